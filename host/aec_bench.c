@@ -0,0 +1,255 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 17:00:00
+ * @LastEditTime: 2026-10-16 17:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端回声消除基准：对近端/远端WAV对运行PBFDAF，统计ERLE、收敛过程与每10ms帧耗时
+ * @FilePath: \audio_manager\host\aec_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "i2s_file.h"
+#include "aec_pbfdaf.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#define BENCH_RATE          16000                           // 与全双工引擎一致
+#define BENCH_FRAME         (BENCH_RATE / 100)              // 10ms帧
+#define BENCH_SETTLE_S      10.0                            // 计算稳态ERLE前跳过的收敛时间
+#define BENCH_CONVERGED_DB  20.0                            // 判定已收敛的每秒ERLE
+#define BENCH_FAR_MIN       (BENCH_FRAME * 64.0 * 64.0)     // 远端有声门限（与AEC内部一致）
+#define BENCH_ECHO_DELAY    80                              // 合成回声路径的纯延迟（样点）
+#define BENCH_ECHO_TAIL     640                             // 合成回声路径的混响长度（样点）
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline uint64_t now_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* ------------------------------------------------------------------ */
+/* 合成测试数据                                                        */
+/* ------------------------------------------------------------------ */
+
+static double noise(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return ((*seed >> 8) & 0xffff) / 32768.0 - 1.0;
+}
+
+/**
+ * @brief 类语音信号：音节包络调制的变调谐波 + 有色噪声（覆盖全部频点以便收敛）
+ */
+static double talker(double t, double f0, double period, uint32_t *seed, double *lp)
+{
+    double ph = fmod(t, period);
+    double env = ph < period * 0.7 ? 0.5 * (1 - cos(2 * M_PI * 3 * ph)) : 0.0;
+    double f = f0 * (1 + 0.15 * sin(2 * M_PI * 0.7 * t));
+    double v = 0.25 * sin(2 * M_PI * f * t) + 0.15 * sin(2 * M_PI * 3 * f * t) + 0.08 * sin(2 * M_PI * 7 * f * t);
+    *lp += 0.3 * (noise(seed) - *lp);
+    return env * (v + 0.25 * *lp);
+}
+
+static int run_gen(const char *far_path, const char *near_path, double seconds, bool doubletalk)
+{
+    i2s_file_t *far = i2s_file_open_writer(far_path, BENCH_RATE, 1, 16, false);
+    i2s_file_t *near = i2s_file_open_writer(near_path, BENCH_RATE, 1, 16, false);
+    int total = (int)(seconds * BENCH_RATE);
+    int len = BENCH_ECHO_DELAY + BENCH_ECHO_TAIL;
+    double *ir = calloc(len, sizeof(double));
+    double *hist = calloc(len, sizeof(double));
+    if (!far || !near || !ir || !hist) {
+        return 1;
+    }
+    // 回声路径：纯延迟 + 指数衰减随机混响（回声损耗约3dB）
+    uint32_t seed = 11;
+    for (int i = 0; i < BENCH_ECHO_TAIL; i++) {
+        ir[BENCH_ECHO_DELAY + i] = 0.12 * noise(&seed) * exp(-i / (BENCH_ECHO_TAIL / 6.0));
+    }
+    ir[BENCH_ECHO_DELAY] = 0.5;
+    uint32_t s_far = 3, s_near = 5, s_bg = 9;
+    double lp_far = 0, lp_near = 0;
+    for (int n = 0; n < total; n++) {
+        double t = (double)n / BENCH_RATE;
+        double x = 0.7 * talker(t, 140, 1.1, &s_far, &lp_far);
+        memmove(hist + 1, hist, (len - 1) * sizeof(double));
+        hist[0] = x;
+        double echo = 0;
+        for (int i = 0; i < len; i++) {
+            echo += ir[i] * hist[i];
+        }
+        double d = echo + 0.001 * noise(&s_bg);
+        // 双讲：后半段每4秒插入1.5秒近端说话
+        if (doubletalk && t > seconds / 2 && fmod(t, 4.0) < 1.5) {
+            d += 0.4 * talker(t + 0.3, 220, 0.9, &s_near, &lp_near);
+        }
+        int16_t xs = (int16_t)lrint(x * 32767), ds = (int16_t)lrint(fmax(-1, fmin(1, d)) * 32767);
+        i2s_file_write(far, &xs, sizeof(xs));
+        i2s_file_write(near, &ds, sizeof(ds));
+    }
+    free(ir);
+    free(hist);
+    i2s_file_close(far);
+    i2s_file_close(near);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 运行                                                                */
+/* ------------------------------------------------------------------ */
+
+static int run_aec(const char *far_path, const char *near_path, const char *out_path, const aec_pbfdaf_cfg_t *cfg)
+{
+    i2s_file_t *far = i2s_file_open_reader(far_path, false);
+    i2s_file_t *near = i2s_file_open_reader(near_path, false);
+    if (!far || !near) {
+        fprintf(stderr, "cannot open input\n");
+        return 1;
+    }
+    int rate, ch, bits;
+    i2s_file_get_format(far, &rate, &ch, &bits);
+    int nrate, nch, nbits;
+    i2s_file_get_format(near, &nrate, &nch, &nbits);
+    if (rate != BENCH_RATE || ch != 1 || bits != 16 || nrate != rate || nch != ch || nbits != bits) {
+        fprintf(stderr, "inputs must be %d Hz mono 16-bit WAV\n", BENCH_RATE);
+        return 1;
+    }
+    i2s_file_t *out = out_path ? i2s_file_open_writer(out_path, BENCH_RATE, 1, 16, false) : NULL;
+    aec_pbfdaf_t *aec = aec_pbfdaf_create(cfg);
+    if (!aec) {
+        fprintf(stderr, "aec create failed\n");
+        return 1;
+    }
+    aec_pbfdaf_stats_t st;
+    aec_pbfdaf_get_stats(aec, &st);
+
+    int16_t x[BENCH_FRAME], d[BENCH_FRAME], e[BENCH_FRAME];
+    uint64_t ns = 0, cyc = 0, frames = 0;
+    double sec_d = 0, sec_e = 0, ss_d = 0, ss_e = 0;
+    int sec = 0, converged = 0;
+    // 输出相对输入延迟 delay_samples，ERLE 对齐比较
+    int16_t dl[BENCH_FRAME + AEC_PBFDAF_BLOCK] = {0};
+    int dly = st.delay_samples;
+    printf("%-6s %10s\n", "t(s)", "ERLE dB");
+    while (i2s_file_read(far, x, sizeof(x)) == sizeof(x) && i2s_file_read(near, d, sizeof(d)) == sizeof(d)) {
+        uint64_t c0 = now_cycles(), t0 = now_ns();
+        aec_pbfdaf_process(aec, d, x, e, BENCH_FRAME);
+        ns += now_ns() - t0;
+        cyc += now_cycles() - c0;
+        frames++;
+        if (out) {
+            i2s_file_write(out, e, sizeof(e));
+        }
+        memmove(dl, dl + BENCH_FRAME, dly * sizeof(int16_t));
+        memcpy(dl + dly, d, sizeof(d));
+        double ex = 0, ed = 0, ee = 0;
+        for (int i = 0; i < BENCH_FRAME; i++) {
+            ex += (double)x[i] * x[i];
+            ed += (double)dl[i] * dl[i];
+            ee += (double)e[i] * e[i];
+        }
+        if (ex > BENCH_FAR_MIN) {
+            sec_d += ed;
+            sec_e += ee;
+            if (frames * BENCH_FRAME >= BENCH_SETTLE_S * BENCH_RATE) {
+                ss_d += ed;
+                ss_e += ee;
+            }
+        }
+        if (frames % 100 == 0) {
+            sec++;
+            if (sec_e > 0) {
+                double db = 10 * log10(sec_d / sec_e);
+                printf("%-6d %10.1f\n", sec, db);
+                if (!converged && db >= BENCH_CONVERGED_DB) {
+                    converged = sec;
+                }
+            }
+            sec_d = sec_e = 0;
+        }
+    }
+    aec_pbfdaf_get_stats(aec, &st);
+    double audio_s = (double)frames * BENCH_FRAME / BENCH_RATE;
+    printf("audio           : %.2f s, tail %u ms, mu %.3f\n", audio_s, cfg->tail_ms, cfg->mu_q15 / 32768.0);
+    if (ss_e > 0) {
+        printf("steady ERLE     : %.1f dB (far-end active, after %.0f s)\n", 10 * log10(ss_d / ss_e), BENCH_SETTLE_S);
+    }
+    if (converged) {
+        printf("converged       : %.0f dB reached in second %d\n", BENCH_CONVERGED_DB, converged);
+    }
+    printf("blocks          : %u, adapted %u, double-talk %u, divergence %u\n",
+           st.blocks, st.adapt_blocks, st.doubletalk_blocks, st.divergence);
+    printf("per 10ms frame  : %.2f us", frames ? ns / 1e3 / frames : 0);
+#ifdef BENCH_HAVE_TSC
+    printf(", %.0f cycles", frames ? (double)cyc / frames : 0);
+#endif
+    printf(" (%.2f%% of realtime)\n", audio_s > 0 ? ns / 1e9 / audio_s * 100 : 0);
+    printf("memory          : %u bytes, delay %u samples\n", st.mem_bytes, st.delay_samples);
+    aec_pbfdaf_destroy(aec);
+    i2s_file_close(far);
+    i2s_file_close(near);
+    if (out) {
+        i2s_file_close(out);
+    }
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: aec_bench gen <far.wav> <near.wav> <seconds> [--doubletalk]\n"
+            "       aec_bench run <far.wav> <near.wav> [out.wav] [--tail ms] [--mu q15] [--dt-ratio n]\n"
+            "input: %d Hz mono 16-bit WAV pair, far = loudspeaker reference, near = microphone,\n"
+            "       sample-aligned as delivered by the full-duplex engine\n", BENCH_RATE);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        usage();
+        return 1;
+    }
+    if (!strcmp(argv[1], "gen") && argc >= 5) {
+        return run_gen(argv[2], argv[3], atof(argv[4]), argc > 5 && !strcmp(argv[5], "--doubletalk"));
+    }
+    if (strcmp(argv[1], "run")) {
+        usage();
+        return 1;
+    }
+    aec_pbfdaf_cfg_t cfg = DEFAULT_AEC_PBFDAF_CONFIG();
+    cfg.frame_samples = BENCH_FRAME;
+    const char *out = NULL;
+    for (int i = 4; i < argc; i++) {
+        if (!strcmp(argv[i], "--tail") && i + 1 < argc) {
+            cfg.tail_ms = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--mu") && i + 1 < argc) {
+            cfg.mu_q15 = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--dt-ratio") && i + 1 < argc) {
+            cfg.dt_ratio = (uint8_t)atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !out) {
+            out = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    return run_aec(argv[2], argv[3], out, &cfg);
+}
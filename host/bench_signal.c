@@ -0,0 +1,43 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端基准共用的麦克风信号源实现
+ * @FilePath: \audio_manager\host\bench_signal.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <math.h>
+#include "bench_signal.h"
+
+#define BENCH_SIGNAL_MAX 8388607    // 24位满幅
+
+void bench_signal_init(bench_signal_t *s, uint32_t rate, double amp, double h3, uint32_t seed)
+{
+    s->rate = rate;
+    s->amp = amp;
+    s->h3 = h3;
+    s->pos = 0;
+    s->seed = seed;
+}
+
+void bench_signal_read(bench_signal_t *s, int32_t *raw, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = s->pos + i;
+        s->seed = s->seed * 1103515245u + 12345u;
+        // 先转为有符号再减，否则按无符号回绕
+        double v = ((int)((s->seed >> 8) % 2001) - 1000) * 0.5;
+        if ((k / s->rate) % 3 != 2) {
+            double t = 2 * M_PI * 220.0 * k / s->rate;
+            v += s->amp * (sin(t) + s->h3 * sin(3 * t));
+        }
+        // 在64位中限幅到24位再左移到32位字的高位，不会溢出
+        int64_t w = llrint(v);
+        if (w > BENCH_SIGNAL_MAX) w = BENCH_SIGNAL_MAX;
+        if (w < -BENCH_SIGNAL_MAX - 1) w = -BENCH_SIGNAL_MAX - 1;
+        raw[i] = (int32_t)(w * 256);
+    }
+    s->pos += n;
+}
@@ -0,0 +1,42 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端基准共用的麦克风信号源：讲话/停顿交替的220Hz谐波加底噪，输出I2S DMA原始字
+ * @FilePath: \audio_manager\host\bench_signal.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 信号源状态：每3秒中前2秒有音（220Hz基波 + 可选660Hz三次谐波），底噪为±500的均匀噪声
+ */
+typedef struct {
+    uint32_t rate;              // 采样率
+    double amp;                 // 基波幅度（24位满幅为8388607）
+    double h3;                  // 三次谐波相对基波的幅度，0 为纯音
+    uint64_t pos;               // 已产生的样点数
+    uint32_t seed;              // 噪声随机数状态
+} bench_signal_t;
+
+/**
+ * @brief 初始化信号源
+ */
+void bench_signal_init(bench_signal_t *s, uint32_t rate, double amp, double h3, uint32_t seed);
+
+/**
+ * @brief 产生 n 个样点，24位有效、左对齐于32位字（与I2S DMA一致），超出24位满幅时限幅
+ */
+void bench_signal_read(bench_signal_t *s, int32_t *raw, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,287 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 19:00:00
+ * @LastEditTime: 2026-10-16 19:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端采集格式转换基准：融合内核与逐步多遍参考实现逐位比对，并与原先的多遍转换比较耗时和去直流效果
+ * @FilePath: \audio_manager\host\convert_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "capture_convert.h"
+
+#define BENCH_RATE      44100                   // 采集采样率（与固件一致）
+#define BENCH_BLOCK     256                     // 每次转换的样点数（与重采样元素一次读取的字数一致）
+#define BENCH_MAX_N     1024                    // 比对时单块最大样点数
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t rnd(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed;
+}
+
+/* ------------------------------------------------------------------ */
+/* 逐步多遍参考：取位 -> 去直流 -> 限幅 -> 移位/增益，每步单独遍历        */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int64_t dc_q8;
+} ref_state_t;
+
+static void ref_s16(ref_state_t *st, const capture_conv_t *cv, const int32_t *in, int16_t *out, int32_t *q31, size_t n)
+{
+    static int32_t s24[BENCH_MAX_N];
+    static int32_t v[BENCH_MAX_N];
+    int32_t dc = (int32_t)(st->dc_q8 >> 8);
+    for (size_t i = 0; i < n; i++) {
+        s24[i] = in[i] / 256 - (in[i] < 0 && in[i] % 256 ? 1 : 0);   // 向下取整，不依赖算术右移
+    }
+    for (size_t i = 0; i < n; i++) {
+        int64_t d = (int64_t)s24[i] - dc;
+        v[i] = (int32_t)(d > cv->hi ? cv->hi : d < cv->lo ? cv->lo : d);
+    }
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t p = (int64_t)floor((double)v[i] / (1 << cv->shift));
+        int64_t y = (int64_t)v[i] * (1ll << (8 + cv->gain_shift));
+        sum += p;
+        if (cv->fine_q15) {
+            p = (int64_t)floor((double)(p * cv->fine_q15) / 32768.0);
+            y = (int64_t)floor((double)(y * cv->fine_q15) / 32768.0);
+        }
+        out[i] = (int16_t)p;
+        q31[i] = (int32_t)y;
+    }
+    if (cv->dc_shift) {
+        int64_t d = (int64_t)floor((double)(sum * (1ll << (cv->shift + 8))) / (double)(1ll << cv->dc_shift));
+        int64_t lim = ((1 << 23) - 1) << 8;
+        st->dc_q8 += d;
+        st->dc_q8 = st->dc_q8 > lim ? lim : st->dc_q8 < -lim ? -lim : st->dc_q8;
+    }
+}
+
+/**
+ * @brief 生成一块DMA字：随机满幅、满幅边界、带直流的正弦，低8位填随机杂散
+ */
+static void make_block(int32_t *w, size_t n, int kind, uint32_t *seed, uint32_t *t)
+{
+    for (size_t i = 0; i < n; i++, (*t)++) {
+        int32_t s;
+        switch (kind) {
+        case 0:
+            s = (int32_t)rnd(seed) >> 8;
+            break;
+        case 1:
+            s = (rnd(seed) & 1) ? (1 << 23) - 1 : -(1 << 23);
+            break;
+        default:
+            s = (int32_t)(400000 + 3000000 * sin(2 * M_PI * 1000.0 * *t / BENCH_RATE));
+            break;
+        }
+        w[i] = (int32_t)((uint32_t)s << 8) | (int32_t)(rnd(seed) & 0xff);
+    }
+}
+
+static int run_verify(void)
+{
+    static const uint32_t gains[] = {
+        4096, 1000, 2048, 3000, 4095, 4097, 6000, 8192, 12000, 16384, 50000, 65536, 100000, 1048575, 1048576,
+    };
+    static const uint8_t shifts[] = {0, 6, 10, 14};
+    static const size_t sizes[] = {1, 7, 8, 9, 31, 256, 320, 441, 1000};
+    static int32_t in[BENCH_MAX_N + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t)];
+    static int16_t out_buf[BENCH_MAX_N + 8] __attribute__((aligned(16)));
+    static int32_t q31[BENCH_MAX_N];
+    static int16_t ref[BENCH_MAX_N];
+    static int32_t ref_q31[BENCH_MAX_N];
+    uint64_t samples = 0, mism = 0, mism_q31 = 0, mism_cross = 0;
+    double gain_err = 0;
+    uint32_t seed = 1;
+
+    for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); g++) {
+        for (size_t d = 0; d < sizeof(shifts) / sizeof(shifts[0]); d++) {
+            capture_conv_cfg_t cfg = {.gain_q12 = gains[g], .dc_shift = shifts[d]};
+            capture_conv_t cv, cq;
+            if (capture_conv_init(&cv, &cfg) != 0 || capture_conv_init(&cq, &cfg) != 0) {
+                fprintf(stderr, "init failed for gain %u\n", gains[g]);
+                return 1;
+            }
+            double eff = (1 << cv.gain_shift) * (cv.fine_q15 ? cv.fine_q15 / 32768.0 : 1.0);
+            double err = fabs(20 * log10(eff / (gains[g] / 4096.0)));
+            gain_err = err > gain_err ? err : gain_err;
+            ref_state_t rs = {0};
+            uint32_t t = 0;
+            // 块长与输出偏移轮换，覆盖对齐头部、SIMD主体与尾部
+            for (int blk = 0; blk < 60; blk++) {
+                size_t n = sizes[blk % (sizeof(sizes) / sizeof(sizes[0]))];
+                if (shifts[d] && n > (1u << shifts[d])) {
+                    n = 1u << shifts[d];
+                }
+                int16_t *out = out_buf + blk % 8;
+                make_block(in, n, blk % 3, &seed, &t);
+                ref_s16(&rs, &cv, in, ref, ref_q31, n);
+                capture_conv_s16(&cv, in, out, n);
+                capture_conv_q31(&cq, in, q31, n);
+                for (size_t i = 0; i < n; i++) {
+                    mism += out[i] != ref[i];
+                    mism_q31 += q31[i] != ref_q31[i];
+                    mism_cross += !cv.fine_q15 && (int16_t)(q31[i] >> 16) != out[i];
+                }
+                mism += cv.dc_q8 != rs.dc_q8 || cq.dc_q8 != rs.dc_q8;
+                samples += n;
+            }
+        }
+    }
+    printf("vectors         : %llu samples, %zu gains x %zu dc settings\n", (unsigned long long)samples,
+           sizeof(gains) / sizeof(gains[0]), sizeof(shifts) / sizeof(shifts[0]));
+    printf("s16 vs reference: %llu mismatches\n", (unsigned long long)mism);
+    printf("q31 vs reference: %llu mismatches\n", (unsigned long long)mism_q31);
+    printf("q31>>16 vs s16  : %llu mismatches (power-of-two gains)\n", (unsigned long long)mism_cross);
+    printf("gain split error: %.4f dB max\n", gain_err);
+    return mism || mism_q31 || mism_cross ? 1 : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 耗时与去直流效果                                                     */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 原先的做法：扩展取高16位、一阶IIR去直流、增益饱和各遍历一次
+ */
+static void legacy_convert(const int32_t *in, int16_t *out, size_t n, int32_t gain_q12, int32_t *x1, int64_t *y1_q15)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int16_t)(in[i] >> 16);
+    }
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = out[i];
+        int64_t y = (int64_t)(x - *x1) * 32768 + ((*y1_q15 * 32604) >> 15);
+        *x1 = x;
+        *y1_q15 = y;
+        int64_t v = y >> 15;
+        out[i] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+    }
+    for (size_t i = 0; i < n; i++) {
+        int32_t v = (out[i] * gain_q12) >> 12;
+        out[i] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+    }
+}
+
+static int run_bench(double seconds, uint32_t gain_q12)
+{
+    size_t blocks = (size_t)(seconds * BENCH_RATE / BENCH_BLOCK);
+    int32_t *in = malloc((blocks * BENCH_BLOCK + 4) * sizeof(int32_t));
+    int16_t *out = malloc(blocks * BENCH_BLOCK * sizeof(int16_t));
+    int32_t *q31 = malloc(BENCH_BLOCK * sizeof(int32_t));
+    if (!in || !out || !q31) {
+        return 1;
+    }
+    // 1kHz -20dBFS 正弦 + 约 -15dBFS 的直流偏置（MEMS麦克风上电后的典型情况）
+    uint32_t seed = 7;
+    for (size_t i = 0; i < blocks * BENCH_BLOCK; i++) {
+        int32_t s = (int32_t)(1500000 + 838860 * sin(2 * M_PI * 1000.0 * i / BENCH_RATE));
+        in[i] = (int32_t)((uint32_t)s << 8) | (int32_t)(rnd(&seed) & 0xff);
+    }
+
+    capture_conv_cfg_t cfg = {.gain_q12 = gain_q12, .dc_shift = 10};
+    capture_conv_t cv;
+    if (capture_conv_init(&cv, &cfg) != 0) {
+        fprintf(stderr, "invalid gain\n");
+        return 1;
+    }
+    uint64_t t0 = now_ns();
+    for (size_t b = 0; b < blocks; b++) {
+        capture_conv_s16(&cv, in + b * BENCH_BLOCK, out + b * BENCH_BLOCK, BENCH_BLOCK);
+    }
+    uint64_t fused_ns = now_ns() - t0;
+
+    // 稳态（跳过前1秒）输出的直流与1kHz幅度
+    size_t skip = BENCH_RATE;
+    double mean = 0, amp = 0;
+    size_t cnt = blocks * BENCH_BLOCK > skip ? blocks * BENCH_BLOCK - skip : 0;
+    for (size_t i = skip; i < skip + cnt; i++) {
+        mean += out[i];
+    }
+    mean = cnt ? mean / cnt : 0;
+    for (size_t i = skip; i < skip + cnt; i++) {
+        amp += (out[i] - mean) * (out[i] - mean);
+    }
+    amp = cnt ? sqrt(2 * amp / cnt) : 0;
+
+    capture_conv_t cq;
+    capture_conv_init(&cq, &cfg);
+    t0 = now_ns();
+    for (size_t b = 0; b < blocks; b++) {
+        capture_conv_q31(&cq, in + b * BENCH_BLOCK, q31, BENCH_BLOCK);
+    }
+    uint64_t q31_ns = now_ns() - t0;
+
+    int32_t x1 = 0;
+    int64_t y1 = 0;
+    t0 = now_ns();
+    for (size_t b = 0; b < blocks; b++) {
+        legacy_convert(in + b * BENCH_BLOCK, out + b * BENCH_BLOCK, BENCH_BLOCK, (int32_t)gain_q12, &x1, &y1);
+    }
+    uint64_t legacy_ns = now_ns() - t0;
+
+    double n = (double)blocks * BENCH_BLOCK;
+    printf("audio           : %.2f s, %u-sample blocks, gain %.2f dB\n", n / BENCH_RATE, BENCH_BLOCK,
+           20 * log10(gain_q12 / 4096.0));
+    printf("fused s16       : %.3f ns/sample\n", fused_ns / n);
+    printf("fused q31       : %.3f ns/sample\n", q31_ns / n);
+    printf("three-pass      : %.3f ns/sample (expand, IIR DC block, gain)\n", legacy_ns / n);
+    printf("input dc        : %.1f LSB16, output dc %.2f LSB16 (after 1 s)\n", 1500000 / 256.0 * gain_q12 / 4096.0, mean);
+    printf("1 kHz amplitude : %.1f LSB16 (expected %.1f)\n", amp, 838860 / 256.0 * gain_q12 / 4096.0);
+    free(in);
+    free(out);
+    free(q31);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: convert_bench verify\n"
+            "       convert_bench run [seconds] [--gain q12]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    if (!strcmp(argv[1], "verify")) {
+        return run_verify();
+    }
+    if (strcmp(argv[1], "run")) {
+        usage();
+        return 1;
+    }
+    double seconds = 60;
+    uint32_t gain = 4096;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--gain") && i + 1 < argc) {
+            gain = (uint32_t)atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            seconds = atof(argv[i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    return run_bench(seconds, gain);
+}
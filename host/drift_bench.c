@@ -0,0 +1,374 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 14:00:00
+ * @LastEditTime: 2026-10-17 14:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端时钟漂移补偿基准：发送端晶振相对本地偏差若干ppm，包经抖动网络进入抖动缓冲，
+ *               按本地DMA节拍播放数小时，对比固定播放（整帧丢弃/插入）与 drift_asrc 闭环补偿下的
+ *               卡顿次数、缓冲延迟漂移与比值收敛；另测开环插值的正弦信噪比与每样点耗时
+ * @FilePath: \audio_manager\host\drift_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "jitter_buffer.h"
+#include "drift_asrc.h"
+
+#define BENCH_RATE          16000
+#define BENCH_DMA_SAMPLES   160             // 每个DMA描述符的样点数（10ms）
+#define BENCH_OUT_FRAMES    2               // 解码输出保持的帧数（同 OPUS_PKT_DECODER_OUT_FRAMES）
+#define BENCH_RB_SAMPLES    8192            // 输出环形缓冲区容量（样点）
+#define BENCH_MAX_INFLIGHT  256
+#define BENCH_WINDOW_S      600             // 延迟统计窗口（秒）
+#define BENCH_TONE_HZ       1000.0
+
+typedef struct {
+    uint32_t hours;
+    double frame_ms;            // 发送端帧长
+    double base_ms;             // 网络固定时延
+    double jitter_ms;           // 网络抖动均值（指数分布）
+    bool trace;
+} bench_cfg_t;
+
+typedef struct {
+    uint32_t arrival_ms;
+    uint16_t seq;
+} bench_wire_pkt_t;
+
+typedef struct {
+    uint32_t dropped;           // 抖动缓冲整帧丢弃
+    uint32_t inserted;          // 抖动缓冲插入隐藏帧
+    uint32_t plc;               // 迟到导致的隐藏帧
+    uint32_t underruns;         // DAC欠载
+    double first_ms;            // 首个统计窗口的平均缓冲延迟
+    double last_ms;             // 最后一个统计窗口的平均缓冲延迟
+    double min_ms, max_ms;      // 首个窗口之后各窗口平均延迟的极值
+    drift_asrc_stats_t asrc;
+    double wobble_ppm;          // 收敛后比值相对积分项的均方根偏差（音高抖动）
+    double ns_per_sample;
+} bench_result_t;
+
+static uint32_t s_seed;
+
+static double bench_rand(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return ((s_seed >> 8) + 1.0) / 16777217.0;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* 发送端以自己的时钟采样，帧内样点为连续的1kHz正弦，接收端只需序号即可还原 */
+static void bench_synth(uint16_t seq, uint32_t frame_samples, int16_t *pcm)
+{
+    for (uint32_t i = 0; i < frame_samples; i++) {
+        uint64_t k = (uint64_t)seq * frame_samples + i;
+        pcm[i] = (int16_t)(16384.0 * sin(2 * M_PI * BENCH_TONE_HZ * (double)(k % BENCH_RATE) / BENCH_RATE));
+    }
+}
+
+static void bench_run(const bench_cfg_t *cfg, double ppm, bool comp, bench_result_t *r)
+{
+    const uint32_t frame_us = (uint32_t)(cfg->frame_ms * 1000);
+    const uint32_t frame_samples = BENCH_RATE * frame_us / 1000000;
+    const uint64_t total_ms = (uint64_t)cfg->hours * 3600000;
+
+    jitter_buffer_cfg_t jb_cfg = DEFAULT_JITTER_BUFFER_CONFIG();
+    jb_cfg.frame_us = frame_us;
+    jb_cfg.min_depth_ms = (uint16_t)(cfg->frame_ms * 2);
+    jitter_buffer_t *jb = jitter_buffer_create(&jb_cfg);
+    drift_asrc_cfg_t asrc_cfg = DEFAULT_DRIFT_ASRC_CONFIG();
+    drift_asrc_t *asrc = drift_asrc_create(&asrc_cfg);
+    int16_t *pcm = malloc(frame_samples * sizeof(int16_t));
+    int16_t *out = malloc(drift_asrc_max_output(asrc, frame_samples) * sizeof(int16_t));
+    bench_wire_pkt_t *inflight = malloc(BENCH_MAX_INFLIGHT * sizeof(bench_wire_pkt_t));
+    if (!jb || !asrc || !pcm || !out || !inflight) {
+        fprintf(stderr, "alloc failed\n");
+        exit(1);
+    }
+    memset(r, 0, sizeof(*r));
+    r->min_ms = 1e9;
+    s_seed = 1;
+
+    uint32_t rb_fill = 0;                          // 输出缓冲只计样点数，内容不影响时序
+    int count = 0;
+    uint16_t send_seq = 0;
+    double next_send_us = 0;
+    const double send_period_us = frame_us * 1e6 / (1e6 + ppm);    // 远端时钟偏快时包间隔更短
+    bool have_newest = false;
+    uint16_t newest_seq = 0;
+    uint32_t newest_ms = 0;
+    bool anchored = false;
+    int32_t setpoint_us = 0, steps_base = 0;
+    double win_sum = 0;
+    uint32_t win_n = 0, windows = 0;
+    double wobble_sum = 0;
+    uint64_t wobble_n = 0;
+    uint64_t asrc_ns = 0, asrc_samples = 0;
+
+    for (uint64_t now_ms = 0; now_ms < total_ms; now_ms++) {
+        // 1. 发送端按自己的时钟出包，经指数分布时延到达
+        while (next_send_us <= (double)now_ms * 1000 + 999) {
+            if (count < BENCH_MAX_INFLIGHT) {
+                bench_wire_pkt_t *w = &inflight[count++];
+                w->arrival_ms = (uint32_t)(next_send_us / 1000 + cfg->base_ms - cfg->jitter_ms * log(bench_rand()));
+                w->seq = send_seq;
+            }
+            send_seq++;
+            next_send_us += send_period_us;
+        }
+        for (int i = 0; i < count;) {
+            if (inflight[i].arrival_ms > now_ms) {
+                i++;
+                continue;
+            }
+            uint16_t seq = inflight[i].seq;
+            jitter_buffer_put(jb, (const uint8_t *)&seq, sizeof(seq), seq, (uint32_t)now_ms);
+            if (!have_newest || (int16_t)(seq - newest_seq) > 0) {
+                newest_seq = seq;
+                newest_ms = (uint32_t)now_ms;
+                have_newest = true;
+            }
+            inflight[i] = inflight[--count];
+        }
+
+        // 2. DAC按本地时钟每10ms取走一个描述符
+        if (now_ms % (BENCH_DMA_SAMPLES * 1000 / BENCH_RATE) == 0) {
+            if (rb_fill >= BENCH_DMA_SAMPLES) {
+                rb_fill -= BENCH_DMA_SAMPLES;
+            } else if (now_ms > 1000) {
+                r->underruns++;
+                rb_fill = 0;
+            }
+        }
+
+        // 3. 解码端：输出缓冲低于目标即取一帧（同 _opus_pkt_decoder_process）
+        while (rb_fill < frame_samples * BENCH_OUT_FRAMES) {
+            const uint8_t *data;
+            uint16_t len;
+            jitter_frame_type_t type = jitter_buffer_get(jb, &data, &len);
+            if (type == JITTER_FRAME_NONE) {
+                if (comp) {
+                    drift_asrc_hold(asrc);
+                }
+                anchored = false;
+                break;
+            }
+            if (type == JITTER_FRAME_NORMAL) {
+                uint16_t seq;
+                memcpy(&seq, data, sizeof(seq));
+                bench_synth(seq, frame_samples, pcm);
+            } else {
+                memset(pcm, 0, frame_samples * sizeof(int16_t));
+            }
+            uint32_t n = frame_samples;
+            if (comp) {
+                jitter_buffer_stats_t st;
+                jitter_buffer_get_stats(jb, &st);
+                // 水位 = 已到达未播放的帧 + 最新包到达后经过的时间（去掉按帧量化的锯齿）；
+                // 设定点在开始播放时取目标深度加一帧，之后只随抖动缓冲的整帧调整平移，两者不相互抵消
+                int32_t level_us = st.depth_ms * 1000 + (int32_t)((uint32_t)now_ms - newest_ms) * 1000;
+                if (!anchored) {
+                    setpoint_us = st.target_ms * 1000 + (int32_t)frame_us * 3 / 2;
+                    steps_base = (int32_t)(st.inserted - st.dropped);
+                    anchored = true;
+                }
+                int32_t steps = (int32_t)(st.inserted - st.dropped) - steps_base;
+                drift_asrc_update(asrc, level_us - setpoint_us - steps * (int32_t)frame_us, frame_us);
+                uint64_t t0 = now_ns();
+                n = (uint32_t)drift_asrc_process(asrc, pcm, frame_samples, out);
+                asrc_ns += now_ns() - t0;
+                asrc_samples += n;
+            }
+            rb_fill = rb_fill + n < BENCH_RB_SAMPLES ? rb_fill + n : BENCH_RB_SAMPLES;
+        }
+
+        // 4. 每秒采样一次端到端缓冲延迟（抖动缓冲 + 输出缓冲），按窗口平均
+        if (now_ms % 1000 == 999) {
+            jitter_buffer_stats_t st;
+            jitter_buffer_get_stats(jb, &st);
+            win_sum += st.depth_ms + rb_fill * 1000.0 / BENCH_RATE;
+            win_n++;
+            if (comp && now_ms > 2 * BENCH_WINDOW_S * 1000) {
+                drift_asrc_stats_t as;
+                drift_asrc_get_stats(asrc, &as);
+                double d = (as.ratio_ppb - as.drift_ppb) / 1000.0;
+                wobble_sum += d * d;
+                wobble_n++;
+            }
+            if (win_n == BENCH_WINDOW_S) {
+                double avg = win_sum / win_n;
+                if (windows == 0) {
+                    r->first_ms = avg;
+                } else {
+                    r->min_ms = avg < r->min_ms ? avg : r->min_ms;
+                    r->max_ms = avg > r->max_ms ? avg : r->max_ms;
+                }
+                r->last_ms = avg;
+                windows++;
+                if (cfg->trace) {
+                    drift_asrc_stats_t as = {0};
+                    drift_asrc_get_stats(asrc, &as);
+                    printf("    %5.1f min: latency %6.1f ms, target %3u ms, ratio %+8.3f ppm, drift %+8.3f ppm\n",
+                           (now_ms + 1) / 60000.0, avg, st.target_ms, as.ratio_ppb / 1000.0, as.drift_ppb / 1000.0);
+                }
+                win_sum = 0;
+                win_n = 0;
+            }
+        }
+    }
+
+    jitter_buffer_stats_t st;
+    jitter_buffer_get_stats(jb, &st);
+    r->dropped = st.dropped;
+    r->inserted = st.inserted;
+    r->plc = st.plc;
+    drift_asrc_get_stats(asrc, &r->asrc);
+    r->wobble_ppm = wobble_n ? sqrt(wobble_sum / wobble_n) : 0;
+    r->ns_per_sample = asrc_samples ? (double)asrc_ns / asrc_samples : 0;
+
+    free(inflight);
+    free(out);
+    free(pcm);
+    drift_asrc_destroy(asrc);
+    jitter_buffer_destroy(jb);
+}
+
+static void bench_print(double ppm, bool comp, const bench_result_t *r)
+{
+    printf("%+6.0f ppm %-6s: dropped %4u, inserted %4u (net %+5d), plc %3u, underruns %3u | latency first %6.1f ms, "
+           "last %6.1f ms, range %6.1f ~ %6.1f ms",
+           ppm, comp ? "asrc" : "fixed", r->dropped, r->inserted, (int)(r->inserted - r->dropped), r->plc, r->underruns,
+           r->first_ms, r->last_ms, r->min_ms, r->max_ms);
+    if (comp) {
+        printf(" | drift est %+8.3f ppm, wobble %.3f ppm rms, saturated %u, %.1f ns/sample",
+               r->asrc.drift_ppb / 1000.0, r->wobble_ppm, r->asrc.saturated, r->ns_per_sample);
+    }
+    printf("\n");
+}
+
+/* 开环插值质量：1kHz正弦按固定比值重采样，在已知输出频率上做最小二乘拟合，残差即失真与噪声 */
+static double bench_tone_snr(int32_t ratio_ppb)
+{
+    const size_t n_in = BENCH_RATE * 3, skip = BENCH_RATE, n_fit = BENCH_RATE;
+    drift_asrc_cfg_t cfg = DEFAULT_DRIFT_ASRC_CONFIG();
+    drift_asrc_t *asrc = drift_asrc_create(&cfg);
+    int16_t *in = malloc(n_in * sizeof(int16_t));
+    int16_t *out = malloc(drift_asrc_max_output(asrc, n_in) * sizeof(int16_t));
+    for (size_t i = 0; i < n_in; i++) {
+        in[i] = (int16_t)lrint(16384.0 * sin(2 * M_PI * BENCH_TONE_HZ * i / BENCH_RATE));
+    }
+    drift_asrc_set_ratio(asrc, ratio_ppb);
+    size_t produced = 0;
+    for (size_t i = 0; i < n_in; i += 160) {
+        produced += drift_asrc_process(asrc, in + i, 160, out + produced);
+    }
+    double w = 2 * M_PI * BENCH_TONE_HZ * (1.0 + ratio_ppb * 1e-9) / BENCH_RATE;
+    // 法方程 [cc cs c; cs ss s; c s n] * [a b d] = [yc ys y]
+    double m[3][4] = {{0}};
+    for (size_t i = skip; i < skip + n_fit && i < produced; i++) {
+        double v[3] = {cos(w * i), sin(w * i), 1.0};
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                m[a][b] += v[a] * v[b];
+            }
+            m[a][3] += v[a] * out[i];
+        }
+    }
+    for (int p = 0; p < 3; p++) {
+        for (int q = p + 1; q < 3; q++) {
+            double f = m[q][p] / m[p][p];
+            for (int k = p; k < 4; k++) {
+                m[q][k] -= f * m[p][k];
+            }
+        }
+    }
+    double x[3];
+    for (int p = 2; p >= 0; p--) {
+        x[p] = m[p][3];
+        for (int k = p + 1; k < 3; k++) {
+            x[p] -= m[p][k] * x[k];
+        }
+        x[p] /= m[p][p];
+    }
+    double sig = 0, err = 0;
+    for (size_t i = skip; i < skip + n_fit && i < produced; i++) {
+        double fit = x[0] * cos(w * i) + x[1] * sin(w * i) + x[2];
+        sig += fit * fit;
+        err += (out[i] - fit) * (out[i] - fit);
+    }
+    free(out);
+    free(in);
+    drift_asrc_destroy(asrc);
+    return 10 * log10(sig / (err > 0 ? err : 1e-9));
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: drift_bench run [--hours n] [--ppm n] [--frame-ms n] [--jitter-ms n] [--trace]\n"
+            "       drift_bench tone\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    if (!strcmp(argv[1], "tone")) {
+        const int32_t ratios[] = {0, 200000, -200000, 1000000, -1000000};
+        for (size_t i = 0; i < sizeof(ratios) / sizeof(ratios[0]); i++) {
+            printf("ratio %+6.0f ppm: 1 kHz tone SNR %.1f dB\n", ratios[i] / 1000.0, bench_tone_snr(ratios[i]));
+        }
+        return 0;
+    }
+    if (strcmp(argv[1], "run") != 0) {
+        usage();
+        return 1;
+    }
+    bench_cfg_t cfg = {.hours = 4, .frame_ms = 20, .base_ms = 30, .jitter_ms = 5, .trace = false};
+    double ppms[3] = {-200, 200, 0};
+    int n_ppm = 2;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--hours") && i + 1 < argc) {
+            cfg.hours = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--ppm") && i + 1 < argc) {
+            ppms[0] = atof(argv[++i]);
+            n_ppm = 1;
+        } else if (!strcmp(argv[i], "--frame-ms") && i + 1 < argc) {
+            cfg.frame_ms = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--jitter-ms") && i + 1 < argc) {
+            cfg.jitter_ms = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--trace")) {
+            cfg.trace = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (cfg.hours == 0 || cfg.frame_ms < 2.5) {
+        usage();
+        return 1;
+    }
+    printf("%u h, frame %.1f ms, network %.0f ms + exp(%.0f ms)\n", cfg.hours, cfg.frame_ms, cfg.base_ms, cfg.jitter_ms);
+    for (int i = 0; i < n_ppm; i++) {
+        for (int comp = 0; comp < 2; comp++) {
+            bench_result_t r;
+            bench_run(&cfg, ppms[i], comp, &r);
+            bench_print(ppms[i], comp, &r);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 15:00:00
+ * @LastEditTime: 2026-10-17 15:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端格式协商基准：列出典型器件组合的协商结果，并比较直采16kHz与44.1kHz采集+多相重采样的处理耗时
+ * @FilePath: \audio_manager\host\format_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "audio_format.h"
+#include "capture_convert.h"
+#include "polyphase_resampler.h"
+
+#define BENCH_OUT_RATE  16000                   // 采集发布采样率（与固件一致）
+#define BENCH_BLOCK     256                     // 每次处理的I2S样点数（与重采样元素一次读取的字数一致）
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------ */
+/* 器件格式（与固件中的声明一致）                                      */
+/* ------------------------------------------------------------------ */
+
+static const audio_format_conv_t s_capture_convs[] = {
+    {"polyphase", 44100, BENCH_OUT_RATE, POLYPHASE_RSP_TAPS},
+};
+
+static const audio_caps_t s_capture_caps = {
+    .rates = {BENCH_OUT_RATE}, .rate_count = 1,
+    .channels_mask = AUDIO_FORMAT_CH(1), .bits_mask = AUDIO_FORMAT_BITS_16,
+};
+
+static const audio_caps_t s_inmp441 = {
+    .rate_min = 7800, .rate_max = 50000,
+    .channels_mask = AUDIO_FORMAT_CH(1), .bits_mask = AUDIO_FORMAT_BITS_32,
+};
+
+static const audio_caps_t s_mic_fixed = {
+    .rates = {44100, 48000}, .rate_count = 2,
+    .channels_mask = AUDIO_FORMAT_CH(1), .bits_mask = AUDIO_FORMAT_BITS_32,
+};
+
+static const audio_caps_t s_mic_48k = {
+    .rates = {48000}, .rate_count = 1,
+    .channels_mask = AUDIO_FORMAT_CH(1), .bits_mask = AUDIO_FORMAT_BITS_32,
+};
+
+static const audio_caps_t s_opus = {
+    .rates = {16000, 24000, 48000}, .rate_count = 3,
+    .channels_mask = AUDIO_FORMAT_CH(1), .bits_mask = AUDIO_FORMAT_BITS_16,
+};
+
+static const audio_caps_t s_max98357a = {
+    .rate_min = 8000, .rate_max = 96000,
+    .channels_mask = AUDIO_FORMAT_CH(1) | AUDIO_FORMAT_CH(2),
+    .bits_mask = AUDIO_FORMAT_BITS_16 | AUDIO_FORMAT_BITS_32,
+};
+
+static const audio_caps_t s_codec_48k = {
+    .rates = {48000}, .rate_count = 1,
+    .channels_mask = AUDIO_FORMAT_CH(2), .bits_mask = AUDIO_FORMAT_BITS_16 | AUDIO_FORMAT_BITS_32,
+};
+
+static const audio_caps_t s_duplex = {
+    .rates = {16000}, .rate_count = 1,
+    .channels_mask = AUDIO_FORMAT_CH(1), .bits_mask = AUDIO_FORMAT_BITS_16,
+};
+
+typedef struct {
+    const char *name;
+    const audio_caps_t *src;
+    const audio_caps_t *sink;
+    const audio_format_conv_t *convs;
+    int count;
+} bench_case_t;
+
+static const bench_case_t s_cases[] = {
+    {"INMP441 -> capture", &s_inmp441, &s_capture_caps, s_capture_convs, 1},
+    {"mic 44.1/48k -> capture", &s_mic_fixed, &s_capture_caps, s_capture_convs, 1},
+    {"mic 48k only -> capture", &s_mic_48k, &s_capture_caps, s_capture_convs, 1},
+    {"opus -> MAX98357A", &s_opus, &s_max98357a, NULL, 0},
+    {"opus -> 48k stereo codec", &s_opus, &s_codec_48k, NULL, 0},
+    {"opus -> duplex", &s_opus, &s_duplex, NULL, 0},
+    {"capture -> MAX98357A", &s_capture_caps, &s_max98357a, NULL, 0},
+};
+
+static void run_cases(void)
+{
+    printf("%-26s %-18s %-18s %-10s %10s\n", "link", "src", "sink", "convert", "cost/s");
+    for (size_t i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++) {
+        const bench_case_t *c = &s_cases[i];
+        audio_format_link_t link;
+        if (audio_format_negotiate(c->src, c->sink, c->convs, c->count, &link) != 0) {
+            printf("%-26s no path\n", c->name);
+            continue;
+        }
+        char src[32];
+        char sink[32];
+        snprintf(src, sizeof(src), "%u Hz %uch %ub", (unsigned)link.src.rate, link.src.channels, link.src.bits);
+        snprintf(sink, sizeof(sink), "%u Hz %uch %ub", (unsigned)link.sink.rate, link.sink.channels, link.sink.bits);
+        printf("%-26s %-18s %-18s %-10s %10u\n", c->name, src, sink,
+               link.conv < 0 ? "direct" : c->convs[link.conv].name, (unsigned)link.cost);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* 处理耗时：每秒音频的转换（+重采样）时间                              */
+/* ------------------------------------------------------------------ */
+
+static double time_capture(uint32_t in_rate, double seconds, int resample)
+{
+    static int32_t raw[BENCH_BLOCK + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t)];
+    static int16_t pcm[BENCH_BLOCK];
+    static int16_t out[BENCH_BLOCK];
+    static polyphase_rsp_t rsp;
+    capture_conv_t cv;
+    capture_conv_init(&cv, NULL);
+    polyphase_rsp_reset(&rsp);
+
+    uint64_t total = (uint64_t)(seconds * in_rate);
+    uint64_t produced = 0;
+    uint32_t t = 0;
+    uint64_t ns = 0;
+    for (uint64_t done = 0; done < total; done += BENCH_BLOCK) {
+        for (int i = 0; i < BENCH_BLOCK; i++, t++) {
+            double v = 0.3 * sin(2 * M_PI * 440.0 * t / in_rate) + 0.01;
+            raw[i] = (int32_t)(v * 8388607.0) * 256;
+        }
+        uint64_t t0 = now_ns();
+        capture_conv_s16(&cv, raw, pcm, BENCH_BLOCK);
+        produced += resample ? polyphase_rsp_process(&rsp, pcm, BENCH_BLOCK, out) : BENCH_BLOCK;
+        ns += now_ns() - t0;
+    }
+    printf("  %5u Hz %-12s %8.1f us per second of audio, %llu samples out\n", (unsigned)in_rate,
+           resample ? "+ polyphase" : "convert only", ns / 1000.0 / seconds, (unsigned long long)produced);
+    return ns / seconds;
+}
+
+static void run_timing(double seconds)
+{
+    printf("\ncapture front end, %.0f s of audio:\n", seconds);
+    double direct = time_capture(BENCH_OUT_RATE, seconds, 0);
+    double legacy = time_capture(44100, seconds, 1);
+    printf("  direct 16 kHz saves %.1f%% of front-end CPU, I2S DMA %u -> %u bytes/s\n",
+           100.0 * (1.0 - direct / legacy), 44100u * 4, BENCH_OUT_RATE * 4u);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: format_bench run [seconds]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 1;
+    }
+    double seconds = argc > 2 ? atof(argv[2]) : 60.0;
+    if (seconds <= 0) {
+        usage();
+        return 1;
+    }
+    run_cases();
+    run_timing(seconds);
+    return 0;
+}
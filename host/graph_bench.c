@@ -0,0 +1,712 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 13:00:00
+ * @LastEditTime: 2026-10-17 13:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端执行引擎基准：同一条采集+录制链路分别以ADF模型（每元素一个线程、元素间环形缓冲区拷贝）
+ *               与单任务处理图（audio_graph）运行，对比CPU、上下文切换、内存与端到端延迟
+ * @FilePath: \audio_manager\host\graph_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include "capture_convert.h"
+#include "polyphase_resampler.h"
+#include "audio_fanout.h"
+#include "voice_activity.h"
+#include "audio_graph.h"
+#include "bench_signal.h"
+
+#define BENCH_IN_RATE       44100
+#define BENCH_OUT_RATE      16000
+#define BENCH_BLOCKS        12          // 扇出块池（同 AUDIO_CAPTURE_BLOCK_COUNT）
+#define BENCH_DEPTH         4           // 订阅深度（同 AUDIO_CAPTURE_DEFAULT_DEPTH）
+#define BENCH_MAX_FRAMES    (1 << 16)
+
+// 固件中的元素参数（ADF i2s_stream 默认值与本仓库各元素的配置）
+#define FW_I2S_STACK        3584        // I2S_STREAM_TASK_STACK
+#define FW_ELEMENT_STACK    3072        // 重采样/扇出/读取元素
+#define FW_OPUS_STACK       (24 * 1024) // OPUS_PKT_ENCODER_TASK_STACK
+#define FW_RSP_BUF          1024        // RSP_POLYPHASE_BUF_SIZE
+#define FW_GRAPH_STACK      3072        // AUDIO_CAPTURE_GRAPH_TASK_STACK
+
+/**
+ * @brief 延迟档位中与引擎相关的参数（同 audio_latency.c）
+ */
+typedef struct {
+    const char *name;
+    uint32_t block_ms;          // 采集块长 = Opus帧长
+    uint32_t i2s_buffer_len;    // i2s_stream 每次读取字节数
+    uint32_t i2s_rb_size;       // I2S输出环形缓冲区
+    uint32_t element_rb_size;   // 中间元素输出环形缓冲区
+} bench_profile_t;
+
+static const bench_profile_t s_profiles[] = {
+    {"ultra-low", 5, 512, 2 * 1024, 1024},
+    {"balanced", 20, 3600, 8 * 1024, 4 * 1024},
+};
+
+typedef struct {
+    const bench_profile_t *pf;
+    uint32_t seconds;
+    uint32_t encode_us;         // 编码耗时替身（忙等），模拟libopus
+    uint32_t block;             // 16kHz块长
+    uint32_t in_block;          // 44.1kHz节拍长（处理图）
+} bench_cfg_t;
+
+/* ------------------------------------------------------------------ */
+/* 公共部件                                                            */
+/* ------------------------------------------------------------------ */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t t)
+{
+    struct timespec ts = {.tv_sec = (time_t)(t / 1000000000ull), .tv_nsec = (long)(t % 1000000000ull)};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+/**
+ * @brief 麦克风信号源：间断的语音状正弦加噪声，24位左对齐于32位槽，按真实时间节拍给出
+ */
+typedef struct {
+    uint64_t t0;
+    bench_signal_t sig;
+} bench_src_t;
+
+static void src_read(bench_src_t *s, int32_t *out, size_t n)
+{
+    bench_signal_read(&s->sig, out, n);
+    // 最后一个样点采到之后DMA才交出数据
+    sleep_until(s->t0 + s->sig.pos * 1000000000ull / BENCH_IN_RATE);
+}
+
+/**
+ * @brief 编码替身：凑满一帧后做VAD并忙等 encode_us，记录帧末样点的端到端延迟
+ */
+typedef struct {
+    const bench_cfg_t *cfg;
+    voice_activity_t *vad;
+    int16_t *pcm;
+    uint32_t fill;
+    uint64_t out_pos;           // 已编码的16kHz样点数
+    uint64_t t0;
+    uint32_t frames;
+    uint32_t speech;
+    uint32_t *lat_us;
+} bench_enc_t;
+
+static void enc_frame(bench_enc_t *e, const int16_t *pcm)
+{
+    e->speech += voice_activity_process(e->vad, pcm, e->cfg->block);
+    uint64_t end = now_ns() + e->cfg->encode_us * 1000ull;
+    while (now_ns() < end) {
+    }
+    e->out_pos += e->cfg->block;
+    // 帧末样点的采样时刻（重采样群延迟对两种引擎相同，不计入）
+    uint64_t sampled = e->t0 + e->out_pos * 1000000000ull / BENCH_OUT_RATE;
+    uint64_t now = now_ns();
+    if (e->frames < BENCH_MAX_FRAMES) {
+        e->lat_us[e->frames] = now > sampled ? (uint32_t)((now - sampled) / 1000) : 0;
+    }
+    e->frames++;
+}
+
+static void enc_feed(bench_enc_t *e, const int16_t *p, size_t n)
+{
+    while (n > 0) {
+        if (e->fill == 0 && n >= e->cfg->block) {
+            enc_frame(e, p);
+            p += e->cfg->block;
+            n -= e->cfg->block;
+            continue;
+        }
+        size_t k = e->cfg->block - e->fill;
+        if (k > n) {
+            k = n;
+        }
+        memcpy(e->pcm + e->fill, p, k * sizeof(int16_t));
+        e->fill += k;
+        p += k;
+        n -= k;
+        if (e->fill == e->cfg->block) {
+            e->fill = 0;
+            enc_frame(e, e->pcm);
+        }
+    }
+}
+
+/**
+ * @brief 扇出消费者的唤醒（对应固件中的二值信号量）
+ */
+typedef struct {
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    bool signaled;
+} bench_sem_t;
+
+static void sem_give(void *ctx)
+{
+    bench_sem_t *s = ctx;
+    pthread_mutex_lock(&s->mu);
+    s->signaled = true;
+    pthread_cond_signal(&s->cv);
+    pthread_mutex_unlock(&s->mu);
+}
+
+static void sem_take(bench_sem_t *s, uint32_t timeout_ms)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += (long)timeout_ms * 1000000;
+    ts.tv_sec += ts.tv_nsec / 1000000000;
+    ts.tv_nsec %= 1000000000;
+    pthread_mutex_lock(&s->mu);
+    while (!s->signaled) {
+        if (pthread_cond_timedwait(&s->cv, &s->mu, &ts) != 0) {
+            break;
+        }
+    }
+    s->signaled = false;
+    pthread_mutex_unlock(&s->mu);
+}
+
+/**
+ * @brief 共用的链路状态：转换、重采样、扇出切块、订阅与编码替身
+ */
+typedef struct {
+    bench_cfg_t cfg;
+    bench_src_t src;
+    capture_conv_t conv;
+    polyphase_rsp_t rsp;
+    audio_fanout_t *fo;
+    audio_fanout_consumer_t *consumer;
+    bench_sem_t sem;
+    audio_block_t *cur;
+    volatile bool src_done;
+    bench_enc_t enc;
+} bench_chain_t;
+
+static void chain_sink(bench_chain_t *c, const int16_t *p, size_t left)
+{
+    while (left > 0) {
+        if (!c->cur && !(c->cur = audio_fanout_alloc(c->fo))) {
+            return;
+        }
+        size_t n = c->cur->cap - c->cur->count;
+        if (n > left) {
+            n = left;
+        }
+        memcpy(c->cur->samples + c->cur->count, p, n * sizeof(int16_t));
+        c->cur->count += n;
+        p += n;
+        left -= n;
+        if (c->cur->count == c->cur->cap) {
+            audio_fanout_publish(c->fo, c->cur);
+            c->cur = NULL;
+        }
+    }
+}
+
+static const audio_block_t *chain_pull(bench_chain_t *c)
+{
+    const audio_block_t *blk;
+    while (!(blk = audio_fanout_pull(c->consumer))) {
+        if (c->src_done) {
+            return NULL;
+        }
+        sem_take(&c->sem, 10);
+    }
+    return blk;
+}
+
+/* ------------------------------------------------------------------ */
+/* ADF 模型：每元素一个线程，元素之间经环形缓冲区拷贝                   */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 环形缓冲区（语义同ADF ringbuf：写满阻塞，读取凑满请求长度或上游结束才返回）
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t head;
+    size_t fill;
+    size_t peak;
+    bool done;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+} bench_rb_t;
+
+static void rb_init(bench_rb_t *rb, size_t size)
+{
+    memset(rb, 0, sizeof(*rb));
+    rb->buf = malloc(size);
+    rb->size = size;
+    pthread_mutex_init(&rb->mu, NULL);
+    pthread_cond_init(&rb->cv, NULL);
+}
+
+static void rb_write(bench_rb_t *rb, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    pthread_mutex_lock(&rb->mu);
+    while (len > 0) {
+        while (rb->fill == rb->size) {
+            pthread_cond_wait(&rb->cv, &rb->mu);
+        }
+        size_t n = rb->size - rb->fill;
+        if (n > len) {
+            n = len;
+        }
+        for (size_t i = 0; i < n; i++) {
+            rb->buf[(rb->head + rb->fill + i) % rb->size] = p[i];
+        }
+        rb->fill += n;
+        if (rb->fill > rb->peak) {
+            rb->peak = rb->fill;
+        }
+        p += n;
+        len -= n;
+        pthread_cond_broadcast(&rb->cv);
+    }
+    pthread_mutex_unlock(&rb->mu);
+}
+
+static size_t rb_read(bench_rb_t *rb, void *data, size_t len)
+{
+    uint8_t *p = data;
+    size_t got = 0;
+    pthread_mutex_lock(&rb->mu);
+    while (got < len) {
+        while (rb->fill == 0 && !rb->done) {
+            pthread_cond_wait(&rb->cv, &rb->mu);
+        }
+        if (rb->fill == 0) {
+            break;
+        }
+        size_t n = rb->fill < len - got ? rb->fill : len - got;
+        for (size_t i = 0; i < n; i++) {
+            p[got + i] = rb->buf[(rb->head + i) % rb->size];
+        }
+        rb->head = (rb->head + n) % rb->size;
+        rb->fill -= n;
+        got += n;
+        pthread_cond_broadcast(&rb->cv);
+    }
+    pthread_mutex_unlock(&rb->mu);
+    return got;
+}
+
+static void rb_done(bench_rb_t *rb)
+{
+    pthread_mutex_lock(&rb->mu);
+    rb->done = true;
+    pthread_cond_broadcast(&rb->cv);
+    pthread_mutex_unlock(&rb->mu);
+}
+
+typedef struct {
+    bench_chain_t *c;
+    bench_rb_t i2s_rb;          // [i2s] -> [rsp]
+    bench_rb_t rsp_rb;          // [rsp] -> [fanout]
+    bench_rb_t reader_rb;       // [reader] -> [opus]
+    uint64_t total_in;
+} bench_adf_t;
+
+static void *adf_i2s(void *arg)
+{
+    bench_adf_t *a = arg;
+    size_t words = a->c->cfg.pf->i2s_buffer_len / sizeof(int32_t);
+    int32_t *buf = malloc(words * sizeof(int32_t));
+    while (a->c->src.sig.pos < a->total_in) {
+        src_read(&a->c->src, buf, words);
+        rb_write(&a->i2s_rb, buf, words * sizeof(int32_t));
+    }
+    rb_done(&a->i2s_rb);
+    free(buf);
+    return NULL;
+}
+
+static void *adf_rsp(void *arg)
+{
+    bench_adf_t *a = arg;
+    size_t words = FW_RSP_BUF / sizeof(int32_t);
+    int32_t *raw = calloc(words + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t), sizeof(int32_t));
+    int16_t *pcm = calloc(words, sizeof(int16_t));
+    int16_t *out = calloc(polyphase_rsp_max_output(words), sizeof(int16_t));
+    size_t got;
+    while ((got = rb_read(&a->i2s_rb, raw, words * sizeof(int32_t))) > 0) {
+        size_t n = got / sizeof(int32_t);
+        capture_conv_s16(&a->c->conv, raw, pcm, n);
+        n = polyphase_rsp_process(&a->c->rsp, pcm, n, out);
+        if (n) {
+            rb_write(&a->rsp_rb, out, n * sizeof(int16_t));
+        }
+    }
+    rb_done(&a->rsp_rb);
+    free(raw);
+    free(pcm);
+    free(out);
+    return NULL;
+}
+
+static void *adf_fanout(void *arg)
+{
+    bench_adf_t *a = arg;
+    size_t bytes = a->c->cfg.block * sizeof(int16_t);
+    int16_t *buf = malloc(bytes);
+    size_t got;
+    while ((got = rb_read(&a->rsp_rb, buf, bytes)) > 0) {
+        chain_sink(a->c, buf, got / sizeof(int16_t));
+    }
+    a->c->src_done = true;
+    sem_give(&a->c->sem);
+    free(buf);
+    return NULL;
+}
+
+static void *adf_reader(void *arg)
+{
+    bench_adf_t *a = arg;
+    const audio_block_t *blk;
+    while ((blk = chain_pull(a->c)) != NULL) {
+        rb_write(&a->reader_rb, blk->samples, blk->count * sizeof(int16_t));
+        audio_fanout_release(a->c->fo, blk);
+    }
+    rb_done(&a->reader_rb);
+    return NULL;
+}
+
+static void *adf_opus(void *arg)
+{
+    bench_adf_t *a = arg;
+    size_t bytes = a->c->cfg.block * sizeof(int16_t);
+    int16_t *buf = malloc(bytes);
+    size_t got;
+    while ((got = rb_read(&a->reader_rb, buf, bytes)) > 0) {
+        enc_feed(&a->c->enc, buf, got / sizeof(int16_t));
+    }
+    free(buf);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/* 处理图模型：采集一个线程 [conv]->[rsp]->[fanout]，录制一个线程 [opus]  */
+/* ------------------------------------------------------------------ */
+
+static size_t node_conv(void *ctx, const void *in, size_t n, void *out)
+{
+    capture_conv_s16(&((bench_chain_t *)ctx)->conv, in, out, n);
+    return n;
+}
+
+static size_t node_rsp(void *ctx, const void *in, size_t n, void *out)
+{
+    return polyphase_rsp_process(&((bench_chain_t *)ctx)->rsp, in, n, out);
+}
+
+static size_t node_fanout(void *ctx, const void *in, size_t n, void *out)
+{
+    (void)out;
+    chain_sink(ctx, in, n);
+    return 0;
+}
+
+static size_t node_opus(void *ctx, const void *in, size_t n, void *out)
+{
+    (void)out;
+    enc_feed(&((bench_chain_t *)ctx)->enc, in, n);
+    return 0;
+}
+
+typedef struct {
+    bench_chain_t *c;
+    audio_graph_t *cap;
+    audio_graph_t *rec;
+    uint64_t total_in;
+} bench_graph_t;
+
+static void *graph_cap(void *arg)
+{
+    bench_graph_t *g = arg;
+    uint32_t words = g->c->cfg.in_block;
+    int32_t *rx = calloc(words + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t), sizeof(int32_t));
+    while (g->c->src.sig.pos < g->total_in) {
+        src_read(&g->c->src, rx, words);
+        audio_graph_run(g->cap, rx, words);
+    }
+    g->c->src_done = true;
+    sem_give(&g->c->sem);
+    free(rx);
+    return NULL;
+}
+
+static void *graph_rec(void *arg)
+{
+    bench_graph_t *g = arg;
+    const audio_block_t *blk;
+    while ((blk = chain_pull(g->c)) != NULL) {
+        audio_graph_run(g->rec, blk->samples, blk->count);
+        audio_fanout_release(g->c->fo, blk);
+    }
+    return NULL;
+}
+
+static uint32_t graph_clock(void)
+{
+    return (uint32_t)(now_ns() / 1000);
+}
+
+/* ------------------------------------------------------------------ */
+/* 运行与报告                                                          */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const char *name;
+    uint32_t threads;
+    uint64_t cpu_ns;
+    long csw;
+    uint32_t frames;
+    uint32_t speech;
+    double lat_avg_ms;
+    double lat_p95_ms;
+    double lat_max_ms;
+    size_t stack_bytes;         // 固件中对应任务的堆栈
+    size_t buf_bytes;           // 环形缓冲区与元素/节拍缓冲
+    size_t rb_peak;             // 各环形缓冲区峰值水位之和
+} bench_result_t;
+
+static long csw_now(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_nvcsw + ru.ru_nivcsw;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void chain_init(bench_chain_t *c, const bench_cfg_t *cfg)
+{
+    memset(c, 0, sizeof(*c));
+    c->cfg = *cfg;
+    capture_conv_cfg_t conv_cfg = {.gain_q12 = 4096, .dc_shift = 10};
+    capture_conv_init(&c->conv, &conv_cfg);
+    polyphase_rsp_reset(&c->rsp);
+    c->fo = audio_fanout_create(NULL, BENCH_BLOCKS, cfg->block);
+    pthread_mutex_init(&c->sem.mu, NULL);
+    pthread_cond_init(&c->sem.cv, NULL);
+    c->consumer = audio_fanout_subscribe(c->fo, BENCH_DEPTH, sem_give, &c->sem);
+    voice_activity_cfg_t va_cfg = DEFAULT_VOICE_ACTIVITY_CONFIG();
+    c->enc.cfg = &c->cfg;
+    c->enc.vad = voice_activity_create(&va_cfg);
+    c->enc.pcm = calloc(cfg->block, sizeof(int16_t));
+    c->enc.lat_us = calloc(BENCH_MAX_FRAMES, sizeof(uint32_t));
+    bench_signal_init(&c->src.sig, BENCH_IN_RATE, 2000000.0, 0, 1);
+    if (!c->fo || !c->consumer || !c->enc.vad || !c->enc.pcm || !c->enc.lat_us) {
+        fprintf(stderr, "alloc failed\n");
+        exit(1);
+    }
+}
+
+static void chain_finish(bench_chain_t *c, bench_result_t *r)
+{
+    r->frames = c->enc.frames;
+    r->speech = c->enc.speech;
+    uint32_t n = c->enc.frames < BENCH_MAX_FRAMES ? c->enc.frames : BENCH_MAX_FRAMES;
+    qsort(c->enc.lat_us, n, sizeof(uint32_t), cmp_u32);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum += c->enc.lat_us[i];
+    }
+    r->lat_avg_ms = n ? sum / 1000.0 / n : 0;
+    r->lat_p95_ms = n ? c->enc.lat_us[n * 95 / 100] / 1000.0 : 0;
+    r->lat_max_ms = n ? c->enc.lat_us[n - 1] / 1000.0 : 0;
+    if (c->cur) {
+        audio_fanout_release(c->fo, c->cur);
+    }
+    audio_fanout_unsubscribe(c->fo, c->consumer);
+    audio_fanout_destroy(c->fo);
+    voice_activity_destroy(c->enc.vad);
+    free(c->enc.pcm);
+    free(c->enc.lat_us);
+}
+
+static void run_adf(const bench_cfg_t *cfg, bench_result_t *r)
+{
+    bench_chain_t c;
+    chain_init(&c, cfg);
+    bench_adf_t a = {.c = &c, .total_in = (uint64_t)cfg->seconds * BENCH_IN_RATE};
+    const bench_profile_t *pf = cfg->pf;
+    rb_init(&a.i2s_rb, pf->i2s_rb_size);
+    rb_init(&a.rsp_rb, pf->element_rb_size);
+    rb_init(&a.reader_rb, pf->element_rb_size);
+
+    void *(*fn[5])(void *) = {adf_i2s, adf_rsp, adf_fanout, adf_reader, adf_opus};
+    pthread_t th[5];
+    long csw0 = csw_now();
+    uint64_t cpu0 = cpu_ns();
+    c.src.t0 = c.enc.t0 = now_ns();
+    for (int i = 4; i >= 0; i--) {
+        pthread_create(&th[i], NULL, fn[i], &a);
+    }
+    for (int i = 0; i < 5; i++) {
+        pthread_join(th[i], NULL);
+    }
+    r->cpu_ns = cpu_ns() - cpu0;
+    r->csw = csw_now() - csw0;
+    r->name = "adf";
+    r->threads = 5;
+    r->stack_bytes = FW_I2S_STACK + 3 * FW_ELEMENT_STACK + FW_OPUS_STACK;
+    // 环形缓冲区 + 各元素的 buffer_len（i2s读取块、重采样 raw/pcm/out、扇出、读取、编码帧）
+    r->buf_bytes = pf->i2s_rb_size + 2 * pf->element_rb_size + pf->i2s_buffer_len +
+                   FW_RSP_BUF + CAPTURE_CONV_PAD_BYTES + FW_RSP_BUF / 2 + polyphase_rsp_max_output(FW_RSP_BUF / 4) * 2 +
+                   3 * cfg->block * sizeof(int16_t);
+    r->rb_peak = a.i2s_rb.peak + a.rsp_rb.peak + a.reader_rb.peak;
+    chain_finish(&c, r);
+    free(a.i2s_rb.buf);
+    free(a.rsp_rb.buf);
+    free(a.reader_rb.buf);
+}
+
+static void run_graph(const bench_cfg_t *cfg, bench_result_t *r, bool trace)
+{
+    bench_chain_t c;
+    chain_init(&c, cfg);
+    bench_graph_t g = {.c = &c, .total_in = (uint64_t)cfg->seconds * BENCH_IN_RATE};
+    audio_graph_cfg_t cap_cfg = DEFAULT_AUDIO_GRAPH_CONFIG();
+    cap_cfg.buf_bytes = cfg->in_block * sizeof(int16_t);
+    cap_cfg.frame_us = cfg->block * 1000000 / BENCH_OUT_RATE;
+    cap_cfg.clock_us = graph_clock;
+    g.cap = audio_graph_create(&cap_cfg);
+    audio_graph_cfg_t rec_cfg = cap_cfg;
+    rec_cfg.buf_bytes = 0;
+    g.rec = audio_graph_create(&rec_cfg);
+    if (!g.cap || !g.rec) {
+        fprintf(stderr, "alloc failed\n");
+        exit(1);
+    }
+    audio_graph_add(g.cap, "cap_conv", node_conv, &c, false);
+    audio_graph_add(g.cap, "cap_rsp", node_rsp, &c, false);
+    audio_graph_add(g.cap, "cap_fanout", node_fanout, &c, false);
+    audio_graph_add(g.rec, "rec_opus", node_opus, &c, false);
+
+    pthread_t th[2];
+    long csw0 = csw_now();
+    uint64_t cpu0 = cpu_ns();
+    c.src.t0 = c.enc.t0 = now_ns();
+    pthread_create(&th[1], NULL, graph_rec, &g);
+    pthread_create(&th[0], NULL, graph_cap, &g);
+    pthread_join(th[0], NULL);
+    pthread_join(th[1], NULL);
+    r->cpu_ns = cpu_ns() - cpu0;
+    r->csw = csw_now() - csw0;
+    r->name = "graph";
+    r->threads = 2;
+    r->stack_bytes = FW_GRAPH_STACK + FW_OPUS_STACK;
+    // 节拍读取缓冲 + 重采样状态 + 两块工作缓冲 + 编码帧缓冲
+    r->buf_bytes = (cfg->in_block * sizeof(int32_t) + CAPTURE_CONV_PAD_BYTES) + sizeof(polyphase_rsp_t) +
+                   audio_graph_mem_size(&cap_cfg, AUDIO_ARENA_INTERNAL) + audio_graph_mem_size(&rec_cfg, AUDIO_ARENA_INTERNAL) +
+                   cfg->block * sizeof(int16_t);
+    r->rb_peak = 0;
+    if (trace) {
+        audio_graph_node_stats_t nodes[AUDIO_GRAPH_MAX_NODES];
+        audio_graph_stats_t st;
+        int n = audio_graph_get_stats(g.cap, &st, nodes, AUDIO_GRAPH_MAX_NODES);
+        printf("  cap graph: %u frames, avg %.1f us, peak %u us, overruns %u\n",
+               st.frames, (double)st.total_us / st.frames, st.peak_us, st.overruns);
+        for (int i = 0; i < n; i++) {
+            printf("    %-10s calls %6u  avg %6.2f us  peak %4u us  out %llu\n", nodes[i].name, nodes[i].calls,
+                   nodes[i].calls ? (double)nodes[i].total_us / nodes[i].calls : 0, nodes[i].peak_us,
+                   (unsigned long long)nodes[i].samples_out);
+        }
+    }
+    chain_finish(&c, r);
+    audio_graph_destroy(g.cap);
+    audio_graph_destroy(g.rec);
+}
+
+static void report(const bench_cfg_t *cfg, const bench_result_t *r)
+{
+    printf("%-6s: %u threads, cpu %6.2f ms/s audio, %6.1f ctx switches/s, stacks %5zu B, buffers %5zu B (rb peak %4zu B), "
+           "latency avg %5.2f ms p95 %5.2f ms max %5.2f ms, %u frames (%u speech)\n",
+           r->name, r->threads, r->cpu_ns / 1e6 / cfg->seconds, (double)r->csw / cfg->seconds, r->stack_bytes,
+           r->buf_bytes, r->rb_peak, r->lat_avg_ms, r->lat_p95_ms, r->lat_max_ms, r->frames, r->speech);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: graph_bench run [--profile ultra-low|balanced] [--seconds n] [--encode-us n] [--trace]\n"
+            "runs capture (i2s -> convert -> resample -> fanout) + recorder (reader -> vad/encode)\n"
+            "in real time, once as one-thread-per-element with ring buffers (ADF) and once as audio_graph\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 1;
+    }
+    bench_cfg_t cfg = {.pf = &s_profiles[0], .seconds = 5, .encode_us = 0};
+    bool trace = false;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--profile") && i + 1 < argc) {
+            i++;
+            cfg.pf = NULL;
+            for (size_t k = 0; k < sizeof(s_profiles) / sizeof(s_profiles[0]); k++) {
+                if (!strcmp(argv[i], s_profiles[k].name)) {
+                    cfg.pf = &s_profiles[k];
+                }
+            }
+            if (!cfg.pf) {
+                usage();
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            cfg.seconds = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--encode-us") && i + 1 < argc) {
+            cfg.encode_us = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--trace")) {
+            trace = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    cfg.block = BENCH_OUT_RATE * cfg.pf->block_ms / 1000;
+    cfg.in_block = BENCH_IN_RATE * cfg.pf->block_ms / 1000;
+    printf("profile %s: block %u ms, %u s real time, encode stand-in %u us/frame\n",
+           cfg.pf->name, cfg.pf->block_ms, cfg.seconds, cfg.encode_us);
+
+    bench_result_t adf, graph;
+    run_adf(&cfg, &adf);
+    run_graph(&cfg, &graph, trace);
+    report(&cfg, &adf);
+    report(&cfg, &graph);
+    return 0;
+}
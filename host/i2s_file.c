@@ -0,0 +1,230 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 12:00:00
+ * @LastEditTime: 2026-10-16 12:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端I2S替身实现（WAV文件读写 + 可选实时节拍）
+ * @FilePath: \audio_manager\host\i2s_file.c
+ * 遇事不决，可问春风
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "i2s_file.h"
+
+struct i2s_file {
+    FILE *fp;                   // 文件
+    bool writer;                // 是否为写入端
+    bool realtime;              // 是否按采样率节拍
+    int sample_rate;            // 采样率
+    int channels;               // 通道数
+    int file_bits;              // 文件中的位宽
+    int out_bits;               // 对外样点位宽（24位展开为32）
+    uint64_t frames;            // 已读写的帧数
+    uint64_t data_left;         // 读取端剩余数据字节
+    uint32_t data_bytes;        // 写入端已写数据字节
+    struct timespec start;      // 首次读写的时间
+};
+
+static uint32_t rd_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void wr_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+static void wr_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+/**
+ * @brief 实时节拍：等待到已处理帧数对应的时刻
+ */
+static void i2s_file_pace(i2s_file_t *f)
+{
+    if (!f->realtime) {
+        return;
+    }
+    if (f->frames == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &f->start);
+        return;
+    }
+    uint64_t due_ns = f->frames * 1000000000ull / f->sample_rate;
+    struct timespec due = f->start;
+    due.tv_sec += due_ns / 1000000000ull;
+    due.tv_nsec += due_ns % 1000000000ull;
+    if (due.tv_nsec >= 1000000000L) {
+        due.tv_sec++;
+        due.tv_nsec -= 1000000000L;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL);
+}
+
+i2s_file_t *i2s_file_open_reader(const char *path, bool realtime)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    uint8_t hdr[12];
+    if (fread(hdr, 1, 12, fp) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4)) {
+        fclose(fp);
+        return NULL;
+    }
+    i2s_file_t *f = calloc(1, sizeof(i2s_file_t));
+    if (!f) {
+        fclose(fp);
+        return NULL;
+    }
+    f->fp = fp;
+    f->realtime = realtime;
+    // 依次遍历块，找到 fmt 与 data
+    uint8_t ck[8];
+    while (fread(ck, 1, 8, fp) == 8) {
+        uint32_t size = rd_le32(ck + 4);
+        if (!memcmp(ck, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, fp) != 16) {
+                break;
+            }
+            f->channels = rd_le16(fmt + 2);
+            f->sample_rate = (int)rd_le32(fmt + 4);
+            f->file_bits = rd_le16(fmt + 14);
+            fseek(fp, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (!memcmp(ck, "data", 4)) {
+            f->data_left = size;
+            break;
+        } else {
+            fseek(fp, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    if (f->sample_rate <= 0 || f->channels <= 0 || f->data_left == 0 ||
+            (f->file_bits != 16 && f->file_bits != 24 && f->file_bits != 32)) {
+        i2s_file_close(f);
+        return NULL;
+    }
+    f->out_bits = f->file_bits == 24 ? 32 : f->file_bits;
+    return f;
+}
+
+i2s_file_t *i2s_file_open_writer(const char *path, int sample_rate, int channels, int bits, bool realtime)
+{
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        return NULL;
+    }
+    i2s_file_t *f = calloc(1, sizeof(i2s_file_t));
+    if (!f) {
+        fclose(fp);
+        return NULL;
+    }
+    f->fp = fp;
+    f->writer = true;
+    f->realtime = realtime;
+    f->sample_rate = sample_rate;
+    f->channels = channels;
+    f->file_bits = bits;
+    f->out_bits = bits;
+    uint8_t hdr[44] = {0};
+    fwrite(hdr, 1, sizeof(hdr), fp);    // 关闭时回填
+    return f;
+}
+
+int i2s_file_read(i2s_file_t *f, void *buf, size_t bytes)
+{
+    int out_bps = f->out_bits / 8;
+    int file_bps = f->file_bits / 8;
+    size_t frames = bytes / (out_bps * f->channels);
+    size_t avail = f->data_left / (file_bps * f->channels);
+    if (frames > avail) {
+        frames = avail;
+    }
+    if (frames == 0) {
+        return 0;
+    }
+    i2s_file_pace(f);
+    size_t samples = frames * f->channels;
+    if (f->file_bits != 24) {
+        samples = fread(buf, file_bps, samples, f->fp);
+    } else {
+        // 24位样点展开为32位字，低8位补0，与I2S DMA数据布局一致
+        uint8_t *dst = (uint8_t *)buf;
+        uint8_t s[3];
+        size_t i = 0;
+        for (; i < samples && fread(s, 1, 3, f->fp) == 3; i++) {
+            dst[4 * i + 0] = 0;
+            dst[4 * i + 1] = s[0];
+            dst[4 * i + 2] = s[1];
+            dst[4 * i + 3] = s[2];
+        }
+        samples = i;
+    }
+    frames = samples / f->channels;
+    f->data_left -= frames * f->channels * file_bps;
+    f->frames += frames;
+    return (int)(frames * f->channels * out_bps);
+}
+
+int i2s_file_write(i2s_file_t *f, const void *buf, size_t bytes)
+{
+    i2s_file_pace(f);
+    size_t n = fwrite(buf, 1, bytes, f->fp);
+    f->data_bytes += (uint32_t)n;
+    f->frames += n / (f->out_bits / 8 * f->channels);
+    return (int)n;
+}
+
+void i2s_file_get_format(const i2s_file_t *f, int *sample_rate, int *channels, int *bits)
+{
+    if (sample_rate) {
+        *sample_rate = f->sample_rate;
+    }
+    if (channels) {
+        *channels = f->channels;
+    }
+    if (bits) {
+        *bits = f->out_bits;
+    }
+}
+
+void i2s_file_close(i2s_file_t *f)
+{
+    if (!f) {
+        return;
+    }
+    if (f->writer) {
+        uint8_t h[44];
+        int block = f->channels * f->file_bits / 8;
+        memcpy(h, "RIFF", 4);
+        wr_le32(h + 4, 36 + f->data_bytes);
+        memcpy(h + 8, "WAVEfmt ", 8);
+        wr_le32(h + 16, 16);
+        wr_le16(h + 20, 1);
+        wr_le16(h + 22, (uint16_t)f->channels);
+        wr_le32(h + 24, (uint32_t)f->sample_rate);
+        wr_le32(h + 28, (uint32_t)(f->sample_rate * block));
+        wr_le16(h + 32, (uint16_t)block);
+        wr_le16(h + 34, (uint16_t)f->file_bits);
+        memcpy(h + 36, "data", 4);
+        wr_le32(h + 40, f->data_bytes);
+        fseek(f->fp, 0, SEEK_SET);
+        fwrite(h, 1, sizeof(h), f->fp);
+    }
+    fclose(f->fp);
+    free(f);
+}
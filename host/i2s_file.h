@@ -0,0 +1,69 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 12:00:00
+ * @LastEditTime: 2026-10-16 12:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端I2S替身：以WAV/PCM文件代替I2S读写，支持实时节拍或尽快运行
+ * @FilePath: \audio_manager\host\i2s_file.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct i2s_file i2s_file_t;
+
+/**
+ * @brief 打开WAV文件作为I2S输入（替代 i2s_stream reader）
+ *
+ * 支持16/24/32位PCM；24位样点按I2S DMA的方式展开为32位字（高24位有效）。
+ *
+ * @param path     WAV文件路径
+ * @param realtime true 按采样率节拍读取，false 尽快读取
+ * @return 句柄，失败返回NULL
+ */
+i2s_file_t *i2s_file_open_reader(const char *path, bool realtime);
+
+/**
+ * @brief 打开WAV文件作为I2S输出（替代 i2s_stream writer）
+ *
+ * @param path        WAV文件路径
+ * @param sample_rate 采样率
+ * @param channels    通道数
+ * @param bits        位宽（16或32）
+ * @param realtime    true 按采样率节拍写入，false 尽快写入
+ * @return 句柄，失败返回NULL
+ */
+i2s_file_t *i2s_file_open_writer(const char *path, int sample_rate, int channels, int bits, bool realtime);
+
+/**
+ * @brief 读取样点（与 i2s_read 语义一致：返回实际字节数，文件结束返回0）
+ *
+ * 24位输入每个样点返回4字节（32位字），其余位宽按原样返回。
+ */
+int i2s_file_read(i2s_file_t *f, void *buf, size_t bytes);
+
+/**
+ * @brief 写入样点，返回实际字节数
+ */
+int i2s_file_write(i2s_file_t *f, const void *buf, size_t bytes);
+
+/**
+ * @brief 获取格式（bits 为每个返回样点的字节数*8，24位输入返回32）
+ */
+void i2s_file_get_format(const i2s_file_t *f, int *sample_rate, int *channels, int *bits);
+
+/**
+ * @brief 关闭文件，写入端会回填WAV头长度
+ */
+void i2s_file_close(i2s_file_t *f);
+
+#ifdef __cplusplus
+}
+#endif
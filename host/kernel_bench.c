@@ -0,0 +1,175 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 16:00:00
+ * @LastEditTime: 2026-10-17 16:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端DSP内核微基准：按纳秒/样点计时，与树内基线比较，有回退时以非0退出，可选双精度精度比较
+ * @FilePath: \audio_manager\host\kernel_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "dsp_bench.h"
+
+#define BENCH_BATCH_NS      1000000             // 每批至少1ms
+#define BENCH_BASELINE_MAX  (64 * 1024)         // 基线文件最大长度
+#define BENCH_MAX_REPEAT    15                  // 整套重复次数上限
+
+static uint32_t clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static char *read_text(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    char *text = calloc(1, BENCH_BASELINE_MAX + 1);
+    if (text) {
+        fread(text, 1, BENCH_BASELINE_MAX, f);
+    }
+    fclose(f);
+    return text;
+}
+
+static int save_baseline(const char *path, const dsp_bench_result_t *r, int count)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "# DSP内核基线（主机，ns/样点）：kernel_bench run --save 生成，同一台机器上比较才有意义\n");
+    fprintf(f, "# <内核> <信号> <块长> <每输入样点纳秒>\n");
+    for (int i = 0; i < count; i++) {
+        char line[64];
+        dsp_bench_format_baseline(&r[i], line, sizeof(line));
+        fprintf(f, "%s\n", line);
+    }
+    fclose(f);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: kernel_bench run [--filter name] [--verify] [--repeat n] [--baseline file] [--threshold pct]\n"
+            "                        [--save file]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 2;
+    }
+    dsp_bench_cfg_t cfg = {
+        .clock = clock_ns,
+        .batch_ticks = BENCH_BATCH_NS,
+    };
+    const char *baseline = NULL;
+    const char *save = NULL;
+    uint32_t threshold = DSP_BENCH_THRESHOLD_PCT;
+    int repeat = 5;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--verify")) {
+            cfg.verify = true;
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            cfg.filter = argv[++i];
+        } else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (!strcmp(argv[i], "--threshold") && i + 1 < argc) {
+            threshold = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--save") && i + 1 < argc) {
+            save = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    // 整套跑 repeat 遍，每项取中位数：最快一遍常受睿频影响、最慢一遍常受其他进程干扰
+    static dsp_bench_result_t results[DSP_BENCH_MAX_RESULTS];
+    static dsp_bench_result_t pass[DSP_BENCH_MAX_RESULTS];
+    static dsp_bench_baseline_t base[DSP_BENCH_MAX_RESULTS];
+    static uint32_t samples[BENCH_MAX_REPEAT][DSP_BENCH_MAX_RESULTS];
+    if (repeat < 1 || repeat > BENCH_MAX_REPEAT) {
+        repeat = repeat < 1 ? 1 : BENCH_MAX_REPEAT;
+    }
+    bool verify = cfg.verify;
+    int count = dsp_bench_run(&cfg, results, DSP_BENCH_MAX_RESULTS);
+    for (int i = 0; i < count; i++) {
+        samples[0][i] = results[i].milli_per_sample;
+    }
+    cfg.verify = false;
+    for (int p = 1; p < repeat && count > 0; p++) {
+        dsp_bench_run(&cfg, pass, count);
+        for (int i = 0; i < count; i++) {
+            samples[p][i] = pass[i].milli_per_sample;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        uint32_t v[BENCH_MAX_REPEAT];
+        for (int p = 0; p < repeat; p++) {
+            v[p] = samples[p][i];
+        }
+        qsort(v, repeat, sizeof(v[0]), cmp_u32);
+        results[i].milli_per_sample = v[repeat / 2];
+    }
+    if (count < 0) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    int base_count = 0;
+    if (baseline) {
+        char *text = read_text(baseline);
+        if (!text) {
+            perror(baseline);
+            return 2;
+        }
+        base_count = dsp_bench_parse_baseline(text, base, DSP_BENCH_MAX_RESULTS);
+        free(text);
+    }
+    int regressed = dsp_bench_compare(results, count, base, base_count, threshold);
+
+    static const char *const status[] = {"new", "ok", "faster", "REGRESSED"};
+    printf("%-14s %-6s %5s %10s %7s %-9s", "kernel", "signal", "n", "ns/sample", "delta", "status");
+    printf(verify ? " %9s %7s\n" : "\n", "snr dB", "max err");
+    for (int i = 0; i < count; i++) {
+        const dsp_bench_result_t *r = &results[i];
+        printf("%-14s %-6s %5u %10.3f %+6d%% %-9s", r->kernel, r->signal, r->n, r->milli_per_sample / 1000.0,
+               (int)r->delta_pct, baseline ? status[r->status] : "-");
+        if (r->verified) {
+            printf(" %9.1f %7d\n", r->snr_db, (int)r->max_err);
+        } else {
+            printf("\n");
+        }
+    }
+    if (baseline && base_count == 0) {
+        fprintf(stderr, "warning: no baseline entries in %s - regression check disabled\n", baseline);
+    } else if (baseline) {
+        printf("%d results, %d baselines, %d regressed beyond %u%%\n", count, base_count, regressed,
+               (unsigned)threshold);
+    }
+    if (save && save_baseline(save, results, count) != 0) {
+        return 2;
+    }
+    return regressed > 0 ? 1 : 0;
+}
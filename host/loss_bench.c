@@ -0,0 +1,543 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端丢包抗性测试：按20ms帧时间轴编码语音状信号，按设定丢包率（可带突发）丢包后
+ *               经 opus_mixer（抖动缓冲 + 冗余封装 + FEC/PLC）解码，对比无保护、带内FEC、RED 各模式
+ *               相对无丢包解码的分段信噪比、恢复/隐藏帧数与码率开销
+ * @FilePath: \audio_manager\host\loss_bench.c
+ * 遇事不决，可问春风
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "opus_mixer.h"
+#include "opus_red.h"
+#ifdef HOST_HAVE_OPUS
+#include <opus.h>
+#endif
+
+#define BENCH_RATE          16000       // 编码采样率（同 AUDIO_CAPTURE_SAMPLE_RATE）
+#define BENCH_FRAME         320         // 20ms 帧
+#define BENCH_FRAME_MS      20
+#define BENCH_MAX_PACKET    512         // 单包最大长度（同 OPUS_RECORDER_SLOT_SIZE）
+#define BENCH_RED_BLOCK     512         // 进入冗余历史的单帧上限（同 OPUS_PKT_RED_BLOCK_BYTES）
+#define BENCH_FLUSH_FRAMES  10          // 输入结束后继续混音的帧数，取完抖动缓冲中的余量
+#define BENCH_SNR_FLOOR     1e3         // 参考帧能量低于此值（约-50dBFS）视为静音，不计入信噪比
+#define BENCH_LEAD_FRAMES   8           // 起播前的帧不丢，各模式与参考从同一序号开始播放
+
+// 替身编解码（无libopus时）：主负载为4倍抽取后的μ律（80字节/帧，32kbps），
+// FEC为前一帧16倍抽取后的μ律（20字节），附在主负载之后，解码端以 fec=1 取用
+#define STANDIN_PRIMARY_DEC 4
+#define STANDIN_LBRR_DEC    16
+#define STANDIN_PRIMARY     (BENCH_FRAME / STANDIN_PRIMARY_DEC)
+#define STANDIN_LBRR        (BENCH_FRAME / STANDIN_LBRR_DEC)
+
+/**
+ * @brief 对比的保护模式
+ */
+typedef struct {
+    const char *name;
+    bool fec;                   // 带内FEC
+    uint8_t red_depth;          // 冗余封装深度
+} bench_mode_t;
+
+static const bench_mode_t s_modes[] = {
+    { "none",     false, 0 },
+    { "fec",      true,  0 },
+    { "red1",     false, 1 },
+    { "red2",     false, 2 },
+    { "fec+red1", true,  1 },
+};
+#define BENCH_MODES (sizeof(s_modes) / sizeof(s_modes[0]))
+
+typedef struct {
+    double seconds;
+    int bitrate;
+    double burst;               // 平均突发长度（帧），1 为独立丢包（Bernoulli）
+    const double *losses;
+    int loss_count;
+} bench_cfg_t;
+
+typedef struct {
+    uint32_t frames;            // 输出帧数
+    uint64_t bytes;             // 发送字节数（含丢掉的包）
+    uint32_t lost;              // 丢掉的包数
+    jitter_buffer_stats_t jb;   // 抖动缓冲统计
+} bench_result_t;
+
+static uint32_t rnd(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+static double rnd_unit(uint32_t *seed)
+{
+    return (rnd(seed) & 0xFFFFFF) / 16777216.0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 编解码（有libopus时使用Opus，否则用μ律替身验证恢复路径）            */
+/* ------------------------------------------------------------------ */
+
+#ifndef HOST_HAVE_OPUS
+static uint8_t ulaw_encode(int16_t s)
+{
+    int sign = s < 0 ? 0x80 : 0;
+    int v = s < 0 ? -(int)s : s;
+    if (v > 32635) {
+        v = 32635;
+    }
+    v += 0x84;
+    int exp = 7;
+    for (int m = 0x4000; !(v & m) && exp > 0; m >>= 1) {
+        exp--;
+    }
+    int mant = (v >> (exp + 3)) & 0x0F;
+    return (uint8_t)~(sign | exp << 4 | mant);
+}
+
+static int16_t ulaw_decode(uint8_t u)
+{
+    u = (uint8_t)~u;
+    int exp = (u >> 4) & 7;
+    int v = ((((u & 0x0F) << 3) + 0x84) << exp) - 0x84;
+    return (int16_t)(u & 0x80 ? -v : v);
+}
+
+/**
+ * @brief 按 dec 倍平均抽取后μ律编码
+ */
+static void standin_pack(const int16_t *pcm, int dec, uint8_t *out)
+{
+    for (int i = 0; i < BENCH_FRAME / dec; i++) {
+        int32_t acc = 0;
+        for (int j = 0; j < dec; j++) {
+            acc += pcm[i * dec + j];
+        }
+        out[i] = ulaw_encode((int16_t)(acc / dec));
+    }
+}
+
+/**
+ * @brief μ律解码后线性插值回整帧，tail 为上一帧最后一个样点（保持帧间连续）
+ */
+static void standin_unpack(const uint8_t *in, int dec, int16_t tail, int16_t *pcm)
+{
+    int16_t prev = tail;
+    for (int i = 0; i < BENCH_FRAME / dec; i++) {
+        int16_t cur = ulaw_decode(in[i]);
+        for (int j = 0; j < dec; j++) {
+            pcm[i * dec + j] = (int16_t)(prev + (cur - prev) * (j + 1) / dec);
+        }
+        prev = cur;
+    }
+}
+#endif
+
+typedef struct {
+#ifdef HOST_HAVE_OPUS
+    OpusEncoder *enc;
+#else
+    bool fec;
+    bool has_prev;
+    int16_t prev[BENCH_FRAME];      // 上一帧，供FEC附带其粗略副本
+#endif
+} bench_enc_t;
+
+static int enc_open(bench_enc_t *e, bool fec, int bitrate, int loss_pct)
+{
+    memset(e, 0, sizeof(*e));
+#ifdef HOST_HAVE_OPUS
+    int err = OPUS_OK;
+    e->enc = opus_encoder_create(BENCH_RATE, 1, OPUS_APPLICATION_VOIP, &err);
+    if (err != OPUS_OK) {
+        return -1;
+    }
+    opus_encoder_ctl(e->enc, OPUS_SET_BITRATE(bitrate));
+    opus_encoder_ctl(e->enc, OPUS_SET_COMPLEXITY(5));
+    opus_encoder_ctl(e->enc, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+    opus_encoder_ctl(e->enc, OPUS_SET_INBAND_FEC(fec ? 1 : 0));
+    // libopus 只在预期丢包率非0时编入LBRR，与接收端反馈的丢包率一致
+    opus_encoder_ctl(e->enc, OPUS_SET_PACKET_LOSS_PERC(fec ? (loss_pct > 0 ? loss_pct : 1) : 0));
+#else
+    (void)bitrate;
+    (void)loss_pct;
+    e->fec = fec;
+#endif
+    return 0;
+}
+
+static void enc_close(bench_enc_t *e)
+{
+#ifdef HOST_HAVE_OPUS
+    opus_encoder_destroy(e->enc);
+#else
+    (void)e;
+#endif
+}
+
+static int enc_encode(bench_enc_t *e, const int16_t *pcm, uint8_t *out, int cap)
+{
+#ifdef HOST_HAVE_OPUS
+    return opus_encode(e->enc, pcm, BENCH_FRAME, out, cap);
+#else
+    int n = STANDIN_PRIMARY + (e->fec && e->has_prev ? STANDIN_LBRR : 0);
+    if (n > cap) {
+        return -1;
+    }
+    standin_pack(pcm, STANDIN_PRIMARY_DEC, out);
+    if (e->fec && e->has_prev) {
+        standin_pack(e->prev, STANDIN_LBRR_DEC, out + STANDIN_PRIMARY);
+    }
+    memcpy(e->prev, pcm, sizeof(e->prev));
+    e->has_prev = true;
+    return n;
+#endif
+}
+
+#ifdef HOST_HAVE_OPUS
+static size_t dec_state_size(int channels)
+{
+    return (size_t)opus_decoder_get_size(channels);
+}
+
+static int dec_state_init(void *state, int sample_rate, int channels)
+{
+    return opus_decoder_init((OpusDecoder *)state, sample_rate, channels) == OPUS_OK ? 0 : -1;
+}
+
+static int dec_state_decode(void *state, const uint8_t *data, int len, int16_t *pcm, int max_samples, int fec)
+{
+    return opus_decode((OpusDecoder *)state, data, len, pcm, max_samples, fec);
+}
+#else
+typedef struct {
+    int16_t last[BENCH_FRAME];      // 上一帧输出（PLC重复并衰减）
+    uint8_t plc_run;                // 连续隐藏帧数
+} standin_dec_t;
+
+static size_t dec_state_size(int channels)
+{
+    (void)channels;
+    return sizeof(standin_dec_t);
+}
+
+static int dec_state_init(void *state, int sample_rate, int channels)
+{
+    (void)sample_rate;
+    (void)channels;
+    memset(state, 0, sizeof(standin_dec_t));
+    return 0;
+}
+
+static int dec_state_decode(void *state, const uint8_t *data, int len, int16_t *pcm, int max_samples, int fec)
+{
+    standin_dec_t *d = state;
+    if (max_samples < BENCH_FRAME) {
+        return -1;
+    }
+    int16_t tail = d->last[BENCH_FRAME - 1];
+    if (data && !fec && len >= STANDIN_PRIMARY) {
+        standin_unpack(data, STANDIN_PRIMARY_DEC, tail, pcm);
+        d->plc_run = 0;
+    } else if (data && fec && len >= STANDIN_PRIMARY + STANDIN_LBRR) {
+        standin_unpack(data + STANDIN_PRIMARY, STANDIN_LBRR_DEC, tail, pcm);
+        d->plc_run = 0;
+    } else {
+        // 包内没有FEC数据时与缺包一样做隐藏：重复上一帧，每帧衰减一半
+        d->plc_run++;
+        for (int i = 0; i < BENCH_FRAME; i++) {
+            pcm[i] = (int16_t)(d->last[i] / 2);
+        }
+    }
+    memcpy(d->last, pcm, sizeof(d->last));
+    return BENCH_FRAME;
+}
+#endif
+
+static const opus_mixer_codec_t s_codec = {
+    .state_size = dec_state_size,
+    .init = dec_state_init,
+    .decode = dec_state_decode,
+};
+
+/* ------------------------------------------------------------------ */
+/* 测试信号与评估                                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 语音状信号：基频在110~220Hz间滑动的谐波串，按共振峰加权，4Hz音节包络，每2秒末尾0.6秒静音
+ */
+static void gen_speech(int16_t *pcm, uint32_t samples)
+{
+    static const double formant[3] = { 500, 1500, 2500 };
+    double phase = 0;
+    uint32_t seed = 11;
+    for (uint32_t i = 0; i < samples; i++) {
+        double t = (double)i / BENCH_RATE;
+        double f0 = 165 + 55 * sin(2 * M_PI * 0.7 * t);
+        phase += 2 * M_PI * f0 / BENCH_RATE;
+        double env = fmod(t, 2.0) < 1.4 ? 0.5 * (1 - cos(2 * M_PI * 4 * t)) : 0.0;
+        double v = 0;
+        for (int h = 1; h * f0 < 3400; h++) {
+            double w = 0;
+            for (int k = 0; k < 3; k++) {
+                double d = (h * f0 - formant[k]) / 300.0;
+                w += exp(-d * d);
+            }
+            v += (0.05 + w) * sin(h * phase) / h;
+        }
+        v = 0.25 * env * v + 0.001 * (rnd_unit(&seed) * 2 - 1);
+        pcm[i] = (int16_t)lrint(fmax(-1.0, fmin(1.0, v)) * 32767);
+    }
+}
+
+/**
+ * @brief 分段信噪比：逐帧 10log10(参考能量/误差能量)，截断到 [-10, 40] dB，只统计参考为语音的帧
+ * @param mask 非NULL时只统计 mask 非0的帧（丢包帧）
+ */
+static double seg_snr(const int16_t *ref, const int16_t *out, uint32_t frames, const uint8_t *mask)
+{
+    double sum = 0;
+    uint32_t n = 0;
+    for (uint32_t f = 0; f < frames; f++) {
+        if (mask && !mask[f]) {
+            continue;
+        }
+        double es = 0, en = 0;
+        for (int i = 0; i < BENCH_FRAME; i++) {
+            double r = ref[f * BENCH_FRAME + i];
+            double d = r - out[f * BENCH_FRAME + i];
+            es += r * r;
+            en += d * d;
+        }
+        if (es / BENCH_FRAME < BENCH_SNR_FLOOR) {
+            continue;
+        }
+        double snr = en > 0 ? 10 * log10(es / en) : 40;
+        sum += fmax(-10.0, fmin(40.0, snr));
+        n++;
+    }
+    return n ? sum / n : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 单次运行：编码 -> 冗余封装 -> 丢包 -> opus_mixer                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 按模式与丢包率跑完整段信号；丢包序列只由丢包率与突发长度决定，各模式相同
+ *
+ * 输出按序号对齐：抖动缓冲为加深而插入的隐藏帧不计入输出，为减浅而丢弃的帧在输出中留空，
+ * 第 k 帧输出始终对应第 k 个包。lost 记录每帧的包是否丢失。
+ */
+static int run_one(const bench_cfg_t *cfg, const bench_mode_t *mode, double loss, const int16_t *pcm,
+                   uint32_t frames, int16_t *out, uint8_t *lost, bench_result_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    bench_enc_t enc;
+    if (enc_open(&enc, mode->fec, cfg->bitrate, (int)lrint(loss * 100)) != 0) {
+        return -1;
+    }
+    opus_red_t *red = mode->red_depth ? opus_red_create(NULL, mode->red_depth, BENCH_RED_BLOCK, 0) : NULL;
+    opus_mixer_cfg_t mix_cfg = DEFAULT_OPUS_MIXER_CONFIG();
+    mix_cfg.sample_rate = BENCH_RATE;
+    mix_cfg.frame_us = BENCH_FRAME_MS * 1000;
+    mix_cfg.codec = &s_codec;
+    mix_cfg.red = mode->red_depth > 0;
+    mix_cfg.fec = mode->fec;
+    // 副本晚 red_depth 帧到达，最小深度须容纳 red_depth + 1 帧
+    uint16_t min_ms = (uint16_t)((mode->red_depth + 1) * BENCH_FRAME_MS);
+    if (min_ms > mix_cfg.jitter_min_ms) {
+        mix_cfg.jitter_min_ms = min_ms;
+    }
+    opus_mixer_t *mix = opus_mixer_create(&mix_cfg);
+    opus_mixer_stream_t *s = mix ? opus_mixer_open(mix, AUDIO_MIX_UNITY) : NULL;
+    if ((mode->red_depth && !red) || !s) {
+        opus_mixer_destroy(mix);
+        opus_red_destroy(red);
+        enc_close(&enc);
+        return -1;
+    }
+
+    // Gilbert两状态丢包：好状态按 p_gb 进入突发，坏状态按 1/burst 退出，平均丢包率为 loss；
+    // 突发长度不超过独立丢包的平均值 1/(1-loss) 时即为独立丢包（p_gb = loss，p_bg = 1-loss）
+    double burst = cfg->burst * (1 - loss) > 1 ? cfg->burst : 1 / (1 - loss);
+    double p_bg = 1.0 / burst;
+    double p_gb = loss * p_bg / (1 - loss);
+    uint32_t seed = 0x5eed + (uint32_t)lrint(loss * 1000);
+    bool bad = false;
+
+    static uint8_t buf[BENCH_MAX_PACKET];
+    static int16_t mixed[BENCH_RATE * OPUS_MIXER_MAX_FRAME_MS / 1000] __attribute__((aligned(16)));
+    for (uint32_t k = 0; k < frames + BENCH_FLUSH_FRAMES && r->frames < frames; k++) {
+        if (k < frames) {
+            uint16_t seq = (uint16_t)k;
+            size_t off = red ? opus_red_begin(red, seq, buf, sizeof(buf)) : 0;
+            int n = enc_encode(&enc, pcm + (size_t)k * BENCH_FRAME, buf + off, (int)(sizeof(buf) - off));
+            if (n <= 0) {
+                break;
+            }
+            if (red) {
+                opus_red_push(red, seq, buf + off, (uint16_t)n);
+            }
+            r->bytes += off + n;
+            bad = rnd_unit(&seed) < (bad ? 1 - p_bg : p_gb);
+            lost[k] = bad && k >= BENCH_LEAD_FRAMES;
+            if (lost[k]) {
+                r->lost++;
+            } else {
+                opus_packet_t pkt = {
+                    .data = buf, .len = (uint16_t)(off + n), .cap = sizeof(buf),
+                    .seq = seq, .stream = opus_mixer_stream_id(s),
+                    .timestamp = k * BENCH_FRAME, .arrival_ms = k * BENCH_FRAME_MS,
+                };
+                opus_mixer_put(mix, &pkt);
+            }
+        }
+        int n = opus_mixer_mix(mix, mixed);
+        opus_mixer_stream_stats_t st;
+        opus_mixer_get_stream_stats(s, &st);
+        if (st.jb.dropped > r->jb.dropped) {
+            r->frames++;    // 被丢弃的帧：输出中留空（计为误差）
+        }
+        if (n == BENCH_FRAME && st.jb.inserted == r->jb.inserted && r->frames < frames) {
+            memcpy(out + (size_t)r->frames * BENCH_FRAME, mixed, sizeof(int16_t) * BENCH_FRAME);
+            r->frames++;
+        }
+        r->jb = st.jb;
+    }
+    if (r->frames > frames) {
+        r->frames = frames;
+    }
+    opus_mixer_destroy(mix);
+    opus_red_destroy(red);
+    enc_close(&enc);
+    return 0;
+}
+
+static int run(const bench_cfg_t *cfg)
+{
+    uint32_t frames = (uint32_t)(cfg->seconds * 1000 / BENCH_FRAME_MS);
+    size_t samples = (size_t)frames * BENCH_FRAME;
+    int16_t *pcm = malloc(samples * sizeof(int16_t));
+    int16_t *ref = calloc(samples, sizeof(int16_t));
+    int16_t *out = calloc(samples, sizeof(int16_t));
+    uint8_t *lost = calloc(frames, 1);
+    if (!pcm || !ref || !out || !lost) {
+        free(pcm);
+        free(ref);
+        free(out);
+        free(lost);
+        return 1;
+    }
+    gen_speech(pcm, (uint32_t)samples);
+
+#ifdef HOST_HAVE_OPUS
+    printf("%.0f s speech-like signal, libopus %d bps, 20 ms frames", cfg->seconds, cfg->bitrate);
+#else
+    printf("%.0f s speech-like signal, mu-law stand-in codec (no libopus): primary %d B, FEC copy %d B per 20 ms",
+           cfg->seconds, STANDIN_PRIMARY, STANDIN_LBRR);
+#endif
+    printf(", loss burst %.1f frames\n", cfg->burst);
+
+    // 参考：无保护、无丢包的解码输出；各模式的质量都相对它计算，只反映丢包与保护本身的影响
+    bench_result_t base;
+    if (run_one(cfg, &s_modes[0], 0, pcm, frames, ref, lost, &base) != 0) {
+        fprintf(stderr, "reference run failed\n");
+        return 1;
+    }
+    printf("reference       : %u frames, %.1f kbps, seg SNR vs input %.1f dB\n", base.frames,
+           base.bytes * 8.0 / cfg->seconds / 1000, seg_snr(pcm, ref, base.frames, NULL));
+    // fec 为抖动缓冲以下一包做FEC解码的帧数（只在发送端启用带内FEC的模式中出现）；ins/drop 为抖动缓冲
+    // 调整深度插入/丢弃的帧（插入帧不计入信噪比，丢弃帧计为误差）；lostSNR 只统计丢包帧
+    printf("%5s %-9s %7s %8s %6s %6s %6s %6s %6s %8s %8s %9s\n", "loss", "mode", "kbps", "overhead", "delay",
+           "lost", "fec", "red", "plc", "ins/drop", "segSNR", "lostSNR");
+
+    int ret = 0;
+    for (int l = 0; l < cfg->loss_count; l++) {
+        double loss = cfg->losses[l];
+        uint64_t none_bytes = 0;
+        for (size_t m = 0; m < BENCH_MODES; m++) {
+            bench_result_t r;
+            memset(out, 0, samples * sizeof(int16_t));
+            if (run_one(cfg, &s_modes[m], loss, pcm, frames, out, lost, &r) != 0) {
+                fprintf(stderr, "%s run failed\n", s_modes[m].name);
+                ret = 1;
+                continue;
+            }
+            if (m == 0) {
+                none_bytes = r.bytes;
+            }
+            printf("%4.0f%% %-9s %7.1f %7.1f%% %4u ms %6u %6u %6u %6u %4u/%-3u %5.1f dB %6.1f dB\n", loss * 100,
+                   s_modes[m].name, r.bytes * 8.0 / cfg->seconds / 1000,
+                   none_bytes ? (r.bytes * 100.0 / none_bytes - 100) : 0, r.jb.target_ms, r.lost, r.jb.fec,
+                   r.jb.redundant, r.jb.plc, r.jb.inserted, r.jb.dropped, seg_snr(ref, out, r.frames, NULL), seg_snr(ref, out, r.frames, lost));
+        }
+    }
+    free(pcm);
+    free(ref);
+    free(out);
+    free(lost);
+    return ret;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: loss_bench run [--seconds n] [--bitrate bps] [--burst frames] [--loss pct[,pct...]]\n"
+            "modes: none / fec (in-band LBRR) / red1 / red2 (previous frames piggybacked) / fec+red1\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 2;
+    }
+    static double losses[16] = { 0.01, 0.05, 0.10, 0.20 };
+    bench_cfg_t cfg = {
+        .seconds = 60,
+        .bitrate = 24000,
+        .burst = 1,
+        .losses = losses,
+        .loss_count = 4,
+    };
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            cfg.seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--bitrate") && i + 1 < argc) {
+            cfg.bitrate = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--burst") && i + 1 < argc) {
+            cfg.burst = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--loss") && i + 1 < argc) {
+            cfg.loss_count = 0;
+            for (char *p = argv[++i]; *p && cfg.loss_count < 16; p++) {
+                losses[cfg.loss_count++] = strtod(p, &p) / 100.0;
+                if (*p != ',') {
+                    break;
+                }
+            }
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (cfg.seconds < 1 || cfg.burst < 1 || cfg.bitrate < 6000 || cfg.loss_count == 0) {
+        usage();
+        return 2;
+    }
+    for (int l = 0; l < cfg.loss_count; l++) {
+        if (losses[l] < 0 || losses[l] >= 1) {
+            usage();
+            return 2;
+        }
+    }
+    return run(&cfg);
+}
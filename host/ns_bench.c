@@ -0,0 +1,646 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端降噪基准：对带噪WAV（或合成的风扇/空调噪声语音）运行降噪，
+ *               统计分段信噪比提升、静音段噪声压低量、DTX下语音帧的检出率与静音段仍需编码的帧、每帧耗时；
+ *               eval 断言降噪后语音帧的检出率不低于不降噪时
+ * @FilePath: \audio_manager\host\ns_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "i2s_file.h"
+#include "noise_suppress.h"
+#include "voice_activity.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+#ifdef HOST_HAVE_OPUS
+#include <opus.h>
+#endif
+
+#define BENCH_RATE          NOISE_SUPPRESS_SAMPLE_RATE
+#define BENCH_HOP           NOISE_SUPPRESS_HOP              // 统计粒度：10ms
+#define BENCH_FRAME         320                             // 每次调用的样点数（与采集块一致，20ms）
+#define BENCH_ACTIVE_MIN    (BENCH_HOP * 100.0 * 100.0)     // 纯净语音能量高于此值（约-50dBFS）的帧计入分段信噪比
+#define BENCH_SILENT_MAX    (BENCH_HOP * 3.0 * 3.0)         // 纯净语音能量低于此值的帧视为纯噪声段
+#define BENCH_SPEECH_MIN    (BENCH_FRAME * 100.0 * 100.0)   // 纯净语音能量高于此值（约-50dBFS）的20ms帧计入语音检出率
+#define BENCH_SEG_MIN       -10.0                           // 分段信噪比截断范围
+#define BENCH_SEG_MAX       35.0
+#define BENCH_OPUS_BITRATE  24000                           // 对比比特率时的VBR目标（同编码器默认值）
+#define BENCH_MAX_PACKET    512                             // 单包最大长度（同 OPUS_RECORDER_SLOT_SIZE）
+#define BENCH_DTX_KEEPALIVE 20                              // DTX静音期间保活包间隔（帧，同 OPUS_PKT_DTX_KEEPALIVE_MS）
+#define BENCH_DEEP_FRAMES   20                              // 停顿开始400ms之后的帧已越过VAD的300ms拖尾
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline uint64_t now_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static uint32_t bench_clock_us(void)
+{
+    return (uint32_t)(now_ns() / 1000);
+}
+
+/* ------------------------------------------------------------------ */
+/* 合成测试数据                                                        */
+/* ------------------------------------------------------------------ */
+
+static double noise(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return ((*seed >> 8) & 0xffff) / 32768.0 - 1.0;
+}
+
+/**
+ * @brief 类语音信号：音节包络调制的变调谐波 + 有色噪声，每个周期约30%为停顿
+ */
+static double talker(double t, double f0, double period, uint32_t *seed, double *lp)
+{
+    double ph = fmod(t, period);
+    double env = ph < period * 0.7 ? 0.5 * (1 - cos(2 * M_PI * 3 * ph)) : 0.0;
+    double f = f0 * (1 + 0.15 * sin(2 * M_PI * 0.7 * t));
+    double v = 0.25 * sin(2 * M_PI * f * t) + 0.15 * sin(2 * M_PI * 3 * f * t) + 0.08 * sin(2 * M_PI * 7 * f * t);
+    *lp += 0.3 * (noise(seed) - *lp);
+    return env * (v + 0.25 * *lp);
+}
+
+typedef enum {
+    BENCH_NOISE_FAN = 0,    // 低通宽带噪声 + 叶片通过频率的谐波（轻微调幅）
+    BENCH_NOISE_HVAC,       // 低频隆隆声 + 送风嘶声
+    BENCH_NOISE_WHITE,
+} bench_noise_t;
+
+typedef struct {
+    uint32_t seed;
+    double lp1;
+    double lp2;
+} bench_noise_state_t;
+
+static double noise_sample(bench_noise_t type, double t, bench_noise_state_t *st)
+{
+    double w = noise(&st->seed);
+    switch (type) {
+    case BENCH_NOISE_FAN: {
+        st->lp1 += 0.15 * (w - st->lp1);
+        double am = 1 + 0.1 * sin(2 * M_PI * 3 * t);
+        double hum = 0.3 * sin(2 * M_PI * 120 * t) + 0.15 * sin(2 * M_PI * 240 * t) + 0.08 * sin(2 * M_PI * 360 * t);
+        return am * (1.5 * st->lp1 + 0.5 * hum);
+    }
+    case BENCH_NOISE_HVAC:
+        st->lp1 += 0.02 * (w - st->lp1);
+        st->lp2 += 0.5 * (w - st->lp2);
+        return 4.0 * st->lp1 + 0.25 * st->lp2;
+    default:
+        return w;
+    }
+}
+
+/**
+ * @brief 合成纯净语音与指定信噪比（按语音活动段功率）的带噪语音
+ */
+static void synth(int16_t *clean, int16_t *noisy, int total, bench_noise_t type, double snr_db)
+{
+    double *s = malloc(total * sizeof(double));
+    double *v = malloc(total * sizeof(double));
+    uint32_t seed = 5, turn = 23;
+    double lp = 0;
+    bench_noise_state_t ns = {.seed = 17};
+    double ps = 0, pn = 0;
+    int active = 0, left = 0;
+    bool talking = false;
+    for (int n = 0; n < total; n++) {
+        double t = (double)n / BENCH_RATE;
+        // 对话节奏：说话 1~2.5 秒与停顿 0.8~2 秒交替，停顿段只有噪声（DTX可省去的帧）
+        if (--left <= 0) {
+            talking = !talking;
+            double u = (noise(&turn) + 1) / 2;
+            left = (int)((talking ? 1.0 + 1.5 * u : 0.8 + 1.2 * u) * BENCH_RATE);
+        }
+        s[n] = talking ? 0.6 * talker(t, 150, 1.3, &seed, &lp) : 0.0;
+        v[n] = noise_sample(type, t, &ns);
+        if (fabs(s[n]) > 1e-3) {
+            ps += s[n] * s[n];
+            active++;
+        }
+        pn += v[n] * v[n];
+    }
+    ps /= active ? active : 1;
+    pn /= total;
+    double g = sqrt(ps / (pn * pow(10, snr_db / 10)));
+    for (int n = 0; n < total; n++) {
+        clean[n] = (int16_t)lrint(s[n] * 32767);
+        noisy[n] = (int16_t)lrint(fmax(-1, fmin(1, s[n] + g * v[n])) * 32767);
+    }
+    free(s);
+    free(v);
+}
+
+static int parse_noise(const char *name, bench_noise_t *type)
+{
+    static const char *names[] = {"fan", "hvac", "white"};
+    for (int i = 0; i < 3; i++) {
+        if (!strcmp(name, names[i])) {
+            *type = (bench_noise_t)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int run_gen(const char *clean_path, const char *noisy_path, double seconds, bench_noise_t type, double snr_db)
+{
+    int total = (int)(seconds * BENCH_RATE);
+    int16_t *clean = malloc(total * sizeof(int16_t));
+    int16_t *noisy = malloc(total * sizeof(int16_t));
+    i2s_file_t *fc = i2s_file_open_writer(clean_path, BENCH_RATE, 1, 16, false);
+    i2s_file_t *fn = i2s_file_open_writer(noisy_path, BENCH_RATE, 1, 16, false);
+    if (!clean || !noisy || !fc || !fn) {
+        return 1;
+    }
+    synth(clean, noisy, total, type, snr_db);
+    i2s_file_write(fc, clean, total * sizeof(int16_t));
+    i2s_file_write(fn, noisy, total * sizeof(int16_t));
+    i2s_file_close(fc);
+    i2s_file_close(fn);
+    free(clean);
+    free(noisy);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 运行与评估                                                          */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    double seg_in;          // 分段信噪比（带噪输入，dB）
+    double seg_out;         // 分段信噪比（降噪输出，dB）
+    double atten;           // 纯噪声段的能量压低量（dB）
+    double speech_gain;     // 输出在纯净语音上的投影增益（dB），衡量语音本身被削弱的程度
+    double hit_in;          // 语音帧被VAD判为语音的比例（%，不降噪，默认配置检测带噪输入）
+    double hit_out;         // 同上（降噪后，VOICE_ACTIVITY_DENOISED_CONFIG() 检测降噪输出，同编码器）
+    double false_in;        // 纯噪声段中被判为语音的帧比例（%，不降噪），含语音结束后的拖尾
+    double false_out;       // 同上（降噪后）
+    double deep_in;         // 停顿开始 BENCH_DEEP_FRAMES 帧之后仍判为语音的比例（%，不降噪），即拖尾之外的误判
+    double deep_out;        // 同上（降噪后）
+    double coded_in;        // DTX下需编码的帧比例（%，语音帧与保活帧，不降噪）
+    double coded_out;       // 同上（降噪后）
+    double pause_in;        // 纯噪声帧中DTX仍需编码的比例（%，不降噪）
+    double pause_out;       // 同上（降噪后）
+    double us_per_frame;    // 每次调用（BENCH_FRAME 个样点）平均耗时
+    double cycles_per_hop;  // 每10ms帧平均周期数（x86 TSC）
+    double rt_pct;          // 占实时的百分比
+    double kbps_in;         // Opus VBR+DTX 平均比特率（不降噪，仅有libopus时）
+    double kbps_out;        // 同上（降噪后）
+    noise_suppress_stats_t st;
+} bench_result_t;
+
+/**
+ * @brief 按20ms帧运行VAD（与编码器DTX的判决相同），dec 记录每帧判决
+ */
+static void vad_run(const int16_t *pcm, int total, const voice_activity_cfg_t *cfg, uint8_t *dec)
+{
+    voice_activity_t *va = voice_activity_create(cfg);
+    for (int i = 0; i + BENCH_FRAME <= total; i += BENCH_FRAME) {
+        dec[i / BENCH_FRAME] = voice_activity_process(va, pcm + i, BENCH_FRAME);
+    }
+    voice_activity_destroy(va);
+}
+
+/**
+ * @brief 纯净语音能量高于 BENCH_SPEECH_MIN 的20ms帧中被判为语音的比例（%）
+ */
+static double vad_hit(const int16_t *clean, int total, const uint8_t *dec)
+{
+    int speech = 0, hits = 0;
+    for (int i = BENCH_RATE; i + BENCH_FRAME <= total; i += BENCH_FRAME) {
+        double ec = 0;
+        for (int k = i; k < i + BENCH_FRAME; k++) {
+            ec += (double)clean[k] * clean[k];
+        }
+        if (ec > BENCH_SPEECH_MIN) {
+            speech++;
+            hits += dec[i / BENCH_FRAME];
+        }
+    }
+    return speech ? 100.0 * hits / speech : 0;
+}
+
+static bool frame_silent(const int16_t *clean, int i)
+{
+    double ec = 0;
+    for (int k = i; k < i + BENCH_FRAME; k++) {
+        ec += (double)clean[k] * clean[k];
+    }
+    return ec < BENCH_SILENT_MAX;
+}
+
+/**
+ * @brief 纯净语音全为静音的20ms帧中被判为语音的比例（%）；deep 为停顿开始 BENCH_DEEP_FRAMES 帧之后的比例，
+ *        两者之差即语音结束后的拖尾（判对语音的代价），deep 才是噪声起伏造成的误判
+ */
+static double vad_false(const int16_t *clean, int total, const uint8_t *dec, double *deep)
+{
+    int silent = 0, hits = 0, run = 0, deep_n = 0, deep_hits = 0;
+    for (int i = BENCH_RATE; i + BENCH_FRAME <= total; i += BENCH_FRAME) {
+        if (!frame_silent(clean, i)) {
+            run = 0;
+            continue;
+        }
+        silent++;
+        hits += dec[i / BENCH_FRAME];
+        if (++run > BENCH_DEEP_FRAMES) {
+            deep_n++;
+            deep_hits += dec[i / BENCH_FRAME];
+        }
+    }
+    *deep = deep_n ? 100.0 * deep_hits / deep_n : 0;
+    return silent ? 100.0 * hits / silent : 0;
+}
+
+/**
+ * @brief 按编码器DTX规则标记需编码的帧：语音帧、静音段首帧与此后每个保活间隔一帧，返回其比例（%）
+ */
+static double dtx_mark(const uint8_t *dec, int frames, uint8_t *coded)
+{
+    int gap = 0, n = 0;
+    for (int f = 0; f < frames; f++) {
+        if (dec[f]) {
+            gap = 0;
+            coded[f] = 1;
+        } else if (gap > 0 && gap < BENCH_DTX_KEEPALIVE) {
+            gap++;
+            coded[f] = 0;
+        } else {
+            gap = 1;
+            coded[f] = 1;
+        }
+        n += coded[f];
+    }
+    return frames ? 100.0 * n / frames : 0;
+}
+
+/**
+ * @brief 纯噪声帧中DTX仍需编码的比例（%）
+ */
+static double pause_coded(const int16_t *clean, int total, const uint8_t *coded)
+{
+    int silent = 0, n = 0;
+    for (int i = BENCH_RATE; i + BENCH_FRAME <= total; i += BENCH_FRAME) {
+        if (frame_silent(clean, i)) {
+            silent++;
+            n += coded[i / BENCH_FRAME];
+        }
+    }
+    return silent ? 100.0 * n / silent : 0;
+}
+
+#ifdef HOST_HAVE_OPUS
+/**
+ * @brief 同编码器：只编码 coded 标记的帧（VBR，libopus DTX 同时开启），返回平均比特率（kbps）
+ */
+static double opus_kbps(const int16_t *pcm, int total, const uint8_t *coded)
+{
+    int err = OPUS_OK;
+    OpusEncoder *enc = opus_encoder_create(BENCH_RATE, 1, OPUS_APPLICATION_VOIP, &err);
+    if (err != OPUS_OK) {
+        return 0;
+    }
+    opus_encoder_ctl(enc, OPUS_SET_BITRATE(BENCH_OPUS_BITRATE));
+    opus_encoder_ctl(enc, OPUS_SET_VBR(1));
+    opus_encoder_ctl(enc, OPUS_SET_DTX(1));
+    opus_encoder_ctl(enc, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+    uint8_t pkt[BENCH_MAX_PACKET];
+    uint64_t bytes = 0;
+    int frames = 0;
+    for (int i = 0; i + BENCH_FRAME <= total; i += BENCH_FRAME) {
+        if (!coded[i / BENCH_FRAME]) {
+            frames++;
+            continue;
+        }
+        int len = opus_encode(enc, pcm + i, BENCH_FRAME, pkt, sizeof(pkt));
+        // DTX 帧（长度不超过2字节）在链路上不发送
+        if (len > 2) {
+            bytes += (uint64_t)len;
+        }
+        frames++;
+    }
+    opus_encoder_destroy(enc);
+    return frames ? bytes * 8.0 / (frames * (double)BENCH_FRAME / BENCH_RATE) / 1000 : 0;
+}
+#endif
+
+/**
+ * @brief 对带噪信号运行降噪（out 为延迟对齐后的输出），clean 非NULL时计算质量指标
+ */
+static int measure(const int16_t *clean, const int16_t *noisy, int16_t *out, int total,
+                   const noise_suppress_cfg_t *cfg, bench_result_t *r)
+{
+    noise_suppress_t *ns = noise_suppress_create(cfg);
+    if (!ns) {
+        fprintf(stderr, "noise suppress create failed\n");
+        return -1;
+    }
+    memset(r, 0, sizeof(*r));
+    noise_suppress_get_stats(ns, &r->st);
+    int dly = r->st.delay_samples;
+    int16_t zero[BENCH_FRAME] = {0};
+    uint64_t ns_total = 0, cyc = 0, calls = 0;
+    // 末尾补静音帧，把延迟中的样点冲出来
+    for (int i = 0; i < total + dly; i += BENCH_FRAME) {
+        const int16_t *in = i + BENCH_FRAME <= total ? noisy + i : zero;
+        if (i < total && i + BENCH_FRAME > total) {
+            memcpy(zero, noisy + i, (total - i) * sizeof(int16_t));
+            in = zero;
+        }
+        int16_t buf[BENCH_FRAME];
+        uint64_t c0 = now_cycles(), t0 = now_ns();
+        noise_suppress_process(ns, in, buf, BENCH_FRAME);
+        ns_total += now_ns() - t0;
+        cyc += now_cycles() - c0;
+        calls++;
+        memset(zero, 0, sizeof(zero));
+        int o = i - dly;
+        for (int k = 0; k < BENCH_FRAME; k++) {
+            if (o + k >= 0 && o + k < total) {
+                out[o + k] = buf[k];
+            }
+        }
+    }
+    noise_suppress_get_stats(ns, &r->st);
+    noise_suppress_destroy(ns);
+    r->us_per_frame = calls ? ns_total / 1e3 / calls : 0;
+    r->cycles_per_hop = r->st.hops ? (double)cyc / r->st.hops : 0;
+    r->rt_pct = ns_total / 1e9 / ((double)calls * BENCH_FRAME / BENCH_RATE) * 100;
+    // 同编码器：不降噪时默认配置检测带噪输入，降噪后 VOICE_ACTIVITY_DENOISED_CONFIG() 检测降噪输出
+    int frames = total / BENCH_FRAME;
+    uint8_t *dec_in = calloc(frames + 1, 1);
+    uint8_t *dec_out = calloc(frames + 1, 1);
+    uint8_t *coded_in = calloc(frames + 1, 1);
+    uint8_t *coded_out = calloc(frames + 1, 1);
+    voice_activity_cfg_t va_in = DEFAULT_VOICE_ACTIVITY_CONFIG();
+    voice_activity_cfg_t va_out = VOICE_ACTIVITY_DENOISED_CONFIG();
+    vad_run(noisy, total, &va_in, dec_in);
+    vad_run(out, total, &va_out, dec_out);
+    r->coded_in = dtx_mark(dec_in, frames, coded_in);
+    r->coded_out = dtx_mark(dec_out, frames, coded_out);
+    if (clean) {
+        r->hit_in = vad_hit(clean, total, dec_in);
+        r->hit_out = vad_hit(clean, total, dec_out);
+        r->false_in = vad_false(clean, total, dec_in, &r->deep_in);
+        r->false_out = vad_false(clean, total, dec_out, &r->deep_out);
+        r->pause_in = pause_coded(clean, total, coded_in);
+        r->pause_out = pause_coded(clean, total, coded_out);
+    }
+#ifdef HOST_HAVE_OPUS
+    r->kbps_in = opus_kbps(noisy, total, coded_in);
+    r->kbps_out = opus_kbps(out, total, coded_out);
+#endif
+    free(dec_in);
+    free(dec_out);
+    free(coded_in);
+    free(coded_out);
+    if (!clean) {
+        return 0;
+    }
+    double seg_in = 0, seg_out = 0, sil_in = 0, sil_out = 0, sp_cc = 0, sp_oc = 0;
+    int seg_n = 0;
+    for (int i = 0; i + BENCH_HOP <= total; i += BENCH_HOP) {
+        double ec = 0, en = 0, eo = 0, ei = 0, eout = 0, oc = 0;
+        for (int k = i; k < i + BENCH_HOP; k++) {
+            double c = clean[k];
+            ec += c * c;
+            oc += out[k] * c;
+            en += (noisy[k] - c) * (noisy[k] - c);
+            eo += (out[k] - c) * (out[k] - c);
+            ei += (double)noisy[k] * noisy[k];
+            eout += (double)out[k] * out[k];
+        }
+        if (ec > BENCH_ACTIVE_MIN) {
+            seg_in += fmax(BENCH_SEG_MIN, fmin(BENCH_SEG_MAX, 10 * log10(ec / (en + 1))));
+            seg_out += fmax(BENCH_SEG_MIN, fmin(BENCH_SEG_MAX, 10 * log10(ec / (eo + 1))));
+            sp_cc += ec;
+            sp_oc += oc;
+            seg_n++;
+        } else if (ec < BENCH_SILENT_MAX && i > BENCH_RATE) {
+            sil_in += ei;       // 跳过开头1秒的噪声学习
+            sil_out += eout;
+        }
+    }
+    r->seg_in = seg_n ? seg_in / seg_n : 0;
+    r->seg_out = seg_n ? seg_out / seg_n : 0;
+    r->atten = sil_out > 0 ? 10 * log10(sil_in / sil_out) : 0;
+    r->speech_gain = sp_oc > 0 ? 20 * log10(sp_oc / sp_cc) : 0;
+    return 0;
+}
+
+static void print_result(const bench_result_t *r, bool quality)
+{
+    const noise_suppress_stats_t *st = &r->st;
+    if (quality) {
+        printf("segSNR          : %.2f dB -> %.2f dB (%+.2f dB)\n", r->seg_in, r->seg_out, r->seg_out - r->seg_in);
+        printf("noise-only      : %.2f dB attenuation, speech gain %.2f dB\n", r->atten, r->speech_gain);
+        printf("VAD on speech   : %.1f%% -> %.1f%% of speech 20ms frames detected\n", r->hit_in, r->hit_out);
+        printf("VAD on pauses   : %.1f%% -> %.1f%% of noise-only 20ms frames (%.1f%% -> %.1f%% past the hangover)\n",
+               r->false_in, r->false_out, r->deep_in, r->deep_out);
+        printf("DTX pauses      : %.1f%% -> %.1f%% of noise-only 20ms frames still coded\n", r->pause_in, r->pause_out);
+    }
+    printf("DTX coded       : %.1f%% -> %.1f%% of 20ms frames\n", r->coded_in, r->coded_out);
+#ifdef HOST_HAVE_OPUS
+    printf("opus VBR+DTX    : %.2f kbps -> %.2f kbps (target %d bps)\n", r->kbps_in, r->kbps_out, BENCH_OPUS_BITRATE);
+#endif
+    printf("noise floor     : %.1f dBFS, smoothed reduction %.1f dB\n", st->noise_dbfs_q8 / 256.0, st->reduction_q8 / 256.0);
+    printf("hops            : %u, hold %u, bypass %u, over budget %u, frame errors %u, peak %u us\n",
+           st->hops, st->hold_hops, st->bypass_hops, st->over_budget, st->frame_errors, st->peak_us);
+    printf("per %d-sample call : %.2f us", BENCH_FRAME, r->us_per_frame);
+#ifdef BENCH_HAVE_TSC
+    printf(", %.0f cycles per 10ms hop", r->cycles_per_hop);
+#endif
+    printf(" (%.2f%% of realtime)\n", r->rt_pct);
+    printf("memory          : %u bytes, delay %u samples\n", st->mem_bytes, st->delay_samples);
+}
+
+static int read_wav(const char *path, int16_t **pcm, int *total)
+{
+    i2s_file_t *f = i2s_file_open_reader(path, false);
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    int rate, ch, bits;
+    i2s_file_get_format(f, &rate, &ch, &bits);
+    if (rate != BENCH_RATE || ch != 1 || bits != 16) {
+        fprintf(stderr, "%s: must be %d Hz mono 16-bit WAV\n", path, BENCH_RATE);
+        i2s_file_close(f);
+        return -1;
+    }
+    int cap = BENCH_RATE * 10, n = 0;
+    int16_t *buf = malloc(cap * sizeof(int16_t));
+    int r;
+    while ((r = i2s_file_read(f, buf + n, (cap - n) * sizeof(int16_t))) > 0) {
+        n += r / (int)sizeof(int16_t);
+        if (n == cap) {
+            cap *= 2;
+            buf = realloc(buf, cap * sizeof(int16_t));
+        }
+    }
+    i2s_file_close(f);
+    *pcm = buf;
+    *total = n;
+    return 0;
+}
+
+static int run_file(const char *noisy_path, const char *out_path, const char *clean_path, const noise_suppress_cfg_t *cfg)
+{
+    int16_t *noisy = NULL, *clean = NULL;
+    int total = 0, ctotal = 0;
+    if (read_wav(noisy_path, &noisy, &total) != 0 || (clean_path && read_wav(clean_path, &clean, &ctotal) != 0)) {
+        return 1;
+    }
+    if (clean && ctotal < total) {
+        total = ctotal;
+    }
+    int16_t *out = calloc(total, sizeof(int16_t));
+    bench_result_t r;
+    if (measure(clean, noisy, out, total, cfg, &r) != 0) {
+        return 1;
+    }
+    printf("audio           : %.2f s, level %d, budget %u us\n", (double)total / BENCH_RATE, cfg->level, cfg->budget_us);
+    print_result(&r, clean != NULL);
+    if (out_path) {
+        i2s_file_t *fo = i2s_file_open_writer(out_path, BENCH_RATE, 1, 16, false);
+        if (fo) {
+            i2s_file_write(fo, out, total * sizeof(int16_t));
+            i2s_file_close(fo);
+        }
+    }
+    free(out);
+    free(noisy);
+    free(clean);
+    return 0;
+}
+
+/**
+ * @brief 合成数据上遍历信噪比与降噪强度
+ */
+static int run_eval(double seconds, bench_noise_t type, const char *snr_list, const noise_suppress_cfg_t *base)
+{
+    int total = (int)(seconds * BENCH_RATE);
+    int16_t *clean = malloc(total * sizeof(int16_t));
+    int16_t *noisy = malloc(total * sizeof(int16_t));
+    int16_t *out = malloc(total * sizeof(int16_t));
+    if (!clean || !noisy || !out) {
+        return 1;
+    }
+    int fails = 0;
+    printf("%-6s %-5s %9s %9s %9s %9s %9s %9s %9s %9s %8s\n",
+           "SNR", "level", "segSNR in", "out", "noise dB", "speech dB", "hit in%", "out%", "pause in%", "out%", "us/call");
+    char list[128];
+    snprintf(list, sizeof(list), "%s", snr_list);
+    for (char *tok = strtok(list, ","); tok; tok = strtok(NULL, ",")) {
+        double snr = atof(tok);
+        synth(clean, noisy, total, type, snr);
+        for (int level = 0; level < NOISE_SUPPRESS_LEVEL_MAX; level++) {
+            noise_suppress_cfg_t cfg = *base;
+            cfg.level = (noise_suppress_level_t)level;
+            bench_result_t r;
+            if (measure(clean, noisy, out, total, &cfg, &r) != 0) {
+                return 1;
+            }
+            // 降噪不得让DTX漏掉语音：检出率低于不降噪时即失败
+            bool ok = r.hit_out >= r.hit_in;
+            printf("%-6.0f %-5d %9.2f %9.2f %9.2f %9.2f %9.1f %9.1f %9.1f %9.1f %8.2f%s\n",
+                   snr, level, r.seg_in, r.seg_out, r.atten, r.speech_gain, r.hit_in, r.hit_out, r.pause_in, r.pause_out,
+                   r.us_per_frame, ok ? "" : "  FAIL speech hit rate dropped");
+            fails += !ok;
+        }
+    }
+    free(clean);
+    free(noisy);
+    free(out);
+    if (fails) {
+        printf("FAIL: %d rows detect less speech with NS than without\n", fails);
+    }
+    return fails ? 1 : 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ns_bench gen <clean.wav> <noisy.wav> <seconds> [--noise fan|hvac|white] [--snr dB]\n"
+            "       ns_bench run <noisy.wav> [out.wav] [--clean clean.wav] [--level 0-3] [--budget-us n]\n"
+            "       ns_bench eval [--seconds s] [--noise fan|hvac|white] [--snr 0,5,10] [--budget-us n]\n"
+            "input: %d Hz mono 16-bit WAV, processed in %d-sample calls like the capture blocks\n",
+            BENCH_RATE, BENCH_FRAME);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    noise_suppress_cfg_t cfg = DEFAULT_NOISE_SUPPRESS_CONFIG();
+    cfg.frame_samples = BENCH_FRAME;
+    cfg.clock_us = bench_clock_us;
+    bench_noise_t type = BENCH_NOISE_FAN;
+    double snr = 5, seconds = 30;
+    const char *snr_list = "0,5,10,20";
+    const char *clean = NULL;
+    const char *pos[3] = {NULL, NULL, NULL};
+    int npos = 0;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--noise") && i + 1 < argc) {
+            if (parse_noise(argv[++i], &type) != 0) {
+                usage();
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--snr") && i + 1 < argc) {
+            snr_list = argv[++i];
+            snr = atof(snr_list);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--level") && i + 1 < argc) {
+            cfg.level = (noise_suppress_level_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--budget-us") && i + 1 < argc) {
+            cfg.budget_us = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--clean") && i + 1 < argc) {
+            clean = argv[++i];
+        } else if (argv[i][0] != '-' && npos < 3) {
+            pos[npos++] = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (!strcmp(argv[1], "gen") && npos == 3) {
+        return run_gen(pos[0], pos[1], atof(pos[2]), type, snr);
+    }
+    if (!strcmp(argv[1], "run") && npos >= 1) {
+        return run_file(pos[0], pos[1], clean, &cfg);
+    }
+    if (!strcmp(argv[1], "eval")) {
+        return run_eval(seconds, type, snr_list, &cfg);
+    }
+    usage();
+    return 1;
+}
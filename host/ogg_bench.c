@@ -0,0 +1,291 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 11:00:00
+ * @LastEditTime: 2026-10-17 11:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端Ogg-Opus存储基准：以普通文件代替Flash/SD，统计封装/解封装吞吐、写调用次数与写放大、按索引定位的开销，
+ *               并逐包校验读回的数据与定位结果
+ * @FilePath: \audio_manager\host\ogg_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "ogg_opus.h"
+
+#define BENCH_FRAME_MS      20                      // 帧长
+#define BENCH_FRAME_48K     (OGG_OPUS_RATE * BENCH_FRAME_MS / 1000)
+#define BENCH_TOC           0x48                    // SILK 宽带 20ms，单帧
+#define BENCH_SECTOR        4096                    // 计算写放大的存储扇区大小
+#define BENCH_DTX_CYCLE     100                     // DTX模型：每100帧（2秒）中末尾一段静音
+#define BENCH_DTX_KEEPALIVE 20                      // 静音期间保活包间隔（帧，与固件400ms一致）
+#define BENCH_PRE_SKIP      312                     // 16kHz SILK 前瞻换算到48kHz（与libopus一致）
+
+typedef struct {
+    uint16_t len;                   // 0 表示DTX期间未发送
+    uint8_t data[OGG_OPUS_PACKET_CAP];
+} bench_pkt_t;
+
+typedef struct {
+    FILE *f;
+    uint32_t offset;                // 当前写偏移
+    uint64_t sectors;               // 写调用涉及的扇区数（每次写入都要重写所涉及的扇区）
+} bench_file_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t rnd(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+static uint64_t sectors_touched(uint32_t offset, size_t len)
+{
+    return len ? (offset + len - 1) / BENCH_SECTOR - offset / BENCH_SECTOR + 1 : 0;
+}
+
+static int file_write(void *ctx, const void *data, size_t len)
+{
+    bench_file_t *bf = ctx;
+    bf->sectors += sectors_touched(bf->offset, len);
+    bf->offset += (uint32_t)len;
+    return fwrite(data, 1, len, bf->f) == len ? (int)len : -1;
+}
+
+static int file_read(void *ctx, void *data, size_t len)
+{
+    size_t n = fread(data, 1, len, ((bench_file_t *)ctx)->f);
+    return ferror(((bench_file_t *)ctx)->f) ? -1 : (int)n;
+}
+
+static int file_seek(void *ctx, uint32_t offset)
+{
+    return fseek(((bench_file_t *)ctx)->f, offset, SEEK_SET);
+}
+
+/**
+ * @brief 生成第 k 帧的包：语音帧按比特率上下浮动25%，DTX静音段只发首帧与保活帧（只有TOC）
+ */
+static void gen_packet(bench_pkt_t *p, uint32_t k, int bitrate, int dtx_pct, uint32_t *seed)
+{
+    uint32_t silent_from = BENCH_DTX_CYCLE - BENCH_DTX_CYCLE * dtx_pct / 100;
+    uint32_t phase = k % BENCH_DTX_CYCLE;
+    if (dtx_pct && phase >= silent_from) {
+        uint32_t gap = phase - silent_from;
+        p->len = gap % BENCH_DTX_KEEPALIVE == 0 ? 1 : 0;
+        p->data[0] = BENCH_TOC;
+        return;
+    }
+    int avg = bitrate * BENCH_FRAME_MS / 8000;
+    int len = avg * 3 / 4 + (int)(rnd(seed) % (avg / 2 + 1));
+    if (len < 3) {
+        len = 3;
+    }
+    if (len > OGG_OPUS_PACKET_CAP) {
+        len = OGG_OPUS_PACKET_CAP;
+    }
+    p->len = (uint16_t)len;
+    p->data[0] = BENCH_TOC;
+    for (int i = 1; i < len; i++) {
+        p->data[i] = (uint8_t)(k * 31 + i * 7);
+    }
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ogg_bench run <out.opus> <seconds> [--bitrate bps] [--dtx pct] [--block bytes] [--seeks n]\n"
+            "writes <out.opus> and <out.opus>.idx, then reads back, verifies and seeks\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 1;
+    }
+    const char *path = argv[2];
+    double seconds = atof(argv[3]);
+    int bitrate = 24000, dtx_pct = 0, block = OGG_OPUS_BLOCK_SIZE, seeks = 200;
+    for (int i = 4; i < argc; i++) {
+        if (!strcmp(argv[i], "--bitrate") && i + 1 < argc) {
+            bitrate = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--dtx") && i + 1 < argc) {
+            dtx_pct = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--block") && i + 1 < argc) {
+            block = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seeks") && i + 1 < argc) {
+            seeks = atoi(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    uint32_t frames = (uint32_t)(seconds * 1000 / BENCH_FRAME_MS);
+    if (!frames || dtx_pct < 0 || dtx_pct > 90 || block < 512 || block > 65535) {
+        usage();
+        return 1;
+    }
+
+    // 1. 生成包序列（跳过的帧也占序号，与 opus_packet_codec.c 的DTX一致）
+    bench_pkt_t *pkts = calloc(frames, sizeof(bench_pkt_t));
+    if (!pkts) {
+        return 1;
+    }
+    uint32_t seed = 1, sent = 0, last = 0;
+    uint64_t payload = 0, naive_sectors = 0;
+    uint32_t naive_off = 0;
+    for (uint32_t k = 0; k < frames; k++) {
+        gen_packet(&pkts[k], k, bitrate, dtx_pct, &seed);
+        if (pkts[k].len) {
+            sent++;
+            last = k;
+            payload += pkts[k].len;
+            // 对照：每包带2字节长度直接追加写入（opus_encode_recorder_read() 的裸流存法）
+            naive_sectors += sectors_touched(naive_off, pkts[k].len + 2u);
+            naive_off += pkts[k].len + 2u;
+        }
+    }
+
+    // 2. 封装写出：写回调每次都是一次真实的 write 系统调用
+    bench_file_t bf = {.f = fopen(path, "wb")};
+    if (!bf.f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    setvbuf(bf.f, NULL, _IONBF, 0);
+    ogg_opus_writer_cfg_t wcfg = DEFAULT_OGG_OPUS_WRITER_CONFIG();
+    wcfg.write = file_write;
+    wcfg.ctx = &bf;
+    wcfg.pre_skip = BENCH_PRE_SKIP;
+    wcfg.block_size = (uint16_t)block;
+    ogg_opus_writer_t *w = ogg_opus_writer_create(&wcfg);
+    if (!w) {
+        fprintf(stderr, "writer create failed\n");
+        return 1;
+    }
+    uint64_t t0 = now_ns();
+    for (uint32_t k = 0; k < frames; k++) {
+        if (!pkts[k].len) {
+            continue;
+        }
+        opus_packet_t pkt = {.data = pkts[k].data, .len = pkts[k].len, .seq = (uint16_t)k};
+        if (ogg_opus_writer_put(w, &pkt) != 0) {
+            fprintf(stderr, "put failed at %u\n", k);
+            return 1;
+        }
+    }
+    ogg_opus_writer_close(w);
+    uint64_t write_ns = now_ns() - t0;
+    fclose(bf.f);
+    ogg_opus_writer_stats_t ws;
+    ogg_opus_writer_get_stats(w, &ws);
+
+    char idx_path[512];
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", path);
+    bench_file_t bi = {.f = fopen(idx_path, "wb")};
+    const ogg_opus_index_t *wi = ogg_opus_writer_get_index(w);
+    if (!bi.f || ogg_opus_index_save(wi, file_write, &bi) != 0) {
+        fprintf(stderr, "index save failed\n");
+        return 1;
+    }
+    fclose(bi.f);
+
+    double audio_s = frames * BENCH_FRAME_MS / 1000.0;
+    printf("audio           : %.1f s, %u frames, %u packets sent (dtx %d%%), %d bps\n", audio_s, frames, sent, dtx_pct, bitrate);
+    printf("payload         : %llu bytes\n", (unsigned long long)payload);
+    printf("ogg file        : %u bytes (+%.2f%%), %u pages, %u gap packets\n", ws.file_bytes,
+           payload ? (ws.file_bytes - (double)payload) * 100 / payload : 0, ws.pages, ws.gap_packets);
+    printf("index           : %u entries every %u ms, %zu bytes\n", wi->count, wi->interval_ms, ogg_opus_index_size(wi));
+    printf("write calls     : %u (block %d B)  vs  %u per-packet\n", ws.write_calls, block, sent);
+    printf("sector writes   : %llu  vs  %llu per-packet (%d B sectors)\n", (unsigned long long)bf.sectors,
+           (unsigned long long)naive_sectors, BENCH_SECTOR);
+    printf("write amplif.   : %.2fx  vs  %.2fx per-packet\n", payload ? bf.sectors * (double)BENCH_SECTOR / payload : 0,
+           payload ? naive_sectors * (double)BENCH_SECTOR / payload : 0);
+    printf("mux             : %.2f ms, %.1f MB/s, %.0fx realtime\n", write_ns / 1e6,
+           write_ns ? ws.file_bytes / (write_ns / 1e9) / 1e6 : 0, write_ns ? audio_s / (write_ns / 1e9) : 0);
+    ogg_opus_writer_destroy(w);
+
+    // 3. 顺序读回并逐包校验：空帧包只出现在未发送的帧上，其余与写入逐字节一致；
+    //    末尾未发送的帧之后没有包，不补写
+    bench_file_t rf = {.f = fopen(path, "rb")};
+    ogg_opus_reader_cfg_t rcfg = DEFAULT_OGG_OPUS_READER_CONFIG();
+    rcfg.read = file_read;
+    rcfg.seek = file_seek;
+    rcfg.ctx = &rf;
+    rcfg.block_size = (uint16_t)block;
+    ogg_opus_reader_t *r = rf.f ? ogg_opus_reader_create(&rcfg) : NULL;
+    if (!r) {
+        fprintf(stderr, "reader create failed\n");
+        return 1;
+    }
+    ogg_opus_info_t info;
+    ogg_opus_reader_get_info(r, &info);
+    uint32_t bad = 0, read_pkts = 0;
+    ogg_opus_packet_t op;
+    t0 = now_ns();
+    while (ogg_opus_reader_next(r, &op) == 1) {
+        int64_t k = (op.pos + info.pre_skip) / BENCH_FRAME_48K;
+        if (k < 0 || k >= frames || op.samples != BENCH_FRAME_48K) {
+            bad++;
+        } else if (pkts[k].len ? (op.len != pkts[k].len || memcmp(op.data, pkts[k].data, op.len) != 0) : op.len > 2) {
+            bad++;
+        }
+        read_pkts++;
+    }
+    uint64_t read_ns = now_ns() - t0;
+    ogg_opus_reader_stats_t rs;
+    ogg_opus_reader_get_stats(r, &rs);
+    printf("demux           : %.2f ms, %.1f MB/s, %u packets (%u expected), %u read calls, crc errors %u, mismatches %u\n",
+           read_ns / 1e6, read_ns ? rs.read_bytes / (read_ns / 1e9) / 1e6 : 0, read_pkts, last + 1, rs.read_calls,
+           rs.crc_errors, bad + (read_pkts != last + 1));
+
+    // 4. 随机定位：有索引时只读目标所在页附近；无索引时从头扫描
+    ogg_opus_index_entry_t entries[OGG_OPUS_INDEX_CAP];
+    ogg_opus_index_t idx = {.entries = entries, .cap = OGG_OPUS_INDEX_CAP};
+    bench_file_t ri = {.f = fopen(idx_path, "rb")};
+    if (!ri.f || ogg_opus_index_load(&idx, file_read, &ri) != 0) {
+        fprintf(stderr, "index load failed\n");
+        return 1;
+    }
+    fclose(ri.f);
+    // 目标只取已封装的范围：DTX下末尾的静音帧不写入，文件时长以最后的颗粒位置为准
+    uint32_t muxed_ms = (uint32_t)((ws.granule - BENCH_PRE_SKIP) / (OGG_OPUS_RATE / 1000));
+    for (int pass = 0; pass < 2 && muxed_ms; pass++) {
+        const ogg_opus_index_t *use = pass == 0 ? &idx : NULL;
+        int n = pass == 0 ? seeks : (seeks + 9) / 10;
+        uint32_t seek_bad = 0;
+        uint64_t ns = 0, bytes = 0;
+        seed = 99;
+        for (int i = 0; i < n; i++) {
+            uint32_t target = rnd(&seed) % muxed_ms;
+            ogg_opus_reader_stats_t before;
+            ogg_opus_reader_get_stats(r, &before);
+            t0 = now_ns();
+            int ret = ogg_opus_reader_seek(r, target, use);
+            ret = ret == 0 ? ogg_opus_reader_next(r, &op) : -1;
+            ns += now_ns() - t0;
+            ogg_opus_reader_get_stats(r, &rs);
+            bytes += rs.read_bytes - before.read_bytes;
+            int64_t want = (int64_t)(target > OGG_OPUS_PREROLL_MS ? target - OGG_OPUS_PREROLL_MS : 0) * (OGG_OPUS_RATE / 1000);
+            if (ret != 1 || op.pos > want || op.pos + op.samples <= want) {
+                seek_bad++;
+            }
+        }
+        printf("seek %-10s : %d seeks, %.1f us/seek, %.1f KB read/seek, wrong %u\n", use ? "(index)" : "(scan)", n,
+               n ? ns / 1e3 / n : 0, n ? bytes / 1024.0 / n : 0, seek_bad);
+    }
+    fclose(rf.f);
+    ogg_opus_reader_destroy(r);
+    free(pkts);
+    return 0;
+}
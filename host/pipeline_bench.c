@@ -0,0 +1,1023 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 12:00:00
+ * @LastEditTime: 2026-10-16 12:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端管道基准：以WAV文件代替I2S，端到端运行采集/重采样/编码/抖动缓冲/解码链路，
+ *               统计实时倍率、各元素CPU时间、峰值堆内存与缓冲占用；mix 模式统计多路解码混音每增加一路的CPU开销；
+ *               loopback 可回放实测的到达时间轨迹（每行“到达时间ms 序号”），输出端到端延迟与隐藏率
+ * @FilePath: \audio_manager\host\pipeline_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <malloc.h>
+#include "i2s_file.h"
+#include "polyphase_resampler.h"
+#include "capture_convert.h"
+#include "opus_packet_slab.h"
+#include "jitter_buffer.h"
+#include "voice_activity.h"
+#include "audio_arena.h"
+#include "opus_mixer.h"
+#ifdef HOST_HAVE_OPUS
+#include <opus.h>
+#endif
+
+#define BENCH_IN_RATE       44100                           // 采集采样率（与固件一致）
+#define BENCH_OUT_RATE      16000                           // 编码/播放采样率
+#define BENCH_FRAME_MS      20                              // 帧长
+#define BENCH_IN_FRAME      (BENCH_IN_RATE * BENCH_FRAME_MS / 1000)
+#define BENCH_OUT_FRAME     (BENCH_OUT_RATE * BENCH_FRAME_MS / 1000)
+#define BENCH_SLOT_COUNT    16                              // 包slab槽数（与固件一致）
+#define BENCH_SLOT_SIZE     (BENCH_OUT_FRAME * 2)           // 足够容纳无Opus时的PCM直通包
+#define BENCH_ARENA_SRAM    (8 * 1024)                      // 回环各内核的片内预算
+#define BENCH_ARENA_PSRAM   (32 * 1024)                     // 包数据区预算
+#define BENCH_MAX_INFLIGHT  256                             // 模拟网络中同时在途的最大包数
+#define BENCH_DTX_KEEPALIVE 20                              // DTX静音期间保活包间隔（帧，与固件400ms一致）
+#define BENCH_TRACE_LOST    UINT32_MAX                      // 轨迹中未出现的序号（丢包）
+
+/* ------------------------------------------------------------------ */
+/* 计时与内存统计                                                      */
+/* ------------------------------------------------------------------ */
+
+typedef enum {
+    STAGE_CAPTURE = 0,
+    STAGE_RESAMPLE,
+    STAGE_VAD,
+    STAGE_ENCODE,
+    STAGE_NETWORK,
+    STAGE_DECODE,
+    STAGE_MIX,
+    STAGE_PLAYBACK,
+    STAGE_MAX,
+} bench_stage_t;
+
+static const char *s_stage_name[STAGE_MAX] = {
+    "capture(i2s)", "resample", "vad", "encode", "slab/jitter", "decode", "decode+mix", "playback(i2s)",
+};
+
+typedef struct {
+    uint64_t ns[STAGE_MAX];         // 各阶段累计耗时
+    uint64_t calls[STAGE_MAX];      // 各阶段调用次数
+    size_t heap_base;               // 起始堆占用
+    size_t heap_peak;               // 峰值堆占用
+    uint32_t slab_peak;             // slab峰值占用（包）
+    uint32_t jitter_peak_ms;        // 抖动缓冲峰值深度
+    double m2e_sum_ms;              // 端到端延迟累计
+    uint32_t m2e_count;             // 端到端延迟样本数
+    uint64_t audio_frames;          // 处理的音频帧数
+} bench_t;
+
+static bench_t s_bench;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static size_t heap_in_use(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static void heap_sample(void)
+{
+    size_t h = heap_in_use();
+    if (h > s_bench.heap_peak) {
+        s_bench.heap_peak = h;
+    }
+}
+
+#define STAGE_RUN(stage, stmt) do {                 \
+        uint64_t _t0 = now_ns();                    \
+        stmt;                                       \
+        s_bench.ns[stage] += now_ns() - _t0;        \
+        s_bench.calls[stage]++;                     \
+    } while (0)
+
+static void bench_report(const char *mode, double wall_s)
+{
+    double audio_s = (double)s_bench.audio_frames * BENCH_FRAME_MS / 1000.0;
+    uint64_t total = 0;
+    for (int i = 0; i < STAGE_MAX; i++) {
+        total += s_bench.ns[i];
+    }
+    printf("mode            : %s\n", mode);
+    printf("audio           : %.2f s\n", audio_s);
+    printf("wall            : %.3f s (%.1fx realtime)\n", wall_s, wall_s > 0 ? audio_s / wall_s : 0);
+    printf("%-16s %10s %10s %10s %8s\n", "element", "cpu ms", "calls", "us/call", "%rt");
+    for (int i = 0; i < STAGE_MAX; i++) {
+        if (!s_bench.calls[i]) {
+            continue;
+        }
+        printf("%-16s %10.2f %10llu %10.2f %8.3f\n", s_stage_name[i], s_bench.ns[i] / 1e6,
+               (unsigned long long)s_bench.calls[i], s_bench.ns[i] / 1e3 / s_bench.calls[i],
+               audio_s > 0 ? s_bench.ns[i] / 1e9 / audio_s * 100 : 0);
+    }
+    printf("%-16s %10.2f %10s %10s %8.3f\n", "total", total / 1e6, "", "",
+           audio_s > 0 ? total / 1e9 / audio_s * 100 : 0);
+    printf("heap peak       : %zu bytes above start\n", s_bench.heap_peak - s_bench.heap_base);
+    printf("slab peak       : %u / %u packets\n", s_bench.slab_peak, BENCH_SLOT_COUNT);
+    if (s_bench.jitter_peak_ms) {
+        printf("jitter peak     : %u ms\n", s_bench.jitter_peak_ms);
+    }
+    if (s_bench.m2e_count) {
+        printf("mouth-to-ear    : %.1f ms (buffered, excl. I2S DMA)\n", s_bench.m2e_sum_ms / s_bench.m2e_count);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* 编解码（有libopus时使用Opus，否则PCM直通，仅用于验证管道结构）      */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+#ifdef HOST_HAVE_OPUS
+    OpusEncoder *enc;
+    OpusDecoder *dec;
+#endif
+    int16_t last[BENCH_OUT_FRAME];  // 直通模式下PLC重复上一帧
+} bench_codec_t;
+
+static int codec_open(bench_codec_t *c, int bitrate)
+{
+    memset(c, 0, sizeof(*c));
+#ifdef HOST_HAVE_OPUS
+    int err = OPUS_OK;
+    c->enc = opus_encoder_create(BENCH_OUT_RATE, 1, OPUS_APPLICATION_VOIP, &err);
+    if (err != OPUS_OK) {
+        return -1;
+    }
+    opus_encoder_ctl(c->enc, OPUS_SET_BITRATE(bitrate));
+    opus_encoder_ctl(c->enc, OPUS_SET_COMPLEXITY(5));
+    c->dec = opus_decoder_create(BENCH_OUT_RATE, 1, &err);
+    return err == OPUS_OK ? 0 : -1;
+#else
+    (void)bitrate;
+    return 0;
+#endif
+}
+
+static void codec_close(bench_codec_t *c)
+{
+#ifdef HOST_HAVE_OPUS
+    opus_encoder_destroy(c->enc);
+    opus_decoder_destroy(c->dec);
+#else
+    (void)c;
+#endif
+}
+
+static int codec_encode(bench_codec_t *c, const int16_t *pcm, uint8_t *out, int cap)
+{
+#ifdef HOST_HAVE_OPUS
+    return opus_encode(c->enc, pcm, BENCH_OUT_FRAME, out, cap);
+#else
+    (void)c;
+    int n = BENCH_OUT_FRAME * (int)sizeof(int16_t);
+    if (n > cap) {
+        return -1;
+    }
+    memcpy(out, pcm, n);
+    return n;
+#endif
+}
+
+static int codec_decode(bench_codec_t *c, jitter_frame_type_t type, const uint8_t *data, int len, int16_t *pcm)
+{
+#ifdef HOST_HAVE_OPUS
+    switch (type) {
+    case JITTER_FRAME_NORMAL:
+        return opus_decode(c->dec, data, len, pcm, BENCH_OUT_FRAME * 6, 0);
+    case JITTER_FRAME_FEC:
+        return opus_decode(c->dec, data, len, pcm, BENCH_OUT_FRAME, 1);
+    default:
+        return opus_decode(c->dec, NULL, 0, pcm, BENCH_OUT_FRAME, 0);
+    }
+#else
+    if (type == JITTER_FRAME_NORMAL && len == (int)sizeof(c->last)) {
+        memcpy(c->last, data, len);
+    }
+    memcpy(pcm, c->last, sizeof(c->last));
+    return BENCH_OUT_FRAME;
+#endif
+}
+
+/* ------------------------------------------------------------------ */
+/* 模拟网络：固定时延 + 指数分布抖动 + 随机丢包，或回放到达时间轨迹     */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint32_t arrival_ms;
+    uint16_t seq;
+    uint16_t len;
+    uint8_t data[BENCH_SLOT_SIZE];
+} bench_wire_pkt_t;
+
+typedef struct {
+    double base_ms;                 // 固定时延
+    double jitter_ms;               // 抖动均值
+    double loss;                    // 丢包率 0~1
+    uint32_t seed;                  // 随机种子
+    bench_wire_pkt_t *inflight;     // 在途包
+    int count;                      // 在途包数
+    uint32_t sent, lost;            // 发送/丢失计数
+    uint32_t *trace_delay_ms;       // 轨迹：按序号（自0起）的单向时延，NULL 为随机模型
+    uint32_t trace_len;             // 轨迹覆盖的包数
+    uint32_t send_seq;              // 已发送包的32位展开序号（用于查轨迹）
+} bench_net_t;
+
+/**
+ * @brief 16位序号展开为32位：取与上一个展开值距离最近的一个
+ */
+static uint32_t seq_unwrap(uint32_t last, uint32_t seq16)
+{
+    return last + (uint32_t)(int32_t)(int16_t)(uint16_t)(seq16 - (last & 0xFFFF));
+}
+
+/**
+ * @brief 读取到达时间轨迹：每行“到达时间(ms) 序号”，# 开头为注释
+ *
+ * 序号可为16位回绕的RTP序号（按行展开）或连续整数，以首行序号为0重新编号；
+ * 同一序号多次出现取最早到达，未出现的序号视为丢包。单向时延按 到达时间 - 序号*帧长 计算，
+ * 两端时钟偏移未知，故整体平移使最小时延等于 base_ms；回放时每个包在实际发出时刻加上该时延到达。
+ */
+static int net_load_trace(bench_net_t *n, const char *path, double base_ms)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "cannot open trace: %s\n", path);
+        return -1;
+    }
+    size_t cap = 0, count = 0;
+    double *arr = NULL;
+    uint32_t *seqs = NULL;
+    uint32_t first = 0, last = 0, max_seq = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        double t;
+        unsigned long sq;
+        if (line[0] == '#' || sscanf(line, "%lf %lu", &t, &sq) != 2) {
+            continue;
+        }
+        if (count == cap) {
+            cap = cap ? cap * 2 : 1024;
+            double *na = realloc(arr, cap * sizeof(double));
+            uint32_t *ns = realloc(seqs, cap * sizeof(uint32_t));
+            if (!na || !ns) {
+                free(na ? na : arr);
+                free(ns ? ns : seqs);
+                fclose(f);
+                return -1;
+            }
+            arr = na;
+            seqs = ns;
+        }
+        uint32_t ext = count == 0 ? (uint32_t)sq : sq > 0xFFFF ? (uint32_t)sq : seq_unwrap(last, (uint32_t)sq);
+        if (count == 0) {
+            first = ext;
+        }
+        last = ext;
+        if (ext - first >= 0x80000000u) {
+            continue;   // 早于首包的乱序包
+        }
+        arr[count] = t;
+        seqs[count++] = ext - first;
+        if (ext - first > max_seq) {
+            max_seq = ext - first;
+        }
+    }
+    fclose(f);
+    if (count == 0) {
+        fprintf(stderr, "trace %s has no \"arrival_ms seq\" lines\n", path);
+        free(arr);
+        free(seqs);
+        return -1;
+    }
+    double min_delay = arr[0] - (double)seqs[0] * BENCH_FRAME_MS;
+    for (size_t i = 1; i < count; i++) {
+        double d = arr[i] - (double)seqs[i] * BENCH_FRAME_MS;
+        if (d < min_delay) {
+            min_delay = d;
+        }
+    }
+    n->trace_len = max_seq + 1;
+    n->trace_delay_ms = malloc(n->trace_len * sizeof(uint32_t));
+    if (!n->trace_delay_ms) {
+        free(arr);
+        free(seqs);
+        return -1;
+    }
+    for (uint32_t i = 0; i < n->trace_len; i++) {
+        n->trace_delay_ms[i] = BENCH_TRACE_LOST;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint32_t ms = (uint32_t)lrint(arr[i] - (double)seqs[i] * BENCH_FRAME_MS - min_delay + base_ms);
+        if (ms < n->trace_delay_ms[seqs[i]]) {
+            n->trace_delay_ms[seqs[i]] = ms;
+        }
+    }
+    free(arr);
+    free(seqs);
+    return 0;
+}
+
+static double net_rand(bench_net_t *n)
+{
+    n->seed = n->seed * 1103515245u + 12345u;
+    return ((n->seed >> 8) + 1.0) / 16777217.0;
+}
+
+static void net_send(bench_net_t *n, const opus_packet_t *pkt, uint32_t now_ms)
+{
+    n->sent++;
+    uint32_t arrival_ms;
+    if (n->trace_delay_ms) {
+        n->send_seq = n->sent == 1 ? pkt->seq : seq_unwrap(n->send_seq, pkt->seq);
+        uint32_t delay = n->send_seq < n->trace_len ? n->trace_delay_ms[n->send_seq] : BENCH_TRACE_LOST;
+        arrival_ms = delay == BENCH_TRACE_LOST ? BENCH_TRACE_LOST : now_ms + delay;
+    } else {
+        arrival_ms = net_rand(n) < n->loss ? BENCH_TRACE_LOST
+                     : now_ms + (uint32_t)(n->base_ms - n->jitter_ms * log(net_rand(n)));
+    }
+    if (arrival_ms == BENCH_TRACE_LOST || n->count >= BENCH_MAX_INFLIGHT) {
+        n->lost++;
+        return;
+    }
+    bench_wire_pkt_t *w = &n->inflight[n->count++];
+    w->arrival_ms = arrival_ms;
+    w->seq = pkt->seq;
+    w->len = pkt->len;
+    memcpy(w->data, pkt->data, pkt->len);
+}
+
+static void net_deliver(bench_net_t *n, jitter_buffer_t *jb, uint32_t now_ms)
+{
+    for (int i = 0; i < n->count;) {
+        bench_wire_pkt_t *w = &n->inflight[i];
+        if (w->arrival_ms > now_ms) {
+            i++;
+            continue;
+        }
+        jitter_buffer_put(jb, w->data, w->len, w->seq, w->arrival_ms);
+        n->inflight[i] = n->inflight[--n->count];
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* 管道                                                                */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const char *in_path;
+    const char *out_path;
+    bool realtime;
+    int bitrate;
+    double net_base_ms;
+    double net_jitter_ms;
+    double net_loss;
+    const char *net_trace;
+    bool dtx;
+    int streams;
+} bench_opts_t;
+
+/**
+ * @brief 读取一帧I2S数据并转换为16位（多通道取左声道）
+ *
+ * 24/32位输入与固件相同，经 capture_conv_s16 一次完成取位/去直流/增益/饱和。
+ */
+static int capture_frame(i2s_file_t *in, capture_conv_t *cv, int16_t *pcm)
+{
+    static int32_t raw[BENCH_IN_FRAME * 2 + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t)];
+    int rate, ch, bits;
+    i2s_file_get_format(in, &rate, &ch, &bits);
+    int bytes = i2s_file_read(in, raw, (size_t)BENCH_IN_FRAME * ch * (bits / 8));
+    int n = bytes / (ch * (bits / 8));
+    if (bits == 16) {
+        for (int i = 0; i < n; i++) {
+            pcm[i] = ((const int16_t *)raw)[i * ch];
+        }
+        return n;
+    }
+    for (int i = 1; i < n && ch > 1; i++) {
+        raw[i] = raw[i * ch];
+    }
+    capture_conv_s16(cv, raw, pcm, n);
+    return n;
+}
+
+static i2s_file_t *open_input(const char *path, bool realtime)
+{
+    i2s_file_t *in = i2s_file_open_reader(path, realtime);
+    if (!in) {
+        fprintf(stderr, "cannot open input wav: %s\n", path);
+        return NULL;
+    }
+    int rate, ch, bits;
+    i2s_file_get_format(in, &rate, &ch, &bits);
+    if (rate != BENCH_IN_RATE || ch > 2) {
+        fprintf(stderr, "input must be %d Hz mono/stereo (got %d Hz, %d ch)\n", BENCH_IN_RATE, rate, ch);
+        i2s_file_close(in);
+        return NULL;
+    }
+    return in;
+}
+
+/**
+ * @brief 对应 audio_resample_adf.c：[i2s_read] -> [filter] -> [i2s_write]
+ */
+static int run_resample(const bench_opts_t *o)
+{
+    i2s_file_t *in = open_input(o->in_path, o->realtime);
+    i2s_file_t *out = in ? i2s_file_open_writer(o->out_path, BENCH_OUT_RATE, 1, 16, false) : NULL;
+    if (!out) {
+        i2s_file_close(in);
+        return 1;
+    }
+    static polyphase_rsp_t rsp;
+    polyphase_rsp_reset(&rsp);
+    capture_conv_t conv;
+    capture_conv_init(&conv, NULL);
+    int16_t cap[BENCH_IN_FRAME];
+    int16_t res[BENCH_OUT_FRAME + 4];
+    for (;;) {
+        int n = 0;
+        size_t m = 0;
+        STAGE_RUN(STAGE_CAPTURE, n = capture_frame(in, &conv, cap));
+        if (n <= 0) {
+            break;
+        }
+        STAGE_RUN(STAGE_RESAMPLE, m = polyphase_rsp_process(&rsp, cap, n, res));
+        STAGE_RUN(STAGE_PLAYBACK, i2s_file_write(out, res, m * sizeof(int16_t)));
+        s_bench.audio_frames++;
+        heap_sample();
+    }
+    i2s_file_close(in);
+    i2s_file_close(out);
+    return 0;
+}
+
+/**
+ * @brief 对应 opus_encode_recorder.c + 网络 + opus_decode_play.c 的完整回环：
+ *        [i2s] -> [filter] -> [opus enc] -> slab -> 网络 -> 抖动缓冲 -> [opus dec] -> [i2s]
+ */
+static int run_loopback(const bench_opts_t *o)
+{
+    i2s_file_t *in = open_input(o->in_path, o->realtime);
+    i2s_file_t *out = in ? i2s_file_open_writer(o->out_path, BENCH_OUT_RATE, 1, 16, false) : NULL;
+    if (!out) {
+        i2s_file_close(in);
+        return 1;
+    }
+    static polyphase_rsp_t rsp;
+    polyphase_rsp_reset(&rsp);
+    capture_conv_t conv;
+    capture_conv_init(&conv, NULL);
+    bench_codec_t codec;
+    if (codec_open(&codec, o->bitrate) != 0) {
+        fprintf(stderr, "codec open failed\n");
+        return 1;
+    }
+    // 与固件一致：slab、抖动缓冲与VAD全部从预留的内存区切分，运行中不再分配
+    audio_arena_cfg_t arena_cfg = {.name = "loopback", .internal_bytes = BENCH_ARENA_SRAM, .psram_bytes = BENCH_ARENA_PSRAM};
+    audio_arena_t *arena = audio_arena_create(&arena_cfg);
+    audio_arena_set_owner(arena, "rec_slab");
+    opus_packet_slab_t *slab = opus_packet_slab_create(arena, BENCH_SLOT_COUNT, BENCH_SLOT_SIZE);
+    jitter_buffer_cfg_t jb_cfg = DEFAULT_JITTER_BUFFER_CONFIG();
+    jb_cfg.slot_size = BENCH_SLOT_SIZE;
+    jb_cfg.arena = arena;
+    audio_arena_set_owner(arena, "play_jitter");
+    jitter_buffer_t *jb = jitter_buffer_create(&jb_cfg);
+    bench_net_t net = {
+        .base_ms = o->net_base_ms, .jitter_ms = o->net_jitter_ms, .loss = o->net_loss, .seed = 1,
+        .inflight = calloc(BENCH_MAX_INFLIGHT, sizeof(bench_wire_pkt_t)),
+    };
+    if (!arena || !slab || !jb || !net.inflight) {
+        fprintf(stderr, "alloc failed\n");
+        return 1;
+    }
+    if (o->net_trace && net_load_trace(&net, o->net_trace, o->net_base_ms) != 0) {
+        return 1;
+    }
+
+    int16_t cap[BENCH_IN_FRAME];
+    int16_t res[BENCH_OUT_FRAME + 4];
+    int16_t frame[BENCH_OUT_FRAME];
+    int16_t play[BENCH_OUT_FRAME * 6];
+    int frame_fill = 0;
+    uint16_t seq = 0;
+    voice_activity_t *vad = NULL;
+    if (o->dtx) {
+        voice_activity_cfg_t vad_cfg = DEFAULT_VOICE_ACTIVITY_CONFIG();
+        vad_cfg.sample_rate = BENCH_OUT_RATE;
+        vad_cfg.arena = arena;
+        audio_arena_set_owner(arena, "rec_vad");
+        vad = voice_activity_create(&vad_cfg);
+    }
+    uint32_t dtx_gap = 0, dtx_skipped = 0, keepalive = 0, sent_pkts = 0;
+    uint64_t sent_bytes = 0;
+    uint32_t tick = 0;
+    bool eof = false;
+
+    // 以帧为节拍推进虚拟时钟；输入结束后继续播放，直到网络与抖动缓冲排空
+    while (!eof || net.count > 0 || tick < seq + 20u) {
+        uint32_t now_ms = tick * BENCH_FRAME_MS;
+        if (!eof) {
+            int n = 0;
+            size_t m = 0;
+            STAGE_RUN(STAGE_CAPTURE, n = capture_frame(in, &conv, cap));
+            if (n <= 0 || (net.trace_delay_ms && seq >= net.trace_len)) {
+                eof = true;     // 回放轨迹时，轨迹结束即停止采集
+            } else {
+                STAGE_RUN(STAGE_RESAMPLE, m = polyphase_rsp_process(&rsp, cap, n, res));
+                for (size_t i = 0; i < m; i++) {
+                    frame[frame_fill++] = res[i];
+                    if (frame_fill < BENCH_OUT_FRAME) {
+                        continue;
+                    }
+                    frame_fill = 0;
+                    // 与 opus_packet_codec.c 的DTX一致：静音段只发首帧与每个保活间隔一帧，跳过的帧也占用序号
+                    if (vad) {
+                        bool speech = false;
+                        STAGE_RUN(STAGE_VAD, speech = voice_activity_process(vad, frame, BENCH_OUT_FRAME));
+                        if (speech) {
+                            dtx_gap = 0;
+                        } else if (dtx_gap > 0 && dtx_gap < BENCH_DTX_KEEPALIVE) {
+                            dtx_gap++;
+                            dtx_skipped++;
+                            seq++;
+                            continue;
+                        } else {
+                            dtx_gap = 1;
+                            keepalive++;
+                        }
+                    }
+                    opus_packet_t *pkt = opus_packet_slab_acquire_write(slab);
+                    if (!pkt) {
+                        seq++;
+                        continue;
+                    }
+                    int len = 0;
+                    STAGE_RUN(STAGE_ENCODE, len = codec_encode(&codec, frame, pkt->data, pkt->cap));
+                    if (len <= 0) {
+                        seq++;
+                        continue;
+                    }
+                    pkt->len = (uint16_t)len;
+                    pkt->seq = seq++;
+                    pkt->timestamp = (uint32_t)pkt->seq * BENCH_OUT_FRAME;
+                    opus_packet_slab_commit(slab, pkt);
+                    sent_pkts++;
+                    sent_bytes += len;
+                }
+            }
+        }
+        uint32_t occ = opus_packet_slab_count(slab);
+        if (occ > s_bench.slab_peak) {
+            s_bench.slab_peak = occ;
+        }
+
+        // 网络任务：从slab零拷贝取包发送，接收端按到达时间放入抖动缓冲
+        STAGE_RUN(STAGE_NETWORK, {
+            const opus_packet_t *pkt;
+            while ((pkt = opus_packet_slab_acquire_read(slab)) != NULL) {
+                net_send(&net, pkt, now_ms);
+                opus_packet_slab_release(slab, pkt);
+            }
+            net_deliver(&net, jb, now_ms);
+        });
+
+        // 播放节拍：取一帧解码并写入输出
+        const uint8_t *data = NULL;
+        uint16_t len = 0;
+        jitter_frame_type_t type = jitter_buffer_get(jb, &data, &len);
+        int samples = 0;
+        if (type != JITTER_FRAME_NONE) {
+            STAGE_RUN(STAGE_DECODE, samples = codec_decode(&codec, type, data, len, play));
+            if (type == JITTER_FRAME_NORMAL) {
+                s_bench.m2e_sum_ms += now_ms - (double)jitter_buffer_playout_seq(jb) * BENCH_FRAME_MS;
+                s_bench.m2e_count++;
+            }
+        } else {
+            memset(play, 0, BENCH_OUT_FRAME * sizeof(int16_t));
+            samples = BENCH_OUT_FRAME;
+        }
+        if (samples > 0) {
+            STAGE_RUN(STAGE_PLAYBACK, i2s_file_write(out, play, samples * sizeof(int16_t)));
+        }
+        jitter_buffer_stats_t st;
+        jitter_buffer_get_stats(jb, &st);
+        if (st.depth_ms > s_bench.jitter_peak_ms) {
+            s_bench.jitter_peak_ms = st.depth_ms;
+        }
+        heap_sample();
+        s_bench.audio_frames++;
+        tick++;
+    }
+
+    jitter_buffer_stats_t st;
+    jitter_buffer_get_stats(jb, &st);
+    uint32_t shown = st.played + st.fec + st.plc;
+    double conceal = shown ? (st.fec + st.plc) * 100.0 / shown : 0;
+    if (net.trace_delay_ms) {
+        printf("network         : sent %u lost %u (trace %s, %u packets, min delay %.0f ms)\n",
+               net.sent, net.lost, o->net_trace, net.trace_len, o->net_base_ms);
+    } else {
+        printf("network         : sent %u lost %u (base %.0f ms, jitter %.0f ms, loss %.1f%%)\n",
+               net.sent, net.lost, o->net_base_ms, o->net_jitter_ms, o->net_loss * 100);
+    }
+    printf("jitter buffer   : played %u fec %u plc %u late %u target %u ms conceal %.2f%%\n",
+           st.played, st.fec, st.plc, st.late, st.target_ms, conceal);
+    if (net.trace_delay_ms) {
+        printf("trace replay    : mouth-to-ear %.1f ms, concealment %.2f%%\n",
+               s_bench.m2e_count ? s_bench.m2e_sum_ms / s_bench.m2e_count : 0, conceal);
+    }
+    double sent_s = (double)seq * BENCH_FRAME_MS / 1000.0;
+    printf("uplink          : %u packets, %llu bytes, %.1f kbps avg\n", sent_pkts,
+           (unsigned long long)sent_bytes, sent_s > 0 ? sent_bytes * 8 / sent_s / 1000 : 0);
+    if (vad) {
+        voice_activity_stats_t vs;
+        voice_activity_get_stats(vad, &vs);
+        printf("dtx             : speech %.1f%% of %u frames, %u onsets, skipped %u, keepalive %u, noise floor %.1f dBFS\n",
+               vs.frames ? vs.speech_frames * 100.0 / vs.frames : 0, vs.frames, vs.onsets, dtx_skipped, keepalive,
+               vs.noise_db_q8 / 256.0);
+        voice_activity_destroy(vad);
+    }
+
+    audio_arena_stats_t as;
+    audio_arena_get_stats(arena, &as);
+    printf("arena           : sram %u/%u psram %u/%u bytes, %u over budget\n",
+           as.used[AUDIO_ARENA_INTERNAL], as.budget[AUDIO_ARENA_INTERNAL],
+           as.used[AUDIO_ARENA_PSRAM], as.budget[AUDIO_ARENA_PSRAM], as.failures);
+    for (uint32_t i = 0; i < as.owners; i++) {
+        audio_arena_owner_stats_t os;
+        audio_arena_get_owner(arena, i, &os);
+        printf("  %-13s : sram %u psram %u\n", os.owner, os.used[AUDIO_ARENA_INTERNAL], os.used[AUDIO_ARENA_PSRAM]);
+    }
+
+    free(net.inflight);
+    free(net.trace_delay_ms);
+    jitter_buffer_destroy(jb);
+    opus_packet_slab_destroy(slab);
+    audio_arena_destroy(arena);
+    codec_close(&codec);
+    i2s_file_close(in);
+    i2s_file_close(out);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 多路解码混音                                                        */
+/* ------------------------------------------------------------------ */
+
+#ifdef HOST_HAVE_OPUS
+static size_t mix_state_size(int channels)
+{
+    return (size_t)opus_decoder_get_size(channels);
+}
+
+static int mix_state_init(void *state, int sample_rate, int channels)
+{
+    return opus_decoder_init((OpusDecoder *)state, sample_rate, channels) == OPUS_OK ? 0 : -1;
+}
+
+static int mix_state_decode(void *state, const uint8_t *data, int len, int16_t *pcm, int max_samples, int fec)
+{
+    return opus_decode((OpusDecoder *)state, data, len, pcm, max_samples, fec);
+}
+#else
+// 直通解码：状态为上一帧，PLC/FEC重复上一帧
+static size_t mix_state_size(int channels)
+{
+    return sizeof(int16_t) * BENCH_OUT_FRAME * channels;
+}
+
+static int mix_state_init(void *state, int sample_rate, int channels)
+{
+    (void)sample_rate;
+    memset(state, 0, mix_state_size(channels));
+    return 0;
+}
+
+static int mix_state_decode(void *state, const uint8_t *data, int len, int16_t *pcm, int max_samples, int fec)
+{
+    (void)fec;
+    if (max_samples < BENCH_OUT_FRAME) {
+        return -1;
+    }
+    if (data && len == (int)mix_state_size(1)) {
+        memcpy(state, data, len);
+    }
+    memcpy(pcm, state, mix_state_size(1));
+    return BENCH_OUT_FRAME;
+}
+#endif
+
+static const opus_mixer_codec_t s_mix_codec = {
+    .state_size = mix_state_size,
+    .init = mix_state_init,
+    .decode = mix_state_decode,
+};
+
+typedef struct {
+    uint16_t len;                   // 0 表示DTX期间未发送
+    uint8_t data[BENCH_SLOT_SIZE];
+} bench_mix_pkt_t;
+
+/**
+ * @brief 对应 opus_decode_play.c 的多路播放：N路错开时间的同一输入分别编码（可选DTX），
+ *        依次以 1..N 路运行 opus_mixer，只对混音节拍计时，得出每增加一路的CPU开销
+ */
+static int run_mix(const bench_opts_t *o)
+{
+    i2s_file_t *in = open_input(o->in_path, o->realtime);
+    if (!in) {
+        return 1;
+    }
+    // 1. 采集并重采样全部输入
+    static polyphase_rsp_t rsp;
+    polyphase_rsp_reset(&rsp);
+    capture_conv_t conv;
+    capture_conv_init(&conv, NULL);
+    int16_t cap[BENCH_IN_FRAME];
+    int16_t res[BENCH_OUT_FRAME + 4];
+    int16_t *src = NULL;
+    size_t src_len = 0, src_cap = 0;
+    for (;;) {
+        int n = 0;
+        size_t m = 0;
+        STAGE_RUN(STAGE_CAPTURE, n = capture_frame(in, &conv, cap));
+        if (n <= 0) {
+            break;
+        }
+        STAGE_RUN(STAGE_RESAMPLE, m = polyphase_rsp_process(&rsp, cap, n, res));
+        if (src_len + m > src_cap) {
+            src_cap = (src_len + m) * 2;
+            src = realloc(src, src_cap * sizeof(int16_t));
+        }
+        memcpy(src + src_len, res, m * sizeof(int16_t));
+        src_len += m;
+    }
+    i2s_file_close(in);
+    int frames = (int)(src_len / BENCH_OUT_FRAME);
+    int streams = o->streams;
+    if (frames < streams) {
+        fprintf(stderr, "input too short\n");
+        free(src);
+        return 1;
+    }
+
+    // 2. 每路错开 frames/streams 帧编码；DTX时静音段只发保活包（与libopus DTX一致，只有TOC字节）
+    bench_mix_pkt_t *pkts = calloc((size_t)streams * frames, sizeof(bench_mix_pkt_t));
+    uint32_t sent = 0, keepalive = 0;
+    for (int k = 0; k < streams && pkts; k++) {
+        bench_codec_t codec;
+        if (codec_open(&codec, o->bitrate) != 0) {
+            fprintf(stderr, "codec open failed\n");
+            return 1;
+        }
+        voice_activity_t *vad = NULL;
+        if (o->dtx) {
+            voice_activity_cfg_t vad_cfg = DEFAULT_VOICE_ACTIVITY_CONFIG();
+            vad_cfg.sample_rate = BENCH_OUT_RATE;
+            vad = voice_activity_create(&vad_cfg);
+        }
+        uint32_t dtx_gap = 0;
+        for (int i = 0; i < frames; i++) {
+            const int16_t *frame = src + (size_t)((i + k * frames / streams) % frames) * BENCH_OUT_FRAME;
+            bench_mix_pkt_t *p = &pkts[(size_t)k * frames + i];
+            if (vad) {
+                bool speech = false;
+                STAGE_RUN(STAGE_VAD, speech = voice_activity_process(vad, frame, BENCH_OUT_FRAME));
+                if (speech) {
+                    dtx_gap = 0;
+                } else if (dtx_gap > 0 && dtx_gap < BENCH_DTX_KEEPALIVE) {
+                    dtx_gap++;
+                    continue;
+                } else {
+                    dtx_gap = 1;
+                    p->data[0] = 0x08;
+                    p->len = 1;
+                    keepalive++;
+                    continue;
+                }
+            }
+            int len = 0;
+            STAGE_RUN(STAGE_ENCODE, len = codec_encode(&codec, frame, p->data, sizeof(p->data)));
+            p->len = len > 0 ? (uint16_t)len : 0;
+            sent += p->len > 0;
+        }
+        voice_activity_destroy(vad);
+        codec_close(&codec);
+    }
+    free(src);
+    if (!pkts) {
+        fprintf(stderr, "alloc failed\n");
+        return 1;
+    }
+
+    // 3. 依次以 1..N 路运行混音器，内存按 opus_mixer_mem_size() 精确预留
+    printf("%-8s %10s %8s %12s %10s %10s %8s %10s\n", "streams", "us/tick", "%rt", "+us/stream",
+           "decoded", "skipped", "silent", "sram");
+    double base_us = 0;
+    int ret = 0;
+    for (int n = 1; n <= streams && ret == 0; n++) {
+        opus_mixer_cfg_t cfg = DEFAULT_OPUS_MIXER_CONFIG();
+        cfg.sample_rate = BENCH_OUT_RATE;
+        cfg.frame_us = BENCH_FRAME_MS * 1000;
+        cfg.max_streams = (uint8_t)n;
+        cfg.jitter_slot_size = BENCH_SLOT_SIZE;
+        cfg.codec = &s_mix_codec;
+        audio_arena_cfg_t arena_cfg = {
+            .name = "mix",
+            .internal_bytes = opus_mixer_mem_size(&cfg, AUDIO_ARENA_INTERNAL),
+            .psram_bytes = opus_mixer_mem_size(&cfg, AUDIO_ARENA_PSRAM),
+        };
+        audio_arena_t *arena = audio_arena_create(&arena_cfg);
+        cfg.arena = arena;
+        opus_mixer_t *mix = opus_mixer_create(&cfg);
+        i2s_file_t *out = n == streams ? i2s_file_open_writer(o->out_path, BENCH_OUT_RATE, 1, 16, false) : NULL;
+        int16_t *play = aligned_alloc(AUDIO_ARENA_ALIGN, AUDIO_ARENA_SIZE(BENCH_OUT_RATE * OPUS_MIXER_MAX_FRAME_MS / 1000 * sizeof(int16_t)));
+        opus_mixer_stream_t *handle[OPUS_MIXER_MAX_STREAMS] = {0};
+        for (int k = 0; k < n && mix; k++) {
+            // 第0路0dB直接解码到输出，其余路-6dB经缩放累加
+            handle[k] = opus_mixer_open(mix, k == 0 ? AUDIO_MIX_UNITY : AUDIO_MIX_UNITY / 2);
+        }
+        if (!arena || !mix || !play || (n == streams && !out)) {
+            fprintf(stderr, "alloc failed\n");
+            ret = 1;
+        }
+        uint64_t ns = 0;
+        int ticks = 0;
+        for (int i = 0; ret == 0 && i < frames + 10; i++) {
+            uint32_t now_ms = (uint32_t)i * BENCH_FRAME_MS;
+            for (int k = 0; k < n && i < frames; k++) {
+                bench_mix_pkt_t *p = &pkts[(size_t)k * frames + i];
+                if (!p->len) {
+                    continue;
+                }
+                opus_packet_t pkt = {
+                    .data = p->data, .len = p->len, .cap = sizeof(p->data), .seq = (uint16_t)i,
+                    .stream = opus_mixer_stream_id(handle[k]), .arrival_ms = now_ms,
+                };
+                opus_mixer_put(mix, &pkt);
+            }
+            int samples = 0;
+            uint64_t t0 = now_ns();
+            samples = opus_mixer_mix(mix, play);
+            uint64_t dt = now_ns() - t0;
+            ns += dt;
+            ticks++;
+            if (n == streams) {
+                s_bench.ns[STAGE_MIX] += dt;
+                s_bench.calls[STAGE_MIX]++;
+                s_bench.audio_frames++;
+                if (samples <= 0) {
+                    memset(play, 0, BENCH_OUT_FRAME * sizeof(int16_t));
+                    samples = BENCH_OUT_FRAME;
+                }
+                STAGE_RUN(STAGE_PLAYBACK, i2s_file_write(out, play, samples * sizeof(int16_t)));
+            }
+        }
+        if (ret == 0) {
+            uint32_t decoded = 0, skipped = 0;
+            for (int k = 0; k < n; k++) {
+                opus_mixer_stream_stats_t ss;
+                opus_mixer_get_stream_stats(handle[k], &ss);
+                decoded += ss.decoded;
+                skipped += ss.skipped;
+            }
+            opus_mixer_stats_t ms;
+            opus_mixer_get_stats(mix, &ms);
+            double us = ticks ? ns / 1e3 / ticks : 0;
+            if (n == 1) {
+                base_us = us;
+            }
+            printf("%-8d %10.2f %8.3f %12.2f %10u %10u %8u %10u\n", n, us, us / (BENCH_FRAME_MS * 10.0),
+                   n > 1 ? (us - base_us) / (n - 1) : 0.0, decoded, skipped, ms.silent, arena_cfg.internal_bytes);
+        }
+        heap_sample();
+        opus_mixer_destroy(mix);
+        audio_arena_destroy(arena);
+        free(play);
+        i2s_file_close(out);
+    }
+    printf("uplink          : %d streams x %d frames, %u packets + %u dtx keepalive%s\n", streams, frames, sent,
+           keepalive, o->dtx ? "" : " (dtx off)");
+#ifndef HOST_HAVE_OPUS
+    printf("codec           : PCM pass-through (libopus not found), decode cost excluded\n");
+#endif
+    free(pkts);
+    return ret;
+}
+
+/**
+ * @brief 生成测试输入：44.1kHz 32位（高24位有效）单声道，语音状的调制多音 + 噪声，段间夹静音
+ */
+static int run_gen(const char *path, double seconds, double talk)
+{
+    i2s_file_t *out = i2s_file_open_writer(path, BENCH_IN_RATE, 1, 32, false);
+    if (!out) {
+        return 1;
+    }
+    uint32_t seed = 7;
+    int total = (int)(seconds * BENCH_IN_RATE);
+    for (int i = 0; i < total; i++) {
+        double t = (double)i / BENCH_IN_RATE;
+        double env = fmod(t, 2.0) < 2.0 * talk ? 0.5 * (1 - cos(2 * M_PI * 4 * t)) : 0.0;
+        double v = env * (0.3 * sin(2 * M_PI * 180 * t) + 0.2 * sin(2 * M_PI * 720 * t) + 0.1 * sin(2 * M_PI * 2500 * t));
+        seed = seed * 1103515245u + 12345u;
+        v += 0.002 * (((seed >> 8) & 0xffff) / 32768.0 - 1.0);
+        int32_t w = (int32_t)lrint(v * 8388607.0) * 256;   // 24位有效，左对齐到32位
+        i2s_file_write(out, &w, sizeof(w));
+    }
+    i2s_file_close(out);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: pipeline_bench gen <out.wav> <seconds> [--talk pct]\n"
+            "       pipeline_bench resample <in.wav> <out.wav> [--realtime]\n"
+            "       pipeline_bench loopback <in.wav> <out.wav> [--realtime] [--bitrate bps]\n"
+            "                      [--net-delay ms] [--net-jitter ms] [--net-loss pct] [--dtx]\n"
+            "                      [--net-trace file]  (lines \"arrival_ms seq\"; replaces jitter/loss,\n"
+            "                      arrivals shifted so the smallest one-way delay is --net-delay)\n"
+            "       pipeline_bench mix <in.wav> <out.wav> [--streams n] [--bitrate bps] [--dtx]\n"
+            "input: %d Hz WAV (16/24/32-bit) standing in for the I2S microphone\n", BENCH_IN_RATE);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        usage();
+        return 1;
+    }
+    if (!strcmp(argv[1], "gen")) {
+        double talk = 0.7;
+        if (argc > 5 && !strcmp(argv[4], "--talk")) {
+            talk = atof(argv[5]) / 100.0;
+        }
+        return run_gen(argv[2], atof(argv[3]), talk);
+    }
+    bench_opts_t o = {
+        .in_path = argv[2], .out_path = argv[3], .bitrate = 24000,
+        .net_base_ms = 20, .net_jitter_ms = 10, .net_loss = 0.01, .streams = 4,
+    };
+    for (int i = 4; i < argc; i++) {
+        if (!strcmp(argv[i], "--realtime")) {
+            o.realtime = true;
+        } else if (!strcmp(argv[i], "--bitrate") && i + 1 < argc) {
+            o.bitrate = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--net-delay") && i + 1 < argc) {
+            o.net_base_ms = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--net-jitter") && i + 1 < argc) {
+            o.net_jitter_ms = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--net-loss") && i + 1 < argc) {
+            o.net_loss = atof(argv[++i]) / 100.0;
+        } else if (!strcmp(argv[i], "--net-trace") && i + 1 < argc) {
+            o.net_trace = argv[++i];
+        } else if (!strcmp(argv[i], "--dtx")) {
+            o.dtx = true;
+        } else if (!strcmp(argv[i], "--streams") && i + 1 < argc) {
+            o.streams = atoi(argv[++i]);
+            if (o.streams < 1 || o.streams > OPUS_MIXER_MAX_STREAMS) {
+                fprintf(stderr, "--streams must be 1..%d\n", OPUS_MIXER_MAX_STREAMS);
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    s_bench.heap_base = heap_in_use();
+    s_bench.heap_peak = s_bench.heap_base;
+    uint64_t t0 = now_ns();
+    int ret;
+    if (!strcmp(argv[1], "resample")) {
+        ret = run_resample(&o);
+    } else if (!strcmp(argv[1], "loopback")) {
+        ret = run_loopback(&o);
+    } else if (!strcmp(argv[1], "mix")) {
+        ret = run_mix(&o);
+    } else {
+        usage();
+        return 1;
+    }
+    if (ret == 0) {
+        bench_report(argv[1], (now_ns() - t0) / 1e9);
+    }
+    return ret;
+}
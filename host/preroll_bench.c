@@ -0,0 +1,353 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端预录环测试：按20ms帧时间轴模拟常开编码（可带DTX），在随机时刻触发，
+ *               统计交出的触发前历史时长、历史与实时的衔接是否完整，并与“触发后才启动录制”对比；
+ *               stress 模式以生产者/读取者两个线程反复触发、解除，校验包内容与顺序
+ * @FilePath: \audio_manager\host\preroll_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "opus_preroll.h"
+
+#define BENCH_RATE          16000       // 编码采样率（同 AUDIO_CAPTURE_SAMPLE_RATE）
+#define BENCH_FRAME         320         // 20ms 帧
+#define BENCH_MAX_PACKET    512         // 单包最大长度（同 OPUS_RECORDER_SLOT_SIZE）
+#define BENCH_KEEPALIVE     20          // DTX 静音段每20帧（400ms）一个保活包
+#define BENCH_MAX_FRAMES    (3600 * 50) // 时间轴最长1小时
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t rnd(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+/**
+ * @brief 包内容由序号决定，读取端据此校验没有读到被覆盖或错位的数据
+ */
+static void fill_packet(uint8_t *data, uint16_t len, uint16_t seq)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        data[i] = (uint8_t)(seq * 31 + i);
+    }
+}
+
+static bool check_packet(const opus_packet_t *pkt)
+{
+    for (uint16_t i = 0; i < pkt->len; i++) {
+        if (pkt->data[i] != (uint8_t)(pkt->seq * 31 + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/* run：按帧时间轴模拟，统计每次触发交出的历史                          */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint32_t history_ms;        // 预录环设定历史
+    uint32_t back_ms;           // 触发时回溯时长
+    uint32_t bitrate;           // 比特率
+    bool dtx;                   // 静音段只写保活包
+    uint32_t triggers;          // 触发次数
+    uint32_t live_ms;           // 每次触发后读取实时包的时长
+    uint32_t startup_ms;        // 对比：触发后才构建管道、安装I2S的启动耗时
+} run_cfg_t;
+
+typedef struct {
+    uint16_t seq;
+    uint16_t len;
+    uint32_t ts;
+} produced_t;
+
+static int cmd_run(const run_cfg_t *cfg)
+{
+    uint32_t bytes = opus_preroll_bytes_for(cfg->history_ms, cfg->bitrate, 20000, BENCH_MAX_PACKET);
+    opus_preroll_t *pr = opus_preroll_create(NULL, bytes, BENCH_MAX_PACKET);
+    static produced_t produced[BENCH_MAX_FRAMES];
+    if (!pr) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    uint32_t seed = 7;
+    uint32_t nominal = cfg->bitrate / 8 / 50;
+    uint32_t gap_frames = cfg->live_ms / 20 + cfg->history_ms / 20 + 50;   // 两次触发之间至少积满一次历史
+    uint32_t frames = cfg->history_ms / 20 + cfg->triggers * gap_frames + 100;
+    if (frames > BENCH_MAX_FRAMES) {
+        fprintf(stderr, "timeline too long\n");
+        return 2;
+    }
+
+    uint32_t nproduced = 0;
+    uint32_t next_trigger = cfg->history_ms / 20 + rnd(&seed) % 50;
+    uint32_t live_end = 0;
+    bool reading = false;
+    bool first = false;
+    uint32_t trigger_ts = 0;
+    uint32_t from_ts = 0;
+    uint32_t expect_idx = 0;    // 读取端期望的下一个包在 produced[] 中的下标
+    uint32_t done = 0;
+    uint32_t missing = 0;
+    uint32_t corrupt = 0;
+    uint64_t recovered_total = 0;
+    uint32_t recovered_min = UINT32_MAX;
+    uint64_t history_pkts = 0;
+    uint64_t produce_ns = 0;
+    uint16_t seq = 0;
+
+    for (uint32_t k = 0; k < frames && done < cfg->triggers; k++) {
+        uint32_t ts = k * BENCH_FRAME;
+        // 生产者：讲话3秒、静音1秒交替，DTX时静音段只写保活包
+        bool speech = (k / 50) % 4 != 3;
+        bool emit = speech || !cfg->dtx || (k % BENCH_KEEPALIVE) == 0;
+        uint64_t t0 = now_ns();
+        opus_preroll_poll(pr, ts);
+        if (emit) {
+            opus_packet_t *pkt = opus_preroll_acquire_write(pr);
+            if (pkt) {
+                uint16_t len = speech ? (uint16_t)(nominal * 3 / 4 + rnd(&seed) % (nominal / 2 + 1)) : 3;
+                fill_packet(pkt->data, len, seq);
+                pkt->len = len;
+                pkt->seq = seq;
+                pkt->timestamp = ts;
+                opus_preroll_commit(pr, pkt);
+                produced[nproduced++] = (produced_t) {seq, len, ts};
+            }
+        }
+        produce_ns += now_ns() - t0;
+        seq++;
+
+        // 读取者：到点触发，回溯 back_ms；每帧取空已有的包，逐包与生产记录比对
+        if (!reading && k == next_trigger) {
+            trigger_ts = ts + BENCH_FRAME;
+            from_ts = trigger_ts - cfg->back_ms * (BENCH_RATE / 1000);
+            opus_preroll_trigger(pr, from_ts);
+            reading = true;
+            first = true;
+            live_end = k + cfg->live_ms / 20;
+            // 期望从首个不早于起点、且仍在环内的包开始
+            expect_idx = 0;
+            while (expect_idx < nproduced && (int32_t)(produced[expect_idx].ts - from_ts) < 0) {
+                expect_idx++;
+            }
+            continue;
+        }
+        if (!reading) {
+            continue;
+        }
+        const opus_packet_t *pkt;
+        while ((pkt = opus_preroll_acquire_read(pr)) != NULL) {
+            if (first) {
+                // 首包之前被覆盖的部分计为缺失（历史不足时正常）
+                opus_preroll_stats_t st;
+                opus_preroll_get_stats(pr, &st);
+                uint32_t rec_ms = (trigger_ts - pkt->timestamp) / (BENCH_RATE / 1000);
+                recovered_total += rec_ms;
+                recovered_min = rec_ms < recovered_min ? rec_ms : recovered_min;
+                history_pkts += st.history_packets;
+                while (expect_idx < nproduced && produced[expect_idx].seq != pkt->seq) {
+                    expect_idx++;
+                }
+                first = false;
+            }
+            if (expect_idx >= nproduced || produced[expect_idx].seq != pkt->seq ||
+                produced[expect_idx].len != pkt->len || produced[expect_idx].ts != pkt->timestamp) {
+                missing++;
+                while (expect_idx < nproduced && produced[expect_idx].seq != pkt->seq) {
+                    expect_idx++;
+                }
+            }
+            if (!check_packet(pkt)) {
+                corrupt++;
+            }
+            expect_idx++;
+            opus_preroll_release(pr, pkt);
+        }
+        if (k >= live_end) {
+            // 实时段结束时应已读到最新的包
+            if (expect_idx != nproduced) {
+                missing += nproduced - expect_idx;
+            }
+            opus_preroll_disarm(pr);
+            reading = false;
+            done++;
+            next_trigger = k + cfg->history_ms / 20 + 1 + rnd(&seed) % 50;
+        }
+    }
+
+    opus_preroll_stats_t st;
+    opus_preroll_get_stats(pr, &st);
+    printf("ring %u bytes for %u ms at %u bps%s, %u packets written, %u evicted, %u dropped\n",
+           (unsigned)st.capacity, (unsigned)cfg->history_ms, (unsigned)cfg->bitrate, cfg->dtx ? " (dtx)" : "",
+           (unsigned)st.packets, (unsigned)st.evicted, (unsigned)st.dropped);
+    printf("%u triggers, back %u ms: recovered before trigger avg %.0f ms, min %u ms, %.1f history packets\n",
+           (unsigned)done, (unsigned)cfg->back_ms, done ? (double)recovered_total / done : 0.0,
+           done ? (unsigned)recovered_min : 0, done ? (double)history_pkts / done : 0.0);
+    printf("history -> live: %u missing/out-of-order, %u corrupt packets\n", (unsigned)missing, (unsigned)corrupt);
+    printf("start on trigger instead: first %u ms after the trigger lost, nothing before it\n",
+           (unsigned)cfg->startup_ms);
+    printf("producer cost %.0f ns per 20 ms frame (poll + acquire + commit + fill)\n",
+           nproduced ? (double)produce_ns / seq : 0.0);
+    opus_preroll_destroy(pr);
+    return missing || corrupt || done < cfg->triggers ? 1 : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* stress：生产者与读取者线程并发，反复触发/解除                        */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    opus_preroll_t *pr;
+    atomic_bool stop;
+    uint64_t frames;
+} stress_t;
+
+static void *stress_producer(void *arg)
+{
+    stress_t *s = arg;
+    uint32_t seed = 3;
+    uint16_t seq = 0;
+    uint32_t ts = 0;
+    while (!atomic_load(&s->stop)) {
+        opus_preroll_poll(s->pr, ts);
+        opus_packet_t *pkt = opus_preroll_acquire_write(s->pr);
+        if (pkt) {
+            uint16_t len = (uint16_t)(1 + rnd(&seed) % 160);
+            fill_packet(pkt->data, len, seq);
+            pkt->len = len;
+            pkt->seq = seq;
+            pkt->timestamp = ts;
+            opus_preroll_commit(s->pr, pkt);
+        } else {
+            sched_yield();
+        }
+        seq++;
+        ts += BENCH_FRAME;
+        s->frames++;
+    }
+    return NULL;
+}
+
+static int cmd_stress(double seconds)
+{
+    stress_t s = {.pr = opus_preroll_create(NULL, 16 * 1024, BENCH_MAX_PACKET)};
+    if (!s.pr) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    atomic_init(&s.stop, false);
+    pthread_t th;
+    pthread_create(&th, NULL, stress_producer, &s);
+    uint32_t seed = 5;
+    uint64_t end = now_ns() + (uint64_t)(seconds * 1e9);
+    uint64_t packets = 0;
+    uint32_t triggers = 0;
+    uint32_t corrupt = 0;
+    uint32_t backwards = 0;
+    while (now_ns() < end) {
+        opus_preroll_trigger(s.pr, opus_preroll_timestamp(s.pr) - (rnd(&seed) % 200) * BENCH_FRAME);
+        while (!opus_preroll_is_armed(s.pr) && now_ns() < end) {
+            sched_yield();
+        }
+        triggers++;
+        bool have_prev = false;
+        uint32_t prev_ts = 0;
+        uint32_t want = 1 + rnd(&seed) % 2000;
+        for (uint32_t n = 0; n < want && now_ns() < end;) {
+            const opus_packet_t *pkt = opus_preroll_acquire_read(s.pr);
+            if (!pkt) {
+                sched_yield();
+                continue;
+            }
+            corrupt += !check_packet(pkt);
+            backwards += have_prev && (int32_t)(pkt->timestamp - prev_ts) <= 0;
+            have_prev = true;
+            prev_ts = pkt->timestamp;
+            opus_preroll_release(s.pr, pkt);
+            packets++;
+            n++;
+        }
+        opus_preroll_disarm(s.pr);
+    }
+    atomic_store(&s.stop, true);
+    pthread_join(th, NULL);
+    opus_preroll_stats_t st;
+    opus_preroll_get_stats(s.pr, &st);
+    printf("%u triggers, %llu frames, %llu packets read, %u evicted, %u dropped while armed\n", (unsigned)triggers,
+           (unsigned long long)s.frames, (unsigned long long)packets, (unsigned)st.evicted, (unsigned)st.dropped);
+    printf("%u corrupt, %u out-of-order packets\n", (unsigned)corrupt, (unsigned)backwards);
+    opus_preroll_destroy(s.pr);
+    return corrupt || backwards ? 1 : 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: preroll_bench run [--history ms] [--back ms] [--bitrate bps] [--dtx] [--triggers n]\n"
+            "                         [--live ms] [--startup-ms ms]\n"
+            "       preroll_bench stress [seconds]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && !strcmp(argv[1], "stress")) {
+        return cmd_stress(argc >= 3 ? atof(argv[2]) : 2.0);
+    }
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 2;
+    }
+    run_cfg_t cfg = {
+        .history_ms = 5000,
+        .back_ms = 2000,
+        .bitrate = 24000,
+        .triggers = 20,
+        .live_ms = 3000,
+        .startup_ms = 300,
+    };
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--dtx")) {
+            cfg.dtx = true;
+        } else if (!strcmp(argv[i], "--history") && i + 1 < argc) {
+            cfg.history_ms = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--back") && i + 1 < argc) {
+            cfg.back_ms = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--bitrate") && i + 1 < argc) {
+            cfg.bitrate = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--triggers") && i + 1 < argc) {
+            cfg.triggers = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--live") && i + 1 < argc) {
+            cfg.live_ms = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--startup-ms") && i + 1 < argc) {
+            cfg.startup_ms = (uint32_t)atoi(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (cfg.bitrate < 6000 || cfg.history_ms < 20 || cfg.triggers == 0) {
+        usage();
+        return 2;
+    }
+    return cmd_run(&cfg);
+}
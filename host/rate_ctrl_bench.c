@@ -0,0 +1,241 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 12:00:00
+ * @LastEditTime: 2026-10-17 12:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端编码参数自适应基准：以编码耗时模型与瓶颈链路模型驱动 opus_rate_ctrl，
+ *               对比固定参数与自适应下的编码超时、链路丢包、排队延迟与码率利用率
+ * @FilePath: \audio_manager\host\rate_ctrl_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "opus_rate_ctrl.h"
+
+#define BENCH_FRAME_US      20000               // 初始帧长
+#define BENCH_QUEUE_MS      200                 // 瓶颈队列上限（超出即丢包）
+#define BENCH_REPORT_MS     1000                // 接收端反馈周期
+#define BENCH_MAX_DELAYS    (1 << 16)           // 排队延迟样本上限
+
+/**
+ * @brief 场景：每段时长内的CPU负载倍数、链路带宽与随机丢包率
+ */
+typedef struct {
+    int seconds;
+    double cpu_load;        // 编码耗时倍数（与采集/AEC/WiFi共核时的争用）
+    int capacity_bps;       // 瓶颈带宽
+    int loss_pct;           // 随机丢包率
+    const char *what;
+} bench_phase_t;
+
+static const bench_phase_t s_phases[] = {
+    {20, 1.0, 64000, 0, "idle"},
+    {30, 2.2, 64000, 0, "cpu contention"},
+    {30, 1.0, 24000, 0, "link 24k"},
+    {30, 1.0, 14000, 0, "link 14k"},
+    {30, 1.0, 48000, 0, "link 48k"},
+    {30, 1.0, 48000, 6, "6% random loss"},
+};
+#define BENCH_PHASES (sizeof(s_phases) / sizeof(s_phases[0]))
+
+typedef struct {
+    uint32_t frames;
+    uint32_t overruns;          // 编码耗时超出帧长预算
+    uint32_t sent;
+    uint32_t dropped;           // 瓶颈队列溢出
+    uint32_t lost;              // 随机丢包
+    uint32_t fec_frames;        // 开着FEC的帧数
+    uint64_t payload_bits;
+    uint64_t capacity_bits;
+    uint32_t delays;
+    uint16_t *delay_ms;         // 每包排队延迟
+    uint64_t update_ns;         // 控制器耗时
+    uint32_t changes;
+} bench_result_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t rnd(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+/**
+ * @brief 编码耗时模型（微秒）：随复杂度线性增长，随帧长按比例增长，±10%抖动
+ */
+static uint32_t encode_cost_us(const opus_rate_params_t *p, double load, uint32_t *seed)
+{
+    double us = (900.0 + 520.0 * p->complexity) * (1.0 + p->bitrate / 200000.0) * p->frame_us / 20000.0;
+    us *= load * (0.9 + (rnd(seed) % 2001) / 10000.0);
+    return (uint32_t)us;
+}
+
+static int cmp_u16(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+static void run(bool adaptive, const opus_rate_params_t *init, const opus_rate_ctrl_cfg_t *cfg,
+                bool trace, bench_result_t *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->delay_ms = calloc(BENCH_MAX_DELAYS, sizeof(uint16_t));
+    opus_rate_ctrl_t *rc = opus_rate_ctrl_create(cfg, init);
+    if (!rc || !res->delay_ms) {
+        fprintf(stderr, "alloc failed\n");
+        exit(1);
+    }
+    opus_rate_params_t p = *init;
+    uint32_t seed = 7;
+    double queue_bits = 0;
+    uint64_t t_us = 0, next_report_us = BENCH_REPORT_MS * 1000ull;
+    uint32_t iv_sent = 0, iv_lost = 0;
+    uint64_t phase_end_us = 0;
+    for (size_t ph = 0; ph < BENCH_PHASES; ph++) {
+        const bench_phase_t *phase = &s_phases[ph];
+        phase_end_us += phase->seconds * 1000000ull;
+        uint32_t ph_frames = 0, ph_overruns = 0, ph_drop = 0, ph_sent = 0;
+        uint64_t ph_rate = 0, ph_cplx = 0;
+        while (t_us < phase_end_us) {
+            // 1. 编码一帧
+            uint32_t cost = encode_cost_us(&p, phase->cpu_load, &seed);
+            res->frames++;
+            ph_frames++;
+            if (cost > (uint32_t)p.frame_us * cfg->cpu_budget_pct / 100) {
+                res->overruns++;
+                ph_overruns++;
+            }
+            if (p.fec) {
+                res->fec_frames++;
+            }
+            ph_rate += p.bitrate;
+            ph_cplx += p.complexity;
+
+            // 2. 经瓶颈链路发送：队列按带宽排空，超过上限尾部丢弃
+            double drain = (double)phase->capacity_bps * p.frame_us / 1e6;
+            queue_bits = queue_bits > drain ? queue_bits - drain : 0;
+            res->capacity_bits += (uint64_t)drain;
+            uint32_t payload = (uint32_t)((uint64_t)p.bitrate * p.frame_us / 8000000);
+            double bits = (payload + cfg->overhead_bytes) * 8.0;
+            double delay_ms = (queue_bits + bits) * 1000.0 / phase->capacity_bps;
+            res->sent++;
+            ph_sent++;
+            iv_sent++;
+            if (delay_ms > BENCH_QUEUE_MS) {
+                res->dropped++;
+                ph_drop++;
+                iv_lost++;
+            } else if ((int)(rnd(&seed) % 100) < phase->loss_pct) {
+                queue_bits += bits;
+                res->lost++;
+                iv_lost++;
+            } else {
+                queue_bits += bits;
+                res->payload_bits += payload * 8u;
+                if (res->delays < BENCH_MAX_DELAYS) {
+                    res->delay_ms[res->delays++] = (uint16_t)delay_ms;
+                }
+            }
+            t_us += p.frame_us;
+
+            // 3. 控制器：耗时反馈每帧一次，接收端反馈每秒一次（带宽估计 ±5%）
+            if (adaptive) {
+                uint64_t t0 = now_ns();
+                opus_rate_ctrl_encode_time(rc, cost);
+                if (t_us >= next_report_us) {
+                    next_report_us += BENCH_REPORT_MS * 1000ull;
+                    uint32_t bw = (uint32_t)(phase->capacity_bps * (0.95 + (rnd(&seed) % 1001) / 10000.0));
+                    opus_rate_ctrl_report(rc, (uint8_t)(iv_sent ? iv_lost * 100 / iv_sent : 0), bw);
+                    iv_sent = iv_lost = 0;
+                }
+                if (opus_rate_ctrl_update(rc, &p)) {
+                    res->changes++;
+                }
+                res->update_ns += now_ns() - t0;
+            }
+        }
+        if (trace) {
+            printf("  %-15s %3ds: bitrate %5.1f kbps, complexity %4.1f, frame %2d ms, fec %d, overruns %3u/%u, dropped %3u/%u\n",
+                   phase->what, phase->seconds, ph_rate / 1000.0 / ph_frames, (double)ph_cplx / ph_frames,
+                   p.frame_us / 1000, p.fec, ph_overruns, ph_frames, ph_drop, ph_sent);
+        }
+    }
+    opus_rate_ctrl_destroy(rc);
+}
+
+static void report(const char *name, bench_result_t *r)
+{
+    qsort(r->delay_ms, r->delays, sizeof(uint16_t), cmp_u16);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < r->delays; i++) {
+        sum += r->delay_ms[i];
+    }
+    printf("%-10s: overruns %4u/%u (%.1f%%), link drops %4u (%.2f%%), random loss %3u, "
+           "queue delay avg %.1f ms p95 %u ms, goodput %.1f%% of capacity, fec %.0f%% of frames, %u changes",
+           name, r->overruns, r->frames, r->overruns * 100.0 / r->frames, r->dropped, r->dropped * 100.0 / r->sent,
+           r->lost, r->delays ? (double)sum / r->delays : 0, r->delays ? r->delay_ms[r->delays * 95 / 100] : 0,
+           r->payload_bits * 100.0 / r->capacity_bits, r->fec_frames * 100.0 / r->frames, r->changes);
+    if (r->update_ns) {
+        printf(", %.0f ns/frame", (double)r->update_ns / r->frames);
+    }
+    printf("\n");
+    free(r->delay_ms);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: rate_ctrl_bench run [--bitrate bps] [--complexity n] [--budget pct] [--adapt-frame] [--trace]\n"
+            "simulates a %d s scenario (cpu contention, link drops to 24k/14k, random loss)\n"
+            "and compares fixed encoder parameters against opus_rate_ctrl\n", 170);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 1;
+    }
+    opus_rate_ctrl_cfg_t cfg = DEFAULT_OPUS_RATE_CTRL_CONFIG();
+    opus_rate_params_t init = {.bitrate = 24000, .complexity = 5, .frame_us = BENCH_FRAME_US, .fec = false, .loss_pct = 0};
+    bool trace = false;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--bitrate") && i + 1 < argc) {
+            init.bitrate = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--complexity") && i + 1 < argc) {
+            init.complexity = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--budget") && i + 1 < argc) {
+            cfg.cpu_budget_pct = (uint8_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--adapt-frame")) {
+            cfg.adapt_frame = true;
+        } else if (!strcmp(argv[i], "--trace")) {
+            trace = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    bench_result_t fixed, adaptive;
+    if (trace) {
+        printf("fixed %d bps, complexity %d:\n", init.bitrate, init.complexity);
+    }
+    run(false, &init, &cfg, trace, &fixed);
+    if (trace) {
+        printf("adaptive (budget %u%% of frame, %s):\n", cfg.cpu_budget_pct, cfg.adapt_frame ? "adapt frame" : "fixed frame");
+    }
+    run(true, &init, &cfg, trace, &adaptive);
+    report("fixed", &fixed);
+    report("adaptive", &adaptive);
+    return 0;
+}
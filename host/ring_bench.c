@@ -0,0 +1,460 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 17:00:00
+ * @LastEditTime: 2026-10-17 17:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端包队列压力测试：生产者/消费者线程经加锁阻塞环形缓冲区（raw_stream + ringbuf 模型）
+ *               与无等待包slab（逐包/成批）传递Opus大小的包，校验顺序与内容，对比吞吐、交付尾延迟与写入方单次调用耗时，
+ *               并统计每包的拷贝次数与字节数（加锁环形缓冲区至少2次，slab原地收发为0，兼容接口为1）
+ * @FilePath: \audio_manager\host\ring_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "opus_packet_slab.h"
+
+#define BENCH_SLOT_COUNT    16          // 包槽数（同 PACKET_SLOT_COUNT）
+#define BENCH_SLOT_SIZE     512         // 包槽容量（同 PACKET_SLOT_SIZE）
+#define BENCH_PKT_LEN       80          // 20ms 32kbps 的Opus包
+#define BENCH_RB_SIZE       (BENCH_SLOT_COUNT * BENCH_SLOT_SIZE)   // 加锁环形缓冲区与slab同样大小
+#define BENCH_MAX_BATCH     16
+#define BENCH_HIST_BUCKETS  2048
+
+typedef enum {
+    MODE_LOCKED = 0,            // raw_stream_write/read：加锁，写满/读空时阻塞
+    MODE_SLAB,                  // 包slab逐包：不阻塞，写满/读空时让出CPU后重试
+    MODE_SLAB_BATCH,            // 包slab成批
+    MODE_SLAB_COMPAT,           // 包slab兼容接口：消费者同 opus_encode_recorder_read，拷出到调用者缓冲区
+} bench_mode_t;
+
+static const char *const s_mode_names[] = {"locked ringbuf", "slab", "slab batch", "slab compat"};
+
+/* ------------------------------------------------------------------ */
+/* 计时与延迟直方图（每2的幂分32档，相对误差约3%）                     */
+/* ------------------------------------------------------------------ */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+typedef struct {
+    uint64_t count[BENCH_HIST_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+} bench_hist_t;
+
+static void hist_add(bench_hist_t *h, uint64_t ns)
+{
+    uint32_t b = (uint32_t)ns;
+    if (ns >= 64) {
+        int e = 63 - __builtin_clzll(ns);
+        b = 64 + (uint32_t)(e - 6) * 32 + (uint32_t)((ns >> (e - 5)) & 31);
+    }
+    h->count[b < BENCH_HIST_BUCKETS ? b : BENCH_HIST_BUCKETS - 1]++;
+    h->total++;
+    if (ns > h->max) {
+        h->max = ns;
+    }
+}
+
+static uint64_t hist_value(uint32_t b)
+{
+    if (b < 64) {
+        return b;
+    }
+    uint32_t e = (b - 64) / 32 + 6;
+    return (uint64_t)(32 + (b - 64) % 32) << (e - 5);
+}
+
+static uint64_t hist_pct(const bench_hist_t *h, double pct)
+{
+    uint64_t want = (uint64_t)(h->total * pct / 100.0);
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < BENCH_HIST_BUCKETS; b++) {
+        seen += h->count[b];
+        if (seen > want) {
+            return hist_value(b);
+        }
+    }
+    return h->max;
+}
+
+/* ------------------------------------------------------------------ */
+/* 拷贝计数：数据路径上的每次 memcpy 都经过这里                        */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint64_t calls;             // memcpy 次数
+    uint64_t bytes;             // 拷贝字节数
+} bench_copy_t;
+
+static void bench_copy(bench_copy_t *c, void *dst, const void *src, size_t len)
+{
+    memcpy(dst, src, len);
+    c->calls++;
+    c->bytes += len;
+}
+
+/* ------------------------------------------------------------------ */
+/* 加锁环形缓冲区（语义同 raw_stream + ADF ringbuf：每包前置长度，写满/读空阻塞）*/
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint8_t buf[BENCH_RB_SIZE];
+    size_t head;
+    size_t fill;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    bench_copy_t copy;
+} bench_rb_t;
+
+/* 同 ADF ringbuf：写入/读出各一次 memcpy，跨过缓冲区末尾时分两段 */
+static void rb_copy_in(bench_rb_t *rb, const void *data, size_t len)
+{
+    size_t pos = (rb->head + rb->fill) % BENCH_RB_SIZE;
+    size_t first = BENCH_RB_SIZE - pos < len ? BENCH_RB_SIZE - pos : len;
+    bench_copy(&rb->copy, &rb->buf[pos], data, first);
+    if (first < len) {
+        bench_copy(&rb->copy, rb->buf, (const uint8_t *)data + first, len - first);
+    }
+    rb->fill += len;
+}
+
+static void rb_copy_out(bench_rb_t *rb, void *data, size_t len)
+{
+    size_t first = BENCH_RB_SIZE - rb->head < len ? BENCH_RB_SIZE - rb->head : len;
+    bench_copy(&rb->copy, data, &rb->buf[rb->head], first);
+    if (first < len) {
+        bench_copy(&rb->copy, (uint8_t *)data + first, rb->buf, len - first);
+    }
+    rb->head = (rb->head + len) % BENCH_RB_SIZE;
+    rb->fill -= len;
+}
+
+static void rb_write(bench_rb_t *rb, const uint8_t *data, uint16_t len)
+{
+    pthread_mutex_lock(&rb->mu);
+    while (BENCH_RB_SIZE - rb->fill < sizeof(len) + len) {
+        pthread_cond_wait(&rb->cv, &rb->mu);
+    }
+    rb_copy_in(rb, &len, sizeof(len));
+    rb_copy_in(rb, data, len);
+    pthread_cond_broadcast(&rb->cv);
+    pthread_mutex_unlock(&rb->mu);
+}
+
+static int rb_read(bench_rb_t *rb, uint8_t *data, const volatile bool *done)
+{
+    uint16_t len = 0;
+    pthread_mutex_lock(&rb->mu);
+    while (rb->fill == 0 && !*done) {
+        pthread_cond_wait(&rb->cv, &rb->mu);
+    }
+    if (rb->fill > 0) {
+        rb_copy_out(rb, &len, sizeof(len));
+        rb_copy_out(rb, data, len);
+        pthread_cond_broadcast(&rb->cv);
+    }
+    pthread_mutex_unlock(&rb->mu);
+    return len;
+}
+
+/* ------------------------------------------------------------------ */
+/* 生产者/消费者                                                       */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    bench_mode_t mode;
+    uint32_t batch;
+    uint64_t duration_ns;
+    uint64_t period_ns;         // 0 为尽快发送（测吞吐），否则按该间隔发送（测交付延迟）
+    bench_rb_t rb;
+    opus_packet_slab_t *slab;
+    volatile bool done;         // 生产者已发完
+    uint64_t sent;
+    uint64_t received;
+    uint64_t errors;            // 乱序或内容不符
+    uint64_t in_place;          // 消费者读到的正是生产者写入的那块内存（未经拷贝）的包数
+    bench_copy_t copy;          // 兼容接口拷出的次数与字节（环形缓冲区的在 rb.copy）
+    uint64_t full;              // 写入时已满的次数（slab）
+    uint64_t elapsed_ns;
+    uint32_t wm_high;           // 高水位通知次数
+    uint32_t wm_low;            // 低水位通知次数
+    bench_hist_t call;          // 生产者单次写入调用耗时（网络任务被音频拖住的时间）
+    bench_hist_t lat;           // 提交到被消费者取出的延迟
+} bench_run_t;
+
+/* 包头依次为序号、发送时间与生产者写入的地址（字段拷贝不属于数据路径，不计数） */
+static void fill_packet(uint8_t *p, uint64_t seq, uint64_t t)
+{
+    uintptr_t addr = (uintptr_t)p;
+    memcpy(p, &seq, sizeof(seq));
+    memcpy(p + 8, &t, sizeof(t));
+    memcpy(p + 16, &addr, sizeof(addr));
+    memset(p + 24, (uint8_t)seq, BENCH_PKT_LEN - 24);
+}
+
+static void check_packet(bench_run_t *r, const uint8_t *p, uint16_t len, uint64_t now)
+{
+    uint64_t seq;
+    uint64_t t;
+    uintptr_t addr;
+    memcpy(&seq, p, sizeof(seq));
+    memcpy(&t, p + 8, sizeof(t));
+    memcpy(&addr, p + 16, sizeof(addr));
+    if (len != BENCH_PKT_LEN || seq != r->received || p[BENCH_PKT_LEN - 1] != (uint8_t)seq) {
+        r->errors++;
+    }
+    if (addr == (uintptr_t)p) {
+        r->in_place++;
+    }
+    hist_add(&r->lat, now - t);
+    r->received++;
+}
+
+static void on_watermark(void *ctx, bool high)
+{
+    bench_run_t *r = ctx;
+    if (high) {
+        r->wm_high++;
+    } else {
+        r->wm_low++;
+    }
+}
+
+static void *producer(void *arg)
+{
+    bench_run_t *r = arg;
+    uint8_t pkt[BENCH_PKT_LEN];
+    uint64_t start = now_ns();
+    uint64_t next = start;
+    while (now_ns() - start < r->duration_ns) {
+        if (r->period_ns) {
+            while (now_ns() < next) {
+                sched_yield();
+            }
+            next += r->period_ns;
+        }
+        uint64_t t0 = now_ns();
+        if (r->mode == MODE_LOCKED) {
+            fill_packet(pkt, r->sent, t0);
+            rb_write(&r->rb, pkt, BENCH_PKT_LEN);
+            r->sent++;
+        } else {
+            // 同 opus_decode_play_write/write_batch：取槽、拷贝、提交，已满则本次不写，由调用者稍后重试
+            opus_packet_t *slots[BENCH_MAX_BATCH];
+            uint32_t want = r->mode == MODE_SLAB_BATCH && !r->period_ns ? r->batch : 1;
+            uint32_t got = opus_packet_slab_acquire_write_batch(r->slab, slots, want);
+            for (uint32_t i = 0; i < got; i++) {
+                fill_packet(slots[i]->data, r->sent + i, t0);
+                slots[i]->len = BENCH_PKT_LEN;
+            }
+            opus_packet_slab_commit_batch(r->slab, got);
+            r->sent += got;
+            if (got == 0) {
+                r->full++;
+            }
+        }
+        hist_add(&r->call, now_ns() - t0);
+        if (r->mode != MODE_LOCKED && !r->period_ns && opus_packet_slab_count(r->slab) > BENCH_SLOT_COUNT / 2) {
+            sched_yield();  // 单核主机上让消费者有机会运行
+        }
+    }
+    r->elapsed_ns = now_ns() - start;
+    __atomic_store_n(&r->done, true, __ATOMIC_RELEASE);
+    if (r->mode == MODE_LOCKED) {
+        pthread_mutex_lock(&r->rb.mu);
+        pthread_cond_broadcast(&r->rb.cv);
+        pthread_mutex_unlock(&r->rb.mu);
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    bench_run_t *r = arg;
+    uint8_t pkt[BENCH_SLOT_SIZE];
+    for (;;) {
+        bool done = __atomic_load_n(&r->done, __ATOMIC_ACQUIRE);
+        uint32_t got = 0;
+        if (r->mode == MODE_LOCKED) {
+            int len = rb_read(&r->rb, pkt, &r->done);
+            if (len > 0) {
+                check_packet(r, pkt, (uint16_t)len, now_ns());
+                got = 1;
+            }
+        } else if (r->mode == MODE_SLAB_COMPAT) {
+            // 同 opus_encode_recorder_read：取一个包，拷到调用者缓冲区后立即归还
+            const opus_packet_t *p = opus_packet_slab_acquire_read(r->slab);
+            if (p) {
+                uint16_t len = p->len;
+                bench_copy(&r->copy, pkt, p->data, len);
+                opus_packet_slab_release(r->slab, p);
+                check_packet(r, pkt, len, now_ns());
+                got = 1;
+            } else if (!done) {
+                sched_yield();
+            }
+        } else {
+            // 同解码元素：成批取出、按包处理后一次归还；逐包模式每次只取一个
+            const opus_packet_t *pkts[BENCH_MAX_BATCH];
+            uint32_t want = r->mode == MODE_SLAB_BATCH ? r->batch : 1;
+            got = opus_packet_slab_acquire_read_batch(r->slab, pkts, want);
+            uint64_t now = now_ns();
+            for (uint32_t i = 0; i < got; i++) {
+                check_packet(r, pkts[i]->data, pkts[i]->len, now);
+            }
+            opus_packet_slab_release_batch(r->slab, got);
+            if (got == 0 && !done) {
+                sched_yield();
+            }
+        }
+        if (got == 0 && done && r->received == r->sent) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static bench_run_t *run_one(bench_mode_t mode, uint32_t batch, double seconds, uint64_t period_ns)
+{
+    bench_run_t *r = calloc(1, sizeof(bench_run_t));
+    if (!r) {
+        return NULL;
+    }
+    r->mode = mode;
+    r->batch = batch;
+    r->duration_ns = (uint64_t)(seconds * 1e9);
+    r->period_ns = period_ns;
+    pthread_mutex_init(&r->rb.mu, NULL);
+    pthread_cond_init(&r->rb.cv, NULL);
+    if (mode != MODE_LOCKED) {
+        r->slab = opus_packet_slab_create(NULL, BENCH_SLOT_COUNT, BENCH_SLOT_SIZE);
+        if (!r->slab) {
+            free(r);
+            return NULL;
+        }
+        opus_packet_slab_set_watermarks(r->slab, BENCH_SLOT_COUNT * 3 / 4, BENCH_SLOT_COUNT / 4, on_watermark, r);
+    }
+    pthread_t th[2];
+    pthread_create(&th[1], NULL, consumer, r);
+    pthread_create(&th[0], NULL, producer, r);
+    pthread_join(th[0], NULL);
+    pthread_join(th[1], NULL);
+    opus_packet_slab_destroy(r->slab);
+    return r;
+}
+
+/**
+ * @brief 每包拷贝统计；返回不符合预期（环形缓冲区至少2次、slab原地为0、兼容接口恰好1次）时为 true
+ */
+static bool print_copies(const bench_run_t *r)
+{
+    uint64_t calls = r->rb.copy.calls + r->copy.calls;
+    uint64_t bytes = r->rb.copy.bytes + r->copy.bytes;
+    double n = r->received ? (double)r->received : 1.0;
+    printf("  %-16s copies: %.2f memcpy/pkt, %.1f B/pkt, %.1f%% read in place\n", "", calls / n, bytes / n,
+           100.0 * r->in_place / n);
+    switch (r->mode) {
+    case MODE_LOCKED:
+        return calls < 2 * r->received || r->in_place != 0;
+    case MODE_SLAB:
+    case MODE_SLAB_BATCH:
+        return calls != 0 || r->in_place != r->received;
+    default:
+        return calls != r->received || bytes != r->received * BENCH_PKT_LEN;
+    }
+}
+
+static void print_run(const bench_run_t *r)
+{
+    char name[32];
+    snprintf(name, sizeof(name), r->mode == MODE_SLAB_BATCH ? "%s x%u" : "%s", s_mode_names[r->mode],
+             (unsigned)r->batch);
+    printf("  %-16s %10.0f %8.2f %8.2f %9.2f %9.2f %8.2f %9.2f %6llu %6llu\n", name,
+           r->received / (r->elapsed_ns / 1e9), hist_pct(&r->lat, 50) / 1000.0, hist_pct(&r->lat, 99) / 1000.0,
+           hist_pct(&r->lat, 99.9) / 1000.0, r->lat.max / 1000.0, hist_pct(&r->call, 99) / 1000.0,
+           r->call.max / 1000.0, (unsigned long long)r->errors, (unsigned long long)r->full);
+}
+
+static int run_phase(const char *title, double seconds, uint64_t period_ns, uint32_t batch)
+{
+    printf("\n%s\n", title);
+    printf("  %-16s %10s %8s %8s %9s %9s %8s %9s %6s %6s\n", "queue", "pkts/s", "lat p50", "p99", "p99.9",
+           "max(us)", "call p99", "max(us)", "errors", "full");
+    int errors = 0;
+    const bench_mode_t modes[] = {MODE_LOCKED, MODE_SLAB, MODE_SLAB_BATCH, MODE_SLAB_COMPAT};
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        bench_run_t *r = run_one(modes[i], batch, seconds, period_ns);
+        if (!r) {
+            fprintf(stderr, "out of memory\n");
+            return -1;
+        }
+        print_run(r);
+        if (r->errors || r->received != r->sent) {
+            errors++;
+        }
+        if (print_copies(r)) {
+            printf("  %-16s unexpected copy count\n", "");
+            errors++;
+        }
+        if (r->wm_high || r->wm_low) {
+            printf("  %-16s watermarks: %u high, %u low\n", "", r->wm_high, r->wm_low);
+        }
+        free(r);
+    }
+    return errors;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: ring_bench run [--seconds s] [--batch n] [--rate pkts/s]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 2;
+    }
+    double seconds = 2.0;
+    uint32_t batch = 8;
+    uint32_t rate = 20000;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--batch") && i + 1 < argc) {
+            batch = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--rate") && i + 1 < argc) {
+            rate = (uint32_t)atoi(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (seconds <= 0 || batch < 1 || batch > BENCH_MAX_BATCH || rate == 0) {
+        usage();
+        return 2;
+    }
+
+    printf("%u slots x %u B, %u B packets, %.1f s per run\n", BENCH_SLOT_COUNT, BENCH_SLOT_SIZE, BENCH_PKT_LEN,
+           seconds);
+    int errors = run_phase("saturated (producer sends as fast as possible):", seconds, 0, batch);
+    char title[64];
+    snprintf(title, sizeof(title), "paced (%u pkts/s):", (unsigned)rate);
+    errors += run_phase(title, seconds, 1000000000ull / rate, batch);
+    if (errors) {
+        printf("\n%d runs lost, duplicated or reordered packets or copied more than expected\n", errors);
+    }
+    return errors ? 1 : 0;
+}
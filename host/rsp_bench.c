@@ -0,0 +1,470 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端重采样基准：对比原线性插值 resample_audio()，检查多相重采样器的信噪比、阻带衰减、
+ *               块边界连续性、C/PIE点积逐位一致与每输入样点耗时，任一检查失败时返回非0
+ * @FilePath: \audio_manager\host\rsp_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "polyphase_resampler.h"
+#include "polyphase_resampler_coef.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#define BENCH_RATE_IN       44100
+#define BENCH_RATE_OUT      16000
+#define BENCH_LEGACY_BLOCK  1024                    // 原实现每次处理的样点数（同 DMA_BUF_LEN）
+#define BENCH_AMP           16000.0                 // 测试单音幅度（约-6dBFS）
+#define BENCH_SKIP          256                     // 统计时跳过的起始输出样点（滤波器建立）
+#define BENCH_SINAD_MIN     70.0                    // 通带单音 SINAD 下限（dB）
+#define BENCH_ALIAS_MAX     -60.0                   // 阻带单音折叠到输出的电平上限（dB，相对输入）
+#define BENCH_HIST          (POLYPHASE_RSP_TAPS - 1)
+
+static int s_failures;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline uint64_t now_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void check(bool ok, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "PASS" : "FAIL");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* 被比较的两种实现                                                    */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 原 main/audio_resample_test.c 中的线性插值重采样（逐字复制）
+ */
+static void resample_audio(int16_t *input, int16_t *output, int input_len, int output_len) {
+    float ratio = (float)input_len / output_len; // 输入/输出采样点比率
+    for (int i = 0; i < output_len; i++) {
+        float pos = i * ratio;                   // 对应输入的浮点位置
+        int pos_int = (int)pos;                  // 取整得到输入下标
+        float frac = pos - pos_int;              // 小数部分用于插值
+
+        // 边界处理：如果超出输入范围，直接取最后一个采样点
+        if (pos_int + 1 >= input_len) {
+            output[i] = input[input_len - 1];
+        } else {
+            // 线性插值：output = (1-frac)*input[pos_int] + frac*input[pos_int+1]
+            output[i] = (int16_t)(input[pos_int] * (1 - frac) + input[pos_int + 1] * frac);
+        }
+    }
+}
+
+/**
+ * @brief 按原任务的调用方式（每 DMA_BUF_LEN 个输入一块）运行线性插值
+ */
+static size_t run_legacy(int16_t *in, size_t n, int16_t *out)
+{
+    size_t produced = 0;
+    for (size_t off = 0; off + BENCH_LEGACY_BLOCK <= n; off += BENCH_LEGACY_BLOCK) {
+        int out_len = BENCH_LEGACY_BLOCK * BENCH_RATE_OUT / BENCH_RATE_IN;
+        resample_audio(&in[off], &out[produced], BENCH_LEGACY_BLOCK, out_len);
+        produced += out_len;
+    }
+    return produced;
+}
+
+static size_t run_polyphase(const int16_t *in, size_t n, int16_t *out)
+{
+    static polyphase_rsp_t rsp;
+    polyphase_rsp_reset(&rsp);
+    size_t produced = 0;
+    for (size_t off = 0; off < n; off += BENCH_LEGACY_BLOCK) {
+        size_t m = n - off < BENCH_LEGACY_BLOCK ? n - off : BENCH_LEGACY_BLOCK;
+        produced += polyphase_rsp_process(&rsp, &in[off], m, &out[produced]);
+    }
+    return produced;
+}
+
+/* ------------------------------------------------------------------ */
+/* 点积模型与逐位参考                                                  */
+/* ------------------------------------------------------------------ */
+
+typedef int32_t (*bench_dot_fn)(const int16_t *x, const int16_t *h);
+
+/**
+ * @brief 与 polyphase_resampler.c 中 rsp_dot_c 相同的32位累加
+ */
+static int32_t dot_c(const int16_t *x, const int16_t *h)
+{
+    int32_t acc = 0;
+    for (int i = 0; i < POLYPHASE_RSP_TAPS; i++) {
+        acc += (int32_t)x[i] * h[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief PIE点积模型：ee.vmulas.s16.accx 每次把8个乘积累加进40位 ACCX，最后取低32位
+ */
+static int32_t dot_pie_model(const int16_t *x, const int16_t *h)
+{
+    int64_t accx = 0;
+    for (int g = 0; g < POLYPHASE_RSP_TAPS; g += 8) {
+        for (int i = 0; i < 8; i++) {
+            accx += (int32_t)x[g + i] * h[g + i];
+        }
+        accx = (int64_t)((uint64_t)accx << 24) >> 24;   // 40位回绕
+    }
+    return (int32_t)(uint32_t)accx;
+}
+
+/**
+ * @brief 用指定点积对整段输入做一次性重采样（无分块），作为逐位参考
+ *
+ * 第 k 个输出的窗口末端为输入下标 floor(k*DOWN/UP)，相位为 (k*DOWN) mod UP，
+ * 与实现中从 end=TAPS-1、phase=0 开始逐步累加的状态一致；窗口左侧不足部分按0填充。
+ */
+static size_t run_reference(const int16_t *in, size_t n, int16_t *out, bench_dot_fn dot)
+{
+    int16_t *pad = calloc(n + BENCH_HIST, sizeof(int16_t));
+    memcpy(&pad[BENCH_HIST], in, n * sizeof(int16_t));
+    size_t produced = 0;
+    for (uint64_t k = 0;; k++) {
+        uint64_t pos = k * POLYPHASE_RSP_DOWN / POLYPHASE_RSP_UP;
+        uint32_t phase = (uint32_t)(k * POLYPHASE_RSP_DOWN % POLYPHASE_RSP_UP);
+        if (pos >= n) {
+            break;
+        }
+        int32_t acc = dot(&pad[pos], s_polyphase_coef[phase]);
+        int32_t v = (acc + (1 << 14)) >> 15;
+        out[produced++] = v > 32767 ? 32767 : (v < -32768 ? -32768 : (int16_t)v);
+    }
+    free(pad);
+    return produced;
+}
+
+/* ------------------------------------------------------------------ */
+/* 测试信号与测量                                                      */
+/* ------------------------------------------------------------------ */
+
+static void gen_tone(int16_t *x, size_t n, double freq, double amp)
+{
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (int16_t)lrint(amp * sin(2.0 * M_PI * freq * i / BENCH_RATE_IN));
+    }
+}
+
+static uint32_t rnd(uint32_t *seed)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 8;
+}
+
+/**
+ * @brief 对输出做 DC + 已知频率正弦的最小二乘拟合，返回 SINAD（dB）
+ */
+static double sinad_db(const int16_t *y, size_t n, double freq, double rate)
+{
+    double s[3][3] = {{0}}, b[3] = {0};
+    for (size_t i = 0; i < n; i++) {
+        double w = 2.0 * M_PI * freq * i / rate;
+        double v[3] = {cos(w), sin(w), 1.0};
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                s[r][c] += v[r] * v[c];
+            }
+            b[r] += v[r] * y[i];
+        }
+    }
+    // 3x3 高斯消元
+    for (int p = 0; p < 3; p++) {
+        for (int r = p + 1; r < 3; r++) {
+            double f = s[r][p] / s[p][p];
+            for (int c = p; c < 3; c++) {
+                s[r][c] -= f * s[p][c];
+            }
+            b[r] -= f * b[p];
+        }
+    }
+    double a[3];
+    for (int r = 2; r >= 0; r--) {
+        double acc = b[r];
+        for (int c = r + 1; c < 3; c++) {
+            acc -= s[r][c] * a[c];
+        }
+        a[r] = acc / s[r][r];
+    }
+    double sig = 0, err = 0;
+    for (size_t i = 0; i < n; i++) {
+        double w = 2.0 * M_PI * freq * i / rate;
+        double fit = a[0] * cos(w) + a[1] * sin(w);
+        double e = y[i] - fit - a[2];
+        sig += fit * fit;
+        err += e * e;
+    }
+    return 10.0 * log10(sig / (err > 1e-9 ? err : 1e-9));
+}
+
+static double level_db(const int16_t *y, size_t n, double amp)
+{
+    double e = 0;
+    for (size_t i = 0; i < n; i++) {
+        e += (double)y[i] * y[i];
+    }
+    double rms = sqrt(e / n);
+    return 20.0 * log10((rms > 1e-9 ? rms : 1e-9) / (amp / sqrt(2.0)));
+}
+
+/* ------------------------------------------------------------------ */
+/* 各项检查                                                            */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 通带信噪比与阻带折叠：原实现按块调用，块内比率 1024/371 与 44100/16000 不符，
+ *        其输出的实际采样率偏低约0.15%，因此对原实现按其实际输出率拟合（否则 SINAD 主要反映频偏）
+ */
+static void test_quality(void)
+{
+    const size_t n = BENCH_RATE_IN * 2;
+    int16_t *in = malloc(n * sizeof(int16_t));
+    int16_t *lin = malloc(n * sizeof(int16_t));
+    int16_t *poly = malloc(polyphase_rsp_max_output(n) * sizeof(int16_t));
+    const double legacy_rate = (double)(BENCH_LEGACY_BLOCK * BENCH_RATE_OUT / BENCH_RATE_IN)
+                               * BENCH_RATE_IN / BENCH_LEGACY_BLOCK;
+
+    printf("%-10s %12s %12s\n", "tone", "legacy", "polyphase");
+    static const double pass_hz[] = {1000, 3000, 6000};
+    for (size_t t = 0; t < sizeof(pass_hz) / sizeof(pass_hz[0]); t++) {
+        gen_tone(in, n, pass_hz[t], BENCH_AMP);
+        size_t nl = run_legacy(in, n, lin);
+        size_t np = run_polyphase(in, n, poly);
+        double sl = sinad_db(&lin[BENCH_SKIP], nl - BENCH_SKIP, pass_hz[t], legacy_rate);
+        double sp = sinad_db(&poly[BENCH_SKIP], np - BENCH_SKIP, pass_hz[t], BENCH_RATE_OUT);
+        printf("%-6.0fHz SINAD %6.1f dB  %6.1f dB\n", pass_hz[t], sl, sp);
+        check(sp >= BENCH_SINAD_MIN, "passband %.0fHz SINAD %.1f dB >= %.0f dB", pass_hz[t], sp, BENCH_SINAD_MIN);
+    }
+    static const double stop_hz[] = {9000, 10000, 12000, 15000, 20000};
+    for (size_t t = 0; t < sizeof(stop_hz) / sizeof(stop_hz[0]); t++) {
+        gen_tone(in, n, stop_hz[t], BENCH_AMP);
+        size_t nl = run_legacy(in, n, lin);
+        size_t np = run_polyphase(in, n, poly);
+        double ll = level_db(&lin[BENCH_SKIP], nl - BENCH_SKIP, BENCH_AMP);
+        double lp = level_db(&poly[BENCH_SKIP], np - BENCH_SKIP, BENCH_AMP);
+        printf("%-6.0fHz alias %6.1f dB  %6.1f dB\n", stop_hz[t], ll, lp);
+        check(lp <= BENCH_ALIAS_MAX, "stopband %.0fHz alias %.1f dB <= %.0f dB", stop_hz[t], lp, BENCH_ALIAS_MAX);
+    }
+    free(in);
+    free(lin);
+    free(poly);
+}
+
+/**
+ * @brief 块边界连续性：同一段信号一次送入与按随机长度（含1样点、跨 BLOCK 的长块）分块送入，
+ *        输出必须逐位相同，即小数相位与历史在块边界处无丢失
+ */
+static void test_blocks(void)
+{
+    const size_t n = BENCH_RATE_IN * 3;
+    int16_t *in = malloc(n * sizeof(int16_t));
+    size_t cap = polyphase_rsp_max_output(n) + 64;
+    int16_t *ref = malloc(cap * sizeof(int16_t));
+    int16_t *got = malloc(cap * sizeof(int16_t));
+    uint32_t seed = 1;
+    for (size_t i = 0; i < n; i++) {
+        double f = 200.0 + 7000.0 * i / n;  // 扫频
+        in[i] = (int16_t)lrint(12000.0 * sin(M_PI * f * i / BENCH_RATE_IN)) + (int16_t)(rnd(&seed) % 2001) - 1000;
+    }
+    static polyphase_rsp_t rsp;
+    polyphase_rsp_reset(&rsp);
+    size_t nr = polyphase_rsp_process(&rsp, in, n, ref);
+
+    bool same = true;
+    size_t first_diff = 0;
+    for (int trial = 0; trial < 8 && same; trial++) {
+        polyphase_rsp_reset(&rsp);
+        size_t ng = 0, off = 0;
+        while (off < n) {
+            uint32_t r = rnd(&seed);
+            size_t m = (r & 3) == 0 ? 1 + (r >> 4) % 4 : 1 + (r >> 4) % (2 * POLYPHASE_RSP_BLOCK + 100);
+            if (m > n - off) m = n - off;
+            ng += polyphase_rsp_process(&rsp, &in[off], m, &got[ng]);
+            off += m;
+        }
+        if (ng != nr) {
+            same = false;
+            first_diff = ng < nr ? ng : nr;
+            break;
+        }
+        for (size_t i = 0; i < nr; i++) {
+            if (got[i] != ref[i]) {
+                same = false;
+                first_diff = i;
+                break;
+            }
+        }
+    }
+    if (same) {
+        check(true, "block continuity: random block sizes bit-identical to one call (%zu samples, 8 trials)", nr);
+    } else {
+        check(false, "block continuity: first mismatch at output %zu", first_diff);
+    }
+    free(in);
+    free(ref);
+    free(got);
+}
+
+/**
+ * @brief C 与 PIE 点积逐位一致：
+ *        1) 每个相位 sum|h|*32768 < 2^31，则任意输入下32位部分和都不溢出，
+ *           C 的32位累加与 PIE 的40位 ACCX 低32位都等于精确点积；
+ *        2) 在最坏输入（每相位 x=±32768 与系数同号/反号对齐）、满幅随机与扫频上，
+ *           实现输出、C参考与 PIE 模型参考三者逐位相同
+ */
+static void test_exact(void)
+{
+    int64_t worst = 0;
+    int worst_phase = 0;
+    for (int p = 0; p < POLYPHASE_RSP_UP; p++) {
+        int64_t s = 0;
+        for (int i = 0; i < POLYPHASE_RSP_TAPS; i++) {
+            s += llabs(s_polyphase_coef[p][i]);
+        }
+        if (s > worst) {
+            worst = s;
+            worst_phase = p;
+        }
+    }
+    check(worst * 32768 < (1ll << 31), "no 32-bit overflow: max sum|h|*32768 = %lld (phase %d) < 2^31",
+          (long long)(worst * 32768), worst_phase);
+
+    const size_t n = BENCH_RATE_IN;
+    int16_t *in = malloc(n * sizeof(int16_t));
+    size_t cap = polyphase_rsp_max_output(n);
+    int16_t *impl = malloc(cap * sizeof(int16_t));
+    int16_t *ref_c = malloc(cap * sizeof(int16_t));
+    int16_t *ref_pie = malloc(cap * sizeof(int16_t));
+    uint32_t seed = 7;
+    bool ok = true;
+    for (int sig = 0; sig < 3 && ok; sig++) {
+        for (size_t i = 0; i < n; i++) {
+            if (sig == 0) {
+                // 最坏情况：满幅输入按最大相位系数的符号排列，窗口对齐时点积达到上界
+                in[i] = s_polyphase_coef[worst_phase][i % POLYPHASE_RSP_TAPS] >= 0 ? 32767 : -32768;
+            } else if (sig == 1) {
+                in[i] = (int16_t)(rnd(&seed) & 0xffff);
+            } else {
+                in[i] = (int16_t)lrint(32767.0 * sin(M_PI * (100.0 + 20000.0 * i / n) * i / BENCH_RATE_IN));
+            }
+        }
+        size_t ni = run_polyphase(in, n, impl);
+        size_t nc = run_reference(in, n, ref_c, dot_c);
+        size_t np = run_reference(in, n, ref_pie, dot_pie_model);
+        ok = ni == nc && nc == np &&
+             memcmp(impl, ref_c, ni * sizeof(int16_t)) == 0 &&
+             memcmp(ref_c, ref_pie, nc * sizeof(int16_t)) == 0;
+    }
+    check(ok, "C vs PIE: implementation, C dot and 40-bit ACCX model bit-identical (worst-case, full-scale noise, sweep)");
+    free(in);
+    free(impl);
+    free(ref_c);
+    free(ref_pie);
+}
+
+/**
+ * @brief 每输入样点耗时：两种实现按原任务的 1024 样点块处理相同的10秒信号
+ */
+static void test_speed(int repeat)
+{
+    const size_t n = BENCH_RATE_IN * 10;
+    int16_t *in = malloc(n * sizeof(int16_t));
+    int16_t *out = malloc(polyphase_rsp_max_output(n) * sizeof(int16_t));
+    uint32_t seed = 3;
+    for (size_t i = 0; i < n; i++) {
+        in[i] = (int16_t)(rnd(&seed) % 20001) - 10000;
+    }
+    uint64_t best_ns[2] = {UINT64_MAX, UINT64_MAX}, best_cyc[2] = {UINT64_MAX, UINT64_MAX};
+    volatile int16_t sink = 0;
+    for (int r = 0; r < repeat; r++) {
+        for (int k = 0; k < 2; k++) {
+            uint64_t t0 = now_ns(), c0 = now_cycles();
+            size_t m = k == 0 ? run_legacy(in, n, out) : run_polyphase(in, n, out);
+            uint64_t c1 = now_cycles(), t1 = now_ns();
+            sink ^= out[m / 2];
+            if (t1 - t0 < best_ns[k]) best_ns[k] = t1 - t0;
+            if (c1 - c0 < best_cyc[k]) best_cyc[k] = c1 - c0;
+        }
+    }
+    (void)sink;
+    printf("per input sample (best of %d):\n", repeat);
+    printf("  legacy     %6.2f ns  %6.2f cycles\n", (double)best_ns[0] / n, (double)best_cyc[0] / n);
+    printf("  polyphase  %6.2f ns  %6.2f cycles\n", (double)best_ns[1] / n, (double)best_cyc[1] / n);
+#ifndef BENCH_HAVE_TSC
+    printf("  (no TSC on this host, cycles not measured)\n");
+#endif
+    free(in);
+    free(out);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s run [--repeat N]\n"
+            "  对比 resample_audio() 与多相重采样器: 通带SINAD、阻带折叠、块边界连续性、\n"
+            "  C/PIE 点积逐位一致与每输入样点耗时; 有检查失败时退出码为1\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    int repeat = 5;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (repeat < 1) {
+        repeat = 1;
+    }
+    test_quality();
+    test_blocks();
+    test_exact();
+    test_speed(repeat);
+    printf("%s: %d check(s) failed\n", s_failures ? "FAIL" : "OK", s_failures);
+    return s_failures ? 1 : 0;
+}
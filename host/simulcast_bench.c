@@ -0,0 +1,354 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 主机端同播编码基准：1~3个编码层共用一个采集前端（处理图旁路节点按指针读同一块），
+ *               与每层各自采集、转换、重采样的独立实例对比每秒音频的CPU耗时
+ * @FilePath: \audio_manager\host\simulcast_bench.c
+ * 遇事不决，可问春风
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "capture_convert.h"
+#include "polyphase_resampler.h"
+#include "voice_activity.h"
+#include "opus_packet_slab.h"
+#include "audio_graph.h"
+#include "bench_signal.h"
+#ifdef HOST_HAVE_OPUS
+#include <opus.h>
+#endif
+
+#define BENCH_OUT_RATE      16000                   // 采集发布采样率（同 AUDIO_CAPTURE_SAMPLE_RATE）
+#define BENCH_BLOCK_MS      20                      // 采集块时长（同 AUDIO_CAPTURE_BLOCK_MS）
+#define BENCH_MAX_LAYERS    3                       // 同 OPUS_RECORDER_MAX_LAYERS
+#define BENCH_MAX_FRAME     (BENCH_OUT_RATE * 60 / 1000)
+#define BENCH_MAX_IN_BLOCK  (44100 * BENCH_BLOCK_MS / 1000 + 1)
+#define BENCH_SLOT_COUNT    16
+#define BENCH_SLOT_SIZE     512
+
+/**
+ * @brief 同播层（与示例中的典型配置一致：录制/云端高质量，受限客户端低码率长帧）
+ */
+typedef struct {
+    const char *name;
+    int bitrate;
+    int frame_ms;
+    int complexity;
+} bench_layer_cfg_t;
+
+static const bench_layer_cfg_t s_layer_cfgs[BENCH_MAX_LAYERS] = {
+    {"hq 32k/20ms", 32000, 20, 5},
+    {"mid 16k/20ms", 16000, 20, 3},
+    {"low 8k/40ms", 8000, 40, 1},
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------ */
+/* 编码层：凑帧 -> VAD -> 编码进slab -> 网络任务取走                   */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const bench_layer_cfg_t *cfg;
+    uint32_t encode_us;             // 无libopus时每20ms帧的编码耗时替身（忙等）
+    voice_activity_t *vad;
+    opus_packet_slab_t *slab;
+#ifdef HOST_HAVE_OPUS
+    OpusEncoder *enc;
+#endif
+    int16_t pcm[BENCH_MAX_FRAME];
+    uint32_t frame;                 // 帧长（样点）
+    uint32_t fill;
+    uint32_t packets;
+    uint64_t bytes;
+} bench_layer_t;
+
+static int layer_open(bench_layer_t *l, const bench_layer_cfg_t *cfg, uint32_t encode_us)
+{
+    memset(l, 0, sizeof(*l));
+    l->cfg = cfg;
+    l->encode_us = encode_us;
+    l->frame = BENCH_OUT_RATE * cfg->frame_ms / 1000;
+    voice_activity_cfg_t vad_cfg = DEFAULT_VOICE_ACTIVITY_CONFIG();
+    l->vad = voice_activity_create(&vad_cfg);
+    l->slab = opus_packet_slab_create(NULL, BENCH_SLOT_COUNT, BENCH_SLOT_SIZE);
+#ifdef HOST_HAVE_OPUS
+    int err = OPUS_OK;
+    l->enc = opus_encoder_create(BENCH_OUT_RATE, 1, OPUS_APPLICATION_VOIP, &err);
+    if (err != OPUS_OK) {
+        return -1;
+    }
+    opus_encoder_ctl(l->enc, OPUS_SET_BITRATE(cfg->bitrate));
+    opus_encoder_ctl(l->enc, OPUS_SET_COMPLEXITY(cfg->complexity));
+#endif
+    return l->vad && l->slab ? 0 : -1;
+}
+
+static void layer_close(bench_layer_t *l)
+{
+#ifdef HOST_HAVE_OPUS
+    opus_encoder_destroy(l->enc);
+#endif
+    voice_activity_destroy(l->vad);
+    opus_packet_slab_destroy(l->slab);
+}
+
+static void layer_encode(bench_layer_t *l)
+{
+    voice_activity_process(l->vad, l->pcm, l->frame);
+    opus_packet_t *pkt = opus_packet_slab_acquire_write(l->slab);
+    if (!pkt) {
+        return;
+    }
+#ifdef HOST_HAVE_OPUS
+    int n = opus_encode(l->enc, l->pcm, (int)l->frame, pkt->data, pkt->cap);
+#else
+    // 替身：按帧长等比忙等，输出按比特率计的字节数
+    uint64_t end = now_ns() + (uint64_t)l->encode_us * 1000 * l->cfg->frame_ms / 20;
+    while (now_ns() < end) {
+    }
+    int n = l->cfg->bitrate / 8 * l->cfg->frame_ms / 1000;
+#endif
+    if (n > 0) {
+        pkt->len = (uint16_t)n;
+        opus_packet_slab_commit(l->slab, pkt);
+    }
+    // 网络任务取走
+    const opus_packet_t *out[BENCH_SLOT_COUNT];
+    uint32_t got = opus_packet_slab_acquire_read_batch(l->slab, out, BENCH_SLOT_COUNT);
+    for (uint32_t i = 0; i < got; i++) {
+        l->packets++;
+        l->bytes += out[i]->len;
+    }
+    opus_packet_slab_release_batch(l->slab, got);
+}
+
+static size_t layer_feed(void *ctx, const void *in, size_t n, void *out)
+{
+    (void)out;
+    bench_layer_t *l = ctx;
+    const int16_t *p = in;
+    while (n > 0) {
+        size_t k = l->frame - l->fill;
+        if (k > n) {
+            k = n;
+        }
+        memcpy(l->pcm + l->fill, p, k * sizeof(int16_t));
+        l->fill += (uint32_t)k;
+        p += k;
+        n -= k;
+        if (l->fill == l->frame) {
+            layer_encode(l);
+            l->fill = 0;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 采集前端：24-in-32 -> 16位（去直流）-> [44.1k 时多相重采样到16k]    */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint32_t in_rate;
+    capture_conv_t cv;
+    polyphase_rsp_t rsp;
+    int16_t pcm[BENCH_MAX_IN_BLOCK];
+    int16_t out[BENCH_MAX_IN_BLOCK];
+} bench_front_t;
+
+static void front_init(bench_front_t *f, uint32_t in_rate)
+{
+    f->in_rate = in_rate;
+    capture_conv_init(&f->cv, NULL);
+    polyphase_rsp_reset(&f->rsp);
+}
+
+static size_t front_run(bench_front_t *f, const int32_t *raw, size_t n, const int16_t **out)
+{
+    capture_conv_s16(&f->cv, raw, f->pcm, n);
+    if (f->in_rate == BENCH_OUT_RATE) {
+        *out = f->pcm;
+        return n;
+    }
+    *out = f->out;
+    return polyphase_rsp_process(&f->rsp, f->pcm, n, f->out);
+}
+
+/* ------------------------------------------------------------------ */
+/* 两种组织方式                                                        */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    double front_us;                // 每秒音频的前端耗时
+    double total_us;                // 每秒音频的总耗时
+    uint32_t packets[BENCH_MAX_LAYERS];
+    uint64_t bytes[BENCH_MAX_LAYERS];
+} bench_result_t;
+
+/**
+ * @brief 共用前端：每块只做一次转换与重采样，处理图中各层为旁路节点读同一块
+ */
+static int run_shared(uint32_t in_rate, int layers, double seconds, uint32_t encode_us, bench_result_t *r)
+{
+    static bench_front_t front;
+    static bench_layer_t layer[BENCH_MAX_LAYERS];
+    static int32_t raw[BENCH_MAX_IN_BLOCK + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t)];
+    front_init(&front, in_rate);
+    audio_graph_cfg_t gcfg = DEFAULT_AUDIO_GRAPH_CONFIG();
+    audio_graph_t *g = audio_graph_create(&gcfg);
+    if (!g) {
+        return -1;
+    }
+    for (int i = 0; i < layers; i++) {
+        if (layer_open(&layer[i], &s_layer_cfgs[i], encode_us) != 0) {
+            return -1;
+        }
+        audio_graph_add_tap(g, s_layer_cfgs[i].name, layer_feed, &layer[i]);
+    }
+
+    size_t block = in_rate * BENCH_BLOCK_MS / 1000;
+    uint64_t total = (uint64_t)(seconds * in_rate);
+    bench_signal_t sig;
+    bench_signal_init(&sig, in_rate, 1500000.0, 0.3, 1);
+    uint64_t front_ns = 0;
+    uint64_t all_ns = 0;
+    while (sig.pos < total) {
+        bench_signal_read(&sig, raw, block);
+        uint64_t t0 = now_ns();
+        const int16_t *pcm;
+        size_t n = front_run(&front, raw, block, &pcm);
+        uint64_t t1 = now_ns();
+        audio_graph_run(g, pcm, n);
+        uint64_t t2 = now_ns();
+        front_ns += t1 - t0;
+        all_ns += t2 - t0;
+    }
+    r->front_us = front_ns / 1000.0 / seconds;
+    r->total_us = all_ns / 1000.0 / seconds;
+    for (int i = 0; i < layers; i++) {
+        r->packets[i] = layer[i].packets;
+        r->bytes[i] = layer[i].bytes;
+        layer_close(&layer[i]);
+    }
+    audio_graph_destroy(g);
+    return 0;
+}
+
+/**
+ * @brief 独立实例：每层各自一份采集前端（旧的单实例录制器复制多份时的做法）
+ */
+static int run_separate(uint32_t in_rate, int layers, double seconds, uint32_t encode_us, bench_result_t *r)
+{
+    static bench_front_t front[BENCH_MAX_LAYERS];
+    static bench_layer_t layer[BENCH_MAX_LAYERS];
+    static int32_t raw[BENCH_MAX_IN_BLOCK + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t)];
+    for (int i = 0; i < layers; i++) {
+        front_init(&front[i], in_rate);
+        if (layer_open(&layer[i], &s_layer_cfgs[i], encode_us) != 0) {
+            return -1;
+        }
+    }
+
+    size_t block = in_rate * BENCH_BLOCK_MS / 1000;
+    uint64_t total = (uint64_t)(seconds * in_rate);
+    bench_signal_t sig;
+    bench_signal_init(&sig, in_rate, 1500000.0, 0.3, 1);
+    uint64_t front_ns = 0;
+    uint64_t all_ns = 0;
+    while (sig.pos < total) {
+        bench_signal_read(&sig, raw, block);
+        for (int i = 0; i < layers; i++) {
+            uint64_t t0 = now_ns();
+            const int16_t *pcm;
+            size_t n = front_run(&front[i], raw, block, &pcm);
+            uint64_t t1 = now_ns();
+            layer_feed(&layer[i], pcm, n, NULL);
+            uint64_t t2 = now_ns();
+            front_ns += t1 - t0;
+            all_ns += t2 - t0;
+        }
+    }
+    r->front_us = front_ns / 1000.0 / seconds;
+    r->total_us = all_ns / 1000.0 / seconds;
+    for (int i = 0; i < layers; i++) {
+        r->packets[i] = layer[i].packets;
+        r->bytes[i] = layer[i].bytes;
+        layer_close(&layer[i]);
+    }
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: simulcast_bench run [seconds] [--in-rate hz] [--encode-us us]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || strcmp(argv[1], "run") != 0) {
+        usage();
+        return 1;
+    }
+    double seconds = 60.0;
+    uint32_t in_rate = BENCH_OUT_RATE;
+    uint32_t encode_us = 0;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--in-rate") && i + 1 < argc) {
+            in_rate = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--encode-us") && i + 1 < argc) {
+            encode_us = (uint32_t)atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            seconds = atof(argv[i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (seconds <= 0 || (in_rate != BENCH_OUT_RATE && in_rate != 44100)) {
+        usage();
+        return 1;
+    }
+
+#ifdef HOST_HAVE_OPUS
+    printf("capture %u Hz, %.0f s of audio, libopus encoders\n", (unsigned)in_rate, seconds);
+#else
+    printf("capture %u Hz, %.0f s of audio, encoder stand-in %u us per 20 ms frame (no libopus)\n",
+           (unsigned)in_rate, seconds, (unsigned)encode_us);
+#endif
+    printf("%-7s %-9s %12s %12s %8s   %s\n", "layers", "front end", "front us/s", "total us/s", "cpu %",
+           "packets / kbps per layer");
+    for (int layers = 1; layers <= BENCH_MAX_LAYERS; layers++) {
+        bench_result_t res[2];
+        memset(res, 0, sizeof(res));
+        if (run_shared(in_rate, layers, seconds, encode_us, &res[0]) != 0 ||
+            run_separate(in_rate, layers, seconds, encode_us, &res[1]) != 0) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        for (int m = 0; m < 2; m++) {
+            const bench_result_t *r = &res[m];
+            printf("%-7d %-9s %12.1f %12.1f %8.3f  ", layers, m ? "separate" : "shared", r->front_us, r->total_us,
+                   r->total_us / 1e4);
+            for (int i = 0; i < layers; i++) {
+                printf(" %u/%.1f", (unsigned)r->packets[i], r->bytes[i] * 8 / seconds / 1000.0);
+            }
+            printf("\n");
+        }
+        printf("%-7s shared saves %.1f%% of total\n", "", 100.0 * (1.0 - res[0].total_us / res[1].total_us));
+    }
+    return 0;
+}
@@ -0,0 +1,421 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 17:00:00
+ * @LastEditTime: 2026-10-16 17:00:00
+ * @LastEditors: 星年
+ * @Description: 分块频域自适应回声消除实现（重叠保留PBFDAF + 定点实FFT + 能量双讲检测）
+ * @FilePath: \audio_manager\main\aec_pbfdaf.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "aec_pbfdaf.h"
+#include "fixed_fft.h"
+
+#define AEC_N           AEC_PBFDAF_BLOCK        // 分块长度，也是复数FFT点数（实FFT长度2N）
+#define AEC_LOG2_N      6
+#define AEC_W_Q         24                      // 滤波器系数定点位数（频域为未归一化DFT）
+#define AEC_IN_SHIFT    10                      // 时域样点送入FFT前左移位数，保留定点精度
+#define AEC_OUT_SHIFT   (AEC_IN_SHIFT - 7)      // irfft结果为 样点*2^IN_SHIFT/(2N)
+#define AEC_DELTA       (1ull << 32)            // 归一化正则项，约对应 -60dBFS 的参考信号
+#define AEC_ERLE_MAX    (1u << 22)              // 双讲判据b使用的ERLE上限（约42dB）
+#define AEC_FAR_MIN     (AEC_N * 64 * 64)       // 参考能量低于此值（约-54dBFS）视为远端静音
+
+typedef fixed_fft_cpx_t aec_cpx_t;
+
+struct aec_pbfdaf {
+    aec_pbfdaf_cfg_t cfg;
+    uint32_t parts;                         // 分区数
+    aec_cpx_t *w;                           // 滤波器 [parts][BINS]
+    aec_cpx_t *x;                           // 参考频谱历史 [parts][BINS]，环形
+    int64_t *pden;                          // 参考功率谱平滑值 [BINS]
+    uint32_t xpos;                          // 最新参考频谱所在分区槽
+    uint32_t rr;                            // 下一个做梯度约束的分区（轮转）
+    uint32_t erl_q16;                       // 回声路径能量增益估计（麦克风/参考，Q16）
+    uint64_t ex_s;                          // 参考分块能量平滑值（覆盖回声尾长）
+    uint64_t ed_s;                          // 麦克风分块能量平滑值
+    uint32_t erle_q8;                       // 麦克风/残差 能量比的平滑值（线性，Q8）
+    int16_t ref_prev[AEC_N];                // 上一分块参考（重叠保留的前半）
+    int16_t in_mic[AEC_N];                  // 未满一块的输入
+    int16_t in_ref[AEC_N];
+    uint32_t in_fill;
+    int16_t *out;                           // 输出环形队列
+    uint32_t out_cap;
+    uint32_t out_head;
+    uint32_t out_count;
+    aec_cpx_t z[AEC_N];                     // FFT工作区
+    int32_t t[2 * AEC_N];                   // 时域工作区
+    aec_cpx_t spec[AEC_PBFDAF_BINS];        // 频域工作区
+    int32_t g[AEC_PBFDAF_BINS][2];          // 每频点归一化步长（实/虚）
+    int8_t gsh[AEC_PBFDAF_BINS];            // 每频点步长移位
+    aec_pbfdaf_stats_t stats;
+};
+
+/* ------------------------------------------------------------------ */
+/* 辅助                                                                */
+/* ------------------------------------------------------------------ */
+
+static inline int bits64(uint64_t v)
+{
+    return v ? 64 - __builtin_clzll(v) : 0;
+}
+
+static inline int32_t sat32(int64_t v)
+{
+    return v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : (int32_t)v);
+}
+
+static inline int16_t sat16(int32_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+/**
+ * @brief 10*log10(num/den) 的Q8近似（以log2的分段线性近似计算）
+ */
+static int16_t db_ratio_q8(uint64_t num, uint64_t den)
+{
+    if (!num || !den) {
+        return 0;
+    }
+    // log2(v) Q8：整数部分取最高位，小数部分取其后8位线性近似
+    int bn = bits64(num) - 1;
+    int bd = bits64(den) - 1;
+    int32_t ln = (bn << 8) + (int32_t)(bn >= 8 ? (num >> (bn - 8)) & 0xff : (num << (8 - bn)) & 0xff);
+    int32_t ld = (bd << 8) + (int32_t)(bd >= 8 ? (den >> (bd - 8)) & 0xff : (den << (8 - bd)) & 0xff);
+    // 10*log10(2) ≈ 3.0103 ≈ 771/256
+    return (int16_t)(((ln - ld) * 771) >> 8);
+}
+
+static inline aec_cpx_t *aec_part(aec_cpx_t *base, uint32_t p)
+{
+    return base + (size_t)p * AEC_PBFDAF_BINS;
+}
+
+/* ------------------------------------------------------------------ */
+/* 分块处理                                                            */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 计算各频点的归一化步长 g = mu * E / (parts * Pxx + delta)，以尾数+移位表示
+ */
+static void aec_step(aec_pbfdaf_t *a, const aec_cpx_t *E)
+{
+    for (int k = 0; k < AEC_PBFDAF_BINS; k++) {
+        uint64_t den = (uint64_t)a->pden[k] * a->parts + AEC_DELTA;
+        int ds = bits64(den) - 31;
+        if (ds < 0) {
+            ds = 0;
+        }
+        uint64_t inv = (1ull << 61) / (den >> ds);           // (2^30, 2^31]
+        int64_t rre = (((int64_t)E[k].re * (int64_t)inv) >> 15) * a->cfg.mu_q15;
+        int64_t rim = (((int64_t)E[k].im * (int64_t)inv) >> 15) * a->cfg.mu_q15;
+        uint64_t mag = (uint64_t)llabs(rre) | (uint64_t)llabs(rim);
+        int rs = bits64(mag) - 31;
+        if (rs < 0) {
+            rs = 0;
+        }
+        // W += (g * conj(X)) >> sh，推导见 aec_pbfdaf_block() 注释
+        int sh = 37 + ds - rs;
+        if (sh < 0) {
+            rs += -sh;
+            sh = 0;
+        }
+        if (sh > 62) {
+            sh = 62;
+        }
+        a->g[k][0] = (int32_t)(rre >> rs);
+        a->g[k][1] = (int32_t)(rim >> rs);
+        a->gsh[k] = (int8_t)sh;
+    }
+}
+
+/**
+ * @brief 对一个分区做梯度约束：时域后半置零，保证线性卷积
+ */
+static void aec_constrain(aec_pbfdaf_t *a, aec_cpx_t *w)
+{
+    fixed_fft_irfft(w, a->t, a->z, AEC_LOG2_N);      // t = h * 2^W_Q
+    for (int i = 0; i < AEC_N; i++) {
+        a->t[i] = sat32((int64_t)a->t[i] * 16);  // 提高精度后再做正变换，|h| < 8 时不饱和
+    }
+    memset(a->t + AEC_N, 0, AEC_N * sizeof(int32_t));
+    fixed_fft_rfft(a->t, w, a->z, AEC_LOG2_N);       // w = DFT(t) / 2N
+    for (int k = 0; k < AEC_PBFDAF_BINS; k++) {
+        w[k].re = sat32((int64_t)w[k].re * 8);
+        w[k].im = sat32((int64_t)w[k].im * 8);
+    }
+}
+
+/*
+ * 定标约定（2N=128）：
+ *   X = rfft(x << IN_SHIFT) = DFT(x) * 2^IN_SHIFT / 2N
+ *   W = DFT(h) * 2^W_Q（未归一化DFT）
+ *   Y = sum(X * W) >> W_Q，irfft(Y) = (x ⊛ h) * 2^IN_SHIFT / 2N，右移 OUT_SHIFT 得到回声估计
+ *   E 与 X 同定标，NLMS 更新 dW = mu * E * conj(X) / den * 2^W_Q 与定标无关
+ */
+static void aec_pbfdaf_block(aec_pbfdaf_t *a, const int16_t *mic, const int16_t *ref, int16_t *out)
+{
+    const uint32_t P = a->parts;
+    aec_cpx_t *spec = a->spec;
+
+    // 1. 参考频谱：重叠保留 [上一块, 本块]
+    for (int i = 0; i < AEC_N; i++) {
+        a->t[i] = (int32_t)a->ref_prev[i] * (1 << AEC_IN_SHIFT);   // 负数左移为未定义行为，用乘法
+        a->t[AEC_N + i] = (int32_t)ref[i] * (1 << AEC_IN_SHIFT);
+    }
+    memcpy(a->ref_prev, ref, sizeof(a->ref_prev));
+    a->xpos = (a->xpos + 1) % P;
+    fixed_fft_rfft(a->t, aec_part(a->x, a->xpos), a->z, AEC_LOG2_N);
+
+    // 2. 回声估计 Y = sum_p W[p] * X[k-p]
+    for (int k = 0; k < AEC_PBFDAF_BINS; k++) {
+        int64_t yre = 0, yim = 0;
+        uint32_t xp = a->xpos;
+        for (uint32_t p = 0; p < P; p++) {
+            const aec_cpx_t *w = aec_part(a->w, p) + k;
+            const aec_cpx_t *x = aec_part(a->x, xp) + k;
+            yre += (int64_t)w->re * x->re - (int64_t)w->im * x->im;
+            yim += (int64_t)w->re * x->im + (int64_t)w->im * x->re;
+            xp = xp ? xp - 1 : P - 1;
+        }
+        spec[k].re = sat32(yre >> AEC_W_Q);
+        spec[k].im = sat32(yim >> AEC_W_Q);
+    }
+    fixed_fft_irfft(spec, a->t, a->z, AEC_LOG2_N);
+
+    // 3. 误差与能量
+    uint64_t ed = 0, ee = 0, ex = 0;
+    int16_t e[AEC_N];
+    for (int i = 0; i < AEC_N; i++) {
+        int32_t y = (a->t[AEC_N + i] + (1 << (AEC_OUT_SHIFT - 1))) >> AEC_OUT_SHIFT;
+        e[i] = sat16(mic[i] - y);
+        ed += (int32_t)mic[i] * mic[i];
+        ee += (int32_t)e[i] * e[i];
+        ex += (int32_t)ref[i] * ref[i];
+    }
+    a->stats.blocks++;
+
+    // 4. 发散保护：滤波后能量明显大于原始麦克风时收缩滤波器，本块直接输出麦克风
+    if (ee > (ed << 2) && ed > AEC_FAR_MIN) {
+        for (size_t i = 0; i < (size_t)P * AEC_PBFDAF_BINS; i++) {
+            a->w[i].re >>= 1;
+            a->w[i].im >>= 1;
+        }
+        a->stats.divergence++;
+        memcpy(out, mic, AEC_N * sizeof(int16_t));
+        return;
+    }
+    memcpy(out, e, sizeof(e));
+
+    // 5. 双讲检测，两个判据任一成立即冻结更新：
+    //    a) 能量平滑到与回声尾长相当的时间尺度后，跟踪 麦克风/参考 比值的下包络作为回声路径增益
+    //       （快降慢升），麦克风能量超出 dt_ratio 倍预期回声；
+    //    b) 滤波器收敛后，残差能量超出 dt_ratio 倍按当前ERLE预期的残差（近端语音无法被消除）。
+    //       判为双讲期间ERLE缓慢回落，回声路径真实变化时仍能在约2秒内恢复更新
+    a->ex_s += ((int64_t)ex - (int64_t)a->ex_s) / 16;
+    a->ed_s += ((int64_t)ed - (int64_t)a->ed_s) / 16;
+    if (ex < AEC_FAR_MIN) {
+        return;
+    }
+    uint64_t r = (a->ed_s << 16) / (a->ex_s + 1);
+    if (r > UINT32_MAX) {
+        r = UINT32_MAX;
+    }
+    int64_t diff = (int64_t)r - a->erl_q16;
+    a->erl_q16 += diff < 0 ? diff / 8 : diff / 128;
+    uint64_t xref = ex > a->ex_s ? ex : a->ex_s;
+    if (ed > (((uint64_t)a->erl_q16 * a->cfg.dt_ratio * xref) >> 16) ||
+        ee * a->erle_q8 > ((ed * a->cfg.dt_ratio) << 8)) {
+        a->erle_q8 -= a->erle_q8 >> 6;
+        if (a->erle_q8 < (1 << 8)) {
+            a->erle_q8 = 1 << 8;
+        }
+        a->stats.doubletalk_blocks++;
+        return;
+    }
+    uint64_t g = (ed << 8) / (ee + 1);
+    if (g > AEC_ERLE_MAX) {
+        g = AEC_ERLE_MAX;
+    }
+    a->erle_q8 += ((int64_t)g - (int64_t)a->erle_q8) / 16;
+    int16_t erle = db_ratio_q8(ed, ee + 1);
+    a->stats.erle_q8 = (int16_t)(a->stats.erle_q8 + ((erle - a->stats.erle_q8) >> 3));
+
+    // 6. 误差频谱与参考功率谱
+    memset(a->t, 0, AEC_N * sizeof(int32_t));
+    for (int i = 0; i < AEC_N; i++) {
+        a->t[AEC_N + i] = (int32_t)e[i] * (1 << AEC_IN_SHIFT);
+    }
+    fixed_fft_rfft(a->t, spec, a->z, AEC_LOG2_N);
+    const aec_cpx_t *xn = aec_part(a->x, a->xpos);
+    for (int k = 0; k < AEC_PBFDAF_BINS; k++) {
+        int64_t pw = (int64_t)xn[k].re * xn[k].re + (int64_t)xn[k].im * xn[k].im;
+        a->pden[k] += (pw - a->pden[k]) >> 3;
+    }
+    aec_step(a, spec);
+
+    // 7. 更新全部分区：W[p] += g * conj(X[k-p])
+    uint32_t xp = a->xpos;
+    for (uint32_t p = 0; p < P; p++) {
+        aec_cpx_t *w = aec_part(a->w, p);
+        const aec_cpx_t *x = aec_part(a->x, xp);
+        for (int k = 0; k < AEC_PBFDAF_BINS; k++) {
+            int64_t gre = a->g[k][0], gim = a->g[k][1];
+            int64_t ure = gre * x[k].re + gim * x[k].im;
+            int64_t uim = gim * x[k].re - gre * x[k].im;
+            w[k].re = sat32((int64_t)w[k].re + (ure >> a->gsh[k]));
+            w[k].im = sat32((int64_t)w[k].im + (uim >> a->gsh[k]));
+        }
+        xp = xp ? xp - 1 : P - 1;
+    }
+
+    // 8. 每块只约束一个分区（轮转），约束代价从 2P 次FFT降为 2 次
+    aec_constrain(a, aec_part(a->w, a->rr));
+    a->rr = (a->rr + 1) % P;
+    a->stats.adapt_blocks++;
+}
+
+/* ------------------------------------------------------------------ */
+/* 对外接口                                                            */
+/* ------------------------------------------------------------------ */
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b)
+{
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief 校验配置并返回分区数，非法返回0
+ */
+static uint32_t aec_parts(const aec_pbfdaf_cfg_t *cfg)
+{
+    if (!cfg || cfg->sample_rate == 0 || cfg->frame_samples == 0 || cfg->mu_q15 == 0 || cfg->dt_ratio == 0) {
+        return 0;
+    }
+    uint32_t tail = (uint32_t)((uint64_t)cfg->tail_ms * cfg->sample_rate / 1000);
+    uint32_t parts = (tail + AEC_N - 1) / AEC_N;
+    return parts > AEC_PBFDAF_MAX_PARTS ? 0 : parts;
+}
+
+uint32_t aec_pbfdaf_mem_size(const aec_pbfdaf_cfg_t *cfg)
+{
+    uint32_t parts = aec_parts(cfg);
+    if (parts == 0) {
+        return 0;
+    }
+    uint32_t out_cap = cfg->frame_samples + 2 * AEC_N;
+    return AUDIO_ARENA_SIZE(sizeof(aec_pbfdaf_t)) + 2 * AUDIO_ARENA_SIZE(parts * AEC_PBFDAF_BINS * sizeof(aec_cpx_t)) +
+           AUDIO_ARENA_SIZE(AEC_PBFDAF_BINS * sizeof(int64_t)) + AUDIO_ARENA_SIZE(out_cap * sizeof(int16_t));
+}
+
+aec_pbfdaf_t *aec_pbfdaf_create(const aec_pbfdaf_cfg_t *cfg)
+{
+    uint32_t parts = aec_parts(cfg);
+    if (parts == 0) {
+        return NULL;
+    }
+    // 滤波器与参考频谱每块全量遍历，全部放片内
+    aec_pbfdaf_t *a = audio_arena_calloc(cfg->arena, 1, sizeof(aec_pbfdaf_t), AUDIO_ARENA_INTERNAL);
+    if (!a) {
+        return NULL;
+    }
+    a->cfg = *cfg;
+    a->parts = parts;
+    a->out_cap = cfg->frame_samples + 2 * AEC_N;
+    a->w = audio_arena_calloc(cfg->arena, (size_t)parts * AEC_PBFDAF_BINS, sizeof(aec_cpx_t), AUDIO_ARENA_INTERNAL);
+    a->x = audio_arena_calloc(cfg->arena, (size_t)parts * AEC_PBFDAF_BINS, sizeof(aec_cpx_t), AUDIO_ARENA_INTERNAL);
+    a->pden = audio_arena_calloc(cfg->arena, AEC_PBFDAF_BINS, sizeof(int64_t), AUDIO_ARENA_INTERNAL);
+    a->out = audio_arena_calloc(cfg->arena, a->out_cap, sizeof(int16_t), AUDIO_ARENA_INTERNAL);
+    if (!a->w || !a->x || !a->pden || !a->out) {
+        aec_pbfdaf_destroy(a);
+        return NULL;
+    }
+    // 帧长不是分块整数倍时，输出队列预置 N-gcd(帧长,N) 个静音样点，保证每次调用都有足够输出
+    a->stats.delay_samples = (cfg->frame_samples % AEC_N) ? AEC_N - gcd_u32(cfg->frame_samples, AEC_N) : 0;
+    a->stats.mem_bytes = aec_pbfdaf_mem_size(cfg);
+    aec_pbfdaf_reset(a);
+    return a;
+}
+
+void aec_pbfdaf_destroy(aec_pbfdaf_t *aec)
+{
+    if (!aec) {
+        return;
+    }
+    audio_arena_t *arena = aec->cfg.arena;
+    audio_arena_free(arena, aec->w);
+    audio_arena_free(arena, aec->x);
+    audio_arena_free(arena, aec->pden);
+    audio_arena_free(arena, aec->out);
+    audio_arena_free(arena, aec);
+}
+
+void aec_pbfdaf_reset(aec_pbfdaf_t *aec)
+{
+    memset(aec->w, 0, (size_t)aec->parts * AEC_PBFDAF_BINS * sizeof(aec_cpx_t));
+    memset(aec->x, 0, (size_t)aec->parts * AEC_PBFDAF_BINS * sizeof(aec_cpx_t));
+    memset(aec->pden, 0, AEC_PBFDAF_BINS * sizeof(int64_t));
+    memset(aec->ref_prev, 0, sizeof(aec->ref_prev));
+    aec->xpos = 0;
+    aec->rr = 0;
+    aec->erl_q16 = 1 << 16;
+    aec->ex_s = 0;
+    aec->ed_s = 0;
+    aec->erle_q8 = 1 << 8;
+    aec->in_fill = 0;
+    aec->out_head = 0;
+    aec->out_count = aec->stats.delay_samples;
+    memset(aec->out, 0, aec->out_cap * sizeof(int16_t));
+    uint16_t delay = aec->stats.delay_samples;
+    uint32_t mem = aec->stats.mem_bytes;
+    memset(&aec->stats, 0, sizeof(aec->stats));
+    aec->stats.delay_samples = delay;
+    aec->stats.mem_bytes = mem;
+}
+
+int aec_pbfdaf_process(aec_pbfdaf_t *aec, const int16_t *mic, const int16_t *ref, int16_t *out, size_t n)
+{
+    if (n != aec->cfg.frame_samples) {
+        return -1;
+    }
+    // 先把整帧输入收入分块缓冲再写输出，允许 out 与 mic 为同一缓冲区
+    size_t i = 0;
+    int16_t blk[AEC_N];
+    while (i < n) {
+        size_t m = AEC_N - aec->in_fill;
+        if (m > n - i) {
+            m = n - i;
+        }
+        memcpy(aec->in_mic + aec->in_fill, mic + i, m * sizeof(int16_t));
+        memcpy(aec->in_ref + aec->in_fill, ref + i, m * sizeof(int16_t));
+        aec->in_fill += m;
+        i += m;
+        if (aec->in_fill == AEC_N) {
+            aec_pbfdaf_block(aec, aec->in_mic, aec->in_ref, blk);
+            aec->in_fill = 0;
+            uint32_t tail = (aec->out_head + aec->out_count) % aec->out_cap;
+            for (int k = 0; k < AEC_N; k++) {
+                aec->out[tail] = blk[k];
+                tail = tail + 1 == aec->out_cap ? 0 : tail + 1;
+            }
+            aec->out_count += AEC_N;
+        }
+    }
+    for (size_t k = 0; k < n; k++) {
+        out[k] = aec->out[aec->out_head];
+        aec->out_head = aec->out_head + 1 == aec->out_cap ? 0 : aec->out_head + 1;
+    }
+    aec->out_count -= n;
+    return 0;
+}
+
+void aec_pbfdaf_get_stats(const aec_pbfdaf_t *aec, aec_pbfdaf_stats_t *stats)
+{
+    *stats = aec->stats;
+}
@@ -0,0 +1,107 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 17:00:00
+ * @LastEditTime: 2026-10-16 17:00:00
+ * @LastEditors: 星年
+ * @Description: 回声消除：分块频域自适应滤波（PBFDAF，重叠保留），定点FFT，纯C实现，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\aec_pbfdaf.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AEC_PBFDAF_BLOCK        64                      // 分块长度（样点），FFT长度为其2倍
+#define AEC_PBFDAF_BINS         (AEC_PBFDAF_BLOCK + 1)  // 实FFT的有效频点数
+#define AEC_PBFDAF_MAX_PARTS    32                      // 最大分区数（16kHz下128ms回声尾长）
+
+/**
+ * @brief 回声消除配置
+ */
+typedef struct {
+    uint32_t sample_rate;       // 采样率（仅用于换算尾长）
+    uint32_t frame_samples;     // 每次调用处理的样点数（固定），决定内部对齐延迟
+    uint16_t tail_ms;           // 回声尾长，向上取整到分块长度
+    uint16_t mu_q15;            // 步长（Q15），越大收敛越快、稳态失调越大
+    uint8_t dt_ratio;           // 双讲判定：麦克风能量超过 回声估计路径增益*参考能量 的倍数
+    audio_arena_t *arena;       // 内存区，NULL 时从堆分配
+} aec_pbfdaf_cfg_t;
+
+#define DEFAULT_AEC_PBFDAF_CONFIG() {   \
+    .sample_rate   = 16000,             \
+    .frame_samples = 320,               \
+    .tail_ms       = 64,                \
+    .mu_q15        = 16384,             \
+    .dt_ratio      = 8,                 \
+    .arena         = NULL,              \
+}
+
+/**
+ * @brief 回声消除统计
+ */
+typedef struct {
+    uint32_t blocks;            // 已处理分块数
+    uint32_t adapt_blocks;      // 进行了滤波器更新的分块数
+    uint32_t doubletalk_blocks; // 判为双讲而冻结更新的分块数
+    uint32_t divergence;        // 检测到发散并收缩滤波器的次数
+    int16_t erle_q8;            // 最近的回声回波损耗增强（dB，Q8），仅在远端有声时更新
+    uint16_t delay_samples;     // 内部对齐引入的固定延迟（样点）
+    uint32_t mem_bytes;         // 占用内存（同 aec_pbfdaf_mem_size()）
+} aec_pbfdaf_stats_t;
+
+typedef struct aec_pbfdaf aec_pbfdaf_t;
+
+/**
+ * @brief 创建回声消除器，所有缓冲区一次性分配
+ *
+ * @param cfg 配置
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+aec_pbfdaf_t *aec_pbfdaf_create(const aec_pbfdaf_cfg_t *cfg);
+
+/**
+ * @brief 按配置计算所需内存（按内存区对齐取整），用于预留内存区
+ *
+ * @return 字节数，配置非法返回0
+ */
+uint32_t aec_pbfdaf_mem_size(const aec_pbfdaf_cfg_t *cfg);
+
+/**
+ * @brief 销毁回声消除器
+ */
+void aec_pbfdaf_destroy(aec_pbfdaf_t *aec);
+
+/**
+ * @brief 清空滤波器与历史，重新收敛
+ */
+void aec_pbfdaf_reset(aec_pbfdaf_t *aec);
+
+/**
+ * @brief 处理一帧：从麦克风信号中减去参考信号经回声路径后的估计
+ *
+ * mic 与 ref 须按采样时刻对齐（ref 为同一时刻扬声器输出的样点）。
+ * 帧长不是分块长度整数倍时，输出相对输入固定延迟 delay_samples 个样点。
+ *
+ * @param aec 句柄
+ * @param mic 麦克风样点
+ * @param ref 参考样点
+ * @param out 输出样点（可与 mic 相同）
+ * @param n   样点数，须等于 cfg.frame_samples
+ * @return 0，帧长不符返回-1
+ */
+int aec_pbfdaf_process(aec_pbfdaf_t *aec, const int16_t *mic, const int16_t *ref, int16_t *out, size_t n);
+
+/**
+ * @brief 获取统计
+ */
+void aec_pbfdaf_get_stats(const aec_pbfdaf_t *aec, aec_pbfdaf_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,102 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 17:00:00
+ * @LastEditTime: 2026-10-16 17:00:00
+ * @LastEditors: 星年
+ * @Description: 回声消除接入实现：全双工节拍回调中运行PBFDAF，原地替换麦克风样点
+ * @FilePath: \audio_manager\main\audio_aec.c
+ * 遇事不决，可问春风
+ */
+#include "esp_log.h"
+#include "audio_probe.h"
+#include "audio_duplex.h"
+#include "audio_aec.h"
+
+static const char *TAG = "AUDIO_AEC";
+
+static aec_pbfdaf_t *s_aec = NULL;
+static audio_arena_t *s_arena = NULL;       // 回声消除内存区（按尾长预留，停止后回卷复用）
+static audio_probe_t *s_probe = NULL;
+
+/**
+ * @brief 节拍回调：mic 与 ref 已由引擎按采样时刻对齐
+ */
+static void audio_aec_tap(int16_t *mic, const int16_t *ref, size_t samples, uint32_t timestamp, void *ctx)
+{
+    (void)timestamp;
+    uint32_t stamp = audio_probe_begin(s_probe, NULL);
+    if (aec_pbfdaf_process((aec_pbfdaf_t *)ctx, mic, ref, mic, samples) != 0) {
+        audio_probe_error(s_probe);
+    }
+    audio_probe_end(s_probe, stamp);
+}
+
+esp_err_t audio_aec_start(const aec_pbfdaf_cfg_t *cfg)
+{
+    audio_duplex_stats_t ds;
+    if (s_aec || audio_duplex_get_stats(&ds) != ESP_OK) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    aec_pbfdaf_cfg_t c = DEFAULT_AEC_PBFDAF_CONFIG();
+    if (cfg) {
+        c = *cfg;
+    }
+    c.sample_rate = AUDIO_DUPLEX_SAMPLE_RATE;
+    c.frame_samples = ds.block_samples;
+    // 滤波器与参考频谱每块全量遍历，按配置精确预留片内SRAM
+    audio_arena_cfg_t arena_cfg = {
+        .name = "aec",
+        .internal_bytes = aec_pbfdaf_mem_size(&c),
+        .psram_bytes = 0,
+    };
+    if (arena_cfg.internal_bytes == 0 || audio_arena_ensure(&s_arena, &arena_cfg) != 0) {
+        ESP_LOGE(TAG, "arena reserve failed (tail %u ms)", c.tail_ms);
+        return ESP_ERR_NO_MEM;
+    }
+    audio_arena_set_owner(s_arena, "aec");
+    c.arena = s_arena;
+    s_aec = aec_pbfdaf_create(&c);
+    if (!s_aec) {
+        ESP_LOGE(TAG, "create failed (tail %u ms)", c.tail_ms);
+        return ESP_ERR_NO_MEM;
+    }
+    s_probe = audio_probe_get("aec");
+    if (audio_duplex_set_tap(audio_aec_tap, s_aec) != ESP_OK) {
+        aec_pbfdaf_destroy(s_aec);
+        s_aec = NULL;
+        audio_arena_reset(s_arena);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    aec_pbfdaf_stats_t st;
+    aec_pbfdaf_get_stats(s_aec, &st);
+    ESP_LOGI(TAG, "aec started: tail %u ms, frame %u, delay %u samples, %u bytes",
+             c.tail_ms, (unsigned)c.frame_samples, st.delay_samples, (unsigned)st.mem_bytes);
+    return ESP_OK;
+}
+
+void audio_aec_stop(void)
+{
+    aec_pbfdaf_t *aec = s_aec;
+    if (!aec) {
+        return;
+    }
+    // 返回时节拍任务已越过节拍边界（或引擎已停止），不会再进入回调，滤波器可以释放
+    audio_duplex_set_tap(NULL, NULL);
+    s_aec = NULL;
+    aec_pbfdaf_destroy(aec);
+    audio_arena_reset(s_arena);
+    ESP_LOGI(TAG, "aec stopped");
+}
+
+esp_err_t audio_aec_get_stats(aec_pbfdaf_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_aec) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    aec_pbfdaf_get_stats(s_aec, stats);
+    return ESP_OK;
+}
@@ -0,0 +1,44 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 17:00:00
+ * @LastEditTime: 2026-10-16 17:00:00
+ * @LastEditors: 星年
+ * @Description: 回声消除接入：挂在全双工引擎节拍回调上，用样点对齐的播放参考消除麦克风中的回声
+ * @FilePath: \audio_manager\main\audio_aec.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include "esp_err.h"
+#include "aec_pbfdaf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 启动回声消除
+ *
+ * 需在全双工引擎启动后调用。帧长取引擎节拍长度，处理在节拍任务内原地完成，
+ * 所有采集订阅者（录音、监听等）拿到的都是消除回声后的数据。
+ *
+ * @param cfg 配置，NULL使用 DEFAULT_AEC_PBFDAF_CONFIG()（frame_samples 与 sample_rate 由引擎决定）
+ * @return ESP_OK；引擎未运行或已启动返回 ESP_ERR_INVALID_STATE；内存不足返回 ESP_ERR_NO_MEM
+ */
+esp_err_t audio_aec_start(const aec_pbfdaf_cfg_t *cfg);
+
+/**
+ * @brief 停止回声消除（须在停止全双工引擎之前调用）
+ */
+void audio_aec_stop(void);
+
+/**
+ * @brief 获取回声消除统计
+ *
+ * @return ESP_OK，未启动返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t audio_aec_get_stats(aec_pbfdaf_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,279 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 21:00:00
+ * @LastEditTime: 2026-10-16 21:00:00
+ * @LastEditors: 星年
+ * @Description: 音频内存区实现：预留一次、顺序切分、整体回卷，全局登记供统计
+ * @FilePath: \audio_manager\main\audio_arena.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#ifdef ESP_PLATFORM
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#endif
+#include "audio_arena.h"
+
+struct audio_arena {
+    const char *name;
+    uint8_t *base[AUDIO_ARENA_PLACE_MAX];       // 预留的内存
+    uint32_t budget[AUDIO_ARENA_PLACE_MAX];     // 预留量
+    uint32_t used[AUDIO_ARENA_PLACE_MAX];       // 已切分量
+    uint32_t peak[AUDIO_ARENA_PLACE_MAX];       // 已切分量峰值
+    uint32_t failures;                          // 超出预算次数
+    bool psram_fallback;                        // PSRAM预算位于片内SRAM
+    audio_arena_owner_stats_t *cur;             // 当前记账的元素
+    uint32_t owner_count;
+    audio_arena_owner_stats_t owners[AUDIO_ARENA_MAX_OWNERS];
+};
+
+static _Atomic(audio_arena_t *) s_arenas[AUDIO_ARENA_MAX_ARENAS];
+
+static size_t audio_arena_round(size_t n)
+{
+    return AUDIO_ARENA_SIZE(n);
+}
+
+#ifdef ESP_PLATFORM
+static uint32_t audio_arena_caps(audio_arena_place_t place)
+{
+    return place == AUDIO_ARENA_PSRAM ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+#endif
+
+/**
+ * @brief 预留一块内存；PSRAM不可用时退回片内SRAM并置 fallback
+ */
+static void *audio_arena_reserve(size_t n, audio_arena_place_t place, bool *fallback)
+{
+#ifdef ESP_PLATFORM
+    void *p = heap_caps_aligned_alloc(AUDIO_ARENA_ALIGN, n, audio_arena_caps(place));
+    if (!p && place == AUDIO_ARENA_PSRAM) {
+        *fallback = true;
+        p = heap_caps_aligned_alloc(AUDIO_ARENA_ALIGN, n, audio_arena_caps(AUDIO_ARENA_INTERNAL));
+    }
+    return p;
+#else
+    (void)place;
+    (void)fallback;
+    return aligned_alloc(AUDIO_ARENA_ALIGN, n);
+#endif
+}
+
+static void audio_arena_release(void *p)
+{
+#ifdef ESP_PLATFORM
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+audio_arena_t *audio_arena_create(const audio_arena_cfg_t *cfg)
+{
+    if (!cfg) {
+        return NULL;
+    }
+    audio_arena_t *arena = calloc(1, sizeof(audio_arena_t));
+    if (!arena) {
+        return NULL;
+    }
+    arena->name = cfg->name;
+    arena->budget[AUDIO_ARENA_INTERNAL] = (uint32_t)audio_arena_round(cfg->internal_bytes);
+    arena->budget[AUDIO_ARENA_PSRAM] = (uint32_t)audio_arena_round(cfg->psram_bytes);
+    for (int p = 0; p < AUDIO_ARENA_PLACE_MAX; p++) {
+        if (arena->budget[p] == 0) {
+            continue;
+        }
+        arena->base[p] = audio_arena_reserve(arena->budget[p], (audio_arena_place_t)p, &arena->psram_fallback);
+        if (!arena->base[p]) {
+            audio_arena_destroy(arena);
+            return NULL;
+        }
+    }
+    for (int i = 0; i < AUDIO_ARENA_MAX_ARENAS; i++) {
+        audio_arena_t *empty = NULL;
+        if (atomic_compare_exchange_strong(&s_arenas[i], &empty, arena)) {
+            break;
+        }
+    }
+    return arena;
+}
+
+void audio_arena_destroy(audio_arena_t *arena)
+{
+    if (!arena) {
+        return;
+    }
+    for (int i = 0; i < AUDIO_ARENA_MAX_ARENAS; i++) {
+        audio_arena_t *self = arena;
+        atomic_compare_exchange_strong(&s_arenas[i], &self, NULL);
+    }
+    for (int p = 0; p < AUDIO_ARENA_PLACE_MAX; p++) {
+        audio_arena_release(arena->base[p]);
+    }
+    free(arena);
+}
+
+int audio_arena_ensure(audio_arena_t **arena, const audio_arena_cfg_t *cfg)
+{
+    audio_arena_t *a = *arena;
+    if (a && a->budget[AUDIO_ARENA_INTERNAL] >= audio_arena_round(cfg->internal_bytes) &&
+        a->budget[AUDIO_ARENA_PSRAM] >= audio_arena_round(cfg->psram_bytes)) {
+        audio_arena_reset(a);
+        return 0;
+    }
+    audio_arena_destroy(a);
+    *arena = audio_arena_create(cfg);
+    return *arena ? 0 : -1;
+}
+
+void audio_arena_set_owner(audio_arena_t *arena, const char *owner)
+{
+    if (!arena) {
+        return;
+    }
+    arena->cur = NULL;
+    if (!owner) {
+        return;
+    }
+    for (uint32_t i = 0; i < arena->owner_count; i++) {
+        if (strcmp(arena->owners[i].owner, owner) == 0) {
+            arena->cur = &arena->owners[i];
+            return;
+        }
+    }
+    // 表满时只计入内存区总量
+    if (arena->owner_count < AUDIO_ARENA_MAX_OWNERS) {
+        arena->cur = &arena->owners[arena->owner_count++];
+        arena->cur->owner = owner;
+    }
+}
+
+void *audio_arena_calloc(audio_arena_t *arena, size_t n, size_t size, audio_arena_place_t place)
+{
+    if (size && n > SIZE_MAX / size) {
+        return NULL;
+    }
+    if (!arena) {
+#ifdef ESP_PLATFORM
+        void *p = heap_caps_calloc(n, size, audio_arena_caps(place));
+        return p ? p : heap_caps_calloc(n, size, MALLOC_CAP_DEFAULT);
+#else
+        (void)place;
+        return calloc(n, size);
+#endif
+    }
+    size_t bytes = audio_arena_round(n * size);
+    if (bytes > arena->budget[place] - arena->used[place]) {
+        arena->failures++;
+        return NULL;
+    }
+    uint8_t *p = arena->base[place] + arena->used[place];
+    arena->used[place] += (uint32_t)bytes;
+    if (arena->used[place] > arena->peak[place]) {
+        arena->peak[place] = arena->used[place];
+    }
+    audio_arena_owner_stats_t *o = arena->cur;
+    if (o) {
+        o->used[place] += (uint32_t)bytes;
+        if (o->used[place] > o->peak[place]) {
+            o->peak[place] = o->used[place];
+        }
+        o->allocs++;
+    }
+    memset(p, 0, bytes);
+    return p;
+}
+
+void audio_arena_free(audio_arena_t *arena, void *p)
+{
+    if (!arena) {
+        free(p);
+    }
+}
+
+void audio_arena_reset(audio_arena_t *arena)
+{
+    if (!arena) {
+        return;
+    }
+    for (int p = 0; p < AUDIO_ARENA_PLACE_MAX; p++) {
+        arena->used[p] = 0;
+    }
+    for (uint32_t i = 0; i < arena->owner_count; i++) {
+        memset(arena->owners[i].used, 0, sizeof(arena->owners[i].used));
+        arena->owners[i].allocs = 0;
+    }
+    arena->cur = NULL;
+}
+
+bool audio_arena_has_psram(const audio_arena_t *arena)
+{
+#ifdef ESP_PLATFORM
+    return arena && arena->base[AUDIO_ARENA_PSRAM] && !arena->psram_fallback;
+#else
+    (void)arena;
+    return false;
+#endif
+}
+
+void audio_arena_get_stats(const audio_arena_t *arena, audio_arena_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (!arena) {
+        return;
+    }
+    stats->name = arena->name;
+    memcpy(stats->budget, arena->budget, sizeof(stats->budget));
+    memcpy(stats->used, arena->used, sizeof(stats->used));
+    memcpy(stats->peak, arena->peak, sizeof(stats->peak));
+    stats->failures = arena->failures;
+    stats->owners = arena->owner_count;
+    stats->psram_fallback = arena->psram_fallback;
+}
+
+int audio_arena_get_owner(const audio_arena_t *arena, uint32_t index, audio_arena_owner_stats_t *stats)
+{
+    if (!arena || index >= arena->owner_count) {
+        return -1;
+    }
+    *stats = arena->owners[index];
+    return 0;
+}
+
+audio_arena_t *audio_arena_get(uint32_t index)
+{
+    return index < AUDIO_ARENA_MAX_ARENAS ? atomic_load(&s_arenas[index]) : NULL;
+}
+
+#ifdef ESP_PLATFORM
+void audio_arena_log_all(void)
+{
+    static const char *TAG = "AUDIO_ARENA";
+    uint32_t total[AUDIO_ARENA_PLACE_MAX] = {0};
+    for (uint32_t i = 0; i < AUDIO_ARENA_MAX_ARENAS; i++) {
+        audio_arena_t *arena = audio_arena_get(i);
+        if (!arena) {
+            continue;
+        }
+        audio_arena_stats_t st;
+        audio_arena_get_stats(arena, &st);
+        ESP_LOGI(TAG, "%-10s sram %u/%u peak %u  psram%s %u/%u peak %u  fail=%u",
+                 st.name, (unsigned)st.used[0], (unsigned)st.budget[0], (unsigned)st.peak[0],
+                 st.psram_fallback ? "(sram)" : "", (unsigned)st.used[1], (unsigned)st.budget[1],
+                 (unsigned)st.peak[1], (unsigned)st.failures);
+        for (uint32_t k = 0; k < st.owners; k++) {
+            audio_arena_owner_stats_t o;
+            audio_arena_get_owner(arena, k, &o);
+            ESP_LOGI(TAG, "  %-12s sram %u (peak %u)  psram %u (peak %u)",
+                     o.owner, (unsigned)o.used[0], (unsigned)o.peak[0], (unsigned)o.used[1], (unsigned)o.peak[1]);
+        }
+        total[0] += st.budget[0];
+        total[1] += st.budget[1];
+    }
+    ESP_LOGI(TAG, "audio footprint: sram %u  psram %u", (unsigned)total[0], (unsigned)total[1]);
+}
+#endif
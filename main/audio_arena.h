@@ -0,0 +1,157 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 21:00:00
+ * @LastEditTime: 2026-10-16 21:00:00
+ * @LastEditors: 星年
+ * @Description: 音频内存区：每条管道按声明的预算一次性预留片内SRAM与PSRAM，构建时顺序切分，按元素统计占用
+ * @FilePath: \audio_manager\main\audio_arena.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_ARENA_MAX_OWNERS  (12)    // 每个内存区最多统计的元素数
+#define AUDIO_ARENA_MAX_ARENAS  (8)     // 全局最多登记的内存区数
+#define AUDIO_ARENA_ALIGN       (16)    // 分配对齐（满足PIE 128位访存）
+
+// 一次分配 n 字节在内存区中实际占用的字节数（按对齐向上取整），用于计算预算
+#define AUDIO_ARENA_SIZE(n)     (((size_t)(n) + AUDIO_ARENA_ALIGN - 1) & ~(size_t)(AUDIO_ARENA_ALIGN - 1))
+
+/**
+ * @brief 内存位置
+ */
+typedef enum {
+    AUDIO_ARENA_INTERNAL = 0,       // 片内SRAM：DSP每帧访问的状态与工作缓冲
+    AUDIO_ARENA_PSRAM,              // PSRAM：容量大、访问稀疏的包槽与块池
+    AUDIO_ARENA_PLACE_MAX,
+} audio_arena_place_t;
+
+/**
+ * @brief 内存区配置
+ */
+typedef struct {
+    const char *name;               // 名称（常量字符串）
+    uint32_t internal_bytes;        // 片内SRAM预算
+    uint32_t psram_bytes;           // PSRAM预算，无PSRAM时改从片内SRAM预留
+} audio_arena_cfg_t;
+
+/**
+ * @brief 单个元素的占用（字节）
+ */
+typedef struct {
+    const char *owner;                      // 元素名（与管道注册名一致）
+    uint32_t used[AUDIO_ARENA_PLACE_MAX];   // 当前占用
+    uint32_t peak[AUDIO_ARENA_PLACE_MAX];   // 历史峰值（跨多次构建）
+    uint32_t allocs;                        // 当前分配次数
+} audio_arena_owner_stats_t;
+
+/**
+ * @brief 内存区统计（字节）
+ */
+typedef struct {
+    const char *name;
+    uint32_t budget[AUDIO_ARENA_PLACE_MAX]; // 预留量
+    uint32_t used[AUDIO_ARENA_PLACE_MAX];   // 当前占用
+    uint32_t peak[AUDIO_ARENA_PLACE_MAX];   // 历史峰值
+    uint32_t failures;                      // 超出预算的分配次数
+    uint32_t owners;                        // 已统计的元素数
+    bool psram_fallback;                    // PSRAM不可用，PSRAM预算实际位于片内SRAM
+} audio_arena_stats_t;
+
+typedef struct audio_arena audio_arena_t;
+
+/**
+ * @brief 创建内存区：按预算一次性预留两块连续内存并登记到全局列表
+ *
+ * @return 句柄，预留失败返回NULL
+ */
+audio_arena_t *audio_arena_create(const audio_arena_cfg_t *cfg);
+
+/**
+ * @brief 销毁内存区，其中的所有分配一并失效
+ */
+void audio_arena_destroy(audio_arena_t *arena);
+
+/**
+ * @brief 为一次构建准备内存区：已有且预算足够时回卷复用，否则按新预算重新创建
+ *
+ * 模块首次构建时预留，此后每次重建都复用同一块内存；只有预算变大（如换了延迟档位）才重新预留。
+ *
+ * @param arena 模块持有的内存区指针，可指向NULL
+ * @param cfg   本次构建需要的预算
+ * @return 0 成功，预留失败返回 -1（*arena 置为NULL）
+ */
+int audio_arena_ensure(audio_arena_t **arena, const audio_arena_cfg_t *cfg);
+
+/**
+ * @brief 指定此后的分配记到哪个元素名下（NULL 内存区时忽略）
+ *
+ * 同一内存区的构建须在一个任务内顺序进行，不可与其他分配并发。
+ */
+void audio_arena_set_owner(audio_arena_t *arena, const char *owner);
+
+/**
+ * @brief 从内存区分配并清零
+ *
+ * arena 为NULL时按 place 从堆分配（片内SRAM或PSRAM，后者不可用时退回默认堆），
+ * 供未使用内存区的调用者保持原有行为。
+ *
+ * @param arena 内存区，可为NULL
+ * @param n     元素个数
+ * @param size  元素大小
+ * @param place 内存位置
+ * @return 按 AUDIO_ARENA_ALIGN 对齐的内存，超出预算返回NULL
+ */
+void *audio_arena_calloc(audio_arena_t *arena, size_t n, size_t size, audio_arena_place_t place);
+
+/**
+ * @brief 释放：arena 为NULL时归还堆，否则不做任何事（内存随 audio_arena_reset() 统一回收）
+ */
+void audio_arena_free(audio_arena_t *arena, void *p);
+
+/**
+ * @brief 回卷内存区：当前全部分配一次性失效，预留的内存保留供下次构建使用
+ *
+ * 调用前须已销毁所有从中分配的对象。
+ */
+void audio_arena_reset(audio_arena_t *arena);
+
+/**
+ * @brief PSRAM预算是否确实位于PSRAM
+ */
+bool audio_arena_has_psram(const audio_arena_t *arena);
+
+/**
+ * @brief 获取内存区统计
+ */
+void audio_arena_get_stats(const audio_arena_t *arena, audio_arena_stats_t *stats);
+
+/**
+ * @brief 获取第 index 个元素的占用
+ *
+ * @return 0 成功，index 越界返回 -1
+ */
+int audio_arena_get_owner(const audio_arena_t *arena, uint32_t index, audio_arena_owner_stats_t *stats);
+
+/**
+ * @brief 按下标取全局登记的内存区（0 ~ AUDIO_ARENA_MAX_ARENAS-1），空位返回NULL
+ */
+audio_arena_t *audio_arena_get(uint32_t index);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief 打印所有内存区的预算、占用、峰值与各元素明细
+ */
+void audio_arena_log_all(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1076 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 13:00:00
+ * @LastEditTime: 2026-10-16 13:00:00
+ * @LastEditors: 星年
+ * @Description: 共享采集前端实现：[i2s] -> [filter] -> [fanout]，按订阅者引用计数启动/停止
+ * @FilePath: \audio_manager\main\audio_capture.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/i2s_std.h"
+#include "audio_element.h"
+#include "audio_pipeline.h"
+#include "audio_mem.h"
+#include "audio_error.h"
+#include "i2s_stream.h"
+#include "rsp_polyphase.h"
+#include "polyphase_resampler.h"
+#include "capture_convert.h"
+#include "audio_probe.h"
+#include "audio_lifecycle.h"
+#include "audio_capture.h"
+
+static const char *TAG = "AUDIO_CAPTURE";
+
+#define AUDIO_CAPTURE_BCK_IO        41          // 麦克风BCLK引脚
+#define AUDIO_CAPTURE_WS_IO         42          // 麦克风WS引脚
+#define AUDIO_CAPTURE_DIN_IO        2           // 麦克风DIN引脚
+#define AUDIO_CAPTURE_SINK_STACK    (3 * 1024)  // 扇出元素任务堆栈
+
+// 采集内存区预算：片内放重采样状态、扇出元素与块描述，PSRAM放块池样点
+#define AUDIO_CAPTURE_ARENA_SRAM    (6 * 1024)
+#define AUDIO_CAPTURE_ARENA_PSRAM   AUDIO_ARENA_SIZE(AUDIO_CAPTURE_BLOCK_COUNT * AUDIO_CAPTURE_BLOCK_SAMPLES * sizeof(int16_t))
+#define AUDIO_CAPTURE_GRAPH_NODES   3           // 处理图节点：转换、重采样、扇出
+#define AUDIO_CAPTURE_GRAPH_ACK_MS  100         // 节拍任务确认暂停/退出的等待上限（远大于一个节拍）
+
+// INMP441：SCK 0.5~3.2MHz、每帧64个SCK，即约7.8kHz~50kHz；24位数据左对齐于32位槽
+#define DEFAULT_AUDIO_CAPTURE_MIC_CAPS() {              \
+    .rate_count    = 0,                                 \
+    .rate_min      = 7800,                              \
+    .rate_max      = 50000,                             \
+    .channels_mask = AUDIO_FORMAT_CH(1),                \
+    .bits_mask     = AUDIO_FORMAT_BITS_32,              \
+}
+
+// 采集链路可用的采样率转换器（开销为每个输出样点的乘加次数）
+static const audio_format_conv_t s_capture_convs[] = {
+    {"polyphase", 44100, AUDIO_CAPTURE_SAMPLE_RATE, POLYPHASE_RSP_TAPS},
+};
+
+// 发布格式：下游编码器、回声消除与监听都按16kHz 16位单声道构建
+static const audio_caps_t s_capture_caps = {
+    .rates = {AUDIO_CAPTURE_SAMPLE_RATE},
+    .rate_count = 1,
+    .channels_mask = AUDIO_FORMAT_CH(1),
+    .bits_mask = AUDIO_FORMAT_BITS_16,
+};
+
+struct audio_capture_client {
+    audio_fanout_consumer_t *consumer;  // 扇出消费者（暂停期间为NULL）
+    SemaphoreHandle_t sem;              // 新块到达信号
+    audio_probe_t *probe;               // 读取元素的性能探针
+    audio_lifecycle_t *lifecycle;       // 读取元素所属管道的生命周期（记录首块数据耗时，可为NULL）
+    uint32_t depth;                     // 队列深度
+    bool active;                        // 是否在接收数据
+    volatile bool wake;                 // audio_capture_wake() 请求：等待中的 pull 立即返回NULL
+};
+
+typedef struct {
+    audio_block_t *cur;                 // 正在填充的块
+    uint32_t timestamp;                 // 下一个样点的采样计数
+    uint32_t dropped;                   // 块池耗尽丢弃的样点数
+    audio_probe_t *probe;               // 性能探针
+} capture_sink_t;
+
+typedef struct {
+    i2s_chan_handle_t rx;               // 采集通道
+    int32_t *rx_buf;                    // DMA读取缓冲区（32位槽，尾部留出转换内核的填充）
+    capture_conv_t conv;                // 格式转换（取位/去直流/增益/饱和）
+    polyphase_rsp_t *rsp;               // 多相重采样状态
+    audio_graph_t *graph;               // [cap_conv] -> [cap_rsp] -> [cap_fanout]
+    capture_sink_t sink;                // 扇出切块状态（持有订阅表锁访问）
+    audio_probe_t *probe;               // 整个节拍的性能探针
+    uint32_t in_block;                  // 每节拍读取的I2S样点数（按协商的采集采样率）
+    uint32_t rx_errors;                 // I2S读取失败或不足一节拍的次数
+} capture_graph_t;
+
+static portMUX_TYPE s_lock_mux = portMUX_INITIALIZER_UNLOCKED;
+static StaticSemaphore_t s_life_lock_buf;
+static StaticSemaphore_t s_table_lock_buf;
+static SemaphoreHandle_t s_life_lock = NULL;            // 串行化启动/停止
+static SemaphoreHandle_t s_table_lock = NULL;           // 串行化订阅表修改与发布
+static audio_arena_t *s_arena = NULL;                   // 采集内存区（首次订阅时预留，之后复用）
+static audio_fanout_t *s_fanout = NULL;                 // PCM块扇出
+static audio_pipeline_handle_t s_pipeline = NULL;       // 采集管道
+static audio_element_handle_t s_i2s = NULL;             // I2S输入元素
+static audio_element_handle_t s_filter = NULL;          // 重采样元素
+static audio_element_handle_t s_sink = NULL;            // 扇出元素
+static uint32_t s_clients = 0;                          // 当前订阅者数
+static uint32_t s_active = 0;                           // 当前接收数据的订阅者数，为0时采集管道暂停
+static uint32_t s_block_samples = 0;                    // 当前块长（按延迟档位取帧长，最长20ms）
+static bool s_external = false;                         // 是否由外部数据源（全双工引擎）供数
+static uint32_t s_external_latency_us = 0;              // 外部数据源自身的缓冲延迟
+static capture_sink_t s_ext_sink;                       // 外部数据源的切块状态（持有订阅表锁访问）
+static audio_engine_t s_engine = AUDIO_ENGINE_ADF;      // 下次创建采集管道时使用的执行引擎
+static capture_graph_t *s_graph = NULL;                 // 处理图引擎（以处理图运行时非NULL）
+static TaskHandle_t s_graph_task = NULL;                // 处理图节拍任务
+static volatile bool s_graph_running = false;           // 节拍任务运行标志
+static volatile bool s_graph_paused = false;            // 暂停请求
+static StaticSemaphore_t s_graph_ack_buf;
+static SemaphoreHandle_t s_graph_ack = NULL;            // 节拍任务已确认暂停或已退出（二值信号量）
+static audio_caps_t s_mic_caps = DEFAULT_AUDIO_CAPTURE_MIC_CAPS();  // 麦克风支持的格式
+static audio_format_link_t s_link;                      // 当前采集链路的协商结果（创建扇出时确定）
+
+/* ------------------------------------------------------------------ */
+/* 扇出元素：把重采样输出切成定长块并发布                              */
+/* ------------------------------------------------------------------ */
+
+static esp_err_t _capture_sink_open(audio_element_handle_t self)
+{
+    capture_sink_t *sink = (capture_sink_t *)audio_element_getdata(self);
+    sink->cur = NULL;
+    sink->timestamp = 0;
+    sink->probe = audio_probe_get(audio_element_get_tag(self));
+    return ESP_OK;
+}
+
+static esp_err_t _capture_sink_close(audio_element_handle_t self)
+{
+    capture_sink_t *sink = (capture_sink_t *)audio_element_getdata(self);
+    if (sink->cur) {
+        audio_fanout_release(s_fanout, sink->cur);
+        sink->cur = NULL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 把样点切成定长块并发布，调用者须持有订阅表锁
+ */
+static void capture_sink_feed(capture_sink_t *sink, const int16_t *p, int left)
+{
+    while (left > 0) {
+        if (!sink->cur) {
+            sink->cur = audio_fanout_alloc(s_fanout);
+            if (!sink->cur) {
+                // 所有块都被订阅者占用，丢弃本次输入，不阻塞采集
+                sink->dropped += left;
+                sink->timestamp += left;
+                audio_probe_error(sink->probe);
+                break;
+            }
+            sink->cur->timestamp = sink->timestamp;
+        }
+        audio_block_t *blk = sink->cur;
+        int n = blk->cap - blk->count;
+        if (n > left) {
+            n = left;
+        }
+        memcpy(blk->samples + blk->count, p, n * sizeof(int16_t));
+        blk->count += n;
+        sink->timestamp += n;
+        p += n;
+        left -= n;
+        if (blk->count == blk->cap) {
+            audio_fanout_publish(s_fanout, blk);
+            sink->cur = NULL;
+        }
+    }
+}
+
+static audio_element_err_t _capture_sink_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    capture_sink_t *sink = (capture_sink_t *)audio_element_getdata(self);
+    int r_size = audio_element_input(self, in_buffer, in_len);
+    if (r_size <= 0) {
+        return r_size;
+    }
+    uint32_t stamp = audio_probe_begin(sink->probe, self);
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    capture_sink_feed(sink, (const int16_t *)in_buffer, r_size / sizeof(int16_t));
+    xSemaphoreGive(s_table_lock);
+    audio_probe_end(sink->probe, stamp);
+    return r_size;
+}
+
+static esp_err_t _capture_sink_destroy(audio_element_handle_t self)
+{
+    capture_sink_t *sink = (capture_sink_t *)audio_element_getdata(self);
+    if (sink->dropped) {
+        ESP_LOGW(TAG, "dropped %u samples, block pool exhausted", (unsigned)sink->dropped);
+    }
+    audio_arena_free(s_arena, sink);
+    return ESP_OK;
+}
+
+static audio_element_handle_t capture_sink_init(const audio_latency_profile_t *profile)
+{
+    audio_arena_set_owner(s_arena, "cap_fanout");
+    capture_sink_t *sink = (capture_sink_t *)audio_arena_calloc(s_arena, 1, sizeof(capture_sink_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, sink, return NULL);
+
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = _capture_sink_open;
+    cfg.close = _capture_sink_close;
+    cfg.process = _capture_sink_process;
+    cfg.destroy = _capture_sink_destroy;
+    cfg.buffer_len = s_block_samples * sizeof(int16_t);
+    cfg.out_rb_size = 0;
+    cfg.task_stack = AUDIO_CAPTURE_SINK_STACK;
+    cfg.task_core = profile->capture_core;
+    cfg.task_prio = profile->task_prio;
+    cfg.tag = "capture_fanout";
+
+    audio_element_handle_t el = audio_element_init(&cfg);
+    AUDIO_MEM_CHECK(TAG, el, {audio_arena_free(s_arena, sink); return NULL;});
+    audio_element_setdata(el, sink);
+    return el;
+}
+
+/* ------------------------------------------------------------------ */
+/* 采集管道生命周期                                                    */
+/* ------------------------------------------------------------------ */
+
+static void capture_locks_init(void)
+{
+    if (s_life_lock) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock_mux);
+    if (!s_life_lock) {
+        s_table_lock = xSemaphoreCreateMutexStatic(&s_table_lock_buf);
+        s_graph_ack = xSemaphoreCreateBinaryStatic(&s_graph_ack_buf);
+        s_life_lock = xSemaphoreCreateMutexStatic(&s_life_lock_buf);
+    }
+    portEXIT_CRITICAL(&s_lock_mux);
+}
+
+static void capture_pipeline_destroy(void)
+{
+    if (s_pipeline) {
+        audio_pipeline_stop(s_pipeline);
+        audio_pipeline_wait_for_stop(s_pipeline);
+        audio_pipeline_terminate(s_pipeline);
+        audio_pipeline_unregister(s_pipeline, s_i2s);
+        audio_pipeline_unregister(s_pipeline, s_filter);
+        audio_pipeline_unregister(s_pipeline, s_sink);
+        audio_pipeline_deinit(s_pipeline);
+        s_pipeline = NULL;
+    }
+    if (s_i2s) {
+        audio_element_deinit(s_i2s);
+        s_i2s = NULL;
+    }
+    if (s_filter) {
+        audio_element_deinit(s_filter);
+        s_filter = NULL;
+    }
+    if (s_sink) {
+        audio_element_deinit(s_sink);
+        s_sink = NULL;
+    }
+}
+
+static size_t capture_graph_mem_size(void);
+
+/**
+ * @brief 协商I2S采集采样率：能直采发布采样率就不跑重采样
+ */
+static esp_err_t capture_negotiate(void)
+{
+    if (audio_format_negotiate(&s_mic_caps, &s_capture_caps, s_capture_convs,
+                               sizeof(s_capture_convs) / sizeof(s_capture_convs[0]), &s_link) != 0) {
+        ESP_LOGE(TAG, "No capture path from mic to %u Hz", AUDIO_CAPTURE_SAMPLE_RATE);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    ESP_LOGI(TAG, "Capture format: mic %u Hz %u-bit -> %u Hz %u-bit (%s)", (unsigned)s_link.src.rate,
+             s_link.src.bits, (unsigned)s_link.sink.rate, s_link.sink.bits,
+             s_link.conv < 0 ? "direct" : s_capture_convs[s_link.conv].name);
+    return ESP_OK;
+}
+
+static bool capture_resampling(void)
+{
+    return s_link.conv >= 0;
+}
+
+static esp_err_t capture_fanout_create(void)
+{
+    if (!s_external && capture_negotiate() != ESP_OK) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    // 块长跟随延迟档位的帧长，避免短帧时在块内额外攒数据
+    s_block_samples = audio_latency_frame_samples(AUDIO_CAPTURE_SAMPLE_RATE);
+    if (s_block_samples > AUDIO_CAPTURE_BLOCK_SAMPLES) {
+        s_block_samples = AUDIO_CAPTURE_BLOCK_SAMPLES;
+    }
+    // 扇出先于采集管道创建、后于其销毁，此时内存区中没有其他对象，可整体回卷
+    audio_arena_cfg_t arena_cfg = {
+        .name = "capture",
+        .internal_bytes = AUDIO_CAPTURE_ARENA_SRAM,
+        .psram_bytes = AUDIO_CAPTURE_ARENA_PSRAM,
+    };
+    if (s_engine == AUDIO_ENGINE_GRAPH && !s_external) {
+        arena_cfg.internal_bytes += capture_graph_mem_size();
+    }
+    if (audio_arena_ensure(&s_arena, &arena_cfg) != 0) {
+        ESP_LOGE(TAG, "Failed to reserve capture arena");
+        return ESP_ERR_NO_MEM;
+    }
+    audio_arena_set_owner(s_arena, "cap_fanout");
+    audio_fanout_t *fo = audio_fanout_create(s_arena, AUDIO_CAPTURE_BLOCK_COUNT, s_block_samples);
+    if (!fo) {
+        ESP_LOGE(TAG, "Failed to create block pool");
+        return ESP_ERR_NO_MEM;
+    }
+    // 外部数据源在订阅表锁内读取 s_fanout
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    s_fanout = fo;
+    xSemaphoreGive(s_table_lock);
+    return ESP_OK;
+}
+
+static void capture_fanout_destroy(void)
+{
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    if (s_ext_sink.cur) {
+        audio_fanout_release(s_fanout, s_ext_sink.cur);
+        s_ext_sink.cur = NULL;
+    }
+    audio_fanout_destroy(s_fanout);
+    s_fanout = NULL;
+    xSemaphoreGive(s_table_lock);
+}
+
+static esp_err_t capture_pipeline_create(void)
+{
+    const audio_latency_profile_t *profile = audio_latency_get_profile();
+
+    // 1. I2S输入：INMP441，按协商的采样率单声道采集，24位数据左对齐于32位槽；
+    //    读取元素原样输出DMA字，不做位宽扩展，转换交给重采样元素一次完成
+    i2s_stream_cfg_t i2s_cfg = I2S_STREAM_CFG_DEFAULT();
+    i2s_cfg.type = AUDIO_STREAM_READER;
+    i2s_cfg.transmit_mode = I2S_COMM_MODE_STD;
+    i2s_cfg.chan_cfg.id = I2S_NUM_0;
+    i2s_cfg.chan_cfg.role = I2S_ROLE_MASTER;
+    i2s_cfg.chan_cfg.dma_desc_num = profile->i2s_dma_desc_num;
+    i2s_cfg.chan_cfg.dma_frame_num = profile->i2s_dma_frame_num;
+    i2s_cfg.std_cfg.clk_cfg.sample_rate_hz = s_link.src.rate;
+    i2s_cfg.std_cfg.slot_cfg.data_bit_width = I2S_DATA_BIT_WIDTH_32BIT;
+    i2s_cfg.std_cfg.slot_cfg.slot_bit_width = I2S_SLOT_BIT_WIDTH_32BIT;
+    i2s_cfg.std_cfg.slot_cfg.slot_mode = I2S_SLOT_MODE_MONO;
+    i2s_cfg.std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+    i2s_cfg.std_cfg.slot_cfg.ws_width = 32;
+    i2s_cfg.std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+    i2s_cfg.std_cfg.gpio_cfg.bclk = AUDIO_CAPTURE_BCK_IO;
+    i2s_cfg.std_cfg.gpio_cfg.ws = AUDIO_CAPTURE_WS_IO;
+    i2s_cfg.std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;
+    i2s_cfg.std_cfg.gpio_cfg.din = AUDIO_CAPTURE_DIN_IO;
+    i2s_cfg.use_alc = false;
+    i2s_cfg.need_expand = false;
+    i2s_cfg.out_rb_size = profile->i2s_rb_size;
+    i2s_cfg.buffer_len = profile->i2s_buffer_len;
+    i2s_cfg.task_stack = I2S_STREAM_TASK_STACK;
+    i2s_cfg.task_core = profile->capture_core;
+    i2s_cfg.task_prio = profile->task_prio;
+    s_i2s = i2s_stream_init(&i2s_cfg);
+
+    // 2. 格式转换（取位/去直流/增益/饱和）+ 多相重采样 44.1kHz -> 16kHz；直采16kHz时只做格式转换
+    rsp_polyphase_cfg_t rsp_cfg = DEFAULT_RSP_POLYPHASE_CONFIG();
+    rsp_cfg.in_bits = 32;
+    rsp_cfg.in_rate = (int)s_link.src.rate;
+    rsp_cfg.conv.gain_q12 = AUDIO_CAPTURE_GAIN_Q12;
+    rsp_cfg.conv.dc_shift = AUDIO_CAPTURE_DC_SHIFT;
+    rsp_cfg.arena = s_arena;
+    rsp_cfg.out_rb_size = profile->element_rb_size;
+    rsp_cfg.task_core = profile->capture_core;
+    rsp_cfg.task_prio = profile->task_prio;
+    audio_arena_set_owner(s_arena, "cap_rsp");
+    s_filter = rsp_polyphase_init(&rsp_cfg);
+
+    // 3. 扇出元素
+    s_sink = capture_sink_init(profile);
+    audio_arena_set_owner(s_arena, NULL);
+
+    audio_pipeline_cfg_t pipeline_cfg = DEFAULT_AUDIO_PIPELINE_CONFIG();
+    s_pipeline = audio_pipeline_init(&pipeline_cfg);
+    if (!s_i2s || !s_filter || !s_sink || !s_pipeline) {
+        ESP_LOGE(TAG, "Failed to create capture pipeline");
+        capture_pipeline_destroy();
+        return ESP_FAIL;
+    }
+    // 注册名同时作为探针名，各管道之间不可重名；直采时中间元素只做格式转换，与处理图节点同名
+    const char *filter_tag = capture_resampling() ? "cap_rsp" : "cap_conv";
+    audio_pipeline_register(s_pipeline, s_i2s, "cap_i2s");
+    audio_pipeline_register(s_pipeline, s_filter, filter_tag);
+    audio_pipeline_register(s_pipeline, s_sink, "cap_fanout");
+    const char *link_tag[3] = {"cap_i2s", filter_tag, "cap_fanout"};
+    audio_pipeline_link(s_pipeline, &link_tag[0], 3);
+    audio_pipeline_run(s_pipeline);
+    ESP_LOGI(TAG, "Capture pipeline started");
+    return ESP_OK;
+}
+
+/* ------------------------------------------------------------------ */
+/* 处理图引擎：一个任务以RX DMA为节拍同步跑完整条链                     */
+/* ------------------------------------------------------------------ */
+
+static uint32_t capture_graph_in_block(void)
+{
+    return s_block_samples * s_link.src.rate / AUDIO_CAPTURE_SAMPLE_RATE;
+}
+
+static void capture_graph_cfg(audio_graph_cfg_t *cfg)
+{
+    // 转换节点输出与输入等长，重采样节点输出更短，工作缓冲按转换输出取
+    audio_graph_cfg_t graph_cfg = DEFAULT_AUDIO_GRAPH_CONFIG();
+    graph_cfg.buf_bytes = capture_graph_in_block() * sizeof(int16_t);
+    graph_cfg.frame_us = s_block_samples * 1000000 / AUDIO_CAPTURE_SAMPLE_RATE;
+    graph_cfg.arena = s_arena;
+    *cfg = graph_cfg;
+}
+
+/**
+ * @brief 处理图引擎在采集内存区中额外需要的片内预算（节拍缓冲与处理图，替代重采样元素的三块缓冲）
+ */
+static size_t capture_graph_mem_size(void)
+{
+    audio_graph_cfg_t cfg;
+    capture_graph_cfg(&cfg);
+    uint32_t rx_words = capture_graph_in_block() + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t);
+    size_t rsp_bytes = capture_resampling() ? AUDIO_ARENA_SIZE(sizeof(polyphase_rsp_t)) : 0;
+    return AUDIO_ARENA_SIZE(sizeof(capture_graph_t)) + AUDIO_ARENA_SIZE(rx_words * sizeof(int32_t)) +
+           rsp_bytes + audio_graph_mem_size(&cfg, AUDIO_ARENA_INTERNAL);
+}
+
+static uint32_t _capture_graph_clock(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+static size_t _capture_graph_conv(void *ctx, const void *in, size_t n, void *out)
+{
+    capture_graph_t *cg = (capture_graph_t *)ctx;
+    capture_conv_s16(&cg->conv, (const int32_t *)in, (int16_t *)out, n);
+    return n;
+}
+
+static size_t _capture_graph_rsp(void *ctx, const void *in, size_t n, void *out)
+{
+    capture_graph_t *cg = (capture_graph_t *)ctx;
+    return polyphase_rsp_process(cg->rsp, (const int16_t *)in, n, (int16_t *)out);
+}
+
+static size_t _capture_graph_fanout(void *ctx, const void *in, size_t n, void *out)
+{
+    capture_graph_t *cg = (capture_graph_t *)ctx;
+    (void)out;
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    capture_sink_feed(&cg->sink, (const int16_t *)in, (int)n);
+    xSemaphoreGive(s_table_lock);
+    return 0;
+}
+
+/**
+ * @brief 交出未凑满的块并复位滤波器状态，恢复时从新数据开始（对应元素管道暂停时的关闭/打开）
+ */
+static void capture_graph_flush(capture_graph_t *cg)
+{
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    if (cg->sink.cur) {
+        audio_fanout_release(s_fanout, cg->sink.cur);
+        cg->sink.cur = NULL;
+    }
+    xSemaphoreGive(s_table_lock);
+    if (cg->rsp) {
+        polyphase_rsp_reset(cg->rsp);
+    }
+    capture_conv_cfg_t conv_cfg = {
+        .gain_q12 = AUDIO_CAPTURE_GAIN_Q12,
+        .dc_shift = AUDIO_CAPTURE_DC_SHIFT,
+    };
+    capture_conv_init(&cg->conv, &conv_cfg);
+}
+
+static void capture_graph_task(void *arg)
+{
+    capture_graph_t *cg = (capture_graph_t *)arg;
+    size_t bytes = cg->in_block * sizeof(int32_t);
+    // 一个节拍的超时：两个块时长，至少10ms；暂停请求最迟在一次超时后得到响应
+    uint32_t timeout_ms = cg->in_block * 2000 / s_link.src.rate;
+    if (timeout_ms < 10) {
+        timeout_ms = 10;
+    }
+
+    while (s_graph_running) {
+        if (s_graph_paused) {
+            capture_graph_flush(cg);
+            xSemaphoreGive(s_graph_ack);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        // 1. 等待RX DMA完成一个节拍
+        size_t n = 0;
+        if (i2s_channel_read(cg->rx, cg->rx_buf, bytes, &n, timeout_ms) != ESP_OK || n != bytes) {
+            cg->rx_errors++;
+            continue;
+        }
+        // 2. 转换 -> 重采样 -> 切块发布，中间结果只在两块工作缓冲之间按指针传递
+        uint32_t stamp = audio_probe_begin(cg->probe, NULL);
+        audio_graph_run(cg->graph, cg->rx_buf, cg->in_block);
+        audio_probe_end(cg->probe, stamp);
+    }
+    s_graph_task = NULL;
+    xSemaphoreGive(s_graph_ack);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t capture_graph_i2s_init(capture_graph_t *cg, const audio_latency_profile_t *profile)
+{
+    // INMP441：按协商的采样率单声道采集，24位数据左对齐于32位槽；每个DMA描述符恰好一个节拍
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = profile->i2s_dma_desc_num;
+    chan_cfg.dma_frame_num = cg->in_block;
+    esp_err_t ret = i2s_new_channel(&chan_cfg, NULL, &cg->rx);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(s_link.src.rate),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = AUDIO_CAPTURE_BCK_IO,
+            .ws = AUDIO_CAPTURE_WS_IO,
+            .dout = I2S_GPIO_UNUSED,
+            .din = AUDIO_CAPTURE_DIN_IO,
+        },
+    };
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+    ret = i2s_channel_init_std_mode(cg->rx, &std_cfg);
+    if (ret == ESP_OK) {
+        ret = i2s_channel_enable(cg->rx);
+    }
+    return ret;
+}
+
+static void capture_graph_free(capture_graph_t *cg)
+{
+    if (cg->rx) {
+        i2s_del_channel(cg->rx);
+    }
+    if (cg->sink.dropped) {
+        ESP_LOGW(TAG, "dropped %u samples, block pool exhausted", (unsigned)cg->sink.dropped);
+    }
+    audio_graph_destroy(cg->graph);
+    audio_arena_free(s_arena, cg->rsp);
+    audio_arena_free(s_arena, cg->rx_buf);
+    audio_arena_free(s_arena, cg);
+}
+
+static void capture_graph_destroy(void)
+{
+    capture_graph_t *cg = s_graph;
+    if (!cg) {
+        return;
+    }
+    s_graph_running = false;
+    if (s_graph_task) {
+        xTaskNotifyGive(s_graph_task);
+    }
+    // 任务退出前给出确认；暂停确认迟到时会多取到一次，以任务句柄清空为准
+    while (s_graph_task) {
+        if (xSemaphoreTake(s_graph_ack, pdMS_TO_TICKS(AUDIO_CAPTURE_GRAPH_ACK_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "waiting for capture graph task to exit");
+        }
+    }
+    if (!s_graph_paused) {
+        i2s_channel_disable(cg->rx);
+    }
+    capture_graph_flush(cg);
+    s_graph = NULL;
+    capture_graph_free(cg);
+}
+
+static esp_err_t capture_graph_create(void)
+{
+    const audio_latency_profile_t *profile = audio_latency_get_profile();
+    audio_arena_set_owner(s_arena, "cap_graph");
+    capture_graph_t *cg = (capture_graph_t *)audio_arena_calloc(s_arena, 1, sizeof(capture_graph_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, cg, return ESP_ERR_NO_MEM);
+    cg->in_block = capture_graph_in_block();
+    // 转换内核会越过末尾预取，读取缓冲区尾部留出填充
+    uint32_t rx_words = cg->in_block + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t);
+    cg->rx_buf = (int32_t *)audio_arena_calloc(s_arena, rx_words, sizeof(int32_t), AUDIO_ARENA_INTERNAL);
+    if (capture_resampling()) {
+        cg->rsp = (polyphase_rsp_t *)audio_arena_calloc(s_arena, 1, sizeof(polyphase_rsp_t), AUDIO_ARENA_INTERNAL);
+    }
+    audio_graph_cfg_t graph_cfg;
+    capture_graph_cfg(&graph_cfg);
+    graph_cfg.clock_us = _capture_graph_clock;
+    cg->graph = audio_graph_create(&graph_cfg);
+    audio_arena_set_owner(s_arena, NULL);
+    AUDIO_MEM_CHECK(TAG, cg->rx_buf && (cg->rsp || !capture_resampling()) && cg->graph, {
+        capture_graph_free(cg);
+        return ESP_ERR_NO_MEM;
+    });
+    // 节点名与元素管道的注册名一致，两种引擎的统计可直接对照
+    audio_graph_add(cg->graph, "cap_conv", _capture_graph_conv, cg, false);
+    if (cg->rsp) {
+        audio_graph_add(cg->graph, "cap_rsp", _capture_graph_rsp, cg, false);
+    }
+    audio_graph_add(cg->graph, "cap_fanout", _capture_graph_fanout, cg, false);
+    cg->sink.probe = audio_probe_get("cap_fanout");
+    cg->probe = audio_probe_get("cap_graph");
+    capture_graph_flush(cg);
+
+    esp_err_t ret = capture_graph_i2s_init(cg, profile);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2S init failed: %s", esp_err_to_name(ret));
+        capture_graph_free(cg);
+        return ret;
+    }
+    s_graph = cg;
+    s_graph_paused = false;
+    xSemaphoreTake(s_graph_ack, 0);
+    s_graph_running = true;
+    if (xTaskCreatePinnedToCore(capture_graph_task, "cap_graph", AUDIO_CAPTURE_GRAPH_TASK_STACK, cg,
+                                profile->task_prio, &s_graph_task, profile->capture_core) != pdPASS) {
+        s_graph_running = false;
+        s_graph = NULL;
+        i2s_channel_disable(cg->rx);
+        capture_graph_free(cg);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Capture graph started: tick %u samples @ %u Hz", (unsigned)cg->in_block, (unsigned)s_link.src.rate);
+    return ESP_OK;
+}
+
+/**
+ * @brief 暂停节拍任务：同步握手，任务处理完在途的节拍、交出未凑满的块后给出确认并阻塞，再停掉RX DMA
+ */
+static esp_err_t capture_graph_pause(void)
+{
+    if (s_graph_paused) {
+        return ESP_OK;
+    }
+    xSemaphoreTake(s_graph_ack, 0);     // 清掉上次超时后迟到的确认
+    s_graph_paused = true;
+    if (xSemaphoreTake(s_graph_ack, pdMS_TO_TICKS(AUDIO_CAPTURE_GRAPH_ACK_MS)) != pdTRUE) {
+        // 撤销暂停请求：任务若随后进入等待，这次通知让它立即继续
+        s_graph_paused = false;
+        xTaskNotifyGive(s_graph_task);
+        ESP_LOGW(TAG, "capture graph task did not acknowledge pause");
+        return ESP_ERR_TIMEOUT;
+    }
+    return i2s_channel_disable(s_graph->rx);
+}
+
+static esp_err_t capture_graph_resume(void)
+{
+    if (!s_graph_paused) {
+        return ESP_OK;
+    }
+    esp_err_t ret = i2s_channel_enable(s_graph->rx);
+    s_graph_paused = false;
+    xTaskNotifyGive(s_graph_task);
+    return ret;
+}
+
+/* ------------------------------------------------------------------ */
+/* 按执行引擎分派                                                      */
+/* ------------------------------------------------------------------ */
+
+static esp_err_t capture_engine_create(void)
+{
+    return s_engine == AUDIO_ENGINE_GRAPH ? capture_graph_create() : capture_pipeline_create();
+}
+
+static void capture_engine_destroy(void)
+{
+    capture_pipeline_destroy();
+    capture_graph_destroy();
+}
+
+static esp_err_t capture_engine_pause(void)
+{
+    if (s_pipeline) {
+        return audio_lifecycle_pause(s_pipeline);
+    }
+    return s_graph ? capture_graph_pause() : ESP_OK;
+}
+
+static esp_err_t capture_engine_resume(void)
+{
+    if (s_pipeline) {
+        return audio_lifecycle_resume(s_pipeline);
+    }
+    return s_graph ? capture_graph_resume() : ESP_OK;
+}
+
+void audio_capture_set_engine(audio_engine_t engine)
+{
+    capture_locks_init();
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    s_engine = engine;
+    if (s_clients) {
+        ESP_LOGI(TAG, "engine change takes effect when capture restarts");
+    }
+    xSemaphoreGive(s_life_lock);
+}
+
+int audio_capture_get_graph_stats(audio_graph_stats_t *stats, audio_graph_node_stats_t *nodes, int max)
+{
+    if (!s_life_lock) {
+        return -1;
+    }
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    int count = s_graph ? audio_graph_get_stats(s_graph->graph, stats, nodes, max) : -1;
+    xSemaphoreGive(s_life_lock);
+    return count;
+}
+
+void audio_capture_set_mic_caps(const audio_caps_t *caps)
+{
+    static const audio_caps_t defaults = DEFAULT_AUDIO_CAPTURE_MIC_CAPS();
+    capture_locks_init();
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    s_mic_caps = caps ? *caps : defaults;
+    if (s_clients) {
+        ESP_LOGI(TAG, "mic caps take effect when capture restarts");
+    }
+    xSemaphoreGive(s_life_lock);
+}
+
+const audio_caps_t *audio_capture_get_caps(void)
+{
+    return &s_capture_caps;
+}
+
+uint32_t audio_capture_block_samples(void)
+{
+    return s_block_samples;
+}
+
+esp_err_t audio_capture_get_link(audio_format_link_t *link)
+{
+    if (!link || !s_life_lock) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    esp_err_t ret = (s_pipeline || s_graph) ? ESP_OK : ESP_ERR_INVALID_STATE;
+    if (ret == ESP_OK) {
+        *link = s_link;
+    }
+    xSemaphoreGive(s_life_lock);
+    return ret;
+}
+
+/* ------------------------------------------------------------------ */
+/* 订阅接口                                                            */
+/* ------------------------------------------------------------------ */
+
+static void _capture_client_notify(void *ctx)
+{
+    xSemaphoreGive((SemaphoreHandle_t)ctx);
+}
+
+audio_capture_client_t *audio_capture_subscribe(uint32_t depth)
+{
+    capture_locks_init();
+    audio_capture_client_t *client = (audio_capture_client_t *)audio_calloc(1, sizeof(audio_capture_client_t));
+    AUDIO_MEM_CHECK(TAG, client, return NULL);
+    client->sem = xSemaphoreCreateBinary();
+    AUDIO_MEM_CHECK(TAG, client->sem, {audio_free(client); return NULL;});
+
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    if (!s_fanout && capture_fanout_create() != ESP_OK) {
+        goto _fail;
+    }
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    client->consumer = audio_fanout_subscribe(s_fanout, depth, _capture_client_notify, client->sem);
+    xSemaphoreGive(s_table_lock);
+    if (!client->consumer) {
+        ESP_LOGE(TAG, "Too many capture clients");
+        goto _fail;
+    }
+    client->depth = depth;
+    client->active = true;
+    // 外部数据源接管时不创建I2S采集管道
+    if (++s_clients == 1 && !s_external && capture_engine_create() != ESP_OK) {
+        xSemaphoreTake(s_table_lock, portMAX_DELAY);
+        audio_fanout_unsubscribe(s_fanout, client->consumer);
+        xSemaphoreGive(s_table_lock);
+        s_clients = 0;
+        goto _fail;
+    }
+    if (s_active++ == 0 && s_clients > 1) {
+        capture_engine_resume();
+    }
+    xSemaphoreGive(s_life_lock);
+    return client;
+
+_fail:
+    if (s_clients == 0 && s_fanout) {
+        capture_fanout_destroy();
+    }
+    xSemaphoreGive(s_life_lock);
+    vSemaphoreDelete(client->sem);
+    audio_free(client);
+    return NULL;
+}
+
+void audio_capture_unsubscribe(audio_capture_client_t *client)
+{
+    if (!client) {
+        return;
+    }
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    if (client->active) {
+        xSemaphoreTake(s_table_lock, portMAX_DELAY);
+        audio_fanout_unsubscribe(s_fanout, client->consumer);
+        xSemaphoreGive(s_table_lock);
+        s_active--;
+    }
+    if (--s_clients == 0) {
+        // 停止管道时不可持有订阅表锁，扇出元素发布时需要它
+        capture_engine_destroy();
+        capture_fanout_destroy();
+        audio_arena_reset(s_arena);
+        ESP_LOGI(TAG, "Capture stopped");
+    } else if (s_active == 0) {
+        capture_engine_pause();
+    }
+    xSemaphoreGive(s_life_lock);
+    vSemaphoreDelete(client->sem);
+    audio_free(client);
+}
+
+esp_err_t audio_capture_set_active(audio_capture_client_t *client, bool active)
+{
+    if (!client || !s_life_lock) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    if (client->active == active) {
+        xSemaphoreGive(s_life_lock);
+        return ESP_OK;
+    }
+    if (active) {
+        // 重新占用暂停时让出的消费者槽位，不分配内存
+        xSemaphoreTake(s_table_lock, portMAX_DELAY);
+        client->consumer = audio_fanout_subscribe(s_fanout, client->depth, _capture_client_notify, client->sem);
+        xSemaphoreGive(s_table_lock);
+        if (!client->consumer) {
+            ESP_LOGE(TAG, "Too many capture clients");
+            xSemaphoreGive(s_life_lock);
+            return ESP_ERR_NO_MEM;
+        }
+        xSemaphoreTake(client->sem, 0);
+        client->active = true;
+        if (s_active++ == 0) {
+            ret = capture_engine_resume();
+        }
+    } else {
+        // 注销消费者即释放其队列中未取走的块，不再占用块池
+        xSemaphoreTake(s_table_lock, portMAX_DELAY);
+        audio_fanout_unsubscribe(s_fanout, client->consumer);
+        client->consumer = NULL;
+        xSemaphoreGive(s_table_lock);
+        client->active = false;
+        if (--s_active == 0) {
+            // 最后一个接收者暂停时采集管道随之暂停，I2S驱动与元素任务保留
+            ret = capture_engine_pause();
+        }
+    }
+    xSemaphoreGive(s_life_lock);
+    return ret;
+}
+
+const audio_block_t *audio_capture_pull(audio_capture_client_t *client, uint32_t timeout_ms)
+{
+    if (!client->active) {
+        return NULL;
+    }
+    TickType_t ticks = (timeout_ms == AUDIO_CAPTURE_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    const audio_block_t *blk = audio_fanout_pull(client->consumer);
+    while (!blk) {
+        if (xSemaphoreTake(client->sem, ticks) != pdTRUE) {
+            return NULL;    // 超时
+        }
+        if (client->wake) {
+            client->wake = false;
+            return NULL;    // 被 audio_capture_wake() 唤醒
+        }
+        blk = audio_fanout_pull(client->consumer);
+    }
+    return blk;
+}
+
+void audio_capture_wake(audio_capture_client_t *client)
+{
+    client->wake = true;
+    xSemaphoreGive(client->sem);
+}
+
+void audio_capture_release(audio_capture_client_t *client, const audio_block_t *blk)
+{
+    (void)client;
+    audio_fanout_release(s_fanout, blk);
+}
+
+uint32_t audio_capture_overruns(const audio_capture_client_t *client)
+{
+    return client->consumer ? audio_fanout_overruns(client->consumer) : 0;
+}
+
+esp_err_t audio_capture_get_latency(const audio_capture_client_t *client, audio_latency_report_t *report)
+{
+    if (!client || !report || !s_life_lock) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    if (s_clients == 0 || !client->active) {
+        xSemaphoreGive(s_life_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_external) {
+        audio_latency_report_add(report, "duplex src", s_external_latency_us);
+    } else if (s_graph) {
+        // 处理图没有环形缓冲区：DMA描述符恰为一个节拍，节拍内同步跑完转换与重采样
+        const audio_latency_profile_t *profile = audio_latency_get_profile();
+        audio_latency_report_add(report, "i2s dma", (uint32_t)((uint64_t)profile->i2s_dma_desc_num * s_graph->in_block *
+                                                               1000000 / s_link.src.rate));
+        if (capture_resampling()) {
+            audio_latency_report_add(report, "resample", POLYPHASE_RSP_TAPS / 2 * 1000000 / s_link.src.rate);
+        }
+    } else {
+        // I2S读取元素输出为24位数据扩展的32位字
+        audio_latency_report_add_dma(report, "i2s dma", s_link.src.rate);
+        audio_latency_report_add_ringbuf(report, "i2s rb", s_i2s, s_link.src.rate * 4);
+        if (capture_resampling()) {
+            audio_latency_report_add(report, "resample", POLYPHASE_RSP_TAPS / 2 * 1000000 / s_link.src.rate);
+        }
+        audio_latency_report_add_ringbuf(report, "resample rb", s_filter, AUDIO_CAPTURE_SAMPLE_RATE * 2);
+    }
+    uint32_t block_us = s_block_samples * 1000000 / AUDIO_CAPTURE_SAMPLE_RATE;
+    audio_latency_report_add(report, "fanout", block_us + audio_fanout_queued(client->consumer) * block_us);
+    xSemaphoreGive(s_life_lock);
+    return ESP_OK;
+}
+
+/* ------------------------------------------------------------------ */
+/* 外部数据源                                                          */
+/* ------------------------------------------------------------------ */
+
+esp_err_t audio_capture_attach_source(uint32_t source_latency_us)
+{
+    capture_locks_init();
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    if (s_clients || s_external) {
+        xSemaphoreGive(s_life_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    memset(&s_ext_sink, 0, sizeof(s_ext_sink));
+    s_external_latency_us = source_latency_us;
+    s_external = true;
+    xSemaphoreGive(s_life_lock);
+    ESP_LOGI(TAG, "Capture attached to external source");
+    return ESP_OK;
+}
+
+void audio_capture_detach_source(void)
+{
+    capture_locks_init();
+    xSemaphoreTake(s_life_lock, portMAX_DELAY);
+    if (s_clients == 0) {
+        s_external = false;
+    } else {
+        ESP_LOGW(TAG, "detach with %u clients ignored", (unsigned)s_clients);
+    }
+    xSemaphoreGive(s_life_lock);
+}
+
+void audio_capture_feed(const int16_t *samples, size_t count, uint32_t timestamp)
+{
+    if (!s_external || !samples) {
+        return;
+    }
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    if (s_fanout) {
+        if (!s_ext_sink.cur) {
+            s_ext_sink.timestamp = timestamp;
+        }
+        capture_sink_feed(&s_ext_sink, samples, (int)count);
+    }
+    xSemaphoreGive(s_table_lock);
+}
+
+/* ------------------------------------------------------------------ */
+/* 读取元素：订阅块 -> 下游管道                                        */
+/* ------------------------------------------------------------------ */
+
+static esp_err_t _capture_reader_open(audio_element_handle_t self)
+{
+    audio_capture_client_t *client = (audio_capture_client_t *)audio_element_getdata(self);
+    client->probe = audio_probe_get(audio_element_get_tag(self));
+
+    audio_element_info_t info = {0};
+    audio_element_getinfo(self, &info);
+    info.sample_rates = AUDIO_CAPTURE_SAMPLE_RATE;
+    info.channels = 1;
+    info.bits = 16;
+    audio_element_setinfo(self, &info);
+    audio_element_report_info(self);
+    return ESP_OK;
+}
+
+static audio_element_err_t _capture_reader_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    audio_capture_client_t *client = (audio_capture_client_t *)audio_element_getdata(self);
+    const audio_block_t *blk = audio_capture_pull(client, AUDIO_CAPTURE_BLOCK_MS * 2);
+    if (!blk) {
+        return AEL_IO_TIMEOUT;
+    }
+    if (client->lifecycle) {
+        audio_lifecycle_data(client->lifecycle);
+    }
+    // 读取元素本身只做拷贝，探针主要用于记录块数与下游环形缓冲区水位
+    audio_probe_end(client->probe, audio_probe_begin(client->probe, self));
+    int ret = audio_element_output(self, (char *)blk->samples, blk->count * sizeof(int16_t));
+    audio_capture_release(client, blk);
+    return ret;
+}
+
+static esp_err_t _capture_reader_close(audio_element_handle_t self)
+{
+    // 丢弃停止期间积压的块，恢复时从最新数据开始
+    audio_capture_client_t *client = (audio_capture_client_t *)audio_element_getdata(self);
+    const audio_block_t *blk;
+    while (client->consumer && (blk = audio_fanout_pull(client->consumer)) != NULL) {
+        audio_capture_release(client, blk);
+    }
+    return ESP_OK;
+}
+
+audio_element_handle_t audio_capture_reader_init(audio_capture_reader_cfg_t *config)
+{
+    if (config == NULL || config->client == NULL) {
+        ESP_LOGE(TAG, "reader config or client is NULL");
+        return NULL;
+    }
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = _capture_reader_open;
+    cfg.close = _capture_reader_close;
+    cfg.process = _capture_reader_process;
+    cfg.buffer_len = AUDIO_CAPTURE_BLOCK_SAMPLES * sizeof(int16_t);
+    cfg.out_rb_size = config->out_rb_size;
+    cfg.task_stack = config->task_stack;
+    cfg.task_core = config->task_core;
+    cfg.task_prio = config->task_prio;
+    cfg.stack_in_ext = config->stack_in_ext;
+    cfg.tag = "capture_reader";
+
+    audio_element_handle_t el = audio_element_init(&cfg);
+    AUDIO_MEM_CHECK(TAG, el, return NULL);
+    config->client->lifecycle = config->lifecycle;
+    audio_element_setdata(el, config->client);
+    return el;
+}
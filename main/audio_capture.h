@@ -0,0 +1,213 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 13:00:00
+ * @LastEditTime: 2026-10-16 13:00:00
+ * @LastEditors: 星年
+ * @Description: 共享采集前端：独占I2S输入并完成44.1kHz->16kHz重采样，以引用计数PCM块扇出给多个消费者
+ * @FilePath: \audio_manager\main\audio_capture.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_element.h"
+#include "audio_fanout.h"
+#include "audio_latency.h"
+#include "audio_lifecycle.h"
+#include "audio_graph.h"
+#include "audio_format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_CAPTURE_SAMPLE_RATE       (16000)         // 发布的PCM采样率
+#define AUDIO_CAPTURE_BLOCK_MS          (20)            // 最长块时长，实际块长取延迟档位的Opus帧长（不超过此值）
+#define AUDIO_CAPTURE_BLOCK_SAMPLES     (AUDIO_CAPTURE_SAMPLE_RATE * AUDIO_CAPTURE_BLOCK_MS / 1000)
+#define AUDIO_CAPTURE_BLOCK_COUNT       (12)            // 块池大小，总计 12 * 640B
+#define AUDIO_CAPTURE_DEFAULT_DEPTH     (4)             // 默认消费者队列深度（块）
+#define AUDIO_CAPTURE_WAIT_FOREVER      UINT32_MAX      // 一直等待直到有块
+#define AUDIO_CAPTURE_GAIN_Q12          (4096)          // 麦克风固定增益（Q12，4096 = 0dB），在格式转换中一并完成
+#define AUDIO_CAPTURE_DC_SHIFT          (10)            // 去直流反馈系数 2^-10，44.1kHz下约7Hz、16kHz下约2.5Hz
+
+#define AUDIO_CAPTURE_GRAPH_TASK_STACK  (3 * 1024)      // 处理图引擎任务堆栈（替代 i2s/重采样/扇出三个元素任务）
+
+#define AUDIO_CAPTURE_READER_RINGBUFFER (2 * 1024)      // 读取元素输出环形缓冲区大小
+#define AUDIO_CAPTURE_READER_TASK_STACK (3 * 1024)      // 读取元素任务堆栈
+#define AUDIO_CAPTURE_READER_TASK_CORE  (0)             // 读取元素任务绑定核心
+#define AUDIO_CAPTURE_READER_TASK_PRIO  (5)             // 读取元素任务优先级
+
+typedef struct audio_capture_client audio_capture_client_t;
+
+/**
+ * @brief 订阅采集数据
+ *
+ * 第一个订阅者会启动采集管道 [i2s] -> [filter] -> [fanout]，之后的订阅者直接共享同一份数据。
+ *
+ * @param depth 该订阅者的队列深度（块），处理过慢时只丢弃该订阅者自己的块
+ * @return 订阅句柄，失败返回NULL
+ */
+audio_capture_client_t *audio_capture_subscribe(uint32_t depth);
+
+/**
+ * @brief 取消订阅，最后一个订阅者取消时停止采集并释放I2S
+ *
+ * 调用前须已归还所有通过 audio_capture_pull() 取得的块。
+ */
+void audio_capture_unsubscribe(audio_capture_client_t *client);
+
+/**
+ * @brief 暂停/恢复某个订阅者接收数据，订阅本身保留
+ *
+ * 暂停时注销其扇出消费者并释放队列中的块；所有订阅者都暂停时采集管道随之暂停（同步握手并冲刷），
+ * I2S驱动、元素任务与缓冲区全部保留。恢复时重新占用消费者槽位，整个过程不分配内存。
+ * 暂停前须先停止读取（如先暂停读取元素所在的管道），并已归还所有取得的块。
+ *
+ * @param client 订阅句柄
+ * @param active true 恢复接收，false 暂停
+ * @return ESP_OK，恢复时消费者槽位已被占满返回 ESP_ERR_NO_MEM
+ */
+esp_err_t audio_capture_set_active(audio_capture_client_t *client, bool active);
+
+/**
+ * @brief 取出下一块16kHz 16位单声道PCM（零拷贝，与其他订阅者共享）
+ *
+ * @param client     订阅句柄
+ * @param timeout_ms 最长等待时间（毫秒），AUDIO_CAPTURE_WAIT_FOREVER 表示一直等待
+ * @return 只读块，超时或订阅者已暂停返回NULL；使用完毕须调用 audio_capture_release()
+ */
+const audio_block_t *audio_capture_pull(audio_capture_client_t *client, uint32_t timeout_ms);
+
+/**
+ * @brief 让正在 audio_capture_pull() 中等待的调用者立即返回NULL（用于同步暂停，不必等下一个块或超时）
+ *
+ * 调用时没有人在等待，则下一次需要等待的 pull 直接返回NULL。
+ */
+void audio_capture_wake(audio_capture_client_t *client);
+
+/**
+ * @brief 归还由 audio_capture_pull() 取得的块
+ */
+void audio_capture_release(audio_capture_client_t *client, const audio_block_t *blk);
+
+/**
+ * @brief 该订阅者因处理过慢被丢弃的块数
+ */
+uint32_t audio_capture_overruns(const audio_capture_client_t *client);
+
+/**
+ * @brief 追加采集前端各级的缓冲延迟（I2S DMA、I2S环形缓冲区、重采样、扇出队列）
+ *
+ * @return ESP_OK，采集未运行返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t audio_capture_get_latency(const audio_capture_client_t *client, audio_latency_report_t *report);
+
+/**
+ * @brief 选择采集前端的执行引擎，下次创建采集管道时生效（运行中不切换）
+ *
+ * AUDIO_ENGINE_ADF：[i2s] -> [filter] -> [fanout] 三个元素任务，经两个环形缓冲区；
+ * AUDIO_ENGINE_GRAPH：一个任务以RX DMA完成为节拍，同步跑完 [转换] -> [重采样] -> [扇出]
+ * （协商为直采时没有重采样节点），
+ * 缓冲区按指针传递，DMA描述符恰为一个节拍。外部数据源接管时两者都不创建。
+ */
+void audio_capture_set_engine(audio_engine_t engine);
+
+/**
+ * @brief 声明麦克风支持的格式，下次创建采集管道时参与协商（运行中不切换）
+ *
+ * 采集管道创建时以麦克风格式为源、发布格式（audio_capture_get_caps()）为宿协商I2S采样率：
+ * 麦克风支持16kHz时直接以16kHz采集，只做格式转换；否则以44.1kHz采集再经多相重采样。
+ * 默认按INMP441（SCK 0.5~3.2MHz、64 SCK/帧，即约7.8kHz~50kHz，24-in-32位单声道）。
+ *
+ * @param caps 麦克风格式集合，NULL 恢复默认
+ */
+void audio_capture_set_mic_caps(const audio_caps_t *caps);
+
+/**
+ * @brief 采集前端发布的格式集合（16kHz 16位单声道），供下游元素协商
+ */
+const audio_caps_t *audio_capture_get_caps(void);
+
+/**
+ * @brief 获取发布块长（16kHz样点数，按延迟档位取帧长，最长 AUDIO_CAPTURE_BLOCK_SAMPLES）
+ *
+ * @return 样点数，采集从未启动过返回0
+ */
+uint32_t audio_capture_block_samples(void);
+
+/**
+ * @brief 获取当前采集链路的协商结果（麦克风工作格式、发布格式、采用的转换器）
+ *
+ * @return ESP_OK，未以I2S采集运行（未订阅或外部数据源接管）返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t audio_capture_get_link(audio_format_link_t *link);
+
+/**
+ * @brief 获取处理图引擎的统计（各节点调用次数与耗时、节拍超时）
+ *
+ * @param stats 整图统计，可为NULL
+ * @param nodes 节点统计数组，可为NULL
+ * @param max   nodes 容量
+ * @return 写入 nodes 的条目数，未以处理图运行返回-1
+ */
+int audio_capture_get_graph_stats(audio_graph_stats_t *stats, audio_graph_node_stats_t *nodes, int max);
+
+/**
+ * @brief 由外部数据源接管采集（如全双工引擎），之后订阅不再创建I2S采集管道
+ *
+ * 须在没有订阅者时调用。外部源通过 audio_capture_feed() 按节拍送入16kHz 16位单声道PCM。
+ *
+ * @param source_latency_us 外部源自身的缓冲延迟，计入 audio_capture_get_latency()
+ * @return ESP_OK，已有订阅者或已接管返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t audio_capture_attach_source(uint32_t source_latency_us);
+
+/**
+ * @brief 外部数据源退出，之后订阅恢复创建I2S采集管道（须在没有订阅者时调用）
+ */
+void audio_capture_detach_source(void);
+
+/**
+ * @brief 外部数据源送入PCM，切块后发布给所有订阅者；没有订阅者时直接丢弃
+ *
+ * @param samples   16位单声道样点
+ * @param count     样点数
+ * @param timestamp 首样点的采样计数
+ */
+void audio_capture_feed(const int16_t *samples, size_t count, uint32_t timestamp);
+
+/**
+ * @brief 采集读取元素配置（管道首元素，输入取自订阅，不需要输入环形缓冲区）
+ */
+typedef struct {
+    audio_capture_client_t *client;     // 订阅句柄（由调用者订阅与取消）
+    audio_lifecycle_t *lifecycle;       // 所属管道的生命周期，用于记录启动到首块数据的耗时（可为NULL）
+    int  out_rb_size;                   // 输出环形缓冲区大小
+    int  task_stack;                    // 任务堆栈大小
+    int  task_core;                     // 任务绑定核心
+    int  task_prio;                     // 任务优先级
+    bool stack_in_ext;                  // 堆栈是否放在外部RAM
+} audio_capture_reader_cfg_t;
+
+#define DEFAULT_AUDIO_CAPTURE_READER_CONFIG() {         \
+    .client       = NULL,                               \
+    .lifecycle    = NULL,                               \
+    .out_rb_size  = AUDIO_CAPTURE_READER_RINGBUFFER,    \
+    .task_stack   = AUDIO_CAPTURE_READER_TASK_STACK,    \
+    .task_core    = AUDIO_CAPTURE_READER_TASK_CORE,     \
+    .task_prio    = AUDIO_CAPTURE_READER_TASK_PRIO,     \
+    .stack_in_ext = false,                              \
+}
+
+/**
+ * @brief 创建采集读取元素，把订阅到的PCM块送入下游管道（替代各管道自己的 i2s_stream reader）
+ *
+ * @param config 元素配置
+ * @return 元素句柄，失败返回NULL
+ */
+audio_element_handle_t audio_capture_reader_init(audio_capture_reader_cfg_t *config);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,370 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 16:00:00
+ * @LastEditTime: 2026-10-16 16:00:00
+ * @LastEditors: 星年
+ * @Description: 全双工音频引擎实现：I2S0 TX+RX 共用时钟，节拍任务以RX DMA完成为节拍，同一节拍内完成采集发布与播放写入
+ * @FilePath: \audio_manager\main\audio_duplex.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "driver/i2s_std.h"
+#include "audio_mem.h"
+#include "audio_error.h"
+#include "audio_capture.h"
+#include "capture_convert.h"
+#include "audio_probe.h"
+#include "audio_arena.h"
+#include "audio_duplex.h"
+
+static const char *TAG = "AUDIO_DUPLEX";
+
+#define AUDIO_DUPLEX_ACK_MS 100     // 节拍任务确认回调切换/退出的等待上限（远大于一个节拍）
+
+/**
+ * @brief 节拍回调与上下文，作为一个整体按指针发布，节拍任务不会看到新回调配旧上下文
+ */
+typedef struct {
+    audio_duplex_tap_t fn;
+    void *ctx;
+} audio_duplex_tap_slot_t;
+
+typedef struct {
+    i2s_chan_handle_t tx;               // 播放通道
+    i2s_chan_handle_t rx;               // 采集通道
+    ringbuf_handle_t play_rb;           // 播放环形缓冲区（解码元素输出）
+    int32_t *rx_buf;                    // I2S读取缓冲区（32位槽）
+    int32_t *tx_buf;                    // I2S写入缓冲区（32位槽）
+    int16_t *mic;                       // 本节拍采集样点
+    capture_conv_t conv;                // 采集格式转换（去直流/增益）
+    int16_t *ref_hist;                  // 播放参考延迟线：ref_depth+1 个块
+    uint32_t block;                     // 每节拍样点数
+    uint32_t ref_depth;                 // TX DMA排队深度（块）
+    uint32_t ref_pos;                   // 延迟线写位置（块）
+    uint32_t timestamp;                 // 下一节拍首样点的采样计数
+    audio_duplex_tap_slot_t tap_slots[2];       // 回调双缓冲：只改写未发布的一份，旧的一份在节拍边界确认后才复用
+    _Atomic(audio_duplex_tap_slot_t *) tap;     // 当前节拍回调（NULL为无）
+    atomic_bool tap_sync;                       // 请求节拍任务在下一个节拍边界给出确认
+    audio_probe_t *probe;               // 性能探针
+    audio_duplex_stats_t stats;         // 统计
+} audio_duplex_t;
+
+static audio_duplex_t *s_duplex = NULL;
+static audio_arena_t *s_arena = NULL;       // 节拍缓冲内存区（首次启动时预留，停止后回卷复用）
+static TaskHandle_t s_task = NULL;
+static volatile bool s_running = false;
+static StaticSemaphore_t s_ack_buf;
+static SemaphoreHandle_t s_ack = NULL;      // 节拍任务已越过节拍边界或已退出（二值信号量）
+
+static void audio_duplex_free(audio_duplex_t *d)
+{
+    if (d->tx) {
+        i2s_del_channel(d->tx);
+    }
+    if (d->rx) {
+        i2s_del_channel(d->rx);
+    }
+    if (d->play_rb) {
+        rb_destroy(d->play_rb);
+    }
+    audio_arena_free(s_arena, d->rx_buf);
+    audio_arena_free(s_arena, d->tx_buf);
+    audio_arena_free(s_arena, d->mic);
+    audio_arena_free(s_arena, d->ref_hist);
+    audio_arena_free(s_arena, d);
+    audio_arena_reset(s_arena);
+}
+
+/**
+ * @brief 取一块播放数据，不足部分补静音；返回是否欠载
+ */
+static bool audio_duplex_pull_playback(audio_duplex_t *d, int16_t *out)
+{
+    int want = d->block * sizeof(int16_t);
+    int filled = rb_bytes_filled(d->play_rb);
+    int got = 0;
+    if (filled > 0) {
+        got = rb_read(d->play_rb, (char *)out, filled < want ? filled : want, 0);
+        if (got < 0) {
+            got = 0;
+        }
+    }
+    if (got < want) {
+        memset((char *)out + got, 0, want - got);
+        return true;
+    }
+    return false;
+}
+
+static void audio_duplex_task(void *arg)
+{
+    audio_duplex_t *d = (audio_duplex_t *)arg;
+    size_t bytes = d->block * sizeof(int32_t);
+    // 一个节拍的超时：两个块时长，至少10ms
+    uint32_t timeout_ms = d->block * 2000 / AUDIO_DUPLEX_SAMPLE_RATE;
+    if (timeout_ms < 10) {
+        timeout_ms = 10;
+    }
+
+    while (s_running) {
+        // 0. 节拍边界：上一节拍的回调已经返回，确认回调切换
+        if (atomic_exchange(&d->tap_sync, false)) {
+            xSemaphoreGive(s_ack);
+        }
+
+        // 1. 等待RX DMA完成一个块，作为本节拍
+        size_t n = 0;
+        if (i2s_channel_read(d->rx, d->rx_buf, bytes, &n, timeout_ms) != ESP_OK || n != bytes) {
+            d->stats.rx_errors++;
+            continue;
+        }
+        uint32_t stamp = audio_probe_begin(d->probe, NULL);
+
+        // 2. 取本节拍要写出的播放块，放入参考延迟线
+        int16_t *play = d->ref_hist + d->ref_pos * d->block;
+        if (audio_duplex_pull_playback(d, play)) {
+            d->stats.play_underruns++;
+        }
+        // 此刻正从功放输出的是 ref_depth 个节拍之前写入的块
+        uint32_t ref_idx = (d->ref_pos + 1) % (d->ref_depth + 1);
+        const int16_t *ref = d->ref_hist + ref_idx * d->block;
+        d->ref_pos = ref_idx;
+
+        // 3. INMP441 24位数据位于32位槽的高位，一次遍历完成取位/去直流/增益/饱和
+        capture_conv_s16(&d->conv, d->rx_buf, d->mic, d->block);
+        for (uint32_t i = 0; i < d->block; i++) {
+            d->tx_buf[i] = (int32_t)play[i] * 65536;   // 16位样点放到32位槽高位（负数不能左移）
+        }
+        audio_duplex_tap_slot_t *tap = atomic_load(&d->tap);
+        if (tap) {
+            tap->fn(d->mic, ref, d->block, d->timestamp, tap->ctx);
+        }
+        audio_capture_feed(d->mic, d->block, d->timestamp);
+        audio_probe_end(d->probe, stamp);
+
+        // 4. 写出播放块：RX刚取走一块，TX同时送出一块，DMA队列中恰有空位
+        if (i2s_channel_write(d->tx, d->tx_buf, bytes, &n, timeout_ms) != ESP_OK || n != bytes) {
+            d->stats.tx_errors++;
+        }
+        d->timestamp += d->block;
+        d->stats.ticks++;
+    }
+    s_task = NULL;
+    xSemaphoreGive(s_ack);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t audio_duplex_i2s_init(audio_duplex_t *d)
+{
+    // 同一控制器创建TX+RX，两者共用BCLK/WS，采集与播放天然同源同相
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(AUDIO_DUPLEX_I2S_PORT, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = d->ref_depth;
+    chan_cfg.dma_frame_num = d->block;
+    chan_cfg.auto_clear = true;         // TX欠载时输出静音而不是重复旧数据
+    esp_err_t ret = i2s_new_channel(&chan_cfg, &d->tx, &d->rx);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // 收发使用相同的时钟与槽配置：32位槽、左声道单声道
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(AUDIO_DUPLEX_SAMPLE_RATE),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = AUDIO_DUPLEX_BCK_IO,
+            .ws = AUDIO_DUPLEX_WS_IO,
+            .dout = AUDIO_DUPLEX_DOUT_IO,
+            .din = AUDIO_DUPLEX_DIN_IO,
+        },
+    };
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+    ret = i2s_channel_init_std_mode(d->tx, &std_cfg);
+    if (ret == ESP_OK) {
+        ret = i2s_channel_init_std_mode(d->rx, &std_cfg);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // TX DMA预先填满静音，使播放写入到输出的延迟固定为 ref_depth 个块
+    memset(d->tx_buf, 0, d->block * sizeof(int32_t));
+    for (uint32_t i = 0; i < d->ref_depth; i++) {
+        size_t loaded = 0;
+        i2s_channel_preload_data(d->tx, d->tx_buf, d->block * sizeof(int32_t), &loaded);
+    }
+    ret = i2s_channel_enable(d->tx);
+    if (ret == ESP_OK) {
+        ret = i2s_channel_enable(d->rx);
+    }
+    return ret;
+}
+
+esp_err_t audio_duplex_start(void)
+{
+    if (s_duplex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const audio_latency_profile_t *profile = audio_latency_get_profile();
+
+    // 节拍长度与采集块长一致（档位帧长，最长20ms），每个DMA描述符恰好一个节拍
+    uint32_t frame = audio_latency_frame_samples(AUDIO_DUPLEX_SAMPLE_RATE);
+    uint32_t block = frame > AUDIO_CAPTURE_BLOCK_SAMPLES ? AUDIO_CAPTURE_BLOCK_SAMPLES : frame;
+    uint32_t ref_depth = profile->i2s_dma_desc_num;
+    uint32_t rx_words = block + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t);
+
+    // 节拍缓冲每个节拍都要读写，全部放片内SRAM，预算按档位精确计算
+    audio_arena_cfg_t arena_cfg = {
+        .name = "duplex",
+        .internal_bytes = AUDIO_ARENA_SIZE(sizeof(audio_duplex_t)) + AUDIO_ARENA_SIZE(rx_words * sizeof(int32_t)) +
+                          AUDIO_ARENA_SIZE(block * sizeof(int32_t)) + AUDIO_ARENA_SIZE(block * sizeof(int16_t)) +
+                          AUDIO_ARENA_SIZE((ref_depth + 1) * block * sizeof(int16_t)),
+        .psram_bytes = 0,
+    };
+    if (audio_arena_ensure(&s_arena, &arena_cfg) != 0) {
+        ESP_LOGE(TAG, "Failed to reserve duplex arena");
+        return ESP_ERR_NO_MEM;
+    }
+    audio_arena_set_owner(s_arena, "duplex");
+    audio_duplex_t *d = (audio_duplex_t *)audio_arena_calloc(s_arena, 1, sizeof(audio_duplex_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, d, return ESP_ERR_NO_MEM);
+    d->block = block;
+    d->ref_depth = ref_depth;
+    // 播放环形缓冲区须容纳解码端保持的帧数，长帧时按帧长放大
+    uint32_t play_blocks = (3 * frame + d->block - 1) / d->block;
+    if (play_blocks < AUDIO_DUPLEX_PLAY_RB_FRAMES) {
+        play_blocks = AUDIO_DUPLEX_PLAY_RB_FRAMES;
+    }
+    // 转换内核会越过末尾预取，读取缓冲区尾部留出填充
+    d->rx_buf = (int32_t *)audio_arena_calloc(s_arena, rx_words, sizeof(int32_t), AUDIO_ARENA_INTERNAL);
+    d->tx_buf = (int32_t *)audio_arena_calloc(s_arena, d->block, sizeof(int32_t), AUDIO_ARENA_INTERNAL);
+    d->mic = (int16_t *)audio_arena_calloc(s_arena, d->block, sizeof(int16_t), AUDIO_ARENA_INTERNAL);
+    d->ref_hist = (int16_t *)audio_arena_calloc(s_arena, (d->ref_depth + 1) * d->block, sizeof(int16_t), AUDIO_ARENA_INTERNAL);
+    audio_arena_set_owner(s_arena, NULL);
+    d->play_rb = rb_create(d->block * sizeof(int16_t), play_blocks);
+    AUDIO_MEM_CHECK(TAG, d->rx_buf && d->tx_buf && d->mic && d->ref_hist && d->play_rb, {
+        audio_duplex_free(d);
+        return ESP_ERR_NO_MEM;
+    });
+    capture_conv_cfg_t conv_cfg = {
+        .gain_q12 = AUDIO_CAPTURE_GAIN_Q12,
+        .dc_shift = AUDIO_CAPTURE_DC_SHIFT,
+    };
+    capture_conv_init(&d->conv, &conv_cfg);
+    d->probe = audio_probe_get("duplex");
+    d->stats.block_samples = d->block;
+    d->stats.ref_delay_samples = d->ref_depth * d->block;
+
+    esp_err_t ret = audio_duplex_i2s_init(d);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2S full-duplex init failed: %s", esp_err_to_name(ret));
+        audio_duplex_free(d);
+        return ret;
+    }
+    // 采集前端改由本引擎供数，上报的源延迟为RX DMA深度
+    uint32_t dma_us = (uint32_t)((uint64_t)d->ref_depth * d->block * 1000000 / AUDIO_DUPLEX_SAMPLE_RATE);
+    ret = audio_capture_attach_source(dma_us);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "capture already running, start duplex before subscribers");
+        i2s_channel_disable(d->rx);
+        i2s_channel_disable(d->tx);
+        audio_duplex_free(d);
+        return ret;
+    }
+
+    atomic_init(&d->tap, NULL);
+    atomic_init(&d->tap_sync, false);
+    if (!s_ack) {
+        s_ack = xSemaphoreCreateBinaryStatic(&s_ack_buf);
+    }
+    xSemaphoreTake(s_ack, 0);
+    s_duplex = d;
+    s_running = true;
+    if (xTaskCreatePinnedToCore(audio_duplex_task, "audio_duplex", AUDIO_DUPLEX_TASK_STACK, d,
+                                profile->task_prio, &s_task, profile->capture_core) != pdPASS) {
+        s_running = false;
+        s_duplex = NULL;
+        audio_capture_detach_source();
+        i2s_channel_disable(d->rx);
+        i2s_channel_disable(d->tx);
+        audio_duplex_free(d);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "full-duplex started: %u Hz, tick %u samples, tx depth %u",
+             AUDIO_DUPLEX_SAMPLE_RATE, (unsigned)d->block, (unsigned)d->ref_depth);
+    return ESP_OK;
+}
+
+void audio_duplex_stop(void)
+{
+    audio_duplex_t *d = s_duplex;
+    if (!d) {
+        return;
+    }
+    s_running = false;
+    // 节拍任务每个节拍检查一次运行标志，最长一次I2S读取超时后退出并给出确认；以任务句柄清空为准
+    while (s_task) {
+        if (xSemaphoreTake(s_ack, pdMS_TO_TICKS(AUDIO_DUPLEX_ACK_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "waiting for duplex task to exit");
+        }
+    }
+    audio_capture_detach_source();
+    i2s_channel_disable(d->rx);
+    i2s_channel_disable(d->tx);
+    s_duplex = NULL;
+    audio_duplex_free(d);
+    ESP_LOGI(TAG, "full-duplex stopped");
+}
+
+bool audio_duplex_is_running(void)
+{
+    return s_duplex != NULL;
+}
+
+ringbuf_handle_t audio_duplex_get_playback_rb(void)
+{
+    return s_duplex ? s_duplex->play_rb : NULL;
+}
+
+esp_err_t audio_duplex_set_tap(audio_duplex_tap_t tap, void *ctx)
+{
+    audio_duplex_t *d = s_duplex;
+    if (!d) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    audio_duplex_tap_slot_t *cur = atomic_load(&d->tap);
+    audio_duplex_tap_slot_t *next = NULL;
+    if (tap) {
+        next = &d->tap_slots[cur == &d->tap_slots[0] ? 1 : 0];
+        next->fn = tap;
+        next->ctx = ctx;
+    }
+    xSemaphoreTake(s_ack, 0);           // 清掉迟到的确认
+    atomic_store(&d->tap, next);
+    atomic_store(&d->tap_sync, true);
+    // 等节拍任务越过下一个节拍边界（或退出）：此后旧回调不会再被调用，旧上下文可以释放
+    while (s_task) {
+        if (xSemaphoreTake(s_ack, pdMS_TO_TICKS(AUDIO_DUPLEX_ACK_MS)) == pdTRUE) {
+            break;
+        }
+        ESP_LOGW(TAG, "waiting for duplex tick to release the tap");
+    }
+    return ESP_OK;
+}
+
+esp_err_t audio_duplex_get_stats(audio_duplex_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_duplex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *stats = s_duplex->stats;
+    return ESP_OK;
+}
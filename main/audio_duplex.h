@@ -0,0 +1,110 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 16:00:00
+ * @LastEditTime: 2026-10-16 16:00:00
+ * @LastEditors: 星年
+ * @Description: 全双工音频引擎：单个I2S控制器同时收发，共用BCLK/WS，由一个DMA节拍任务同步驱动采集与播放
+ * @FilePath: \audio_manager\main\audio_duplex.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "ringbuf.h"
+#include "audio_latency.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 全双工接线：麦克风与功放共用 BCLK/WS（I2S0 主模式输出），
+ * 麦克风 SD 接 DIN，功放 DIN 接 DOUT。
+ */
+#define AUDIO_DUPLEX_I2S_PORT       I2S_NUM_0
+#define AUDIO_DUPLEX_BCK_IO         41          // 共用BCLK
+#define AUDIO_DUPLEX_WS_IO          42          // 共用WS
+#define AUDIO_DUPLEX_DIN_IO         2           // 麦克风数据
+#define AUDIO_DUPLEX_DOUT_IO        4           // 功放数据
+#define AUDIO_DUPLEX_SAMPLE_RATE    (16000)     // 收发共用采样率（与采集发布、解码输出一致，无需重采样）
+#define AUDIO_DUPLEX_TASK_STACK     (4 * 1024)  // 节拍任务堆栈
+#define AUDIO_DUPLEX_PLAY_RB_FRAMES (4)         // 播放环形缓冲区最少容量（节拍块数），另保证能容纳3个Opus帧
+
+/**
+ * @brief 节拍回调：每个节拍在发布采集数据前调用一次
+ *
+ * mic 与 ref 样点对齐：ref 是与 mic 同一时刻从功放输出的播放样点（已扣除TX DMA排队深度），
+ * 回调可原地修改 mic（如回声消除），修改后的数据才会发布给采集订阅者。
+ * 回调在节拍任务中执行，耗时须小于一个节拍。
+ *
+ * @param mic       本节拍采集的16位样点（可修改）
+ * @param ref       同一时刻输出的播放参考样点
+ * @param samples   样点数
+ * @param timestamp 首样点的采样计数
+ * @param ctx       用户上下文
+ */
+typedef void (*audio_duplex_tap_t)(int16_t *mic, const int16_t *ref, size_t samples, uint32_t timestamp, void *ctx);
+
+/**
+ * @brief 引擎统计
+ */
+typedef struct {
+    uint32_t ticks;             // 已运行节拍数
+    uint32_t block_samples;     // 每节拍样点数
+    uint32_t play_underruns;    // 播放数据不足、以静音补齐的节拍数
+    uint32_t rx_errors;         // I2S读取失败或超时次数
+    uint32_t tx_errors;         // I2S写入失败或超时次数
+    uint32_t ref_delay_samples; // 播放样点写入到实际输出的固定延迟（TX DMA深度）
+} audio_duplex_stats_t;
+
+/**
+ * @brief 启动全双工引擎
+ *
+ * 需在启动采集订阅者与解码播放之前调用。启动后共享采集前端改由本引擎供数，
+ * 解码播放改为写入本引擎的播放环形缓冲区，不再各自创建I2S。
+ * 节拍长度取当前延迟档位的Opus帧长（最长20ms），DMA描述符数取档位配置。
+ *
+ * @return ESP_OK，已启动返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t audio_duplex_start(void);
+
+/**
+ * @brief 停止全双工引擎并释放I2S（须先停止解码播放与所有采集订阅者）
+ */
+void audio_duplex_stop(void);
+
+/**
+ * @brief 引擎是否在运行
+ */
+bool audio_duplex_is_running(void);
+
+/**
+ * @brief 播放环形缓冲区，解码元素将其设为输出环形缓冲区，节拍任务每个节拍取一块
+ *
+ * @return 环形缓冲区，未运行返回NULL
+ */
+ringbuf_handle_t audio_duplex_get_playback_rb(void);
+
+/**
+ * @brief 设置节拍回调（NULL取消），用于回声消除等需要对齐参考信号的处理
+ *
+ * 回调与上下文作为一对原子地换上。返回前等节拍任务越过下一个节拍边界：
+ * 返回后旧回调不会再被调用，其上下文可以释放。须在同一个控制任务中调用，不可在回调内调用。
+ *
+ * @return ESP_OK，引擎未运行返回 ESP_ERR_INVALID_STATE（此时也不会有回调）
+ */
+esp_err_t audio_duplex_set_tap(audio_duplex_tap_t tap, void *ctx);
+
+/**
+ * @brief 获取引擎统计
+ *
+ * @return ESP_OK，未运行返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t audio_duplex_get_stats(audio_duplex_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,197 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 13:00:00
+ * @LastEditTime: 2026-10-16 13:00:00
+ * @LastEditors: 星年
+ * @Description: PCM块扇出实现，块引用计数与空闲掩码均为原子操作，每个消费者一个单生产者/单消费者队列
+ * @FilePath: \audio_manager\main\audio_fanout.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "audio_fanout.h"
+
+struct audio_fanout_consumer {
+    audio_fanout_t *owner;                      // 所属扇出
+    bool active;                                // 是否已注册（由调用者串行化修改）
+    uint32_t mask;                              // 队列深度 - 1
+    _Atomic uint32_t head;                      // 生产者下标
+    _Atomic uint32_t tail;                      // 消费者下标
+    uint8_t queue[AUDIO_FANOUT_MAX_BLOCKS];     // 块下标队列
+    _Atomic uint32_t overruns;                  // 队列满丢弃的块数
+    audio_fanout_notify_t notify;               // 通知回调
+    void *notify_ctx;                           // 通知回调上下文
+};
+
+struct audio_fanout {
+    audio_arena_t *arena;                                       // 所属内存区（NULL为堆）
+    audio_block_t blocks[AUDIO_FANOUT_MAX_BLOCKS];              // 块描述
+    _Atomic uint32_t refs[AUDIO_FANOUT_MAX_BLOCKS];             // 块引用计数
+    _Atomic uint32_t free_mask;                                 // 空闲块掩码
+    int16_t *mem;                                               // 样点数据区
+    uint32_t seq;                                               // 下一个发布序号
+    audio_fanout_consumer_t consumers[AUDIO_FANOUT_MAX_CONSUMERS];
+};
+
+audio_fanout_t *audio_fanout_create(audio_arena_t *arena, uint32_t block_count, uint32_t block_samples)
+{
+    if (block_count == 0 || block_count > AUDIO_FANOUT_MAX_BLOCKS || block_samples == 0 || block_samples > UINT16_MAX) {
+        return NULL;
+    }
+    // 引用计数与队列在片内；块数据区由生产者整块写入、消费者整块读出，放PSRAM
+    audio_fanout_t *fo = audio_arena_calloc(arena, 1, sizeof(audio_fanout_t), AUDIO_ARENA_INTERNAL);
+    if (!fo) {
+        return NULL;
+    }
+    fo->arena = arena;
+    fo->mem = audio_arena_calloc(arena, (size_t)block_count * block_samples, sizeof(int16_t), AUDIO_ARENA_PSRAM);
+    if (!fo->mem) {
+        audio_arena_free(arena, fo);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < block_count; i++) {
+        fo->blocks[i].samples = fo->mem + (size_t)i * block_samples;
+        fo->blocks[i].cap = (uint16_t)block_samples;
+        fo->blocks[i].index = (uint8_t)i;
+        atomic_init(&fo->refs[i], 0);
+    }
+    atomic_init(&fo->free_mask, block_count == 32 ? UINT32_MAX : (1u << block_count) - 1);
+    return fo;
+}
+
+void audio_fanout_destroy(audio_fanout_t *fo)
+{
+    if (!fo) {
+        return;
+    }
+    audio_arena_free(fo->arena, fo->mem);
+    audio_arena_free(fo->arena, fo);
+}
+
+audio_fanout_consumer_t *audio_fanout_subscribe(audio_fanout_t *fo, uint32_t depth, audio_fanout_notify_t notify, void *ctx)
+{
+    uint32_t size = 1;
+    while (size < depth && size < AUDIO_FANOUT_MAX_BLOCKS) {
+        size <<= 1;
+    }
+    for (int i = 0; i < AUDIO_FANOUT_MAX_CONSUMERS; i++) {
+        audio_fanout_consumer_t *c = &fo->consumers[i];
+        if (c->active) {
+            continue;
+        }
+        c->owner = fo;
+        c->mask = size - 1;
+        atomic_store(&c->head, 0);
+        atomic_store(&c->tail, 0);
+        atomic_store(&c->overruns, 0);
+        c->notify = notify;
+        c->notify_ctx = ctx;
+        c->active = true;
+        return c;
+    }
+    return NULL;
+}
+
+void audio_fanout_unsubscribe(audio_fanout_t *fo, audio_fanout_consumer_t *c)
+{
+    if (!c || !c->active) {
+        return;
+    }
+    c->active = false;
+    const audio_block_t *blk;
+    while ((blk = audio_fanout_pull(c)) != NULL) {
+        audio_fanout_release(fo, blk);
+    }
+}
+
+uint32_t audio_fanout_consumers(const audio_fanout_t *fo)
+{
+    uint32_t n = 0;
+    for (int i = 0; i < AUDIO_FANOUT_MAX_CONSUMERS; i++) {
+        n += fo->consumers[i].active;
+    }
+    return n;
+}
+
+audio_block_t *audio_fanout_alloc(audio_fanout_t *fo)
+{
+    uint32_t mask = atomic_load_explicit(&fo->free_mask, memory_order_acquire);
+    while (mask) {
+        uint32_t bit = (uint32_t)__builtin_ctz(mask);
+        // 只有生产者清除位，消费者只会置位，CAS失败时重新取掩码即可
+        if (atomic_compare_exchange_weak_explicit(&fo->free_mask, &mask, mask & ~(1u << bit),
+                                                  memory_order_acquire, memory_order_acquire)) {
+            audio_block_t *blk = &fo->blocks[bit];
+            atomic_store_explicit(&fo->refs[bit], 1, memory_order_relaxed);
+            blk->count = 0;
+            return blk;
+        }
+    }
+    return NULL;
+}
+
+uint32_t audio_fanout_publish(audio_fanout_t *fo, audio_block_t *blk)
+{
+    uint32_t delivered = 0;
+    blk->seq = fo->seq++;
+    for (int i = 0; i < AUDIO_FANOUT_MAX_CONSUMERS; i++) {
+        audio_fanout_consumer_t *c = &fo->consumers[i];
+        if (!c->active) {
+            continue;
+        }
+        uint32_t head = atomic_load_explicit(&c->head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&c->tail, memory_order_acquire);
+        if (head - tail > c->mask) {
+            atomic_fetch_add_explicit(&c->overruns, 1, memory_order_relaxed);
+            continue;   // 该消费者过慢，只丢它自己的块
+        }
+        atomic_fetch_add_explicit(&fo->refs[blk->index], 1, memory_order_relaxed);
+        c->queue[head & c->mask] = blk->index;
+        atomic_store_explicit(&c->head, head + 1, memory_order_release);
+        delivered++;
+        if (c->notify) {
+            c->notify(c->notify_ctx);
+        }
+    }
+    audio_fanout_release(fo, blk);  // 释放生产者引用
+    return delivered;
+}
+
+const audio_block_t *audio_fanout_pull(audio_fanout_consumer_t *c)
+{
+    uint32_t tail = atomic_load_explicit(&c->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&c->head, memory_order_acquire);
+    if (tail == head) {
+        return NULL;
+    }
+    uint8_t index = c->queue[tail & c->mask];
+    atomic_store_explicit(&c->tail, tail + 1, memory_order_release);
+    return &c->owner->blocks[index];
+}
+
+void audio_fanout_release(audio_fanout_t *fo, const audio_block_t *blk)
+{
+    if (!blk) {
+        return;
+    }
+    if (atomic_fetch_sub_explicit(&fo->refs[blk->index], 1, memory_order_acq_rel) == 1) {
+        atomic_fetch_or_explicit(&fo->free_mask, 1u << blk->index, memory_order_release);
+    }
+}
+
+uint32_t audio_fanout_overruns(const audio_fanout_consumer_t *c)
+{
+    return atomic_load_explicit(&c->overruns, memory_order_relaxed);
+}
+
+uint32_t audio_fanout_queued(const audio_fanout_consumer_t *c)
+{
+    return atomic_load_explicit(&c->head, memory_order_acquire) - atomic_load_explicit(&c->tail, memory_order_acquire);
+}
+
+uint32_t audio_fanout_free_blocks(const audio_fanout_t *fo)
+{
+    return (uint32_t)__builtin_popcount(atomic_load_explicit(&fo->free_mask, memory_order_relaxed));
+}
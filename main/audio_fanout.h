@@ -0,0 +1,129 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 13:00:00
+ * @LastEditTime: 2026-10-16 13:00:00
+ * @LastEditors: 星年
+ * @Description: PCM块扇出：预分配的引用计数PCM块池，一个生产者发布，多个消费者共享同一块数据（不拷贝）
+ * @FilePath: \audio_manager\main\audio_fanout.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_FANOUT_MAX_BLOCKS     32      // 块池最大块数（空闲块以32位掩码管理）
+#define AUDIO_FANOUT_MAX_CONSUMERS  4       // 最大消费者数
+
+/**
+ * @brief 一块PCM数据，发布后对所有消费者只读
+ */
+typedef struct {
+    int16_t *samples;       // 样点数据（指向块池内部，不可释放）
+    uint16_t count;         // 有效样点数
+    uint16_t cap;           // 块容量（样点）
+    uint8_t index;          // 块在池中的下标（内部使用）
+    uint32_t seq;           // 块序号，发布时自增
+    uint32_t timestamp;     // 首样点的采样计数（以输出采样率计）
+} audio_block_t;
+
+typedef struct audio_fanout audio_fanout_t;
+typedef struct audio_fanout_consumer audio_fanout_consumer_t;
+
+/**
+ * @brief 通知回调，块投递到某个消费者队列后调用（用于唤醒该消费者）
+ */
+typedef void (*audio_fanout_notify_t)(void *ctx);
+
+/**
+ * @brief 创建扇出，所有块一次性分配
+ *
+ * @param arena         内存区（块描述与队列在片内SRAM，块数据在PSRAM），NULL 时从堆分配
+ * @param block_count   块数量（不超过 AUDIO_FANOUT_MAX_BLOCKS）
+ * @param block_samples 每块样点数
+ * @return 句柄，失败返回NULL
+ */
+audio_fanout_t *audio_fanout_create(audio_arena_t *arena, uint32_t block_count, uint32_t block_samples);
+
+/**
+ * @brief 销毁扇出（须先注销所有消费者）
+ */
+void audio_fanout_destroy(audio_fanout_t *fo);
+
+/**
+ * @brief 注册消费者
+ *
+ * 注册/注销与 audio_fanout_publish() 之间不做同步，由调用者串行化；
+ * 消费者侧的 pull/release 与发布无锁并发。
+ *
+ * @param fo     句柄
+ * @param depth  消费者队列深度（块，向上取整到2的幂），队列满时该消费者丢块，不影响其他消费者
+ * @param notify 通知回调（可为NULL）
+ * @param ctx    通知回调上下文
+ * @return 消费者句柄，已满返回NULL
+ */
+audio_fanout_consumer_t *audio_fanout_subscribe(audio_fanout_t *fo, uint32_t depth, audio_fanout_notify_t notify, void *ctx);
+
+/**
+ * @brief 注销消费者，队列中未取走的块随之释放
+ *
+ * 调用前消费者须已归还所有通过 audio_fanout_pull() 取得的块。
+ */
+void audio_fanout_unsubscribe(audio_fanout_t *fo, audio_fanout_consumer_t *c);
+
+/**
+ * @brief 当前消费者数量
+ */
+uint32_t audio_fanout_consumers(const audio_fanout_t *fo);
+
+/**
+ * @brief 生产者获取一个空闲块，不阻塞
+ *
+ * @return 可写块，池中无空闲块返回NULL
+ */
+audio_block_t *audio_fanout_alloc(audio_fanout_t *fo);
+
+/**
+ * @brief 发布块：每个消费者引用一次，随后释放生产者自身的引用
+ *
+ * 无消费者时块直接回到空闲状态。
+ *
+ * @return 实际投递到的消费者数
+ */
+uint32_t audio_fanout_publish(audio_fanout_t *fo, audio_block_t *blk);
+
+/**
+ * @brief 消费者取出下一个块，不阻塞
+ *
+ * @return 只读块，队列为空返回NULL
+ */
+const audio_block_t *audio_fanout_pull(audio_fanout_consumer_t *c);
+
+/**
+ * @brief 消费者归还块，最后一个引用归还后块回到空闲状态
+ */
+void audio_fanout_release(audio_fanout_t *fo, const audio_block_t *blk);
+
+/**
+ * @brief 该消费者因队列满而丢弃的块数
+ */
+uint32_t audio_fanout_overruns(const audio_fanout_consumer_t *c);
+
+/**
+ * @brief 该消费者队列中已投递未取走的块数
+ */
+uint32_t audio_fanout_queued(const audio_fanout_consumer_t *c);
+
+/**
+ * @brief 当前空闲块数
+ */
+uint32_t audio_fanout_free_blocks(const audio_fanout_t *fo);
+
+#ifdef __cplusplus
+}
+#endif
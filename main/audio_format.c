@@ -0,0 +1,141 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 15:00:00
+ * @LastEditTime: 2026-10-17 15:00:00
+ * @LastEditors: 星年
+ * @Description: 链路格式协商实现：枚举候选采样率对，按每秒转换开销取最小，开销相同取较低采样率
+ * @FilePath: \audio_manager\main\audio_format.c
+ * 遇事不决，可问春风
+ */
+#include "audio_format.h"
+
+#define AUDIO_FORMAT_MAX_CANDIDATES (2 * AUDIO_FORMAT_MAX_RATES + 16)
+
+int audio_caps_has_rate(const audio_caps_t *caps, uint32_t rate)
+{
+    if (caps->rate_count == 0) {
+        return rate >= caps->rate_min && rate <= caps->rate_max;
+    }
+    for (int i = 0; i < caps->rate_count; i++) {
+        if (caps->rates[i] == rate) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int _audio_format_add_rate(uint32_t *list, int n, uint32_t rate)
+{
+    for (int i = 0; i < n; i++) {
+        if (list[i] == rate) {
+            return n;
+        }
+    }
+    if (n < AUDIO_FORMAT_MAX_CANDIDATES) {
+        list[n++] = rate;
+    }
+    return n;
+}
+
+static uint8_t _audio_format_lowest_bit(uint8_t mask)
+{
+    for (uint8_t i = 0; i < 8; i++) {
+        if (mask & (1u << i)) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+static uint8_t _audio_format_bits(uint8_t bit)
+{
+    static const uint8_t widths[] = {16, 24, 32};
+    return bit < sizeof(widths) ? widths[bit] : 16;
+}
+
+int audio_format_negotiate(const audio_caps_t *src, const audio_caps_t *sink,
+                           const audio_format_conv_t *convs, int count, audio_format_link_t *link)
+{
+    if (!src || !sink || !link || !src->channels_mask || !sink->channels_mask ||
+        !src->bits_mask || !sink->bits_mask) {
+        return -1;
+    }
+
+    // 1. 候选采样率：区间端只可能在另一端的离散采样率、转换器端点或区间下限上取到最优
+    uint32_t cand[AUDIO_FORMAT_MAX_CANDIDATES];
+    int n = 0;
+    for (int i = 0; i < src->rate_count; i++) {
+        n = _audio_format_add_rate(cand, n, src->rates[i]);
+    }
+    for (int i = 0; i < sink->rate_count; i++) {
+        n = _audio_format_add_rate(cand, n, sink->rates[i]);
+    }
+    for (int i = 0; i < count; i++) {
+        n = _audio_format_add_rate(cand, n, convs[i].in_rate);
+        n = _audio_format_add_rate(cand, n, convs[i].out_rate);
+    }
+    if (src->rate_count == 0) {
+        n = _audio_format_add_rate(cand, n, src->rate_min);
+    }
+    if (sink->rate_count == 0) {
+        n = _audio_format_add_rate(cand, n, sink->rate_min);
+    }
+
+    // 2. 声道与位宽与采样率无关，先定下来：有共有项取最少/最窄，否则各取自己的最少/最窄并计入开销
+    uint8_t ch_common = src->channels_mask & sink->channels_mask;
+    uint8_t bits_common = src->bits_mask & sink->bits_mask;
+    uint32_t per_sample = (ch_common ? 0 : 1) + (bits_common ? 0 : 1);
+    audio_format_t sf = {
+        .channels = _audio_format_lowest_bit(ch_common ? ch_common : src->channels_mask) + 1,
+        .bits = _audio_format_bits(_audio_format_lowest_bit(bits_common ? bits_common : src->bits_mask)),
+    };
+    audio_format_t kf = {
+        .channels = _audio_format_lowest_bit(ch_common ? ch_common : sink->channels_mask) + 1,
+        .bits = _audio_format_bits(_audio_format_lowest_bit(bits_common ? bits_common : sink->bits_mask)),
+    };
+
+    // 3. 逐对比较：每秒开销最小，其次两端采样率之和最小
+    int found = 0;
+    uint64_t best_cost = 0;
+    uint64_t best_sum = 0;
+    for (int i = 0; i < n; i++) {
+        if (!audio_caps_has_rate(src, cand[i])) {
+            continue;
+        }
+        for (int j = 0; j < n; j++) {
+            if (!audio_caps_has_rate(sink, cand[j])) {
+                continue;
+            }
+            int conv = -1;
+            uint64_t cost = (uint64_t)per_sample * cand[j];
+            if (cand[i] != cand[j]) {
+                for (int k = 0; k < count; k++) {
+                    if (convs[k].in_rate == cand[i] && convs[k].out_rate == cand[j] &&
+                        (conv < 0 || convs[k].cost < convs[conv].cost)) {
+                        conv = k;
+                    }
+                }
+                if (conv < 0) {
+                    continue;
+                }
+                cost += (uint64_t)convs[conv].cost * cand[j];
+            }
+            uint64_t sum = (uint64_t)cand[i] + cand[j];
+            if (!found || cost < best_cost || (cost == best_cost && sum < best_sum)) {
+                found = 1;
+                best_cost = cost;
+                best_sum = sum;
+                sf.rate = cand[i];
+                kf.rate = cand[j];
+                link->conv = conv;
+            }
+        }
+    }
+    if (!found) {
+        return -1;
+    }
+    link->src = sf;
+    link->sink = kf;
+    link->cost = best_cost > UINT32_MAX ? UINT32_MAX : (uint32_t)best_cost;
+    return 0;
+}
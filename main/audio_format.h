@@ -0,0 +1,98 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 15:00:00
+ * @LastEditTime: 2026-10-17 15:00:00
+ * @LastEditors: 星年
+ * @Description: 链路格式协商：两端声明支持的采样率/声道/位宽，连接时在可用转换器中选开销最小的路径，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\audio_format.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_FORMAT_MAX_RATES  8           // 离散采样率列表最大长度
+
+#define AUDIO_FORMAT_CH(n)      (1u << ((n) - 1))   // 声道掩码：n 声道
+#define AUDIO_FORMAT_BITS_16    (1u << 0)           // 位宽掩码：16位
+#define AUDIO_FORMAT_BITS_24    (1u << 1)           // 24位（打包）
+#define AUDIO_FORMAT_BITS_32    (1u << 2)           // 32位槽（含24-in-32 DMA字）
+
+/**
+ * @brief 具体格式
+ */
+typedef struct {
+    uint32_t rate;              // 采样率
+    uint8_t channels;           // 声道数
+    uint8_t bits;               // 位宽（16/24/32）
+} audio_format_t;
+
+/**
+ * @brief 一端支持的格式集合
+ *
+ * 采样率为离散列表（rate_count > 0，如Opus解码器），或连续区间 [rate_min, rate_max]
+ * （rate_count 为0，如按BCLK分频取任意采样率的I2S器件）。
+ */
+typedef struct {
+    uint32_t rates[AUDIO_FORMAT_MAX_RATES]; // 离散采样率
+    uint8_t rate_count;                     // 离散采样率个数，0 表示使用区间
+    uint32_t rate_min;                      // 区间下限
+    uint32_t rate_max;                      // 区间上限
+    uint8_t channels_mask;                  // AUDIO_FORMAT_CH() 之或
+    uint8_t bits_mask;                      // AUDIO_FORMAT_BITS_xx 之或
+} audio_caps_t;
+
+/**
+ * @brief 可用的采样率转换器
+ *
+ * cost 为每个输出样点的相对开销（约等于乘加次数），协商按 cost * 输出采样率 比较每秒开销。
+ */
+typedef struct {
+    const char *name;           // 名称（日志与统计）
+    uint32_t in_rate;           // 输入采样率
+    uint32_t out_rate;          // 输出采样率
+    uint16_t cost;              // 每个输出样点的开销
+} audio_format_conv_t;
+
+/**
+ * @brief 协商结果
+ */
+typedef struct {
+    audio_format_t src;         // 源端工作格式
+    audio_format_t sink;        // 宿端工作格式
+    int conv;                   // 采用的采样率转换器下标，-1 表示采样率直通
+    uint32_t cost;              // 每秒开销（采样率转换 + 声道/位宽转换）
+} audio_format_link_t;
+
+/**
+ * @brief 判断集合是否包含某采样率
+ */
+int audio_caps_has_rate(const audio_caps_t *caps, uint32_t rate);
+
+/**
+ * @brief 协商链路格式
+ *
+ * 候选采样率取两端的离散采样率与各转换器的输入/输出采样率，逐对检查两端是否支持、
+ * 采样率不同时是否有对应转换器；声道与位宽优先取两端共有的（声道取最少、位宽取最窄），
+ * 没有共有项时按每样点1次运算计入开销。
+ * 每秒开销最小者胜出；开销相同时取两端采样率之和最小者（DMA与下游处理更省），
+ * 需要保留带宽的一端应在自己的集合里去掉过低的采样率。
+ *
+ * @param src   源端集合
+ * @param sink  宿端集合
+ * @param convs 可用转换器，可为NULL
+ * @param count 转换器个数
+ * @param link  输出结果
+ * @return 0；两端没有可行路径返回-1
+ */
+int audio_format_negotiate(const audio_caps_t *src, const audio_caps_t *sink,
+                           const audio_format_conv_t *convs, int count, audio_format_link_t *link);
+
+#ifdef __cplusplus
+}
+#endif
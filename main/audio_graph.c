@@ -0,0 +1,184 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 13:00:00
+ * @LastEditTime: 2026-10-17 13:00:00
+ * @LastEditors: 星年
+ * @Description: 单任务同步处理图实现：节点按链路顺序同步调用，两块工作缓冲乒乓交替，
+ *               原地节点不切换缓冲，整条链没有环形缓冲区也没有数据拷贝
+ * @FilePath: \audio_manager\main\audio_graph.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "audio_graph.h"
+
+typedef struct {
+    audio_graph_process_t fn;
+    void *ctx;
+    bool inplace;
+    bool tap;                                   // 旁路节点：只读当前数据，不改变链上的数据与样点数
+} audio_graph_node_t;
+
+struct audio_graph {
+    audio_graph_cfg_t cfg;
+    uint8_t *buf[2];                            // 乒乓工作缓冲
+    const void *out;                            // 最近一帧最后一个节点的输出
+    uint8_t count;                              // 节点数
+    audio_graph_node_t node[AUDIO_GRAPH_MAX_NODES];
+    audio_graph_node_stats_t node_stats[AUDIO_GRAPH_MAX_NODES];
+    audio_graph_stats_t stats;
+};
+
+size_t audio_graph_mem_size(const audio_graph_cfg_t *cfg, audio_arena_place_t place)
+{
+    if (!cfg || place != AUDIO_ARENA_INTERNAL) {
+        return 0;
+    }
+    size_t bytes = AUDIO_ARENA_SIZE(sizeof(audio_graph_t));
+    if (cfg->buf_bytes) {
+        bytes += 2 * AUDIO_ARENA_SIZE(cfg->buf_bytes + AUDIO_GRAPH_PAD_BYTES);
+    }
+    return bytes;
+}
+
+audio_graph_t *audio_graph_create(const audio_graph_cfg_t *cfg)
+{
+    if (!cfg) {
+        return NULL;
+    }
+    audio_graph_t *g = audio_arena_calloc(cfg->arena, 1, sizeof(audio_graph_t), AUDIO_ARENA_INTERNAL);
+    if (!g) {
+        return NULL;
+    }
+    g->cfg = *cfg;
+    // 工作缓冲每帧都要读写，放片内
+    for (int i = 0; i < 2 && cfg->buf_bytes; i++) {
+        g->buf[i] = audio_arena_calloc(cfg->arena, 1, cfg->buf_bytes + AUDIO_GRAPH_PAD_BYTES, AUDIO_ARENA_INTERNAL);
+        if (!g->buf[i]) {
+            audio_graph_destroy(g);
+            return NULL;
+        }
+    }
+    return g;
+}
+
+void audio_graph_destroy(audio_graph_t *g)
+{
+    if (!g) {
+        return;
+    }
+    audio_arena_t *arena = g->cfg.arena;
+    audio_arena_free(arena, g->buf[0]);
+    audio_arena_free(arena, g->buf[1]);
+    audio_arena_free(arena, g);
+}
+
+int audio_graph_add(audio_graph_t *g, const char *name, audio_graph_process_t fn, void *ctx, bool inplace)
+{
+    if (!g || !fn || g->count >= AUDIO_GRAPH_MAX_NODES) {
+        return -1;
+    }
+    int idx = g->count++;
+    g->node[idx].fn = fn;
+    g->node[idx].ctx = ctx;
+    g->node[idx].inplace = inplace;
+    g->node[idx].tap = false;
+    memset(&g->node_stats[idx], 0, sizeof(g->node_stats[idx]));
+    g->node_stats[idx].name = name;
+    g->stats.nodes = g->count;
+    return idx;
+}
+
+int audio_graph_add_tap(audio_graph_t *g, const char *name, audio_graph_process_t fn, void *ctx)
+{
+    int idx = audio_graph_add(g, name, fn, ctx, true);
+    if (idx >= 0) {
+        g->node[idx].tap = true;
+    }
+    return idx;
+}
+
+size_t audio_graph_run(audio_graph_t *g, const void *in, size_t n)
+{
+    uint32_t (*clock_us)(void) = g->cfg.clock_us;
+    uint32_t t0 = clock_us ? clock_us() : 0;
+    uint32_t t = t0;
+    const void *cur = in;
+    int next = 0;                               // 下一个非原地节点写入的工作缓冲
+    for (int i = 0; i < g->count && n > 0; i++) {
+        audio_graph_node_t *node = &g->node[i];
+        if (node->tap) {
+            // 旁路节点与下一个节点读同一份数据，不占工作缓冲
+            node->fn(node->ctx, cur, n, NULL);
+        } else {
+            void *out;
+            if (node->inplace && cur != in) {
+                out = (void *)cur;
+            } else {
+                out = g->buf[next];
+                next ^= 1;
+            }
+            n = node->fn(node->ctx, cur, n, out);
+            cur = out;
+        }
+
+        audio_graph_node_stats_t *ns = &g->node_stats[i];
+        ns->calls++;
+        ns->samples_out += n;
+        if (clock_us) {
+            uint32_t now = clock_us();
+            uint32_t us = now - t;
+            t = now;
+            ns->total_us += us;
+            if (us > ns->peak_us) {
+                ns->peak_us = us;
+            }
+        }
+    }
+    g->out = cur;
+    g->stats.frames++;
+    if (clock_us) {
+        uint32_t us = t - t0;
+        g->stats.last_us = us;
+        g->stats.total_us += us;
+        if (us > g->stats.peak_us) {
+            g->stats.peak_us = us;
+        }
+        if (g->cfg.frame_us && us > g->cfg.frame_us) {
+            g->stats.overruns++;
+        }
+    }
+    return n;
+}
+
+const void *audio_graph_output(const audio_graph_t *g)
+{
+    return g->out;
+}
+
+int audio_graph_get_stats(const audio_graph_t *g, audio_graph_stats_t *stats, audio_graph_node_stats_t *nodes, int max)
+{
+    if (!g) {
+        return 0;
+    }
+    if (stats) {
+        *stats = g->stats;
+    }
+    int count = 0;
+    if (nodes) {
+        count = g->count < max ? g->count : max;
+        memcpy(nodes, g->node_stats, count * sizeof(audio_graph_node_stats_t));
+    }
+    return count;
+}
+
+void audio_graph_reset_stats(audio_graph_t *g)
+{
+    memset(&g->stats, 0, sizeof(g->stats));
+    g->stats.nodes = g->count;
+    for (int i = 0; i < g->count; i++) {
+        const char *name = g->node_stats[i].name;
+        memset(&g->node_stats[i], 0, sizeof(g->node_stats[i]));
+        g->node_stats[i].name = name;
+    }
+}
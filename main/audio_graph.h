@@ -0,0 +1,165 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 13:00:00
+ * @LastEditTime: 2026-10-17 13:00:00
+ * @LastEditors: 星年
+ * @Description: 单任务同步处理图：一串处理回调在同一个（DMA驱动的）任务里按定长帧跑完，缓冲区按指针传递，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\audio_graph.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_GRAPH_MAX_NODES   8       // 单图最多节点数
+#define AUDIO_GRAPH_PAD_BYTES   16      // 工作缓冲尾部填充，供向量内核越过末尾预取
+
+/**
+ * @brief 管道执行引擎
+ *
+ * ADF 每个元素一个任务、元素之间经环形缓冲区拷贝；处理图整条链在一个任务里同步跑完，
+ * 省去元素任务堆栈、环形缓冲区与每块两次拷贝和上下文切换，代价是链上最慢的节点决定整条链的时延。
+ */
+typedef enum {
+    AUDIO_ENGINE_ADF = 0,           // ADF 元素管道（默认）
+    AUDIO_ENGINE_GRAPH,             // 单任务同步处理图
+} audio_engine_t;
+
+/**
+ * @brief 节点处理回调
+ *
+ * 输入与输出均为样点数组，元素类型由相邻两个节点约定（如DMA原始32位字 -> 16位PCM）。
+ * 节点在本次调用内处理完全部输入，按需在内部保留历史（滤波器、未凑满的帧）。
+ *
+ * @param ctx 节点上下文
+ * @param in  输入（本帧上一个节点的输出，或图的输入）
+ * @param n   输入样点数
+ * @param out 输出缓冲区（容量为图配置的 buf_bytes）；原地节点的 out 可能与 in 相同
+ * @return 输出样点数；返回0时本帧在此结束（末端节点或尚未攒够数据）
+ */
+typedef size_t (*audio_graph_process_t)(void *ctx, const void *in, size_t n, void *out);
+
+/**
+ * @brief 处理图配置
+ */
+typedef struct {
+    size_t buf_bytes;               // 工作缓冲容量：任一节点单帧输出的最大字节数（0 不分配，链上只有末端节点时使用）
+    uint32_t frame_us;              // 帧时长，整条链单帧耗时超过它计一次超时（0 不检查）
+    uint32_t (*clock_us)(void);     // 微秒时钟，NULL 时不统计耗时
+    audio_arena_t *arena;           // 内存区，NULL 时从堆分配（工作缓冲放片内）
+} audio_graph_cfg_t;
+
+#define DEFAULT_AUDIO_GRAPH_CONFIG() {  \
+    .buf_bytes = 0,                     \
+    .frame_us  = 0,                     \
+    .clock_us  = NULL,                  \
+    .arena     = NULL,                  \
+}
+
+/**
+ * @brief 节点统计
+ */
+typedef struct {
+    const char *name;               // 节点名
+    uint32_t calls;                 // 调用次数
+    uint32_t total_us;              // 累计耗时
+    uint32_t peak_us;               // 单次最长耗时
+    uint64_t samples_out;           // 累计输出样点数
+} audio_graph_node_stats_t;
+
+/**
+ * @brief 处理图统计
+ */
+typedef struct {
+    uint32_t frames;                // 已运行帧数
+    uint32_t overruns;              // 单帧耗时超过帧时长的次数
+    uint32_t last_us;               // 最近一帧耗时
+    uint32_t peak_us;               // 单帧最长耗时
+    uint64_t total_us;              // 累计耗时
+    uint8_t nodes;                  // 节点数
+} audio_graph_stats_t;
+
+typedef struct audio_graph audio_graph_t;
+
+/**
+ * @brief 创建处理图（分配两块乒乓工作缓冲）
+ *
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+audio_graph_t *audio_graph_create(const audio_graph_cfg_t *cfg);
+
+/**
+ * @brief 销毁处理图（节点上下文归调用者所有）
+ */
+void audio_graph_destroy(audio_graph_t *g);
+
+/**
+ * @brief 在链尾追加节点（只可在开始运行前调用）
+ *
+ * @param g       句柄
+ * @param name    节点名（须长期有效，用于统计）
+ * @param fn      处理回调
+ * @param ctx     回调上下文
+ * @param inplace 节点支持 out == in，此时不切换工作缓冲（链首节点除外，图的输入只读）
+ * @return 节点下标，节点已满或参数非法返回-1
+ */
+int audio_graph_add(audio_graph_t *g, const char *name, audio_graph_process_t fn, void *ctx, bool inplace);
+
+/**
+ * @brief 在链尾追加旁路节点（只可在开始运行前调用）
+ *
+ * 旁路节点读取当前数据（out 为NULL，返回值忽略），之后的节点仍收到同一份数据与样点数，
+ * 用于把一份数据同时交给多个末端消费者（如同一采集块的多路编码）而不拷贝。
+ *
+ * @return 节点下标，节点已满或参数非法返回-1
+ */
+int audio_graph_add_tap(audio_graph_t *g, const char *name, audio_graph_process_t fn, void *ctx);
+
+/**
+ * @brief 按链路顺序运行一帧
+ *
+ * 每个节点的输出作为下一个节点的输入，非原地节点在两块工作缓冲之间交替写入，不做拷贝。
+ *
+ * @param g  句柄
+ * @param in 图的输入（只读）
+ * @param n  输入样点数
+ * @return 最后一个节点的输出样点数（中途某节点返回0时为0），输出可由 audio_graph_output() 取得
+ */
+size_t audio_graph_run(audio_graph_t *g, const void *in, size_t n);
+
+/**
+ * @brief 最近一次运行中最后一个节点的输出（下次运行前有效）
+ */
+const void *audio_graph_output(const audio_graph_t *g);
+
+/**
+ * @brief 获取统计
+ *
+ * @param g     句柄
+ * @param stats 整图统计，可为NULL
+ * @param nodes 节点统计数组，可为NULL
+ * @param max   nodes 容量
+ * @return 写入 nodes 的条目数
+ */
+int audio_graph_get_stats(const audio_graph_t *g, audio_graph_stats_t *stats, audio_graph_node_stats_t *nodes, int max);
+
+/**
+ * @brief 清空统计
+ */
+void audio_graph_reset_stats(audio_graph_t *g);
+
+/**
+ * @brief 按配置计算处理图在 place 中所需的内存（按内存区对齐取整），用于预留内存区
+ */
+size_t audio_graph_mem_size(const audio_graph_cfg_t *cfg, audio_arena_place_t place);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,157 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 14:00:00
+ * @LastEditTime: 2026-10-16 14:00:00
+ * @LastEditors: 星年
+ * @Description: 延迟档位与按级延迟统计实现
+ * @FilePath: \audio_manager\main\audio_latency.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include "esp_log.h"
+#include "ringbuf.h"
+#include "i2s_stream.h"
+#include "audio_latency.h"
+
+static const audio_latency_profile_t s_presets[AUDIO_LATENCY_MAX] = {
+    [AUDIO_LATENCY_ULTRA_LOW] = {
+        .name              = "ultra-low",
+        .i2s_dma_desc_num  = 4,
+        .i2s_dma_frame_num = 64,
+        .i2s_buffer_len    = 512,
+        .i2s_rb_size       = 2 * 1024,
+        .element_rb_size   = 1024,
+        .opus_frame_us     = 5000,
+        .jitter_min_ms     = 20,
+        .task_prio         = 20,
+        .capture_core      = 1,
+        .playback_core     = 1,
+    },
+    [AUDIO_LATENCY_BALANCED] = {
+        .name              = "balanced",
+        .i2s_dma_desc_num  = 3,
+        .i2s_dma_frame_num = 300,
+        .i2s_buffer_len    = I2S_STREAM_BUF_SIZE,
+        .i2s_rb_size       = I2S_STREAM_RINGBUFFER_SIZE,
+        .element_rb_size   = 4 * 1024,
+        .opus_frame_us     = 20000,
+        .jitter_min_ms     = 40,
+        .task_prio         = 5,
+        .capture_core      = 0,
+        .playback_core     = 0,
+    },
+    [AUDIO_LATENCY_THROUGHPUT] = {
+        .name              = "throughput",
+        .i2s_dma_desc_num  = 8,
+        .i2s_dma_frame_num = 511,
+        .i2s_buffer_len    = 8 * 1024,
+        .i2s_rb_size       = 16 * 1024,
+        .element_rb_size   = 8 * 1024,
+        .opus_frame_us     = 60000,
+        .jitter_min_ms     = 120,
+        .task_prio         = 5,
+        .capture_core      = 0,
+        .playback_core     = 1,
+    },
+};
+
+static audio_latency_profile_t s_profile = {0};     // 当前档位，name为NULL表示尚未设置
+
+static bool audio_latency_frame_valid(int frame_us)
+{
+    switch (frame_us) {
+    case 2500:
+    case 5000:
+    case 10000:
+    case 20000:
+    case 40000:
+    case 60000:
+        return true;
+    default:
+        return false;
+    }
+}
+
+esp_err_t audio_latency_set_profile(audio_latency_profile_id_t id)
+{
+    if (id < 0 || id >= AUDIO_LATENCY_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return audio_latency_set_custom(&s_presets[id]);
+}
+
+esp_err_t audio_latency_set_custom(const audio_latency_profile_t *profile)
+{
+    if (!profile || !audio_latency_frame_valid(profile->opus_frame_us) ||
+            profile->i2s_dma_desc_num < 2 || profile->i2s_dma_frame_num <= 0 ||
+            profile->i2s_buffer_len <= 0 || profile->i2s_rb_size <= 0 || profile->element_rb_size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_profile = *profile;
+    if (!s_profile.name) {
+        s_profile.name = "custom";
+    }
+    ESP_LOGI("AUDIO_LATENCY", "profile %s: dma %dx%d, frame %d us, jitter min %d ms",
+             s_profile.name, s_profile.i2s_dma_desc_num, s_profile.i2s_dma_frame_num,
+             s_profile.opus_frame_us, s_profile.jitter_min_ms);
+    return ESP_OK;
+}
+
+const audio_latency_profile_t *audio_latency_get_profile(void)
+{
+    if (!s_profile.name) {
+        s_profile = s_presets[AUDIO_LATENCY_BALANCED];
+    }
+    return &s_profile;
+}
+
+int audio_latency_frame_samples(int sample_rate)
+{
+    return (int)((int64_t)sample_rate * audio_latency_get_profile()->opus_frame_us / 1000000);
+}
+
+void audio_latency_report_reset(audio_latency_report_t *report)
+{
+    memset(report, 0, sizeof(*report));
+}
+
+void audio_latency_report_add(audio_latency_report_t *report, const char *name, uint32_t us)
+{
+    if (report->count >= AUDIO_LATENCY_MAX_STAGES) {
+        return;
+    }
+    report->stage[report->count].name = name;
+    report->stage[report->count].us = us;
+    report->count++;
+    report->total_us += us;
+}
+
+void audio_latency_report_add_ringbuf(audio_latency_report_t *report, const char *name, audio_element_handle_t el, uint32_t bytes_per_sec)
+{
+    if (!el || bytes_per_sec == 0) {
+        return;
+    }
+    ringbuf_handle_t rb = audio_element_get_output_ringbuf(el);
+    uint32_t filled = rb ? (uint32_t)rb_bytes_filled(rb) : 0;
+    audio_latency_report_add(report, name, (uint32_t)((uint64_t)filled * 1000000 / bytes_per_sec));
+}
+
+void audio_latency_report_add_dma(audio_latency_report_t *report, const char *name, int sample_rate)
+{
+    const audio_latency_profile_t *p = audio_latency_get_profile();
+    if (sample_rate <= 0) {
+        return;
+    }
+    uint64_t frames = (uint64_t)p->i2s_dma_desc_num * p->i2s_dma_frame_num;
+    audio_latency_report_add(report, name, (uint32_t)(frames * 1000000 / sample_rate));
+}
+
+void audio_latency_report_log(const char *tag, const char *title, const audio_latency_report_t *report)
+{
+    ESP_LOGI(tag, "%s latency (%s): %u.%01u ms", title, audio_latency_get_profile()->name,
+             (unsigned)(report->total_us / 1000), (unsigned)(report->total_us % 1000 / 100));
+    for (int i = 0; i < report->count; i++) {
+        ESP_LOGI(tag, "  %-14s %6u.%01u ms", report->stage[i].name,
+                 (unsigned)(report->stage[i].us / 1000), (unsigned)(report->stage[i].us % 1000 / 100));
+    }
+}
@@ -0,0 +1,127 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 14:00:00
+ * @LastEditTime: 2026-10-16 14:00:00
+ * @LastEditors: 星年
+ * @Description: 延迟档位：统一配置采集/编码/解码/播放各管道的DMA深度、环形缓冲区、Opus帧长与任务调度，并按级统计缓冲延迟
+ * @FilePath: \audio_manager\main\audio_latency.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "audio_element.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 预置延迟档位
+ */
+typedef enum {
+    AUDIO_LATENCY_ULTRA_LOW = 0,    // 超低延迟：小DMA、小环形缓冲区、5ms帧、高优先级独占核心1
+    AUDIO_LATENCY_BALANCED,         // 均衡（默认，与原有配置一致）：20ms帧
+    AUDIO_LATENCY_THROUGHPUT,       // 吞吐优先：大缓冲、60ms帧，CPU唤醒次数最少
+    AUDIO_LATENCY_MAX,
+} audio_latency_profile_id_t;
+
+/**
+ * @brief 延迟档位参数
+ */
+typedef struct {
+    const char *name;           // 档位名称
+    int i2s_dma_desc_num;       // I2S DMA描述符数量
+    int i2s_dma_frame_num;      // 每个DMA描述符的帧数
+    int i2s_buffer_len;         // i2s_stream 每次读写的字节数
+    int i2s_rb_size;            // I2S读取元素输出环形缓冲区大小
+    int element_rb_size;        // 中间元素（重采样/采集读取/解码）输出环形缓冲区大小
+    int opus_frame_us;          // Opus帧长（微秒）：2500/5000/10000/20000/40000/60000
+    int jitter_min_ms;          // 抖动缓冲最小目标深度
+    int task_prio;              // 音频元素任务优先级
+    int capture_core;           // 采集/编码侧任务绑定核心
+    int playback_core;          // 解码/播放侧任务绑定核心
+} audio_latency_profile_t;
+
+/**
+ * @brief 切换延迟档位
+ *
+ * 各管道在启动时读取当前档位，已运行的管道需停止后重新启动才会生效。
+ * 编码端与解码端须使用相同的Opus帧长。
+ *
+ * @param id 预置档位
+ * @return ESP_OK，参数非法返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t audio_latency_set_profile(audio_latency_profile_id_t id);
+
+/**
+ * @brief 使用自定义档位参数（拷贝一份，name 需为常量字符串）
+ *
+ * @return ESP_OK，Opus帧长或其他参数非法返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t audio_latency_set_custom(const audio_latency_profile_t *profile);
+
+/**
+ * @brief 当前档位参数（未设置时为 AUDIO_LATENCY_BALANCED）
+ */
+const audio_latency_profile_t *audio_latency_get_profile(void);
+
+/**
+ * @brief 按当前档位计算每帧采样点数
+ */
+int audio_latency_frame_samples(int sample_rate);
+
+#define AUDIO_LATENCY_MAX_STAGES    (12)    // 一条链路最多统计的级数
+
+/**
+ * @brief 单级缓冲延迟
+ */
+typedef struct {
+    const char *name;           // 级名称
+    uint32_t us;                // 当前缓冲/算法延迟（微秒）
+} audio_latency_stage_t;
+
+/**
+ * @brief 一条链路的按级延迟报告
+ */
+typedef struct {
+    audio_latency_stage_t stage[AUDIO_LATENCY_MAX_STAGES];
+    int count;                  // 级数
+    uint32_t total_us;          // 合计
+} audio_latency_report_t;
+
+/**
+ * @brief 清空报告
+ */
+void audio_latency_report_reset(audio_latency_report_t *report);
+
+/**
+ * @brief 追加一级固定或已知的延迟
+ */
+void audio_latency_report_add(audio_latency_report_t *report, const char *name, uint32_t us);
+
+/**
+ * @brief 追加一级环形缓冲区延迟：取元素输出环形缓冲区的已填充字节数换算为时间
+ *
+ * @param report        报告
+ * @param name          级名称
+ * @param el            元素（取其输出环形缓冲区），NULL时忽略
+ * @param bytes_per_sec 该缓冲区中数据的字节率
+ */
+void audio_latency_report_add_ringbuf(audio_latency_report_t *report, const char *name, audio_element_handle_t el, uint32_t bytes_per_sec);
+
+/**
+ * @brief 追加I2S DMA缓冲延迟（按当前档位的DMA深度计算，DMA满载时的上限值）
+ */
+void audio_latency_report_add_dma(audio_latency_report_t *report, const char *name, int sample_rate);
+
+/**
+ * @brief 打印报告
+ */
+void audio_latency_report_log(const char *tag, const char *title, const audio_latency_report_t *report);
+
+#ifdef __cplusplus
+}
+#endif
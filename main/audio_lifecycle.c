@@ -0,0 +1,162 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 20:00:00
+ * @LastEditTime: 2026-10-16 20:00:00
+ * @LastEditors: 星年
+ * @Description: 常驻管道生命周期实现：同步暂停/恢复、冲刷、启停计时与共用事件监听任务
+ * @FilePath: \audio_manager\main\audio_lifecycle.c
+ * 遇事不决，可问春风
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "audio_event_iface.h"
+#include "audio_probe.h"
+#include "audio_lifecycle.h"
+
+static const char *TAG = "AUDIO_LIFECYCLE";
+
+static portMUX_TYPE s_lock_mux = portMUX_INITIALIZER_UNLOCKED;
+static StaticSemaphore_t s_evt_lock_buf;
+static SemaphoreHandle_t s_evt_lock = NULL;             // 串行化共用监听器的创建与挂接
+static audio_event_iface_handle_t s_evt = NULL;         // 共用事件监听器（常驻）
+static TaskHandle_t s_evt_task = NULL;                  // 共用事件监听任务（常驻）
+
+static SemaphoreHandle_t audio_lifecycle_lock(SemaphoreHandle_t *lock, StaticSemaphore_t *buf)
+{
+    if (!*lock) {
+        portENTER_CRITICAL(&s_lock_mux);
+        if (!*lock) {
+            *lock = xSemaphoreCreateMutexStatic(buf);
+        }
+        portEXIT_CRITICAL(&s_lock_mux);
+    }
+    return *lock;
+}
+
+static uint32_t audio_lifecycle_elapsed(int64_t t0)
+{
+    int64_t d = esp_timer_get_time() - t0;
+    return d > 0 ? (uint32_t)d : 0;
+}
+
+void audio_lifecycle_enter(audio_lifecycle_t *lc)
+{
+    xSemaphoreTake(audio_lifecycle_lock(&lc->lock, &lc->lock_buf), portMAX_DELAY);
+    lc->t0 = esp_timer_get_time();
+}
+
+void audio_lifecycle_leave(audio_lifecycle_t *lc, audio_lifecycle_state_t state)
+{
+    uint32_t us = audio_lifecycle_elapsed(lc->t0);
+    audio_lifecycle_stats_t *st = &lc->stats;
+    if (state == AUDIO_LIFECYCLE_RUNNING && lc->state != AUDIO_LIFECYCLE_RUNNING) {
+        st->starts++;
+        st->start_us = us;
+        if (lc->state == AUDIO_LIFECYCLE_IDLE) {
+            st->builds++;
+            st->build_us = us;
+        } else if (us > st->start_max_us) {
+            st->start_max_us = us;
+        }
+        lc->armed_us = lc->t0;
+    } else if (state == AUDIO_LIFECYCLE_PAUSED && lc->state == AUDIO_LIFECYCLE_RUNNING) {
+        st->stops++;
+        st->stop_us = us;
+        if (us > st->stop_max_us) {
+            st->stop_max_us = us;
+        }
+        lc->armed_us = 0;
+    } else if (state == AUDIO_LIFECYCLE_IDLE) {
+        lc->armed_us = 0;
+    }
+    lc->state = state;
+    xSemaphoreGive(lc->lock);
+}
+
+void audio_lifecycle_data(audio_lifecycle_t *lc)
+{
+    int64_t armed = lc->armed_us;
+    if (!armed) {
+        return;
+    }
+    lc->armed_us = 0;
+    uint32_t us = audio_lifecycle_elapsed(armed);
+    lc->stats.first_data_us = us;
+    if (us > lc->stats.first_data_max_us) {
+        lc->stats.first_data_max_us = us;
+    }
+}
+
+void audio_lifecycle_get_stats(const audio_lifecycle_t *lc, audio_lifecycle_stats_t *stats)
+{
+    *stats = lc->stats;
+}
+
+esp_err_t audio_lifecycle_pause(audio_pipeline_handle_t pipeline)
+{
+    // 每个元素处理完当前一次 process 后确认暂停，之后不会再有任务读写环形缓冲区
+    esp_err_t ret = audio_pipeline_pause(pipeline);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "pipeline pause failed: %d", ret);
+        return ret;
+    }
+    return audio_pipeline_reset_ringbuffer(pipeline);
+}
+
+esp_err_t audio_lifecycle_resume(audio_pipeline_handle_t pipeline)
+{
+    esp_err_t ret = audio_pipeline_resume(pipeline);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "pipeline resume failed: %d", ret);
+    }
+    return ret;
+}
+
+/**
+ * @brief 共用事件监听任务：所有常驻管道的元素事件都送到这里，只做探针统计
+ */
+static void audio_lifecycle_evt_task(void *arg)
+{
+    while (1) {
+        audio_event_iface_msg_t msg;
+        if (audio_event_iface_listen(s_evt, &msg, portMAX_DELAY) == ESP_OK) {
+            audio_probe_on_event(&msg);
+        }
+    }
+}
+
+esp_err_t audio_lifecycle_listen(audio_pipeline_handle_t pipeline)
+{
+    SemaphoreHandle_t lock = audio_lifecycle_lock(&s_evt_lock, &s_evt_lock_buf);
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (!s_evt) {
+        audio_event_iface_cfg_t evt_cfg = AUDIO_EVENT_IFACE_DEFAULT_CFG();
+        s_evt = audio_event_iface_init(&evt_cfg);
+        if (!s_evt || xTaskCreate(audio_lifecycle_evt_task, "audio_lifecycle", AUDIO_LIFECYCLE_EVT_TASK_STACK,
+                                  NULL, AUDIO_LIFECYCLE_EVT_TASK_PRIO, &s_evt_task) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create shared event listener");
+            if (s_evt) {
+                audio_event_iface_destroy(s_evt);
+                s_evt = NULL;
+            }
+            s_evt_task = NULL;
+            xSemaphoreGive(lock);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    esp_err_t ret = audio_pipeline_set_listener(pipeline, s_evt);
+    xSemaphoreGive(lock);
+    return ret;
+}
+
+void audio_lifecycle_unlisten(audio_pipeline_handle_t pipeline)
+{
+    SemaphoreHandle_t lock = audio_lifecycle_lock(&s_evt_lock, &s_evt_lock_buf);
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (s_evt) {
+        audio_pipeline_remove_listener(pipeline);
+    }
+    xSemaphoreGive(lock);
+}
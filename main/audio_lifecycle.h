@@ -0,0 +1,115 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 20:00:00
+ * @LastEditTime: 2026-10-16 20:00:00
+ * @LastEditors: 星年
+ * @Description: 常驻管道生命周期：管道只构建一次，启停改为带握手的暂停/恢复与冲刷，统计启停耗时；所有常驻管道共用一个事件监听任务
+ * @FilePath: \audio_manager\main\audio_lifecycle.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "audio_pipeline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_LIFECYCLE_EVT_TASK_STACK  (3 * 1024)  // 共用事件监听任务堆栈
+#define AUDIO_LIFECYCLE_EVT_TASK_PRIO   (4)         // 共用事件监听任务优先级（低于音频元素）
+
+/**
+ * @brief 管道状态
+ */
+typedef enum {
+    AUDIO_LIFECYCLE_IDLE = 0,       // 未构建（或已 deinit）
+    AUDIO_LIFECYCLE_RUNNING,        // 已构建，运行中
+    AUDIO_LIFECYCLE_PAUSED,         // 已构建，暂停中，资源全部保留
+} audio_lifecycle_state_t;
+
+/**
+ * @brief 启停统计（时间单位微秒）
+ */
+typedef struct {
+    uint32_t builds;                // 构建次数（首次启动或 deinit 之后的启动）
+    uint32_t starts;                // 启动次数（含构建）
+    uint32_t stops;                 // 停止（暂停）次数
+    uint32_t start_us;              // 最近一次启动：调用到所有元素恢复运行
+    uint32_t start_max_us;          // 不含构建的启动耗时最大值
+    uint32_t build_us;              // 最近一次构建耗时（创建元素、安装驱动、创建任务）
+    uint32_t stop_us;               // 最近一次停止：调用到所有元素确认暂停并冲刷完毕
+    uint32_t stop_max_us;           // 停止耗时最大值
+    uint32_t first_data_us;         // 最近一次启动到首块数据（含凑满一块的时长），0 表示尚无数据
+    uint32_t first_data_max_us;     // 首块数据耗时最大值
+} audio_lifecycle_stats_t;
+
+/**
+ * @brief 生命周期状态，由各模块静态持有，以 AUDIO_LIFECYCLE_INIT() 初始化
+ */
+typedef struct {
+    audio_lifecycle_state_t state;  // 当前状态
+    audio_lifecycle_stats_t stats;  // 启停统计
+    int64_t armed_us;               // 等待首块数据的起点，0 表示未在等待
+    int64_t t0;                     // 当前启停操作的起点
+    SemaphoreHandle_t lock;         // 串行化启停（首次使用时创建）
+    StaticSemaphore_t lock_buf;
+} audio_lifecycle_t;
+
+#define AUDIO_LIFECYCLE_INIT() { .state = AUDIO_LIFECYCLE_IDLE }
+
+/**
+ * @brief 进入启停操作：加锁并记下起点
+ */
+void audio_lifecycle_enter(audio_lifecycle_t *lc);
+
+/**
+ * @brief 退出启停操作：按新状态记录耗时并解锁
+ *
+ * 状态由 IDLE 变为 RUNNING 计为构建，由 PAUSED 变为 RUNNING 计为启动，
+ * 变为 PAUSED 计为停止；启动后开始等待首块数据。
+ *
+ * @param lc    生命周期
+ * @param state 操作完成后的状态（操作失败时传入原状态，不计统计）
+ */
+void audio_lifecycle_leave(audio_lifecycle_t *lc, audio_lifecycle_state_t state);
+
+/**
+ * @brief 数据通路在每块数据到达时调用，记录启动后的首块数据耗时（只在等待时记录一次）
+ */
+void audio_lifecycle_data(audio_lifecycle_t *lc);
+
+/**
+ * @brief 获取启停统计
+ */
+void audio_lifecycle_get_stats(const audio_lifecycle_t *lc, audio_lifecycle_stats_t *stats);
+
+/**
+ * @brief 暂停管道并冲刷：等所有元素确认暂停（同步握手）后清空管道内各环形缓冲区
+ *
+ * 元素任务、驱动与缓冲区全部保留，恢复时不再分配内存。
+ */
+esp_err_t audio_lifecycle_pause(audio_pipeline_handle_t pipeline);
+
+/**
+ * @brief 恢复管道，等所有元素确认恢复运行后返回
+ */
+esp_err_t audio_lifecycle_resume(audio_pipeline_handle_t pipeline);
+
+/**
+ * @brief 把管道事件接到共用监听任务（元素错误计入探针），首次调用时创建该任务
+ */
+esp_err_t audio_lifecycle_listen(audio_pipeline_handle_t pipeline);
+
+/**
+ * @brief 从共用监听任务上摘下管道，须在 audio_pipeline_deinit() 之前调用
+ */
+void audio_lifecycle_unlisten(audio_pipeline_handle_t pipeline);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 09:00:00
+ * @LastEditTime: 2026-10-17 09:00:00
+ * @LastEditors: 星年
+ * @Description: 混音内核实现，ESP32-S3使用PIE向量内核，其余平台使用可移植C实现
+ * @FilePath: \audio_manager\main\audio_mix.c
+ * 遇事不决，可问春风
+ */
+#include <stdint.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+#include "audio_mix.h"
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(AUDIO_MIX_FORCE_C)
+/**
+ * @brief PIE内核（见 audio_mix_aes3.S），指针须16字节对齐，n8 为8样点组数，gain 指向Q15增益
+ */
+extern void audio_mix_scale_s16_aes3(int16_t *buf, int n8, const int16_t *gain);
+extern void audio_mix_add_s16_aes3(int16_t *acc, const int16_t *in, int n8);
+extern void audio_mix_mac_s16_aes3(int16_t *acc, const int16_t *in, int n8, const int16_t *gain);
+#define MIX_HAVE_AES3 1
+#endif
+
+static inline int16_t mix_sat16(int32_t v)
+{
+    if (v > INT16_MAX) return INT16_MAX;
+    if (v < INT16_MIN) return INT16_MIN;
+    return (int16_t)v;
+}
+
+/**
+ * @brief 可移植C实现，与PIE版本逐位一致（Q15乘法截断，增益小于1时乘积不会超出16位）
+ */
+static void mix_scale_c(int16_t *buf, size_t n, int32_t gain)
+{
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = (int16_t)((buf[i] * gain) >> 15);
+    }
+}
+
+static void mix_s16_c(int16_t *acc, const int16_t *in, size_t n, uint16_t gain)
+{
+    if (gain >= AUDIO_MIX_UNITY) {
+        for (size_t i = 0; i < n; i++) {
+            acc[i] = mix_sat16(acc[i] + in[i]);
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        acc[i] = mix_sat16(acc[i] + ((in[i] * (int32_t)gain) >> 15));
+    }
+}
+
+void audio_mix_scale_s16(int16_t *buf, size_t n, uint16_t gain)
+{
+    if (gain >= AUDIO_MIX_UNITY) {
+        return;
+    }
+#ifdef MIX_HAVE_AES3
+    if (((uintptr_t)buf & 15) == 0 && n >= 8) {
+        int16_t g = (int16_t)gain;
+        audio_mix_scale_s16_aes3(buf, (int)(n / 8), &g);
+        size_t done = n & ~(size_t)7;
+        buf += done;
+        n -= done;
+    }
+#endif
+    mix_scale_c(buf, n, gain);
+}
+
+void audio_mix_s16(int16_t *acc, const int16_t *in, size_t n, uint16_t gain)
+{
+#ifdef MIX_HAVE_AES3
+    if ((((uintptr_t)acc | (uintptr_t)in) & 15) == 0 && n >= 8) {
+        int16_t g = (int16_t)gain;
+        if (gain >= AUDIO_MIX_UNITY) {
+            audio_mix_add_s16_aes3(acc, in, (int)(n / 8));
+        } else {
+            audio_mix_mac_s16_aes3(acc, in, (int)(n / 8), &g);
+        }
+        size_t done = n & ~(size_t)7;
+        acc += done;
+        in += done;
+        n -= done;
+    }
+#endif
+    mix_s16_c(acc, in, n, gain);
+}
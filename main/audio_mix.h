@@ -0,0 +1,47 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 09:00:00
+ * @LastEditTime: 2026-10-17 09:00:00
+ * @LastEditors: 星年
+ * @Description: 16位PCM混音内核：按路增益缩放后饱和累加，ESP32-S3使用PIE向量内核
+ * @FilePath: \audio_manager\main\audio_mix.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_MIX_UNITY     32768       // 0dB 增益（Q15），小于此值为衰减，0 为静音
+
+/**
+ * @brief 缩放：buf[i] = (buf[i] * gain) >> 15
+ *
+ * gain 为 AUDIO_MIX_UNITY 时不做任何事。buf 16字节对齐时走向量内核。
+ *
+ * @param buf  样点
+ * @param n    样点数
+ * @param gain 增益（Q15，0 ~ AUDIO_MIX_UNITY）
+ */
+void audio_mix_scale_s16(int16_t *buf, size_t n, uint16_t gain);
+
+/**
+ * @brief 混入一路：acc[i] = sat16(acc[i] + ((in[i] * gain) >> 15))
+ *
+ * 每路混入后即饱和，多路同时接近满幅时结果与混入顺序有关。
+ * acc 与 in 均16字节对齐时走向量内核，否则走逐位一致的C实现。
+ *
+ * @param acc  累加结果
+ * @param in   本路样点
+ * @param n    样点数
+ * @param gain 增益（Q15，0 ~ AUDIO_MIX_UNITY）
+ */
+void audio_mix_s16(int16_t *acc, const int16_t *in, size_t n, uint16_t gain);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,181 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 降噪ADF元素实现：凑满一帧后原地降噪并输出，整帧到达时不拷贝
+ * @FilePath: \audio_manager\main\audio_ns.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "audio_element.h"
+#include "audio_mem.h"
+#include "audio_error.h"
+#include "audio_probe.h"
+#include "audio_ns.h"
+
+static const char *TAG = "AUDIO_NS";
+
+typedef struct {
+    audio_ns_cfg_t cfg;             // 配置
+    noise_suppress_t *ns;           // 降噪器
+    int frame_bytes;                // 每帧PCM字节数
+    int16_t *pcm;                   // 不足一帧时的累积缓冲区
+    int pcm_fill;                   // 累积缓冲区已有字节数
+    audio_probe_t *probe;           // 性能探针（按管道注册名）
+} audio_ns_t;
+
+static uint32_t _audio_ns_clock(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+static esp_err_t _audio_ns_open(audio_element_handle_t self)
+{
+    audio_ns_t *an = (audio_ns_t *)audio_element_getdata(self);
+    // 重新打开时重新学习噪声，之前残留的半帧与延迟中的样点一并丢弃
+    noise_suppress_reset(an->ns);
+    an->pcm_fill = 0;
+    an->probe = audio_probe_get(audio_element_get_tag(self));
+    return ESP_OK;
+}
+
+static esp_err_t _audio_ns_close(audio_element_handle_t self)
+{
+    (void)self;
+    return ESP_OK;
+}
+
+/**
+ * @brief 降噪一帧并交给下游
+ */
+static int _audio_ns_frame(audio_element_handle_t self, audio_ns_t *an, int16_t *pcm)
+{
+    uint32_t stamp = audio_probe_begin(an->probe, self);
+    noise_suppress_process(an->ns, pcm, pcm, an->cfg.ns.frame_samples);
+    audio_probe_end(an->probe, stamp);
+    return audio_element_output(self, (char *)pcm, an->frame_bytes);
+}
+
+static audio_element_err_t _audio_ns_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    audio_ns_t *an = (audio_ns_t *)audio_element_getdata(self);
+    int r_size = audio_element_input(self, in_buffer, in_len);
+    if (r_size <= 0) {
+        return r_size;
+    }
+    const char *p = in_buffer;
+    int left = r_size;
+    while (left > 0) {
+        if (an->pcm_fill == 0 && left >= an->frame_bytes) {
+            // 整帧直接在输入缓冲区内原地降噪（缓冲区长度即一帧，读满时走这里）
+            int w = _audio_ns_frame(self, an, (int16_t *)p);
+            if (w < 0) {
+                return w;
+            }
+            p += an->frame_bytes;
+            left -= an->frame_bytes;
+            continue;
+        }
+        int n = an->frame_bytes - an->pcm_fill;
+        if (n > left) {
+            n = left;
+        }
+        memcpy((char *)an->pcm + an->pcm_fill, p, n);
+        an->pcm_fill += n;
+        p += n;
+        left -= n;
+        if (an->pcm_fill == an->frame_bytes) {
+            an->pcm_fill = 0;
+            int w = _audio_ns_frame(self, an, an->pcm);
+            if (w < 0) {
+                return w;
+            }
+        }
+    }
+    return r_size;
+}
+
+static esp_err_t _audio_ns_destroy(audio_element_handle_t self)
+{
+    audio_ns_t *an = (audio_ns_t *)audio_element_getdata(self);
+    audio_arena_t *arena = an->cfg.ns.arena;
+    noise_suppress_destroy(an->ns);
+    audio_arena_free(arena, an->pcm);
+    audio_arena_free(arena, an);
+    return ESP_OK;
+}
+
+uint32_t audio_ns_mem_size(const audio_ns_cfg_t *config)
+{
+    uint32_t ns_bytes = config ? noise_suppress_mem_size(&config->ns) : 0;
+    if (ns_bytes == 0) {
+        return 0;
+    }
+    return ns_bytes + AUDIO_ARENA_SIZE(sizeof(audio_ns_t)) +
+           AUDIO_ARENA_SIZE(config->ns.frame_samples * sizeof(int16_t));
+}
+
+audio_element_handle_t audio_ns_init(audio_ns_cfg_t *config)
+{
+    if (audio_ns_mem_size(config) == 0) {
+        ESP_LOGE(TAG, "invalid noise suppress config");
+        return NULL;
+    }
+    audio_arena_t *arena = config->ns.arena;
+    audio_ns_t *an = (audio_ns_t *)audio_arena_calloc(arena, 1, sizeof(audio_ns_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, an, return NULL);
+    an->cfg = *config;
+    if (!an->cfg.ns.clock_us) {
+        an->cfg.ns.clock_us = _audio_ns_clock;      // 预算控制需要时钟
+    }
+    an->frame_bytes = (int)(config->ns.frame_samples * sizeof(int16_t));
+    an->pcm = (int16_t *)audio_arena_calloc(arena, 1, an->frame_bytes, AUDIO_ARENA_INTERNAL);
+    an->ns = noise_suppress_create(&an->cfg.ns);
+    AUDIO_MEM_CHECK(TAG, an->pcm && an->ns, goto _fail);
+
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = _audio_ns_open;
+    cfg.close = _audio_ns_close;
+    cfg.process = _audio_ns_process;
+    cfg.destroy = _audio_ns_destroy;
+    cfg.buffer_len = an->frame_bytes;
+    cfg.out_rb_size = config->out_rb_size;
+    cfg.task_stack = config->task_stack;
+    cfg.task_core = config->task_core;
+    cfg.task_prio = config->task_prio;
+    cfg.stack_in_ext = config->stack_in_ext;
+    cfg.tag = "ns";
+
+    audio_element_handle_t el = audio_element_init(&cfg);
+    AUDIO_MEM_CHECK(TAG, el, goto _fail);
+    audio_element_setdata(el, an);
+    return el;
+
+_fail:
+    noise_suppress_destroy(an->ns);
+    audio_arena_free(arena, an->pcm);
+    audio_arena_free(arena, an);
+    return NULL;
+}
+
+int audio_ns_set_level(audio_element_handle_t self, noise_suppress_level_t level)
+{
+    if (!self || !audio_element_getdata(self)) {
+        return -1;
+    }
+    audio_ns_t *an = (audio_ns_t *)audio_element_getdata(self);
+    return noise_suppress_set_level(an->ns, level);
+}
+
+int audio_ns_get_stats(audio_element_handle_t self, noise_suppress_stats_t *stats)
+{
+    if (!self || !stats || !audio_element_getdata(self)) {
+        return -1;
+    }
+    audio_ns_t *an = (audio_ns_t *)audio_element_getdata(self);
+    noise_suppress_get_stats(an->ns, stats);
+    return 0;
+}
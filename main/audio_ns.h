@@ -0,0 +1,78 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 降噪接入：把 noise_suppress 包装成ADF元素，链接在采集与编码之间 [capture] -> [ns] -> [opus]
+ * @FilePath: \audio_manager\main\audio_ns.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_element.h"
+#include "noise_suppress.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_NS_RINGBUFFER     (2 * 1024)      // 输出环形缓冲区大小
+#define AUDIO_NS_TASK_STACK     (3 * 1024)      // 元素任务堆栈（FFT工作区在句柄内，不占堆栈）
+#define AUDIO_NS_TASK_CORE      (0)             // 任务绑定核心
+#define AUDIO_NS_TASK_PRIO      (5)             // 任务优先级
+
+/**
+ * @brief 降噪元素配置
+ */
+typedef struct {
+    noise_suppress_cfg_t ns;            // 降噪配置：frame_samples 为元素每次处理的样点数，clock_us 为NULL时使用esp_timer
+    int  out_rb_size;                   // 输出环形缓冲区大小
+    int  task_stack;                    // 任务堆栈大小
+    int  task_core;                     // 任务绑定核心
+    int  task_prio;                     // 任务优先级
+    bool stack_in_ext;                  // 堆栈是否放在外部RAM
+} audio_ns_cfg_t;
+
+#define DEFAULT_AUDIO_NS_CONFIG() {                 \
+    .ns           = DEFAULT_NOISE_SUPPRESS_CONFIG(),\
+    .out_rb_size  = AUDIO_NS_RINGBUFFER,            \
+    .task_stack   = AUDIO_NS_TASK_STACK,            \
+    .task_core    = AUDIO_NS_TASK_CORE,             \
+    .task_prio    = AUDIO_NS_TASK_PRIO,             \
+    .stack_in_ext = false,                          \
+}
+
+/**
+ * @brief 创建降噪元素（16kHz单声道16位PCM进出，输出相对输入固定延迟 delay_samples）
+ *
+ * 输入按 ns.frame_samples 凑帧后原地降噪再输出；降噪器与帧缓冲从 ns.arena 一次分配，启停不再分配。
+ *
+ * @param config 元素配置
+ * @return 元素句柄，失败返回NULL
+ */
+audio_element_handle_t audio_ns_init(audio_ns_cfg_t *config);
+
+/**
+ * @brief 按配置计算元素所需内存（片内SRAM，按内存区对齐取整），用于预留内存区
+ */
+uint32_t audio_ns_mem_size(const audio_ns_cfg_t *config);
+
+/**
+ * @brief 调整降噪强度，下一个10ms帧生效
+ *
+ * @return 0，参数非法返回-1
+ */
+int audio_ns_set_level(audio_element_handle_t self, noise_suppress_level_t level);
+
+/**
+ * @brief 获取降噪统计
+ *
+ * @return 0，参数非法返回-1
+ */
+int audio_ns_get_stats(audio_element_handle_t self, noise_suppress_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,297 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 15:00:00
+ * @LastEditTime: 2026-10-16 15:00:00
+ * @LastEditors: 星年
+ * @Description: 管道元素探针实现
+ * @FilePath: \audio_manager\main\audio_probe.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include <stdatomic.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ringbuf.h"
+#include "audio_probe.h"
+
+#if AUDIO_PROBE_ENABLE
+
+static const char *TAG = "AUDIO_PROBE";
+
+#define AUDIO_PROBE_CYCLES_PER_US   (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+#define AUDIO_PROBE_RECORD_SIZE     (32)
+#define AUDIO_PROBE_LOG_TASK_STACK  (3 * 1024)
+#define AUDIO_PROBE_LOG_TASK_PRIO   (1)
+
+/*
+ * 计数均由元素任务以relaxed原子操作更新（每个探针通常只有一个写者），
+ * 快照任务读取后以差值计算窗口统计；水位与最大耗时在快照时交换复位。
+ * 周期耗时以32位计数，单个窗口内累计不超过 2^32 周期（160MHz下约26秒）即可正确求差。
+ */
+struct audio_probe {
+    char name[AUDIO_PROBE_NAME_LEN];
+    _Atomic bool ready;                 // 名称写入完成后置位，之后才能被查找到
+    _Atomic uint32_t calls;
+    _Atomic uint32_t busy_cycles;
+    _Atomic uint32_t max_cycles;
+    _Atomic uint32_t in_lo;             // 水位（%），lo复位为0xff、hi复位为0，未采样时保持复位值
+    _Atomic uint32_t in_hi;
+    _Atomic uint32_t out_lo;
+    _Atomic uint32_t out_hi;
+    _Atomic uint32_t underruns;
+    _Atomic uint32_t overruns;
+    _Atomic uint32_t errors;
+    uint32_t last_calls;                // 以下仅快照任务访问
+    uint32_t last_busy;
+};
+
+static audio_probe_t s_probes[AUDIO_PROBE_MAX];
+static _Atomic uint32_t s_probe_count = 0;
+static int64_t s_window_start_us = 0;
+static uint16_t s_last_window_ms = 0;
+static TaskHandle_t s_log_task = NULL;
+static _Atomic bool s_log_stop = false;
+static uint32_t s_log_period_ms = 0;
+
+static void audio_probe_reset_levels(audio_probe_t *p)
+{
+    atomic_store_explicit(&p->in_lo, AUDIO_PROBE_LEVEL_NONE, memory_order_relaxed);
+    atomic_store_explicit(&p->in_hi, 0, memory_order_relaxed);
+    atomic_store_explicit(&p->out_lo, AUDIO_PROBE_LEVEL_NONE, memory_order_relaxed);
+    atomic_store_explicit(&p->out_hi, 0, memory_order_relaxed);
+}
+
+audio_probe_t *audio_probe_get(const char *name)
+{
+    if (!name) {
+        return NULL;
+    }
+    uint32_t n = atomic_load_explicit(&s_probe_count, memory_order_acquire);
+    for (uint32_t i = 0; i < n && i < AUDIO_PROBE_MAX; i++) {
+        audio_probe_t *p = &s_probes[i];
+        if (atomic_load_explicit(&p->ready, memory_order_acquire) &&
+                strncmp(p->name, name, AUDIO_PROBE_NAME_LEN - 1) == 0) {
+            return p;
+        }
+    }
+    // 同名探针几乎同时创建时可能重复登记，只影响统计分散到两个槽位，不影响正确性
+    uint32_t idx = atomic_fetch_add_explicit(&s_probe_count, 1, memory_order_acq_rel);
+    if (idx >= AUDIO_PROBE_MAX) {
+        atomic_store_explicit(&s_probe_count, AUDIO_PROBE_MAX, memory_order_release);
+        ESP_LOGW(TAG, "probe table full, %s not tracked", name);
+        return NULL;
+    }
+    audio_probe_t *p = &s_probes[idx];
+    strncpy(p->name, name, AUDIO_PROBE_NAME_LEN - 1);
+    p->name[AUDIO_PROBE_NAME_LEN - 1] = '\0';
+    audio_probe_reset_levels(p);
+    atomic_store_explicit(&p->ready, true, memory_order_release);
+    return p;
+}
+
+static inline void audio_probe_level(_Atomic uint32_t *lo, _Atomic uint32_t *hi, uint32_t level)
+{
+    if (level < atomic_load_explicit(lo, memory_order_relaxed)) {
+        atomic_store_explicit(lo, level, memory_order_relaxed);
+    }
+    if (level > atomic_load_explicit(hi, memory_order_relaxed)) {
+        atomic_store_explicit(hi, level, memory_order_relaxed);
+    }
+}
+
+uint32_t audio_probe_begin(audio_probe_t *probe, audio_element_handle_t el)
+{
+    if (!probe) {
+        return 0;
+    }
+    if (el) {
+        ringbuf_handle_t rb = audio_element_get_input_ringbuf(el);
+        int size = rb ? rb_get_size(rb) : 0;
+        if (size > 0) {
+            int filled = rb_bytes_filled(rb);
+            audio_probe_level(&probe->in_lo, &probe->in_hi, (uint32_t)filled * 100 / size);
+            if (filled >= size) {
+                atomic_fetch_add_explicit(&probe->overruns, 1, memory_order_relaxed);
+            }
+        }
+        rb = audio_element_get_output_ringbuf(el);
+        size = rb ? rb_get_size(rb) : 0;
+        if (size > 0) {
+            int filled = rb_bytes_filled(rb);
+            audio_probe_level(&probe->out_lo, &probe->out_hi, (uint32_t)filled * 100 / size);
+            if (filled == 0) {
+                atomic_fetch_add_explicit(&probe->underruns, 1, memory_order_relaxed);
+            }
+        }
+    }
+    return esp_cpu_get_cycle_count();
+}
+
+void audio_probe_end(audio_probe_t *probe, uint32_t stamp)
+{
+    if (!probe) {
+        return;
+    }
+    uint32_t cycles = esp_cpu_get_cycle_count() - stamp;
+    atomic_fetch_add_explicit(&probe->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&probe->busy_cycles, cycles, memory_order_relaxed);
+    if (cycles > atomic_load_explicit(&probe->max_cycles, memory_order_relaxed)) {
+        atomic_store_explicit(&probe->max_cycles, cycles, memory_order_relaxed);
+    }
+}
+
+void audio_probe_error(audio_probe_t *probe)
+{
+    if (probe) {
+        atomic_fetch_add_explicit(&probe->errors, 1, memory_order_relaxed);
+    }
+}
+
+void audio_probe_on_event(const audio_event_iface_msg_t *msg)
+{
+    if (!msg || msg->source_type != AUDIO_ELEMENT_TYPE_ELEMENT || msg->cmd != AEL_MSG_CMD_REPORT_STATUS) {
+        return;
+    }
+    int status = (int)(intptr_t)msg->data;
+    if (status < AEL_STATUS_ERROR_OPEN || status > AEL_STATUS_ERROR_UNKNOWN) {
+        return;
+    }
+    const char *tag = audio_element_get_tag((audio_element_handle_t)msg->source);
+    ESP_LOGW(TAG, "%s reported error status %d", tag ? tag : "?", status);
+    audio_probe_error(audio_probe_get(tag));
+}
+
+static uint16_t audio_probe_clamp16(uint32_t v)
+{
+    return v > UINT16_MAX ? UINT16_MAX : (uint16_t)v;
+}
+
+int audio_probe_snapshot(audio_probe_snapshot_t *out, int max)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t window_us = s_window_start_us ? now - s_window_start_us : 0;
+    s_window_start_us = now;
+    s_last_window_ms = audio_probe_clamp16((uint32_t)(window_us / 1000));
+
+    uint32_t n = atomic_load_explicit(&s_probe_count, memory_order_acquire);
+    int filled = 0;
+    for (uint32_t i = 0; i < n && i < AUDIO_PROBE_MAX && filled < max; i++) {
+        audio_probe_t *p = &s_probes[i];
+        if (!atomic_load_explicit(&p->ready, memory_order_acquire)) {
+            continue;
+        }
+        audio_probe_snapshot_t *s = &out[filled++];
+        uint32_t calls = atomic_load_explicit(&p->calls, memory_order_relaxed);
+        uint32_t busy = atomic_load_explicit(&p->busy_cycles, memory_order_relaxed);
+        uint32_t d_calls = calls - p->last_calls;
+        uint32_t d_busy_us = (busy - p->last_busy) / AUDIO_PROBE_CYCLES_PER_US;
+        p->last_calls = calls;
+        p->last_busy = busy;
+
+        memcpy(s->name, p->name, AUDIO_PROBE_NAME_LEN);
+        s->calls = d_calls;
+        s->cpu_permille = window_us > 0 ? audio_probe_clamp16((uint32_t)((uint64_t)d_busy_us * 1000 / window_us)) : 0;
+        s->avg_us = d_calls ? audio_probe_clamp16(d_busy_us / d_calls) : 0;
+        s->max_us = audio_probe_clamp16(atomic_exchange_explicit(&p->max_cycles, 0, memory_order_relaxed) / AUDIO_PROBE_CYCLES_PER_US);
+        s->in_lo = (uint8_t)atomic_exchange_explicit(&p->in_lo, AUDIO_PROBE_LEVEL_NONE, memory_order_relaxed);
+        s->in_hi = (uint8_t)atomic_exchange_explicit(&p->in_hi, 0, memory_order_relaxed);
+        s->out_lo = (uint8_t)atomic_exchange_explicit(&p->out_lo, AUDIO_PROBE_LEVEL_NONE, memory_order_relaxed);
+        s->out_hi = (uint8_t)atomic_exchange_explicit(&p->out_hi, 0, memory_order_relaxed);
+        if (s->in_lo == AUDIO_PROBE_LEVEL_NONE) {
+            s->in_hi = AUDIO_PROBE_LEVEL_NONE;
+        }
+        if (s->out_lo == AUDIO_PROBE_LEVEL_NONE) {
+            s->out_hi = AUDIO_PROBE_LEVEL_NONE;
+        }
+        s->underruns = atomic_load_explicit(&p->underruns, memory_order_relaxed);
+        s->overruns = atomic_load_explicit(&p->overruns, memory_order_relaxed);
+        s->errors = atomic_load_explicit(&p->errors, memory_order_relaxed);
+    }
+    return filled;
+}
+
+static inline uint8_t *audio_probe_put16(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+int audio_probe_dump(uint8_t *buf, size_t cap)
+{
+    audio_probe_snapshot_t snap[AUDIO_PROBE_MAX];
+    int n = audio_probe_snapshot(snap, AUDIO_PROBE_MAX);
+    size_t need = 4 + (size_t)n * AUDIO_PROBE_RECORD_SIZE;
+    if (!buf || cap < need) {
+        return -1;
+    }
+    uint8_t *p = buf;
+    *p++ = AUDIO_PROBE_DUMP_VERSION;
+    *p++ = (uint8_t)n;
+    p = audio_probe_put16(p, s_last_window_ms);
+    for (int i = 0; i < n; i++) {
+        const audio_probe_snapshot_t *s = &snap[i];
+        memcpy(p, s->name, AUDIO_PROBE_NAME_LEN);
+        p += AUDIO_PROBE_NAME_LEN;
+        p = audio_probe_put16(p, audio_probe_clamp16(s->calls));
+        p = audio_probe_put16(p, s->cpu_permille);
+        p = audio_probe_put16(p, s->avg_us);
+        p = audio_probe_put16(p, s->max_us);
+        *p++ = s->in_lo;
+        *p++ = s->in_hi;
+        *p++ = s->out_lo;
+        *p++ = s->out_hi;
+        p = audio_probe_put16(p, s->underruns & 0xffff);
+        p = audio_probe_put16(p, s->overruns & 0xffff);
+    }
+    return (int)(p - buf);
+}
+
+static void audio_probe_log_task(void *arg)
+{
+    audio_probe_snapshot_t snap[AUDIO_PROBE_MAX];
+    audio_probe_snapshot(snap, AUDIO_PROBE_MAX);    // 丢弃首个窗口，从此刻开始计时
+    while (!atomic_load(&s_log_stop)) {
+        vTaskDelay(pdMS_TO_TICKS(s_log_period_ms));
+        int n = audio_probe_snapshot(snap, AUDIO_PROBE_MAX);
+        for (int i = 0; i < n; i++) {
+            const audio_probe_snapshot_t *s = &snap[i];
+            // 名称 调用次数 CPU‰ 平均/最大耗时 输入/输出水位 欠载/溢出/错误
+            ESP_LOGI(TAG, "%-15s n=%-4u cpu=%u.%u%% avg=%uus max=%uus in=%u-%u out=%u-%u ur=%u or=%u err=%u",
+                     s->name, (unsigned)s->calls, s->cpu_permille / 10, s->cpu_permille % 10,
+                     s->avg_us, s->max_us, s->in_lo, s->in_hi, s->out_lo, s->out_hi,
+                     (unsigned)s->underruns, (unsigned)s->overruns, (unsigned)s->errors);
+        }
+    }
+    s_log_task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t audio_probe_start_log(uint32_t period_ms)
+{
+    if (s_log_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (period_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_log_period_ms = period_ms;
+    atomic_store(&s_log_stop, false);
+    if (xTaskCreate(audio_probe_log_task, "audio_probe", AUDIO_PROBE_LOG_TASK_STACK, NULL,
+                    AUDIO_PROBE_LOG_TASK_PRIO, &s_log_task) != pdPASS) {
+        s_log_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void audio_probe_stop_log(void)
+{
+    atomic_store(&s_log_stop, true);
+}
+
+#endif
@@ -0,0 +1,142 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 15:00:00
+ * @LastEditTime: 2026-10-16 15:00:00
+ * @LastEditors: 星年
+ * @Description: 管道元素探针：无锁计数各元素处理耗时、环形缓冲区水位、饥饿/阻塞次数与错误状态，支持快照、周期日志与二进制导出
+ * @FilePath: \audio_manager\main\audio_probe.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "audio_element.h"
+#include "audio_event_iface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef AUDIO_PROBE_ENABLE
+#define AUDIO_PROBE_ENABLE          1       // 置0时探针调用全部编译为空
+#endif
+
+#define AUDIO_PROBE_MAX             (16)    // 最多探针数
+#define AUDIO_PROBE_NAME_LEN        (16)    // 探针名最大长度（含结尾0）
+#define AUDIO_PROBE_LEVEL_NONE      (0xff)  // 快照中表示该方向没有环形缓冲区
+#define AUDIO_PROBE_DUMP_VERSION    (1)     // 二进制导出格式版本
+
+typedef struct audio_probe audio_probe_t;
+
+/**
+ * @brief 单个探针的快照（两次快照之间的窗口统计 + 累计计数）
+ */
+typedef struct {
+    char name[AUDIO_PROBE_NAME_LEN];    // 探针名
+    uint32_t calls;                     // 窗口内处理次数
+    uint16_t cpu_permille;              // 窗口内处理耗时占墙钟时间的千分比
+    uint16_t avg_us;                    // 窗口内平均每次耗时
+    uint16_t max_us;                    // 窗口内最大单次耗时
+    uint8_t in_lo;                      // 窗口内输入环形缓冲区最低水位（%）
+    uint8_t in_hi;                      // 窗口内输入环形缓冲区最高水位（%）
+    uint8_t out_lo;                     // 窗口内输出环形缓冲区最低水位（%）
+    uint8_t out_hi;                     // 窗口内输出环形缓冲区最高水位（%）
+    uint32_t underruns;                 // 累计：处理开始时输出环形缓冲区已空（下游即将饥饿，播放侧即I2S欠载）
+    uint32_t overruns;                  // 累计：处理开始时输入环形缓冲区已满（上游被阻塞，采集侧即I2S DMA溢出）
+    uint32_t errors;                    // 累计：元素上报的错误状态
+} audio_probe_snapshot_t;
+
+#if AUDIO_PROBE_ENABLE
+
+/**
+ * @brief 按名称获取探针，不存在时创建（无锁，可在元素init中调用）
+ *
+ * 元素应在open回调中以 audio_element_get_tag() 取得的名称获取探针，此时tag已是注册到管道时的名称，
+ * 与管道事件中的元素tag一致，错误状态才能计入同一探针。
+ * 同名探针在管道重建后继续累计。探针数超过 AUDIO_PROBE_MAX 时返回NULL，
+ * 之后对NULL探针的调用均为空操作。
+ */
+audio_probe_t *audio_probe_get(const char *name);
+
+/**
+ * @brief 元素处理开始：采样输入/输出环形缓冲区水位，返回时间戳
+ *
+ * 应在阻塞读取输入之后调用，只计入元素自身的处理耗时。
+ *
+ * @param probe 探针（可为NULL）
+ * @param el    元素（为NULL时不采样环形缓冲区，用于编解码等函数级计时）
+ * @return 传给 audio_probe_end() 的时间戳
+ */
+uint32_t audio_probe_begin(audio_probe_t *probe, audio_element_handle_t el);
+
+/**
+ * @brief 元素处理结束，累计本次耗时
+ */
+void audio_probe_end(audio_probe_t *probe, uint32_t stamp);
+
+/**
+ * @brief 记录一次元素上报的错误状态
+ */
+void audio_probe_error(audio_probe_t *probe);
+
+/**
+ * @brief 处理管道事件：元素上报的错误状态按元素tag计入对应探针
+ *
+ * 供各管道的事件循环调用，替代直接丢弃事件。
+ */
+void audio_probe_on_event(const audio_event_iface_msg_t *msg);
+
+/**
+ * @brief 获取全部探针快照，并开始新的统计窗口（仅允许一个任务调用）
+ *
+ * @param out 输出数组
+ * @param max 数组长度
+ * @return 实际填写的探针数
+ */
+int audio_probe_snapshot(audio_probe_snapshot_t *out, int max);
+
+/**
+ * @brief 以紧凑二进制格式导出快照（小端）
+ *
+ * 格式：u8 版本, u8 探针数, u16 窗口毫秒, 之后每个探针 32 字节：
+ * name[16], u16 calls, u16 cpu_permille, u16 avg_us, u16 max_us, u8 in_lo, u8 in_hi, u8 out_lo, u8 out_hi,
+ * u16 underruns, u16 overruns（累计值取低16位）
+ *
+ * @param buf 输出缓冲区
+ * @param cap 缓冲区大小
+ * @return 写入字节数，缓冲区不足返回-1
+ */
+int audio_probe_dump(uint8_t *buf, size_t cap);
+
+/**
+ * @brief 启动周期日志任务，每个周期打印一行/探针的紧凑统计
+ *
+ * @param period_ms 周期（毫秒）
+ * @return ESP_OK，已启动返回 ESP_ERR_INVALID_STATE，创建任务失败返回 ESP_ERR_NO_MEM
+ */
+esp_err_t audio_probe_start_log(uint32_t period_ms);
+
+/**
+ * @brief 停止周期日志任务
+ */
+void audio_probe_stop_log(void);
+
+#else
+
+#define audio_probe_get(name)               ((audio_probe_t *)NULL)
+#define audio_probe_begin(probe, el)        ((void)(probe), (void)(el), 0u)
+#define audio_probe_end(probe, stamp)       ((void)(probe), (void)(stamp))
+#define audio_probe_error(probe)            ((void)(probe))
+#define audio_probe_on_event(msg)           ((void)(msg))
+#define audio_probe_snapshot(out, max)      ((void)(out), (void)(max), 0)
+#define audio_probe_dump(buf, cap)          ((void)(buf), (void)(cap), -1)
+#define audio_probe_start_log(period_ms)    ((void)(period_ms), ESP_ERR_NOT_SUPPORTED)
+#define audio_probe_stop_log()              ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,27 +11,42 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "audio_lifecycle.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief 启动音频重采样任务
+ * @brief 启动音频监听
  *
- * 该函数会创建并启动一个后台任务，负责从INMP441采集音频数据，
- * 重采样后输出到MAX98357A。调用此函数后，音频重采样会自动进行。
+ * 首次调用时构建监听管道，订阅共享采集前端（audio_capture）的16kHz PCM，
+ * 输出到MAX98357A。可与 opus_encode_recorder 同时运行，二者共用同一次采集与重采样。
+ * 停止之后再次启动只恢复已暂停的管道，不创建任务、不分配内存。
  */
 void audio_resample_start(void);
 
 /**
- * @brief 停止音频重采样任务
+ * @brief 停止音频监听
  *
- * 该函数会终止后台的音频重采样任务，释放相关资源。
- * 停止后如需再次重采样需重新调用 audio_resample_start()。
+ * 暂停监听管道与采集订阅，等各元素确认暂停后返回；I2S驱动与管道保留，暂停期间输出静音。
+ * 彻底释放请调用 audio_resample_deinit()。
  */
 void audio_resample_stop(void);
 
+/**
+ * @brief 释放监听管道、I2S驱动与采集订阅，之后再次启动会重新构建
+ */
+void audio_resample_deinit(void);
+
+/**
+ * @brief 获取监听管道的启停统计
+ *
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int audio_resample_get_lifecycle(audio_lifecycle_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif 
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 19:00:00
+ * @LastEditTime: 2026-10-16 19:00:00
+ * @LastEditors: 星年
+ * @Description: 采集格式转换内核实现，ESP32-S3使用PIE向量内核，其余平台使用可移植C实现
+ * @FilePath: \audio_manager\main\capture_convert.c
+ * 遇事不决，可问春风
+ */
+#include <stdint.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+#include "capture_convert.h"
+
+#define CONV_DC_LIMIT_Q8    (((1 << 23) - 1) << 8)      // 直流估计不超出24位样点范围
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(CAPTURE_CONV_FORCE_C)
+/**
+ * @brief PIE内核参数（见 capture_convert_aes3.S，布局与汇编中的偏移一致）
+ */
+typedef struct {
+    int32_t dc;         // 0:  直流（24位样点单位）
+    int32_t hi;         // 4:  限幅上界
+    int32_t lo;         // 8:  限幅下界
+    int16_t fine;       // 12: 细增益（Q15）
+    int16_t one;        // 14: 常数1，用于向量求和
+    uint32_t shift;     // 16: 24位 -> 16位右移位数
+    uint32_t fine_on;   // 20: 是否乘细增益
+} capture_conv_aes3_args_t;
+
+/**
+ * @brief PIE 16位转换内核
+ *
+ * in 可不对齐，out 必须16字节对齐，n8 为8样点组数；返回本段去直流后16位样点（乘细增益前）之和。
+ */
+extern int32_t capture_conv_s16_aes3(const int32_t *in, int16_t *out, int n8, const capture_conv_aes3_args_t *args);
+#define CONV_HAVE_AES3 1
+#endif
+
+static inline int32_t conv_clamp(int32_t v, int32_t lo, int32_t hi)
+{
+    if (v > hi) return hi;
+    if (v < lo) return lo;
+    return v;
+}
+
+/**
+ * @brief 可移植C内核，与PIE版本逐位一致（16位乘法截断、限幅后移位不会溢出）
+ */
+static int32_t conv_s16_c(const capture_conv_t *cv, int32_t dc, const int32_t *in, int16_t *out, size_t n)
+{
+    int32_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        int32_t p = conv_clamp((in[i] >> 8) - dc, cv->lo, cv->hi) >> cv->shift;
+        sum += p;
+        out[i] = (int16_t)(cv->fine_q15 ? (p * cv->fine_q15) >> 15 : p);
+    }
+    return sum;
+}
+
+/**
+ * @brief 以本块去直流后的输出更新直流估计（一阶反馈，等效每样点系数 2^-dc_shift）
+ */
+static void conv_track_dc(capture_conv_t *cv, int32_t sum)
+{
+    if (!cv->dc_shift) {
+        return;
+    }
+    int64_t dc = cv->dc_q8 + (((int64_t)sum * (1 << (cv->shift + 8))) >> cv->dc_shift);
+    if (dc > CONV_DC_LIMIT_Q8) {
+        dc = CONV_DC_LIMIT_Q8;
+    } else if (dc < -CONV_DC_LIMIT_Q8) {
+        dc = -CONV_DC_LIMIT_Q8;
+    }
+    cv->dc_q8 = (int32_t)dc;
+}
+
+int capture_conv_init(capture_conv_t *cv, const capture_conv_cfg_t *cfg)
+{
+    capture_conv_cfg_t def = DEFAULT_CAPTURE_CONV_CONFIG();
+    if (!cfg) {
+        cfg = &def;
+    }
+    if (cfg->gain_q12 == 0 || cfg->gain_q12 > CAPTURE_CONV_MAX_GAIN_Q12 || cfg->dc_shift > 24) {
+        return -1;
+    }
+    // 增益 = 2^gs * fine/32768，fine 落在 (16384, 32768]，恰为32768时省去乘法
+    uint8_t gs = 0;
+    while (cfg->gain_q12 > ((uint32_t)CAPTURE_CONV_UNITY_Q12 << gs)) {
+        gs++;
+    }
+    uint32_t fine = (uint32_t)(((uint64_t)cfg->gain_q12 << 15) / ((uint32_t)CAPTURE_CONV_UNITY_Q12 << gs));
+    cv->gain_shift = gs;
+    cv->shift = 8 - gs;
+    cv->fine_q15 = fine >= 32768 ? 0 : (int16_t)fine;
+    cv->lo = -(1 << (23 - gs));
+    cv->hi = (1 << (23 - gs)) - 1;
+    cv->dc_shift = cfg->dc_shift;
+    cv->dc_q8 = 0;
+    return 0;
+}
+
+void capture_conv_reset(capture_conv_t *cv)
+{
+    cv->dc_q8 = 0;
+}
+
+void capture_conv_s16(capture_conv_t *cv, const int32_t *in, int16_t *out, size_t n)
+{
+    int32_t dc = cv->dc_q8 >> 8;
+#ifdef CONV_HAVE_AES3
+    // 先用C处理到输出16字节对齐，中段交给PIE，尾部不足8个样点再用C
+    size_t head = ((16 - ((uintptr_t)out & 15)) & 15) / sizeof(int16_t);
+    if (head > n) {
+        head = n;
+    }
+    int32_t sum = conv_s16_c(cv, dc, in, out, head);
+    size_t n8 = (n - head) / 8;
+    if (n8 > 0) {
+        capture_conv_aes3_args_t args = {
+            .dc = dc, .hi = cv->hi, .lo = cv->lo,
+            .fine = cv->fine_q15, .one = 1,
+            .shift = cv->shift, .fine_on = cv->fine_q15 != 0,
+        };
+        sum += capture_conv_s16_aes3(in + head, out + head, (int)n8, &args);
+    }
+    size_t done = head + n8 * 8;
+    sum += conv_s16_c(cv, dc, in + done, out + done, n - done);
+#else
+    int32_t sum = conv_s16_c(cv, dc, in, out, n);
+#endif
+    conv_track_dc(cv, sum);
+}
+
+void capture_conv_q31(capture_conv_t *cv, const int32_t *in, int32_t *out, size_t n)
+{
+    int32_t dc = cv->dc_q8 >> 8;
+    int32_t sum = 0;
+    uint8_t up = 8 + cv->gain_shift;
+    for (size_t i = 0; i < n; i++) {
+        int32_t v = conv_clamp((in[i] >> 8) - dc, cv->lo, cv->hi);
+        // 直流反馈取与16位版本相同的量，两种输出格式的直流轨迹一致
+        sum += v >> cv->shift;
+        int32_t y = (int32_t)((uint32_t)v << up);
+        out[i] = cv->fine_q15 ? (int32_t)(((int64_t)y * cv->fine_q15) >> 15) : y;
+    }
+    conv_track_dc(cv, sum);
+}
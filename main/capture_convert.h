@@ -0,0 +1,95 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 19:00:00
+ * @LastEditTime: 2026-10-16 19:00:00
+ * @LastEditors: 星年
+ * @Description: 采集格式转换内核：24-in-32 I2S DMA字一次遍历完成取位、去直流、固定增益与饱和，输出16位或Q31
+ * @FilePath: \audio_manager\main\capture_convert.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAPTURE_CONV_UNITY_Q12      4096                // 0dB 增益（Q12）
+#define CAPTURE_CONV_MAX_GAIN_Q12   (4096 << 8)         // 最大增益 +48dB
+#define CAPTURE_CONV_PAD_BYTES      16                  // SIMD预取会越过输入末尾读取的字节数
+
+/**
+ * @brief 转换配置
+ */
+typedef struct {
+    uint32_t gain_q12;      // 固定增益（Q12，4096 = 0dB），不超过 CAPTURE_CONV_MAX_GAIN_Q12
+    uint8_t  dc_shift;      // 去直流反馈系数 2^-dc_shift（每样点），截止约 fs*2^-dc_shift/2π；0 关闭去直流
+} capture_conv_cfg_t;
+
+#define DEFAULT_CAPTURE_CONV_CONFIG() {     \
+    .gain_q12 = CAPTURE_CONV_UNITY_Q12,     \
+    .dc_shift = 10,                         \
+}
+
+/**
+ * @brief 转换状态
+ *
+ * 增益拆为 2^gain_shift 的移位与 fine_q15/32768 的细增益（fine_q15 为0表示恰为2的整数次幂），
+ * 使SIMD版本只需32位移位/比较与16位乘法。
+ * 直流估计按块反馈更新：每次调用结束时累加本块去直流后的输出，下一块开始生效。
+ */
+typedef struct {
+    int32_t dc_q8;          // 直流估计（24位样点单位，Q8）
+    int32_t lo;             // 去直流后的限幅下界（24位样点单位），保证移位后不超出16位
+    int32_t hi;             // 限幅上界
+    int16_t fine_q15;       // 细增益（Q15），0 表示不做乘法
+    uint8_t shift;          // 24位 -> 16位的右移位数（8 - gain_shift）
+    uint8_t gain_shift;     // 增益中的2次幂部分
+    uint8_t dc_shift;       // 同配置
+} capture_conv_t;
+
+/**
+ * @brief 按配置初始化转换状态（直流估计清零）
+ *
+ * @param cv  转换状态
+ * @param cfg 配置，NULL 使用默认配置
+ * @return 0，增益超出范围返回-1
+ */
+int capture_conv_init(capture_conv_t *cv, const capture_conv_cfg_t *cfg);
+
+/**
+ * @brief 清空直流估计
+ */
+void capture_conv_reset(capture_conv_t *cv);
+
+/**
+ * @brief 转换为16位样点
+ *
+ * 每个样点：取DMA字高24位，减直流，按增益限幅后右移到16位，再乘细增益（截断）。
+ * in 可不对齐，但末尾之后须有 CAPTURE_CONV_PAD_BYTES 字节可读；out 无对齐要求。
+ * 单次 n 不应超过 2^dc_shift，否则直流反馈环会振荡。
+ *
+ * @param cv  转换状态
+ * @param in  24-in-32 DMA字（左对齐，低8位忽略）
+ * @param out 输出样点
+ * @param n   样点数
+ */
+void capture_conv_s16(capture_conv_t *cv, const int32_t *in, int16_t *out, size_t n);
+
+/**
+ * @brief 转换为Q31样点（保留全部24位精度）
+ *
+ * 与 capture_conv_s16 共用同一直流估计与限幅，增益为2的整数次幂时输出右移16位与16位版本逐位一致。
+ *
+ * @param cv  转换状态
+ * @param in  24-in-32 DMA字
+ * @param out 输出样点（可与 in 相同）
+ * @param n   样点数
+ */
+void capture_conv_q31(capture_conv_t *cv, const int32_t *in, int32_t *out, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,208 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 14:00:00
+ * @LastEditTime: 2026-10-17 14:00:00
+ * @LastEditors: 星年
+ * @Description: 时钟漂移补偿异步重采样实现：Q32读指针按比值步进，16抽头分数延迟插值（相邻相位线性插值），
+ *               PI控制器按平滑后的水位误差给出比值，带积分限幅与变化率限制
+ * @FilePath: \audio_manager\main\drift_asrc.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "drift_asrc.h"
+#include "drift_asrc_coef.h"
+
+#define DRIFT_ASRC_BUF_FRAMES   (DRIFT_ASRC_TAPS - 1 + DRIFT_ASRC_BLOCK)
+#define DRIFT_ASRC_PHASE_SHIFT  (32 - 7)                // frac 高7位为相位（PHASES = 128）
+#define DRIFT_ASRC_MU_SHIFT     (DRIFT_ASRC_PHASE_SHIFT - 15)
+#define DRIFT_ASRC_INTEG_SCALE  1000000000LL            // 积分累加器以 ppb*1e9 计，避免小误差被截断
+
+struct drift_asrc {
+    drift_asrc_cfg_t cfg;
+    /* buf 前 TAPS-1 帧为历史，之后为本批新输入；end 为下一个输出的窗口末端，frac 为其分数位置 */
+    int16_t buf[DRIFT_ASRC_BUF_FRAMES * DRIFT_ASRC_MAX_CHANNELS] __attribute__((aligned(16)));
+    uint32_t fill;                  // buf 中有效帧数
+    uint32_t end;                   // 窗口末端帧下标
+    uint32_t frac;                  // 分数位置（Q32）
+    uint64_t step;                  // 每个输出样点前进的输入样点数（Q32）
+    int64_t err_q8;                 // 平滑后的水位误差（微秒，Q8）
+    int64_t integ;                  // 误差积分（ppb * 1e9）
+    bool primed;                    // 平滑状态已由首次测量初始化
+    drift_asrc_stats_t stats;
+};
+
+static inline int16_t _drift_asrc_sat16(int32_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+static void _drift_asrc_set_ratio(drift_asrc_t *asrc, int32_t ratio_ppb)
+{
+    asrc->stats.ratio_ppb = ratio_ppb;
+    asrc->step = (1ULL << 32) + (int64_t)ratio_ppb * (1LL << 32) / DRIFT_ASRC_INTEG_SCALE;
+}
+
+size_t drift_asrc_mem_size(const drift_asrc_cfg_t *cfg, audio_arena_place_t place)
+{
+    if (!cfg || place != AUDIO_ARENA_INTERNAL) {
+        return 0;
+    }
+    return AUDIO_ARENA_SIZE(sizeof(drift_asrc_t));
+}
+
+drift_asrc_t *drift_asrc_create(const drift_asrc_cfg_t *cfg)
+{
+    if (!cfg || cfg->channels < 1 || cfg->channels > DRIFT_ASRC_MAX_CHANNELS ||
+        cfg->max_ppm == 0 || cfg->smooth_ms == 0) {
+        return NULL;
+    }
+    // 插值内层循环每个输出样点都要访问，放片内
+    drift_asrc_t *asrc = audio_arena_calloc(cfg->arena, 1, sizeof(drift_asrc_t), AUDIO_ARENA_INTERNAL);
+    if (!asrc) {
+        return NULL;
+    }
+    asrc->cfg = *cfg;
+    drift_asrc_reset(asrc);
+    return asrc;
+}
+
+void drift_asrc_destroy(drift_asrc_t *asrc)
+{
+    if (asrc) {
+        audio_arena_free(asrc->cfg.arena, asrc);
+    }
+}
+
+void drift_asrc_reset(drift_asrc_t *asrc)
+{
+    memset(asrc->buf, 0, sizeof(asrc->buf));
+    asrc->fill = DRIFT_ASRC_TAPS - 1;
+    asrc->end = DRIFT_ASRC_TAPS - 1;
+    asrc->frac = 0;
+    asrc->err_q8 = 0;
+    asrc->primed = false;
+    // 时钟偏差是两端晶振的属性，流重新开始后沿用积分项，去掉比例项
+    asrc->stats.drift_ppb = (int32_t)(asrc->integ / DRIFT_ASRC_INTEG_SCALE);
+    asrc->stats.error_us = 0;
+    _drift_asrc_set_ratio(asrc, asrc->stats.drift_ppb);
+}
+
+size_t drift_asrc_max_output(const drift_asrc_t *asrc, size_t in_samples)
+{
+    return in_samples + (size_t)(((uint64_t)in_samples * asrc->cfg.max_ppm + 999999) / 1000000) + 2;
+}
+
+size_t drift_asrc_process(drift_asrc_t *asrc, const int16_t *in, size_t in_samples, int16_t *out)
+{
+    const int ch = asrc->cfg.channels;
+    size_t produced = 0;
+    asrc->stats.in_samples += in_samples;
+    while (in_samples > 0) {
+        size_t take = DRIFT_ASRC_BUF_FRAMES - asrc->fill;
+        if (take > in_samples) {
+            take = in_samples;
+        }
+        memcpy(&asrc->buf[asrc->fill * ch], in, take * ch * sizeof(int16_t));
+        asrc->fill += take;
+        in += take * ch;
+        in_samples -= take;
+
+        while (asrc->end < asrc->fill) {
+            const int16_t *c0 = s_drift_asrc_coef[asrc->frac >> DRIFT_ASRC_PHASE_SHIFT];
+            const int16_t *c1 = c0 + DRIFT_ASRC_TAPS;
+            int32_t mu = (int32_t)((asrc->frac >> DRIFT_ASRC_MU_SHIFT) & 0x7FFF);
+            const int16_t *x = &asrc->buf[(asrc->end + 1 - DRIFT_ASRC_TAPS) * ch];
+            for (int c = 0; c < ch; c++) {
+                int32_t a0 = 0;
+                int32_t a1 = 0;
+                for (int j = 0; j < DRIFT_ASRC_TAPS; j++) {
+                    int32_t s = x[j * ch + c];
+                    a0 += c0[j] * s;
+                    a1 += c1[j] * s;
+                }
+                int64_t y = a0 + (((int64_t)a1 - a0) * mu >> 15);
+                *out++ = _drift_asrc_sat16((int32_t)((y + (1 << 14)) >> 15));
+            }
+            produced++;
+            uint64_t pos = (uint64_t)asrc->frac + asrc->step;
+            asrc->end += (uint32_t)(pos >> 32);
+            asrc->frac = (uint32_t)pos;
+        }
+
+        // 只保留下一个窗口需要的 TAPS-1 帧历史（end 最多越过 fill 一帧）
+        uint32_t keep = asrc->end + 1 - DRIFT_ASRC_TAPS;
+        memmove(asrc->buf, &asrc->buf[keep * ch], (asrc->fill - keep) * ch * sizeof(int16_t));
+        asrc->fill -= keep;
+        asrc->end -= keep;
+    }
+    asrc->stats.out_samples += produced;
+    return produced;
+}
+
+void drift_asrc_update(drift_asrc_t *asrc, int32_t error_us, uint32_t interval_us)
+{
+    const drift_asrc_cfg_t *cfg = &asrc->cfg;
+    const int64_t max_ppb = (int64_t)cfg->max_ppm * 1000;
+
+    // 1. 一阶平滑：按帧取包的锯齿与网络抖动远快于时钟漂移，时间常数取数秒
+    if (!asrc->primed) {
+        asrc->err_q8 = (int64_t)error_us << 8;
+        asrc->primed = true;
+    } else {
+        int64_t tau_us = (int64_t)cfg->smooth_ms * 1000 + interval_us;
+        asrc->err_q8 += (((int64_t)error_us << 8) - asrc->err_q8) * interval_us / tau_us;
+    }
+    int64_t err_us = asrc->err_q8 >> 8;
+
+    // 2. 积分项收敛到两端时钟偏差，限幅防止长时间饱和后超调
+    asrc->integ += (int64_t)cfg->ki_ppb_ms_s * err_us * interval_us;
+    int64_t integ_max = max_ppb * DRIFT_ASRC_INTEG_SCALE;
+    if (asrc->integ > integ_max) {
+        asrc->integ = integ_max;
+    } else if (asrc->integ < -integ_max) {
+        asrc->integ = -integ_max;
+    }
+
+    // 3. 比值 = 积分 + 比例（kp 的 ppm/ms 恰为 ppb/us），先限幅再限制变化率
+    int64_t want = asrc->integ / DRIFT_ASRC_INTEG_SCALE + (int64_t)cfg->kp_ppm_ms * err_us;
+    if (want > max_ppb || want < -max_ppb) {
+        want = want > 0 ? max_ppb : -max_ppb;
+        asrc->stats.saturated++;
+    }
+    int64_t slew = (int64_t)cfg->slew_ppm_s * interval_us / 1000;
+    int64_t ratio = asrc->stats.ratio_ppb;
+    if (want > ratio + slew) {
+        want = ratio + slew;
+    } else if (want < ratio - slew) {
+        want = ratio - slew;
+    }
+    _drift_asrc_set_ratio(asrc, (int32_t)want);
+    asrc->stats.drift_ppb = (int32_t)(asrc->integ / DRIFT_ASRC_INTEG_SCALE);
+    asrc->stats.error_us = (int32_t)err_us;
+    asrc->stats.updates++;
+}
+
+void drift_asrc_set_ratio(drift_asrc_t *asrc, int32_t ratio_ppb)
+{
+    int32_t max_ppb = (int32_t)asrc->cfg.max_ppm * 1000;
+    if (ratio_ppb > max_ppb) {
+        ratio_ppb = max_ppb;
+    } else if (ratio_ppb < -max_ppb) {
+        ratio_ppb = -max_ppb;
+    }
+    asrc->integ = (int64_t)ratio_ppb * DRIFT_ASRC_INTEG_SCALE;
+    asrc->stats.drift_ppb = ratio_ppb;
+    _drift_asrc_set_ratio(asrc, ratio_ppb);
+}
+
+void drift_asrc_hold(drift_asrc_t *asrc)
+{
+    asrc->primed = false;
+    asrc->stats.holds++;
+}
+
+void drift_asrc_get_stats(const drift_asrc_t *asrc, drift_asrc_stats_t *stats)
+{
+    *stats = asrc->stats;
+}
@@ -0,0 +1,138 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 14:00:00
+ * @LastEditTime: 2026-10-17 14:00:00
+ * @LastEditors: 星年
+ * @Description: 时钟漂移补偿异步重采样（ASRC）：比值在 1±几百ppm 内连续可调的分数延迟插值，
+ *               由缓冲水位上的PI控制器驱动，定点实现，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\drift_asrc.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DRIFT_ASRC_TAPS         16      // 插值滤波器抽头数
+#define DRIFT_ASRC_PHASES       128     // 系数表相位数，相邻相位之间线性插值
+#define DRIFT_ASRC_BLOCK        256     // 内部每批处理的输入样点数（每通道）
+#define DRIFT_ASRC_MAX_CHANNELS 2       // 最多通道数（交织）
+
+/**
+ * @brief 漂移补偿配置
+ *
+ * 控制量为“缓冲水位误差”：实测缓冲时长减去目标时长（微秒），为正说明远端时钟偏快、缓冲在涨，
+ * 此时比值调高（每个输出样点消耗略多于一个输入样点），反之调低。
+ * 比值 = 1 + kp * 平滑误差 + ki * 误差积分，积分项最终收敛到两端时钟的实际偏差，
+ * 比例项只负责把水位拉回目标。ppm级的比值变化对应的音高变化远小于可闻阈值（1000ppm 约1.7音分）。
+ */
+typedef struct {
+    uint8_t channels;           // 通道数（1 ~ DRIFT_ASRC_MAX_CHANNELS，交织）
+    uint16_t max_ppm;           // 比值偏离1的上限（ppm）
+    uint16_t kp_ppm_ms;         // 比例增益：每1ms平滑误差对应的ppm
+    uint16_t ki_ppb_ms_s;       // 积分增益：每1ms误差持续1秒累积的ppb
+    uint16_t smooth_ms;         // 水位误差平滑时间常数，滤掉网络抖动与按帧取包造成的锯齿
+    uint16_t slew_ppm_s;        // 比值每秒最大变化量（ppm），避免误差突变时音高跳动
+    audio_arena_t *arena;       // 内存区，NULL 时从堆分配
+} drift_asrc_cfg_t;
+
+#define DEFAULT_DRIFT_ASRC_CONFIG() {   \
+    .channels    = 1,                   \
+    .max_ppm     = 1000,                \
+    .kp_ppm_ms   = 10,                  \
+    .ki_ppb_ms_s = 100,                 \
+    .smooth_ms   = 8000,                \
+    .slew_ppm_s  = 200,                 \
+    .arena       = NULL,                \
+}
+
+/**
+ * @brief 漂移补偿统计
+ */
+typedef struct {
+    int32_t ratio_ppb;          // 当前比值偏离1的量（ppb，正为加快消耗输入）
+    int32_t drift_ppb;          // 积分项（估计的两端时钟偏差，ppb）
+    int32_t error_us;           // 平滑后的水位误差
+    uint32_t updates;           // 控制器更新次数
+    uint32_t holds;             // 水位不可信而跳过的更新次数
+    uint32_t saturated;         // 比值触及上限的更新次数
+    uint64_t in_samples;        // 累计输入样点数（每通道）
+    uint64_t out_samples;       // 累计输出样点数（每通道）
+} drift_asrc_stats_t;
+
+typedef struct drift_asrc drift_asrc_t;
+
+/**
+ * @brief 创建漂移补偿器（比值初始为1；插值滤波器带来约8个样点的固定延迟，并滤除0.45倍采样率以上的分量）
+ *
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+drift_asrc_t *drift_asrc_create(const drift_asrc_cfg_t *cfg);
+
+/**
+ * @brief 销毁漂移补偿器
+ */
+void drift_asrc_destroy(drift_asrc_t *asrc);
+
+/**
+ * @brief 清空滤波器历史与水位平滑状态；保留已估计的时钟偏差，流重新开始后无需重新收敛
+ */
+void drift_asrc_reset(drift_asrc_t *asrc);
+
+/**
+ * @brief 输入 in_samples 个样点（每通道）时最多可能产生的输出样点数
+ */
+size_t drift_asrc_max_output(const drift_asrc_t *asrc, size_t in_samples);
+
+/**
+ * @brief 按当前比值重采样一段16位PCM
+ *
+ * @param asrc       句柄
+ * @param in         输入（交织）
+ * @param in_samples 输入样点数（每通道），可为任意长度
+ * @param out        输出（交织），容量不小于 drift_asrc_max_output(in_samples)
+ * @return 输出样点数（每通道）
+ */
+size_t drift_asrc_process(drift_asrc_t *asrc, const int16_t *in, size_t in_samples, int16_t *out);
+
+/**
+ * @brief 以一次水位测量更新比值（每处理一帧调用一次）
+ *
+ * @param asrc        句柄
+ * @param error_us    实测缓冲时长 - 目标时长（微秒）
+ * @param interval_us 距上一次更新的时长（即本帧时长）
+ */
+void drift_asrc_update(drift_asrc_t *asrc, int32_t error_us, uint32_t interval_us);
+
+/**
+ * @brief 开环设置比值（已知两端时钟偏差时使用，如由RTP时间戳估计），下次 drift_asrc_update() 起恢复闭环
+ *
+ * @param asrc      句柄
+ * @param ratio_ppb 比值偏离1的量（ppb），按 max_ppm 限幅
+ */
+void drift_asrc_set_ratio(drift_asrc_t *asrc, int32_t ratio_ppb);
+
+/**
+ * @brief 本次水位不可信（未在播放、流中断、DTX静音段），保持当前比值，下次更新重新开始平滑
+ */
+void drift_asrc_hold(drift_asrc_t *asrc);
+
+/**
+ * @brief 获取统计
+ */
+void drift_asrc_get_stats(const drift_asrc_t *asrc, drift_asrc_stats_t *stats);
+
+/**
+ * @brief 按配置计算所需内存（按内存区对齐取整），用于预留内存区（全部在片内）
+ */
+size_t drift_asrc_mem_size(const drift_asrc_cfg_t *cfg, audio_arena_place_t place);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,526 @@
+/*
+ * 由 tools/gen_drift_asrc_coef.py 生成, 请勿手工修改
+ * PHASES=128 TAPS=16 FC=0.45*fs Kaiser beta=7.0
+ */
+#pragma once
+
+#include <stdint.h>
+
+static const int16_t s_drift_asrc_coef[129][16] __attribute__((aligned(16))) = {
+    { // phase 0
+            41,   -184,    502,  -1038,   1749,  -2492,   3062,  29488,
+          3062,  -2492,   1749,  -1038,    502,   -184,     41,      0,
+    },
+    { // phase 1
+            41,   -183,    499,  -1025,   1712,  -2403,   2829,  29485,
+          3298,  -2582,   1786,  -1051,    505,   -184,     41,      0,
+    },
+    { // phase 2
+            41,   -183,    495,  -1011,   1674,  -2313,   2598,  29479,
+          3536,  -2671,   1822,  -1064,    508,   -184,     41,      0,
+    },
+    { // phase 3
+            41,   -182,    491,   -997,   1636,  -2223,   2370,  29465,
+          3777,  -2760,   1858,  -1076,    511,   -184,     41,      0,
+    },
+    { // phase 4
+            41,   -182,    487,   -982,   1597,  -2132,   2144,  29448,
+          4020,  -2848,   1893,  -1088,    514,   -184,     40,      0,
+    },
+    { // phase 5
+            41,   -181,    483,   -967,   1558,  -2042,   1921,  29424,
+          4265,  -2936,   1928,  -1099,    516,   -183,     40,      0,
+    },
+    { // phase 6
+            41,   -180,    478,   -952,   1518,  -1951,   1701,  29398,
+          4512,  -3023,   1962,  -1110,    518,   -183,     40,     -1,
+    },
+    { // phase 7
+            41,   -179,    473,   -936,   1478,  -1861,   1484,  29367,
+          4762,  -3110,   1995,  -1121,    520,   -183,     39,     -1,
+    },
+    { // phase 8
+            41,   -178,    469,   -920,   1438,  -1771,   1269,  29328,
+          5014,  -3196,   2028,  -1131,    521,   -182,     39,     -1,
+    },
+    { // phase 9
+            41,   -177,    463,   -904,   1397,  -1680,   1058,  29286,
+          5268,  -3282,   2059,  -1140,    522,   -181,     39,     -1,
+    },
+    { // phase 10
+            41,   -176,    458,   -887,   1356,  -1590,    849,  29240,
+          5523,  -3367,   2091,  -1149,    523,   -181,     38,     -1,
+    },
+    { // phase 11
+            41,   -175,    453,   -871,   1315,  -1500,    643,  29188,
+          5781,  -3451,   2121,  -1158,    524,   -180,     38,     -1,
+    },
+    { // phase 12
+            40,   -174,    447,   -854,   1274,  -1410,    440,  29133,
+          6041,  -3534,   2150,  -1166,    524,   -179,     37,     -1,
+    },
+    { // phase 13
+            40,   -172,    441,   -836,   1232,  -1321,    240,  29069,
+          6302,  -3616,   2179,  -1173,    524,   -177,     37,     -1,
+    },
+    { // phase 14
+            40,   -171,    435,   -819,   1190,  -1232,     43,  29005,
+          6565,  -3698,   2207,  -1180,    524,   -176,     36,     -1,
+    },
+    { // phase 15
+            40,   -169,    429,   -801,   1148,  -1143,   -150,  28931,
+          6830,  -3778,   2234,  -1186,    524,   -175,     35,     -1,
+    },
+    { // phase 16
+            39,   -168,    423,   -783,   1106,  -1054,   -341,  28856,
+          7096,  -3858,   2260,  -1192,    523,   -173,     35,     -1,
+    },
+    { // phase 17
+            39,   -166,    417,   -765,   1063,   -966,   -529,  28776,
+          7364,  -3936,   2286,  -1198,    522,   -172,     34,     -1,
+    },
+    { // phase 18
+            39,   -164,    410,   -746,   1021,   -879,   -713,  28688,
+          7634,  -4013,   2310,  -1202,    521,   -170,     33,     -1,
+    },
+    { // phase 19
+            38,   -163,    403,   -728,    978,   -792,   -894,  28600,
+          7905,  -4089,   2334,  -1206,    519,   -168,     32,     -1,
+    },
+    { // phase 20
+            38,   -161,    397,   -709,    936,   -705,  -1072,  28504,
+          8177,  -4164,   2356,  -1210,    517,   -166,     31,     -1,
+    },
+    { // phase 21
+            37,   -159,    390,   -690,    893,   -619,  -1247,  28405,
+          8450,  -4238,   2378,  -1213,    515,   -164,     31,     -1,
+    },
+    { // phase 22
+            37,   -157,    383,   -671,    850,   -533,  -1418,  28299,
+          8725,  -4310,   2398,  -1215,    512,   -161,     30,     -1,
+    },
+    { // phase 23
+            36,   -155,    376,   -652,    808,   -449,  -1586,  28190,
+          9001,  -4381,   2418,  -1217,    510,   -159,     29,     -1,
+    },
+    { // phase 24
+            36,   -153,    368,   -633,    765,   -365,  -1751,  28079,
+          9278,  -4451,   2436,  -1218,    506,   -156,     28,     -1,
+    },
+    { // phase 25
+            36,   -151,    361,   -613,    723,   -281,  -1913,  27959,
+          9556,  -4519,   2453,  -1218,    503,   -154,     26,      0,
+    },
+    { // phase 26
+            35,   -148,    354,   -594,    680,   -199,  -2071,  27837,
+          9834,  -4585,   2470,  -1218,    499,   -151,     25,      0,
+    },
+    { // phase 27
+            35,   -146,    346,   -574,    638,   -117,  -2225,  27708,
+         10114,  -4650,   2485,  -1217,    495,   -148,     24,      0,
+    },
+    { // phase 28
+            34,   -144,    338,   -554,    595,    -36,  -2377,  27579,
+         10395,  -4714,   2499,  -1216,    491,   -145,     23,      0,
+    },
+    { // phase 29
+            34,   -141,    331,   -535,    553,     44,  -2525,  27442,
+         10676,  -4775,   2512,  -1214,    486,   -142,     22,      0,
+    },
+    { // phase 30
+            33,   -139,    323,   -515,    511,    124,  -2669,  27303,
+         10957,  -4835,   2523,  -1211,    481,   -138,     20,      0,
+    },
+    { // phase 31
+            32,   -137,    315,   -495,    469,    202,  -2810,  27160,
+         11240,  -4893,   2534,  -1208,    475,   -135,     19,      0,
+    },
+    { // phase 32
+            32,   -134,    307,   -475,    428,    280,  -2948,  27009,
+         11522,  -4950,   2543,  -1204,    470,   -131,     18,      1,
+    },
+    { // phase 33
+            31,   -132,    299,   -455,    386,    356,  -3082,  26857,
+         11806,  -5004,   2551,  -1199,    464,   -127,     16,      1,
+    },
+    { // phase 34
+            31,   -129,    291,   -435,    345,    432,  -3212,  26699,
+         12089,  -5057,   2558,  -1193,    457,   -124,     15,      1,
+    },
+    { // phase 35
+            30,   -127,    283,   -415,    304,    506,  -3339,  26538,
+         12373,  -5107,   2564,  -1187,    450,   -119,     13,      1,
+    },
+    { // phase 36
+            30,   -124,    275,   -396,    263,    580,  -3463,  26373,
+         12657,  -5156,   2568,  -1180,    443,   -115,     12,      1,
+    },
+    { // phase 37
+            29,   -121,    267,   -376,    223,    652,  -3583,  26205,
+         12940,  -5203,   2571,  -1173,    436,   -111,     10,      2,
+    },
+    { // phase 38
+            28,   -119,    259,   -356,    183,    723,  -3700,  26034,
+         13224,  -5247,   2573,  -1165,    428,   -107,      8,      2,
+    },
+    { // phase 39
+            28,   -116,    250,   -336,    143,    793,  -3813,  25855,
+         13508,  -5289,   2574,  -1156,    420,   -102,      7,      2,
+    },
+    { // phase 40
+            27,   -114,    242,   -316,    103,    863,  -3923,  25674,
+         13792,  -5329,   2573,  -1146,    412,    -97,      5,      2,
+    },
+    { // phase 41
+            26,   -111,    234,   -297,     64,    930,  -4029,  25493,
+         14075,  -5367,   2570,  -1136,    403,    -93,      3,      3,
+    },
+    { // phase 42
+            26,   -108,    226,   -277,     26,    997,  -4131,  25300,
+         14359,  -5403,   2567,  -1124,    394,    -88,      1,      3,
+    },
+    { // phase 43
+            25,   -105,    217,   -258,    -13,   1063,  -4231,  25112,
+         14641,  -5436,   2562,  -1113,    385,    -83,     -1,      3,
+    },
+    { // phase 44
+            25,   -103,    209,   -238,    -51,   1127,  -4326,  24913,
+         14924,  -5467,   2556,  -1100,    375,    -77,     -3,      4,
+    },
+    { // phase 45
+            24,   -100,    201,   -219,    -88,   1190,  -4418,  24714,
+         15205,  -5495,   2548,  -1087,    365,    -72,     -4,      4,
+    },
+    { // phase 46
+            23,    -97,    193,   -200,   -125,   1251,  -4507,  24513,
+         15486,  -5521,   2539,  -1073,    355,    -67,     -6,      4,
+    },
+    { // phase 47
+            23,    -94,    184,   -181,   -162,   1312,  -4592,  24306,
+         15767,  -5544,   2529,  -1059,    344,    -61,     -9,      5,
+    },
+    { // phase 48
+            22,    -92,    176,   -162,   -198,   1371,  -4674,  24098,
+         16046,  -5565,   2517,  -1043,    333,    -55,    -11,      5,
+    },
+    { // phase 49
+            21,    -89,    168,   -143,   -234,   1429,  -4752,  23886,
+         16325,  -5583,   2503,  -1027,    322,    -50,    -13,      5,
+    },
+    { // phase 50
+            21,    -86,    160,   -124,   -269,   1485,  -4827,  23667,
+         16603,  -5599,   2489,  -1010,    311,    -44,    -15,      6,
+    },
+    { // phase 51
+            20,    -83,    152,   -106,   -303,   1540,  -4898,  23449,
+         16879,  -5612,   2473,   -993,    299,    -38,    -17,      6,
+    },
+    { // phase 52
+            20,    -81,    144,    -87,   -338,   1594,  -4966,  23226,
+         17155,  -5622,   2455,   -975,    287,    -32,    -19,      7,
+    },
+    { // phase 53
+            19,    -78,    135,    -69,   -371,   1647,  -5031,  23002,
+         17429,  -5630,   2436,   -956,    274,    -25,    -21,      7,
+    },
+    { // phase 54
+            18,    -75,    127,    -51,   -404,   1698,  -5092,  22774,
+         17702,  -5634,   2415,   -936,    261,    -19,    -24,      8,
+    },
+    { // phase 55
+            18,    -72,    119,    -33,   -437,   1747,  -5149,  22543,
+         17974,  -5636,   2393,   -916,    248,    -13,    -26,      8,
+    },
+    { // phase 56
+            17,    -70,    111,    -16,   -469,   1796,  -5204,  22310,
+         18244,  -5635,   2370,   -895,    235,     -6,    -28,      8,
+    },
+    { // phase 57
+            17,    -67,    104,      2,   -500,   1842,  -5255,  22071,
+         18513,  -5631,   2345,   -873,    221,      1,    -31,      9,
+    },
+    { // phase 58
+            16,    -64,     96,     19,   -531,   1888,  -5302,  21832,
+         18780,  -5625,   2319,   -851,    207,      8,    -33,      9,
+    },
+    { // phase 59
+            15,    -62,     88,     36,   -561,   1932,  -5347,  21592,
+         19046,  -5615,   2291,   -828,    193,     14,    -36,     10,
+    },
+    { // phase 60
+            15,    -59,     80,     53,   -591,   1974,  -5388,  21348,
+         19309,  -5602,   2262,   -804,    178,     21,    -38,     10,
+    },
+    { // phase 61
+            14,    -56,     73,     69,   -619,   2015,  -5426,  21100,
+         19571,  -5586,   2231,   -780,    164,     28,    -41,     11,
+    },
+    { // phase 62
+            14,    -54,     65,     86,   -648,   2055,  -5460,  20850,
+         19831,  -5567,   2198,   -755,    149,     36,    -43,     11,
+    },
+    { // phase 63
+            13,    -51,     58,    102,   -676,   2093,  -5492,  20599,
+         20089,  -5545,   2165,   -729,    133,     43,    -46,     12,
+    },
+    { // phase 64
+            13,    -48,     50,    118,   -703,   2130,  -5520,  20343,
+         20345,  -5520,   2130,   -703,    118,     50,    -48,     13,
+    },
+    { // phase 65
+            12,    -46,     43,    133,   -729,   2165,  -5545,  20089,
+         20599,  -5492,   2093,   -676,    102,     58,    -51,     13,
+    },
+    { // phase 66
+            11,    -43,     36,    149,   -755,   2198,  -5567,  19831,
+         20850,  -5460,   2055,   -648,     86,     65,    -54,     14,
+    },
+    { // phase 67
+            11,    -41,     28,    164,   -780,   2231,  -5586,  19571,
+         21100,  -5426,   2015,   -619,     69,     73,    -56,     14,
+    },
+    { // phase 68
+            10,    -38,     21,    178,   -804,   2262,  -5602,  19309,
+         21348,  -5388,   1974,   -591,     53,     80,    -59,     15,
+    },
+    { // phase 69
+            10,    -36,     14,    193,   -828,   2291,  -5615,  19046,
+         21592,  -5347,   1932,   -561,     36,     88,    -62,     15,
+    },
+    { // phase 70
+             9,    -33,      8,    207,   -851,   2319,  -5625,  18780,
+         21832,  -5302,   1888,   -531,     19,     96,    -64,     16,
+    },
+    { // phase 71
+             9,    -31,      1,    221,   -873,   2345,  -5631,  18513,
+         22071,  -5255,   1842,   -500,      2,    104,    -67,     17,
+    },
+    { // phase 72
+             8,    -28,     -6,    235,   -895,   2370,  -5635,  18244,
+         22310,  -5204,   1796,   -469,    -16,    111,    -70,     17,
+    },
+    { // phase 73
+             8,    -26,    -13,    248,   -916,   2393,  -5636,  17974,
+         22543,  -5149,   1747,   -437,    -33,    119,    -72,     18,
+    },
+    { // phase 74
+             8,    -24,    -19,    261,   -936,   2415,  -5634,  17702,
+         22774,  -5092,   1698,   -404,    -51,    127,    -75,     18,
+    },
+    { // phase 75
+             7,    -21,    -25,    274,   -956,   2436,  -5630,  17429,
+         23002,  -5031,   1647,   -371,    -69,    135,    -78,     19,
+    },
+    { // phase 76
+             7,    -19,    -32,    287,   -975,   2455,  -5622,  17155,
+         23226,  -4966,   1594,   -338,    -87,    144,    -81,     20,
+    },
+    { // phase 77
+             6,    -17,    -38,    299,   -993,   2473,  -5612,  16879,
+         23449,  -4898,   1540,   -303,   -106,    152,    -83,     20,
+    },
+    { // phase 78
+             6,    -15,    -44,    311,  -1010,   2489,  -5599,  16603,
+         23667,  -4827,   1485,   -269,   -124,    160,    -86,     21,
+    },
+    { // phase 79
+             5,    -13,    -50,    322,  -1027,   2503,  -5583,  16325,
+         23886,  -4752,   1429,   -234,   -143,    168,    -89,     21,
+    },
+    { // phase 80
+             5,    -11,    -55,    333,  -1043,   2517,  -5565,  16046,
+         24098,  -4674,   1371,   -198,   -162,    176,    -92,     22,
+    },
+    { // phase 81
+             5,     -9,    -61,    344,  -1059,   2529,  -5544,  15767,
+         24306,  -4592,   1312,   -162,   -181,    184,    -94,     23,
+    },
+    { // phase 82
+             4,     -6,    -67,    355,  -1073,   2539,  -5521,  15486,
+         24513,  -4507,   1251,   -125,   -200,    193,    -97,     23,
+    },
+    { // phase 83
+             4,     -4,    -72,    365,  -1087,   2548,  -5495,  15205,
+         24714,  -4418,   1190,    -88,   -219,    201,   -100,     24,
+    },
+    { // phase 84
+             4,     -3,    -77,    375,  -1100,   2556,  -5467,  14924,
+         24913,  -4326,   1127,    -51,   -238,    209,   -103,     25,
+    },
+    { // phase 85
+             3,     -1,    -83,    385,  -1113,   2562,  -5436,  14641,
+         25112,  -4231,   1063,    -13,   -258,    217,   -105,     25,
+    },
+    { // phase 86
+             3,      1,    -88,    394,  -1124,   2567,  -5403,  14359,
+         25300,  -4131,    997,     26,   -277,    226,   -108,     26,
+    },
+    { // phase 87
+             3,      3,    -93,    403,  -1136,   2570,  -5367,  14075,
+         25493,  -4029,    930,     64,   -297,    234,   -111,     26,
+    },
+    { // phase 88
+             2,      5,    -97,    412,  -1146,   2573,  -5329,  13792,
+         25674,  -3923,    863,    103,   -316,    242,   -114,     27,
+    },
+    { // phase 89
+             2,      7,   -102,    420,  -1156,   2574,  -5289,  13508,
+         25855,  -3813,    793,    143,   -336,    250,   -116,     28,
+    },
+    { // phase 90
+             2,      8,   -107,    428,  -1165,   2573,  -5247,  13224,
+         26034,  -3700,    723,    183,   -356,    259,   -119,     28,
+    },
+    { // phase 91
+             2,     10,   -111,    436,  -1173,   2571,  -5203,  12940,
+         26205,  -3583,    652,    223,   -376,    267,   -121,     29,
+    },
+    { // phase 92
+             1,     12,   -115,    443,  -1180,   2568,  -5156,  12657,
+         26373,  -3463,    580,    263,   -396,    275,   -124,     30,
+    },
+    { // phase 93
+             1,     13,   -119,    450,  -1187,   2564,  -5107,  12373,
+         26538,  -3339,    506,    304,   -415,    283,   -127,     30,
+    },
+    { // phase 94
+             1,     15,   -124,    457,  -1193,   2558,  -5057,  12089,
+         26699,  -3212,    432,    345,   -435,    291,   -129,     31,
+    },
+    { // phase 95
+             1,     16,   -127,    464,  -1199,   2551,  -5004,  11806,
+         26857,  -3082,    356,    386,   -455,    299,   -132,     31,
+    },
+    { // phase 96
+             1,     18,   -131,    470,  -1204,   2543,  -4950,  11522,
+         27009,  -2948,    280,    428,   -475,    307,   -134,     32,
+    },
+    { // phase 97
+             0,     19,   -135,    475,  -1208,   2534,  -4893,  11240,
+         27160,  -2810,    202,    469,   -495,    315,   -137,     32,
+    },
+    { // phase 98
+             0,     20,   -138,    481,  -1211,   2523,  -4835,  10957,
+         27303,  -2669,    124,    511,   -515,    323,   -139,     33,
+    },
+    { // phase 99
+             0,     22,   -142,    486,  -1214,   2512,  -4775,  10676,
+         27442,  -2525,     44,    553,   -535,    331,   -141,     34,
+    },
+    { // phase 100
+             0,     23,   -145,    491,  -1216,   2499,  -4714,  10395,
+         27579,  -2377,    -36,    595,   -554,    338,   -144,     34,
+    },
+    { // phase 101
+             0,     24,   -148,    495,  -1217,   2485,  -4650,  10114,
+         27708,  -2225,   -117,    638,   -574,    346,   -146,     35,
+    },
+    { // phase 102
+             0,     25,   -151,    499,  -1218,   2470,  -4585,   9834,
+         27837,  -2071,   -199,    680,   -594,    354,   -148,     35,
+    },
+    { // phase 103
+             0,     26,   -154,    503,  -1218,   2453,  -4519,   9556,
+         27959,  -1913,   -281,    723,   -613,    361,   -151,     36,
+    },
+    { // phase 104
+            -1,     28,   -156,    506,  -1218,   2436,  -4451,   9278,
+         28079,  -1751,   -365,    765,   -633,    368,   -153,     36,
+    },
+    { // phase 105
+            -1,     29,   -159,    510,  -1217,   2418,  -4381,   9001,
+         28190,  -1586,   -449,    808,   -652,    376,   -155,     36,
+    },
+    { // phase 106
+            -1,     30,   -161,    512,  -1215,   2398,  -4310,   8725,
+         28299,  -1418,   -533,    850,   -671,    383,   -157,     37,
+    },
+    { // phase 107
+            -1,     31,   -164,    515,  -1213,   2378,  -4238,   8450,
+         28405,  -1247,   -619,    893,   -690,    390,   -159,     37,
+    },
+    { // phase 108
+            -1,     31,   -166,    517,  -1210,   2356,  -4164,   8177,
+         28504,  -1072,   -705,    936,   -709,    397,   -161,     38,
+    },
+    { // phase 109
+            -1,     32,   -168,    519,  -1206,   2334,  -4089,   7905,
+         28600,   -894,   -792,    978,   -728,    403,   -163,     38,
+    },
+    { // phase 110
+            -1,     33,   -170,    521,  -1202,   2310,  -4013,   7634,
+         28688,   -713,   -879,   1021,   -746,    410,   -164,     39,
+    },
+    { // phase 111
+            -1,     34,   -172,    522,  -1198,   2286,  -3936,   7364,
+         28776,   -529,   -966,   1063,   -765,    417,   -166,     39,
+    },
+    { // phase 112
+            -1,     35,   -173,    523,  -1192,   2260,  -3858,   7096,
+         28856,   -341,  -1054,   1106,   -783,    423,   -168,     39,
+    },
+    { // phase 113
+            -1,     35,   -175,    524,  -1186,   2234,  -3778,   6830,
+         28931,   -150,  -1143,   1148,   -801,    429,   -169,     40,
+    },
+    { // phase 114
+            -1,     36,   -176,    524,  -1180,   2207,  -3698,   6565,
+         29005,     43,  -1232,   1190,   -819,    435,   -171,     40,
+    },
+    { // phase 115
+            -1,     37,   -177,    524,  -1173,   2179,  -3616,   6302,
+         29069,    240,  -1321,   1232,   -836,    441,   -172,     40,
+    },
+    { // phase 116
+            -1,     37,   -179,    524,  -1166,   2150,  -3534,   6041,
+         29133,    440,  -1410,   1274,   -854,    447,   -174,     40,
+    },
+    { // phase 117
+            -1,     38,   -180,    524,  -1158,   2121,  -3451,   5781,
+         29188,    643,  -1500,   1315,   -871,    453,   -175,     41,
+    },
+    { // phase 118
+            -1,     38,   -181,    523,  -1149,   2091,  -3367,   5523,
+         29240,    849,  -1590,   1356,   -887,    458,   -176,     41,
+    },
+    { // phase 119
+            -1,     39,   -181,    522,  -1140,   2059,  -3282,   5268,
+         29286,   1058,  -1680,   1397,   -904,    463,   -177,     41,
+    },
+    { // phase 120
+            -1,     39,   -182,    521,  -1131,   2028,  -3196,   5014,
+         29328,   1269,  -1771,   1438,   -920,    469,   -178,     41,
+    },
+    { // phase 121
+            -1,     39,   -183,    520,  -1121,   1995,  -3110,   4762,
+         29367,   1484,  -1861,   1478,   -936,    473,   -179,     41,
+    },
+    { // phase 122
+            -1,     40,   -183,    518,  -1110,   1962,  -3023,   4512,
+         29398,   1701,  -1951,   1518,   -952,    478,   -180,     41,
+    },
+    { // phase 123
+             0,     40,   -183,    516,  -1099,   1928,  -2936,   4265,
+         29424,   1921,  -2042,   1558,   -967,    483,   -181,     41,
+    },
+    { // phase 124
+             0,     40,   -184,    514,  -1088,   1893,  -2848,   4020,
+         29448,   2144,  -2132,   1597,   -982,    487,   -182,     41,
+    },
+    { // phase 125
+             0,     41,   -184,    511,  -1076,   1858,  -2760,   3777,
+         29465,   2370,  -2223,   1636,   -997,    491,   -182,     41,
+    },
+    { // phase 126
+             0,     41,   -184,    508,  -1064,   1822,  -2671,   3536,
+         29479,   2598,  -2313,   1674,  -1011,    495,   -183,     41,
+    },
+    { // phase 127
+             0,     41,   -184,    505,  -1051,   1786,  -2582,   3298,
+         29485,   2829,  -2403,   1712,  -1025,    499,   -183,     41,
+    },
+    { // phase 128
+             0,     41,   -184,    502,  -1038,   1749,  -2492,   3062,
+         29488,   3062,  -2492,   1749,  -1038,    502,   -184,     41,
+    },
+};
@@ -0,0 +1,547 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 16:00:00
+ * @LastEditTime: 2026-10-17 16:00:00
+ * @LastEditors: 星年
+ * @Description: DSP内核微基准实现：每项自动定标重复次数，多批取最快；精度以同一算法的双精度实现为参考
+ * @FilePath: \audio_manager\main\dsp_bench.c
+ * 遇事不决，可问春风
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio_arena.h"
+#include "audio_mix.h"
+#include "capture_convert.h"
+#include "fixed_fft.h"
+#include "polyphase_resampler.h"
+#include "polyphase_resampler_coef.h"
+#include "dsp_bench.h"
+
+#define DSP_BENCH_PAD           16                      // 缓冲尾部填充（样点），供向量内核越界预取
+#define DSP_BENCH_MAX_REPS      (1u << 20)              // 定标时单批重复次数上限
+#define DSP_BENCH_MIX_GAIN      (AUDIO_MIX_UNITY / 2)   // 混音与增益内核的增益（-6dB，走乘法路径）
+#define DSP_BENCH_LEGACY_IN     44100                   // 原线性插值重采样的输入/输出采样率
+#define DSP_BENCH_LEGACY_OUT    16000
+
+typedef struct {
+    int16_t in[DSP_BENCH_MAX_N + DSP_BENCH_PAD] __attribute__((aligned(16)));
+    int16_t aux[DSP_BENCH_MAX_N + DSP_BENCH_PAD] __attribute__((aligned(16)));     // 混音的累加初值
+    int16_t out[DSP_BENCH_MAX_N + DSP_BENCH_PAD] __attribute__((aligned(16)));
+    int32_t raw[DSP_BENCH_MAX_N + DSP_BENCH_PAD] __attribute__((aligned(16)));     // 24-in-32 DMA字
+    double ref[DSP_BENCH_MAX_N];
+    int32_t t[2 * FIXED_FFT_MAX_N];                         // FFT时域工作区
+    fixed_fft_cpx_t spec[FIXED_FFT_MAX_N + 1];              // FFT频域
+    fixed_fft_cpx_t z[FIXED_FFT_MAX_N];                     // FFT工作区
+    polyphase_rsp_t rsp;
+    capture_conv_t conv;
+    uint32_t lcg;                                           // 定标内核的状态
+} dsp_bench_ws_t;
+
+typedef struct {
+    const char *name;
+    uint32_t rate;                                          // 输入信号采样率
+    void (*prepare)(dsp_bench_ws_t *ws, bool verify);       // 复位内核状态
+    size_t (*run)(dsp_bench_ws_t *ws, size_t n);            // 处理 n 个输入样点，返回输出样点数（写入 out）
+    size_t (*ref)(dsp_bench_ws_t *ws, size_t n);            // 双精度参考（写入 ref），返回输出样点数；NULL 不比较
+    uint16_t block;                                         // 内核固有块长，只跑其整数倍的块长；0 不限
+} dsp_bench_kernel_t;
+
+static const char *const s_signals[] = {"sine", "noise", "clip"};
+static const uint16_t s_sizes[] = {64, 256, 1024};
+
+static double _dsp_bench_clip(double v)
+{
+    return v > 32767.0 ? 32767.0 : (v < -32768.0 ? -32768.0 : v);
+}
+
+static void _dsp_bench_nop_prepare(dsp_bench_ws_t *ws, bool verify)
+{
+    (void)ws;
+    (void)verify;
+}
+
+/* ------------------------------------------------------------------ */
+/* calib：纯整数依赖链，不访存，只随CPU频率变化                         */
+/* ------------------------------------------------------------------ */
+
+static size_t _dsp_bench_calib_run(dsp_bench_ws_t *ws, size_t n)
+{
+    uint32_t x = ws->lcg;
+    for (size_t i = 0; i < n; i++) {
+        x = x * 1664525u + 1013904223u;
+    }
+    ws->lcg = x;
+    return n;
+}
+
+/* ------------------------------------------------------------------ */
+/* legacy_linear：原 audio_resample_test.c 中的 resample_audio()        */
+/* ------------------------------------------------------------------ */
+
+static size_t _dsp_bench_legacy_out(size_t n)
+{
+    return n * DSP_BENCH_LEGACY_OUT / DSP_BENCH_LEGACY_IN;
+}
+
+/**
+ * @brief 逐句照搬（原文件为独立示例、不参与构建，函数为 static），作为重采样内核的对照组
+ */
+static size_t _dsp_bench_legacy_run(dsp_bench_ws_t *ws, size_t n)
+{
+    int input_len = (int)n;
+    int output_len = (int)_dsp_bench_legacy_out(n);
+    float ratio = (float)input_len / output_len;
+    for (int i = 0; i < output_len; i++) {
+        float pos = i * ratio;
+        int pos_int = (int)pos;
+        float frac = pos - pos_int;
+        if (pos_int + 1 >= input_len) {
+            ws->out[i] = ws->in[input_len - 1];
+        } else {
+            ws->out[i] = (int16_t)(ws->in[pos_int] * (1 - frac) + ws->in[pos_int + 1] * frac);
+        }
+    }
+    return output_len;
+}
+
+static size_t _dsp_bench_legacy_ref(dsp_bench_ws_t *ws, size_t n)
+{
+    size_t m = _dsp_bench_legacy_out(n);
+    double ratio = (double)n / m;
+    for (size_t i = 0; i < m; i++) {
+        double pos = i * ratio;
+        size_t k = (size_t)pos;
+        double frac = pos - k;
+        ws->ref[i] = k + 1 >= n ? ws->in[n - 1] : (1.0 - frac) * ws->in[k] + frac * ws->in[k + 1];
+    }
+    return m;
+}
+
+/* ------------------------------------------------------------------ */
+/* polyphase：多相重采样 44.1k -> 16k                                  */
+/* ------------------------------------------------------------------ */
+
+static void _dsp_bench_polyphase_prepare(dsp_bench_ws_t *ws, bool verify)
+{
+    (void)verify;
+    polyphase_rsp_reset(&ws->rsp);
+}
+
+static size_t _dsp_bench_polyphase_run(dsp_bench_ws_t *ws, size_t n)
+{
+    return polyphase_rsp_process(&ws->rsp, ws->in, n, ws->out);
+}
+
+static size_t _dsp_bench_polyphase_ref(dsp_bench_ws_t *ws, size_t n)
+{
+    // 与定点实现相同的窗口与相位序列，系数按 Q15 取值，乘加与取整全部为双精度
+    size_t m = 0;
+    for (uint64_t pos = 0;; pos += POLYPHASE_RSP_DOWN) {
+        size_t end = (size_t)(pos / POLYPHASE_RSP_UP);
+        if (end >= n) {
+            break;
+        }
+        const int16_t *h = s_polyphase_coef[pos % POLYPHASE_RSP_UP];
+        double acc = 0;
+        for (int j = 0; j < POLYPHASE_RSP_TAPS; j++) {
+            long idx = (long)end - (POLYPHASE_RSP_TAPS - 1) + j;
+            if (idx >= 0) {
+                acc += (double)h[j] * ws->in[idx];
+            }
+        }
+        ws->ref[m++] = acc / 32768.0;
+    }
+    return m;
+}
+
+/* ------------------------------------------------------------------ */
+/* conv_s16：24-in-32 DMA字 -> 16位                                    */
+/* ------------------------------------------------------------------ */
+
+static void _dsp_bench_conv_prepare(dsp_bench_ws_t *ws, bool verify)
+{
+    // 计时按固件配置（去直流开启）；精度比较关闭去直流，参考即理想的 24 -> 16 位缩放
+    capture_conv_cfg_t cfg = DEFAULT_CAPTURE_CONV_CONFIG();
+    if (verify) {
+        cfg.dc_shift = 0;
+    }
+    capture_conv_init(&ws->conv, &cfg);
+}
+
+static size_t _dsp_bench_conv_run(dsp_bench_ws_t *ws, size_t n)
+{
+    capture_conv_s16(&ws->conv, ws->raw, ws->out, n);
+    return n;
+}
+
+static size_t _dsp_bench_conv_ref(dsp_bench_ws_t *ws, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        ws->ref[i] = ws->raw[i] / 65536.0;
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------ */
+/* mix_s16 / scale_s16：每次先恢复累加初值（计时包含这次拷贝）          */
+/* ------------------------------------------------------------------ */
+
+static size_t _dsp_bench_mix_run(dsp_bench_ws_t *ws, size_t n)
+{
+    memcpy(ws->out, ws->aux, n * sizeof(int16_t));
+    audio_mix_s16(ws->out, ws->in, n, DSP_BENCH_MIX_GAIN);
+    return n;
+}
+
+static size_t _dsp_bench_mix_ref(dsp_bench_ws_t *ws, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        ws->ref[i] = ws->aux[i] + ws->in[i] * (DSP_BENCH_MIX_GAIN / 32768.0);
+    }
+    return n;
+}
+
+static size_t _dsp_bench_scale_run(dsp_bench_ws_t *ws, size_t n)
+{
+    memcpy(ws->out, ws->in, n * sizeof(int16_t));
+    audio_mix_scale_s16(ws->out, n, DSP_BENCH_MIX_GAIN);
+    return n;
+}
+
+static size_t _dsp_bench_scale_ref(dsp_bench_ws_t *ws, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        ws->ref[i] = ws->in[i] * (DSP_BENCH_MIX_GAIN / 32768.0);
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------ */
+/* rfft128 / rfft256：定点实FFT正反变换往返，按回声消除的分块与降噪的帧长 */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 逐块 rfft + irfft，输入左移 in_shift 位送入FFT，往返结果为 样点*2^in_shift/(2N)，移回后应等于输入
+ */
+static size_t _dsp_bench_fft_roundtrip(dsp_bench_ws_t *ws, size_t n, int log2_n, int in_shift)
+{
+    size_t len = (size_t)2 << log2_n;
+    int out_shift = in_shift - log2_n - 1;
+    for (size_t b = 0; b + len <= n; b += len) {
+        for (size_t i = 0; i < len; i++) {
+            ws->t[i] = (int32_t)ws->in[b + i] * (1 << in_shift);
+        }
+        fixed_fft_rfft(ws->t, ws->spec, ws->z, log2_n);
+        fixed_fft_irfft(ws->spec, ws->t, ws->z, log2_n);
+        for (size_t i = 0; i < len; i++) {
+            int32_t v = (ws->t[i] + (1 << (out_shift - 1))) >> out_shift;
+            ws->out[b + i] = (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+        }
+    }
+    return n;
+}
+
+static size_t _dsp_bench_rfft128_run(dsp_bench_ws_t *ws, size_t n)
+{
+    return _dsp_bench_fft_roundtrip(ws, n, 6, 10);      // aec_pbfdaf：AEC_LOG2_N、AEC_IN_SHIFT
+}
+
+static size_t _dsp_bench_rfft256_run(dsp_bench_ws_t *ws, size_t n)
+{
+    return _dsp_bench_fft_roundtrip(ws, n, 7, 12);      // noise_suppress：NS_LOG2_N、NS_IN_SHIFT
+}
+
+static size_t _dsp_bench_fft_ref(dsp_bench_ws_t *ws, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        ws->ref[i] = ws->in[i];
+    }
+    return n;
+}
+
+static const dsp_bench_kernel_t s_kernels[] = {
+    {DSP_BENCH_CALIB, 16000, _dsp_bench_nop_prepare, _dsp_bench_calib_run, NULL, 0},
+    {"legacy_linear", DSP_BENCH_LEGACY_IN, _dsp_bench_nop_prepare, _dsp_bench_legacy_run, _dsp_bench_legacy_ref, 0},
+    {"polyphase", 44100, _dsp_bench_polyphase_prepare, _dsp_bench_polyphase_run, _dsp_bench_polyphase_ref, 0},
+    {"conv_s16", 16000, _dsp_bench_conv_prepare, _dsp_bench_conv_run, _dsp_bench_conv_ref, 0},
+    {"mix_s16", 16000, _dsp_bench_nop_prepare, _dsp_bench_mix_run, _dsp_bench_mix_ref, 0},
+    {"scale_s16", 16000, _dsp_bench_nop_prepare, _dsp_bench_scale_run, _dsp_bench_scale_ref, 0},
+    {"rfft128", 16000, _dsp_bench_nop_prepare, _dsp_bench_rfft128_run, _dsp_bench_fft_ref, 128},
+    {"rfft256", 16000, _dsp_bench_nop_prepare, _dsp_bench_rfft256_run, _dsp_bench_fft_ref, 256},
+};
+
+/* ------------------------------------------------------------------ */
+/* 信号、计时与精度                                                    */
+/* ------------------------------------------------------------------ */
+
+static void _dsp_bench_signal(dsp_bench_ws_t *ws, int sig, uint32_t rate, size_t n)
+{
+    uint32_t seed = 0x2545F491u + sig;
+    for (size_t i = 0; i < n + DSP_BENCH_PAD; i++) {
+        double ph = 2.0 * M_PI * 997.0 * i / rate;
+        double v;
+        if (sig == 0) {
+            v = 0.5 * sin(ph);
+        } else if (sig == 1) {
+            seed = seed * 1664525u + 1013904223u;
+            v = ((int32_t)seed >> 16) / 131072.0;           // 均匀分布 ±0.25
+        } else {
+            v = sin(ph) >= 0 ? 1.0 : -1.0;
+        }
+        int32_t s24 = (int32_t)lrint(v * 8388607.0);
+        ws->raw[i] = (int32_t)((uint32_t)s24 << 8);
+        ws->in[i] = (int16_t)lrint(_dsp_bench_clip(v * 32768.0));
+        seed = seed * 1664525u + 1013904223u;
+        // 累加初值：另一路 -6dBFS 噪声，clip 信号时为同相满幅，使混音走饱和
+        ws->aux[i] = sig == 2 ? ws->in[i] : (int16_t)((int32_t)seed >> 17);
+    }
+}
+
+static uint32_t _dsp_bench_time(const dsp_bench_cfg_t *cfg, const dsp_bench_kernel_t *k, dsp_bench_ws_t *ws, size_t n)
+{
+    // 定标：每批重复次数翻倍直到一批超过 batch_ticks
+    uint32_t reps = 1;
+    for (;;) {
+        uint32_t t0 = cfg->clock();
+        for (uint32_t r = 0; r < reps; r++) {
+            k->run(ws, n);
+        }
+        uint32_t dt = cfg->clock() - t0;
+        if (dt >= cfg->batch_ticks || reps >= DSP_BENCH_MAX_REPS) {
+            break;
+        }
+        reps *= 2;
+    }
+    uint32_t best = UINT32_MAX;
+    for (int b = 0; b < DSP_BENCH_BATCHES; b++) {
+        uint32_t t0 = cfg->clock();
+        for (uint32_t r = 0; r < reps; r++) {
+            k->run(ws, n);
+        }
+        uint32_t dt = cfg->clock() - t0;
+        if (dt < best) {
+            best = dt;
+        }
+    }
+    return (uint32_t)((uint64_t)best * 1000 / ((uint64_t)reps * n));
+}
+
+static void _dsp_bench_verify(const dsp_bench_kernel_t *k, dsp_bench_ws_t *ws, size_t n, dsp_bench_result_t *r)
+{
+    k->prepare(ws, true);
+    size_t m = k->run(ws, n);
+    size_t mr = k->ref(ws, n);
+    if (mr < m) {
+        m = mr;
+    }
+    double sig = 0;
+    double noise = 0;
+    int32_t max_err = 0;
+    for (size_t i = 0; i < m; i++) {
+        double ref = _dsp_bench_clip(ws->ref[i]);
+        double e = ws->out[i] - ref;
+        sig += ref * ref;
+        noise += e * e;
+        int32_t ei = abs(ws->out[i] - (int32_t)lrint(ref));
+        if (ei > max_err) {
+            max_err = ei;
+        }
+    }
+    r->verified = true;
+    r->max_err = max_err;
+    r->snr_db = noise > 0 ? (float)(10.0 * log10(sig / noise)) : 150.0f;
+}
+
+int dsp_bench_run(const dsp_bench_cfg_t *cfg, dsp_bench_result_t *results, int max)
+{
+    if (!cfg || !cfg->clock || !results) {
+        return 0;
+    }
+    dsp_bench_ws_t *ws = audio_arena_calloc(NULL, 1, sizeof(dsp_bench_ws_t), AUDIO_ARENA_INTERNAL);
+    if (!ws) {
+        return -1;
+    }
+    int count = 0;
+    for (size_t ki = 0; ki < sizeof(s_kernels) / sizeof(s_kernels[0]); ki++) {
+        const dsp_bench_kernel_t *k = &s_kernels[ki];
+        if (cfg->filter && !strstr(k->name, cfg->filter) && strcmp(k->name, DSP_BENCH_CALIB) != 0) {
+            continue;
+        }
+        // 定标内核与数据无关，只跑一项
+        bool calib = !strcmp(k->name, DSP_BENCH_CALIB);
+        int signals = calib ? 1 : (int)(sizeof(s_signals) / sizeof(s_signals[0]));
+        size_t sizes = calib ? 1 : sizeof(s_sizes) / sizeof(s_sizes[0]);
+        for (int sig = 0; sig < signals; sig++) {
+            for (size_t si = 0; si < sizes && count < max; si++) {
+                size_t n = calib ? DSP_BENCH_MAX_N : s_sizes[si];
+                if (k->block && n % k->block) {
+                    continue;
+                }
+                dsp_bench_result_t *r = &results[count++];
+                memset(r, 0, sizeof(*r));
+                snprintf(r->kernel, sizeof(r->kernel), "%s", k->name);
+                snprintf(r->signal, sizeof(r->signal), "%s", s_signals[sig]);
+                r->n = (uint16_t)n;
+                _dsp_bench_signal(ws, sig, k->rate, n);
+                k->prepare(ws, false);
+                r->milli_per_sample = _dsp_bench_time(cfg, k, ws, n);
+                if (cfg->verify && k->ref) {
+                    _dsp_bench_verify(k, ws, n, r);
+                }
+            }
+        }
+    }
+    audio_arena_free(NULL, ws);
+    return count;
+}
+
+/* ------------------------------------------------------------------ */
+/* 基线                                                                */
+/* ------------------------------------------------------------------ */
+
+int dsp_bench_parse_baseline(const char *text, dsp_bench_baseline_t *base, int max)
+{
+    int count = 0;
+    while (text && *text && count < max) {
+        const char *eol = strchr(text, '\n');
+        size_t len = eol ? (size_t)(eol - text) : strlen(text);
+        char line[96];
+        if (len >= sizeof(line)) {
+            len = sizeof(line) - 1;
+        }
+        memcpy(line, text, len);
+        line[len] = '\0';
+        char *hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+        dsp_bench_baseline_t *b = &base[count];
+        unsigned n = 0;
+        double v = 0;
+        if (sscanf(line, "%15s %15s %u %lf", b->kernel, b->signal, &n, &v) == 4 && n > 0 && v >= 0) {
+            b->n = (uint16_t)n;
+            b->milli_per_sample = (uint32_t)(v * 1000.0 + 0.5);
+            count++;
+        }
+        text = eol ? eol + 1 : NULL;
+    }
+    return count;
+}
+
+int dsp_bench_compare(dsp_bench_result_t *results, int count, const dsp_bench_baseline_t *base, int base_count,
+                      uint32_t threshold_pct)
+{
+    // 基线与本次都有定标项时，按两者之比折算基线，抵消睿频与降频
+    uint64_t scale_num = 1;
+    uint64_t scale_den = 1;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(results[i].kernel, DSP_BENCH_CALIB) != 0) {
+            continue;
+        }
+        for (int j = 0; j < base_count; j++) {
+            if (!strcmp(base[j].kernel, DSP_BENCH_CALIB) && base[j].milli_per_sample && results[i].milli_per_sample) {
+                scale_num = results[i].milli_per_sample;
+                scale_den = base[j].milli_per_sample;
+            }
+        }
+    }
+
+    int regressed = 0;
+    for (int i = 0; i < count; i++) {
+        dsp_bench_result_t *r = &results[i];
+        r->status = DSP_BENCH_NEW;
+        r->delta_pct = 0;
+        for (int j = 0; j < base_count; j++) {
+            const dsp_bench_baseline_t *b = &base[j];
+            if (b->n != r->n || strcmp(b->kernel, r->kernel) != 0 || strcmp(b->signal, r->signal) != 0 ||
+                b->milli_per_sample == 0) {
+                continue;
+            }
+            int64_t expect = (int64_t)(b->milli_per_sample * scale_num / scale_den);
+            if (expect <= 0) {
+                expect = 1;
+            }
+            r->delta_pct = (int32_t)(((int64_t)r->milli_per_sample - expect) * 100 / expect);
+            if (r->delta_pct > (int32_t)threshold_pct) {
+                r->status = DSP_BENCH_REGRESSED;
+                regressed++;
+            } else if (r->delta_pct < -(int32_t)threshold_pct) {
+                r->status = DSP_BENCH_FASTER;
+            } else {
+                r->status = DSP_BENCH_OK;
+            }
+            break;
+        }
+    }
+    return regressed;
+}
+
+int dsp_bench_format_baseline(const dsp_bench_result_t *r, char *buf, size_t len)
+{
+    return snprintf(buf, len, "%-14s %-6s %5u %10.3f", r->kernel, r->signal, r->n, r->milli_per_sample / 1000.0);
+}
+
+/* ------------------------------------------------------------------ */
+/* 目标板入口                                                          */
+/* ------------------------------------------------------------------ */
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+
+static const char *TAG = "DSP_BENCH";
+
+// 由 main/CMakeLists.txt 以 EMBED_TXTFILES 内嵌，以0结尾
+extern const char s_dsp_baseline_txt[] asm("_binary_dsp_baseline_esp32s3_txt_start");
+
+static uint32_t _dsp_bench_cycles(void)
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+int dsp_bench_run_target(bool verify, uint32_t threshold_pct)
+{
+    static const char *const status[] = {"new", "ok", "faster", "REGRESSED"};
+    dsp_bench_result_t *results = audio_arena_calloc(NULL, DSP_BENCH_MAX_RESULTS, sizeof(dsp_bench_result_t),
+                                                     AUDIO_ARENA_INTERNAL);
+    dsp_bench_baseline_t *base = audio_arena_calloc(NULL, DSP_BENCH_MAX_RESULTS, sizeof(dsp_bench_baseline_t),
+                                                    AUDIO_ARENA_INTERNAL);
+    if (!results || !base) {
+        audio_arena_free(NULL, results);
+        audio_arena_free(NULL, base);
+        return -1;
+    }
+    dsp_bench_cfg_t cfg = {
+        .clock = _dsp_bench_cycles,
+        .batch_ticks = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000,     // 每批约1ms
+        .verify = verify,
+    };
+    int count = dsp_bench_run(&cfg, results, DSP_BENCH_MAX_RESULTS);
+    int base_count = dsp_bench_parse_baseline(s_dsp_baseline_txt, base, DSP_BENCH_MAX_RESULTS);
+    int regressed = count > 0 ? dsp_bench_compare(results, count, base, base_count, threshold_pct) : -1;
+    // 每行前半段即基线格式（cycles/sample），可直接复制到 dsp_baseline_esp32s3.txt
+    for (int i = 0; i < count; i++) {
+        char line[64];
+        dsp_bench_format_baseline(&results[i], line, sizeof(line));
+        if (results[i].verified) {
+            ESP_LOGI(TAG, "%s # %+4d%% %-9s snr %6.1f dB max err %d", line, (int)results[i].delta_pct,
+                     status[results[i].status], results[i].snr_db, (int)results[i].max_err);
+        } else {
+            ESP_LOGI(TAG, "%s # %+4d%% %s", line, (int)results[i].delta_pct, status[results[i].status]);
+        }
+    }
+    if (base_count == 0) {
+        // 基线为空时所有结果都是 new，"0 regressed" 没有意义，明确告警而不是报通过
+        ESP_LOGW(TAG, "%d results, no baseline in dsp_baseline_esp32s3.txt - regression check disabled", count);
+    } else {
+        ESP_LOGI(TAG, "%d results, %d baselines, %d regressed beyond %u%%", count, base_count, regressed,
+                 (unsigned)threshold_pct);
+    }
+    audio_arena_free(NULL, results);
+    audio_arena_free(NULL, base);
+    return regressed;
+}
+#endif
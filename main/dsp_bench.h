@@ -0,0 +1,129 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 16:00:00
+ * @LastEditTime: 2026-10-17 16:00:00
+ * @LastEditors: 星年
+ * @Description: DSP内核微基准：各内核按固定块长与信号类型计时（主机纳秒/目标板CPU周期，每样点），
+ *               与树内基线比较标记回退，可同时与双精度参考比较精度，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\dsp_bench.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DSP_BENCH_MAX_N         1024    // 最大块长（样点）
+#define DSP_BENCH_MAX_RESULTS   64      // 一次运行最多结果条数（内核 x 信号 x 块长）
+#define DSP_BENCH_NAME_LEN      16      // 内核/信号名最大长度（含结尾0）
+#define DSP_BENCH_BATCHES       8       // 每项计时批数，取最快一批（排除中断与缓存冷启动）
+#define DSP_BENCH_THRESHOLD_PCT 15      // 默认回退阈值（%）
+#define DSP_BENCH_CALIB         "calib" // 定标项名：纯整数依赖链，比较时按它折算基线，抵消CPU频率变化
+
+/**
+ * @brief 运行配置
+ */
+typedef struct {
+    uint32_t (*clock)(void);    // 计时源：主机为纳秒，目标板为CPU周期计数（32位回绕按差值处理）
+    uint32_t batch_ticks;       // 每批至少累计的计时，按此自动确定每批重复次数
+    bool verify;                // 同时与双精度参考比较精度
+    const char *filter;         // 只跑名称包含该子串的内核，NULL 全跑
+} dsp_bench_cfg_t;
+
+/**
+ * @brief 与基线比较的结论
+ */
+typedef enum {
+    DSP_BENCH_NEW = 0,          // 基线中没有该项
+    DSP_BENCH_OK,               // 在阈值内
+    DSP_BENCH_FASTER,           // 快于基线超过阈值（可考虑更新基线）
+    DSP_BENCH_REGRESSED,        // 慢于基线超过阈值
+} dsp_bench_status_t;
+
+/**
+ * @brief 单项结果
+ */
+typedef struct {
+    char kernel[DSP_BENCH_NAME_LEN];
+    char signal[DSP_BENCH_NAME_LEN];
+    uint16_t n;                 // 块长（每次调用的输入样点数）
+    uint32_t milli_per_sample;  // 每输入样点的计时 x1000（纳秒或周期）
+    bool verified;              // 是否做了精度比较
+    float snr_db;               // 相对双精度参考的信噪比（dB）
+    int32_t max_err;            // 相对双精度参考（取整后）的最大绝对误差（LSB）
+    dsp_bench_status_t status;  // 与基线比较的结论
+    int32_t delta_pct;          // 相对基线的变化（%，正为变慢）
+} dsp_bench_result_t;
+
+/**
+ * @brief 基线条目
+ */
+typedef struct {
+    char kernel[DSP_BENCH_NAME_LEN];
+    char signal[DSP_BENCH_NAME_LEN];
+    uint16_t n;
+    uint32_t milli_per_sample;
+} dsp_bench_baseline_t;
+
+/**
+ * @brief 运行全部（或按 filter 选出的）内核
+ *
+ * 内核：calib（定标，只一项，总是运行）、legacy_linear（原 resample_audio() 浮点线性插值，44.1k->16k）、
+ * polyphase（多相重采样）、conv_s16（24-in-32 -> 16位格式转换）、mix_s16（按增益混入一路）、scale_s16（增益）、
+ * rfft128 / rfft256（定点实FFT正反变换往返，回声消除的分块 / 降噪的帧长，只跑其整数倍的块长）；
+ * 信号：sine（997Hz -6dBFS）、noise（-12dBFS白噪声）、clip（满幅方波，走饱和路径）；
+ * 块长：64、256、1024。工作缓冲从堆分配，运行结束释放。
+ *
+ * @param cfg     配置
+ * @param results 结果数组
+ * @param max     结果数组容量
+ * @return 结果条数，内存不足返回-1
+ */
+int dsp_bench_run(const dsp_bench_cfg_t *cfg, dsp_bench_result_t *results, int max);
+
+/**
+ * @brief 解析基线文本：每行 "<内核> <信号> <块长> <每样点计时>"，# 起为注释
+ *
+ * @return 解析出的条目数
+ */
+int dsp_bench_parse_baseline(const char *text, dsp_bench_baseline_t *base, int max);
+
+/**
+ * @brief 按基线填写各结果的 status 与 delta_pct
+ *
+ * 两边都有 calib 项时，基线按本次与基线的 calib 之比折算后再比较（主机睿频/降频对所有项同比影响）。
+ *
+ * @param threshold_pct 阈值（%），超出即标记回退或变快
+ * @return 回退的条目数
+ */
+int dsp_bench_compare(dsp_bench_result_t *results, int count, const dsp_bench_baseline_t *base, int base_count,
+                      uint32_t threshold_pct);
+
+/**
+ * @brief 把一条结果格式化为基线行（不含换行），可直接粘贴到基线文件
+ *
+ * @return 写入的字符数
+ */
+int dsp_bench_format_baseline(const dsp_bench_result_t *r, char *buf, size_t len);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief 目标板上以CPU周期计数运行全部内核，按固件内嵌的基线（dsp_baseline_esp32s3.txt）比较并打印
+ *
+ * 运行期间独占当前核心，应在启动各音频管道之前调用。基线为空时打印告警，不做回退检查。
+ *
+ * @param verify        同时做精度比较
+ * @param threshold_pct 回退阈值（%）
+ * @return 回退的条目数，内存不足返回-1
+ */
+int dsp_bench_run_target(bool verify, uint32_t threshold_pct);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
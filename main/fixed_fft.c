@@ -0,0 +1,79 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 定点实FFT实现：按最大点数生成的一套表，较小点数按步长取用
+ * @FilePath: \audio_manager\main\fixed_fft.c
+ * 遇事不决，可问春风
+ */
+#include "fixed_fft.h"
+#include "fixed_fft_tables.h"
+
+void fixed_fft(fixed_fft_cpx_t *z, int log2_n, int inverse)
+{
+    const int n = 1 << log2_n;
+    const int ts = FIXED_FFT_LOG2_MAX_N - log2_n;   // 旋转因子表步长的log2
+    for (int len = 2, step = n / 2; len <= n; len <<= 1, step >>= 1) {
+        int half = len >> 1;
+        for (int i = 0; i < n; i += len) {
+            for (int j = 0; j < half; j++) {
+                fixed_fft_cpx_t w = s_fixed_fft_tw[(j * step) << ts];
+                if (inverse) {
+                    w.im = -w.im;
+                }
+                fixed_fft_cpx_t t = fixed_fft_cmul(z[i + j + half], w);
+                fixed_fft_cpx_t u = z[i + j];
+                z[i + j].re = (u.re >> 1) + (t.re >> 1);
+                z[i + j].im = (u.im >> 1) + (t.im >> 1);
+                z[i + j + half].re = (u.re >> 1) - (t.re >> 1);
+                z[i + j + half].im = (u.im >> 1) - (t.im >> 1);
+            }
+        }
+    }
+}
+
+void fixed_fft_rfft(const int32_t *x, fixed_fft_cpx_t *X, fixed_fft_cpx_t *z, int log2_n)
+{
+    const int n = 1 << log2_n;
+    const int ts = FIXED_FFT_LOG2_MAX_N - log2_n;
+    for (int i = 0; i < n; i++) {
+        int r = s_fixed_fft_rev[i] >> ts;
+        z[r].re = x[2 * i];
+        z[r].im = x[2 * i + 1];
+    }
+    fixed_fft(z, log2_n, 0);
+    for (int k = 0; k <= n; k++) {
+        fixed_fft_cpx_t p = z[k & (n - 1)];
+        fixed_fft_cpx_t q = z[(n - k) & (n - 1)];
+        q.im = -q.im;
+        fixed_fft_cpx_t fe = {(p.re >> 1) + (q.re >> 1), (p.im >> 1) + (q.im >> 1)};
+        fixed_fft_cpx_t fo = {(p.im >> 1) - (q.im >> 1), (q.re >> 1) - (p.re >> 1)};
+        fixed_fft_cpx_t t = fixed_fft_cmul(fo, s_fixed_fft_sp[k << ts]);
+        X[k].re = (fe.re >> 1) + (t.re >> 1);
+        X[k].im = (fe.im >> 1) + (t.im >> 1);
+    }
+}
+
+void fixed_fft_irfft(const fixed_fft_cpx_t *X, int32_t *x, fixed_fft_cpx_t *z, int log2_n)
+{
+    const int n = 1 << log2_n;
+    const int ts = FIXED_FFT_LOG2_MAX_N - log2_n;
+    for (int k = 0; k < n; k++) {
+        fixed_fft_cpx_t p = X[k];
+        fixed_fft_cpx_t q = X[n - k];
+        q.im = -q.im;
+        fixed_fft_cpx_t fe = {(p.re >> 1) + (q.re >> 1), (p.im >> 1) + (q.im >> 1)};
+        fixed_fft_cpx_t d = {(p.re >> 1) - (q.re >> 1), (p.im >> 1) - (q.im >> 1)};
+        fixed_fft_cpx_t w = {s_fixed_fft_sp[k << ts].re, -s_fixed_fft_sp[k << ts].im};
+        fixed_fft_cpx_t fo = fixed_fft_cmul(d, w);
+        int r = s_fixed_fft_rev[k] >> ts;
+        z[r].re = fe.re - fo.im;
+        z[r].im = fe.im + fo.re;
+    }
+    fixed_fft(z, log2_n, 1);
+    for (int i = 0; i < n; i++) {
+        x[2 * i] = z[i].re;
+        x[2 * i + 1] = z[i].im;
+    }
+}
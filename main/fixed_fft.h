@@ -0,0 +1,69 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 定点实FFT：回声消除与降噪共用的基2复数FFT与实FFT拆分，表在Flash中只有一份，纯C实现，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\fixed_fft.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIXED_FFT_TW_Q          30                          // 旋转因子定点位数
+#define FIXED_FFT_LOG2_MAX_N    7                           // 复数点数上限的log2
+#define FIXED_FFT_MAX_N         (1 << FIXED_FFT_LOG2_MAX_N) // 复数点数上限（实FFT长度256）
+
+typedef struct {
+    int32_t re;
+    int32_t im;
+} fixed_fft_cpx_t;
+
+/**
+ * @brief 定点复数乘 a*w，w 为 Q30
+ */
+static inline fixed_fft_cpx_t fixed_fft_cmul(fixed_fft_cpx_t a, fixed_fft_cpx_t w)
+{
+    fixed_fft_cpx_t r;
+    r.re = (int32_t)(((int64_t)a.re * w.re - (int64_t)a.im * w.im) >> FIXED_FFT_TW_Q);
+    r.im = (int32_t)(((int64_t)a.re * w.im + (int64_t)a.im * w.re) >> FIXED_FFT_TW_Q);
+    return r;
+}
+
+/**
+ * @brief N点复数FFT（输入已按位反转排列），每级右移1位，输出为 DFT/N 或 IDFT(未归一化)/N
+ *
+ * @param z       数据，原地变换
+ * @param log2_n  log2(N)，1..FIXED_FFT_LOG2_MAX_N
+ * @param inverse 非0做逆变换
+ */
+void fixed_fft(fixed_fft_cpx_t *z, int log2_n, int inverse);
+
+/**
+ * @brief 2N点实FFT：X[0..N] = DFT(x)/(2N)
+ *
+ * @param x      2N个时域样点
+ * @param X      N+1个频点
+ * @param z      N个复数的工作区
+ * @param log2_n log2(N)
+ */
+void fixed_fft_rfft(const int32_t *x, fixed_fft_cpx_t *X, fixed_fft_cpx_t *z, int log2_n);
+
+/**
+ * @brief 2N点实IFFT：x = IDFT(X)（归一化），即 irfft(rfft(x)) = x/(2N)
+ *
+ * @param X      N+1个频点（X[0]、X[N]虚部忽略）
+ * @param x      2N个时域样点
+ * @param z      N个复数的工作区
+ * @param log2_n log2(N)
+ */
+void fixed_fft_irfft(const fixed_fft_cpx_t *X, int32_t *x, fixed_fft_cpx_t *z, int log2_n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,77 @@
+/*
+ * 由 tools/gen_fixed_fft_tables.py 生成, 请勿手工修改
+ * MAX_N=128 (实FFT长度256) Q30
+ */
+#pragma once
+
+#include <stdint.h>
+#include "fixed_fft.h"
+
+/* 复数FFT旋转因子 e^{-j2πk/N} */
+static const fixed_fft_cpx_t s_fixed_fft_tw[64] = {
+    { 1073741824,           0}, { 1072448455,   -52686014}, { 1068571464,  -105245103}, { 1062120190,  -157550647},
+    { 1053110176,  -209476638}, { 1041563127,  -260897982}, { 1027506862,  -311690799}, { 1010975242,  -361732726},
+    {  992008094,  -410903207}, {  970651112,  -459083786}, {  946955747,  -506158392}, {  920979082,  -552013618},
+    {  892783698,  -596538995}, {  862437520,  -639627258}, {  830013654,  -681174602}, {  795590213,  -721080937},
+    {  759250125,  -759250125}, {  721080937,  -795590213}, {  681174602,  -830013654}, {  639627258,  -862437520},
+    {  596538995,  -892783698}, {  552013618,  -920979082}, {  506158392,  -946955747}, {  459083786,  -970651112},
+    {  410903207,  -992008094}, {  361732726, -1010975242}, {  311690799, -1027506862}, {  260897982, -1041563127},
+    {  209476638, -1053110176}, {  157550647, -1062120190}, {  105245103, -1068571464}, {   52686014, -1072448455},
+    {          0, -1073741824}, {  -52686014, -1072448455}, { -105245103, -1068571464}, { -157550647, -1062120190},
+    { -209476638, -1053110176}, { -260897982, -1041563127}, { -311690799, -1027506862}, { -361732726, -1010975242},
+    { -410903207,  -992008094}, { -459083786,  -970651112}, { -506158392,  -946955747}, { -552013618,  -920979082},
+    { -596538995,  -892783698}, { -639627258,  -862437520}, { -681174602,  -830013654}, { -721080937,  -795590213},
+    { -759250125,  -759250125}, { -795590213,  -721080937}, { -830013654,  -681174602}, { -862437520,  -639627258},
+    { -892783698,  -596538995}, { -920979082,  -552013618}, { -946955747,  -506158392}, { -970651112,  -459083786},
+    { -992008094,  -410903207}, {-1010975242,  -361732726}, {-1027506862,  -311690799}, {-1041563127,  -260897982},
+    {-1053110176,  -209476638}, {-1062120190,  -157550647}, {-1068571464,  -105245103}, {-1072448455,   -52686014},
+};
+
+/* 实FFT拆分因子 e^{-jπk/N} */
+static const fixed_fft_cpx_t s_fixed_fft_sp[129] = {
+    { 1073741824,           0}, { 1073418433,   -26350943}, { 1072448455,   -52686014}, { 1070832474,   -78989349},
+    { 1068571464,  -105245103}, { 1065666786,  -131437462}, { 1062120190,  -157550647}, { 1057933813,  -183568930},
+    { 1053110176,  -209476638}, { 1047652185,  -235258165}, { 1041563127,  -260897982}, { 1034846671,  -286380643},
+    { 1027506862,  -311690799}, { 1019548121,  -336813204}, { 1010975242,  -361732726}, { 1001793390,  -386434353},
+    {  992008094,  -410903207}, {  981625251,  -435124548}, {  970651112,  -459083786}, {  959092290,  -482766489},
+    {  946955747,  -506158392}, {  934248793,  -529245404}, {  920979082,  -552013618}, {  907154608,  -574449320},
+    {  892783698,  -596538995}, {  877875009,  -618269338}, {  862437520,  -639627258}, {  846480531,  -660599890},
+    {  830013654,  -681174602}, {  813046808,  -701339000}, {  795590213,  -721080937}, {  777654384,  -740388522},
+    {  759250125,  -759250125}, {  740388522,  -777654384}, {  721080937,  -795590213}, {  701339000,  -813046808},
+    {  681174602,  -830013654}, {  660599890,  -846480531}, {  639627258,  -862437520}, {  618269338,  -877875009},
+    {  596538995,  -892783698}, {  574449320,  -907154608}, {  552013618,  -920979082}, {  529245404,  -934248793},
+    {  506158392,  -946955747}, {  482766489,  -959092290}, {  459083786,  -970651112}, {  435124548,  -981625251},
+    {  410903207,  -992008094}, {  386434353, -1001793390}, {  361732726, -1010975242}, {  336813204, -1019548121},
+    {  311690799, -1027506862}, {  286380643, -1034846671}, {  260897982, -1041563127}, {  235258165, -1047652185},
+    {  209476638, -1053110176}, {  183568930, -1057933813}, {  157550647, -1062120190}, {  131437462, -1065666786},
+    {  105245103, -1068571464}, {   78989349, -1070832474}, {   52686014, -1072448455}, {   26350943, -1073418433},
+    {          0, -1073741824}, {  -26350943, -1073418433}, {  -52686014, -1072448455}, {  -78989349, -1070832474},
+    { -105245103, -1068571464}, { -131437462, -1065666786}, { -157550647, -1062120190}, { -183568930, -1057933813},
+    { -209476638, -1053110176}, { -235258165, -1047652185}, { -260897982, -1041563127}, { -286380643, -1034846671},
+    { -311690799, -1027506862}, { -336813204, -1019548121}, { -361732726, -1010975242}, { -386434353, -1001793390},
+    { -410903207,  -992008094}, { -435124548,  -981625251}, { -459083786,  -970651112}, { -482766489,  -959092290},
+    { -506158392,  -946955747}, { -529245404,  -934248793}, { -552013618,  -920979082}, { -574449320,  -907154608},
+    { -596538995,  -892783698}, { -618269338,  -877875009}, { -639627258,  -862437520}, { -660599890,  -846480531},
+    { -681174602,  -830013654}, { -701339000,  -813046808}, { -721080937,  -795590213}, { -740388522,  -777654384},
+    { -759250125,  -759250125}, { -777654384,  -740388522}, { -795590213,  -721080937}, { -813046808,  -701339000},
+    { -830013654,  -681174602}, { -846480531,  -660599890}, { -862437520,  -639627258}, { -877875009,  -618269338},
+    { -892783698,  -596538995}, { -907154608,  -574449320}, { -920979082,  -552013618}, { -934248793,  -529245404},
+    { -946955747,  -506158392}, { -959092290,  -482766489}, { -970651112,  -459083786}, { -981625251,  -435124548},
+    { -992008094,  -410903207}, {-1001793390,  -386434353}, {-1010975242,  -361732726}, {-1019548121,  -336813204},
+    {-1027506862,  -311690799}, {-1034846671,  -286380643}, {-1041563127,  -260897982}, {-1047652185,  -235258165},
+    {-1053110176,  -209476638}, {-1057933813,  -183568930}, {-1062120190,  -157550647}, {-1065666786,  -131437462},
+    {-1068571464,  -105245103}, {-1070832474,   -78989349}, {-1072448455,   -52686014}, {-1073418433,   -26350943},
+    {-1073741824,           0},
+};
+
+/* 位反转下标 */
+static const uint8_t s_fixed_fft_rev[128] = {
+      0,  64,  32,  96,  16,  80,  48, 112,   8,  72,  40, 104,  24,  88,  56, 120,
+      4,  68,  36, 100,  20,  84,  52, 116,  12,  76,  44, 108,  28,  92,  60, 124,
+      2,  66,  34,  98,  18,  82,  50, 114,  10,  74,  42, 106,  26,  90,  58, 122,
+      6,  70,  38, 102,  22,  86,  54, 118,  14,  78,  46, 110,  30,  94,  62, 126,
+      1,  65,  33,  97,  17,  81,  49, 113,   9,  73,  41, 105,  25,  89,  57, 121,
+      5,  69,  37, 101,  21,  85,  53, 117,  13,  77,  45, 109,  29,  93,  61, 125,
+      3,  67,  35,  99,  19,  83,  51, 115,  11,  75,  43, 107,  27,  91,  59, 123,
+      7,  71,  39, 103,  23,  87,  55, 119,  15,  79,  47, 111,  31,  95,  63, 127,
+};
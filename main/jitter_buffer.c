@@ -0,0 +1,380 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 11:00:00
+ * @LastEditTime: 2026-10-16 11:00:00
+ * @LastEditors: 星年
+ * @Description: 自适应抖动缓冲实现，单线程使用（由解码任务独占），不依赖FreeRTOS，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\jitter_buffer.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "jitter_buffer.h"
+
+#define JB_HISTORY          128     // 统计到达延迟的包数窗口
+#define JB_HIST_BIN_MS      5       // 延迟直方图分辨率（毫秒）
+#define JB_HIST_BINS        128     // 直方图格数（覆盖 0 ~ 640ms）
+#define JB_PERCENTILE       95      // 目标深度覆盖的延迟分位
+#define JB_LEVEL_SHIFT      4       // 缓冲水位平滑系数 1/16
+#define JB_GROW_COOLDOWN    16      // 增加深度后的冷却帧数
+#define JB_SHRINK_COOLDOWN  50      // 缩减深度后的冷却帧数（约1秒）
+#define JB_MAX_CONCEAL      10      // 连续隐藏超过此帧数视为流中断，回到缓冲状态
+
+typedef struct {
+    uint8_t *data;      // 包数据
+    uint16_t len;       // 包长度
+    bool valid;         // 是否持有包
+    int32_t seq;        // 展开后的序号
+} jb_slot_t;
+
+struct jitter_buffer {
+    jitter_buffer_cfg_t cfg;            // 配置
+    jb_slot_t *slots;                   // 包槽（按序号取模索引）
+    uint8_t *mem;                       // 包数据区
+    uint32_t mask;                      // slot_count - 1
+
+    bool started;                       // 是否已收到首包
+    bool playing;                       // 是否已完成预缓冲、正在播放
+    int32_t max_seq;                    // 已收到的最大序号（展开后）
+    int32_t next_seq;                   // 下一个待播放序号（展开后）
+    int32_t pending_free;               // 上次NORMAL返回的包槽，下次取帧时释放（-1为无）
+    int32_t playout_seq;                // 最近一次取出的帧序号
+
+    int32_t delay[JB_HISTORY];          // 相对到达延迟历史（到达时间 - 序号*帧长）
+    uint32_t delay_count;               // 历史有效数量
+    uint32_t delay_pos;                 // 历史写入位置
+
+    uint16_t min_frames;                // 最小目标深度（帧）
+    uint16_t max_frames;                // 最大目标深度（帧）
+    uint16_t target_frames;             // 当前目标深度（帧）
+    int32_t level_q8;                   // 平滑后的缓冲帧数（Q8）
+    uint16_t cooldown;                  // 深度调整冷却计数
+    uint16_t missing_run;               // 连续隐藏帧数
+
+    jitter_buffer_stats_t stats;        // 统计
+};
+
+static inline int32_t jb_buffered(const jitter_buffer_t *jb)
+{
+    int32_t n = jb->max_seq - jb->next_seq + 1;
+    return n > 0 ? n : 0;
+}
+
+static void jb_free_slot(jitter_buffer_t *jb, int32_t seq)
+{
+    jb_slot_t *slot = &jb->slots[(uint32_t)seq & jb->mask];
+    if (slot->valid && slot->seq == seq) {
+        slot->valid = false;
+    }
+}
+
+static void jb_flush(jitter_buffer_t *jb)
+{
+    for (uint32_t i = 0; i <= jb->mask; i++) {
+        jb->slots[i].valid = false;
+    }
+    jb->started = false;
+    jb->playing = false;
+    jb->pending_free = -1;
+    jb->missing_run = 0;
+    jb->cooldown = 0;
+}
+
+/**
+ * @brief 由延迟历史更新抖动估计与目标深度
+ *
+ * 以窗口内最小延迟为基线，取相对延迟的95分位作为抖动，
+ * 目标深度 = ceil(抖动 / 帧长) + 1 帧，限制在 [min, max] 内。
+ */
+static void jb_update_target(jitter_buffer_t *jb)
+{
+    int32_t min_d = jb->delay[0];
+    for (uint32_t i = 1; i < jb->delay_count; i++) {
+        if (jb->delay[i] < min_d) {
+            min_d = jb->delay[i];
+        }
+    }
+    uint16_t hist[JB_HIST_BINS] = {0};
+    for (uint32_t i = 0; i < jb->delay_count; i++) {
+        int32_t bin = (jb->delay[i] - min_d) / JB_HIST_BIN_MS;
+        if (bin >= JB_HIST_BINS) {
+            bin = JB_HIST_BINS - 1;
+        }
+        hist[bin]++;
+    }
+    uint32_t need = (jb->delay_count * JB_PERCENTILE + 99) / 100;
+    uint32_t acc = 0;
+    int32_t bin = 0;
+    for (; bin < JB_HIST_BINS; bin++) {
+        acc += hist[bin];
+        if (acc >= need) {
+            break;
+        }
+    }
+    uint32_t jitter_ms = (uint32_t)(bin + 1) * JB_HIST_BIN_MS;
+    uint32_t frames = (jitter_ms * 1000 + jb->cfg.frame_us - 1) / jb->cfg.frame_us + 1;
+    if (frames < jb->min_frames) {
+        frames = jb->min_frames;
+    }
+    if (frames > jb->max_frames) {
+        frames = jb->max_frames;
+    }
+    jb->target_frames = (uint16_t)frames;
+    jb->stats.jitter_ms = (uint16_t)jitter_ms;
+}
+
+static uint32_t jb_slot_count(uint32_t n)
+{
+    uint32_t count = 1;
+    while (count < n) {
+        count <<= 1;
+    }
+    return count;
+}
+
+size_t jitter_buffer_mem_size(const jitter_buffer_cfg_t *cfg, audio_arena_place_t place)
+{
+    if (cfg == NULL || cfg->frame_us == 0 || cfg->slot_count == 0 || cfg->slot_size == 0) {
+        return 0;
+    }
+    uint32_t count = jb_slot_count(cfg->slot_count);
+    if (place == AUDIO_ARENA_PSRAM) {
+        return AUDIO_ARENA_SIZE((size_t)count * cfg->slot_size);
+    }
+    return AUDIO_ARENA_SIZE(sizeof(jitter_buffer_t)) + AUDIO_ARENA_SIZE(count * sizeof(jb_slot_t));
+}
+
+jitter_buffer_t *jitter_buffer_create(const jitter_buffer_cfg_t *cfg)
+{
+    if (cfg == NULL || cfg->frame_us == 0 || cfg->slot_count == 0 || cfg->slot_size == 0) {
+        return NULL;
+    }
+    uint32_t count = jb_slot_count(cfg->slot_count);
+    // 包槽描述每帧都要查找，放片内；包数据区放PSRAM
+    jitter_buffer_t *jb = audio_arena_calloc(cfg->arena, 1, sizeof(jitter_buffer_t), AUDIO_ARENA_INTERNAL);
+    if (!jb) {
+        return NULL;
+    }
+    jb->cfg = *cfg;
+    jb->cfg.slot_count = (uint16_t)count;
+    jb->slots = audio_arena_calloc(cfg->arena, count, sizeof(jb_slot_t), AUDIO_ARENA_INTERNAL);
+    jb->mem = audio_arena_calloc(cfg->arena, count, cfg->slot_size, AUDIO_ARENA_PSRAM);
+    if (!jb->slots || !jb->mem) {
+        jitter_buffer_destroy(jb);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        jb->slots[i].data = jb->mem + (size_t)i * cfg->slot_size;
+    }
+    jb->mask = count - 1;
+
+    uint32_t min_frames = (cfg->min_depth_ms * 1000u + cfg->frame_us - 1) / cfg->frame_us;
+    uint32_t max_frames = cfg->max_depth_ms * 1000u / cfg->frame_us;
+    if (min_frames < 1) {
+        min_frames = 1;
+    }
+    if (max_frames > count - 1) {
+        max_frames = count - 1;     // 至少留一个包槽给正在到达的包
+    }
+    if (max_frames < min_frames) {
+        max_frames = min_frames;
+    }
+    jb->min_frames = (uint16_t)min_frames;
+    jb->max_frames = (uint16_t)max_frames;
+    jitter_buffer_reset(jb);
+    return jb;
+}
+
+void jitter_buffer_destroy(jitter_buffer_t *jb)
+{
+    if (!jb) {
+        return;
+    }
+    audio_arena_free(jb->cfg.arena, jb->slots);
+    audio_arena_free(jb->cfg.arena, jb->mem);
+    audio_arena_free(jb->cfg.arena, jb);
+}
+
+void jitter_buffer_reset(jitter_buffer_t *jb)
+{
+    jb_flush(jb);
+    jb->delay_count = 0;
+    jb->delay_pos = 0;
+    jb->target_frames = jb->min_frames;
+    jb->level_q8 = 0;
+    memset(&jb->stats, 0, sizeof(jb->stats));
+}
+
+int jitter_buffer_put(jitter_buffer_t *jb, const uint8_t *data, uint16_t len, uint16_t seq, uint32_t arrival_ms)
+{
+    if (len > jb->cfg.slot_size) {
+        return -1;
+    }
+    if (!jb->started) {
+        jb->started = true;
+        jb->max_seq = seq;
+        jb->next_seq = seq;
+    }
+    // 以已收到的最大序号为参考展开16位序号
+    int32_t ext = jb->max_seq + (int16_t)(seq - (uint16_t)jb->max_seq);
+
+    if (ext < jb->next_seq) {
+        if (jb->playing) {
+            jb->stats.late++;
+            return -1;
+        }
+        if (jb->max_seq - ext >= (int32_t)jb->mask) {
+            jb->stats.late++;
+            return -1;
+        }
+        jb->next_seq = ext;     // 预缓冲阶段，更早的包提前播放起点
+    }
+    if (ext - jb->next_seq > (int32_t)jb->mask) {
+        // 超出可重排范围（发送端重启或长时间中断），丢弃旧状态从该包重新开始
+        jb_flush(jb);
+        jb->started = true;
+        jb->max_seq = ext;
+        jb->next_seq = ext;
+        jb->delay_count = 0;
+        jb->delay_pos = 0;
+        jb->stats.resync++;
+    }
+
+    jb_slot_t *slot = &jb->slots[(uint32_t)ext & jb->mask];
+    if (slot->valid && slot->seq == ext) {
+        jb->stats.duplicate++;
+        return -1;
+    }
+    memcpy(slot->data, data, len);
+    slot->len = len;
+    slot->seq = ext;
+    slot->valid = true;
+    if (ext < jb->max_seq) {
+        jb->stats.reordered++;
+    } else {
+        jb->max_seq = ext;
+    }
+    jb->stats.received++;
+
+    jb->delay[jb->delay_pos] = (int32_t)(arrival_ms - (uint32_t)((int64_t)ext * jb->cfg.frame_us / 1000));
+    jb->delay_pos = (jb->delay_pos + 1) % JB_HISTORY;
+    if (jb->delay_count < JB_HISTORY) {
+        jb->delay_count++;
+    }
+    jb_update_target(jb);
+    return 0;
+}
+
+int jitter_buffer_put_redundant(jitter_buffer_t *jb, const uint8_t *data, uint16_t len, uint16_t seq)
+{
+    if (!jb->started || len > jb->cfg.slot_size) {
+        return -1;
+    }
+    // 冗余块只填补播放点之后、已收到的最大序号之前的空位，不改变参考序号与到达统计
+    int32_t ext = jb->max_seq + (int16_t)(seq - (uint16_t)jb->max_seq);
+    if (ext < jb->next_seq || ext >= jb->max_seq || jb->max_seq - ext >= (int32_t)jb->mask) {
+        return -1;
+    }
+    jb_slot_t *slot = &jb->slots[(uint32_t)ext & jb->mask];
+    if (slot->valid && slot->seq == ext) {
+        return -1;  // 原包已到（常态），不计重复
+    }
+    memcpy(slot->data, data, len);
+    slot->len = len;
+    slot->seq = ext;
+    slot->valid = true;
+    jb->stats.redundant++;
+    return 0;
+}
+
+jitter_frame_type_t jitter_buffer_get(jitter_buffer_t *jb, const uint8_t **data, uint16_t *len)
+{
+    *data = NULL;
+    *len = 0;
+    if (jb->pending_free >= 0) {
+        jb_free_slot(jb, jb->pending_free);
+        jb->pending_free = -1;
+    }
+    if (!jb->started) {
+        return JITTER_FRAME_NONE;
+    }
+
+    int32_t buffered = jb_buffered(jb);
+    jb->level_q8 += ((buffered << 8) - jb->level_q8) >> JB_LEVEL_SHIFT;
+    jb->stats.depth_ms = (uint16_t)(buffered * jb->cfg.frame_us / 1000);
+    jb->stats.target_ms = (uint16_t)(jb->target_frames * jb->cfg.frame_us / 1000);
+
+    // 1. 预缓冲：攒够目标深度后开始播放。只保留最近的目标深度，流中断或发送端DTX静音
+    //    期间零星到达的旧包（及其间未发送的帧）不计入缓冲，避免新话段起播延迟被抬高
+    if (!jb->playing) {
+        while (buffered > jb->target_frames) {
+            jb_free_slot(jb, jb->next_seq);
+            jb->next_seq++;
+            buffered--;
+        }
+        if (buffered < jb->target_frames) {
+            return JITTER_FRAME_NONE;
+        }
+        jb->playing = true;
+        jb->level_q8 = buffered << 8;
+        jb->missing_run = 0;
+        jb->cooldown = JB_GROW_COOLDOWN;
+    }
+
+    // 2. 以帧长为步进调整深度：水位偏低插入一帧隐藏，偏高丢弃一帧
+    if (jb->cooldown > 0) {
+        jb->cooldown--;
+    } else if (jb->level_q8 < ((int32_t)jb->target_frames << 8) - 128) {
+        jb->cooldown = JB_GROW_COOLDOWN;
+        jb->level_q8 += 1 << 8;
+        jb->playout_seq = jb->next_seq - 1;
+        jb->stats.inserted++;
+        return JITTER_FRAME_PLC;
+    } else if (jb->level_q8 > ((int32_t)jb->target_frames << 8) + 384 && buffered > jb->target_frames) {
+        jb_free_slot(jb, jb->next_seq);
+        jb->next_seq++;
+        jb->cooldown = JB_SHRINK_COOLDOWN;
+        jb->level_q8 -= 1 << 8;
+        jb->stats.dropped++;
+    }
+
+    // 3. 取出下一帧；缺失时优先用下一包的FEC（发送端启用时），其次PLC
+    jb_slot_t *slot = &jb->slots[(uint32_t)jb->next_seq & jb->mask];
+    if (slot->valid && slot->seq == jb->next_seq) {
+        *data = slot->data;
+        *len = slot->len;
+        jb->pending_free = jb->next_seq;
+        jb->playout_seq = jb->next_seq;
+        jb->next_seq++;
+        jb->missing_run = 0;
+        jb->stats.played++;
+        return JITTER_FRAME_NORMAL;
+    }
+    if (jb_buffered(jb) == 0 && jb->missing_run >= JB_MAX_CONCEAL) {
+        jb->playing = false;    // 流中断，停止隐藏并重新预缓冲
+        return JITTER_FRAME_NONE;
+    }
+    jb->missing_run++;
+    int32_t lost = jb->next_seq++;
+    jb->playout_seq = lost;
+    jb_slot_t *next = &jb->slots[(uint32_t)jb->next_seq & jb->mask];
+    if (jb->cfg.fec && next->valid && next->seq == lost + 1) {
+        *data = next->data;
+        *len = next->len;
+        jb->stats.fec++;
+        return JITTER_FRAME_FEC;
+    }
+    jb->stats.plc++;
+    return JITTER_FRAME_PLC;
+}
+
+uint16_t jitter_buffer_playout_seq(const jitter_buffer_t *jb)
+{
+    return (uint16_t)jb->playout_seq;
+}
+
+void jitter_buffer_get_stats(const jitter_buffer_t *jb, jitter_buffer_stats_t *stats)
+{
+    *stats = jb->stats;
+}
@@ -0,0 +1,150 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 11:00:00
+ * @LastEditTime: 2026-10-16 11:00:00
+ * @LastEditors: 星年
+ * @Description: 自适应抖动缓冲：按序号重排，统计到达延迟分布，以帧长为步进调整目标深度，缺包时指示FEC/PLC
+ * @FilePath: \audio_manager\main\jitter_buffer.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 抖动缓冲配置
+ */
+typedef struct {
+    uint32_t frame_us;          // 每包时长（微秒，Opus为2500~60000），目标深度按此步进
+    uint16_t slot_count;        // 包槽数量（2的幂），决定最大可重排范围
+    uint16_t slot_size;         // 每个包槽容量（字节）
+    uint16_t min_depth_ms;      // 最小目标深度
+    uint16_t max_depth_ms;      // 最大目标深度
+    bool fec;                   // 发送端启用了带内FEC：缺包而下一包已到时指示FEC，否则一律PLC
+    audio_arena_t *arena;       // 内存区，NULL 时从堆分配
+} jitter_buffer_cfg_t;
+
+#define DEFAULT_JITTER_BUFFER_CONFIG() {    \
+    .frame_us     = 20000,                  \
+    .slot_count   = 32,                     \
+    .slot_size    = 512,                    \
+    .min_depth_ms = 40,                     \
+    .max_depth_ms = 400,                    \
+    .fec          = false,                  \
+    .arena        = NULL,                   \
+}
+
+/**
+ * @brief 取帧结果类型
+ */
+typedef enum {
+    JITTER_FRAME_NONE = 0,      // 尚未开始播放或流已中断，无需输出
+    JITTER_FRAME_NORMAL,        // 正常包，按常规解码
+    JITTER_FRAME_FEC,           // 当前包丢失，用返回的下一包中的FEC数据恢复
+    JITTER_FRAME_PLC,           // 当前包丢失且无FEC可用，做丢包隐藏
+} jitter_frame_type_t;
+
+/**
+ * @brief 抖动缓冲统计
+ */
+typedef struct {
+    uint32_t received;          // 收到的包数
+    uint32_t late;              // 迟到（已过播放点）丢弃的包数
+    uint32_t duplicate;         // 重复包数
+    uint32_t reordered;         // 乱序到达但仍及时的包数
+    uint32_t played;            // 正常播放的帧数
+    uint32_t fec;               // 通过FEC恢复的帧数
+    uint32_t redundant;         // 原包丢失、由后续包携带的冗余块（RED）补上的包数
+    uint32_t plc;               // 通过PLC隐藏的帧数
+    uint32_t dropped;           // 缩减深度时丢弃的帧数
+    uint32_t inserted;          // 增加深度时插入的隐藏帧数
+    uint32_t resync;            // 流重同步次数
+    uint16_t target_ms;         // 当前目标深度
+    uint16_t depth_ms;          // 当前缓冲深度
+    uint16_t jitter_ms;         // 到达抖动（95分位）
+} jitter_buffer_stats_t;
+
+typedef struct jitter_buffer jitter_buffer_t;
+
+/**
+ * @brief 创建抖动缓冲，所有包槽一次性分配
+ *
+ * @param cfg 配置
+ * @return 句柄，失败返回NULL
+ */
+jitter_buffer_t *jitter_buffer_create(const jitter_buffer_cfg_t *cfg);
+
+/**
+ * @brief 按配置计算在 place 中所需的内存（按内存区对齐取整），用于预留内存区
+ *
+ * @return 字节数，配置非法返回0
+ */
+size_t jitter_buffer_mem_size(const jitter_buffer_cfg_t *cfg, audio_arena_place_t place);
+
+/**
+ * @brief 销毁抖动缓冲
+ */
+void jitter_buffer_destroy(jitter_buffer_t *jb);
+
+/**
+ * @brief 清空缓冲与统计，回到等待首包状态
+ */
+void jitter_buffer_reset(jitter_buffer_t *jb);
+
+/**
+ * @brief 放入一个包
+ *
+ * @param jb         句柄
+ * @param data       包数据（会拷贝进包槽）
+ * @param len        包长度
+ * @param seq        包序号
+ * @param arrival_ms 本地到达时间（毫秒）
+ * @return 成功返回0，迟到/重复/过长返回-1
+ */
+int jitter_buffer_put(jitter_buffer_t *jb, const uint8_t *data, uint16_t len, uint16_t seq, uint32_t arrival_ms);
+
+/**
+ * @brief 放入后续包携带的冗余副本（RED），只填补尚未播放的空位
+ *
+ * 原包已到或已过播放点时忽略；不参与到达延迟统计，也不推进最大序号。
+ * 须在放入携带它的主包之后调用。
+ *
+ * @return 补上空位返回0，否则返回-1
+ */
+int jitter_buffer_put_redundant(jitter_buffer_t *jb, const uint8_t *data, uint16_t len, uint16_t seq);
+
+/**
+ * @brief 按播放节奏取出下一帧（每个帧周期调用一次）
+ *
+ * NORMAL 返回的数据在下一次调用前有效；FEC 返回的是下一包数据，该包仍保留在缓冲中。
+ * 只有配置了 fec 时才返回 FEC，否则缺包一律为 PLC。
+ *
+ * @param jb   句柄
+ * @param data 输出参数，包数据（PLC/NONE时为NULL）
+ * @param len  输出参数，包长度
+ * @return 帧类型
+ */
+jitter_frame_type_t jitter_buffer_get(jitter_buffer_t *jb, const uint8_t **data, uint16_t *len);
+
+/**
+ * @brief 最近一次 jitter_buffer_get() 所对应的包序号（含FEC/PLC隐藏的帧）
+ *
+ * 供调用者将播放时刻与发送端时间戳对应，计算端到端延迟。
+ */
+uint16_t jitter_buffer_playout_seq(const jitter_buffer_t *jb);
+
+/**
+ * @brief 获取统计信息
+ */
+void jitter_buffer_get_stats(const jitter_buffer_t *jb, jitter_buffer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
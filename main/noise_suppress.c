@@ -0,0 +1,456 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 频谱增益降噪实现（加窗重叠相加 + 定点实FFT + 噪声跟踪 + 判决引导维纳增益 + 分档耗时预算）
+ * @FilePath: \audio_manager\main\noise_suppress.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "noise_suppress.h"
+#include "fixed_fft.h"
+
+#define NS_N            (NOISE_SUPPRESS_FFT / 2)    // 复数FFT点数（实FFT长度2N）
+#define NS_LOG2_N       7
+#define NS_HOP          NOISE_SUPPRESS_HOP
+#define NS_OVERLAP      NOISE_SUPPRESS_OVERLAP
+#define NS_BINS         NOISE_SUPPRESS_BINS
+#define NS_IN_SHIFT     12                          // 加窗样点送入FFT前左移位数，保留定点精度
+#define NS_OUT_SHIFT    (NS_IN_SHIFT - 8)           // irfft结果为 样点*2^IN_SHIFT/(2N)
+#define NS_INIT_HOPS    20                          // 开头按平均值初始化噪声估计的帧数（200ms）
+#define NS_DOWN_SHIFT   3                           // 功率低于噪声估计时的下降速度（每帧 1/8）
+#define NS_UP_SHIFT     5                           // 功率略高于噪声估计时的跟踪速度（每帧 1/32）
+#define NS_SPEECH_RATIO 4                           // 功率超过噪声估计此倍数视为有语音，估计只缓慢爬升
+#define NS_CREEP_SHIFT  8                           // 有语音时的爬升速度（每帧 1/256，约 1.7dB/s）
+#define NS_NOISE_MIN    (1ull << 12)                // 噪声估计下限（低于1LSB白噪声），避免数字静音时除零
+#define NS_DD_ALPHA     32113                       // 判决引导平滑系数（Q15，0.98）
+#define NS_GAMMA_MAX    (1u << 16)                  // 后验信噪比上限（Q8，24dB），之上增益已接近1
+#define NS_XI_MAX       (1u << 16)                  // 先验信噪比上限（Q8）
+#define NS_EIN_MIN      (NS_HOP * 4 * 4)            // 输入能量低于此值（约-78dBFS）不更新降噪量统计
+#define NS_HOLD_MAX     8                           // 连续沿用旧增益的帧数上限（80ms），再久的增益已不对应当前噪声与语音
+
+enum {
+    NS_MODE_FULL = 0,   // 噪声估计 + 增益计算 + 施加增益
+    NS_MODE_HOLD,       // 沿用上一帧增益（省去噪声估计与每频点两次除法）
+    NS_MODE_BYPASS,     // 不做FFT，时域乘两次窗后重叠相加（等同单位增益）
+};
+
+/**
+ * @brief 各档强度：增益下限与维纳增益的过减因子 G = ξ / (ξ + β)
+ */
+static const struct {
+    uint16_t floor_q15;
+    uint16_t beta_q8;
+} s_ns_levels[NOISE_SUPPRESS_LEVEL_MAX] = {
+    [NOISE_SUPPRESS_MILD]      = {16423, 256},  // -6dB
+    [NOISE_SUPPRESS_MEDIUM]    = {8231, 320},   // -12dB
+    [NOISE_SUPPRESS_HIGH]      = {4125, 384},   // -18dB
+    [NOISE_SUPPRESS_VERY_HIGH] = {2067, 512},   // -24dB
+};
+
+typedef fixed_fft_cpx_t ns_cpx_t;
+
+struct noise_suppress {
+    noise_suppress_cfg_t cfg;
+    volatile uint8_t level;                 // 当前强度（其他任务可改，下一帧生效）
+    uint32_t init_hops;                     // 已用于初始化噪声估计的帧数
+    uint32_t cost_us[NS_MODE_BYPASS];       // 完整处理与沿用增益两档的单帧耗时估计（快升慢降，未选用时每帧回落）
+    uint32_t hold_run;                      // 自上次完整处理以来的帧数
+    uint64_t full_scale;                    // 满幅正弦的单边功率谱总和（噪声dBFS的参考）
+    uint64_t ein_s;                         // 输入帧能量平滑值
+    uint64_t eout_s;                        // 输出帧能量平滑值
+    uint64_t noise[NS_BINS];                // 噪声功率谱估计
+    uint32_t prior_q8[NS_BINS];             // 上一帧的 G²·γ（Q8），判决引导的先验信噪比项
+    uint16_t gain[NS_BINS];                 // 当前增益（Q15）
+    int16_t frame[NOISE_SUPPRESS_FFT];      // 分析帧：[上一帧末尾 OVERLAP | 本帧 HOP]
+    uint32_t in_fill;                       // 本帧已收的样点数
+    int32_t ola[NS_OVERLAP];                // 重叠相加的尾部
+    int16_t *out;                           // 输出环形队列
+    uint32_t out_cap;
+    uint32_t out_head;
+    uint32_t out_count;
+    int16_t win[NOISE_SUPPRESS_FFT];        // 分析/合成窗（Q15）：sqrt-Hann 上升沿 + 平顶 + 下降沿，平方和为1
+    ns_cpx_t z[NS_N];                       // FFT工作区
+    int32_t t[NOISE_SUPPRESS_FFT];          // 时域工作区
+    ns_cpx_t spec[NS_BINS];                 // 频域工作区
+    noise_suppress_stats_t stats;
+};
+
+/* ------------------------------------------------------------------ */
+/* 辅助                                                                */
+/* ------------------------------------------------------------------ */
+
+static inline int bits64(uint64_t v)
+{
+    return v ? 64 - __builtin_clzll(v) : 0;
+}
+
+static inline int16_t sat16(int32_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+/**
+ * @brief 10*log10(num/den) 的Q8近似（以log2的分段线性近似计算）
+ */
+static int16_t db_ratio_q8(uint64_t num, uint64_t den)
+{
+    if (!num || !den) {
+        return 0;
+    }
+    // log2(v) Q8：整数部分取最高位，小数部分取其后8位线性近似
+    int bn = bits64(num) - 1;
+    int bd = bits64(den) - 1;
+    int32_t ln = (bn << 8) + (int32_t)(bn >= 8 ? (num >> (bn - 8)) & 0xff : (num << (8 - bn)) & 0xff);
+    int32_t ld = (bd << 8) + (int32_t)(bd >= 8 ? (den >> (bd - 8)) & 0xff : (den << (8 - bd)) & 0xff);
+    // 10*log10(2) ≈ 3.0103 ≈ 771/256
+    return (int16_t)(((ln - ld) * 771) >> 8);
+}
+
+/**
+ * @brief 后验信噪比 p/n（Q8，上限 NS_GAMMA_MAX）：两者同移到16位有效位，只做32位除法
+ */
+static inline uint32_t ns_ratio_q8(uint64_t p, uint64_t n)
+{
+    if (p >= (n << 8)) {
+        return NS_GAMMA_MAX;
+    }
+    int sh = bits64(n) - 16;
+    if (sh < 0) {
+        sh = 0;
+    }
+    uint32_t d = (uint32_t)(n >> sh);
+    uint32_t q = (uint32_t)(p >> sh);       // q < d*256 <= 2^24
+    return (q << 8) / d;
+}
+
+/* ------------------------------------------------------------------ */
+/* 逐帧处理                                                            */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 更新噪声估计并计算各频点增益
+ *
+ * 噪声：开头 NS_INIT_HOPS 帧取平均；之后功率低于估计时较快下降，略高时慢速跟踪，
+ * 明显高于估计（有语音）时只按固定速度爬升，噪声变大后数秒内跟上。
+ * 增益：判决引导 ξ = α·G²γ(上一帧) + (1-α)·max(γ-1, 0)，维纳增益 G = ξ/(ξ+β)，
+ * 不低于当前强度的下限，再做 [1 2 1]/4 频率平滑抑制孤立频点的"音乐噪声"。
+ */
+static void ns_update(noise_suppress_t *s, const ns_cpx_t *X)
+{
+    uint8_t level = s->level;
+    const uint32_t floor_q15 = s_ns_levels[level].floor_q15;
+    const uint32_t beta_q8 = s_ns_levels[level].beta_q8;
+    uint16_t g[NS_BINS];
+    uint64_t total = 0;
+
+    for (int k = 0; k < NS_BINS; k++) {
+        uint64_t p = (uint64_t)((int64_t)X[k].re * X[k].re) + (uint64_t)((int64_t)X[k].im * X[k].im);
+        uint64_t nk = s->noise[k];
+        if (s->init_hops < NS_INIT_HOPS) {
+            nk = (uint64_t)((int64_t)nk + ((int64_t)p - (int64_t)nk) / (int64_t)(s->init_hops + 1));
+        } else if (p < nk) {
+            nk -= (nk - p) >> NS_DOWN_SHIFT;
+        } else if (p < nk * NS_SPEECH_RATIO) {
+            nk += (p - nk) >> NS_UP_SHIFT;
+        } else {
+            nk += nk >> NS_CREEP_SHIFT;
+        }
+        if (nk < NS_NOISE_MIN) {
+            nk = NS_NOISE_MIN;
+        }
+        s->noise[k] = nk;
+        total += nk;
+
+        uint32_t gamma = ns_ratio_q8(p, nk);
+        uint32_t ml = gamma > 256 ? gamma - 256 : 0;
+        uint64_t xi = ((uint64_t)NS_DD_ALPHA * s->prior_q8[k] + (uint64_t)(32768 - NS_DD_ALPHA) * ml) >> 15;
+        if (xi > NS_XI_MAX) {
+            xi = NS_XI_MAX;
+        }
+        uint32_t gk = ((uint32_t)xi << 15) / ((uint32_t)xi + beta_q8);
+        if (gk < floor_q15) {
+            gk = floor_q15;
+        }
+        g[k] = (uint16_t)gk;
+        s->prior_q8[k] = (((gamma * gk) >> 15) * gk) >> 15;
+    }
+    if (s->init_hops < NS_INIT_HOPS) {
+        s->init_hops++;
+    }
+
+    s->gain[0] = (uint16_t)((3u * g[0] + g[1]) >> 2);
+    for (int k = 1; k < NS_BINS - 1; k++) {
+        s->gain[k] = (uint16_t)(((uint32_t)g[k - 1] + 2u * g[k] + g[k + 1]) >> 2);
+    }
+    s->gain[NS_BINS - 1] = (uint16_t)((3u * g[NS_BINS - 1] + g[NS_BINS - 2]) >> 2);
+    s->stats.noise_dbfs_q8 = db_ratio_q8(total, s->full_scale);
+}
+
+/*
+ * 定标约定（2N=256）：
+ *   X = rfft((x·w) << IN_SHIFT) = DFT(x·w) * 2^IN_SHIFT / 2N，|X| < 2^27，功率 < 2^55
+ *   irfft(G·X) = (x·w 经增益后) * 2^IN_SHIFT / 2N，再乘合成窗并右移 15 + OUT_SHIFT 得到样点
+ *   上升沿与下降沿的窗平方和为1，单位增益时重叠相加输出即输入延迟 OVERLAP 个样点
+ */
+static void ns_hop(noise_suppress_t *s, int mode, int16_t *out)
+{
+    int32_t *t = s->t;
+    if (mode == NS_MODE_BYPASS) {
+        for (int i = 0; i < NOISE_SUPPRESS_FFT; i++) {
+            t[i] = (((int32_t)s->frame[i] * s->win[i]) >> 15) * s->win[i] >> 15;
+        }
+    } else {
+        for (int i = 0; i < NOISE_SUPPRESS_FFT; i++) {
+            t[i] = (((int32_t)s->frame[i] * s->win[i]) >> 15) * (1 << NS_IN_SHIFT);  // 负数左移为未定义行为，用乘法
+        }
+        fixed_fft_rfft(t, s->spec, s->z, NS_LOG2_N);
+        if (mode == NS_MODE_FULL) {
+            ns_update(s, s->spec);
+        }
+        for (int k = 0; k < NS_BINS; k++) {
+            s->spec[k].re = (int32_t)(((int64_t)s->spec[k].re * s->gain[k]) >> 15);
+            s->spec[k].im = (int32_t)(((int64_t)s->spec[k].im * s->gain[k]) >> 15);
+        }
+        fixed_fft_irfft(s->spec, t, s->z, NS_LOG2_N);
+        for (int i = 0; i < NOISE_SUPPRESS_FFT; i++) {
+            t[i] = (int32_t)(((int64_t)t[i] * s->win[i] + (1 << (14 + NS_OUT_SHIFT))) >> (15 + NS_OUT_SHIFT));
+        }
+    }
+
+    uint64_t ein = 0, eout = 0;
+    for (int i = 0; i < NS_HOP; i++) {
+        int32_t y = i < NS_OVERLAP ? s->ola[i] + t[i] : t[i];
+        out[i] = sat16(y);
+        ein += (int32_t)s->frame[NS_OVERLAP + i] * s->frame[NS_OVERLAP + i];
+        eout += (int32_t)out[i] * out[i];
+    }
+    memcpy(s->ola, t + NS_HOP, sizeof(s->ola));
+    memmove(s->frame, s->frame + NS_HOP, NS_OVERLAP * sizeof(int16_t));
+
+    s->ein_s += ((int64_t)ein - (int64_t)s->ein_s) / 16;
+    s->eout_s += ((int64_t)eout - (int64_t)s->eout_s) / 16;
+    if (s->ein_s > NS_EIN_MIN) {
+        s->stats.reduction_q8 = db_ratio_q8(s->ein_s, s->eout_s + 1);
+    }
+    s->stats.hops++;
+}
+
+/**
+ * @brief 按本次调用已用时间与各档耗时估计选择处理方式（未配置预算时总是完整处理）
+ */
+static int ns_pick_mode(noise_suppress_t *s, uint32_t start)
+{
+    if (!s->cfg.clock_us || !s->cfg.budget_us) {
+        return NS_MODE_FULL;
+    }
+    uint32_t used = s->cfg.clock_us() - start;
+    uint32_t left = used < s->cfg.budget_us ? s->cfg.budget_us - used : 0;
+    if (s->cost_us[NS_MODE_FULL] <= left) {
+        return NS_MODE_FULL;
+    }
+    if (s->cost_us[NS_MODE_HOLD] <= left && s->hold_run < NS_HOLD_MAX) {
+        return NS_MODE_HOLD;
+    }
+    return NS_MODE_BYPASS;
+}
+
+/**
+ * @brief 记录一帧的耗时：选用的档位按实测值快升慢降，未选用的档位估计每帧回落 1/64，
+ *        偶发的抢占尖峰过后会重新尝试，不会一直降级
+ */
+static void ns_account(noise_suppress_t *s, int mode, uint32_t cost)
+{
+    for (int m = NS_MODE_FULL; m < NS_MODE_BYPASS; m++) {
+        uint32_t est = s->cost_us[m];
+        if (m != mode) {
+            s->cost_us[m] = est - (est >> 6);
+        } else if (cost > est) {
+            s->cost_us[m] = est + ((cost - est + 1) >> 1);
+        } else {
+            s->cost_us[m] = est - ((est - cost) >> 4);
+        }
+    }
+    if (mode == NS_MODE_FULL) {
+        s->hold_run = 0;
+    } else {
+        s->hold_run++;
+        if (mode == NS_MODE_HOLD) {
+            s->stats.hold_hops++;
+        } else {
+            s->stats.bypass_hops++;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* 对外接口                                                            */
+/* ------------------------------------------------------------------ */
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b)
+{
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static bool ns_cfg_valid(const noise_suppress_cfg_t *cfg)
+{
+    return cfg && cfg->frame_samples > 0 && (unsigned)cfg->level < NOISE_SUPPRESS_LEVEL_MAX;
+}
+
+uint32_t noise_suppress_mem_size(const noise_suppress_cfg_t *cfg)
+{
+    if (!ns_cfg_valid(cfg)) {
+        return 0;
+    }
+    uint32_t out_cap = cfg->frame_samples + 2 * NS_HOP;
+    return AUDIO_ARENA_SIZE(sizeof(noise_suppress_t)) + AUDIO_ARENA_SIZE(out_cap * sizeof(int16_t));
+}
+
+noise_suppress_t *noise_suppress_create(const noise_suppress_cfg_t *cfg)
+{
+    if (!ns_cfg_valid(cfg)) {
+        return NULL;
+    }
+    // 每帧全量遍历噪声估计与FFT工作区，全部放片内
+    noise_suppress_t *s = audio_arena_calloc(cfg->arena, 1, sizeof(noise_suppress_t), AUDIO_ARENA_INTERNAL);
+    if (!s) {
+        return NULL;
+    }
+    s->cfg = *cfg;
+    s->level = (uint8_t)cfg->level;
+    s->out_cap = cfg->frame_samples + 2 * NS_HOP;
+    s->out = audio_arena_calloc(cfg->arena, s->out_cap, sizeof(int16_t), AUDIO_ARENA_INTERNAL);
+    if (!s->out) {
+        noise_suppress_destroy(s);
+        return NULL;
+    }
+    uint64_t wsum = 0;
+    for (int i = 0; i < NOISE_SUPPRESS_FFT; i++) {
+        double w = 1.0;
+        if (i < NS_OVERLAP) {
+            w = sin(M_PI * (i + 0.5) / (2 * NS_OVERLAP));
+        } else if (i >= NS_HOP) {
+            w = sin(M_PI * (NOISE_SUPPRESS_FFT - i - 0.5) / (2 * NS_OVERLAP));
+        }
+        s->win[i] = (int16_t)lrint(w * 32767.0);
+        wsum += (uint64_t)((int32_t)s->win[i] * s->win[i]);
+    }
+    // 满幅正弦（均方 2^29）加窗后能量为 wsum/2，按 ns_hop() 的定标约定，其单边功率谱总和约为该能量的 2^15 倍
+    s->full_scale = wsum << 14;
+    // 帧长不是帧移整数倍时，输出队列预置 HOP-gcd(帧长,HOP) 个静音样点，保证每次调用都有足够输出
+    s->stats.delay_samples = (uint16_t)(NS_OVERLAP +
+                                        ((cfg->frame_samples % NS_HOP) ? NS_HOP - gcd_u32(cfg->frame_samples, NS_HOP) : 0));
+    s->stats.mem_bytes = noise_suppress_mem_size(cfg);
+    noise_suppress_reset(s);
+    return s;
+}
+
+void noise_suppress_destroy(noise_suppress_t *ns)
+{
+    if (!ns) {
+        return;
+    }
+    audio_arena_t *arena = ns->cfg.arena;
+    audio_arena_free(arena, ns->out);
+    audio_arena_free(arena, ns);
+}
+
+void noise_suppress_reset(noise_suppress_t *ns)
+{
+    memset(ns->noise, 0, sizeof(ns->noise));
+    memset(ns->prior_q8, 0, sizeof(ns->prior_q8));
+    for (int k = 0; k < NS_BINS; k++) {
+        ns->gain[k] = 32767;
+    }
+    memset(ns->frame, 0, sizeof(ns->frame));
+    memset(ns->ola, 0, sizeof(ns->ola));
+    memset(ns->cost_us, 0, sizeof(ns->cost_us));
+    ns->hold_run = 0;
+    ns->init_hops = 0;
+    ns->ein_s = 0;
+    ns->eout_s = 0;
+    ns->in_fill = 0;
+    ns->out_head = 0;
+    ns->out_count = ns->stats.delay_samples - NS_OVERLAP;
+    memset(ns->out, 0, ns->out_cap * sizeof(int16_t));
+    uint16_t delay = ns->stats.delay_samples;
+    uint32_t mem = ns->stats.mem_bytes;
+    memset(&ns->stats, 0, sizeof(ns->stats));
+    ns->stats.delay_samples = delay;
+    ns->stats.mem_bytes = mem;
+}
+
+int noise_suppress_set_level(noise_suppress_t *ns, noise_suppress_level_t level)
+{
+    if (!ns || (unsigned)level >= NOISE_SUPPRESS_LEVEL_MAX) {
+        return -1;
+    }
+    ns->level = (uint8_t)level;
+    return 0;
+}
+
+int noise_suppress_process(noise_suppress_t *ns, const int16_t *in, int16_t *out, size_t n)
+{
+    if (n != ns->cfg.frame_samples) {
+        ns->stats.frame_errors++;
+        return -1;
+    }
+    uint32_t (*clock)(void) = ns->cfg.clock_us;
+    uint32_t start = clock ? clock() : 0;
+    // 先把整帧输入收入分析帧再写输出，允许 out 与 in 为同一缓冲区
+    size_t i = 0;
+    int16_t blk[NS_HOP];
+    while (i < n) {
+        size_t m = NS_HOP - ns->in_fill;
+        if (m > n - i) {
+            m = n - i;
+        }
+        memcpy(ns->frame + NS_OVERLAP + ns->in_fill, in + i, m * sizeof(int16_t));
+        ns->in_fill += m;
+        i += m;
+        if (ns->in_fill < NS_HOP) {
+            continue;
+        }
+        int mode = ns_pick_mode(ns, start);
+        uint32_t t0 = clock ? clock() : 0;
+        ns_hop(ns, mode, blk);
+        ns_account(ns, mode, clock ? clock() - t0 : 0);
+        ns->in_fill = 0;
+        uint32_t tail = (ns->out_head + ns->out_count) % ns->out_cap;
+        for (int k = 0; k < NS_HOP; k++) {
+            ns->out[tail] = blk[k];
+            tail = tail + 1 == ns->out_cap ? 0 : tail + 1;
+        }
+        ns->out_count += NS_HOP;
+    }
+    for (size_t k = 0; k < n; k++) {
+        out[k] = ns->out[ns->out_head];
+        ns->out_head = ns->out_head + 1 == ns->out_cap ? 0 : ns->out_head + 1;
+    }
+    ns->out_count -= n;
+    if (clock) {
+        uint32_t used = clock() - start;
+        ns->stats.last_us = used;
+        if (used > ns->stats.peak_us) {
+            ns->stats.peak_us = used;
+        }
+        if (ns->cfg.budget_us && used > ns->cfg.budget_us) {
+            ns->stats.over_budget++;
+        }
+    }
+    return 0;
+}
+
+void noise_suppress_get_stats(const noise_suppress_t *ns, noise_suppress_stats_t *stats)
+{
+    *stats = ns->stats;
+}
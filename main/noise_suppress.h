@@ -0,0 +1,129 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: 降噪：16kHz、10ms帧移的频谱增益降噪（最小值跟踪噪声估计 + 判决引导维纳增益），
+ *               定点FFT，纯C实现，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\noise_suppress.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NOISE_SUPPRESS_SAMPLE_RATE  16000                       // 仅支持16kHz（采集前端的发布采样率）
+#define NOISE_SUPPRESS_HOP          160                         // 帧移（10ms）
+#define NOISE_SUPPRESS_FFT          256                         // 分析帧长（实FFT长度）
+#define NOISE_SUPPRESS_BINS         (NOISE_SUPPRESS_FFT / 2 + 1)
+#define NOISE_SUPPRESS_OVERLAP      (NOISE_SUPPRESS_FFT - NOISE_SUPPRESS_HOP)   // 相邻帧重叠（6ms），即算法延迟
+
+/**
+ * @brief 降噪强度：越强残余噪声越低，语音失真与"音乐噪声"风险越大
+ */
+typedef enum {
+    NOISE_SUPPRESS_MILD = 0,    // 增益下限 -6dB
+    NOISE_SUPPRESS_MEDIUM,      // 增益下限 -12dB
+    NOISE_SUPPRESS_HIGH,        // 增益下限 -18dB
+    NOISE_SUPPRESS_VERY_HIGH,   // 增益下限 -24dB，并加大过减因子
+    NOISE_SUPPRESS_LEVEL_MAX,
+} noise_suppress_level_t;
+
+/**
+ * @brief 降噪配置
+ */
+typedef struct {
+    uint32_t frame_samples;         // 每次调用处理的样点数（固定），决定内部对齐延迟
+    noise_suppress_level_t level;   // 初始强度（运行中可用 noise_suppress_set_level() 调整）
+    uint32_t budget_us;             // 每次调用的耗时预算（微秒），0 不限；每10ms帧一次正反FFT，目标板周期数见 dsp_bench 的 rfft256 项
+    uint32_t (*clock_us)(void);     // 微秒时钟，NULL 时不做预算控制
+    audio_arena_t *arena;           // 内存区，NULL 时从堆分配
+} noise_suppress_cfg_t;
+
+#define DEFAULT_NOISE_SUPPRESS_CONFIG() {   \
+    .frame_samples = 320,                   \
+    .level         = NOISE_SUPPRESS_MEDIUM, \
+    .budget_us     = 0,                     \
+    .clock_us      = NULL,                  \
+    .arena         = NULL,                  \
+}
+
+/**
+ * @brief 降噪统计
+ */
+typedef struct {
+    uint32_t hops;              // 已处理的10ms帧数
+    uint32_t hold_hops;         // 预算不足、沿用上一帧增益（跳过噪声估计与增益计算）的帧数
+    uint32_t bypass_hops;       // 预算不足、直通（不做FFT）的帧数
+    uint32_t over_budget;       // 调用实际耗时仍超出预算的次数（被抢占或估计偏低）
+    uint32_t frame_errors;      // 样点数与 frame_samples 不符、未处理即返回的调用次数（配置错误）
+    uint32_t last_us;           // 最近一次调用耗时（未配置时钟为0）
+    uint32_t peak_us;           // 单次调用最长耗时
+    int16_t noise_dbfs_q8;      // 噪声估计的总能量（dBFS，Q8）
+    int16_t reduction_q8;       // 输入/输出能量比的平滑值（dB，Q8），即实际压低的量
+    uint16_t delay_samples;     // 输出相对输入的固定延迟（样点），含重叠相加的 NOISE_SUPPRESS_OVERLAP
+    uint32_t mem_bytes;         // 占用内存（同 noise_suppress_mem_size()）
+} noise_suppress_stats_t;
+
+typedef struct noise_suppress noise_suppress_t;
+
+/**
+ * @brief 创建降噪器，所有缓冲区一次性分配
+ *
+ * @param cfg 配置
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+noise_suppress_t *noise_suppress_create(const noise_suppress_cfg_t *cfg);
+
+/**
+ * @brief 按配置计算所需内存（按内存区对齐取整），用于预留内存区
+ *
+ * @return 字节数，配置非法返回0
+ */
+uint32_t noise_suppress_mem_size(const noise_suppress_cfg_t *cfg);
+
+/**
+ * @brief 销毁降噪器
+ */
+void noise_suppress_destroy(noise_suppress_t *ns);
+
+/**
+ * @brief 清空噪声估计与历史，重新学习噪声
+ */
+void noise_suppress_reset(noise_suppress_t *ns);
+
+/**
+ * @brief 调整降噪强度，下一个10ms帧生效（可在其他任务中调用）
+ *
+ * @return 0，强度非法返回-1
+ */
+int noise_suppress_set_level(noise_suppress_t *ns, noise_suppress_level_t level);
+
+/**
+ * @brief 处理一帧
+ *
+ * 配置了预算时，每个10ms帧开始前按已用时间与各档实测耗时选择处理方式：
+ * 完整处理 -> 沿用上一帧增益 -> 直通，保证单次调用不超出预算；直通与完整处理的输出延迟相同，切换无断点。
+ *
+ * @param ns  句柄
+ * @param in  输入样点
+ * @param out 输出样点（可与 in 相同），相对输入固定延迟 delay_samples 个样点
+ * @param n   样点数，须等于 cfg.frame_samples
+ * @return 0，帧长不符返回-1（out 未写入，计入 frame_errors）
+ */
+int noise_suppress_process(noise_suppress_t *ns, const int16_t *in, int16_t *out, size_t n);
+
+/**
+ * @brief 获取统计
+ */
+void noise_suppress_get_stats(const noise_suppress_t *ns, noise_suppress_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,877 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 11:00:00
+ * @LastEditTime: 2026-10-17 11:00:00
+ * @LastEditors: 星年
+ * @Description: Ogg-Opus 封装与解封装实现，纯C，可在Linux主机上以普通文件测试
+ * @FilePath: \audio_manager\main\ogg_opus.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include "ogg_opus.h"
+
+#define OGG_HEADER_SIZE     27          // 页头固定部分
+#define OGG_MAX_SEGMENTS    255         // 单页最大段数
+#define OGG_FLAG_CONTINUED  0x01
+#define OGG_FLAG_BOS        0x02
+#define OGG_FLAG_EOS        0x04
+#define OGG_GRANULE_NONE    (-1)        // 页内没有结束的包
+#define OGG_OPUS_VENDOR     "audio_manager"
+#define OGG_INDEX_MAGIC     "OPIX"
+#define OGG_INDEX_VERSION   1
+#define OGG_INDEX_HEADER    16          // 魔数 + 版本 + 保留 + 条目数 + 间隔
+
+/* Ogg 页校验：CRC-32，多项式 0x04c11db7，初值0，不反转 */
+static const uint32_t s_ogg_crc[256] = {
+    0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b,
+    0x1a864db2, 0x1e475005, 0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
+    0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd, 0x4c11db70, 0x48d0c6c7,
+    0x4593e01e, 0x4152fda9, 0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
+    0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011, 0x791d4014, 0x7ddc5da3,
+    0x709f7b7a, 0x745e66cd, 0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
+    0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5, 0xbe2b5b58, 0xbaea46ef,
+    0xb7a96036, 0xb3687d81, 0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
+    0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49, 0xc7361b4c, 0xc3f706fb,
+    0xceb42022, 0xca753d95, 0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
+    0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d, 0x34867077, 0x30476dc0,
+    0x3d044b19, 0x39c556ae, 0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
+    0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16, 0x018aeb13, 0x054bf6a4,
+    0x0808d07d, 0x0cc9cdca, 0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
+    0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02, 0x5e9f46bf, 0x5a5e5b08,
+    0x571d7dd1, 0x53dc6066, 0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
+    0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e, 0xbfa1b04b, 0xbb60adfc,
+    0xb6238b25, 0xb2e29692, 0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
+    0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a, 0xe0b41de7, 0xe4750050,
+    0xe9362689, 0xedf73b3e, 0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
+    0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686, 0xd5b88683, 0xd1799b34,
+    0xdc3abded, 0xd8fba05a, 0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
+    0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb, 0x4f040d56, 0x4bc510e1,
+    0x46863638, 0x42472b8f, 0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
+    0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47, 0x36194d42, 0x32d850f5,
+    0x3f9b762c, 0x3b5a6b9b, 0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
+    0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623, 0xf12f560e, 0xf5ee4bb9,
+    0xf8ad6d60, 0xfc6c70d7, 0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
+    0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f, 0xc423cd6a, 0xc0e2d0dd,
+    0xcda1f604, 0xc960ebb3, 0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
+    0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b, 0x9b3660c6, 0x9ff77d71,
+    0x92b45ba8, 0x9675461f, 0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
+    0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640, 0x4e8ee645, 0x4a4ffbf2,
+    0x470cdd2b, 0x43cdc09c, 0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
+    0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24, 0x119b4be9, 0x155a565e,
+    0x18197087, 0x1cd86d30, 0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
+    0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088, 0x2497d08d, 0x2056cd3a,
+    0x2d15ebe3, 0x29d4f654, 0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
+    0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c, 0xe3a1cbc1, 0xe760d676,
+    0xea23f0af, 0xeee2ed18, 0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
+    0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0, 0x9abc8bd5, 0x9e7d9662,
+    0x933eb0bb, 0x97ffad0c, 0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
+    0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4,
+};
+
+static uint32_t ogg_crc(uint32_t crc, const uint8_t *p, size_t n)
+{
+    while (n--) {
+        crc = (crc << 8) ^ s_ogg_crc[((crc >> 24) ^ *p++) & 0xff];
+    }
+    return crc;
+}
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    put_le16(p, (uint16_t)v);
+    put_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void put_le64(uint8_t *p, uint64_t v)
+{
+    put_le32(p, (uint32_t)v);
+    put_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return get_le16(p) | ((uint32_t)get_le16(p + 2) << 16);
+}
+
+static uint64_t get_le64(const uint8_t *p)
+{
+    return get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+uint32_t ogg_opus_packet_samples(const uint8_t *data, size_t len)
+{
+    static const uint16_t silk[4] = {480, 960, 1920, 2880};
+    if (!data || len < 1) {
+        return 0;
+    }
+    uint8_t config = data[0] >> 3;
+    uint32_t frame;
+    if (config < 12) {
+        frame = silk[config & 3];           // SILK：10/20/40/60 ms
+    } else if (config < 16) {
+        frame = (config & 1) ? 960 : 480;   // Hybrid：10/20 ms
+    } else {
+        frame = 120u << (config & 3);       // CELT：2.5/5/10/20 ms
+    }
+    uint32_t frames;
+    switch (data[0] & 3) {
+    case 0:
+        frames = 1;
+        break;
+    case 3:
+        frames = len < 2 ? 0 : (data[1] & 0x3f);
+        break;
+    default:
+        frames = 2;
+        break;
+    }
+    uint32_t samples = frame * frames;
+    return samples <= OGG_OPUS_RATE * 120 / 1000 ? samples : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 索引                                                                */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 追加一个页起点；条目写满时隔一删一并将间隔加倍，内存固定、覆盖整个文件
+ */
+static void index_add(ogg_opus_index_t *idx, uint32_t time_ms, uint32_t offset)
+{
+    if (!idx->cap) {
+        return;
+    }
+    if (idx->count && time_ms < idx->entries[idx->count - 1].time_ms + idx->interval_ms) {
+        return;
+    }
+    if (idx->count == idx->cap) {
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < idx->count; i += 2) {
+            idx->entries[n++] = idx->entries[i];
+        }
+        idx->count = n;
+        idx->interval_ms *= 2;
+        if (time_ms < idx->entries[idx->count - 1].time_ms + idx->interval_ms) {
+            return;
+        }
+    }
+    idx->entries[idx->count].time_ms = time_ms;
+    idx->entries[idx->count].offset = offset;
+    idx->count++;
+}
+
+size_t ogg_opus_index_size(const ogg_opus_index_t *index)
+{
+    return OGG_INDEX_HEADER + (size_t)(index ? index->count : 0) * 8 + 4;
+}
+
+int ogg_opus_index_save(const ogg_opus_index_t *index, ogg_opus_write_t write, void *ctx)
+{
+    if (!index || !write) {
+        return -1;
+    }
+    uint8_t buf[OGG_INDEX_HEADER];
+    memcpy(buf, OGG_INDEX_MAGIC, 4);
+    put_le16(buf + 4, OGG_INDEX_VERSION);
+    put_le16(buf + 6, 0);
+    put_le32(buf + 8, index->count);
+    put_le32(buf + 12, index->interval_ms);
+    uint32_t crc = ogg_crc(0, buf, sizeof(buf));
+    if (write(ctx, buf, sizeof(buf)) != (int)sizeof(buf)) {
+        return -1;
+    }
+    // 条目分批序列化，栈上只用一个小缓冲
+    uint8_t chunk[8 * 32];
+    for (uint32_t i = 0; i < index->count;) {
+        uint32_t n = 0;
+        for (; n < 32 && i < index->count; n++, i++) {
+            put_le32(chunk + n * 8, index->entries[i].time_ms);
+            put_le32(chunk + n * 8 + 4, index->entries[i].offset);
+        }
+        crc = ogg_crc(crc, chunk, n * 8);
+        if (write(ctx, chunk, n * 8) != (int)(n * 8)) {
+            return -1;
+        }
+    }
+    put_le32(buf, crc);
+    return write(ctx, buf, 4) == 4 ? 0 : -1;
+}
+
+int ogg_opus_index_load(ogg_opus_index_t *index, ogg_opus_read_t read, void *ctx)
+{
+    if (!index || !index->entries || !index->cap || !read) {
+        return -1;
+    }
+    uint8_t buf[OGG_INDEX_HEADER];
+    if (read(ctx, buf, sizeof(buf)) != (int)sizeof(buf) || memcmp(buf, OGG_INDEX_MAGIC, 4) != 0 ||
+        get_le16(buf + 4) != OGG_INDEX_VERSION) {
+        return -1;
+    }
+    uint32_t crc = ogg_crc(0, buf, sizeof(buf));
+    uint32_t count = get_le32(buf + 8);
+    uint32_t step = (count + index->cap - 1) / index->cap;
+    index->count = 0;
+    index->interval_ms = get_le32(buf + 12) * (step ? step : 1);
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t e[8];
+        if (read(ctx, e, sizeof(e)) != (int)sizeof(e)) {
+            return -1;
+        }
+        crc = ogg_crc(crc, e, sizeof(e));
+        if (i % step == 0) {
+            index->entries[index->count].time_ms = get_le32(e);
+            index->entries[index->count].offset = get_le32(e + 4);
+            index->count++;
+        }
+    }
+    if (read(ctx, buf, 4) != 4 || get_le32(buf) != crc) {
+        index->count = 0;
+        return -1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 封装                                                                */
+/* ------------------------------------------------------------------ */
+
+struct ogg_opus_writer {
+    ogg_opus_writer_cfg_t cfg;      // 配置
+    uint8_t *block;                 // 块缓冲，内容从文件偏移 file_off 开始
+    uint32_t block_fill;            // 块缓冲已有字节
+    uint32_t file_off;              // 已交给写回调的字节数
+    uint8_t *page;                  // 当前页的数据区
+    uint32_t page_fill;             // 当前页数据字节
+    uint32_t page_data_cap;         // 单页数据区上限
+    uint8_t seg[OGG_MAX_SEGMENTS];  // 当前页的段表
+    uint16_t seg_count;             // 当前页段数
+    uint16_t page_packets;          // 当前页的包数
+    uint32_t page_seq;              // 下一页序号
+    uint64_t page_granule;          // 当前页起点的颗粒位置
+    uint16_t next_seq;              // 期望的下一个包序号
+    bool have_seq;                  // 已写入过音频包
+    bool closed;                    // 已写出结束页
+    ogg_opus_index_t index;         // 时间 -> 偏移索引
+    ogg_opus_writer_stats_t stats;  // 统计
+};
+
+/**
+ * @brief 将块缓冲交给写回调
+ */
+static int writer_output(ogg_opus_writer_t *w)
+{
+    if (!w->block_fill) {
+        return 0;
+    }
+    w->stats.write_calls++;
+    int n = w->cfg.write(w->cfg.ctx, w->block, w->block_fill);
+    if (n != (int)w->block_fill) {
+        // 存储出错时丢弃这一块，避免缓冲无限增长；文件在此处断裂，读取端按校验跳过
+        w->stats.write_errors++;
+        w->file_off += w->block_fill;
+        w->block_fill = 0;
+        return -2;
+    }
+    w->file_off += w->block_fill;
+    w->stats.file_bytes += w->block_fill;
+    w->block_fill = 0;
+    return 0;
+}
+
+/**
+ * @brief 追加到块缓冲，到达块边界即写出一整块
+ */
+static int writer_emit(ogg_opus_writer_t *w, const uint8_t *data, size_t len)
+{
+    int ret = 0;
+    while (len) {
+        uint32_t boundary = w->cfg.block_size - (w->file_off % w->cfg.block_size);
+        uint32_t n = boundary - w->block_fill;
+        if (n > len) {
+            n = (uint32_t)len;
+        }
+        memcpy(w->block + w->block_fill, data, n);
+        w->block_fill += n;
+        data += n;
+        len -= n;
+        if (w->block_fill == boundary && writer_output(w) != 0) {
+            ret = -2;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief 结束当前页：填页头与校验，登记索引，写入块缓冲
+ */
+static int writer_page_out(ogg_opus_writer_t *w, bool eos)
+{
+    if (!w->seg_count && !eos) {
+        return 0;
+    }
+    uint8_t hdr[OGG_HEADER_SIZE];
+    memcpy(hdr, "OggS", 4);
+    hdr[4] = 0;
+    hdr[5] = (w->page_seq == 0 ? OGG_FLAG_BOS : 0) | (eos ? OGG_FLAG_EOS : 0);
+    put_le64(hdr + 6, w->stats.granule);
+    put_le32(hdr + 14, w->cfg.serial);
+    put_le32(hdr + 18, w->page_seq++);
+    put_le32(hdr + 22, 0);
+    hdr[26] = (uint8_t)w->seg_count;
+    uint32_t crc = ogg_crc(0, hdr, sizeof(hdr));
+    crc = ogg_crc(crc, w->seg, w->seg_count);
+    crc = ogg_crc(crc, w->page, w->page_fill);
+    put_le32(hdr + 22, crc);
+
+    // 只登记含音频包的页（头两页的颗粒位置为0，不参与定位）
+    if (w->have_seq && w->page_packets) {
+        uint64_t start = w->page_granule > w->cfg.pre_skip ? w->page_granule - w->cfg.pre_skip : 0;
+        index_add(&w->index, (uint32_t)(start * 1000 / OGG_OPUS_RATE), w->file_off + w->block_fill);
+    }
+    int ret = writer_emit(w, hdr, sizeof(hdr));
+    ret |= writer_emit(w, w->seg, w->seg_count);
+    ret |= writer_emit(w, w->page, w->page_fill);
+    w->stats.pages++;
+    w->seg_count = 0;
+    w->page_fill = 0;
+    w->page_packets = 0;
+    w->page_granule = w->stats.granule;
+    return ret ? -2 : 0;
+}
+
+/**
+ * @brief 向当前页追加一个完整的包（页放不下或已到单页时长时先结束当前页；包不跨页）
+ */
+static int writer_add(ogg_opus_writer_t *w, const uint8_t *data, uint16_t len, uint32_t samples)
+{
+    uint32_t lacing = len / 255 + 1;
+    int ret = 0;
+    if (w->seg_count + lacing > OGG_MAX_SEGMENTS || w->page_fill + len > w->page_data_cap ||
+        (w->page_packets && w->stats.granule + samples - w->page_granule > (uint64_t)w->cfg.page_ms * OGG_OPUS_RATE / 1000)) {
+        ret = writer_page_out(w, false);
+    }
+    for (uint32_t i = 0; i + 1 < lacing; i++) {
+        w->seg[w->seg_count++] = 255;
+    }
+    w->seg[w->seg_count++] = (uint8_t)(len % 255);
+    memcpy(w->page + w->page_fill, data, len);
+    w->page_fill += len;
+    w->page_packets++;
+    w->stats.granule += samples;
+    return ret;
+}
+
+ogg_opus_writer_t *ogg_opus_writer_create(const ogg_opus_writer_cfg_t *cfg)
+{
+    if (!cfg || !cfg->write || !cfg->channels || cfg->channels > 2 || !cfg->block_size ||
+        cfg->page_cap < OGG_HEADER_SIZE + OGG_MAX_SEGMENTS + OGG_OPUS_PACKET_CAP) {
+        return NULL;
+    }
+    audio_arena_t *arena = cfg->arena;
+    ogg_opus_writer_t *w = audio_arena_calloc(arena, 1, sizeof(ogg_opus_writer_t), AUDIO_ARENA_INTERNAL);
+    if (!w) {
+        return NULL;
+    }
+    w->cfg = *cfg;
+    w->page_data_cap = cfg->page_cap - OGG_HEADER_SIZE - OGG_MAX_SEGMENTS;
+    // 块与页缓冲只在写包时顺序访问，放PSRAM
+    w->block = audio_arena_calloc(arena, cfg->block_size, 1, AUDIO_ARENA_PSRAM);
+    w->page = audio_arena_calloc(arena, w->page_data_cap, 1, AUDIO_ARENA_PSRAM);
+    if (cfg->index_cap) {
+        w->index.entries = audio_arena_calloc(arena, cfg->index_cap, sizeof(ogg_opus_index_entry_t), AUDIO_ARENA_PSRAM);
+        w->index.cap = cfg->index_cap;
+        w->index.interval_ms = cfg->index_ms;
+    }
+    if (!w->block || !w->page || (cfg->index_cap && !w->index.entries)) {
+        ogg_opus_writer_destroy(w);
+        return NULL;
+    }
+
+    // OpusHead、OpusTags 各占一页（RFC 7845 第3节）
+    uint8_t head[19];
+    memcpy(head, "OpusHead", 8);
+    head[8] = 1;
+    head[9] = cfg->channels;
+    put_le16(head + 10, cfg->pre_skip);
+    put_le32(head + 12, cfg->sample_rate);
+    put_le16(head + 16, 0);
+    head[18] = 0;
+    writer_add(w, head, sizeof(head), 0);
+    writer_page_out(w, false);
+
+    uint8_t tags[8 + 4 + sizeof(OGG_OPUS_VENDOR) - 1 + 4];
+    memcpy(tags, "OpusTags", 8);
+    put_le32(tags + 8, sizeof(OGG_OPUS_VENDOR) - 1);
+    memcpy(tags + 12, OGG_OPUS_VENDOR, sizeof(OGG_OPUS_VENDOR) - 1);
+    put_le32(tags + 12 + sizeof(OGG_OPUS_VENDOR) - 1, 0);
+    writer_add(w, tags, sizeof(tags), 0);
+    writer_page_out(w, false);
+    return w;
+}
+
+int ogg_opus_writer_put(ogg_opus_writer_t *w, const opus_packet_t *pkt)
+{
+    if (!w || !pkt || w->closed) {
+        return -1;
+    }
+    uint32_t samples = ogg_opus_packet_samples(pkt->data, pkt->len);
+    if (!samples || pkt->len > w->page_data_cap) {
+        w->stats.dropped++;
+        return -1;
+    }
+    int ret = 0;
+    uint16_t gap = (uint16_t)(pkt->seq - w->next_seq);
+    if (w->have_seq && gap && gap < 0x8000) {
+        // 缺失的帧补写只有TOC的空帧包：单帧用code 0（1字节），多帧用code 3 + 帧数（2字节）
+        uint32_t frame = ogg_opus_packet_samples((const uint8_t[]){pkt->data[0] & 0xfc}, 1);
+        uint32_t frames = samples / frame;
+        uint8_t empty[2] = {(uint8_t)(frames > 1 ? (pkt->data[0] | 3) : (pkt->data[0] & 0xfc)), (uint8_t)frames};
+        for (uint16_t i = 0; i < gap; i++) {
+            ret |= writer_add(w, empty, frames > 1 ? 2 : 1, frame * frames);
+            w->stats.gap_packets++;
+        }
+    }
+    w->have_seq = true;
+    w->next_seq = pkt->seq + 1;
+    ret |= writer_add(w, pkt->data, pkt->len, samples);
+    w->stats.packets++;
+    w->stats.payload_bytes += pkt->len;
+    return ret ? -2 : 0;
+}
+
+int ogg_opus_writer_flush(ogg_opus_writer_t *w)
+{
+    if (!w) {
+        return -1;
+    }
+    int ret = writer_page_out(w, false);
+    return (writer_output(w) | ret) ? -2 : 0;
+}
+
+int ogg_opus_writer_close(ogg_opus_writer_t *w)
+{
+    if (!w || w->closed) {
+        return -1;
+    }
+    w->closed = true;
+    int ret = writer_page_out(w, true);
+    return (writer_output(w) | ret) ? -2 : 0;
+}
+
+void ogg_opus_writer_destroy(ogg_opus_writer_t *w)
+{
+    if (!w) {
+        return;
+    }
+    audio_arena_t *arena = w->cfg.arena;
+    audio_arena_free(arena, w->index.entries);
+    audio_arena_free(arena, w->page);
+    audio_arena_free(arena, w->block);
+    audio_arena_free(arena, w);
+}
+
+void ogg_opus_writer_get_stats(const ogg_opus_writer_t *w, ogg_opus_writer_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (w) {
+        *stats = w->stats;
+    }
+}
+
+const ogg_opus_index_t *ogg_opus_writer_get_index(const ogg_opus_writer_t *w)
+{
+    return w ? &w->index : NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/* 解封装                                                              */
+/* ------------------------------------------------------------------ */
+
+struct ogg_opus_reader {
+    ogg_opus_reader_cfg_t cfg;      // 配置
+    uint8_t *buf;                   // 读块缓冲
+    uint32_t buf_off;               // buf[0] 的文件偏移
+    uint32_t buf_pos;               // 已消费字节
+    uint32_t buf_len;               // 有效字节
+    bool eof;                       // 读回调已到结尾
+    uint8_t *page;                  // 当前页（页头 + 段表 + 数据）
+    uint32_t page_len;              // 当前页总字节
+    uint8_t seg_count;              // 当前页段数
+    uint8_t seg_idx;                // 下一个要消费的段
+    uint32_t body_pos;              // 当前页数据区已消费字节
+    uint8_t *pkt;                   // 跨段/跨页拼装中的包
+    uint32_t pkt_len;               // 已拼装字节
+    bool pkt_drop;                  // 当前包丢弃（过长或起点不在已读范围）
+    bool audio;                     // 头两页已解析
+    bool pos_valid;                 // pos 已由某页的颗粒位置确定
+    int64_t pos;                    // 下一个包的起点（颗粒位置，含 pre-skip）
+    uint32_t serial;                // Opus 逻辑流序列号
+    uint32_t audio_off;             // 首个音频页的偏移
+    ogg_opus_info_t info;           // 流信息
+    bool has_pending;               // 定位得到的首包尚未返回
+    ogg_opus_packet_t pending;
+    ogg_opus_reader_stats_t stats;  // 统计
+};
+
+/**
+ * @brief 从块缓冲取 n 字节（dst 为NULL时丢弃），缓冲空时按块边界读取
+ *
+ * @return 实际取得的字节数，小于 n 表示结束，读错误返回负值
+ */
+static int reader_bytes(ogg_opus_reader_t *r, uint8_t *dst, uint32_t n)
+{
+    uint32_t got = 0;
+    while (got < n) {
+        if (r->buf_pos == r->buf_len) {
+            if (r->eof) {
+                break;
+            }
+            r->buf_off += r->buf_len;
+            r->buf_pos = r->buf_len = 0;
+            uint32_t want = r->cfg.block_size - (r->buf_off % r->cfg.block_size);
+            int rd = r->cfg.read(r->cfg.ctx, r->buf, want);
+            r->stats.read_calls++;
+            if (rd < 0) {
+                return rd;
+            }
+            r->stats.read_bytes += (uint32_t)rd;
+            r->buf_len = (uint32_t)rd;
+            r->eof = rd == 0;
+            continue;
+        }
+        uint32_t k = r->buf_len - r->buf_pos;
+        if (k > n - got) {
+            k = n - got;
+        }
+        if (dst) {
+            memcpy(dst + got, r->buf + r->buf_pos, k);
+        }
+        r->buf_pos += k;
+        got += k;
+    }
+    return (int)got;
+}
+
+/**
+ * @brief 读入下一页：找页起始标志、校验CRC，跳过过大或不属于本流的页
+ *
+ * @return 1 成功，0 结束，负值为读错误
+ */
+static int reader_page(ogg_opus_reader_t *r)
+{
+    for (;;) {
+        uint8_t *h = r->page;
+        int n = reader_bytes(r, h, 4);
+        if (n < 4) {
+            return n < 0 ? n : 0;
+        }
+        // 不在页边界时逐字节滑动直到找到 "OggS"
+        while (memcmp(h, "OggS", 4) != 0) {
+            memmove(h, h + 1, 3);
+            n = reader_bytes(r, h + 3, 1);
+            if (n < 1) {
+                return n < 0 ? n : 0;
+            }
+        }
+        n = reader_bytes(r, h + 4, OGG_HEADER_SIZE - 4);
+        if (n < OGG_HEADER_SIZE - 4) {
+            return n < 0 ? n : 0;
+        }
+        uint8_t segs = h[26];
+        n = reader_bytes(r, h + OGG_HEADER_SIZE, segs);
+        if (n < segs) {
+            return n < 0 ? n : 0;
+        }
+        uint32_t body = 0;
+        for (int i = 0; i < segs; i++) {
+            body += h[OGG_HEADER_SIZE + i];
+        }
+        uint32_t len = OGG_HEADER_SIZE + segs + body;
+        if (h[4] != 0 || len > r->cfg.page_cap) {
+            r->stats.skipped++;
+            n = reader_bytes(r, NULL, body);
+            if (n < (int)body) {
+                return n < 0 ? n : 0;
+            }
+            continue;
+        }
+        n = reader_bytes(r, h + OGG_HEADER_SIZE + segs, body);
+        if (n < (int)body) {
+            return n < 0 ? n : 0;
+        }
+        uint32_t crc = get_le32(h + 22);
+        memset(h + 22, 0, 4);
+        if (ogg_crc(0, h, len) != crc) {
+            r->stats.crc_errors++;
+            continue;
+        }
+        if (r->audio && get_le32(h + 14) != r->serial) {
+            r->stats.skipped++;
+            continue;
+        }
+        r->page_len = len;
+        r->seg_count = segs;
+        r->seg_idx = 0;
+        r->body_pos = 0;
+        r->stats.pages++;
+        return 1;
+    }
+}
+
+/**
+ * @brief 新页载入后（定位或开头）由页尾颗粒位置倒推页内首个完整包的起点
+ */
+static void reader_page_pos(ogg_opus_reader_t *r)
+{
+    const uint8_t *h = r->page;
+    int64_t granule = (int64_t)get_le64(h + 6);
+    if (r->pos_valid || !r->audio || granule == OGG_GRANULE_NONE) {
+        return;
+    }
+    const uint8_t *segs = h + OGG_HEADER_SIZE;
+    const uint8_t *body = segs + r->seg_count;
+    bool drop = r->pkt_drop || ((h[5] & OGG_FLAG_CONTINUED) && !r->pkt_len);
+    uint32_t start = 0, off = 0;
+    int64_t total = 0;
+    for (int i = 0; i < r->seg_count; i++) {
+        off += segs[i];
+        if (segs[i] == 255) {
+            continue;
+        }
+        if (!drop) {
+            // 跨页续接的包其TOC在已拼装的部分
+            const uint8_t *p = (start == 0 && r->pkt_len) ? r->pkt : body + start;
+            size_t plen = (start == 0 && r->pkt_len) ? r->pkt_len + off : off - start;
+            total += ogg_opus_packet_samples(p, plen);
+        }
+        drop = false;
+        start = off;
+    }
+    r->pos = granule - total;
+    r->pos_valid = true;
+}
+
+/**
+ * @brief 取下一个完整的原始包（跨段、跨页拼装）
+ *
+ * @return 1 成功（数据在 r->pkt，长度 r->pkt_len），0 结束，负值为读错误
+ */
+static int reader_packet(ogg_opus_reader_t *r)
+{
+    for (;;) {
+        if (r->seg_idx == r->seg_count) {
+            int ret = reader_page(r);
+            if (ret <= 0) {
+                return ret;
+            }
+            bool continued = r->page[5] & OGG_FLAG_CONTINUED;
+            if (continued && !r->pkt_len) {
+                r->pkt_drop = true;     // 定位后落在包中间，丢弃这一段残包
+            } else if (!continued && r->pkt_len) {
+                r->pkt_len = 0;         // 上一页的残包没有续接，丢弃
+                r->pkt_drop = false;
+            }
+            reader_page_pos(r);
+            continue;
+        }
+        uint8_t lace = r->page[OGG_HEADER_SIZE + r->seg_idx++];
+        const uint8_t *src = r->page + OGG_HEADER_SIZE + r->seg_count + r->body_pos;
+        r->body_pos += lace;
+        if (!r->pkt_drop) {
+            if (r->pkt_len + lace > r->cfg.packet_cap) {
+                r->pkt_drop = true;
+                r->stats.skipped++;
+            } else {
+                memcpy(r->pkt + r->pkt_len, src, lace);
+                r->pkt_len += lace;
+            }
+        }
+        if (lace == 255) {
+            continue;
+        }
+        if (r->pkt_drop) {
+            r->pkt_drop = false;
+            r->pkt_len = 0;
+            continue;
+        }
+        return 1;
+    }
+}
+
+/**
+ * @brief 取下一个音频包并推进位置
+ */
+static int reader_next_audio(ogg_opus_reader_t *r, ogg_opus_packet_t *pkt)
+{
+    for (;;) {
+        r->pkt_len = 0;
+        int ret = reader_packet(r);
+        if (ret <= 0) {
+            return ret;
+        }
+        uint32_t samples = ogg_opus_packet_samples(r->pkt, r->pkt_len);
+        if (!samples) {
+            r->stats.skipped++;
+            continue;
+        }
+        pkt->data = r->pkt;
+        pkt->len = (uint16_t)r->pkt_len;
+        pkt->samples = samples;
+        pkt->pos = r->pos - r->info.pre_skip;
+        r->pos += samples;
+        r->stats.packets++;
+        return 1;
+    }
+}
+
+static void reader_rewind(ogg_opus_reader_t *r, uint32_t offset)
+{
+    r->buf_off = offset;
+    r->buf_pos = r->buf_len = 0;
+    r->eof = false;
+    r->seg_count = r->seg_idx = 0;
+    r->pkt_len = 0;
+    r->pkt_drop = false;
+    r->pos_valid = false;
+    r->has_pending = false;
+}
+
+/**
+ * @brief 解析 OpusHead/OpusTags，记录首个音频页的偏移
+ */
+static int reader_headers(ogg_opus_reader_t *r)
+{
+    if (reader_packet(r) != 1 || !(r->page[5] & OGG_FLAG_BOS) || r->pkt_len < 19 ||
+        memcmp(r->pkt, "OpusHead", 8) != 0 || (r->pkt[8] & 0xf0) != 0) {
+        return -1;
+    }
+    r->serial = get_le32(r->page + 14);
+    r->info.channels = r->pkt[9];
+    r->info.pre_skip = get_le16(r->pkt + 10);
+    r->info.input_rate = get_le32(r->pkt + 12);
+    r->pkt_len = 0;
+    if (reader_packet(r) != 1 || r->pkt_len < 8 || memcmp(r->pkt, "OpusTags", 8) != 0) {
+        return -1;
+    }
+    // OpusTags 独占到页尾，下一页起为音频
+    r->audio_off = r->buf_off + r->buf_pos;
+    r->audio = true;
+    r->pos_valid = false;
+    r->pkt_len = 0;
+    return 0;
+}
+
+ogg_opus_reader_t *ogg_opus_reader_create(const ogg_opus_reader_cfg_t *cfg)
+{
+    if (!cfg || !cfg->read || !cfg->block_size || cfg->page_cap < OGG_HEADER_SIZE + OGG_MAX_SEGMENTS || !cfg->packet_cap) {
+        return NULL;
+    }
+    audio_arena_t *arena = cfg->arena;
+    ogg_opus_reader_t *r = audio_arena_calloc(arena, 1, sizeof(ogg_opus_reader_t), AUDIO_ARENA_INTERNAL);
+    if (!r) {
+        return NULL;
+    }
+    r->cfg = *cfg;
+    r->buf = audio_arena_calloc(arena, cfg->block_size, 1, AUDIO_ARENA_PSRAM);
+    r->page = audio_arena_calloc(arena, cfg->page_cap, 1, AUDIO_ARENA_PSRAM);
+    r->pkt = audio_arena_calloc(arena, cfg->packet_cap, 1, AUDIO_ARENA_PSRAM);
+    if (!r->buf || !r->page || !r->pkt || reader_headers(r) != 0) {
+        ogg_opus_reader_destroy(r);
+        return NULL;
+    }
+    return r;
+}
+
+void ogg_opus_reader_destroy(ogg_opus_reader_t *r)
+{
+    if (!r) {
+        return;
+    }
+    audio_arena_t *arena = r->cfg.arena;
+    audio_arena_free(arena, r->pkt);
+    audio_arena_free(arena, r->page);
+    audio_arena_free(arena, r->buf);
+    audio_arena_free(arena, r);
+}
+
+void ogg_opus_reader_get_info(const ogg_opus_reader_t *r, ogg_opus_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    if (r) {
+        *info = r->info;
+    }
+}
+
+int ogg_opus_reader_next(ogg_opus_reader_t *r, ogg_opus_packet_t *pkt)
+{
+    if (!r || !pkt) {
+        return -1;
+    }
+    if (r->has_pending) {
+        r->has_pending = false;
+        *pkt = r->pending;
+        return 1;
+    }
+    return reader_next_audio(r, pkt);
+}
+
+int ogg_opus_reader_seek(ogg_opus_reader_t *r, uint32_t time_ms, const ogg_opus_index_t *index)
+{
+    if (!r || !r->cfg.seek) {
+        return -1;
+    }
+    uint32_t t = time_ms > OGG_OPUS_PREROLL_MS ? time_ms - OGG_OPUS_PREROLL_MS : 0;
+    int64_t target = (int64_t)t * (OGG_OPUS_RATE / 1000);
+    uint32_t offset = r->audio_off;
+    if (index) {
+        // 二分查找不晚于目标的最后一个条目
+        uint32_t lo = 0, hi = index->count;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if (index->entries[mid].time_ms <= t) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > 0 && index->entries[lo - 1].offset >= r->audio_off) {
+            offset = index->entries[lo - 1].offset;
+        }
+    }
+    if (r->cfg.seek(r->cfg.ctx, offset) != 0) {
+        return -1;
+    }
+    r->stats.seeks++;
+    reader_rewind(r, offset);
+    for (;;) {
+        ogg_opus_packet_t pkt;
+        int ret = reader_next_audio(r, &pkt);
+        if (ret <= 0) {
+            return ret == 0 ? 1 : ret;
+        }
+        if (pkt.pos + (int64_t)pkt.samples > target) {
+            r->pending = pkt;
+            r->has_pending = true;
+            return 0;
+        }
+    }
+}
+
+void ogg_opus_reader_get_stats(const ogg_opus_reader_t *r, ogg_opus_reader_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (r) {
+        *stats = r->stats;
+    }
+}
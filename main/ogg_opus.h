@@ -0,0 +1,289 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 11:00:00
+ * @LastEditTime: 2026-10-17 11:00:00
+ * @LastEditors: 星年
+ * @Description: Ogg-Opus 封装与解封装（RFC 7845）：按存储块对齐批量写出，附带紧凑的时间->偏移索引，读取端按索引直接定位
+ * @FilePath: \audio_manager\main\ogg_opus.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "opus_packet_slab.h"
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OGG_OPUS_RATE           48000   // Ogg-Opus 颗粒位置的时基（与编码采样率无关）
+#define OGG_OPUS_BLOCK_SIZE     4096    // 默认存储块大小（Flash扇区/SD卡簇的公约数），写入按块对齐
+#define OGG_OPUS_PAGE_CAP       8192    // 默认单页上限（字节，含页头），读取端超过此大小的页跳过
+#define OGG_OPUS_PAGE_MS        1000    // 默认单页最长时长（RFC 7845 建议不超过1秒）
+#define OGG_OPUS_PACKET_CAP     1500    // 默认单包上限（字节）
+#define OGG_OPUS_INDEX_CAP      512     // 默认索引条目数，写满后抽稀一半、间隔加倍
+#define OGG_OPUS_INDEX_MS       1000    // 默认索引间隔
+#define OGG_OPUS_PREROLL_MS     80      // 定位后解码器的预滚时长（RFC 7845 建议80ms）
+
+/**
+ * @brief 存储写回调：写入 len 字节，返回实际写入字节数，失败返回负值
+ */
+typedef int (*ogg_opus_write_t)(void *ctx, const void *data, size_t len);
+
+/**
+ * @brief 存储读回调：最多读 len 字节，返回实际读取字节数（0 表示结束），失败返回负值
+ */
+typedef int (*ogg_opus_read_t)(void *ctx, void *data, size_t len);
+
+/**
+ * @brief 存储定位回调：定位到绝对偏移，成功返回0
+ */
+typedef int (*ogg_opus_seek_t)(void *ctx, uint32_t offset);
+
+/**
+ * @brief 索引条目：某页起点的播放时间与文件偏移
+ */
+typedef struct {
+    uint32_t time_ms;               // 页内首个样点的时间（已扣除 pre-skip）
+    uint32_t offset;                // 页在文件中的字节偏移
+} ogg_opus_index_entry_t;
+
+/**
+ * @brief 时间 -> 偏移索引（条目按时间递增，相邻间隔不小于 interval_ms）
+ */
+typedef struct {
+    ogg_opus_index_entry_t *entries;    // 条目存储（由调用者或写入端提供）
+    uint32_t cap;                       // 条目容量
+    uint32_t count;                     // 条目数
+    uint32_t interval_ms;               // 当前条目间隔
+} ogg_opus_index_t;
+
+/**
+ * @brief 封装配置
+ */
+typedef struct {
+    ogg_opus_write_t write;         // 存储写回调
+    void *ctx;                      // 回调上下文
+    uint32_t sample_rate;           // 编码输入采样率（写入 OpusHead，并换算包时间戳）
+    uint8_t channels;               // 通道数
+    uint16_t pre_skip;              // 编码器前瞻（48kHz样点），播放端从开头丢弃
+    uint32_t serial;                // 逻辑流序列号
+    uint16_t block_size;            // 存储块大小，写回调每次写满一块（结束/冲刷时除外）
+    uint16_t page_cap;              // 单页上限（字节）
+    uint16_t page_ms;               // 单页最长时长，同时决定索引的最小粒度
+    uint16_t index_cap;             // 索引条目数（0 不建索引）
+    uint16_t index_ms;              // 初始索引间隔
+    audio_arena_t *arena;           // 内存区，NULL 时从堆分配
+} ogg_opus_writer_cfg_t;
+
+#define DEFAULT_OGG_OPUS_WRITER_CONFIG() {  \
+    .write       = NULL,                    \
+    .ctx         = NULL,                    \
+    .sample_rate = 16000,                   \
+    .channels    = 1,                       \
+    .pre_skip    = 312,                     \
+    .serial      = 0x4f505553,              \
+    .block_size  = OGG_OPUS_BLOCK_SIZE,     \
+    .page_cap    = OGG_OPUS_PAGE_CAP,       \
+    .page_ms     = OGG_OPUS_PAGE_MS,        \
+    .index_cap   = OGG_OPUS_INDEX_CAP,      \
+    .index_ms    = OGG_OPUS_INDEX_MS,       \
+    .arena       = NULL,                    \
+}
+
+/**
+ * @brief 封装统计
+ */
+typedef struct {
+    uint32_t packets;               // 写入的包数
+    uint32_t gap_packets;           // 为序号缺口（DTX/丢帧）补写的空帧包数
+    uint32_t dropped;               // 过长或格式非法而丢弃的包数
+    uint32_t pages;                 // 写出的页数
+    uint32_t payload_bytes;         // 包数据字节数（不含补写的空帧）
+    uint32_t file_bytes;            // 写出的文件字节数
+    uint32_t write_calls;           // 写回调调用次数
+    uint32_t write_errors;          // 写回调失败次数
+    uint64_t granule;               // 当前颗粒位置（48kHz样点，含 pre-skip）
+} ogg_opus_writer_stats_t;
+
+/**
+ * @brief 解封装配置
+ */
+typedef struct {
+    ogg_opus_read_t read;           // 存储读回调
+    ogg_opus_seek_t seek;           // 存储定位回调（NULL 时不支持定位）
+    void *ctx;                      // 回调上下文
+    uint16_t block_size;            // 每次读回调读取的块大小
+    uint16_t page_cap;              // 单页上限（字节）
+    uint16_t packet_cap;            // 单包上限（字节），超过的包跳过
+    audio_arena_t *arena;           // 内存区，NULL 时从堆分配
+} ogg_opus_reader_cfg_t;
+
+#define DEFAULT_OGG_OPUS_READER_CONFIG() {  \
+    .read       = NULL,                     \
+    .seek       = NULL,                     \
+    .ctx        = NULL,                     \
+    .block_size = OGG_OPUS_BLOCK_SIZE,      \
+    .page_cap   = OGG_OPUS_PAGE_CAP,        \
+    .packet_cap = OGG_OPUS_PACKET_CAP,      \
+    .arena      = NULL,                     \
+}
+
+/**
+ * @brief 流信息（来自 OpusHead）
+ */
+typedef struct {
+    uint8_t channels;               // 通道数
+    uint16_t pre_skip;              // 开头需丢弃的48kHz样点数
+    uint32_t input_rate;            // 原始输入采样率（仅供参考）
+} ogg_opus_info_t;
+
+/**
+ * @brief 解封装出的一个包
+ */
+typedef struct {
+    const uint8_t *data;            // 包数据（下一次调用 ogg_opus_reader_next() 前有效）
+    uint16_t len;                   // 包长度
+    uint32_t samples;               // 包时长（48kHz样点）
+    int64_t pos;                    // 包起点（48kHz样点，已扣除 pre-skip，开头为负）
+} ogg_opus_packet_t;
+
+/**
+ * @brief 解封装统计
+ */
+typedef struct {
+    uint32_t pages;                 // 读取的页数
+    uint32_t packets;               // 输出的包数
+    uint32_t crc_errors;            // 校验失败跳过的页数
+    uint32_t skipped;               // 过大或不属于本流而跳过的页/包数
+    uint32_t read_calls;            // 读回调调用次数
+    uint32_t read_bytes;            // 读回调读取的字节数
+    uint32_t seeks;                 // 定位次数
+} ogg_opus_reader_stats_t;
+
+typedef struct ogg_opus_writer ogg_opus_writer_t;
+typedef struct ogg_opus_reader ogg_opus_reader_t;
+
+/**
+ * @brief Opus 包时长（48kHz样点），由TOC字节推出；格式非法返回0
+ */
+uint32_t ogg_opus_packet_samples(const uint8_t *data, size_t len);
+
+/**
+ * @brief 创建封装器，OpusHead/OpusTags 两页随即进入块缓冲
+ *
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+ogg_opus_writer_t *ogg_opus_writer_create(const ogg_opus_writer_cfg_t *cfg);
+
+/**
+ * @brief 写入一个包
+ *
+ * 包序号出现缺口时（DTX静音段或发送端丢帧）先为每个缺失的帧补写一个只有TOC字节的空帧包，
+ * 解码端对其做PLC/舒适噪声，保证颗粒位置与真实时间一致；空帧每帧仅占2字节。
+ * 只有凑满一个存储块才调用写回调。
+ *
+ * @return 0 成功，包非法返回 -1，写回调失败返回 -2
+ */
+int ogg_opus_writer_put(ogg_opus_writer_t *w, const opus_packet_t *pkt);
+
+/**
+ * @brief 结束当前页并写出块缓冲中的全部数据（不足一块也写出），用于定期落盘
+ *
+ * 之后的写入先补齐到下一个块边界再按整块写出，保持块对齐。
+ *
+ * @return 0 成功，写回调失败返回 -2
+ */
+int ogg_opus_writer_flush(ogg_opus_writer_t *w);
+
+/**
+ * @brief 写出带结束标志的最后一页并冲刷
+ *
+ * @return 0 成功，写回调失败返回 -2
+ */
+int ogg_opus_writer_close(ogg_opus_writer_t *w);
+
+/**
+ * @brief 销毁封装器（未 close 的数据丢弃）
+ */
+void ogg_opus_writer_destroy(ogg_opus_writer_t *w);
+
+/**
+ * @brief 获取封装统计
+ */
+void ogg_opus_writer_get_stats(const ogg_opus_writer_t *w, ogg_opus_writer_stats_t *stats);
+
+/**
+ * @brief 获取封装器建立的索引（随写入增长，封装器销毁后失效）
+ */
+const ogg_opus_index_t *ogg_opus_writer_get_index(const ogg_opus_writer_t *w);
+
+/**
+ * @brief 索引序列化后的字节数
+ */
+size_t ogg_opus_index_size(const ogg_opus_index_t *index);
+
+/**
+ * @brief 将索引写入存储（独立的索引文件，小端，带CRC）
+ *
+ * @return 0 成功，写回调失败返回 -1
+ */
+int ogg_opus_index_save(const ogg_opus_index_t *index, ogg_opus_write_t write, void *ctx);
+
+/**
+ * @brief 从存储读取索引，条目存入 index->entries（容量 index->cap）
+ *
+ * 条目数超过容量时均匀抽稀，仍可定位，只是间隔变大。
+ *
+ * @return 0 成功，格式或校验错误返回 -1
+ */
+int ogg_opus_index_load(ogg_opus_index_t *index, ogg_opus_read_t read, void *ctx);
+
+/**
+ * @brief 创建解封装器并解析 OpusHead/OpusTags
+ *
+ * @return 句柄，参数非法、内存不足或不是Ogg-Opus返回NULL
+ */
+ogg_opus_reader_t *ogg_opus_reader_create(const ogg_opus_reader_cfg_t *cfg);
+
+/**
+ * @brief 销毁解封装器
+ */
+void ogg_opus_reader_destroy(ogg_opus_reader_t *r);
+
+/**
+ * @brief 获取流信息
+ */
+void ogg_opus_reader_get_info(const ogg_opus_reader_t *r, ogg_opus_info_t *info);
+
+/**
+ * @brief 取下一个包
+ *
+ * @return 1 成功，0 流结束，负值为读错误
+ */
+int ogg_opus_reader_next(ogg_opus_reader_t *r, ogg_opus_packet_t *pkt);
+
+/**
+ * @brief 定位到 time_ms
+ *
+ * 有索引时直接跳到不晚于目标的最近一页，只读取该页到目标之间的数据；没有索引时从头顺序扫描。
+ * 定位点提前 OGG_OPUS_PREROLL_MS，供解码器收敛，下一个返回的包即覆盖预滚起点。
+ *
+ * @param r       句柄
+ * @param time_ms 目标时间（已扣除 pre-skip）
+ * @param index   索引，可为NULL
+ * @return 0 成功，目标超出流尾返回1，读错误或不支持定位返回负值
+ */
+int ogg_opus_reader_seek(ogg_opus_reader_t *r, uint32_t time_ms, const ogg_opus_index_t *index);
+
+/**
+ * @brief 获取解封装统计
+ */
+void ogg_opus_reader_get_stats(const ogg_opus_reader_t *r, ogg_opus_reader_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,157 +8,709 @@
  *
  * Copyright (c) 2025 by ${git_name_email}, All Rights Reserved.
  */
+#include <stdio.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "audio_pipeline.h"
 #include "audio_element.h"
-#include "audio_event_iface.h"
 #include "audio_mem.h"
 #include "audio_common.h"
 #include "i2s_stream.h"
-#include "raw_stream.h"
-#include "opus_decoder.h"
+#include "opus_packet_codec.h"
+#include "audio_lifecycle.h"
+#include "audio_duplex.h"
+#include "audio_arena.h"
+#include "audio_format.h"
+#include "ogg_opus.h"
+#include "opus_decode_play.h"
 
 static const char *TAG = "OPUS_DECODE_PLAY";
 
-// 全局静态变量，保存音频管道、raw_reader元素和解码任务句柄
+// 全局静态变量，保存音频管道、包slab与各元素句柄；管道首次启动时构建，停止只暂停
+static audio_lifecycle_t lifecycle = AUDIO_LIFECYCLE_INIT(); // 管道生命周期
 static audio_pipeline_handle_t pipeline = NULL;         // 音频管道句柄
-static audio_element_handle_t raw_reader = NULL;        // raw_stream元素句柄（用于接收Opus数据）
-static TaskHandle_t decode_task_handle = NULL;          // 解码播放任务句柄
+static opus_packet_slab_t *packet_slab = NULL;          // Opus包slab（上层直接写入，解码元素取出后移入抖动缓冲）
+static audio_arena_t *slab_arena = NULL;                // 包slab内存区（随slab一次分配，永不回卷）
+static audio_arena_t *play_arena = NULL;                // 解码管道内存区（首次构建时预留，deinit 时回卷）
+static audio_element_handle_t decoder_el = NULL;        // Opus包解码器元素句柄（用于查询抖动缓冲统计）
+static audio_element_handle_t i2s_writer = NULL;        // I2S播放元素句柄（接入全双工引擎时为NULL）
+static ringbuf_handle_t duplex_rb = NULL;               // 全双工引擎的播放环形缓冲区（未接入时为NULL）
+static uint16_t write_seq = 0;                          // 兼容写接口自动分配的包序号
+static uint32_t wm_high = 0;                            // 包slab高水位（0为不通知）
+static uint32_t wm_low = 0;                             // 包slab低水位
+static opus_packet_slab_watermark_t wm_cb = NULL;       // 水位回调
+static void *wm_ctx = NULL;                             // 水位回调上下文
+static bool red_enabled = false;                        // 上层写入的包为冗余封装（构建解码管道时确定）
+static bool fec_enabled = false;                        // 发送端启用了带内FEC（构建解码管道时确定）
 
-#define RAW_STREAM_BUFFER_SIZE (8 * 1024)               // raw_stream缓冲区大小（字节）
+#define PACKET_SLOT_COUNT 16                            // 包槽数量
+#define PACKET_SLOT_SIZE 512                            // 每个包槽容量（字节），总计8KB
+#define SLAB_ARENA_SRAM (1024)                          // 包槽描述
+#define DECODE_CONTENT_RATE 16000                       // 远端内容采样率（编码端采集发布率），解码不低于它以免丢带宽
+#define FILE_TASK_STACK (4 * 1024)                      // 文件播放任务堆栈（文件系统调用）
+#define FILE_LEAD_MS 200                                // 文件播放提前送包的时长（不超过抖动缓冲最大深度）
+#define FILE_PATH_MAX 96                                // 文件路径最大长度（含 ".idx" 后缀）
+#define FILE_JOIN_MS 1000                               // 等文件播放任务退出，超时只告警继续等
+
+static uint32_t decode_rate = DECODE_CONTENT_RATE;      // 协商后的解码输出采样率（即I2S/全双工引擎采样率）
+
+// Opus解码器可直接输出的采样率；低于内容采样率的档位会丢掉宽带内容，不列入
+static const audio_caps_t opus_caps = {
+    .rates = {16000, 24000, 48000},
+    .rate_count = 3,
+    .channels_mask = AUDIO_FORMAT_CH(1),
+    .bits_mask = AUDIO_FORMAT_BITS_16,
+};
+
+// MAX98357A：8kHz~96kHz，16/32位槽，单声道取左声道
+static const audio_caps_t dac_caps = {
+    .rate_min = 8000,
+    .rate_max = 96000,
+    .channels_mask = AUDIO_FORMAT_CH(1) | AUDIO_FORMAT_CH(2),
+    .bits_mask = AUDIO_FORMAT_BITS_16 | AUDIO_FORMAT_BITS_32,
+};
+
+// 全双工引擎：收发与回声消除共用一个采样率
+static const audio_caps_t duplex_caps = {
+    .rates = {AUDIO_DUPLEX_SAMPLE_RATE},
+    .rate_count = 1,
+    .channels_mask = AUDIO_FORMAT_CH(1),
+    .bits_mask = AUDIO_FORMAT_BITS_16,
+};
+
+static TaskHandle_t file_task = NULL;                   // 文件播放任务（播放文件期间是包slab唯一的生产者）
+static volatile bool file_playing = false;              // 文件播放任务运行标志
+static char file_path[FILE_PATH_MAX];                   // 播放中的文件路径
+static uint32_t file_start_ms = 0;                      // 起始播放位置
+static ogg_opus_index_entry_t *file_index = NULL;       // 文件定位索引条目（构建时从解码管道内存区取得，各次播放复用）
+static StaticSemaphore_t file_done_buf;
+static SemaphoreHandle_t file_done = NULL;              // 文件播放任务已退出（二值信号量）
+
+/**
+ * @brief 获取一个空闲包槽用于写入Opus包（零拷贝，不阻塞）
+ *
+ * 上层可直接将网络数据接收到 pkt->data（容量 pkt->cap），填好len/seq/timestamp后
+ * 调用 opus_decode_play_commit() 提交。
+ * @param pkt 输出参数，指向slab内的空闲包槽
+ * @return 成功返回0，未运行或slab已满返回-1
+ */
+int opus_decode_play_acquire(opus_packet_t **pkt)
+{
+    if (!packet_slab) return -1; // 若slab未初始化，返回错误
+    opus_packet_t *p = opus_packet_slab_acquire_write(packet_slab);
+    if (!p) return -1;
+    *pkt = p;
+    return 0;
+}
+
+/**
+ * @brief 提交由 opus_decode_play_acquire() 获取并已填好的包
+ * @param pkt 待提交的包
+ */
+void opus_decode_play_commit(opus_packet_t *pkt)
+{
+    if (!packet_slab || !pkt) return;
+    pkt->arrival_ms = (uint32_t)(esp_timer_get_time() / 1000);  // 记录到达时间，供抖动缓冲估计网络抖动
+    opus_packet_slab_commit(packet_slab, pkt);
+}
 
 /**
- * @brief 向Opus解码播放模块写入Opus编码数据
+ * @brief 向Opus解码播放模块写入一个完整的Opus包（兼容接口，会拷贝一次）
  *
- * 该函数供上层调用，将Opus编码数据写入raw_stream缓冲区，供后台解码任务消费。
- * @param data Opus编码数据指针
- * @param len  数据长度（字节）
- * @return 实际写入的字节数，失败返回-1
+ * @param data Opus包数据指针
+ * @param len  包长度（字节）
+ * @return 实际写入的字节数，未运行、slab已满或包过长返回-1
  */
 int opus_decode_play_write(const uint8_t *data, size_t len)
 {
-    if (!raw_reader) return -1; // 若raw_reader未初始化，返回错误
-    return raw_stream_write(raw_reader, (const char *)data, len); // 写入数据到raw_stream
+    opus_packet_t *pkt = NULL;
+    if (opus_decode_play_acquire(&pkt) != 0) return -1;
+    if (len > pkt->cap) {
+        ESP_LOGW(TAG, "packet too large: %u > %u", (unsigned)len, (unsigned)pkt->cap);
+        return -1;
+    }
+    memcpy(pkt->data, data, len);
+    pkt->len = (uint16_t)len;
+    pkt->seq = write_seq++;
+    pkt->timestamp = 0;     // 兼容接口不携带时间戳
+    opus_decode_play_commit(pkt);
+    return (int)len;
 }
 
 /**
- * @brief Opus解码播放任务
+ * @brief 一次写入多个完整的Opus包（兼容接口的批量版本，不阻塞）
  *
- * 该任务负责初始化音频管道，依次包括raw_stream（输入Opus数据）、Opus解码器、I2S播放，
- * 并循环监听事件，实现Opus流的实时解码与播放。
- * @param arg 未使用
+ * 空闲包槽只取一次、下标只推进一次、解码任务只唤醒一次。
+ * @param data  各包数据指针
+ * @param len   各包长度
+ * @param count 包数
+ * @return 实际写入的包数（slab已满或遇到过长的包时提前停止），未运行返回-1
  */
-static void opus_decode_play_task(void *arg)
+int opus_decode_play_write_batch(const uint8_t *const *data, const size_t *len, int count)
 {
-    audio_element_handle_t opus_decoder = NULL; // Opus解码器元素句柄
-    audio_element_handle_t i2s_writer = NULL;   // I2S播放元素句柄
+    if (!packet_slab) return -1;
+    opus_packet_t *pkts[PACKET_SLOT_COUNT];
+    uint32_t want = count < PACKET_SLOT_COUNT ? (uint32_t)(count > 0 ? count : 0) : PACKET_SLOT_COUNT;
+    uint32_t got = opus_packet_slab_acquire_write_batch(packet_slab, pkts, want);
+    uint32_t arrival_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    uint32_t n = 0;
+    for (; n < got; n++) {
+        if (len[n] > pkts[n]->cap) {
+            ESP_LOGW(TAG, "packet too large: %u > %u", (unsigned)len[n], (unsigned)pkts[n]->cap);
+            break;
+        }
+        memcpy(pkts[n]->data, data[n], len[n]);
+        pkts[n]->len = (uint16_t)len[n];
+        pkts[n]->seq = write_seq++;
+        pkts[n]->timestamp = 0;
+        pkts[n]->arrival_ms = arrival_ms;
+    }
+    opus_packet_slab_commit_batch(packet_slab, n);
+    return (int)n;
+}
 
-    // 1. 创建 raw_stream 作为 Opus 数据输入
-    raw_stream_cfg_t raw_cfg = {
-        .type = AUDIO_STREAM_READER,                // 作为reader，供上层写入数据
-        .out_rb_size = RAW_STREAM_BUFFER_SIZE,      // 环形缓冲区大小
-    };
-    raw_reader = raw_stream_init(&raw_cfg);         // 初始化raw_stream元素
-
-    // 2. 创建 Opus 解码器
-    opus_decoder_cfg_t opus_cfg = DEFAULT_OPUS_DECODER_CONFIG(); // 获取默认Opus解码器配置
-    // opus_cfg.sample_rate = 44100;
-    // opus_cfg.channel = 1;                                         // 单声道
-    opus_decoder = decoder_opus_init(&opus_cfg);                 // 初始化Opus解码器元素
-
-    // 3. 创建 I2S 播放器
-    i2s_stream_cfg_t i2s_cfg = I2S_STREAM_CFG_DEFAULT();         // 获取默认I2S配置
-    i2s_cfg.type = AUDIO_STREAM_WRITER;                          // 作为writer，输出PCM到I2S
-    i2s_cfg.std_cfg.slot_cfg.slot_mode = I2S_SLOT_MODE_MONO;     // 单声道输出
-    i2s_cfg.std_cfg.slot_cfg.data_bit_width = I2S_DATA_BIT_WIDTH_16BIT; // 16位数据宽度
-    i2s_cfg.std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;                    // 未用MCLK
-    i2s_cfg.std_cfg.gpio_cfg.bclk = 19;                                 // BCLK引脚
-    i2s_cfg.std_cfg.gpio_cfg.ws = 8;                                   // WS引脚
-    i2s_cfg.std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;                   // 未用DOUT
-    i2s_cfg.std_cfg.gpio_cfg.din = 20;                                  // DIN引脚
-    i2s_cfg.volume = 80;                                                // 默认音量
-    i2s_writer = i2s_stream_init(&i2s_cfg);                      // 初始化I2S元素
-
-    // 4. 创建音频管道
-    audio_pipeline_cfg_t pipeline_cfg = DEFAULT_AUDIO_PIPELINE_CONFIG(); // 获取默认管道配置
-    pipeline = audio_pipeline_init(&pipeline_cfg);                       // 初始化音频管道
+/**
+ * @brief 设置包slab的水位通知，slab已创建时立即生效，否则在创建后生效
+ */
+void opus_decode_play_set_watermarks(uint32_t high, uint32_t low, opus_packet_slab_watermark_t cb, void *ctx)
+{
+    wm_high = high;
+    wm_low = low;
+    wm_cb = cb;
+    wm_ctx = ctx;
+    if (packet_slab) {
+        opus_packet_slab_set_watermarks(packet_slab, high, low, cb, ctx);
+    }
+}
 
-    // 注册各元素到管道
-    audio_pipeline_register(pipeline, raw_reader, "raw");        // 注册raw_stream
-    audio_pipeline_register(pipeline, opus_decoder, "opus");     // 注册Opus解码器
-    audio_pipeline_register(pipeline, i2s_writer, "i2s");        // 注册I2S播放
+/**
+ * @brief 声明上层写入的包为冗余封装（opus_red）
+ * @param enable 是否启用
+ * @return 成功返回0，解码管道已构建返回-1
+ */
+int opus_decode_play_set_red(bool enable)
+{
+    if (decoder_el) return -1;
+    red_enabled = enable;
+    return 0;
+}
 
-    // 链接管道元素，数据流向: raw -> opus -> i2s
-    const char *link_tag[3] = {"raw", "opus", "i2s"};
-    audio_pipeline_link(pipeline, link_tag, 3);
+/**
+ * @brief 声明发送端启用了带内FEC
+ * @param enable 是否启用
+ * @return 成功返回0，解码管道已构建返回-1
+ */
+int opus_decode_play_set_fec(bool enable)
+{
+    if (decoder_el) return -1;
+    fec_enabled = enable;
+    return 0;
+}
 
-    // 5. 创建并设置事件监听器
-    audio_event_iface_cfg_t evt_cfg = AUDIO_EVENT_IFACE_DEFAULT_CFG(); // 默认事件接口配置
-    audio_event_iface_handle_t evt = audio_event_iface_init(&evt_cfg); // 初始化事件接口
-    audio_pipeline_set_listener(pipeline, evt);                       // 设置管道事件监听
+/**
+ * @brief 获取抖动缓冲统计（缓冲深度、抖动、FEC/PLC次数等）
+ * @param stats 输出统计
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_decode_play_get_stats(jitter_buffer_stats_t *stats)
+{
+    if (!decoder_el) return -1;
+    return opus_pkt_decoder_get_stats(decoder_el, stats) == ESP_OK ? 0 : -1;
+}
 
-    // 启动音频管道
-    audio_pipeline_run(pipeline);
+/**
+ * @brief 获取时钟漂移补偿统计（估计的发送端时钟偏差、当前比值与水位误差）
+ * @param stats 输出统计
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_decode_play_get_drift_stats(drift_asrc_stats_t *stats)
+{
+    if (!decoder_el) return -1;
+    return opus_pkt_decoder_get_drift_stats(decoder_el, stats) == ESP_OK ? 0 : -1;
+}
 
-    ESP_LOGI(TAG, "Opus decode play pipeline started");
+/**
+ * @brief 打开一路说话人（多路会议播放）
+ * @param gain 增益（Q15，AUDIO_MIX_UNITY 为0dB）
+ * @return 路句柄，未运行或路已用完返回NULL
+ */
+opus_mixer_stream_t *opus_decode_play_stream_open(uint16_t gain)
+{
+    if (!decoder_el) return NULL;
+    return opus_mixer_open(opus_pkt_decoder_get_mixer(decoder_el), gain);
+}
 
-    // 主循环，监听管道事件
-while (1) {
-    audio_event_iface_msg_t msg;
-    esp_err_t ret = audio_event_iface_listen(evt, &msg, portMAX_DELAY);
-    if (ret != ESP_OK) continue;
-    // ESP_LOGI(TAG, "event: source_type=%d, cmd=%d, data=%p", msg.source_type, msg.cmd, msg.data);
+/**
+ * @brief 关闭一路说话人，之后发往该路的包被丢弃
+ * @param stream 路句柄
+ */
+void opus_decode_play_stream_close(opus_mixer_stream_t *stream)
+{
+    if (!decoder_el) return;
+    opus_mixer_close(stream);
 }
 
-    // 退出任务时的资源清理
-    audio_pipeline_stop(pipeline);                // 停止管道
-    audio_pipeline_wait_for_stop(pipeline);       // 等待管道完全停止
-    audio_pipeline_terminate(pipeline);           // 终止管道
+/**
+ * @brief 为指定路获取一个空闲包槽（零拷贝，不阻塞），填好后用 opus_decode_play_commit() 提交
+ * @param stream 路句柄
+ * @param pkt    输出参数，已标记所属路的空闲包槽
+ * @return 成功返回0，未运行或slab已满返回-1
+ */
+int opus_decode_play_stream_acquire(opus_mixer_stream_t *stream, opus_packet_t **pkt)
+{
+    if (!stream || opus_decode_play_acquire(pkt) != 0) return -1;
+    (*pkt)->stream = opus_mixer_stream_id(stream);
+    return 0;
+}
 
-    // 注销各元素
-    audio_pipeline_unregister(pipeline, raw_reader);
-    audio_pipeline_unregister(pipeline, opus_decoder);
-    audio_pipeline_unregister(pipeline, i2s_writer);
+/**
+ * @brief 设置一路的增益（下一帧生效）
+ * @param stream 路句柄
+ * @param gain   增益（Q15，0 为静音且不再解码）
+ */
+void opus_decode_play_stream_set_gain(opus_mixer_stream_t *stream, uint16_t gain)
+{
+    if (!decoder_el) return;
+    opus_mixer_set_gain(stream, gain);
+}
 
-    // 移除并销毁事件监听器
-    audio_pipeline_remove_listener(pipeline);
-    audio_event_iface_destroy(evt);
+/**
+ * @brief 获取一路的解码与抖动缓冲统计
+ * @param stream 路句柄
+ * @param stats  输出统计
+ * @return 成功返回0，未运行或参数无效返回-1
+ */
+int opus_decode_play_stream_get_stats(opus_mixer_stream_t *stream, opus_mixer_stream_stats_t *stats)
+{
+    if (!decoder_el || !stream || !stats) return -1;
+    opus_mixer_get_stream_stats(stream, stats);
+    return 0;
+}
 
-    // 释放管道和元素资源
-    audio_pipeline_deinit(pipeline);
-    audio_element_deinit(raw_reader);
-    audio_element_deinit(opus_decoder);
-    audio_element_deinit(i2s_writer);
+/**
+ * @brief 统计播放链路各级的缓冲延迟（包到达 -> 扬声器）
+ * @param report 输出报告
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_decode_play_get_latency(audio_latency_report_t *report)
+{
+    if (!report || !decoder_el) return -1;
+    int frame_us = audio_latency_get_profile()->opus_frame_us;
+    jitter_buffer_stats_t stats;
+    if (opus_pkt_decoder_get_stats(decoder_el, &stats) != ESP_OK) return -1;
+    audio_latency_report_reset(report);
+    audio_latency_report_add(report, "packet slab", opus_packet_slab_count(packet_slab) * frame_us);
+    audio_latency_report_add(report, "jitter buffer", stats.depth_ms * 1000);
+    audio_latency_report_add(report, "opus decode", frame_us);
+    audio_latency_report_add(report, "drift asrc", DRIFT_ASRC_TAPS / 2 * 1000000 / decode_rate);
+    audio_latency_report_add_ringbuf(report, "decode rb", decoder_el, decode_rate * 2);
+    audio_duplex_stats_t duplex;
+    if (audio_duplex_get_stats(&duplex) == ESP_OK) {
+        audio_latency_report_add(report, "duplex dma", duplex.ref_delay_samples * 1000000ull / decode_rate);
+    } else {
+        audio_latency_report_add_dma(report, "i2s dma", decode_rate);
+    }
+    return 0;
+}
 
-    // 清空全局句柄
-    raw_reader = NULL;
-    pipeline = NULL;
-    decode_task_handle = NULL;
-    vTaskDelete(NULL); // 删除当前任务
+/**
+ * @brief 释放解码播放管道及各元素（管道须处于运行状态或尚未运行），包slab保留
+ */
+static void opus_decode_play_teardown(void)
+{
+    if (pipeline) {
+        audio_pipeline_stop(pipeline);                // 停止管道
+        audio_pipeline_wait_for_stop(pipeline);       // 等待管道完全停止
+        audio_pipeline_terminate(pipeline);           // 终止管道
+
+        // 注销各元素
+        if (decoder_el) {
+            audio_pipeline_unregister(pipeline, decoder_el);
+        }
+        if (i2s_writer) {
+            audio_pipeline_unregister(pipeline, i2s_writer);
+        }
+
+        // 从共用监听任务上摘下，再释放管道
+        audio_lifecycle_unlisten(pipeline);
+        audio_pipeline_deinit(pipeline);
+        pipeline = NULL;
+    }
+    if (decoder_el) {
+        audio_element_deinit(decoder_el);
+        decoder_el = NULL;
+    }
+    if (i2s_writer) {
+        audio_element_deinit(i2s_writer);
+        i2s_writer = NULL;
+    }
+    duplex_rb = NULL;
+    file_index = NULL;
+    audio_arena_reset(play_arena);
 }
 
 /**
- * @brief 启动Opus解码播放任务
+ * @brief 构建并启动解码播放管道（仅首次启动或 deinit 之后执行）
  *
- * 若任务未启动，则创建opus_decode_play_task后台任务，负责Opus解码与播放。
+ * 管道依次包括Opus包解码器（slab -> 抖动缓冲 -> 解码）、I2S播放或全双工引擎，
+ * 元素事件交给共用监听任务，本模块不再单独创建任务。
+ */
+static esp_err_t opus_decode_play_build(void)
+{
+    const audio_latency_profile_t *profile = audio_latency_get_profile(); // 当前延迟档位
+
+    // 0. 解码器直接输出宿端采样率：全双工引擎运行时按引擎采样率，否则按功放支持的采样率，中间不跑重采样
+    duplex_rb = audio_duplex_get_playback_rb();
+    audio_format_link_t link;
+    if (audio_format_negotiate(&opus_caps, duplex_rb ? &duplex_caps : &dac_caps, NULL, 0, &link) != 0) {
+        ESP_LOGE(TAG, "No decode rate supported by %s", duplex_rb ? "duplex engine" : "DAC");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    decode_rate = link.sink.rate;
+    ESP_LOGI(TAG, "Decode format: %u Hz %u ch", (unsigned)decode_rate, link.sink.channels);
+
+    // 1. 创建 Opus 包解码器，各路经自适应抖动缓冲重排后解码，缺包时FEC/PLC，再混成一路
+    opus_pkt_decoder_cfg_t opus_cfg = DEFAULT_OPUS_PKT_DECODER_CONFIG(); // 获取默认Opus包解码器配置
+    opus_cfg.slab = packet_slab;                                 // 输入包slab
+    opus_cfg.sample_rate = decode_rate;                          // 解码输出采样率（协商结果）
+    opus_cfg.frame_us = profile->opus_frame_us;                  // 与编码端帧长一致
+    opus_cfg.streams = OPUS_DECODE_PLAY_MAX_STREAMS;             // 预分配的说话人路数
+    opus_cfg.jitter_min_ms = profile->jitter_min_ms;             // 抖动缓冲最小深度
+    opus_cfg.red = red_enabled;                                  // 冗余封装：拆出主负载，副本补丢包
+    opus_cfg.fec = fec_enabled;                                  // 带内FEC：缺包时用下一包恢复
+    opus_cfg.drift_comp = true;                                  // 按抖动缓冲水位补偿发送端与本地I2S的时钟偏差
+    opus_cfg.lifecycle = &lifecycle;                             // 首帧解码时记录启动耗时
+    opus_cfg.out_rb_size = profile->element_rb_size;             // 解码输出环形缓冲区
+    opus_cfg.task_core = profile->playback_core;
+    opus_cfg.task_prio = profile->task_prio;
+
+    // 预算按路数精确计算：各路解码器状态放片内SRAM，抖动缓冲包数据与文件定位索引放PSRAM
+    audio_arena_cfg_t arena_cfg = {
+        .name = "player",
+        .internal_bytes = opus_pkt_decoder_mem_size(&opus_cfg, AUDIO_ARENA_INTERNAL),
+        .psram_bytes = opus_pkt_decoder_mem_size(&opus_cfg, AUDIO_ARENA_PSRAM) +
+                       AUDIO_ARENA_SIZE(OGG_OPUS_INDEX_CAP * sizeof(ogg_opus_index_entry_t)),
+    };
+    if (audio_arena_ensure(&play_arena, &arena_cfg) != 0) {
+        ESP_LOGE(TAG, "Failed to reserve player arena");
+        return ESP_ERR_NO_MEM;
+    }
+    opus_cfg.arena = play_arena;
+    audio_arena_set_owner(play_arena, "play_opus");
+    decoder_el = opus_pkt_decoder_init(&opus_cfg);               // 初始化Opus包解码器元素
+    audio_arena_set_owner(play_arena, "play_index");
+    file_index = audio_arena_calloc(play_arena, OGG_OPUS_INDEX_CAP, sizeof(ogg_opus_index_entry_t), AUDIO_ARENA_PSRAM);
+    audio_arena_set_owner(play_arena, NULL);
+    if (!decoder_el || !file_index) {
+        ESP_LOGE(TAG, "Failed to create OPUS decoder");
+        return ESP_FAIL;
+    }
+
+    // 2. 创建 I2S 播放器；全双工引擎运行时直接写入引擎的播放环形缓冲区，不再单独创建I2S
+    if (!duplex_rb) {
+        i2s_stream_cfg_t i2s_cfg = I2S_STREAM_CFG_DEFAULT();         // 获取默认I2S配置
+        i2s_cfg.type = AUDIO_STREAM_WRITER;                          // 作为writer，输出PCM到I2S
+        i2s_cfg.chan_cfg.dma_desc_num = profile->i2s_dma_desc_num;   // DMA深度由延迟档位决定
+        i2s_cfg.chan_cfg.dma_frame_num = profile->i2s_dma_frame_num;
+        i2s_cfg.chan_cfg.auto_clear = true;                          // 暂停期间DMA输出静音，不重复残留数据
+        i2s_cfg.buffer_len = profile->i2s_buffer_len;
+        i2s_cfg.task_core = profile->playback_core;
+        i2s_cfg.task_prio = profile->task_prio;
+        i2s_cfg.std_cfg.clk_cfg.sample_rate_hz = decode_rate;        // 与解码输出采样率一致
+        i2s_cfg.std_cfg.slot_cfg.slot_mode = I2S_SLOT_MODE_MONO;     // 单声道输出
+        i2s_cfg.std_cfg.slot_cfg.data_bit_width = I2S_DATA_BIT_WIDTH_16BIT; // 16位数据宽度
+        i2s_cfg.std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;                    // 未用MCLK
+        i2s_cfg.std_cfg.gpio_cfg.bclk = 19;                                 // BCLK引脚
+        i2s_cfg.std_cfg.gpio_cfg.ws = 8;                                   // WS引脚
+        i2s_cfg.std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;                   // 未用DOUT
+        i2s_cfg.std_cfg.gpio_cfg.din = 20;                                  // DIN引脚
+        i2s_cfg.volume = 80;                                                // 默认音量
+        i2s_writer = i2s_stream_init(&i2s_cfg);                      // 初始化I2S元素
+        if (!i2s_writer) {
+            ESP_LOGE(TAG, "Failed to create I2S stream writer");
+            goto _fail;
+        }
+    }
+
+    // 3. 创建音频管道
+    audio_pipeline_cfg_t pipeline_cfg = DEFAULT_AUDIO_PIPELINE_CONFIG(); // 获取默认管道配置
+    pipeline = audio_pipeline_init(&pipeline_cfg);                       // 初始化音频管道
+    if (!pipeline) {
+        goto _fail;
+    }
+
+    // 注册各元素到管道
+    audio_pipeline_register(pipeline, decoder_el, "play_opus");   // 注册Opus解码器（注册名同时作为探针名）
+    if (duplex_rb) {
+        // 数据流向: slab -> opus -> 全双工引擎，由引擎节拍取数写入I2S
+        const char *link_tag[1] = {"play_opus"};
+        audio_pipeline_link(pipeline, link_tag, 1);
+        rb_reset(duplex_rb);
+        audio_element_set_output_ringbuf(decoder_el, duplex_rb);
+    } else {
+        audio_pipeline_register(pipeline, i2s_writer, "play_i2s");    // 注册I2S播放
+
+        // 链接管道元素，数据流向: slab -> opus -> i2s
+        const char *link_tag[2] = {"play_opus", "play_i2s"};
+        audio_pipeline_link(pipeline, link_tag, 2);
+    }
+
+    // 4. 事件接到共用监听任务，启动音频管道
+    audio_lifecycle_listen(pipeline);
+    if (audio_pipeline_run(pipeline) != ESP_OK) {
+        goto _fail;
+    }
+    ESP_LOGI(TAG, "Opus decode play pipeline started");
+    return ESP_OK;
+
+_fail:
+    opus_decode_play_teardown();
+    return ESP_FAIL;
+}
+
+/**
+ * @brief 启动Opus解码播放
+ *
+ * 包slab仅分配一次；首次调用时构建管道，此后停止只是暂停，再次启动时丢弃停止期间
+ * 积压的包、复位抖动缓冲与解码器并恢复管道，不创建任务、不分配内存。
  */
 void opus_decode_play_start(void)
 {
-    if (decode_task_handle) return; // 已启动则不重复创建
-    xTaskCreate(opus_decode_play_task, "opus_decode_play_task", 8 * 1024, NULL, 5, &decode_task_handle);
+    audio_lifecycle_enter(&lifecycle);
+    audio_lifecycle_state_t state = lifecycle.state;
+    if (state == AUDIO_LIFECYCLE_RUNNING) {
+        // 已启动则不重复构建
+    } else if (state == AUDIO_LIFECYCLE_IDLE) {
+        if (!packet_slab) {
+            // 包slab仅分配一次，之后收发过程中不再分配内存；写入方可能在 deinit 后仍持有它，
+            // 因此放在独立的内存区，不随管道内存区回卷
+            audio_arena_cfg_t arena_cfg = {
+                .name = "play_slab",
+                .internal_bytes = SLAB_ARENA_SRAM,
+                .psram_bytes = PACKET_SLOT_COUNT * PACKET_SLOT_SIZE,
+            };
+            if (audio_arena_ensure(&slab_arena, &arena_cfg) == 0) {
+                audio_arena_set_owner(slab_arena, "play_slab");
+                packet_slab = opus_packet_slab_create(slab_arena, PACKET_SLOT_COUNT, PACKET_SLOT_SIZE);
+            }
+            if (packet_slab) {
+                opus_packet_slab_set_watermarks(packet_slab, wm_high, wm_low, wm_cb, wm_ctx);
+            }
+        }
+        if (!packet_slab) {
+            ESP_LOGE(TAG, "Failed to create packet slab");
+        } else {
+            opus_packet_slab_reset(packet_slab);
+            if (opus_decode_play_build() == ESP_OK) {
+                state = AUDIO_LIFECYCLE_RUNNING;
+            }
+        }
+    } else {
+        opus_pkt_decoder_flush(decoder_el);
+        if (duplex_rb) {
+            // 引擎在暂停期间已把残留的PCM播完，此处只清掉停止瞬间写入的尾巴
+            rb_reset(duplex_rb);
+        }
+        if (audio_lifecycle_resume(pipeline) == ESP_OK) {
+            state = AUDIO_LIFECYCLE_RUNNING;
+        }
+    }
+    audio_lifecycle_leave(&lifecycle, state);
 }
 
 /**
- * @brief 停止Opus解码播放任务
+ * @brief 停止Opus解码播放
  *
- * 停止音频管道，任务退出后会自动清理资源。
+ * 暂停管道并冲刷管道内环形缓冲区，等各元素确认暂停后返回；管道、解码器与I2S驱动保留。
+ * 停止期间写入的包在下次启动时丢弃。
  */
 void opus_decode_play_stop(void)
 {
-    if (pipeline) {
-        audio_pipeline_stop(pipeline); // 仅停止管道，任务会检测到并退出
+    opus_decode_play_file_stop();
+    audio_lifecycle_enter(&lifecycle);
+    audio_lifecycle_state_t state = lifecycle.state;
+    if (state == AUDIO_LIFECYCLE_RUNNING && audio_lifecycle_pause(pipeline) == ESP_OK) {
+        state = AUDIO_LIFECYCLE_PAUSED;
+    }
+    audio_lifecycle_leave(&lifecycle, state);
+}
+
+/**
+ * @brief 释放解码播放管道与各元素
+ *
+ * 暂停中的管道先恢复再按正常流程停止，保证各元素任务正常退出；包slab保留以便再次启动。
+ */
+void opus_decode_play_deinit(void)
+{
+    opus_decode_play_file_stop();
+    audio_lifecycle_enter(&lifecycle);
+    if (lifecycle.state == AUDIO_LIFECYCLE_PAUSED) {
+        audio_lifecycle_resume(pipeline);
+    }
+    if (lifecycle.state != AUDIO_LIFECYCLE_IDLE) {
+        opus_decode_play_teardown();
+        ESP_LOGI(TAG, "Opus decode play pipeline released");
+    }
+    audio_lifecycle_leave(&lifecycle, AUDIO_LIFECYCLE_IDLE);
+}
+
+/**
+ * @brief 获取解码播放管道的启停统计
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int opus_decode_play_get_lifecycle(audio_lifecycle_stats_t *stats)
+{
+    if (!stats) return -1;
+    audio_lifecycle_get_stats(&lifecycle, stats);
+    return 0;
+}
+
+/**
+ * @brief 文件读/定位回调
+ */
+static int opus_decode_play_file_read(void *ctx, void *data, size_t len)
+{
+    size_t n = fread(data, 1, len, (FILE *)ctx);
+    return ferror((FILE *)ctx) ? -1 : (int)n;
+}
+
+static int opus_decode_play_file_seek(void *ctx, uint32_t offset)
+{
+    return fseek((FILE *)ctx, offset, SEEK_SET);
+}
+
+/**
+ * @brief 文件播放任务：按索引定位后逐包解封装，按包时间戳提前 FILE_LEAD_MS 送入包slab
+ */
+static void opus_decode_play_file_task(void *arg)
+{
+    FILE *f = fopen(file_path, "rb");
+    ogg_opus_reader_t *r = NULL;
+    ogg_opus_index_t index = {.entries = file_index, .cap = OGG_OPUS_INDEX_CAP};
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open %s", file_path);
+        goto _exit;
+    }
+    setvbuf(f, NULL, _IONBF, 0);    // 解封装器已按存储块读取
+
+    // 1. 读取录制时写出的索引文件（可选），没有时定位退化为顺序扫描
+    size_t n = strlen(file_path);
+    strcpy(file_path + n, ".idx");
+    FILE *fi = fopen(file_path, "rb");
+    file_path[n] = '\0';
+    if (fi) {
+        if (ogg_opus_index_load(&index, opus_decode_play_file_read, fi) != 0) {
+            index.count = 0;
+        }
+        fclose(fi);
+    }
+
+    // 2. 解析头部并定位（定位点提前预滚时长，解码器收敛后正好到起始位置）
+    ogg_opus_reader_cfg_t cfg = DEFAULT_OGG_OPUS_READER_CONFIG();
+    cfg.read = opus_decode_play_file_read;
+    cfg.seek = opus_decode_play_file_seek;
+    cfg.ctx = f;
+    cfg.packet_cap = PACKET_SLOT_SIZE;      // 放不进包槽的包直接跳过
+    r = ogg_opus_reader_create(&cfg);
+    if (!r) {
+        ESP_LOGE(TAG, "%s is not an Ogg-Opus file", file_path);
+        goto _exit;
     }
-}
\ No newline at end of file
+    if (file_start_ms && ogg_opus_reader_seek(r, file_start_ms, index.count ? &index : NULL) != 0) {
+        ESP_LOGW(TAG, "seek to %u ms failed", (unsigned)file_start_ms);
+        goto _exit;
+    }
+
+    // 3. 按包时间戳节拍送包：首包对应当前时刻，每包最多提前 FILE_LEAD_MS
+    ogg_opus_packet_t op;
+    int64_t base_pos = INT64_MIN;
+    int64_t t0_ms = 0;
+    uint16_t seq = 0;
+    while (file_playing && ogg_opus_reader_next(r, &op) == 1) {
+        if (base_pos == INT64_MIN) {
+            base_pos = op.pos;
+            t0_ms = esp_timer_get_time() / 1000;
+        }
+        int64_t due_ms = t0_ms + (op.pos - base_pos) * 1000 / OGG_OPUS_RATE - FILE_LEAD_MS;
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        if (due_ms > now_ms) {
+            vTaskDelay(pdMS_TO_TICKS(due_ms - now_ms));
+        }
+        opus_packet_t *pkt = NULL;
+        while (file_playing && opus_decode_play_acquire(&pkt) != 0) {
+            vTaskDelay(pdMS_TO_TICKS(10));  // slab已满（解码暂停或节拍慢于预期），等解码取走
+        }
+        if (!pkt) {
+            break;
+        }
+        // 文件中是原始Opus包，启用冗余封装时补一个空的封装头（0个冗余块）
+        size_t head = red_enabled ? 1 : 0;
+        if (op.len + head > pkt->cap) {
+            seq++;          // 未提交的包槽下次重新取得；跳过的包按丢包隐藏
+            continue;
+        }
+        pkt->data[0] = 0;
+        memcpy(pkt->data + head, op.data, op.len);
+        pkt->len = (uint16_t)(op.len + head);
+        pkt->seq = seq++;
+        pkt->timestamp = (uint32_t)(op.pos * DECODE_CONTENT_RATE / OGG_OPUS_RATE);
+        opus_decode_play_commit(pkt);
+    }
+
+_exit:
+    ogg_opus_reader_destroy(r);
+    if (f) {
+        fclose(f);
+    }
+    ESP_LOGI(TAG, "file playback of %s finished", file_path);
+    file_playing = false;
+    file_task = NULL;
+    xSemaphoreGive(file_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 从 start_ms 开始播放Ogg-Opus文件
+ * @param path     文件路径
+ * @param start_ms 起始位置（毫秒）
+ * @return 成功返回0，未运行、已在播放文件或路径过长返回-1
+ */
+int opus_decode_play_file_start(const char *path, uint32_t start_ms)
+{
+    if (!path || !decoder_el || file_task) return -1;
+    if (strlen(path) + sizeof(".idx") > sizeof(file_path)) return -1;
+    strcpy(file_path, path);
+    file_start_ms = start_ms;
+    if (!file_done) {
+        file_done = xSemaphoreCreateBinaryStatic(&file_done_buf);
+    }
+    xSemaphoreTake(file_done, 0);   // 清掉上次自然结束时留下的信号
+    file_playing = true;
+    const audio_latency_profile_t *profile = audio_latency_get_profile();
+    if (xTaskCreatePinnedToCore(opus_decode_play_file_task, "play_file", FILE_TASK_STACK, NULL,
+                                profile->task_prio - 1, &file_task, profile->playback_core) != pdPASS) {
+        file_playing = false;
+        file_task = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 停止文件播放，等文件播放任务退出后返回（已送入的包照常播完）
+ */
+void opus_decode_play_file_stop(void)
+{
+    if (!file_task) return;
+    file_playing = false;
+    while (file_task) {
+        if (xSemaphoreTake(file_done, pdMS_TO_TICKS(FILE_JOIN_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "waiting for file playback task to exit");
+        }
+    }
+}
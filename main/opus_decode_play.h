@@ -5,7 +5,7 @@
  * @lastEditTime 2025-06-05 08:47:43
  * @lastEditors 星年
  * @brief Opus解码播放模块头文件
- * @details 提供Opus解码播放相关的API声明，包括启动、停止解码播放任务，以及向解码器写入Opus数据的接口。
+ * @details 提供Opus解码播放相关的API声明，包括启动、停止解码播放任务，以及向解码器写入Opus包的接口（含零拷贝接口）。
  * @filePath \audio_manager\main\opus_decode_play.h
  * @note 遇事不决，可问春风
  */
@@ -13,39 +13,223 @@
 
 #include <stdint.h>   // 用于uint8_t等标准整型定义
 #include <stddef.h>   // 用于size_t类型定义
+#include <stdbool.h>  // 用于bool类型定义
+#include "opus_packet_slab.h"
+#include "jitter_buffer.h"
+#include "opus_mixer.h"
+#include "drift_asrc.h"
+#include "audio_latency.h"
+#include "audio_lifecycle.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define OPUS_DECODE_PLAY_MAX_STREAMS 4  // 同时播放的最大说话人路数（每路约一个libopus解码器状态的片内SRAM）
+
 /**
- * @brief 启动Opus解码播放任务
+ * @brief 启动Opus解码播放
  * 
- * 该函数会创建并启动一个后台任务，负责从内部缓冲区读取Opus数据，进行解码并通过I2S等音频外设播放PCM音频。
- * 通常在系统初始化或需要开始播放Opus流时调用。
+ * 首次调用时构建解码播放管道，负责从内部缓冲区读取Opus数据，进行解码并通过I2S等音频外设播放PCM音频。
+ * 停止之后再次启动只恢复已暂停的管道（先丢弃积压的包并复位抖动缓冲与解码器），不创建任务、不分配内存。
  */
 void opus_decode_play_start(void);
 
 /**
- * @brief 停止Opus解码播放任务
+ * @brief 停止Opus解码播放
  * 
- * 该函数会安全地终止解码播放任务，释放相关资源。调用后将不再播放新的Opus数据。
- * 通常在需要关闭音频输出或系统退出时调用。
+ * 先停止文件播放（若在播放），再暂停解码播放管道，等各元素确认暂停后返回，调用后将不再播放新的Opus数据。
+ * 管道、解码器与I2S驱动保留，I2S在暂停期间输出静音；彻底释放请调用 opus_decode_play_deinit()。
  */
 void opus_decode_play_stop(void);
 
 /**
- * @brief 向Opus解码播放模块写入Opus编码数据
+ * @brief 释放解码播放管道与各元素
+ *
+ * 运行或暂停状态均可调用；之后再次 opus_decode_play_start() 会重新构建。
+ * 接入全双工引擎时须在引擎停止之前调用。
+ */
+void opus_decode_play_deinit(void);
+
+/**
+ * @brief 获取解码播放管道的启停统计：构建/启动/停止次数与耗时、启动到首帧解码的耗时
+ *
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int opus_decode_play_get_lifecycle(audio_lifecycle_stats_t *stats);
+
+/**
+ * @brief 获取一个空闲包槽用于写入Opus包（零拷贝，不阻塞）
+ *
+ * @param pkt 输出参数，指向内部slab中的空闲包槽，容量为 pkt->cap 字节
+ * @return 成功返回0，未运行或slab已满返回-1
+ *
+ * 上层可直接将网络数据接收到 pkt->data，填好 len/seq/timestamp 后调用
+ * opus_decode_play_commit() 提交，解码任务会将包移入抖动缓冲重排后解码。
+ */
+int opus_decode_play_acquire(opus_packet_t **pkt);
+
+/**
+ * @brief 提交由 opus_decode_play_acquire() 获取并已填好的包
+ *
+ * @param pkt 待提交的包
+ */
+void opus_decode_play_commit(opus_packet_t *pkt);
+
+/**
+ * @brief 向Opus解码播放模块写入一个完整的Opus包
  * 
- * @param data 指向Opus编码数据的指针
- * @param len  数据长度（字节数）
- * @return int 实际写入的字节数，或负值表示错误
+ * @param data 指向Opus包数据的指针
+ * @param len  包长度（字节数）
+ * @return int 实际写入的字节数，或负值表示错误（未运行、缓冲已满或包过长）
  * 
- * 该函数将Opus编码数据写入内部缓冲区，供后台解码播放任务消费。
- * 可用于实时流式推送Opus数据（如网络接收、文件读取等）。
+ * 兼容接口，每次调用写入一个完整的包并拷贝一次，序号自动递增；
+ * 对性能敏感的调用者应直接使用 opus_decode_play_acquire()/opus_decode_play_commit()。
  */
 int opus_decode_play_write(const uint8_t *data, size_t len);
 
+/**
+ * @brief 一次写入多个完整的Opus包（不阻塞）
+ *
+ * 与逐包调用 opus_decode_play_write() 等价（每包拷贝一次、序号自动递增），
+ * 但空闲包槽只取一次、提交只推进一次下标并只唤醒一次解码任务，适合网络任务一次收到多个包时使用。
+ *
+ * @param data  各包数据指针
+ * @param len   各包长度（字节数）
+ * @param count 包数
+ * @return 实际写入的包数，slab已满或遇到过长的包时提前停止（其后的包未写入）；未运行返回-1
+ */
+int opus_decode_play_write_batch(const uint8_t *const *data, const size_t *len, int count);
+
+/**
+ * @brief 设置包slab的水位通知，网络任务可据此暂缓或恢复收包，而不必阻塞在写入上
+ *
+ * 未提交的包数升到 high 时在写入方任务中回调 cb(ctx, true)，被解码取走后回落到 low 时
+ * 在解码任务中回调 cb(ctx, false)；回调须非常短且不阻塞。建议在 opus_decode_play_start() 之前设置，
+ * 设置一次对之后的每次启动都生效。
+ *
+ * @param high 高水位（包，不超过16），0 为关闭通知
+ * @param low  低水位（包），须小于 high
+ * @param cb   回调
+ * @param ctx  回调上下文
+ */
+void opus_decode_play_set_watermarks(uint32_t high, uint32_t low, opus_packet_slab_watermark_t cb, void *ctx);
+
+/**
+ * @brief 声明上层写入的包为冗余封装（opus_red.h 格式，发送端 red_depth > 0）
+ *
+ * 解码前拆出主负载，丢包时先用后续包携带的副本补上，再退到FEC与PLC。须在首次
+ * opus_decode_play_start() 之前（或 deinit 之后）调用；抖动缓冲最小深度须不小于
+ * (冗余深度 + 1) 帧，否则副本到达时已过播放点。
+ *
+ * @param enable 是否启用
+ * @return 成功返回0，解码管道已构建返回-1
+ */
+int opus_decode_play_set_red(bool enable);
+
+/**
+ * @brief 声明发送端启用了带内FEC（opus_encode_layer_cfg_t / opus_rate_params_t 的 fec）
+ *
+ * 启用后缺包而下一包已到时从下一包中取FEC数据恢复，否则缺包一律做PLC，统计中的 fec 也不会虚增。
+ * 须在首次 opus_decode_play_start() 之前（或 deinit 之后）调用。
+ *
+ * @param enable 是否启用
+ * @return 成功返回0，解码管道已构建返回-1
+ */
+int opus_decode_play_set_fec(bool enable);
+
+/**
+ * @brief 获取第0路的抖动缓冲统计
+ *
+ * @param stats 输出统计：当前/目标缓冲深度、到达抖动、迟到包数、FEC恢复与PLC隐藏帧数等
+ * @return 成功返回0，未运行返回-1
+ *
+ * 隐藏率 = (fec + plc) / (played + fec + plc)。
+ */
+int opus_decode_play_get_stats(jitter_buffer_stats_t *stats);
+
+/**
+ * @brief 获取时钟漂移补偿统计
+ *
+ * 播放管道的解码输出经 drift_asrc 按第0路抖动缓冲水位微调比值，抵消发送端与本地I2S的时钟偏差。
+ *
+ * @param stats 输出统计：drift_ppb 为估计的发送端时钟偏差（正为发送端偏快），ratio_ppb 为当前比值，
+ *              error_us 为平滑后的水位误差
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_decode_play_get_drift_stats(drift_asrc_stats_t *stats);
+
+/**
+ * @brief 打开一路说话人（多路会议播放）
+ *
+ * 每路独立抖动缓冲、FEC/PLC与解码器状态，逐帧按路增益饱和混音后写入同一个I2S输出。
+ * 第0路在启动时已打开，供 opus_decode_play_acquire()/opus_decode_play_write() 使用，不经本接口。
+ * 路句柄在 opus_decode_play_deinit() 后失效，重新启动后须重新打开。
+ *
+ * @param gain 增益（Q15，AUDIO_MIX_UNITY 为0dB）
+ * @return 路句柄，未运行或已无空闲路返回NULL
+ */
+opus_mixer_stream_t *opus_decode_play_stream_open(uint16_t gain);
+
+/**
+ * @brief 关闭一路说话人，之后发往该路的包被丢弃，下一帧起不再混入
+ */
+void opus_decode_play_stream_close(opus_mixer_stream_t *stream);
+
+/**
+ * @brief 为指定路获取一个空闲包槽（零拷贝，不阻塞）
+ *
+ * 包槽已标记所属路，填好 len/seq/timestamp 后调用 opus_decode_play_commit() 提交。
+ * 包slab为单生产者：所有路的包（含第0路）须由同一个任务写入。
+ *
+ * @param stream 路句柄
+ * @param pkt    输出参数，指向内部slab中的空闲包槽
+ * @return 成功返回0，未运行或slab已满返回-1
+ */
+int opus_decode_play_stream_acquire(opus_mixer_stream_t *stream, opus_packet_t **pkt);
+
+/**
+ * @brief 设置一路的增益（下一帧生效）
+ *
+ * @param stream 路句柄
+ * @param gain   增益（Q15，0 ~ AUDIO_MIX_UNITY）；为0时该路只收包不解码
+ */
+void opus_decode_play_stream_set_gain(opus_mixer_stream_t *stream, uint16_t gain);
+
+/**
+ * @brief 获取一路的统计：解码/跳过帧数、是否处于DTX、抖动缓冲统计
+ *
+ * @return 成功返回0，未运行或参数无效返回-1
+ */
+int opus_decode_play_stream_get_stats(opus_mixer_stream_t *stream, opus_mixer_stream_stats_t *stats);
+
+/**
+ * @brief 统计播放链路当前的按级缓冲延迟
+ *
+ * @param report 输出报告：未处理的包、抖动缓冲深度、解码帧长、解码输出环形缓冲区、I2S DMA
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_decode_play_get_latency(audio_latency_report_t *report);
+
+/**
+ * @brief 从 start_ms 开始播放 opus_encode_recorder_save_start() 录制的Ogg-Opus文件
+ *
+ * 后台任务按存储块读取并解封装，有 path.idx 索引时直接跳到目标附近的页，否则从头扫描；
+ * 包按文件中的时间戳节拍送入第0路（提前约200ms），DTX空帧照常送入由解码端输出静音。
+ * 播放文件期间该任务是包slab唯一的生产者，调用者不得同时写入；文件的帧长须与当前延迟档位一致。
+ *
+ * @param path     文件路径
+ * @param start_ms 起始位置（毫秒，已扣除 pre-skip）
+ * @return 成功返回0，未运行、已在播放文件或路径过长返回-1
+ */
+int opus_decode_play_file_start(const char *path, uint32_t start_ms);
+
+/**
+ * @brief 停止文件播放，等文件播放任务退出后返回（已送入的包照常播完）
+ */
+void opus_decode_play_file_stop(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -3,224 +3,1571 @@
  * @Date: 2025-06-05 08:35:56
  * @LastEditTime: 2025-06-05 20:35:19
  * @LastEditors: 星年 && j_xingnian@163.com
- * @Description: Opus编码录制模块实现，负责采集I2S音频、重采样、编码并输出Opus数据
+ * @Description: Opus编码录制模块实现，订阅共享采集前端的PCM、按层（同播）编码并输出Opus数据
  * @FilePath: \audio_manager\main\opus_encode_recorder.c
  * 遇事不决，可问春风
  */
+#include <stdio.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "audio_element.h"
 #include "audio_pipeline.h"
-#include "audio_event_iface.h"
 #include "audio_mem.h"
 #include "audio_common.h"
-#include "i2s_stream.h"
-#include "opus_encoder.h"
-#include "filter_resample.h"
-#include "raw_stream.h"
+#include "freertos/semphr.h"
+#include "audio_capture.h"
+#include "opus_packet_codec.h"
+#include "audio_lifecycle.h"
+#include "audio_arena.h"
+#include "opus.h"
+#include "ogg_opus.h"
+#include "audio_graph.h"
+#include "audio_ns.h"
+#include "esp_timer.h"
 #include "opus_encode_recorder.h"
 
 #define OPUS_RECORDER_TAG "OPUS_ENCODE_RECORDER"                // 日志TAG
-#define OPUS_RECORDER_RAW_BUF_SIZE (8 * 1024)                   // raw_stream缓冲区大小（字节）
-#define OPUS_RECORDER_TASK_STACK (4 * 1024)                     // 录制任务堆栈大小
-#define OPUS_RECORDER_TASK_PRIO 5                               // 录制任务优先级
+#define OPUS_RECORDER_SLOT_COUNT 16                             // 每层包槽数量
+#define OPUS_RECORDER_SLOT_SIZE 512                             // 每个包槽容量（字节），每层总计8KB
+#define OPUS_RECORDER_ARENA_SRAM (5 * 1024)                     // 每层片内预算：包槽描述、最长60ms帧缓冲、VAD、参数自适应（另加libopus编码器状态）
+#define OPUS_RECORDER_SAVE_STACK (4 * 1024)                     // 保存任务堆栈（文件系统调用）
+#define OPUS_RECORDER_SAVE_WAIT_MS 100                          // 保存任务等包超时，决定停止保存的响应时间
+#define OPUS_RECORDER_SAVE_PATH_MAX 96                          // 保存路径最大长度（含 ".idx" 后缀）
+#define OPUS_RECORDER_GRAPH_WAIT_MS (AUDIO_CAPTURE_BLOCK_MS * 2)  // 处理图任务等块超时（暂停时由 audio_capture_wake() 提前唤醒）
+#define OPUS_RECORDER_GRAPH_ACK_MS 100                          // 处理图任务确认暂停/退出的等待上限
+#define OPUS_RECORDER_SAVE_JOIN_MS 1000                         // 等保存任务写完结束页与索引并退出，超时只告警继续等
+#define OPUS_RECORDER_NAME_LEN 16                               // 层内元素/节点名长度
+#define OPUS_RECORDER_PREROLL_MAX_MS 30000                      // 预录历史时长上限（毫秒）
+#define OPUS_RECORDER_FEC_LOSS_PCT 10                           // 开启带内FEC时的初始预期丢包率（%），自适应随后按反馈调整
 
-static TaskHandle_t s_opus_encode_task_handle = NULL;           // 录制任务句柄
-static audio_pipeline_handle_t s_pipeline = NULL;               // 音频管道句柄
-static audio_element_handle_t s_raw_writer = NULL;              // raw_stream元素句柄（用于输出Opus编码数据）
+/**
+ * @brief 一路编码层：独立的编码器、包slab与取包信号
+ *
+ * ADF 引擎下每层另有各自的采集订阅、读取元素与管道；处理图引擎下所有层共用第0层的采集订阅，
+ * 在同一个任务内按指针读同一个采集块依次编码。采集、格式转换与重采样在共享采集前端只做一次。
+ */
+struct opus_encode_layer {
+    bool used;                                  // 已添加
+    uint8_t index;                              // 层号（0为默认层）
+    opus_encode_layer_cfg_t cfg;                // 层配置
+    char opus_name[OPUS_RECORDER_NAME_LEN];     // 编码元素/节点名（探针名）
+    char capture_name[OPUS_RECORDER_NAME_LEN];  // 读取元素名
+    char ns_name[OPUS_RECORDER_NAME_LEN];       // 降噪元素名
+    opus_packet_slab_t *slab;                   // Opus包slab（编码器直接写入，调用者直接读取；预录层为NULL）
+    uint32_t preroll_ms;                        // 预录历史时长（毫秒），0 为普通层
+    opus_preroll_t *preroll;                    // 预录环（预录层取代slab，触发后才可取包）
+    SemaphoreHandle_t pkt_sem;                  // 新包到达信号
+    atomic_bool closing;                        // 正在释放：等包的读取者醒来后立即返回
+    atomic_int readers;                         // 正在取包的调用者数（释放前须等其离开）
+    atomic_uint read_dropped;                   // 兼容读取接口因缓冲区不足丢弃的包数
+    audio_capture_client_t *capture;            // 共享采集订阅（处理图引擎下只有第0层持有）
+    audio_element_handle_t reader_el;           // 采集读取元素（仅ADF引擎）
+    audio_element_handle_t ns_el;               // 降噪元素（仅ADF引擎且启用降噪）
+    audio_element_handle_t encoder_el;          // Opus编码器元素（处理图引擎下只作编码器状态与统计的容器）
+    audio_pipeline_handle_t pipeline;           // 音频管道（仅ADF引擎）
+    uint32_t wm_high;                           // 包slab高水位（0为不通知）
+    uint32_t wm_low;                            // 包slab低水位
+    opus_packet_slab_watermark_t wm_cb;         // 水位回调
+    void *wm_ctx;                               // 水位回调上下文
+};
+
+static audio_lifecycle_t s_lifecycle = AUDIO_LIFECYCLE_INIT();  // 录制生命周期（首次启动时构建，停止只暂停；所有层一起启停）
+static opus_encode_layer_t s_layers[OPUS_RECORDER_MAX_LAYERS] = {
+    [0] = {.used = true, .cfg = DEFAULT_OPUS_ENCODE_LAYER_CONFIG(), .opus_name = "rec_opus", .capture_name = "rec_capture",
+         .ns_name = "rec_ns"},
+};                                                              // 编码层（第0层即默认录制，由不带句柄的接口使用）
+static audio_arena_t *s_arena = NULL;                           // 录制内存区（首次构建时预留，deinit 后保留供重建复用）
+static TaskHandle_t s_save_task = NULL;                         // 保存任务（保存期间独占第0层slab的消费端）
+static volatile bool s_saving = false;                          // 保存任务运行标志
+static FILE *s_save_file = NULL;                                // 保存中的录音文件
+static char s_save_path[OPUS_RECORDER_SAVE_PATH_MAX];           // 保存文件路径
+static ogg_opus_writer_stats_t s_save_stats;                    // 最近一次保存的封装统计（保存任务逐包更新）
+static audio_engine_t s_engine = AUDIO_ENGINE_ADF;              // 下次构建时使用的执行引擎
+static audio_graph_t *s_graph = NULL;                           // 处理图（以处理图运行时非NULL）
+static TaskHandle_t s_graph_task = NULL;                        // 处理图任务：取块 -> 各层编码，替代读取与编码元素任务
+static volatile bool s_graph_running = false;                   // 处理图任务运行标志
+static volatile bool s_graph_paused = false;                    // 暂停请求
+static portMUX_TYPE s_sync_mux = portMUX_INITIALIZER_UNLOCKED;
+static StaticSemaphore_t s_graph_ack_buf;
+static SemaphoreHandle_t s_graph_ack = NULL;                    // 处理图任务已确认暂停或已退出（二值信号量）
+static StaticSemaphore_t s_save_done_buf;
+static SemaphoreHandle_t s_save_done = NULL;                    // 保存任务已退出（二值信号量）
+static StaticSemaphore_t s_reader_left_buf;
+static SemaphoreHandle_t s_reader_left = NULL;                  // 释放中的层有读取者离开（二值信号量）
+static bool s_ns_enabled = false;                               // 编码前降噪（下次构建时生效）
+static noise_suppress_cfg_t s_ns_cfg = DEFAULT_NOISE_SUPPRESS_CONFIG();  // 降噪强度与耗时预算
+static noise_suppress_t *s_ns = NULL;                           // 处理图引擎下各层共用的降噪器（ADF引擎下每层一个降噪元素）
 
-static volatile bool s_task_running = false;                    // 任务运行标志
+#define OPUS_RECORDER_DEFAULT (&s_layers[0])
 
 /**
- * @brief Opus编码录制任务
- *
- * 该任务负责初始化音频管道，采集I2S音频数据，重采样，Opus编码，并输出到raw_stream。
- * 任务启动后会持续运行，直到s_task_running被置为false。
- */
-static void opus_encode_recorder_task(void *arg)
-{
-    audio_element_handle_t i2s_stream_reader = NULL;    // I2S输入流元素
-    audio_element_handle_t opus_encoder = NULL;         // Opus编码器元素
-    audio_element_handle_t filter = NULL;               // 重采样滤波器元素
-
-    // 1. 配置I2S输入流参数
-    i2s_stream_cfg_t i2s_cfg = I2S_STREAM_CFG_DEFAULT();
-    i2s_cfg.type = AUDIO_STREAM_READER;                        // 作为reader采集音频
-    i2s_cfg.transmit_mode = I2S_COMM_MODE_STD;                 // 标准I2S模式
-    i2s_cfg.chan_cfg.id = I2S_NUM_0;                           // I2S通道0
-    i2s_cfg.chan_cfg.role = I2S_ROLE_MASTER;                   // 主模式
-    // i2s_cfg.chan_cfg.dma_desc_num = 3;                         // DMA描述符数量
-    // i2s_cfg.chan_cfg.dma_frame_num = 300;                      // DMA帧数
-    // i2s_cfg.chan_cfg.auto_clear = false;                       // 不自动清除
-    i2s_cfg.std_cfg.clk_cfg.sample_rate_hz = 44100;            // 输入采样率44.1kHz
-    // i2s_cfg.std_cfg.clk_cfg.clk_src = I2S_CLK_SRC_DEFAULT;     // 默认时钟源
-    // i2s_cfg.std_cfg.clk_cfg.mclk_multiple = I2S_MCLK_MULTIPLE_256; // MCLK倍频
-    i2s_cfg.std_cfg.slot_cfg.data_bit_width = I2S_DATA_BIT_WIDTH_24BIT; // 24位数据宽度
-    // i2s_cfg.std_cfg.slot_cfg.slot_bit_width = I2S_SLOT_BIT_WIDTH_AUTO;  // 自动槽宽
-    i2s_cfg.std_cfg.slot_cfg.slot_mode = I2S_SLOT_MODE_MONO;            // 单声道
-    i2s_cfg.std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;             // 左声道
-    i2s_cfg.std_cfg.slot_cfg.ws_width = 24;                             // WS宽度
-    // i2s_cfg.std_cfg.slot_cfg.ws_pol = false;                            // WS极性
-    // i2s_cfg.std_cfg.slot_cfg.bit_shift = true;                          // 位移
-    i2s_cfg.std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;                    // 未用MCLK
-    i2s_cfg.std_cfg.gpio_cfg.bclk = 41;                                 // BCLK引脚
-    i2s_cfg.std_cfg.gpio_cfg.ws = 42;                                   // WS引脚
-    i2s_cfg.std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;                   // 未用DOUT
-    i2s_cfg.std_cfg.gpio_cfg.din = 2;                                  // DIN引脚
-    // i2s_cfg.std_cfg.gpio_cfg.invert_flags.mclk_inv = false;            // 不反转MCLK
-    // i2s_cfg.std_cfg.gpio_cfg.invert_flags.bclk_inv = false;            // 不反转BCLK
-    // i2s_cfg.use_alc = false;                                           // 不使用ALC
-    i2s_cfg.volume = 80;                                                // 默认音量
-    i2s_cfg.out_rb_size = I2S_STREAM_RINGBUFFER_SIZE;                  // 输出环形缓冲区大小
-    i2s_cfg.task_stack = I2S_STREAM_TASK_STACK;                        // 任务堆栈
-    // i2s_cfg.task_core = I2S_STREAM_TASK_CORE;                          // 任务绑定核心
-    // i2s_cfg.task_prio = I2S_STREAM_TASK_PRIO;                          // 任务优先级
-    // i2s_cfg.stack_in_ext = false;                                      // 堆栈不在外部RAM
-    // i2s_cfg.multi_out_num = 0;                                         // 不使用多路输出
-    // i2s_cfg.uninstall_drv = true;                                      // 任务结束时卸载驱动
-    // i2s_cfg.need_expand = false;                                       // 不需要扩展
-    // i2s_cfg.expand_src_bits = I2S_DATA_BIT_WIDTH_24BIT;                // 扩展源位宽
-    // i2s_cfg.buffer_len = I2S_STREAM_BUF_SIZE;                          // 缓冲区长度
-
-    // 2. 创建音频管道
-    audio_pipeline_cfg_t pipeline_cfg = DEFAULT_AUDIO_PIPELINE_CONFIG();
-    s_pipeline = audio_pipeline_init(&pipeline_cfg);                   // 初始化音频管道
-    mem_assert(s_pipeline);                                            // 断言管道创建成功
-
-    // 3. 创建Opus编码器元素
-    opus_encoder_cfg_t opus_cfg = DEFAULT_OPUS_ENCODER_CONFIG();
-    // opus_cfg.sample_rate = 44100;                                      // 输入采样率
-    // opus_cfg.channel = 1;                                              // 单声道
-    // opus_cfg.bitrate = 64000;                                          // 目标比特率
-    // opus_cfg.complexity = 10;                                          // 编码复杂度
-    opus_encoder = encoder_opus_init(&opus_cfg);                       // 初始化Opus编码器
-    if (!opus_encoder) {
-        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to create OPUS encoder");  // 创建失败日志
-        goto _exit;                                                    // 跳转退出
+ * @brief 创建任务握手用的信号量（静态内存，首次使用时创建）
+ */
+static void opus_encode_recorder_sync_init(void)
+{
+    if (s_save_done) {
+        return;
+    }
+    portENTER_CRITICAL(&s_sync_mux);
+    if (!s_save_done) {
+        s_graph_ack = xSemaphoreCreateBinaryStatic(&s_graph_ack_buf);
+        s_save_done = xSemaphoreCreateBinaryStatic(&s_save_done_buf);
+        s_reader_left = xSemaphoreCreateBinaryStatic(&s_reader_left_buf);
+    }
+    portEXIT_CRITICAL(&s_sync_mux);
+}
+
+/**
+ * @brief 该层的包队列是否已创建（slab或预录环）
+ */
+static bool opus_encode_recorder_built(const opus_encode_layer_t *layer)
+{
+    return layer && (layer->slab || layer->preroll);
+}
+
+/**
+ * @brief 不等待地取出一层的下一个包（预录层未触发时没有包）
+ */
+static const opus_packet_t *opus_encode_recorder_peek(opus_encode_layer_t *layer)
+{
+    if (layer->preroll) {
+        return opus_preroll_acquire_read(layer->preroll);
     }
+    return opus_packet_slab_acquire_read(layer->slab);
+}
 
-    // 4. 创建重采样滤波器（将44.1kHz重采样为16kHz，单声道）
-    rsp_filter_cfg_t rsp_cfg = DEFAULT_RESAMPLE_FILTER_CONFIG();
-    rsp_cfg.src_rate = 44100;                                          // 输入采样率
-    rsp_cfg.src_ch = 1;                                                // 输入通道
-    rsp_cfg.dest_rate = 16000;                                         // 输出采样率
-    rsp_cfg.dest_ch = 1;                                               // 输出通道
-    filter = rsp_filter_init(&rsp_cfg);                                // 初始化重采样滤波器
+/**
+ * @brief 归还由 opus_encode_recorder_peek() 取出的包
+ */
+static void opus_encode_recorder_put(opus_encode_layer_t *layer, const opus_packet_t *pkt)
+{
+    if (layer->preroll) {
+        opus_preroll_release(layer->preroll, pkt);
+    } else {
+        opus_packet_slab_release(layer->slab, pkt);
+    }
+}
 
-    // 5. 创建raw_stream元素用于输出Opus编码数据
-    raw_stream_cfg_t raw_cfg = {
-        .type = AUDIO_STREAM_WRITER,                                   // 作为writer输出数据
-        .out_rb_size = OPUS_RECORDER_RAW_BUF_SIZE,                     // 环形缓冲区大小
-    };
-    s_raw_writer = raw_stream_init(&raw_cfg);                          // 初始化raw_stream
+/**
+ * @brief slab提交新包时的通知回调，唤醒等待中的读取者
+ */
+static void opus_encode_recorder_notify(void *ctx)
+{
+    xSemaphoreGive((SemaphoreHandle_t)ctx);
+}
+
+/**
+ * @brief 等待并取出一层的下一个包（每层slab只有一个消费端：调用者或保存任务）
+ */
+static int opus_encode_recorder_take(opus_encode_layer_t *layer, const opus_packet_t **pkt, TickType_t ticks)
+{
+    const opus_packet_t *p = opus_encode_recorder_peek(layer);
+    while (!p) {
+        if (atomic_load(&layer->closing)) {
+            return -1;  // 层正在释放
+        }
+        if (xSemaphoreTake(layer->pkt_sem, ticks) != pdTRUE) {
+            return -1;  // 超时
+        }
+        p = opus_encode_recorder_peek(layer);
+    }
+    *pkt = p;
+    return 0;
+}
+
+/**
+ * @brief 丢弃一层slab中未取走的包（仅在编码暂停时调用；预录层连同历史一起清空并解除触发）
+ */
+static void opus_encode_recorder_drain(opus_encode_layer_t *layer)
+{
+    if (layer->preroll) {
+        opus_preroll_reset(layer->preroll);
+        xSemaphoreTake(layer->pkt_sem, 0);
+        return;
+    }
+    const opus_packet_t *pkt;
+    while ((pkt = opus_packet_slab_acquire_read(layer->slab)) != NULL) {
+        opus_packet_slab_release(layer->slab, pkt);
+    }
+    xSemaphoreTake(layer->pkt_sem, 0);
+}
+
+/**
+ * @brief 该层是否可以取包：已构建，且第0层未被保存任务独占
+ */
+static bool opus_encode_recorder_readable(const opus_encode_layer_t *layer)
+{
+    return opus_encode_recorder_built(layer) && !(layer == OPUS_RECORDER_DEFAULT && s_save_task);
+}
+
+/**
+ * @brief 调用者开始取包：登记为读取者，层不可读或正在释放时返回false（无需再离开）
+ */
+static bool opus_encode_recorder_reader_enter(opus_encode_layer_t *layer)
+{
+    if (!layer) return false;
+    atomic_fetch_add(&layer->readers, 1);
+    if (atomic_load(&layer->closing) || !opus_encode_recorder_readable(layer)) {
+        atomic_fetch_sub(&layer->readers, 1);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 调用者取包结束，层正在释放时通知等待中的释放方
+ */
+static void opus_encode_recorder_reader_leave(opus_encode_layer_t *layer)
+{
+    atomic_fetch_sub(&layer->readers, 1);
+    if (atomic_load(&layer->closing)) {
+        xSemaphoreGive(s_reader_left);
+    }
+}
+
+/**
+ * @brief 把取出的包拷贝到调用者缓冲区并归还；缓冲区不足时丢弃该包并计数，避免它一直堵在队头
+ * @return 包长度，缓冲区不足返回-1
+ */
+static int opus_encode_recorder_copy_out(opus_encode_layer_t *layer, const opus_packet_t *pkt, uint8_t *data, size_t len)
+{
+    int n = pkt->len;
+    if (pkt->len > len) {
+        ESP_LOGW(OPUS_RECORDER_TAG, "read buffer too small: %u < %u, packet dropped", (unsigned)len, (unsigned)pkt->len);
+        atomic_fetch_add(&layer->read_dropped, 1);
+        n = -1;
+    } else {
+        memcpy(data, pkt->data, n);
+    }
+    opus_encode_recorder_put(layer, pkt);
+    return n;
+}
+
+/**
+ * @brief 唤醒仍在等包的读取者并等其全部离开，之后才可释放slab与取包信号
+ */
+static void opus_encode_recorder_close_readers(opus_encode_layer_t *layer)
+{
+    if (!layer->pkt_sem) return;
+    opus_encode_recorder_sync_init();
+    xSemaphoreTake(s_reader_left, 0);
+    atomic_store(&layer->closing, true);
+    while (atomic_load(&layer->readers) > 0) {
+        xSemaphoreGive(layer->pkt_sem);
+        if (xSemaphoreTake(s_reader_left, pdMS_TO_TICKS(OPUS_RECORDER_GRAPH_ACK_MS)) != pdTRUE) {
+            ESP_LOGW(OPUS_RECORDER_TAG, "%s: waiting for packet readers to leave", layer->opus_name);
+        }
+    }
+}
+
+/**
+ * @brief 释放一层的管道、元素、采集订阅与包slab
+ */
+static void opus_encode_recorder_layer_teardown(opus_encode_layer_t *layer)
+{
+    if (layer->pipeline) {
+        audio_pipeline_stop(layer->pipeline);                         // 停止管道
+        audio_pipeline_wait_for_stop(layer->pipeline);                // 等待管道完全停止
+        audio_pipeline_terminate(layer->pipeline);                    // 终止管道
+        if (layer->reader_el) {
+            audio_pipeline_unregister(layer->pipeline, layer->reader_el);
+        }
+        if (layer->ns_el) {
+            audio_pipeline_unregister(layer->pipeline, layer->ns_el);
+        }
+        if (layer->encoder_el) {
+            audio_pipeline_unregister(layer->pipeline, layer->encoder_el);
+        }
+        audio_lifecycle_unlisten(layer->pipeline);                    // 从共用监听任务上摘下
+        audio_pipeline_deinit(layer->pipeline);
+        layer->pipeline = NULL;
+    }
+    if (layer->reader_el) {
+        audio_element_deinit(layer->reader_el);
+        layer->reader_el = NULL;
+    }
+    if (layer->ns_el) {
+        audio_element_deinit(layer->ns_el);
+        layer->ns_el = NULL;
+    }
+    if (layer->encoder_el) {
+        audio_element_deinit(layer->encoder_el);
+        layer->encoder_el = NULL;
+    }
+    if (layer->capture) {
+        // 取消订阅，若为最后一个订阅者则采集前端随之停止
+        audio_capture_unsubscribe(layer->capture);
+        layer->capture = NULL;
+    }
+    opus_encode_recorder_close_readers(layer);
+    opus_packet_slab_destroy(layer->slab);
+    layer->slab = NULL;
+    opus_preroll_destroy(layer->preroll);
+    layer->preroll = NULL;
+    if (layer->pkt_sem) {
+        vSemaphoreDelete(layer->pkt_sem);
+        layer->pkt_sem = NULL;
+    }
+}
+
+/**
+ * @brief 释放全部层与处理图（管道须处于运行状态或尚未运行）
+ */
+static void opus_encode_recorder_teardown(void)
+{
+    if (s_graph) {
+        s_graph_running = false;
+        if (s_graph_task) {
+            audio_capture_wake(OPUS_RECORDER_DEFAULT->capture);
+            xTaskNotifyGive(s_graph_task);
+        }
+        // 任务退出前给出确认；暂停确认迟到时会多取到一次，以任务句柄清空为准
+        while (s_graph_task) {
+            if (xSemaphoreTake(s_graph_ack, pdMS_TO_TICKS(OPUS_RECORDER_GRAPH_ACK_MS)) != pdTRUE) {
+                ESP_LOGW(OPUS_RECORDER_TAG, "waiting for graph task to exit");
+            }
+        }
+        for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+            opus_pkt_encoder_sync_close(s_layers[i].encoder_el);
+        }
+        audio_graph_destroy(s_graph);
+        s_graph = NULL;
+        noise_suppress_destroy(s_ns);
+        s_ns = NULL;
+    }
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        opus_encode_recorder_layer_teardown(&s_layers[i]);
+    }
+    audio_arena_reset(s_arena);
+}
+
+/* ------------------------------------------------------------------ */
+/* 处理图引擎：一个任务取采集块，各层编码节点按指针读同一块             */
+/* ------------------------------------------------------------------ */
+
+static uint32_t _opus_encode_recorder_clock(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+/**
+ * @brief 一个采集块的样点数：取延迟档位的帧长，不超过最长块
+ */
+static uint32_t opus_encode_recorder_block_samples(void)
+{
+    uint32_t n = (uint32_t)audio_latency_frame_samples(AUDIO_CAPTURE_SAMPLE_RATE);
+    return n > AUDIO_CAPTURE_BLOCK_SAMPLES ? AUDIO_CAPTURE_BLOCK_SAMPLES : n;
+}
+
+/**
+ * @brief 按当前设置生成降噪配置：每次处理一个采集块，内存取自录制内存区
+ */
+static void opus_encode_recorder_ns_cfg(noise_suppress_cfg_t *cfg)
+{
+    *cfg = s_ns_cfg;
+    cfg->frame_samples = opus_encode_recorder_block_samples();
+    cfg->clock_us = _opus_encode_recorder_clock;
+    cfg->arena = s_arena;
+}
+
+/**
+ * @brief 降噪节点：采集块只读，降噪结果写入工作缓冲，之后各层编码读同一份降噪后的数据
+ */
+static size_t _opus_encode_recorder_ns(void *ctx, const void *in, size_t n, void *out)
+{
+    noise_suppress_t *ns = (noise_suppress_t *)ctx;
+    if (noise_suppress_process(ns, (const int16_t *)in, (int16_t *)out, n) != 0) {
+        // 构建时已校验块长，走到这里说明采集块长在运行中变了：直通不中断编码，计数见 frame_errors，只在首次告警
+        noise_suppress_stats_t stats;
+        noise_suppress_get_stats(ns, &stats);
+        if (stats.frame_errors == 1) {
+            ESP_LOGW(OPUS_RECORDER_TAG, "Noise suppress bypassed: block %u samples, expected %u",
+                     (unsigned)n, (unsigned)opus_encode_recorder_block_samples());
+        }
+        memcpy(out, in, n * sizeof(int16_t));
+    }
+    return n;
+}
+
+static size_t _opus_encode_recorder_encode(void *ctx, const void *in, size_t n, void *out)
+{
+    (void)out;
+    opus_pkt_encoder_sync_feed((audio_element_handle_t)ctx, (const int16_t *)in, n);
+    return 0;
+}
+
+/**
+ * @brief 处理图任务：采集块按指针直接交给各层编码节点，凑满一帧即在本任务内编码写入各层slab
+ */
+static void opus_encode_recorder_graph_task(void *arg)
+{
+    audio_capture_client_t *capture = arg;
+    while (s_graph_running) {
+        if (s_graph_paused) {
+            xSemaphoreGive(s_graph_ack);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        const audio_block_t *blk = audio_capture_pull(capture, OPUS_RECORDER_GRAPH_WAIT_MS);
+        if (!blk) {
+            continue;
+        }
+        audio_lifecycle_data(&s_lifecycle);
+        audio_graph_run(s_graph, blk->samples, blk->count);
+        audio_capture_release(capture, blk);
+    }
+    s_graph_task = NULL;
+    xSemaphoreGive(s_graph_ack);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 构建处理图：[rec_ns] -> [rec_opus1] -> ... -> [rec_opus]，降噪节点仅在启用时存在，
+ *        除最后一层外的编码节点都是旁路节点；编码元素只作为编码器状态与统计的容器，不注册到管道
+ */
+static esp_err_t opus_encode_recorder_graph_build(const audio_latency_profile_t *profile)
+{
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        opus_encode_layer_t *layer = &s_layers[i];
+        if (!layer->used) {
+            continue;
+        }
+        audio_element_set_tag(layer->encoder_el, layer->opus_name);        // 探针名与元素管道一致
+        if (opus_pkt_encoder_sync_open(layer->encoder_el) != ESP_OK) {
+            return ESP_FAIL;
+        }
+    }
+    audio_graph_cfg_t graph_cfg = DEFAULT_AUDIO_GRAPH_CONFIG();
+    graph_cfg.frame_us = AUDIO_CAPTURE_BLOCK_MS * 1000;
+    graph_cfg.clock_us = _opus_encode_recorder_clock;
+    graph_cfg.arena = s_arena;
+    if (s_ns_enabled) {
+        // 降噪器按固定块长处理，采集块长不符是配置错误，在这里失败而不是运行中逐块直通
+        if (audio_capture_block_samples() != opus_encode_recorder_block_samples()) {
+            ESP_LOGE(OPUS_RECORDER_TAG, "Capture block %u samples does not match noise suppress frame %u",
+                     (unsigned)audio_capture_block_samples(), (unsigned)opus_encode_recorder_block_samples());
+            return ESP_ERR_INVALID_SIZE;
+        }
+        graph_cfg.buf_bytes = opus_encode_recorder_block_samples() * sizeof(int16_t);  // 降噪输出（采集块只读）
+        noise_suppress_cfg_t ns_cfg;
+        opus_encode_recorder_ns_cfg(&ns_cfg);
+        audio_arena_set_owner(s_arena, "rec_ns");
+        s_ns = noise_suppress_create(&ns_cfg);
+        if (!s_ns) {
+            audio_arena_set_owner(s_arena, NULL);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    audio_arena_set_owner(s_arena, "rec_graph");
+    s_graph = audio_graph_create(&graph_cfg);
+    audio_arena_set_owner(s_arena, NULL);
+    if (!s_graph) {
+        return ESP_ERR_NO_MEM;
+    }
+    // 降噪在链首只做一次，所有层编码同一份降噪后的数据
+    if (s_ns) {
+        audio_graph_add(s_graph, OPUS_RECORDER_DEFAULT->ns_name, _opus_encode_recorder_ns, s_ns, false);
+    }
+    // 附加层在前作旁路节点，默认层在链尾作末端节点，各层读同一个采集块
+    for (int i = OPUS_RECORDER_MAX_LAYERS - 1; i > 0; i--) {
+        if (s_layers[i].used) {
+            audio_graph_add_tap(s_graph, s_layers[i].opus_name, _opus_encode_recorder_encode, s_layers[i].encoder_el);
+        }
+    }
+    audio_graph_add(s_graph, OPUS_RECORDER_DEFAULT->opus_name, _opus_encode_recorder_encode,
+                    OPUS_RECORDER_DEFAULT->encoder_el, false);
+    opus_encode_recorder_sync_init();
+    xSemaphoreTake(s_graph_ack, 0);
+    s_graph_paused = false;
+    s_graph_running = true;
+    // 编码在本任务内进行，堆栈按编码元素的要求分配（各层依次编码，不叠加）
+    if (xTaskCreatePinnedToCore(opus_encode_recorder_graph_task, "rec_graph", OPUS_PKT_ENCODER_TASK_STACK,
+                                OPUS_RECORDER_DEFAULT->capture, profile->task_prio, &s_graph_task,
+                                profile->capture_core) != pdPASS) {
+        s_graph_running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(OPUS_RECORDER_TAG, "Start graph engine for opus encode recorder");
+    return ESP_OK;
+}
+
+/**
+ * @brief 暂停处理图任务（同步握手：唤醒等块的任务，它编码完在途的块后给出确认，返回时已不再取块与编码）
+ */
+static esp_err_t opus_encode_recorder_graph_pause(void)
+{
+    xSemaphoreTake(s_graph_ack, 0);     // 清掉上次超时后迟到的确认
+    s_graph_paused = true;
+    audio_capture_wake(OPUS_RECORDER_DEFAULT->capture);
+    if (xSemaphoreTake(s_graph_ack, pdMS_TO_TICKS(OPUS_RECORDER_GRAPH_ACK_MS)) != pdTRUE) {
+        // 撤销暂停请求：任务若随后进入等待，这次通知让它立即继续
+        s_graph_paused = false;
+        xTaskNotifyGive(s_graph_task);
+        ESP_LOGW(OPUS_RECORDER_TAG, "graph task did not acknowledge pause");
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+static void opus_encode_recorder_graph_resume(void)
+{
+    s_graph_paused = false;
+    xTaskNotifyGive(s_graph_task);
+}
+
+/**
+ * @brief 暂停录制链路（按执行引擎分派，ADF引擎逐层暂停）
+ */
+static esp_err_t opus_encode_recorder_pause(void)
+{
+    if (s_graph) {
+        return opus_encode_recorder_graph_pause();
+    }
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        if (s_layers[i].pipeline && audio_lifecycle_pause(s_layers[i].pipeline) != ESP_OK) {
+            ret = ESP_FAIL;
+        }
+    }
+    return ret;
+}
+
+static esp_err_t opus_encode_recorder_resume(void)
+{
+    if (s_graph) {
+        opus_encode_recorder_graph_resume();
+        return ESP_OK;
+    }
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        if (s_layers[i].pipeline && audio_lifecycle_resume(s_layers[i].pipeline) != ESP_OK) {
+            ret = ESP_FAIL;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief 开关各层的采集订阅（暂停前须先停住取块的任务）
+ */
+static esp_err_t opus_encode_recorder_set_active(bool active)
+{
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        if (s_layers[i].capture && audio_capture_set_active(s_layers[i].capture, active) != ESP_OK) {
+            ret = ESP_FAIL;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief 一层的帧长：层配置为0时跟随延迟档位
+ */
+static int opus_encode_recorder_frame_us(const opus_encode_layer_t *layer)
+{
+    return layer->cfg.frame_us ? layer->cfg.frame_us : audio_latency_get_profile()->opus_frame_us;
+}
+
+/**
+ * @brief 预录层的环容量（字节，已取整到2的幂）：按可能达到的最高比特率估算，保证历史不短于设定时长
+ */
+static uint32_t opus_encode_recorder_preroll_bytes(const opus_encode_layer_t *layer)
+{
+    opus_pkt_encoder_cfg_t def = DEFAULT_OPUS_PKT_ENCODER_CONFIG();
+    uint32_t bitrate = layer->cfg.bitrate ? (uint32_t)layer->cfg.bitrate : (uint32_t)def.bitrate;
+    if (layer->cfg.adaptive && (uint32_t)def.rate_ctrl.max_bitrate > bitrate) {
+        bitrate = (uint32_t)def.rate_ctrl.max_bitrate;     // 自适应可能把比特率调到上限
+    }
+    uint32_t bytes = opus_preroll_bytes_for(layer->preroll_ms, bitrate, (uint32_t)opus_encode_recorder_frame_us(layer),
+                                            OPUS_RECORDER_SLOT_SIZE);
+    uint32_t cap = 1;
+    while (cap < bytes) {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+/**
+ * @brief 构建一层：包slab（预录层为预录环）与编码元素；ADF引擎下另建采集订阅、读取元素与管道
+ *        [capture] -> [ns] -> [opus] -> slab（降噪元素仅在启用时存在）
+ */
+static esp_err_t opus_encode_recorder_layer_build(opus_encode_layer_t *layer, const audio_latency_profile_t *profile,
+                                                  opus_pkt_encoder_cfg_t *opus_cfg)
+{
+    // 1. 从内存区分配包slab或预录环，之后收发与启停过程中不再分配内存
+    layer->pkt_sem = xSemaphoreCreateBinary();
+    atomic_store(&layer->closing, false);
+    atomic_store(&layer->read_dropped, 0);
+    if (layer->preroll_ms) {
+        audio_arena_set_owner(s_arena, "rec_preroll");
+        layer->preroll = opus_preroll_create(s_arena, opus_encode_recorder_preroll_bytes(layer), OPUS_RECORDER_SLOT_SIZE);
+    } else {
+        audio_arena_set_owner(s_arena, "rec_slab");
+        layer->slab = opus_packet_slab_create(s_arena, OPUS_RECORDER_SLOT_COUNT, OPUS_RECORDER_SLOT_SIZE);
+    }
+    audio_arena_set_owner(s_arena, NULL);
+    if (!opus_encode_recorder_built(layer) || !layer->pkt_sem) {
+        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to create packet slab");
+        return ESP_FAIL;
+    }
+    if (layer->preroll) {
+        opus_preroll_set_notify(layer->preroll, opus_encode_recorder_notify, layer->pkt_sem);
+    } else {
+        opus_packet_slab_set_notify(layer->slab, opus_encode_recorder_notify, layer->pkt_sem);
+        opus_packet_slab_set_watermarks(layer->slab, layer->wm_high, layer->wm_low, layer->wm_cb, layer->wm_ctx);
+    }
 
-    // 6. 创建I2S输入流元素
-    i2s_stream_reader = i2s_stream_init(&i2s_cfg);                     // 初始化I2S输入流
+    // 2. 订阅共享采集前端（16kHz单声道），I2S与重采样由其统一负责；处理图引擎下只有第0层订阅
+    if (s_engine == AUDIO_ENGINE_ADF || layer == OPUS_RECORDER_DEFAULT) {
+        layer->capture = audio_capture_subscribe(AUDIO_CAPTURE_DEFAULT_DEPTH);
+        if (!layer->capture) {
+            ESP_LOGE(OPUS_RECORDER_TAG, "Failed to subscribe audio capture");
+            return ESP_FAIL;
+        }
+    }
 
-    // 7. 注册所有元素到音频管道
-    audio_pipeline_register(s_pipeline, i2s_stream_reader, "i2s");     // 注册I2S输入
-    audio_pipeline_register(s_pipeline, filter, "filter");             // 注册重采样滤波器
-    audio_pipeline_register(s_pipeline, opus_encoder, "opus");         // 注册Opus编码器
-    audio_pipeline_register(s_pipeline, s_raw_writer, "raw");          // 注册raw_stream
+    // 3. 创建Opus包编码器元素，编码结果直接写入该层slab包槽
+    const opus_encode_layer_cfg_t *cfg = &layer->cfg;
+    opus_cfg->slab = layer->slab;                                      // 输出包slab
+    opus_cfg->preroll = layer->preroll;                                // 预录层改写预录环
+    opus_cfg->frame_us = opus_encode_recorder_frame_us(layer);         // 帧长默认由延迟档位决定
+    if (cfg->bitrate) {
+        opus_cfg->bitrate = cfg->bitrate;                              // 初始比特率（运行中用 set_params 调整）
+    }
+    if (cfg->complexity >= 0) {
+        opus_cfg->complexity = cfg->complexity;                        // 初始编码复杂度
+    }
+    opus_cfg->dtx = cfg->dtx;                                          // 静音段只发保活包，省编码CPU与上行流量
+    opus_cfg->dtx_denoised = s_ns_enabled;                             // 降噪输出上检测：残余噪声起伏与增益释放的尾音不延长拖尾
+    opus_cfg->adaptive = cfg->adaptive;                                // 复杂度按实测编码耗时守住CPU预算，比特率/FEC跟随接收端反馈
+    if (cfg->fec) {
+        opus_cfg->fec = true;                                          // 带内FEC：libopus只在预期丢包率非0时才编入LBRR
+        opus_cfg->packet_loss_pct = OPUS_RECORDER_FEC_LOSS_PCT;
+    }
+    opus_cfg->red_depth = cfg->red_depth;                              // 冗余封装：每包附带前几帧，补FEC覆盖不到的连续丢包
+    audio_arena_set_owner(s_arena, layer->opus_name);
+    layer->encoder_el = opus_pkt_encoder_init(opus_cfg);               // 初始化Opus包编码器
+    audio_arena_set_owner(s_arena, NULL);
+    if (!layer->encoder_el) {
+        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to create OPUS encoder");  // 创建失败日志
+        return ESP_FAIL;
+    }
+    if (s_engine == AUDIO_ENGINE_GRAPH) {
+        return ESP_OK;  // 处理图引擎：取块与编码在同一个任务内完成，不需要读取元素与管道
+    }
 
-    // 8. 链接管道元素，形成[i2s] -> [filter] -> [opus] -> [raw]的链路
-    const char *link_tag[4] = {"i2s", "filter", "opus", "raw"};
-    audio_pipeline_link(s_pipeline, &link_tag[0], 4);
+    // 4. 创建音频管道
+    audio_pipeline_cfg_t pipeline_cfg = DEFAULT_AUDIO_PIPELINE_CONFIG();
+    layer->pipeline = audio_pipeline_init(&pipeline_cfg);              // 初始化音频管道
+    mem_assert(layer->pipeline);                                       // 断言管道创建成功
 
-    // 9. 创建事件监听器并绑定到管道
-    audio_event_iface_cfg_t evt_cfg = AUDIO_EVENT_IFACE_DEFAULT_CFG();
-    audio_event_iface_handle_t evt = audio_event_iface_init(&evt_cfg); // 创建事件接口
-    audio_pipeline_set_listener(s_pipeline, evt);                     // 设置管道事件监听
+    // 5. 创建采集读取元素，从共享块中取16kHz PCM，首块到达时记录启动耗时
+    audio_capture_reader_cfg_t reader_cfg = DEFAULT_AUDIO_CAPTURE_READER_CONFIG();
+    reader_cfg.client = layer->capture;
+    reader_cfg.lifecycle = &s_lifecycle;
+    reader_cfg.out_rb_size = profile->element_rb_size;
+    reader_cfg.task_core = profile->capture_core;
+    reader_cfg.task_prio = profile->task_prio;
+    reader_cfg.stack_in_ext = audio_arena_has_psram(s_arena);          // 读取元素只搬运块，堆栈可放PSRAM
+    layer->reader_el = audio_capture_reader_init(&reader_cfg);
+    if (!layer->reader_el) {
+        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to create capture reader");
+        return ESP_FAIL;
+    }
 
-    // 10. 启动音频管道，开始采集、重采样、编码、输出
-    ESP_LOGI(OPUS_RECORDER_TAG, "Start audio pipeline for opus encode recorder");
-    audio_pipeline_run(s_pipeline);
+    // 6. 启用降噪时在读取与编码之间插入降噪元素，按采集块凑帧、原地降噪后交给编码器
+    if (s_ns_enabled) {
+        audio_ns_cfg_t ns_cfg = DEFAULT_AUDIO_NS_CONFIG();
+        opus_encode_recorder_ns_cfg(&ns_cfg.ns);
+        ns_cfg.out_rb_size = profile->element_rb_size;
+        ns_cfg.task_core = profile->capture_core;
+        ns_cfg.task_prio = profile->task_prio;
+        audio_arena_set_owner(s_arena, layer->ns_name);
+        layer->ns_el = audio_ns_init(&ns_cfg);
+        audio_arena_set_owner(s_arena, NULL);
+        if (!layer->ns_el) {
+            ESP_LOGE(OPUS_RECORDER_TAG, "Failed to create noise suppressor");
+            return ESP_FAIL;
+        }
+    }
+
+    // 7. 注册所有元素到音频管道（注册名同时作为探针名）
+    audio_pipeline_register(layer->pipeline, layer->reader_el, layer->capture_name);
+    if (layer->ns_el) {
+        audio_pipeline_register(layer->pipeline, layer->ns_el, layer->ns_name);
+    }
+    audio_pipeline_register(layer->pipeline, layer->encoder_el, layer->opus_name);
 
-    s_task_running = true;                                            // 标记任务正在运行
-    while (s_task_running) {
-        vTaskDelay(pdMS_TO_TICKS(100));                               // 周期性延时，可扩展事件处理
-        // 可在此处添加事件处理逻辑，如监听管道状态等
+    // 8. 链接管道元素，形成[capture] -> [ns] -> [opus] -> slab的链路
+    const char *link_tag[3] = {layer->capture_name, layer->ns_name, layer->opus_name};
+    if (layer->ns_el) {
+        audio_pipeline_link(layer->pipeline, &link_tag[0], 3);
+    } else {
+        link_tag[1] = layer->opus_name;
+        audio_pipeline_link(layer->pipeline, &link_tag[0], 2);
     }
 
-    // 11. 停止管道并释放所有资源
-    ESP_LOGI(OPUS_RECORDER_TAG, "Stop audio pipeline for opus encode recorder");
-    audio_pipeline_stop(s_pipeline);                                  // 停止管道
-    audio_pipeline_wait_for_stop(s_pipeline);                         // 等待管道完全停止
-    audio_pipeline_terminate(s_pipeline);                             // 终止管道
+    // 9. 事件接到共用监听任务，启动音频管道，开始编码、输出
+    audio_lifecycle_listen(layer->pipeline);
+    return audio_pipeline_run(layer->pipeline);
+}
 
-    // 注销所有元素
-    audio_pipeline_unregister(s_pipeline, i2s_stream_reader);
-    audio_pipeline_unregister(s_pipeline, filter);
-    audio_pipeline_unregister(s_pipeline, opus_encoder);
-    audio_pipeline_unregister(s_pipeline, s_raw_writer);
+/**
+ * @brief 构建并启动录制（仅首次启动或 deinit 之后执行）
+ *
+ * 各层订阅共享采集前端的16kHz PCM块（采集、转换与重采样只做一次），各自Opus编码，
+ * 并将完整的包写入各层slab。元素事件交给共用监听任务，本模块不再单独创建任务。
+ */
+static esp_err_t opus_encode_recorder_build(void)
+{
+    const audio_latency_profile_t *profile = audio_latency_get_profile();
 
-    // 移除事件监听器并销毁
-    audio_pipeline_remove_listener(s_pipeline);
-    audio_event_iface_destroy(evt);
+    // 1. 按层数预留内存区，之后收发与启停过程中不再分配内存
+    uint32_t layers = 0;
+    size_t psram_bytes = 0;
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        if (s_layers[i].used) {
+            layers++;
+            psram_bytes += s_layers[i].preroll_ms ? opus_encode_recorder_preroll_bytes(&s_layers[i])
+                                                  : OPUS_RECORDER_SLOT_COUNT * OPUS_RECORDER_SLOT_SIZE;
+            if (s_layers[i].cfg.red_depth) {
+                psram_bytes += opus_red_mem_size(s_layers[i].cfg.red_depth, OPUS_PKT_RED_BLOCK_BYTES);
+            }
+        }
+    }
+    // 降噪：处理图引擎下共用一个降噪器并多一对工作缓冲，ADF引擎下每层一个降噪元素
+    size_t ns_bytes = 0;
+    if (s_ns_enabled) {
+        audio_ns_cfg_t ns_cfg = DEFAULT_AUDIO_NS_CONFIG();
+        opus_encode_recorder_ns_cfg(&ns_cfg.ns);
+        if (s_engine == AUDIO_ENGINE_GRAPH) {
+            audio_graph_cfg_t graph_cfg = DEFAULT_AUDIO_GRAPH_CONFIG();
+            graph_cfg.buf_bytes = ns_cfg.ns.frame_samples * sizeof(int16_t);
+            ns_bytes = noise_suppress_mem_size(&ns_cfg.ns) + audio_graph_mem_size(&graph_cfg, AUDIO_ARENA_INTERNAL);
+        } else {
+            ns_bytes = layers * audio_ns_mem_size(&ns_cfg);
+        }
+    }
+    audio_arena_cfg_t arena_cfg = {
+        .name = "recorder",
+        .internal_bytes = layers * (OPUS_RECORDER_ARENA_SRAM + AUDIO_ARENA_SIZE(opus_encoder_get_size(1))) + ns_bytes,
+        .psram_bytes = psram_bytes,
+    };
+    if (audio_arena_ensure(&s_arena, &arena_cfg) != 0) {
+        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to reserve recorder arena");
+        return ESP_ERR_NO_MEM;
+    }
 
-    // 释放所有元素和管道资源
-    audio_pipeline_deinit(s_pipeline);
-    audio_element_deinit(i2s_stream_reader);
-    audio_element_deinit(filter);
-    audio_element_deinit(opus_encoder);
-    audio_element_deinit(s_raw_writer);
+    // 2. 逐层创建编码器（各层公共的编码参数在此设定）
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        opus_encode_layer_t *layer = &s_layers[i];
+        if (!layer->used) {
+            continue;
+        }
+        opus_pkt_encoder_cfg_t opus_cfg = DEFAULT_OPUS_PKT_ENCODER_CONFIG();
+        opus_cfg.sample_rate = AUDIO_CAPTURE_SAMPLE_RATE;              // 与采集前端输出一致
+        opus_cfg.task_core = profile->capture_core;
+        opus_cfg.task_prio = profile->task_prio;
+        opus_cfg.arena = s_arena;                                      // 编码器状态与帧缓冲放片内SRAM
+        if (opus_encode_recorder_layer_build(layer, profile, &opus_cfg) != ESP_OK) {
+            goto _fail;
+        }
+    }
 
-    s_pipeline = NULL;
-    s_raw_writer = NULL;
+    // 3. 处理图引擎：一个任务取块，各层依次编码
+    if (s_engine == AUDIO_ENGINE_GRAPH) {
+        if (opus_encode_recorder_graph_build(profile) != ESP_OK) {
+            goto _fail;
+        }
+        return ESP_OK;
+    }
+    ESP_LOGI(OPUS_RECORDER_TAG, "Start audio pipeline for opus encode recorder (%u layers)", (unsigned)layers);
+    return ESP_OK;
 
-_exit:
-    s_opus_encode_task_handle = NULL;                                 // 清空任务句柄
-    vTaskDelete(NULL);                                                // 删除当前任务
+_fail:
+    opus_encode_recorder_teardown();
+    return ESP_FAIL;
 }
 
 /**
- * @brief 启动Opus编码录制任务
+ * @brief 启动Opus编码录制
  *
- * 创建并启动opus_encode_recorder_task后台任务，负责音频采集与编码。
- * 若任务已在运行，则直接返回。
+ * 首次调用时构建管道；此后停止只是暂停，再次启动时丢弃停止期间残留的包、
+ * 冲刷编码器并恢复管道，不创建任务、不分配内存。若已在运行，则直接返回。
  */
 void opus_encode_recorder_start(void)
 {
-    if (s_opus_encode_task_handle) {
+    audio_lifecycle_enter(&s_lifecycle);
+    audio_lifecycle_state_t state = s_lifecycle.state;
+    if (state == AUDIO_LIFECYCLE_RUNNING) {
         ESP_LOGW(OPUS_RECORDER_TAG, "Opus encode recorder already running"); // 已在运行
-        return;
+    } else if (state == AUDIO_LIFECYCLE_IDLE) {
+        if (opus_encode_recorder_build() == ESP_OK) {
+            state = AUDIO_LIFECYCLE_RUNNING;
+        }
+    } else {
+        // 先恢复采集订阅再恢复管道，读取元素恢复后立即有数据可取
+        for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+            if (opus_encode_recorder_built(&s_layers[i])) {
+                opus_encode_recorder_drain(&s_layers[i]);
+                opus_pkt_encoder_flush(s_layers[i].encoder_el);
+            }
+        }
+        if (opus_encode_recorder_set_active(true) == ESP_OK &&
+            opus_encode_recorder_resume() == ESP_OK) {
+            state = AUDIO_LIFECYCLE_RUNNING;
+        }
     }
-    s_task_running = true;    // 设置任务运行标志
-    // 创建并绑定任务到核心0
-    xTaskCreatePinnedToCore(opus_encode_recorder_task, "opus_encode_recorder_task", OPUS_RECORDER_TASK_STACK, NULL, OPUS_RECORDER_TASK_PRIO, &s_opus_encode_task_handle, 0);
+    audio_lifecycle_leave(&s_lifecycle, state);
 }
 
 /**
- * @brief 停止Opus编码录制任务
+ * @brief 停止Opus编码录制
  *
- * 通知后台任务退出并等待其完全销毁。
- * 若任务未运行，则直接返回。
+ * 先结束保存到文件（若在保存），再暂停各层（等读取与编码确认暂停）并暂停采集订阅，
+ * 已编码未取走的包仍可取出。
+ * 管道、编码器与slab全部保留，再次启动只需恢复；彻底释放请调用 opus_encode_recorder_deinit()。
+ * 若未运行，则直接返回。
  */
 void opus_encode_recorder_stop(void)
 {
-    if (!s_opus_encode_task_handle) {
+    opus_encode_recorder_save_stop();
+    audio_lifecycle_enter(&s_lifecycle);
+    audio_lifecycle_state_t state = s_lifecycle.state;
+    if (state != AUDIO_LIFECYCLE_RUNNING) {
         ESP_LOGW(OPUS_RECORDER_TAG, "Opus encode recorder not running"); // 未在运行
+    } else if (opus_encode_recorder_pause() == ESP_OK) {
+        // 读取元素已停止取块，此时注销采集消费者不会与其竞争
+        opus_encode_recorder_set_active(false);
+        state = AUDIO_LIFECYCLE_PAUSED;
+    }
+    audio_lifecycle_leave(&s_lifecycle, state);
+}
+
+/**
+ * @brief 释放录制管道及全部资源（各层的句柄保留，下次启动时按原配置重建）
+ *
+ * 暂停中的管道先恢复再按正常流程停止，保证各元素任务正常退出。
+ */
+void opus_encode_recorder_deinit(void)
+{
+    opus_encode_recorder_save_stop();
+    audio_lifecycle_enter(&s_lifecycle);
+    if (s_lifecycle.state == AUDIO_LIFECYCLE_PAUSED) {
+        opus_encode_recorder_set_active(true);
+        opus_encode_recorder_resume();
+    }
+    if (s_lifecycle.state != AUDIO_LIFECYCLE_IDLE) {
+        ESP_LOGI(OPUS_RECORDER_TAG, "Stop audio pipeline for opus encode recorder");
+        opus_encode_recorder_teardown();
+    }
+    audio_lifecycle_leave(&s_lifecycle, AUDIO_LIFECYCLE_IDLE);
+}
+
+/**
+ * @brief 获取录制管道的启停统计
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int opus_encode_recorder_get_lifecycle(audio_lifecycle_stats_t *stats)
+{
+    if (!stats) return -1;
+    audio_lifecycle_get_stats(&s_lifecycle, stats);
+    return 0;
+}
+
+/**
+ * @brief 选择录制链路的执行引擎，下次构建（首次启动或 deinit 之后）生效
+ * @param engine AUDIO_ENGINE_ADF 或 AUDIO_ENGINE_GRAPH
+ */
+void opus_encode_recorder_set_engine(audio_engine_t engine)
+{
+    s_engine = engine;
+}
+
+/**
+ * @brief 获取处理图引擎的统计（各层编码节点调用次数与耗时）
+ * @param stats 整图统计，可为NULL
+ * @param nodes 节点统计数组，可为NULL
+ * @param max   nodes 容量
+ * @return 写入 nodes 的条目数，未以处理图运行返回-1
+ */
+int opus_encode_recorder_get_graph_stats(audio_graph_stats_t *stats, audio_graph_node_stats_t *nodes, int max)
+{
+    audio_graph_t *g = s_graph;
+    if (!g) return -1;
+    return audio_graph_get_stats(g, stats, nodes, max);
+}
+
+/**
+ * @brief 设置编码前降噪（下次构建生效）
+ * @param cfg 降噪配置，只取 level 与 budget_us；NULL 关闭降噪
+ */
+void opus_encode_recorder_set_ns(const noise_suppress_cfg_t *cfg)
+{
+    s_ns_enabled = cfg != NULL;
+    if (cfg) {
+        s_ns_cfg.level = cfg->level;
+        s_ns_cfg.budget_us = cfg->budget_us;
+    }
+}
+
+/**
+ * @brief 运行中调整降噪强度，所有层下一个10ms帧生效
+ * @return 0，强度非法返回-1
+ */
+int opus_encode_recorder_set_ns_level(noise_suppress_level_t level)
+{
+    if (level >= NOISE_SUPPRESS_LEVEL_MAX) return -1;
+    s_ns_cfg.level = level;
+    if (s_ns) {
+        noise_suppress_set_level(s_ns, level);
+    }
+    for (int i = 0; i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        if (s_layers[i].ns_el) {
+            audio_ns_set_level(s_layers[i].ns_el, level);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 获取降噪统计（ADF引擎下取默认层的降噪元素）
+ * @return 0，未启用降噪或未构建返回-1
+ */
+int opus_encode_recorder_get_ns_stats(noise_suppress_stats_t *stats)
+{
+    if (!stats) return -1;
+    if (s_ns) {
+        noise_suppress_get_stats(s_ns, stats);
+        return 0;
+    }
+    return audio_ns_get_stats(OPUS_RECORDER_DEFAULT->ns_el, stats);
+}
+
+/* ------------------------------------------------------------------ */
+/* 编码层（同播）                                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 层配置是否合法：帧长为0（跟随延迟档位）或libopus支持的帧长，复杂度不超过10
+ */
+static bool opus_encode_recorder_layer_cfg_valid(const opus_encode_layer_cfg_t *cfg)
+{
+    int f = cfg->frame_us;
+    return cfg->complexity <= 10 && cfg->bitrate >= 0 && cfg->red_depth <= OPUS_RED_MAX_DEPTH &&
+           (f == 0 || f == 2500 || f == 5000 || f == 10000 || f == 20000 || f == 40000 || f == 60000);
+}
+
+/**
+ * @brief 添加一个编码层（仅在未构建时：首次启动之前或 deinit 之后）
+ * @param cfg 层配置
+ * @return 层句柄，已在运行、层数已满或参数非法返回NULL
+ */
+opus_encode_layer_t *opus_encode_recorder_layer_add(const opus_encode_layer_cfg_t *cfg)
+{
+    if (!cfg || !opus_encode_recorder_layer_cfg_valid(cfg)) return NULL;
+    opus_encode_layer_t *layer = NULL;
+    audio_lifecycle_enter(&s_lifecycle);
+    audio_lifecycle_state_t state = s_lifecycle.state;
+    for (int i = 1; state == AUDIO_LIFECYCLE_IDLE && i < OPUS_RECORDER_MAX_LAYERS; i++) {
+        if (!s_layers[i].used) {
+            layer = &s_layers[i];
+            memset(layer, 0, sizeof(*layer));
+            layer->used = true;
+            layer->index = (uint8_t)i;
+            layer->cfg = *cfg;
+            snprintf(layer->opus_name, sizeof(layer->opus_name), "rec_opus%d", i);
+            snprintf(layer->capture_name, sizeof(layer->capture_name), "rec_capture%d", i);
+            snprintf(layer->ns_name, sizeof(layer->ns_name), "rec_ns%d", i);
+            break;
+        }
+    }
+    audio_lifecycle_leave(&s_lifecycle, state);
+    return layer;
+}
+
+/**
+ * @brief 移除一个编码层（仅在未构建时），默认层不可移除
+ * @param layer 层句柄
+ */
+void opus_encode_recorder_layer_remove(opus_encode_layer_t *layer)
+{
+    if (!layer || layer == OPUS_RECORDER_DEFAULT) return;
+    audio_lifecycle_enter(&s_lifecycle);
+    audio_lifecycle_state_t state = s_lifecycle.state;
+    if (state == AUDIO_LIFECYCLE_IDLE) {
+        layer->used = false;
+    }
+    audio_lifecycle_leave(&s_lifecycle, state);
+}
+
+/**
+ * @brief 获取默认层句柄（不带句柄的取包、参数与统计接口都作用于它）
+ */
+opus_encode_layer_t *opus_encode_recorder_default_layer(void)
+{
+    return OPUS_RECORDER_DEFAULT;
+}
+
+/**
+ * @brief 设置默认层的配置（仅在未构建时）
+ * @param cfg 层配置
+ * @return 成功返回0，已在运行或参数非法返回-1
+ */
+int opus_encode_recorder_set_default_layer(const opus_encode_layer_cfg_t *cfg)
+{
+    if (!cfg || !opus_encode_recorder_layer_cfg_valid(cfg)) return -1;
+    int ret = -1;
+    audio_lifecycle_enter(&s_lifecycle);
+    audio_lifecycle_state_t state = s_lifecycle.state;
+    if (state == AUDIO_LIFECYCLE_IDLE) {
+        s_layers[0].cfg = *cfg;
+        ret = 0;
+    }
+    audio_lifecycle_leave(&s_lifecycle, state);
+    return ret;
+}
+
+/**
+ * @brief 获取一层的下一个完整Opus包（零拷贝）
+ * @param layer      层句柄
+ * @param pkt        输出参数，指向该层slab内的包
+ * @param timeout_ms 最长等待时间（毫秒），OPUS_RECORDER_WAIT_FOREVER 表示一直等待
+ * @return 成功返回0，未运行、默认层正在保存到文件或超时返回-1
+ */
+int opus_encode_layer_acquire(opus_encode_layer_t *layer, const opus_packet_t **pkt, uint32_t timeout_ms)
+{
+    if (!opus_encode_recorder_reader_enter(layer)) return -1;
+    TickType_t ticks = (timeout_ms == OPUS_RECORDER_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    int ret = opus_encode_recorder_take(layer, pkt, ticks);
+    opus_encode_recorder_reader_leave(layer);
+    return ret;
+}
+
+/**
+ * @brief 归还由 opus_encode_layer_acquire() 获取的包
+ */
+void opus_encode_layer_release(opus_encode_layer_t *layer, const opus_packet_t *pkt)
+{
+    if (!opus_encode_recorder_built(layer) || !pkt) return;
+    opus_encode_recorder_put(layer, pkt);
+}
+
+/**
+ * @brief 从一层读取一个完整的Opus包，没有包时立即返回
+ * @return 包长度，暂无包返回0，未运行、正在保存或缓冲区不足返回-1（缓冲区不足时丢弃该包并计入 read_dropped）
+ */
+int opus_encode_layer_try_read(opus_encode_layer_t *layer, uint8_t *data, size_t len)
+{
+    if (!opus_encode_recorder_reader_enter(layer)) return -1;
+    const opus_packet_t *pkt = opus_encode_recorder_peek(layer);
+    int n = pkt ? opus_encode_recorder_copy_out(layer, pkt, data, len) : 0;
+    opus_encode_recorder_reader_leave(layer);
+    return n;
+}
+
+/**
+ * @brief 一次取出一层当前已有的最多 max 个包（零拷贝，不阻塞；预录层每次最多取出1个）
+ * @return 取出的包数，暂无包返回0，未运行或正在保存返回-1
+ */
+int opus_encode_layer_acquire_batch(opus_encode_layer_t *layer, const opus_packet_t **pkts, int max)
+{
+    if (max < 0 || !opus_encode_recorder_reader_enter(layer)) return -1;
+    int n;
+    if (layer->preroll) {
+        pkts[0] = max > 0 ? opus_preroll_acquire_read(layer->preroll) : NULL;
+        n = pkts[0] ? 1 : 0;
+    } else {
+        n = (int)opus_packet_slab_acquire_read_batch(layer->slab, pkts, (uint32_t)max);
+    }
+    opus_encode_recorder_reader_leave(layer);
+    return n;
+}
+
+/**
+ * @brief 按取出顺序一次归还一层的 count 个包
+ */
+void opus_encode_layer_release_batch(opus_encode_layer_t *layer, int count)
+{
+    if (!opus_encode_recorder_built(layer) || count <= 0) return;
+    if (layer->preroll) {
+        // 预录层一次只取出1个包，重取得到的仍是这个包
+        opus_preroll_release(layer->preroll, opus_preroll_acquire_read(layer->preroll));
         return;
     }
-    s_task_running = false;   // 通知任务退出
-    // 等待任务句柄被清空，确保任务已销毁
-    while (s_opus_encode_task_handle) {
-        vTaskDelay(pdMS_TO_TICKS(10));
+    opus_packet_slab_release_batch(layer->slab, (uint32_t)count);
+}
+
+/**
+ * @brief 设置一层包slab的水位通知，slab已创建时立即生效，否则在创建后生效（预录层不通知）
+ */
+void opus_encode_layer_set_watermarks(opus_encode_layer_t *layer, uint32_t high, uint32_t low,
+                                      opus_packet_slab_watermark_t cb, void *ctx)
+{
+    if (!layer) return;
+    layer->wm_high = high;
+    layer->wm_low = low;
+    layer->wm_cb = cb;
+    layer->wm_ctx = ctx;
+    if (layer->slab) {
+        opus_packet_slab_set_watermarks(layer->slab, high, low, cb, ctx);
     }
 }
 
 /**
- * @brief 读取Opus编码后的数据
+ * @brief 获取一层的编码统计（VAD状态、DTX跳过帧数、包数与字节数、当前参数）
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_layer_get_stats(opus_encode_layer_t *layer, opus_pkt_encoder_stats_t *stats)
+{
+    audio_element_handle_t el = layer ? layer->encoder_el : NULL;
+    if (!stats || !el) return -1;
+    if (opus_pkt_encoder_get_stats(el, stats) != ESP_OK) return -1;
+    stats->read_dropped = atomic_load(&layer->read_dropped);
+    return 0;
+}
+
+/**
+ * @brief 调整一层运行中编码器的参数，下一个帧边界生效，不影响其他层
+ * @return 成功返回0，未运行或参数非法返回-1
+ */
+int opus_encode_layer_set_params(opus_encode_layer_t *layer, const opus_rate_params_t *params)
+{
+    audio_element_handle_t el = layer ? layer->encoder_el : NULL;
+    if (!el) return -1;
+    return opus_pkt_encoder_set_params(el, params) == ESP_OK ? 0 : -1;
+}
+
+/**
+ * @brief 获取一层当前生效的编码参数
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_layer_get_params(opus_encode_layer_t *layer, opus_rate_params_t *params)
+{
+    audio_element_handle_t el = layer ? layer->encoder_el : NULL;
+    if (!el) return -1;
+    return opus_pkt_encoder_get_params(el, params) == ESP_OK ? 0 : -1;
+}
+
+/**
+ * @brief 上报该层接收端反馈的丢包率与可用带宽
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_layer_report_link(opus_encode_layer_t *layer, uint8_t loss_pct, uint32_t bandwidth_bps)
+{
+    audio_element_handle_t el = layer ? layer->encoder_el : NULL;
+    if (!el) return -1;
+    return opus_pkt_encoder_report_link(el, loss_pct, bandwidth_bps) == ESP_OK ? 0 : -1;
+}
+
+/**
+ * @brief 把一层设为预录层（仅在未构建时）：编码器常开写入预录环，未触发时只保留最近 history_ms 的包
+ * @param layer      层句柄
+ * @param history_ms 历史时长（毫秒），0 恢复为普通层
+ * @return 成功返回0，已在运行或时长超出上限返回-1
+ */
+int opus_encode_layer_set_preroll(opus_encode_layer_t *layer, uint32_t history_ms)
+{
+    if (!layer || history_ms > OPUS_RECORDER_PREROLL_MAX_MS) return -1;
+    int ret = -1;
+    audio_lifecycle_enter(&s_lifecycle);
+    audio_lifecycle_state_t state = s_lifecycle.state;
+    if (state == AUDIO_LIFECYCLE_IDLE) {
+        layer->preroll_ms = history_ms;
+        ret = 0;
+    }
+    audio_lifecycle_leave(&s_lifecycle, state);
+    return ret;
+}
+
+/**
+ * @brief 触发预录层：此后取包接口先交出触发前 history_ms 内的历史包，再无缝接上实时包
+ *
+ * 触发在编码器的下一个帧边界上生效（不超过一帧），历史不足时从最旧的包开始。
+ * 触发期间编码器不再覆盖未取走的包，读取者跟不上时丢弃新包，用完须调用 opus_encode_layer_disarm()。
+ * @param layer      层句柄
+ * @param history_ms 回溯时长（毫秒）
+ * @return 成功返回0，未运行或不是预录层返回-1
+ */
+int opus_encode_layer_trigger(opus_encode_layer_t *layer, uint32_t history_ms)
+{
+    if (!layer || !layer->preroll) return -1;
+    uint32_t back = (uint32_t)((uint64_t)history_ms * AUDIO_CAPTURE_SAMPLE_RATE / 1000);
+    opus_preroll_trigger(layer->preroll, opus_preroll_timestamp(layer->preroll) - back);
+    return 0;
+}
+
+/**
+ * @brief 解除预录层的触发，回到只保留历史的状态（此前取出未归还的包随即失效）
+ */
+void opus_encode_layer_disarm(opus_encode_layer_t *layer)
+{
+    if (!layer || !layer->preroll) return;
+    opus_preroll_disarm(layer->preroll);
+    xSemaphoreTake(layer->pkt_sem, 0);
+}
+
+/**
+ * @brief 获取预录层的统计（占用、覆盖与丢弃包数、最近一次触发交出的历史）
+ * @return 成功返回0，未运行或不是预录层返回-1
+ */
+int opus_encode_layer_get_preroll_stats(opus_encode_layer_t *layer, opus_preroll_stats_t *stats)
+{
+    if (!layer || !layer->preroll || !stats) return -1;
+    opus_preroll_get_stats(layer->preroll, stats);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* 默认层的兼容接口                                                    */
+/* ------------------------------------------------------------------ */
+
+/**
+ * @brief 获取下一个完整的Opus包（零拷贝）
+ *
+ * 返回的包数据位于slab内部，可直接用于网络发送，使用完毕后必须调用
+ * opus_encode_recorder_release() 归还。
+ * @param pkt        输出参数，指向slab内的包
+ * @param timeout_ms 最长等待时间（毫秒），OPUS_RECORDER_WAIT_FOREVER 表示一直等待
+ * @return 成功返回0，未运行、正在保存到文件或超时返回-1
+ */
+int opus_encode_recorder_acquire(const opus_packet_t **pkt, uint32_t timeout_ms)
+{
+    return opus_encode_layer_acquire(OPUS_RECORDER_DEFAULT, pkt, timeout_ms);
+}
+
+/**
+ * @brief 归还由 opus_encode_recorder_acquire() 获取的包
+ * @param pkt 待归还的包
+ */
+void opus_encode_recorder_release(const opus_packet_t *pkt)
+{
+    opus_encode_layer_release(OPUS_RECORDER_DEFAULT, pkt);
+}
+
+/**
+ * @brief 读取一个完整的Opus包（兼容接口，会拷贝一次）
  *
- * 从raw_stream缓冲区读取Opus编码数据，通常用于网络发送或本地存储。
+ * 每次调用返回一个完整的包，包边界得以保留。
  * @param data 目标缓冲区指针
- * @param len  期望读取的字节数
- * @return 实际读取的字节数，失败返回-1
+ * @param len  目标缓冲区大小（字节）
+ * @return 包长度，失败或缓冲区不足返回-1（缓冲区不足时丢弃该包并计入 read_dropped）
  */
 int opus_encode_recorder_read(uint8_t *data, size_t len)
 {
-    if (!s_raw_writer) return -1; // 若raw_stream未初始化，返回错误
-    return raw_stream_read(s_raw_writer, (char *)data, len); // 从raw_stream读取数据
+    opus_encode_layer_t *layer = OPUS_RECORDER_DEFAULT;
+    if (!opus_encode_recorder_reader_enter(layer)) return -1;
+    const opus_packet_t *pkt = NULL;
+    int n = opus_encode_recorder_take(layer, &pkt, portMAX_DELAY);
+    if (n == 0) {
+        n = opus_encode_recorder_copy_out(layer, pkt, data, len);
+    }
+    opus_encode_recorder_reader_leave(layer);
+    return n;
+}
+
+/**
+ * @brief 读取一个完整的Opus包，没有包时立即返回（不阻塞的兼容接口）
+ *
+ * @param data 目标缓冲区指针
+ * @param len  目标缓冲区大小（字节）
+ * @return 包长度，暂无包返回0，未运行、正在保存或缓冲区不足返回-1（缓冲区不足时包保留在slab中）
+ */
+int opus_encode_recorder_try_read(uint8_t *data, size_t len)
+{
+    return opus_encode_layer_try_read(OPUS_RECORDER_DEFAULT, data, len);
+}
+
+/**
+ * @brief 一次取出当前已有的最多 max 个包（零拷贝，不阻塞）
+ *
+ * @param pkts 输出包数组（按编码顺序）
+ * @param max  最多取出的个数
+ * @return 取出的包数，暂无包返回0，未运行或正在保存返回-1
+ */
+int opus_encode_recorder_acquire_batch(const opus_packet_t **pkts, int max)
+{
+    return opus_encode_layer_acquire_batch(OPUS_RECORDER_DEFAULT, pkts, max);
+}
+
+/**
+ * @brief 按取出顺序一次归还 count 个包
+ */
+void opus_encode_recorder_release_batch(int count)
+{
+    opus_encode_layer_release_batch(OPUS_RECORDER_DEFAULT, count);
+}
+
+/**
+ * @brief 设置包slab的水位通知，slab已创建时立即生效，否则在创建后生效
+ */
+void opus_encode_recorder_set_watermarks(uint32_t high, uint32_t low, opus_packet_slab_watermark_t cb, void *ctx)
+{
+    opus_encode_layer_set_watermarks(OPUS_RECORDER_DEFAULT, high, low, cb, ctx);
+}
+
+/**
+ * @brief 当前是否检测到语音
+ * @return 最近一帧为语音（含拖尾）返回true，静音或未运行返回false
+ */
+bool opus_encode_recorder_is_speech(void)
+{
+    opus_pkt_encoder_stats_t stats;
+    return opus_encode_recorder_get_stats(&stats) == 0 && stats.speech;
+}
+
+/**
+ * @brief 获取编码统计（VAD状态、DTX跳过帧数、上行包数与字节数）
+ * @param stats 输出统计
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_get_stats(opus_pkt_encoder_stats_t *stats)
+{
+    return opus_encode_layer_get_stats(OPUS_RECORDER_DEFAULT, stats);
+}
+
+/**
+ * @brief 统计默认层录制链路各级的缓冲延迟（麦克风 -> 可取出的Opus包）
+ * @param report 输出报告
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_get_latency(audio_latency_report_t *report)
+{
+    opus_encode_layer_t *layer = OPUS_RECORDER_DEFAULT;
+    if (!report || !layer->capture || !layer->encoder_el) return -1;
+    audio_latency_report_reset(report);
+    if (audio_capture_get_latency(layer->capture, report) != ESP_OK) return -1;
+    int frame_us = opus_encode_recorder_frame_us(layer);
+    if (layer->reader_el) {
+        audio_latency_report_add_ringbuf(report, "capture rb", layer->reader_el, AUDIO_CAPTURE_SAMPLE_RATE * 2);
+    }
+    noise_suppress_stats_t ns_stats;
+    if (opus_encode_recorder_get_ns_stats(&ns_stats) == 0) {
+        audio_latency_report_add(report, "noise suppress", ns_stats.delay_samples * 1000000u / AUDIO_CAPTURE_SAMPLE_RATE);
+        if (layer->ns_el) {
+            audio_latency_report_add_ringbuf(report, "ns rb", layer->ns_el, AUDIO_CAPTURE_SAMPLE_RATE * 2);
+        }
+    }
+    audio_latency_report_add(report, "opus encode", opus_pkt_encoder_get_delay_us(layer->encoder_el));
+    if (layer->preroll) {
+        audio_latency_report_add(report, "preroll backlog", opus_preroll_count(layer->preroll) * frame_us);
+    } else {
+        audio_latency_report_add(report, "packet slab", opus_packet_slab_count(layer->slab) * frame_us);
+    }
+    return 0;
+}
+
+/**
+ * @brief 调整运行中编码器的参数，下一个帧边界生效，不重建管道
+ * @param params 新参数
+ * @return 成功返回0，未运行或参数非法返回-1
+ */
+int opus_encode_recorder_set_params(const opus_rate_params_t *params)
+{
+    return opus_encode_layer_set_params(OPUS_RECORDER_DEFAULT, params);
+}
+
+/**
+ * @brief 获取当前生效的编码参数
+ * @param params 输出参数
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_get_params(opus_rate_params_t *params)
+{
+    return opus_encode_layer_get_params(OPUS_RECORDER_DEFAULT, params);
+}
+
+/**
+ * @brief 上报接收端反馈的丢包率与可用带宽
+ * @param loss_pct      丢包率（%）
+ * @param bandwidth_bps 可用带宽（bps，含包头开销），0 表示未知
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_report_link(uint8_t loss_pct, uint32_t bandwidth_bps)
+{
+    return opus_encode_layer_report_link(OPUS_RECORDER_DEFAULT, loss_pct, bandwidth_bps);
+}
+
+/**
+ * @brief 把默认层设为预录层（仅在未构建时），见 opus_encode_layer_set_preroll()
+ */
+int opus_encode_recorder_set_preroll(uint32_t history_ms)
+{
+    return opus_encode_layer_set_preroll(OPUS_RECORDER_DEFAULT, history_ms);
+}
+
+/**
+ * @brief 触发默认层的预录，见 opus_encode_layer_trigger()
+ */
+int opus_encode_recorder_trigger(uint32_t history_ms)
+{
+    return opus_encode_layer_trigger(OPUS_RECORDER_DEFAULT, history_ms);
+}
+
+/**
+ * @brief 解除默认层的预录触发，见 opus_encode_layer_disarm()
+ */
+void opus_encode_recorder_disarm(void)
+{
+    opus_encode_layer_disarm(OPUS_RECORDER_DEFAULT);
+}
+
+/**
+ * @brief 文件写回调（无缓冲，封装器每次交来一整块）
+ */
+static int opus_encode_recorder_file_write(void *ctx, const void *data, size_t len)
+{
+    return fwrite(data, 1, len, (FILE *)ctx) == len ? (int)len : -1;
+}
+
+/**
+ * @brief 保存任务：逐包取出写入Ogg封装器，停止时写出结束页与索引文件
+ */
+static void opus_encode_recorder_save_task(void *arg)
+{
+    ogg_opus_writer_t *w = arg;
+    opus_encode_layer_t *layer = OPUS_RECORDER_DEFAULT;
+    while (s_saving) {
+        const opus_packet_t *pkt;
+        if (opus_encode_recorder_take(layer, &pkt, pdMS_TO_TICKS(OPUS_RECORDER_SAVE_WAIT_MS)) != 0) {
+            continue;
+        }
+        // 文件中只存主负载，冗余副本对本地连续的包没有意义
+        opus_packet_t primary = *pkt;
+        opus_red_block_t blocks[OPUS_RED_MAX_DEPTH + 1];
+        int n = layer->cfg.red_depth ? opus_red_parse(pkt->data, pkt->len, blocks, OPUS_RED_MAX_DEPTH + 1) : 0;
+        if (n > 0) {
+            primary.data = (uint8_t *)blocks[n - 1].data;
+            primary.len = blocks[n - 1].len;
+        }
+        int ret = ogg_opus_writer_put(w, &primary);
+        opus_encode_recorder_put(layer, pkt);
+        ogg_opus_writer_get_stats(w, &s_save_stats);
+        if (ret == -2) {
+            // 存储写满或损坏，继续写只会产生残缺的页
+            ESP_LOGE(OPUS_RECORDER_TAG, "storage write failed, stop saving %s", s_save_path);
+            break;
+        }
+    }
+
+    ogg_opus_writer_close(w);
+    ogg_opus_writer_get_stats(w, &s_save_stats);
+    fclose(s_save_file);
+    s_save_file = NULL;
+    size_t n = strlen(s_save_path);
+    strcpy(s_save_path + n, ".idx");
+    FILE *f = fopen(s_save_path, "wb");
+    if (!f || ogg_opus_index_save(ogg_opus_writer_get_index(w), opus_encode_recorder_file_write, f) != 0) {
+        ESP_LOGW(OPUS_RECORDER_TAG, "Failed to write index %s", s_save_path);
+    }
+    if (f) {
+        fclose(f);
+    }
+    s_save_path[n] = '\0';
+    ESP_LOGI(OPUS_RECORDER_TAG, "saved %s: %u packets (%u gap), %u pages, %u bytes in %u writes",
+             s_save_path, (unsigned)s_save_stats.packets, (unsigned)s_save_stats.gap_packets,
+             (unsigned)s_save_stats.pages, (unsigned)s_save_stats.file_bytes, (unsigned)s_save_stats.write_calls);
+    ogg_opus_writer_destroy(w);
+    if (layer->preroll) {
+        opus_preroll_disarm(layer->preroll);
+    }
+    s_saving = false;
+    s_save_task = NULL;
+    xSemaphoreGive(s_save_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 开始把默认层录制的包保存为Ogg-Opus文件
+ *
+ * 默认层为预录层时，文件从整段预录历史开始并接上实时包，结束保存后回到只保留历史。
+ * @param path 文件路径（同时写出 path.idx 索引文件）
+ * @return 成功返回0，未运行、已在保存、路径过长或打开失败返回-1
+ */
+int opus_encode_recorder_save_start(const char *path)
+{
+    opus_encode_layer_t *layer = OPUS_RECORDER_DEFAULT;
+    if (!path || !opus_encode_recorder_built(layer) || !layer->encoder_el || s_save_task) return -1;
+    if (strlen(path) + sizeof(".idx") > sizeof(s_save_path)) return -1;
+    strcpy(s_save_path, path);
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to open %s", path);
+        return -1;
+    }
+    // 封装器已按存储块攒满再写，再经 stdio 缓冲只会多一次拷贝
+    setvbuf(f, NULL, _IONBF, 0);
+
+    // 编码端延迟 = 攒满一帧 + 编码器前瞻，前瞻部分即播放端须丢弃的 pre-skip
+    const audio_latency_profile_t *profile = audio_latency_get_profile();
+    uint32_t frame_us = layer->cfg.frame_us ? (uint32_t)layer->cfg.frame_us : (uint32_t)profile->opus_frame_us;
+    uint32_t delay_us = opus_pkt_encoder_get_delay_us(layer->encoder_el);
+    uint32_t lookahead_us = delay_us > frame_us ? delay_us - frame_us : 0;
+
+    ogg_opus_writer_cfg_t cfg = DEFAULT_OGG_OPUS_WRITER_CONFIG();
+    cfg.write = opus_encode_recorder_file_write;
+    cfg.ctx = f;
+    cfg.sample_rate = AUDIO_CAPTURE_SAMPLE_RATE;
+    cfg.channels = 1;
+    cfg.pre_skip = (uint16_t)((uint64_t)lookahead_us * OGG_OPUS_RATE / 1000000);
+    ogg_opus_writer_t *w = ogg_opus_writer_create(&cfg);
+    if (!w) {
+        ESP_LOGE(OPUS_RECORDER_TAG, "Failed to create ogg writer");
+        fclose(f);
+        return -1;
+    }
+
+    // 丢弃开始保存前积压的包，文件从当前时刻开始；预录层则从整段预录历史开始
+    if (layer->preroll) {
+        opus_encode_layer_trigger(layer, layer->preroll_ms);
+    } else {
+        opus_encode_recorder_drain(layer);
+    }
+    memset(&s_save_stats, 0, sizeof(s_save_stats));
+    opus_encode_recorder_sync_init();
+    xSemaphoreTake(s_save_done, 0);
+    s_save_file = f;
+    s_saving = true;
+    if (xTaskCreatePinnedToCore(opus_encode_recorder_save_task, "rec_save", OPUS_RECORDER_SAVE_STACK, w,
+                                profile->task_prio - 1, &s_save_task, profile->capture_core) != pdPASS) {
+        s_saving = false;
+        s_save_task = NULL;
+        s_save_file = NULL;
+        ogg_opus_writer_destroy(w);
+        fclose(f);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 结束保存：写出结束页与索引文件并关闭，等保存任务退出后返回
+ */
+void opus_encode_recorder_save_stop(void)
+{
+    if (!s_save_task) return;
+    s_saving = false;
+    // 保存任务每 OPUS_RECORDER_SAVE_WAIT_MS 检查一次运行标志，写完结束页与索引后给出退出信号
+    while (s_save_task) {
+        if (xSemaphoreTake(s_save_done, pdMS_TO_TICKS(OPUS_RECORDER_SAVE_JOIN_MS)) != pdTRUE) {
+            ESP_LOGW(OPUS_RECORDER_TAG, "waiting for save task to finish %s", s_save_path);
+        }
+    }
+}
+
+/**
+ * @brief 获取最近一次保存的封装统计
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int opus_encode_recorder_get_save_stats(ogg_opus_writer_stats_t *stats)
+{
+    if (!stats) return -1;
+    *stats = s_save_stats;
+    return 0;
 }
@@ -11,40 +11,445 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include "opus_packet_slab.h"
+#include "opus_packet_codec.h"
+#include "audio_latency.h"
+#include "audio_lifecycle.h"
+#include "ogg_opus.h"
+#include "audio_graph.h"
+#include "noise_suppress.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define OPUS_RECORDER_WAIT_FOREVER UINT32_MAX   // 一直等待直到有包
+#define OPUS_RECORDER_MAX_LAYERS   3            // 同播编码层数上限（含默认层，每层约一个libopus编码器状态的片内SRAM）
+
+/**
+ * @brief 编码层配置（同播：同一路采集按不同比特率/帧长编码成多路码流）
+ */
+typedef struct {
+    int  bitrate;               // 初始比特率（bps），0 为编码器默认值
+    int  frame_us;              // 帧长（微秒，2500~60000），0 跟随延迟档位
+    int  complexity;            // 初始编码复杂度 0~10，-1 为编码器默认值
+    bool dtx;                   // 静音段只发保活包
+    bool adaptive;              // 复杂度按编码耗时、比特率/FEC按该层接收端反馈自适应
+    bool fec;                   // 初始即开启带内FEC（LBRR，丢包时由下一包恢复本帧）
+    uint8_t red_depth;          // 每包附带前几帧的编码数据（0 ~ OPUS_RED_MAX_DEPTH），接收端须 opus_decode_play_set_red()
+} opus_encode_layer_cfg_t;
+
+#define DEFAULT_OPUS_ENCODE_LAYER_CONFIG() {    \
+    .bitrate    = 0,                            \
+    .frame_us   = 0,                            \
+    .complexity = -1,                           \
+    .dtx        = true,                         \
+    .adaptive   = true,                         \
+    .fec        = false,                        \
+    .red_depth  = 0,                            \
+}
+
+typedef struct opus_encode_layer opus_encode_layer_t;
+
 /**
- * @brief 启动Opus编码录制任务
+ * @brief 启动Opus编码录制
  *
- * 该函数会创建并启动一个后台任务，负责从I2S等音频输入接口采集PCM数据，
- * 并进行Opus编码后缓存在内部缓冲区。调用此函数后，可通过
- * opus_encode_recorder_read()接口持续读取Opus编码数据。
+ * 首次调用时构建录制管道：从共享采集前端（audio_capture）获取16kHz PCM数据，
+ * 按默认层与 opus_encode_recorder_layer_add() 添加的各层分别进行Opus编码后缓存在各层的包slab中。调用此函数后，可通过
+ * opus_encode_recorder_acquire()/opus_encode_recorder_release() 零拷贝获取Opus包，
+ * 或通过 opus_encode_recorder_read() 逐包读取。
+ * 停止之后再次启动只恢复已暂停的管道（先丢弃残留包并冲刷编码器），不创建任务、不分配内存。
+ * 预录层（opus_encode_recorder_set_preroll()）在开机时启动一次即可常开，由 opus_encode_recorder_trigger() 开始取包。
  */
 void opus_encode_recorder_start(void);
 
 /**
- * @brief 停止Opus编码录制任务
+ * @brief 停止Opus编码录制
  *
- * 该函数会终止后台的Opus编码录制任务，释放相关资源。
- * 停止后如需再次录制需重新调用 opus_encode_recorder_start()。
+ * 暂停录制管道与采集订阅，等各元素确认暂停后返回；管道、编码器与slab保留，
+ * 停止前已编码的包仍可取出，再次启动前须全部归还。
+ * 所有订阅者都停止时共享采集前端也随之暂停。
  */
 void opus_encode_recorder_stop(void);
 
 /**
- * @brief 读取Opus编码数据
+ * @brief 释放录制管道、采集订阅与包slab
+ *
+ * 运行或暂停状态均可调用；之后再次 opus_encode_recorder_start() 会重新构建。
+ */
+void opus_encode_recorder_deinit(void);
+
+/**
+ * @brief 获取录制管道的启停统计：构建/启动/停止次数与耗时、启动到首块数据的耗时
+ *
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int opus_encode_recorder_get_lifecycle(audio_lifecycle_stats_t *stats);
+
+/**
+ * @brief 选择录制链路的执行引擎，下次构建（首次启动或 deinit 之后）生效
+ *
+ * AUDIO_ENGINE_ADF：[capture reader] -> [opus] 两个元素任务，经一个环形缓冲区；
+ * AUDIO_ENGINE_GRAPH：一个任务取采集块后按指针直接交给编码器，省去读取元素任务、环形缓冲区与一次拷贝。
+ * 两种引擎的启停、取包、统计与参数接口完全相同。
+ *
+ * @param engine 执行引擎
+ */
+void opus_encode_recorder_set_engine(audio_engine_t engine);
+
+/**
+ * @brief 获取处理图引擎的统计
+ *
+ * @param stats 整图统计，可为NULL
+ * @param nodes 节点统计数组，可为NULL
+ * @param max   nodes 容量
+ * @return 写入 nodes 的条目数，未以处理图运行返回-1
+ */
+int opus_encode_recorder_get_graph_stats(audio_graph_stats_t *stats, audio_graph_node_stats_t *nodes, int max);
+
+/**
+ * @brief 设置编码前降噪：采集之后、编码之前做频谱降噪，所有层编码降噪后的数据（下次构建生效）
+ *
+ * 处理图引擎下作为链首节点只做一次；ADF引擎下每层管道插入一个降噪元素 [capture] -> [ns] -> [opus]。
+ * 输出延迟增加 delay_samples（16kHz下6ms），计入 opus_encode_recorder_get_latency()。
+ * DTX的语音检测在降噪输出上进行，按 VOICE_ACTIVITY_DENOISED_CONFIG() 适应残余噪声的起伏。
+ *
+ * @param cfg 降噪配置，只取 level 与 budget_us；NULL 关闭降噪（默认关闭）
+ */
+void opus_encode_recorder_set_ns(const noise_suppress_cfg_t *cfg);
+
+/**
+ * @brief 运行中调整降噪强度，下一个10ms帧生效
+ *
+ * @return 0，强度非法返回-1
+ */
+int opus_encode_recorder_set_ns_level(noise_suppress_level_t level);
+
+/**
+ * @brief 获取降噪统计
+ *
+ * @return 0，未启用降噪或未构建返回-1
+ */
+int opus_encode_recorder_get_ns_stats(noise_suppress_stats_t *stats);
+
+/**
+ * @brief 添加一个同播编码层（须在首次启动之前或 deinit 之后调用）
+ *
+ * 每层有独立的libopus编码器、包slab、VAD/DTX与参数自适应，各自的比特率与帧长；
+ * 所有层共用同一个采集前端，采集、格式转换与重采样只做一次，各层与默认层一起启停。
+ * 处理图引擎下各层在同一个任务内按指针读同一个采集块依次编码；ADF引擎下每层另有一个读取元素与编码元素任务。
+ * 添加的层在 deinit 后保留，下次启动时按原配置重建。
+ *
+ * @param cfg 层配置
+ * @return 层句柄，已构建、层数已满或参数非法返回NULL
+ */
+opus_encode_layer_t *opus_encode_recorder_layer_add(const opus_encode_layer_cfg_t *cfg);
+
+/**
+ * @brief 移除一个同播编码层（须在首次启动之前或 deinit 之后调用），之后句柄失效；默认层不可移除
+ */
+void opus_encode_recorder_layer_remove(opus_encode_layer_t *layer);
+
+/**
+ * @brief 获取默认层句柄，不带句柄的取包、参数、统计与保存接口都作用于默认层
+ */
+opus_encode_layer_t *opus_encode_recorder_default_layer(void);
+
+/**
+ * @brief 设置默认层的配置（须在首次启动之前或 deinit 之后调用）
+ *
+ * @param cfg 层配置
+ * @return 成功返回0，已构建或参数非法返回-1
+ */
+int opus_encode_recorder_set_default_layer(const opus_encode_layer_cfg_t *cfg);
+
+/**
+ * @brief 获取一层的下一个完整Opus包（零拷贝），语义同 opus_encode_recorder_acquire()
+ *
+ * 每层的包只有一个消费端，不同层可由不同任务读取。
+ *
+ * @param layer      层句柄
+ * @param pkt        输出参数，指向该层slab中的包
+ * @param timeout_ms 最长等待时间（毫秒），OPUS_RECORDER_WAIT_FOREVER 表示一直等待
+ * @return 成功返回0，未运行、默认层正在保存到文件或超时返回-1
+ */
+int opus_encode_layer_acquire(opus_encode_layer_t *layer, const opus_packet_t **pkt, uint32_t timeout_ms);
+
+/**
+ * @brief 归还由 opus_encode_layer_acquire() 获取的包
+ */
+void opus_encode_layer_release(opus_encode_layer_t *layer, const opus_packet_t *pkt);
+
+/**
+ * @brief 从一层读取一个完整的Opus包，没有包时立即返回，语义同 opus_encode_recorder_try_read()
+ */
+int opus_encode_layer_try_read(opus_encode_layer_t *layer, uint8_t *data, size_t len);
+
+/**
+ * @brief 一次取出一层当前已有的最多 max 个包，语义同 opus_encode_recorder_acquire_batch()
+ */
+int opus_encode_layer_acquire_batch(opus_encode_layer_t *layer, const opus_packet_t **pkts, int max);
+
+/**
+ * @brief 按取出顺序一次归还一层最早的 count 个包
+ */
+void opus_encode_layer_release_batch(opus_encode_layer_t *layer, int count);
+
+/**
+ * @brief 设置一层包slab的水位通知，语义同 opus_encode_recorder_set_watermarks()
+ */
+void opus_encode_layer_set_watermarks(opus_encode_layer_t *layer, uint32_t high, uint32_t low,
+                                      opus_packet_slab_watermark_t cb, void *ctx);
+
+/**
+ * @brief 获取一层的编码统计
+ *
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_layer_get_stats(opus_encode_layer_t *layer, opus_pkt_encoder_stats_t *stats);
+
+/**
+ * @brief 调整一层运行中编码器的参数，下一个帧边界生效，不影响其他层
+ *
+ * @return 成功返回0，未运行或参数非法返回-1
+ */
+int opus_encode_layer_set_params(opus_encode_layer_t *layer, const opus_rate_params_t *params);
+
+/**
+ * @brief 获取一层当前生效的编码参数
+ *
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_layer_get_params(opus_encode_layer_t *layer, opus_rate_params_t *params);
+
+/**
+ * @brief 上报一层接收端的反馈（丢包率与带宽），只驱动该层的比特率/FEC自适应
+ *
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_layer_report_link(opus_encode_layer_t *layer, uint8_t loss_pct, uint32_t bandwidth_bps);
+
+/**
+ * @brief 把一层设为预录层（仅在未构建时：首次启动之前或 deinit 之后）
+ *
+ * 预录层的编码器常开，包写入PSRAM中的预录环（取代包slab），未触发时覆盖最旧的包、只保留最近
+ * history_ms 的历史，取包接口无包可取。环容量按层比特率（自适应时按比特率上限）估算。
+ * 常开的CPU开销可用较低复杂度与DTX压低：静音段不编码，只写保活包。
+ *
+ * @param history_ms 历史时长（毫秒，不超过30秒），0 恢复为普通层
+ * @return 成功返回0，已在运行或时长超出上限返回-1
+ */
+int opus_encode_layer_set_preroll(opus_encode_layer_t *layer, uint32_t history_ms);
+
+/**
+ * @brief 触发预录层（按键、唤醒词、远程命令等）
+ *
+ * 编码器在下一个帧边界上（不超过一帧）定位到触发前 history_ms 处的包，此后取包接口
+ * （acquire/read/try_read，批量接口每次1个）先交出这段历史，再无缝接上实时包：序号与时间戳连续，
+ * 包数据直接位于预录环内，不拷贝。历史不足时从最旧的包开始。
+ * 触发期间编码器不覆盖未取走的包，读取者跟不上、环满时丢弃新包；用完须调用 opus_encode_layer_disarm()。
  *
- * @param data 指向用于存放Opus编码数据的缓冲区指针
- * @param len  期望读取的数据长度（字节数）
- * @return 实际读取的字节数，失败返回-1
+ * @param history_ms 回溯时长（毫秒）
+ * @return 成功返回0，未运行或不是预录层返回-1
+ */
+int opus_encode_layer_trigger(opus_encode_layer_t *layer, uint32_t history_ms);
+
+/**
+ * @brief 解除触发，回到只保留历史的状态；此前取出未归还的包随即失效
+ */
+void opus_encode_layer_disarm(opus_encode_layer_t *layer);
+
+/**
+ * @brief 获取预录层的统计：环占用、覆盖与丢弃的包数、最近一次触发交出的历史包数与时长
  *
- * 该接口用于从内部缓冲区读取Opus编码后的数据，通常用于网络发送或本地存储。
- * 数据由后台任务自动采集和编码，调用本接口可获取最新的编码数据。
+ * @return 成功返回0，未运行或不是预录层返回-1
+ */
+int opus_encode_layer_get_preroll_stats(opus_encode_layer_t *layer, opus_preroll_stats_t *stats);
+
+/**
+ * @brief 获取下一个完整的Opus包（零拷贝）
+ *
+ * @param pkt        输出参数，指向内部slab中的包（含长度、序号、时间戳）
+ * @param timeout_ms 最长等待时间（毫秒），OPUS_RECORDER_WAIT_FOREVER 表示一直等待
+ * @return 成功返回0，未运行或超时返回-1
+ *
+ * 包数据可直接用于网络发送或存储，无需拷贝；使用完毕后必须调用
+ * opus_encode_recorder_release() 归还，且须按获取顺序逐个归还。
+ */
+int opus_encode_recorder_acquire(const opus_packet_t **pkt, uint32_t timeout_ms);
+
+/**
+ * @brief 归还由 opus_encode_recorder_acquire() 获取的包
+ *
+ * @param pkt 待归还的包
+ */
+void opus_encode_recorder_release(const opus_packet_t *pkt);
+
+/**
+ * @brief 读取一个完整的Opus包
+ *
+ * @param data 指向用于存放Opus包的缓冲区指针
+ * @param len  缓冲区大小（字节数）
+ * @return 包长度（字节数），失败或缓冲区不足返回-1（缓冲区不足时丢弃该包，计入统计的 read_dropped）
+ *
+ * 兼容接口，内部基于 acquire/release 实现，每次返回一个完整的包并拷贝一次；
+ * 没有包时一直等待，网络任务不应阻塞时改用 opus_encode_recorder_try_read()；
+ * 对性能敏感的调用者应直接使用 opus_encode_recorder_acquire()/opus_encode_recorder_acquire_batch()。
  */
 int opus_encode_recorder_read(uint8_t *data, size_t len);
 
+/**
+ * @brief 读取一个完整的Opus包，没有包时立即返回
+ *
+ * 与 opus_encode_recorder_read() 相同但从不等待，网络任务可在自己的收发循环中轮询而不被音频阻塞。
+ *
+ * @param data 指向用于存放Opus包的缓冲区指针
+ * @param len  缓冲区大小（字节数）
+ * @return 包长度（字节数），暂无包返回0，未运行、正在保存或缓冲区不足返回-1（缓冲区不足时丢弃该包）
+ */
+int opus_encode_recorder_try_read(uint8_t *data, size_t len);
+
+/**
+ * @brief 一次取出当前已有的最多 max 个包（零拷贝，不阻塞）
+ *
+ * 消费端下标只读一次，适合网络任务把积压的包合并成一次发送；
+ * 用完后以 opus_encode_recorder_release_batch() 一次归还（可少于取出的个数，其余下次仍会返回）。
+ *
+ * @param pkts 输出参数，指向内部slab中的包（按编码顺序）
+ * @param max  最多取出的个数
+ * @return 取出的包数，暂无包返回0，未运行或正在保存到文件返回-1
+ */
+int opus_encode_recorder_acquire_batch(const opus_packet_t **pkts, int max);
+
+/**
+ * @brief 按取出顺序一次归还最早的 count 个包
+ *
+ * @param count 归还的个数
+ */
+void opus_encode_recorder_release_batch(int count);
+
+/**
+ * @brief 设置包slab的水位通知
+ *
+ * 未取走的包数升到 high 时在编码任务中回调 cb(ctx, true)（网络发送跟不上），
+ * 取走后回落到 low 时在读取方任务中回调 cb(ctx, false)；回调须非常短且不阻塞。
+ * 建议在 opus_encode_recorder_start() 之前设置，设置一次对之后的每次构建都生效。
+ *
+ * @param high 高水位（包，不超过16），0 为关闭通知
+ * @param low  低水位（包），须小于 high
+ * @param cb   回调
+ * @param ctx  回调上下文
+ */
+void opus_encode_recorder_set_watermarks(uint32_t high, uint32_t low, opus_packet_slab_watermark_t cb, void *ctx);
+
+/**
+ * @brief 当前是否检测到语音
+ *
+ * 录制默认启用DTX：静音段不编码，只每 OPUS_PKT_DTX_KEEPALIVE_MS 产生一个舒适噪声/保活包，
+ * 因此静音期间 acquire 会长时间等不到包。
+ *
+ * @return 最近一帧为语音（含拖尾）返回true，静音或未运行返回false
+ */
+bool opus_encode_recorder_is_speech(void);
+
+/**
+ * @brief 获取编码统计：VAD状态与噪声底、DTX跳过的帧数、已产生的包数与字节数
+ *
+ * @param stats 输出统计
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_get_stats(opus_pkt_encoder_stats_t *stats);
+
+/**
+ * @brief 统计录制链路当前的按级缓冲延迟
+ *
+ * @param report 输出报告：I2S DMA、各环形缓冲区、重采样、扇出队列、编码帧长与前瞻、未取走的包
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_get_latency(audio_latency_report_t *report);
+
+/**
+ * @brief 调整运行中编码器的比特率、复杂度、帧长、FEC与预期丢包率
+ *
+ * 在下一个帧边界原地生效，不重建管道、不打断音频。录制默认启用自适应：
+ * 复杂度按实测编码耗时自动升降，比特率/FEC跟随 opus_encode_recorder_report_link() 的反馈，
+ * 此处设置的参数作为自适应的新起点。帧长变化时接收端须按包的实际时长计时。
+ *
+ * @param params 新参数
+ * @return 成功返回0，未运行或参数非法返回-1
+ */
+int opus_encode_recorder_set_params(const opus_rate_params_t *params);
+
+/**
+ * @brief 获取当前生效的编码参数
+ *
+ * @param params 输出参数
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_get_params(opus_rate_params_t *params);
+
+/**
+ * @brief 上报接收端反馈（如RTCP接收报告中的丢包率、带宽估计），驱动比特率/FEC自适应
+ *
+ * 可在任意任务调用，按反馈周期（通常约1秒）调用即可。
+ *
+ * @param loss_pct      丢包率（%）
+ * @param bandwidth_bps 可用带宽（bps，含包头开销），0 表示未知、只按丢包率调整
+ * @return 成功返回0，未运行返回-1
+ */
+int opus_encode_recorder_report_link(uint8_t loss_pct, uint32_t bandwidth_bps);
+
+/**
+ * @brief 把默认层设为预录层（仅在未构建时），见 opus_encode_layer_set_preroll()
+ *
+ * @param history_ms 历史时长（毫秒），0 恢复为普通录制
+ * @return 成功返回0，已在运行或时长超出上限返回-1
+ */
+int opus_encode_recorder_set_preroll(uint32_t history_ms);
+
+/**
+ * @brief 触发默认层的预录：取包接口先交出触发前 history_ms 内的历史，再接上实时包，见 opus_encode_layer_trigger()
+ *
+ * @param history_ms 回溯时长（毫秒）
+ * @return 成功返回0，未运行或不是预录层返回-1
+ */
+int opus_encode_recorder_trigger(uint32_t history_ms);
+
+/**
+ * @brief 解除默认层的预录触发，见 opus_encode_layer_disarm()
+ */
+void opus_encode_recorder_disarm(void);
+
+/**
+ * @brief 开始把录制的包保存为Ogg-Opus文件（须在录制运行时调用）
+ *
+ * 后台任务逐包封装，按存储块（OGG_OPUS_BLOCK_SIZE）攒满后整块写出，DTX静音段补写空帧保持时间轴；
+ * 结束时另写出 path.idx 时间索引，供 opus_decode_play_file_start() 直接定位。
+ * 保存期间保存任务独占包的消费端，opus_encode_recorder_acquire()/read() 返回-1。
+ * 默认层为预录层时，文件从整段预录历史开始并接上实时包，结束保存后自动解除触发。
+ *
+ * @param path 文件路径
+ * @return 成功返回0，未运行、已在保存、路径过长或打开失败返回-1
+ */
+int opus_encode_recorder_save_start(const char *path);
+
+/**
+ * @brief 结束保存：写出结束页与索引文件并关闭文件
+ *
+ * opus_encode_recorder_stop()/deinit() 会先自动调用。
+ */
+void opus_encode_recorder_save_stop(void);
+
+/**
+ * @brief 获取最近一次保存的封装统计：包数、补写的空帧数、页数、文件字节数与写调用次数
+ *
+ * @param stats 输出统计
+ * @return 成功返回0，参数无效返回-1
+ */
+int opus_encode_recorder_get_save_stats(ogg_opus_writer_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
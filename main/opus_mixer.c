@@ -0,0 +1,362 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 09:00:00
+ * @LastEditTime: 2026-10-17 09:00:00
+ * @LastEditors: 星年
+ * @Description: 多路包解码混音实现，纯C，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\opus_mixer.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include <stdatomic.h>
+#include "opus_mixer.h"
+#include "opus_red.h"
+
+/**
+ * @brief 路状态：控制任务只做 CLOSED -> PENDING 与 -> CLOSED，PENDING -> OPEN 由混音任务在复位后完成
+ */
+enum {
+    MIXER_STREAM_CLOSED = 0,
+    MIXER_STREAM_PENDING,       // 已打开，等混音任务复位抖动缓冲与解码器
+    MIXER_STREAM_OPEN,
+};
+
+struct opus_mixer_stream {
+    uint8_t id;                     // 路编号（opus_packet_t.stream）
+    _Atomic uint8_t state;          // 路状态
+    _Atomic uint16_t gain;          // 增益（Q15）
+    bool playing;                   // 最近一帧有输出
+    bool dtx;                       // 最近一个包是DTX包
+    uint8_t plc_run;                // 连续缺包帧数
+    jitter_buffer_t *jb;            // 抖动缓冲
+    void *codec;                    // 解码器状态
+    uint32_t decoded;
+    uint32_t skipped;
+    uint32_t errors;
+};
+
+struct opus_mixer {
+    opus_mixer_cfg_t cfg;               // 配置
+    int frame_samples;                  // 每通道每帧样点数（FEC/PLC/静音帧按此长度）
+    int max_frame_samples;              // 每通道最大帧样点数
+    int16_t *scratch;                   // 第二路起的解码缓冲（最大帧长）
+    opus_mixer_stats_t stats;           // 统计
+    opus_mixer_stream_t streams[OPUS_MIXER_MAX_STREAMS];
+};
+
+static bool mixer_cfg_valid(const opus_mixer_cfg_t *cfg)
+{
+    return cfg && cfg->codec && cfg->codec->state_size && cfg->codec->init && cfg->codec->decode &&
+           cfg->sample_rate > 0 && cfg->channels > 0 && cfg->frame_us > 0 &&
+           cfg->max_streams > 0 && cfg->max_streams <= OPUS_MIXER_MAX_STREAMS;
+}
+
+static void mixer_jb_cfg(const opus_mixer_cfg_t *cfg, jitter_buffer_cfg_t *jb_cfg)
+{
+    jitter_buffer_cfg_t def = DEFAULT_JITTER_BUFFER_CONFIG();
+    *jb_cfg = def;
+    jb_cfg->frame_us = (uint32_t)cfg->frame_us;
+    jb_cfg->slot_count = cfg->jitter_slots;
+    jb_cfg->slot_size = cfg->jitter_slot_size;
+    jb_cfg->min_depth_ms = cfg->jitter_min_ms;
+    jb_cfg->max_depth_ms = cfg->jitter_max_ms;
+    jb_cfg->fec = cfg->fec;
+    jb_cfg->arena = cfg->arena;
+}
+
+static size_t mixer_max_frame_samples(const opus_mixer_cfg_t *cfg)
+{
+    return (size_t)cfg->sample_rate * OPUS_MIXER_MAX_FRAME_MS / 1000;
+}
+
+size_t opus_mixer_mem_size(const opus_mixer_cfg_t *cfg, audio_arena_place_t place)
+{
+    if (!mixer_cfg_valid(cfg)) {
+        return 0;
+    }
+    jitter_buffer_cfg_t jb_cfg;
+    mixer_jb_cfg(cfg, &jb_cfg);
+    size_t jb = jitter_buffer_mem_size(&jb_cfg, place);
+    if (place == AUDIO_ARENA_PSRAM) {
+        return cfg->max_streams * jb;
+    }
+    size_t per_stream = jb + AUDIO_ARENA_SIZE(cfg->codec->state_size(cfg->channels));
+    return AUDIO_ARENA_SIZE(sizeof(opus_mixer_t)) +
+           AUDIO_ARENA_SIZE(mixer_max_frame_samples(cfg) * cfg->channels * sizeof(int16_t)) +
+           cfg->max_streams * per_stream;
+}
+
+opus_mixer_t *opus_mixer_create(const opus_mixer_cfg_t *cfg)
+{
+    if (!mixer_cfg_valid(cfg)) {
+        return NULL;
+    }
+    audio_arena_t *arena = cfg->arena;
+    opus_mixer_t *mix = audio_arena_calloc(arena, 1, sizeof(opus_mixer_t), AUDIO_ARENA_INTERNAL);
+    if (!mix) {
+        return NULL;
+    }
+    mix->cfg = *cfg;
+    mix->frame_samples = (int)((int64_t)cfg->sample_rate * cfg->frame_us / 1000000);
+    mix->max_frame_samples = (int)mixer_max_frame_samples(cfg);
+    mix->scratch = audio_arena_calloc(arena, (size_t)mix->max_frame_samples * cfg->channels, sizeof(int16_t),
+                                      AUDIO_ARENA_INTERNAL);
+    if (!mix->scratch) {
+        opus_mixer_destroy(mix);
+        return NULL;
+    }
+
+    // 各路一次性分配，解码器状态每帧访问放片内，包数据由抖动缓冲放PSRAM
+    jitter_buffer_cfg_t jb_cfg;
+    mixer_jb_cfg(cfg, &jb_cfg);
+    size_t state_size = cfg->codec->state_size(cfg->channels);
+    for (uint8_t i = 0; i < cfg->max_streams; i++) {
+        opus_mixer_stream_t *s = &mix->streams[i];
+        s->id = i;
+        s->jb = jitter_buffer_create(&jb_cfg);
+        s->codec = audio_arena_calloc(arena, 1, state_size, AUDIO_ARENA_INTERNAL);
+        if (!s->jb || !s->codec || cfg->codec->init(s->codec, cfg->sample_rate, cfg->channels) != 0) {
+            opus_mixer_destroy(mix);
+            return NULL;
+        }
+    }
+    return mix;
+}
+
+void opus_mixer_destroy(opus_mixer_t *mix)
+{
+    if (!mix) {
+        return;
+    }
+    audio_arena_t *arena = mix->cfg.arena;
+    for (int i = 0; i < OPUS_MIXER_MAX_STREAMS; i++) {
+        jitter_buffer_destroy(mix->streams[i].jb);
+        audio_arena_free(arena, mix->streams[i].codec);
+    }
+    audio_arena_free(arena, mix->scratch);
+    audio_arena_free(arena, mix);
+}
+
+opus_mixer_stream_t *opus_mixer_open(opus_mixer_t *mix, uint16_t gain)
+{
+    if (!mix) {
+        return NULL;
+    }
+    for (int i = 0; i < mix->cfg.max_streams; i++) {
+        opus_mixer_stream_t *s = &mix->streams[i];
+        uint8_t closed = MIXER_STREAM_CLOSED;
+        if (atomic_compare_exchange_strong(&s->state, &closed, MIXER_STREAM_PENDING)) {
+            opus_mixer_set_gain(s, gain);
+            return s;
+        }
+    }
+    return NULL;
+}
+
+void opus_mixer_close(opus_mixer_stream_t *s)
+{
+    if (s) {
+        atomic_store(&s->state, MIXER_STREAM_CLOSED);
+    }
+}
+
+void opus_mixer_set_gain(opus_mixer_stream_t *s, uint16_t gain)
+{
+    if (s) {
+        atomic_store(&s->gain, gain > AUDIO_MIX_UNITY ? AUDIO_MIX_UNITY : gain);
+    }
+}
+
+uint8_t opus_mixer_stream_id(const opus_mixer_stream_t *s)
+{
+    return s ? s->id : 0;
+}
+
+/**
+ * @brief 混音任务侧：取路状态，PENDING 的路先复位再置为 OPEN
+ *
+ * @return true 该路已打开
+ */
+static bool mixer_stream_active(opus_mixer_t *mix, opus_mixer_stream_t *s)
+{
+    uint8_t state = atomic_load(&s->state);
+    if (state == MIXER_STREAM_OPEN) {
+        return true;
+    }
+    if (state != MIXER_STREAM_PENDING) {
+        s->playing = false;
+        return false;
+    }
+    jitter_buffer_reset(s->jb);
+    mix->cfg.codec->init(s->codec, mix->cfg.sample_rate, mix->cfg.channels);
+    s->playing = false;
+    s->dtx = false;
+    s->plc_run = 0;
+    s->decoded = 0;
+    s->skipped = 0;
+    s->errors = 0;
+    // 复位期间被关闭时保持关闭
+    return atomic_compare_exchange_strong(&s->state, &state, MIXER_STREAM_OPEN);
+}
+
+int opus_mixer_put(opus_mixer_t *mix, const opus_packet_t *pkt)
+{
+    if (!mix || !pkt) {
+        return -1;
+    }
+    if (pkt->stream >= mix->cfg.max_streams || !mixer_stream_active(mix, &mix->streams[pkt->stream])) {
+        mix->stats.orphan++;
+        return -1;
+    }
+    jitter_buffer_t *jb = mix->streams[pkt->stream].jb;
+    if (!mix->cfg.red) {
+        return jitter_buffer_put(jb, pkt->data, pkt->len, pkt->seq, pkt->arrival_ms);
+    }
+    opus_red_block_t blocks[OPUS_RED_MAX_DEPTH + 1];
+    int n = opus_red_parse(pkt->data, pkt->len, blocks, OPUS_RED_MAX_DEPTH + 1);
+    if (n <= 0) {
+        mix->stats.malformed++;
+        return -1;
+    }
+    // 主负载先入缓冲以推进最大序号，冗余块随后只填补此前的空位
+    int ret = jitter_buffer_put(jb, blocks[n - 1].data, blocks[n - 1].len, pkt->seq, pkt->arrival_ms);
+    for (int i = 0; i < n - 1; i++) {
+        jitter_buffer_put_redundant(jb, blocks[i].data, blocks[i].len, (uint16_t)(pkt->seq - blocks[i].distance));
+    }
+    return ret;
+}
+
+/**
+ * @brief 判定本帧是否跳过解码
+ *
+ * DTX包与长时间缺包时解码器只会输出舒适噪声或衰减中的隐藏信号，多路会议中可以忽略；
+ * 跳过后解码器状态不再推进，下一个正常包到来时从该包继续解码。
+ */
+static bool mixer_stream_skip(opus_mixer_stream_t *s, jitter_frame_type_t type, uint16_t len, uint16_t gain)
+{
+    switch (type) {
+    case JITTER_FRAME_NORMAL:
+        s->plc_run = 0;
+        s->dtx = len <= OPUS_MIXER_DTX_BYTES;
+        break;
+    case JITTER_FRAME_FEC:
+        s->plc_run = 0;
+        break;
+    case JITTER_FRAME_PLC:
+    default:
+        if (s->plc_run < UINT8_MAX) {
+            s->plc_run++;
+        }
+        if (s->dtx || s->plc_run > OPUS_MIXER_PLC_FRAMES) {
+            return true;
+        }
+        break;
+    }
+    return gain == 0 || s->dtx;
+}
+
+int opus_mixer_mix(opus_mixer_t *mix, int16_t *out)
+{
+    if (!mix || !out) {
+        return 0;
+    }
+    const opus_mixer_codec_t *codec = mix->cfg.codec;
+    int ch = mix->cfg.channels;
+    int out_samples = 0;
+    uint8_t playing = 0;
+    uint8_t mixed = 0;
+
+    for (int i = 0; i < mix->cfg.max_streams; i++) {
+        opus_mixer_stream_t *s = &mix->streams[i];
+        if (!mixer_stream_active(mix, s)) {
+            continue;
+        }
+        const uint8_t *data = NULL;
+        uint16_t len = 0;
+        jitter_frame_type_t type = jitter_buffer_get(s->jb, &data, &len);
+        s->playing = type != JITTER_FRAME_NONE;
+        if (!s->playing) {
+            continue;
+        }
+        playing++;
+        uint16_t gain = atomic_load(&s->gain);
+        if (mixer_stream_skip(s, type, len, gain)) {
+            s->skipped++;
+            continue;
+        }
+
+        // 首个混入的路直接解码到输出，省去一次拷贝
+        int16_t *dst = mixed ? mix->scratch : out;
+        int max = type == JITTER_FRAME_NORMAL ? mix->max_frame_samples : mix->frame_samples;
+        int n = codec->decode(s->codec, type == JITTER_FRAME_PLC ? NULL : data, type == JITTER_FRAME_PLC ? 0 : len,
+                              dst, max, type == JITTER_FRAME_FEC);
+        if (n <= 0) {
+            s->errors++;
+            mix->stats.errors++;
+            continue;
+        }
+        s->decoded++;
+        if (!mixed) {
+            audio_mix_scale_s16(out, (size_t)n * ch, gain);
+            out_samples = n;
+        } else {
+            if (n > out_samples) {
+                memset(out + out_samples * ch, 0, (size_t)(n - out_samples) * ch * sizeof(int16_t));
+                out_samples = n;
+            }
+            audio_mix_s16(out, mix->scratch, (size_t)n * ch, gain);
+        }
+        mixed++;
+    }
+
+    mix->stats.playing = playing;
+    mix->stats.mixed = mixed;
+    if (mixed > mix->stats.peak_mixed) {
+        mix->stats.peak_mixed = mixed;
+    }
+    if (!playing) {
+        return 0;
+    }
+    if (!mixed) {
+        out_samples = mix->frame_samples;
+        memset(out, 0, (size_t)out_samples * ch * sizeof(int16_t));
+        mix->stats.silent++;
+    }
+    mix->stats.ticks++;
+    return out_samples;
+}
+
+void opus_mixer_reset(opus_mixer_t *mix)
+{
+    if (!mix) {
+        return;
+    }
+    for (int i = 0; i < mix->cfg.max_streams; i++) {
+        uint8_t open = MIXER_STREAM_OPEN;
+        atomic_compare_exchange_strong(&mix->streams[i].state, &open, MIXER_STREAM_PENDING);
+    }
+}
+
+void opus_mixer_get_stream_stats(const opus_mixer_stream_t *s, opus_mixer_stream_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (!s) {
+        return;
+    }
+    stats->open = atomic_load(&s->state) != MIXER_STREAM_CLOSED;
+    stats->playing = s->playing;
+    stats->dtx = s->dtx;
+    stats->gain = atomic_load(&s->gain);
+    stats->decoded = s->decoded;
+    stats->skipped = s->skipped;
+    stats->errors = s->errors;
+    jitter_buffer_get_stats(s->jb, &stats->jb);
+}
+
+void opus_mixer_get_stats(const opus_mixer_t *mix, opus_mixer_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (mix) {
+        *stats = mix->stats;
+    }
+}
@@ -0,0 +1,192 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 09:00:00
+ * @LastEditTime: 2026-10-17 09:00:00
+ * @LastEditors: 星年
+ * @Description: 多路包解码混音：每路独立抖动缓冲与解码器状态，按播放节奏逐帧解码并按路增益饱和混音，静音/DTX路跳过解码
+ * @FilePath: \audio_manager\main\opus_mixer.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "opus_packet_slab.h"
+#include "jitter_buffer.h"
+#include "audio_arena.h"
+#include "audio_mix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPUS_MIXER_MAX_STREAMS  (8)     // 最大路数（opus_packet_t.stream 取值 0 ~ 7）
+#define OPUS_MIXER_MAX_FRAME_MS (120)   // 单包最大时长（libopus上限），决定混音缓冲大小
+#define OPUS_MIXER_DTX_BYTES    (2)     // 不超过此长度的包视为DTX/舒适噪声包，不解码
+#define OPUS_MIXER_PLC_FRAMES   (2)     // 连续缺包超过此帧数后不再做PLC（隐藏已衰减到近乎静音）
+
+/**
+ * @brief 解码器接口（与具体编解码器解耦，主机上可替换为直通实现）
+ */
+typedef struct {
+    size_t (*state_size)(int channels);                         // 单路解码器状态大小
+    int (*init)(void *state, int sample_rate, int channels);    // 初始化/复位状态，成功返回0
+    /**
+     * 解码一包：data 为NULL时做PLC，fec 非0时从 data 中取上一帧的FEC数据。
+     * 返回每通道样点数，失败返回负值。
+     */
+    int (*decode)(void *state, const uint8_t *data, int len, int16_t *pcm, int max_samples, int fec);
+} opus_mixer_codec_t;
+
+/**
+ * @brief 混音器配置
+ */
+typedef struct {
+    int sample_rate;                    // 输出采样率
+    int channels;                       // 输出通道数
+    int frame_us;                       // 每包时长（微秒），各路一致
+    uint8_t max_streams;                // 预分配的路数（1 ~ OPUS_MIXER_MAX_STREAMS）
+    uint16_t jitter_slots;              // 每路抖动缓冲包槽数
+    uint16_t jitter_slot_size;          // 每个包槽容量（字节）
+    uint16_t jitter_min_ms;             // 抖动缓冲最小目标深度
+    uint16_t jitter_max_ms;             // 抖动缓冲最大目标深度
+    const opus_mixer_codec_t *codec;    // 解码器接口
+    bool red;                           // 包为冗余封装（opus_red），拆出主负载后用冗余块补丢包
+    bool fec;                           // 发送端启用了带内FEC，缺包时用下一包的FEC数据恢复（否则做PLC）
+    audio_arena_t *arena;               // 内存区，NULL 时从堆分配
+} opus_mixer_cfg_t;
+
+#define DEFAULT_OPUS_MIXER_CONFIG() {   \
+    .sample_rate      = 16000,          \
+    .channels         = 1,              \
+    .frame_us         = 20000,          \
+    .max_streams      = 1,              \
+    .jitter_slots     = 32,             \
+    .jitter_slot_size = 512,            \
+    .jitter_min_ms    = 40,             \
+    .jitter_max_ms    = 400,            \
+    .codec            = NULL,           \
+    .red              = false,          \
+    .fec              = false,          \
+    .arena            = NULL,           \
+}
+
+/**
+ * @brief 单路统计
+ */
+typedef struct {
+    bool open;                          // 已打开
+    bool playing;                       // 最近一帧有输出（抖动缓冲已开始播放）
+    bool dtx;                           // 处于DTX静音段
+    uint16_t gain;                      // 当前增益（Q15）
+    uint32_t decoded;                   // 解码的帧数（含FEC/PLC）
+    uint32_t skipped;                   // 跳过解码的帧数（增益为0、DTX包、长时间缺包）
+    uint32_t errors;                    // 解码失败次数
+    jitter_buffer_stats_t jb;           // 抖动缓冲统计
+} opus_mixer_stream_stats_t;
+
+/**
+ * @brief 混音器统计
+ */
+typedef struct {
+    uint32_t ticks;                     // 有输出的帧数
+    uint32_t silent;                    // 有路在播放但全部跳过解码、输出静音帧的次数
+    uint32_t orphan;                    // 属于未打开的路而丢弃的包数
+    uint32_t malformed;                 // 冗余封装格式错误而丢弃的包数
+    uint32_t errors;                    // 各路解码失败总数
+    uint8_t playing;                    // 最近一帧在播放的路数
+    uint8_t mixed;                      // 最近一帧实际解码混入的路数
+    uint8_t peak_mixed;                 // 单帧混入路数峰值
+} opus_mixer_stats_t;
+
+typedef struct opus_mixer opus_mixer_t;
+typedef struct opus_mixer_stream opus_mixer_stream_t;
+
+/**
+ * @brief 创建混音器：按 max_streams 一次性分配各路抖动缓冲与解码器状态
+ *
+ * 之后打开/关闭路、收包与混音均不再分配内存。
+ *
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+opus_mixer_t *opus_mixer_create(const opus_mixer_cfg_t *cfg);
+
+/**
+ * @brief 按配置计算在 place 中所需的内存（按内存区对齐取整），用于预留内存区
+ *
+ * @return 字节数，配置非法返回0
+ */
+size_t opus_mixer_mem_size(const opus_mixer_cfg_t *cfg, audio_arena_place_t place);
+
+/**
+ * @brief 销毁混音器，所有路句柄失效
+ */
+void opus_mixer_destroy(opus_mixer_t *mix);
+
+/**
+ * @brief 打开一路
+ *
+ * 可在任意任务调用；该路的抖动缓冲与解码器由混音任务在下一次收包或混音时复位。
+ *
+ * @param mix  句柄
+ * @param gain 增益（Q15，AUDIO_MIX_UNITY 为0dB）
+ * @return 路句柄，无空闲路返回NULL
+ */
+opus_mixer_stream_t *opus_mixer_open(opus_mixer_t *mix, uint16_t gain);
+
+/**
+ * @brief 关闭一路，此后属于该路的包被丢弃，下一帧起不再混入
+ */
+void opus_mixer_close(opus_mixer_stream_t *s);
+
+/**
+ * @brief 设置一路的增益（下一帧生效，可在任意任务调用）
+ *
+ * 增益为0时该路只收包不解码，恢复后解码器从当前包继续。
+ */
+void opus_mixer_set_gain(opus_mixer_stream_t *s, uint16_t gain);
+
+/**
+ * @brief 路编号，发送到该路的包须将 opus_packet_t.stream 置为此值
+ */
+uint8_t opus_mixer_stream_id(const opus_mixer_stream_t *s);
+
+/**
+ * @brief 按 pkt->stream 将包放入对应路的抖动缓冲（只可在混音任务中调用）
+ *
+ * @return 0 成功；路未打开、迟到、重复或过长返回 -1
+ */
+int opus_mixer_put(opus_mixer_t *mix, const opus_packet_t *pkt);
+
+/**
+ * @brief 混出一帧（每个帧周期在混音任务中调用一次）
+ *
+ * 各路从抖动缓冲取帧：增益为0、DTX包、连续缺包超过 OPUS_MIXER_PLC_FRAMES 的路跳过解码；
+ * 首个混入的路直接解码到 out，其余路解码到共用缓冲后按增益饱和累加。
+ * 有路在播放但全部跳过时输出一帧静音，保持播放节奏。
+ *
+ * @param mix 句柄
+ * @param out 输出，容量至少 OPUS_MIXER_MAX_FRAME_MS 的样点，16字节对齐时混音走向量内核
+ * @return 每通道样点数；没有任何路在播放返回0
+ */
+int opus_mixer_mix(opus_mixer_t *mix, int16_t *out);
+
+/**
+ * @brief 复位所有已打开的路：清空抖动缓冲、复位解码器（由混音任务在下一次收包或混音时执行）
+ */
+void opus_mixer_reset(opus_mixer_t *mix);
+
+/**
+ * @brief 获取单路统计
+ */
+void opus_mixer_get_stream_stats(const opus_mixer_stream_t *s, opus_mixer_stream_stats_t *stats);
+
+/**
+ * @brief 获取混音器统计
+ */
+void opus_mixer_get_stats(const opus_mixer_t *mix, opus_mixer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,849 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 10:00:00
+ * @LastEditTime: 2026-10-16 10:00:00
+ * @LastEditors: 星年
+ * @Description: 基于libopus的包编解码ADF元素实现
+ * @FilePath: \audio_manager\main\opus_packet_codec.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "audio_element.h"
+#include "audio_mem.h"
+#include "audio_error.h"
+#include "ringbuf.h"
+#include "opus.h"
+#include "audio_probe.h"
+#include "opus_packet_codec.h"
+
+static const char *TAG = "OPUS_PKT_CODEC";
+
+/* ------------------------------------------------------------------ */
+/* 编码元素                                                            */
+/* ------------------------------------------------------------------ */
+
+static bool opus_pkt_frame_us_valid(int frame_us)
+{
+    // libopus 支持的帧长：2.5/5/10/20/40/60 ms
+    return frame_us == 2500 || frame_us == 5000 || frame_us == 10000 ||
+           frame_us == 20000 || frame_us == 40000 || frame_us == 60000;
+}
+
+#define OPUS_PKT_MAX_PARAM_FRAME_US 60000   // 运行中可切换到的最长帧长，帧缓冲按此一次分配
+#define OPUS_PKT_DECODER_BATCH      8       // 每次从slab成批取出的包数（一次下标推进归还一批包槽）
+
+typedef struct {
+    opus_pkt_encoder_cfg_t cfg;     // 配置
+    OpusEncoder *enc;               // libopus编码器（打开期间指向 state）
+    void *state;                    // libopus编码器状态内存，创建元素时一次分配
+    int frame_samples;              // 每帧采样点数（每通道）
+    int frame_bytes;                // 每帧PCM字节数
+    int16_t *pcm;                   // 不足一帧时的累积缓冲区
+    int pcm_fill;                   // 累积缓冲区已有字节数
+    uint16_t seq;                   // 下一个包序号
+    uint32_t timestamp;             // 下一个包时间戳
+    opus_int32 lookahead;           // 编码器前瞻采样点数
+    voice_activity_t *vad;          // 语音活动检测（仅启用DTX时创建）
+    uint32_t dtx_gap;               // 静音段内距上次发包的采样点数（0表示处于语音段）
+    uint32_t keepalive_samples;     // 静音期间发包间隔（采样点）
+    opus_pkt_encoder_stats_t stats; // 统计
+    audio_probe_t *probe;           // 性能探针（按管道注册名）
+    opus_rate_ctrl_t *ctrl;         // 参数自适应（未启用时为NULL）
+    opus_red_t *red;                // 冗余封装（red_depth 为0时为NULL）
+    portMUX_TYPE lock;              // 保护 pending
+    opus_rate_params_t pending;     // 其他任务设置、待下一帧边界生效的参数
+    volatile bool has_pending;      // pending 有效
+} opus_pkt_encoder_t;
+
+/**
+ * @brief DTX判定：返回true表示本帧不编码、不发送
+ */
+static bool _opus_pkt_dtx_skip(opus_pkt_encoder_t *enc, const int16_t *pcm)
+{
+    if (!enc->vad) {
+        return false;
+    }
+    enc->stats.speech = voice_activity_process(enc->vad, pcm, enc->frame_samples);
+    if (enc->stats.speech) {
+        enc->dtx_gap = 0;
+        return false;
+    }
+    // 静音段首帧与此后每个保活间隔各发一包，其余帧跳过
+    if (enc->dtx_gap > 0 && enc->dtx_gap < enc->keepalive_samples) {
+        enc->dtx_gap += enc->frame_samples;
+        enc->stats.dtx_frames++;
+        return true;
+    }
+    enc->dtx_gap = enc->frame_samples;
+    enc->stats.keepalive++;
+    return false;
+}
+
+/**
+ * @brief 将参数通过 opus_encoder_ctl 原地应用到编码器（只在帧边界、编码任务中调用）
+ */
+static void _opus_pkt_encoder_apply(opus_pkt_encoder_t *enc, const opus_rate_params_t *p)
+{
+    opus_rate_params_t *cur = &enc->stats.params;
+    if (p->bitrate != cur->bitrate) {
+        opus_encoder_ctl(enc->enc, OPUS_SET_BITRATE(p->bitrate));
+    }
+    if (p->complexity != cur->complexity) {
+        opus_encoder_ctl(enc->enc, OPUS_SET_COMPLEXITY(p->complexity));
+    }
+    if (p->fec != cur->fec) {
+        opus_encoder_ctl(enc->enc, OPUS_SET_INBAND_FEC(p->fec ? 1 : 0));
+    }
+    if (p->loss_pct != cur->loss_pct) {
+        opus_encoder_ctl(enc->enc, OPUS_SET_PACKET_LOSS_PERC(p->loss_pct));
+    }
+    if (p->frame_us != cur->frame_us) {
+        // 帧缓冲按最长帧分配，此处只改凑帧长度；libopus 按每次传入的样点数决定包时长
+        enc->frame_samples = (int)((int64_t)enc->cfg.sample_rate * p->frame_us / 1000000);
+        enc->frame_bytes = enc->frame_samples * enc->cfg.channels * sizeof(int16_t);
+    }
+    *cur = *p;
+    enc->stats.param_changes++;
+}
+
+/**
+ * @brief 帧边界：先应用其他任务设置的参数，再由自适应计算下一帧的参数
+ */
+static void _opus_pkt_encoder_next_params(opus_pkt_encoder_t *enc)
+{
+    opus_rate_params_t p;
+    bool manual = false;
+    if (enc->has_pending) {
+        portENTER_CRITICAL(&enc->lock);
+        p = enc->pending;
+        manual = enc->has_pending;
+        enc->has_pending = false;
+        portEXIT_CRITICAL(&enc->lock);
+    }
+    if (manual) {
+        if (enc->ctrl) {
+            opus_rate_ctrl_reset(enc->ctrl, &p);
+            opus_rate_ctrl_update(enc->ctrl, &p);   // 取回按上下限截断后的参数
+        }
+        _opus_pkt_encoder_apply(enc, &p);
+    } else if (enc->ctrl && opus_rate_ctrl_update(enc->ctrl, &p)) {
+        _opus_pkt_encoder_apply(enc, &p);
+    }
+}
+
+static void _opus_pkt_encode_frame(opus_pkt_encoder_t *enc, const int16_t *pcm)
+{
+    enc->stats.frames++;
+    opus_preroll_t *pr = enc->cfg.preroll;
+    if (pr) {
+        opus_preroll_poll(pr, enc->timestamp);  // 每帧发布时间戳，待处理的触发在此帧边界上交接
+    }
+    if (!_opus_pkt_dtx_skip(enc, pcm)) {
+        opus_packet_t *pkt = pr ? opus_preroll_acquire_write(pr) : opus_packet_slab_acquire_write(enc->cfg.slab);
+        if (pkt) {
+            int64_t t0 = enc->ctrl ? esp_timer_get_time() : 0;
+            // 启用冗余时先写包头与前几帧的副本，本帧直接编码在其后
+            size_t off = enc->red ? opus_red_begin(enc->red, enc->seq, pkt->data, pkt->cap) : 0;
+            opus_int32 n = opus_encode(enc->enc, pcm, enc->frame_samples, pkt->data + off, pkt->cap - off);
+            if (enc->ctrl) {
+                opus_rate_ctrl_encode_time(enc->ctrl, (uint32_t)(esp_timer_get_time() - t0));
+            }
+            if (n > 0) {
+                if (enc->red) {
+                    opus_red_push(enc->red, enc->seq, pkt->data + off, (uint16_t)n);
+                    enc->stats.red_bytes += off;
+                }
+                n += (opus_int32)off;
+                pkt->len = (uint16_t)n;
+                pkt->seq = enc->seq;
+                pkt->timestamp = enc->timestamp;
+                if (pr) {
+                    opus_preroll_commit(pr, pkt);
+                } else {
+                    opus_packet_slab_commit(enc->cfg.slab, pkt);
+                }
+                enc->stats.packets++;
+                enc->stats.bytes += n;
+            } else {
+                ESP_LOGW(TAG, "opus_encode failed: %d", (int)n);
+                audio_probe_error(enc->probe);
+            }
+        } else {
+            enc->stats.dropped++;
+        }
+    }
+    // 丢弃与DTX跳过的帧同样推进序号与时间戳，接收端可据此识别丢包并做隐藏
+    enc->seq++;
+    enc->timestamp += enc->frame_samples;
+    _opus_pkt_encoder_next_params(enc);
+}
+
+static esp_err_t _opus_pkt_encoder_open(audio_element_handle_t self)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    int err = opus_encoder_init((OpusEncoder *)enc->state, enc->cfg.sample_rate, enc->cfg.channels, OPUS_APPLICATION_VOIP);
+    if (err != OPUS_OK) {
+        ESP_LOGE(TAG, "opus_encoder_init failed: %d", err);
+        return ESP_FAIL;
+    }
+    enc->enc = (OpusEncoder *)enc->state;
+    // 重新打开时沿用运行中调整过的参数
+    const opus_rate_params_t *p = &enc->stats.params;
+    opus_encoder_ctl(enc->enc, OPUS_SET_BITRATE(p->bitrate));
+    opus_encoder_ctl(enc->enc, OPUS_SET_COMPLEXITY(p->complexity));
+    opus_encoder_ctl(enc->enc, OPUS_SET_INBAND_FEC(p->fec ? 1 : 0));
+    opus_encoder_ctl(enc->enc, OPUS_SET_PACKET_LOSS_PERC(p->loss_pct));
+    opus_encoder_ctl(enc->enc, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+    opus_encoder_ctl(enc->enc, OPUS_SET_DTX(enc->vad ? 1 : 0));
+    opus_encoder_ctl(enc->enc, OPUS_GET_LOOKAHEAD(&enc->lookahead));
+    enc->pcm_fill = 0;
+    enc->dtx_gap = 0;
+    if (enc->vad) {
+        voice_activity_reset(enc->vad);
+    }
+    opus_red_reset(enc->red);
+    enc->probe = audio_probe_get(audio_element_get_tag(self));
+    return ESP_OK;
+}
+
+static esp_err_t _opus_pkt_encoder_close(audio_element_handle_t self)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    // 状态内存保留到元素销毁，下次打开时重新初始化
+    enc->enc = NULL;
+    return ESP_OK;
+}
+
+/**
+ * @brief 按帧切分输入并编码：整帧直接从输入编码，只有跨块的半帧才拷入帧缓冲
+ */
+static void _opus_pkt_encoder_consume(opus_pkt_encoder_t *enc, const char *p, int left)
+{
+    while (left > 0) {
+        if (enc->pcm_fill == 0 && left >= enc->frame_bytes) {
+            // 整帧直接从输入缓冲区编码，无需拷贝（帧边界上可能切换帧长，先记下本帧长度）
+            int n = enc->frame_bytes;
+            _opus_pkt_encode_frame(enc, (const int16_t *)p);
+            p += n;
+            left -= n;
+            continue;
+        }
+        int n = enc->frame_bytes - enc->pcm_fill;
+        if (n > left) {
+            n = left;
+        }
+        memcpy((char *)enc->pcm + enc->pcm_fill, p, n);
+        enc->pcm_fill += n;
+        p += n;
+        left -= n;
+        if (enc->pcm_fill == enc->frame_bytes) {
+            enc->pcm_fill = 0;
+            _opus_pkt_encode_frame(enc, enc->pcm);
+        }
+    }
+}
+
+static audio_element_err_t _opus_pkt_encoder_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    int r_size = audio_element_input(self, in_buffer, in_len);
+    if (r_size <= 0) {
+        return r_size;
+    }
+    uint32_t stamp = audio_probe_begin(enc->probe, self);
+    _opus_pkt_encoder_consume(enc, in_buffer, r_size);
+    audio_probe_end(enc->probe, stamp);
+    return r_size;
+}
+
+static esp_err_t _opus_pkt_encoder_destroy(audio_element_handle_t self)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    audio_arena_t *arena = enc->cfg.arena;
+    opus_rate_ctrl_destroy(enc->ctrl);
+    opus_red_destroy(enc->red);
+    voice_activity_destroy(enc->vad);
+    audio_arena_free(arena, enc->state);
+    audio_arena_free(arena, enc->pcm);
+    audio_arena_free(arena, enc);
+    return ESP_OK;
+}
+
+audio_element_handle_t opus_pkt_encoder_init(opus_pkt_encoder_cfg_t *config)
+{
+    if (config == NULL || (config->slab == NULL && config->preroll == NULL)) {
+        ESP_LOGE(TAG, "encoder config or output is NULL");
+        return NULL;
+    }
+    if (!opus_pkt_frame_us_valid(config->frame_us)) {
+        ESP_LOGE(TAG, "invalid opus frame duration: %d us", config->frame_us);
+        return NULL;
+    }
+    if (config->red_depth > OPUS_RED_MAX_DEPTH) {
+        ESP_LOGE(TAG, "invalid red depth: %d", config->red_depth);
+        return NULL;
+    }
+    audio_arena_t *arena = config->arena;
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_arena_calloc(arena, 1, sizeof(opus_pkt_encoder_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, enc, return NULL);
+    enc->cfg = *config;
+    enc->frame_samples = (int)((int64_t)config->sample_rate * config->frame_us / 1000000);
+    enc->frame_bytes = enc->frame_samples * config->channels * sizeof(int16_t);
+    portMUX_INITIALIZE(&enc->lock);
+    enc->stats.params = (opus_rate_params_t) {
+        .bitrate = config->bitrate,
+        .complexity = config->complexity,
+        .frame_us = config->frame_us,
+        .fec = config->fec,
+        .loss_pct = config->packet_loss_pct,
+    };
+    // 帧缓冲按最长帧分配，运行中切换帧长不再分配
+    int pcm_cap = (int)((int64_t)config->sample_rate * OPUS_PKT_MAX_PARAM_FRAME_US / 1000000) * config->channels * sizeof(int16_t);
+    enc->pcm = (int16_t *)audio_arena_calloc(arena, 1, pcm_cap, AUDIO_ARENA_INTERNAL);
+    // 编码器状态每帧都要访问，放片内SRAM；打开时用 opus_encoder_init() 原地初始化，启停不再分配
+    enc->state = audio_arena_calloc(arena, 1, opus_encoder_get_size(config->channels), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, enc->pcm && enc->state, goto _fail);
+    enc->stats.speech = true;
+    if (config->dtx) {
+        voice_activity_cfg_t vad_cfg = DEFAULT_VOICE_ACTIVITY_CONFIG();
+        if (config->dtx_denoised) {
+            vad_cfg = (voice_activity_cfg_t)VOICE_ACTIVITY_DENOISED_CONFIG();
+        }
+        vad_cfg.sample_rate = config->sample_rate;
+        vad_cfg.arena = arena;
+        enc->vad = voice_activity_create(&vad_cfg);
+        enc->keepalive_samples = (uint32_t)((int64_t)config->sample_rate * config->dtx_keepalive_ms / 1000);
+        AUDIO_MEM_CHECK(TAG, enc->vad, goto _fail);
+    }
+    if (config->adaptive) {
+        opus_rate_ctrl_cfg_t rc_cfg = config->rate_ctrl;
+        rc_cfg.arena = arena;
+        enc->ctrl = opus_rate_ctrl_create(&rc_cfg, &enc->stats.params);
+        AUDIO_MEM_CHECK(TAG, enc->ctrl, goto _fail);
+        opus_rate_ctrl_update(enc->ctrl, &enc->stats.params);  // 初始参数按上下限截断
+    }
+    if (config->red_depth > 0) {
+        enc->red = opus_red_create(arena, config->red_depth, OPUS_PKT_RED_BLOCK_BYTES, config->red_max_bytes);
+        AUDIO_MEM_CHECK(TAG, enc->red, goto _fail);
+    }
+
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = _opus_pkt_encoder_open;
+    cfg.close = _opus_pkt_encoder_close;
+    cfg.process = _opus_pkt_encoder_process;
+    cfg.destroy = _opus_pkt_encoder_destroy;
+    cfg.buffer_len = enc->frame_bytes;
+    cfg.out_rb_size = 0;
+    cfg.task_stack = config->task_stack;
+    cfg.task_core = config->task_core;
+    cfg.task_prio = config->task_prio;
+    cfg.stack_in_ext = config->stack_in_ext;
+    cfg.tag = "opus_pkt_enc";
+
+    audio_element_handle_t el = audio_element_init(&cfg);
+    AUDIO_MEM_CHECK(TAG, el, goto _fail);
+    audio_element_setdata(el, enc);
+    return el;
+
+_fail:
+    opus_rate_ctrl_destroy(enc->ctrl);
+    opus_red_destroy(enc->red);
+    voice_activity_destroy(enc->vad);
+    audio_arena_free(arena, enc->state);
+    audio_arena_free(arena, enc->pcm);
+    audio_arena_free(arena, enc);
+    return NULL;
+}
+
+uint32_t opus_pkt_encoder_get_dropped(audio_element_handle_t self)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    return enc ? enc->stats.dropped : 0;
+}
+
+esp_err_t opus_pkt_encoder_get_stats(audio_element_handle_t self, opus_pkt_encoder_stats_t *stats)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = enc->stats;
+    if (enc->vad) {
+        voice_activity_get_stats(enc->vad, &stats->vad);
+    } else {
+        memset(&stats->vad, 0, sizeof(stats->vad));
+    }
+    if (enc->ctrl) {
+        opus_rate_ctrl_get_stats(enc->ctrl, &stats->rate);
+    } else {
+        memset(&stats->rate, 0, sizeof(stats->rate));
+    }
+    return ESP_OK;
+}
+
+esp_err_t opus_pkt_encoder_flush(audio_element_handle_t self)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 丢弃未凑满的半帧，并让下一帧按新语音段开始（不沿用停止前的预测与VAD状态）
+    enc->pcm_fill = 0;
+    enc->dtx_gap = 0;
+    if (enc->vad) {
+        voice_activity_reset(enc->vad);
+    }
+    opus_red_reset(enc->red);
+    if (enc->enc) {
+        opus_encoder_ctl(enc->enc, OPUS_RESET_STATE);
+    }
+    return ESP_OK;
+}
+
+uint32_t opus_pkt_encoder_get_delay_us(audio_element_handle_t self)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc) {
+        return 0;
+    }
+    return (uint32_t)((int64_t)(enc->frame_samples + enc->lookahead) * 1000000 / enc->cfg.sample_rate);
+}
+
+esp_err_t opus_pkt_encoder_set_params(audio_element_handle_t self, const opus_rate_params_t *params)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc || !params || !opus_pkt_frame_us_valid(params->frame_us) ||
+        params->frame_us > OPUS_PKT_MAX_PARAM_FRAME_US || params->bitrate < 500 || params->bitrate > 512000 ||
+        params->complexity < 0 || params->complexity > 10 || params->loss_pct < 0 || params->loss_pct > 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&enc->lock);
+    enc->pending = *params;
+    enc->has_pending = true;
+    portEXIT_CRITICAL(&enc->lock);
+    return ESP_OK;
+}
+
+esp_err_t opus_pkt_encoder_get_params(audio_element_handle_t self, opus_rate_params_t *params)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc || !params) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *params = enc->stats.params;
+    return ESP_OK;
+}
+
+esp_err_t opus_pkt_encoder_report_link(audio_element_handle_t self, uint8_t loss_pct, uint32_t bandwidth_bps)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!enc->ctrl) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    opus_rate_ctrl_report(enc->ctrl, loss_pct, bandwidth_bps);
+    return ESP_OK;
+}
+
+esp_err_t opus_pkt_encoder_sync_open(audio_element_handle_t self)
+{
+    if (!self || !audio_element_getdata(self)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _opus_pkt_encoder_open(self);
+}
+
+esp_err_t opus_pkt_encoder_sync_feed(audio_element_handle_t self, const int16_t *pcm, size_t samples)
+{
+    opus_pkt_encoder_t *enc = (opus_pkt_encoder_t *)audio_element_getdata(self);
+    if (!enc || !pcm) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!enc->enc) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // 调用者的任务即编码任务，探针不采样环形缓冲区
+    uint32_t stamp = audio_probe_begin(enc->probe, NULL);
+    _opus_pkt_encoder_consume(enc, (const char *)pcm, (int)(samples * enc->cfg.channels * sizeof(int16_t)));
+    audio_probe_end(enc->probe, stamp);
+    return ESP_OK;
+}
+
+void opus_pkt_encoder_sync_close(audio_element_handle_t self)
+{
+    if (self && audio_element_getdata(self)) {
+        _opus_pkt_encoder_close(self);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* 解码元素                                                            */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    opus_pkt_decoder_cfg_t cfg;     // 配置
+    SemaphoreHandle_t pkt_sem;      // 新包到达信号
+    opus_mixer_t *mixer;            // 多路抖动缓冲、解码与混音
+    opus_mixer_stream_t *stream0;   // 第0路（单路兼容接口使用）
+    int16_t *pcm;                   // 解码/混音输出缓冲区（最大帧长）
+    int frame_samples;              // 每通道每帧采样点数
+    int out_target_bytes;           // 输出环形缓冲区保持的字节数
+    uint32_t errors;                // 已上报给探针的解码失败数
+    audio_probe_t *probe;           // 性能探针（按管道注册名）
+    drift_asrc_t *asrc;             // 时钟漂移补偿（未启用时为NULL）
+    int16_t *asrc_out;              // 补偿输出缓冲区
+    bool have_newest;               // 第0路已收到过包
+    uint16_t newest_seq;            // 第0路最新（序号最大）的包
+    uint32_t newest_ms;             // 该包的到达时间
+    bool anchored;                  // 水位设定点已确定
+    int32_t setpoint_us;            // 水位设定点
+    int32_t steps_base;             // 确定设定点时抖动缓冲的 inserted - dropped
+    uint32_t resync;                // 确定设定点时抖动缓冲的重同步次数
+} opus_pkt_decoder_t;
+
+/* libopus 解码器接口，供混音器按路调用 */
+static size_t _opus_pkt_state_size(int channels)
+{
+    return (size_t)opus_decoder_get_size(channels);
+}
+
+static int _opus_pkt_state_init(void *state, int sample_rate, int channels)
+{
+    int err = opus_decoder_init((OpusDecoder *)state, sample_rate, channels);
+    if (err != OPUS_OK) {
+        ESP_LOGE(TAG, "opus_decoder_init failed: %d", err);
+        return -1;
+    }
+    return 0;
+}
+
+static int _opus_pkt_state_decode(void *state, const uint8_t *data, int len, int16_t *pcm, int max_samples, int fec)
+{
+    return opus_decode((OpusDecoder *)state, data, len, pcm, max_samples, fec);
+}
+
+static const opus_mixer_codec_t s_opus_codec = {
+    .state_size = _opus_pkt_state_size,
+    .init = _opus_pkt_state_init,
+    .decode = _opus_pkt_state_decode,
+};
+
+static void _opus_pkt_decoder_mixer_cfg(const opus_pkt_decoder_cfg_t *config, opus_mixer_cfg_t *mix_cfg)
+{
+    opus_mixer_cfg_t def = DEFAULT_OPUS_MIXER_CONFIG();
+    *mix_cfg = def;
+    mix_cfg->sample_rate = config->sample_rate;
+    mix_cfg->channels = config->channels;
+    mix_cfg->frame_us = config->frame_us;
+    mix_cfg->max_streams = (uint8_t)config->streams;
+    mix_cfg->jitter_min_ms = (uint16_t)config->jitter_min_ms;
+    mix_cfg->jitter_max_ms = (uint16_t)config->jitter_max_ms;
+    mix_cfg->codec = &s_opus_codec;
+    mix_cfg->red = config->red;
+    mix_cfg->fec = config->fec;
+    mix_cfg->arena = config->arena;
+}
+
+static void _opus_pkt_decoder_notify(void *ctx)
+{
+    xSemaphoreGive((SemaphoreHandle_t)ctx);
+}
+
+static void _opus_pkt_decoder_drift_reset(opus_pkt_decoder_t *dec)
+{
+    if (dec->asrc) {
+        drift_asrc_reset(dec->asrc);
+    }
+    dec->have_newest = false;
+    dec->anchored = false;
+}
+
+/**
+ * @brief 由第0路抖动缓冲水位更新补偿比值（每混出一帧调用一次）
+ *
+ * 水位 = 已到达未播放的帧 + 最新包到达后经过的时间：包按帧到达，单看帧数是量化到整帧的锯齿，
+ * 加上到达后的时长即得到连续变化的水位。第0路未在播放或处于DTX段时水位无意义，保持比值。
+ */
+static void _opus_pkt_decoder_drift_update(opus_pkt_decoder_t *dec)
+{
+    opus_mixer_stream_stats_t st;
+    opus_mixer_get_stream_stats(dec->stream0, &st);
+    if (!st.playing || st.dtx || !dec->have_newest) {
+        drift_asrc_hold(dec->asrc);
+        dec->anchored = false;
+        return;
+    }
+    int32_t steps = (int32_t)(st.jb.inserted - st.jb.dropped);
+    if (!dec->anchored || st.jb.resync != dec->resync) {
+        dec->setpoint_us = st.jb.target_ms * 1000 + dec->cfg.frame_us * 3 / 2;
+        dec->steps_base = steps;
+        dec->resync = st.jb.resync;
+        dec->anchored = true;
+    }
+    uint32_t age_ms = (uint32_t)(esp_timer_get_time() / 1000) - dec->newest_ms;
+    int32_t level_us = st.jb.depth_ms * 1000 + (int32_t)age_ms * 1000;
+    int32_t error_us = level_us - dec->setpoint_us - (steps - dec->steps_base) * dec->cfg.frame_us;
+    drift_asrc_update(dec->asrc, error_us, dec->cfg.frame_us);
+}
+
+static esp_err_t _opus_pkt_decoder_open(audio_element_handle_t self)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    // 各路解码器状态保留，由混音器在下一帧重新初始化
+    opus_mixer_reset(dec->mixer);
+    _opus_pkt_decoder_drift_reset(dec);
+    dec->probe = audio_probe_get(audio_element_get_tag(self));
+
+    audio_element_info_t info = {0};
+    audio_element_getinfo(self, &info);
+    info.sample_rates = dec->cfg.sample_rate;
+    info.channels = dec->cfg.channels;
+    info.bits = 16;
+    audio_element_setinfo(self, &info);
+    audio_element_report_info(self);
+    return ESP_OK;
+}
+
+static esp_err_t _opus_pkt_decoder_close(audio_element_handle_t self)
+{
+    return ESP_OK;
+}
+
+static audio_element_err_t _opus_pkt_decoder_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    TickType_t frame_ticks = pdMS_TO_TICKS(dec->cfg.frame_us / 1000);
+    if (frame_ticks == 0) {
+        frame_ticks = 1;
+    }
+
+    // 1. 将slab中新到的包按所属路全部移入抖动缓冲，成批取出、成批归还包槽
+    const opus_packet_t *pkts[OPUS_PKT_DECODER_BATCH];
+    uint32_t got;
+    while ((got = opus_packet_slab_acquire_read_batch(dec->cfg.slab, pkts, OPUS_PKT_DECODER_BATCH)) > 0) {
+        for (uint32_t i = 0; i < got; i++) {
+            const opus_packet_t *pkt = pkts[i];
+            if (pkt->stream == 0 && (!dec->have_newest || (int16_t)(pkt->seq - dec->newest_seq) > 0)) {
+                dec->newest_seq = pkt->seq;
+                dec->newest_ms = pkt->arrival_ms;
+                dec->have_newest = true;
+            }
+            opus_mixer_put(dec->mixer, pkt);
+        }
+        opus_packet_slab_release_batch(dec->cfg.slab, got);
+    }
+
+    // 2. 输出环形缓冲区已足够时等待，保证按播放节奏从抖动缓冲取帧
+    ringbuf_handle_t out_rb = audio_element_get_output_ringbuf(self);
+    if (out_rb && rb_bytes_filled(out_rb) >= dec->out_target_bytes) {
+        xSemaphoreTake(dec->pkt_sem, frame_ticks / 2 ? frame_ticks / 2 : 1);
+        return AEL_IO_TIMEOUT;
+    }
+
+    // 3. 各路取出下一帧解码（正常包 / FEC恢复 / PLC隐藏，静音路跳过）并混音
+    //    此时输出环形缓冲区已低于目标，为空即说明I2S即将欠载
+    uint32_t stamp = audio_probe_begin(dec->probe, self);
+    int samples = opus_mixer_mix(dec->mixer, dec->pcm);
+    if (samples <= 0) {
+        if (dec->asrc) {
+            drift_asrc_hold(dec->asrc);
+            dec->anchored = false;
+        }
+        xSemaphoreTake(dec->pkt_sem, frame_ticks);
+        return AEL_IO_TIMEOUT;
+    }
+    // 4. 时钟漂移补偿：按水位微调比值后重采样，每帧输出样点数在帧长附近±1变化
+    int16_t *out = dec->pcm;
+    if (dec->asrc) {
+        _opus_pkt_decoder_drift_update(dec);
+        samples = (int)drift_asrc_process(dec->asrc, dec->pcm, samples, dec->asrc_out);
+        out = dec->asrc_out;
+    }
+    audio_probe_end(dec->probe, stamp);
+    opus_mixer_stats_t st;
+    opus_mixer_get_stats(dec->mixer, &st);
+    if (st.mixed && dec->cfg.lifecycle) {
+        audio_lifecycle_data(dec->cfg.lifecycle);
+    }
+    if (st.errors != dec->errors) {
+        ESP_LOGW(TAG, "opus_decode failed (%u total)", (unsigned)st.errors);
+        dec->errors = st.errors;
+        audio_probe_error(dec->probe);
+    }
+    return audio_element_output(self, (char *)out, samples * dec->cfg.channels * sizeof(int16_t));
+}
+
+static esp_err_t _opus_pkt_decoder_destroy(audio_element_handle_t self)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    opus_packet_slab_set_notify(dec->cfg.slab, NULL, NULL);
+    vSemaphoreDelete(dec->pkt_sem);
+    opus_mixer_destroy(dec->mixer);
+    audio_arena_t *arena = dec->cfg.arena;
+    drift_asrc_destroy(dec->asrc);
+    audio_arena_free(arena, dec->asrc_out);
+    audio_arena_free(arena, dec->pcm);
+    audio_arena_free(arena, dec);
+    return ESP_OK;
+}
+
+static void _opus_pkt_decoder_asrc_cfg(const opus_pkt_decoder_cfg_t *config, drift_asrc_cfg_t *asrc_cfg)
+{
+    drift_asrc_cfg_t def = DEFAULT_DRIFT_ASRC_CONFIG();
+    *asrc_cfg = def;
+    asrc_cfg->channels = (uint8_t)config->channels;
+    asrc_cfg->arena = config->arena;
+}
+
+static size_t _opus_pkt_decoder_asrc_out_samples(const opus_pkt_decoder_cfg_t *config)
+{
+    // 同 drift_asrc_max_output()：比值上限内单帧最多多出的样点
+    drift_asrc_cfg_t asrc_cfg;
+    _opus_pkt_decoder_asrc_cfg(config, &asrc_cfg);
+    size_t max_frame_samples = config->sample_rate * OPUS_PKT_MAX_FRAME_MS / 1000;
+    return max_frame_samples + (max_frame_samples * asrc_cfg.max_ppm + 999999) / 1000000 + 2;
+}
+
+size_t opus_pkt_decoder_mem_size(const opus_pkt_decoder_cfg_t *config, audio_arena_place_t place)
+{
+    if (config == NULL || config->streams < 1 || config->streams > OPUS_MIXER_MAX_STREAMS) {
+        return 0;
+    }
+    opus_mixer_cfg_t mix_cfg;
+    _opus_pkt_decoder_mixer_cfg(config, &mix_cfg);
+    size_t bytes = opus_mixer_mem_size(&mix_cfg, place);
+    if (place == AUDIO_ARENA_INTERNAL) {
+        int max_frame_samples = config->sample_rate * OPUS_PKT_MAX_FRAME_MS / 1000;
+        bytes += AUDIO_ARENA_SIZE(sizeof(opus_pkt_decoder_t)) +
+                 AUDIO_ARENA_SIZE(max_frame_samples * config->channels * sizeof(int16_t));
+        if (config->drift_comp) {
+            drift_asrc_cfg_t asrc_cfg;
+            _opus_pkt_decoder_asrc_cfg(config, &asrc_cfg);
+            bytes += drift_asrc_mem_size(&asrc_cfg, place) +
+                     AUDIO_ARENA_SIZE(_opus_pkt_decoder_asrc_out_samples(config) * config->channels * sizeof(int16_t));
+        }
+    }
+    return bytes;
+}
+
+audio_element_handle_t opus_pkt_decoder_init(opus_pkt_decoder_cfg_t *config)
+{
+    if (config == NULL || config->slab == NULL) {
+        ESP_LOGE(TAG, "decoder config or slab is NULL");
+        return NULL;
+    }
+    if (config->streams < 1 || config->streams > OPUS_MIXER_MAX_STREAMS) {
+        ESP_LOGE(TAG, "invalid stream count: %d", config->streams);
+        return NULL;
+    }
+    if (config->drift_comp && (config->channels < 1 || config->channels > DRIFT_ASRC_MAX_CHANNELS)) {
+        ESP_LOGE(TAG, "drift compensation supports up to %d channels", DRIFT_ASRC_MAX_CHANNELS);
+        return NULL;
+    }
+    audio_arena_t *arena = config->arena;
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_arena_calloc(arena, 1, sizeof(opus_pkt_decoder_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, dec, return NULL);
+    dec->cfg = *config;
+    int max_frame_samples = config->sample_rate * OPUS_PKT_MAX_FRAME_MS / 1000;
+    dec->frame_samples = (int)((int64_t)config->sample_rate * config->frame_us / 1000000);
+    dec->out_target_bytes = dec->frame_samples * config->channels * sizeof(int16_t) * OPUS_PKT_DECODER_OUT_FRAMES;
+    dec->pcm = (int16_t *)audio_arena_calloc(arena, max_frame_samples * config->channels, sizeof(int16_t), AUDIO_ARENA_INTERNAL);
+    dec->pkt_sem = xSemaphoreCreateBinary();
+    opus_mixer_cfg_t mix_cfg;
+    _opus_pkt_decoder_mixer_cfg(config, &mix_cfg);
+    dec->mixer = opus_mixer_create(&mix_cfg);
+    // 第0路始终打开，单路发送端无需感知混音器
+    dec->stream0 = opus_mixer_open(dec->mixer, AUDIO_MIX_UNITY);
+    AUDIO_MEM_CHECK(TAG, dec->pcm && dec->pkt_sem && dec->mixer && dec->stream0, goto _fail);
+    if (config->drift_comp) {
+        drift_asrc_cfg_t asrc_cfg;
+        _opus_pkt_decoder_asrc_cfg(config, &asrc_cfg);
+        dec->asrc = drift_asrc_create(&asrc_cfg);
+        dec->asrc_out = (int16_t *)audio_arena_calloc(arena, _opus_pkt_decoder_asrc_out_samples(config) * config->channels,
+                                                      sizeof(int16_t), AUDIO_ARENA_INTERNAL);
+        AUDIO_MEM_CHECK(TAG, dec->asrc && dec->asrc_out, goto _fail);
+    }
+
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = _opus_pkt_decoder_open;
+    cfg.close = _opus_pkt_decoder_close;
+    cfg.process = _opus_pkt_decoder_process;
+    cfg.destroy = _opus_pkt_decoder_destroy;
+    cfg.out_rb_size = config->out_rb_size;
+    cfg.task_stack = config->task_stack;
+    cfg.task_core = config->task_core;
+    cfg.task_prio = config->task_prio;
+    cfg.stack_in_ext = config->stack_in_ext;
+    cfg.tag = "opus_pkt_dec";
+
+    audio_element_handle_t el = audio_element_init(&cfg);
+    AUDIO_MEM_CHECK(TAG, el, goto _fail);
+    audio_element_setdata(el, dec);
+    opus_packet_slab_set_notify(config->slab, _opus_pkt_decoder_notify, dec->pkt_sem);
+    return el;
+
+_fail:
+    if (dec->pkt_sem) {
+        vSemaphoreDelete(dec->pkt_sem);
+    }
+    opus_mixer_destroy(dec->mixer);
+    drift_asrc_destroy(dec->asrc);
+    audio_arena_free(arena, dec->asrc_out);
+    audio_arena_free(arena, dec->pcm);
+    audio_arena_free(arena, dec);
+    return NULL;
+}
+
+esp_err_t opus_pkt_decoder_flush(audio_element_handle_t self)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    if (!dec) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 停止期间积压的包全部丢弃，各路抖动缓冲重新预缓冲，解码器不再拿旧状态做PLC
+    const opus_packet_t *pkt;
+    while ((pkt = opus_packet_slab_acquire_read(dec->cfg.slab)) != NULL) {
+        opus_packet_slab_release(dec->cfg.slab, pkt);
+    }
+    opus_mixer_reset(dec->mixer);
+    _opus_pkt_decoder_drift_reset(dec);
+    xSemaphoreTake(dec->pkt_sem, 0);
+    return ESP_OK;
+}
+
+esp_err_t opus_pkt_decoder_get_stats(audio_element_handle_t self, jitter_buffer_stats_t *stats)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    if (!dec || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    opus_mixer_stream_stats_t st;
+    opus_mixer_get_stream_stats(dec->stream0, &st);
+    *stats = st.jb;
+    return ESP_OK;
+}
+
+esp_err_t opus_pkt_decoder_get_drift_stats(audio_element_handle_t self, drift_asrc_stats_t *stats)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    if (!dec || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!dec->asrc) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    drift_asrc_get_stats(dec->asrc, stats);
+    return ESP_OK;
+}
+
+opus_mixer_t *opus_pkt_decoder_get_mixer(audio_element_handle_t self)
+{
+    opus_pkt_decoder_t *dec = (opus_pkt_decoder_t *)audio_element_getdata(self);
+    return dec ? dec->mixer : NULL;
+}
@@ -0,0 +1,310 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 10:00:00
+ * @LastEditTime: 2026-10-16 10:00:00
+ * @LastEditors: 星年
+ * @Description: 基于libopus的包编解码ADF元素，编码器直接编码进slab包槽，解码器经自适应抖动缓冲解码
+ * @FilePath: \audio_manager\main\opus_packet_codec.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdbool.h>
+#include "audio_element.h"
+#include "opus_packet_slab.h"
+#include "opus_preroll.h"
+#include "opus_red.h"
+#include "jitter_buffer.h"
+#include "opus_mixer.h"
+#include "voice_activity.h"
+#include "opus_rate_ctrl.h"
+#include "drift_asrc.h"
+#include "audio_lifecycle.h"
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPUS_PKT_ENCODER_TASK_STACK     (24 * 1024)     // libopus编码需要较大堆栈
+#define OPUS_PKT_DECODER_TASK_STACK     (12 * 1024)     // libopus解码堆栈
+#define OPUS_PKT_TASK_CORE              (0)             // 任务绑定核心
+#define OPUS_PKT_TASK_PRIO              (5)             // 任务优先级
+#define OPUS_PKT_DECODER_RINGBUFFER     (4 * 1024)      // 解码器输出环形缓冲区大小
+#define OPUS_PKT_DECODER_OUT_FRAMES     (2)             // 输出环形缓冲区中保持的帧数，其余延迟由抖动缓冲自适应
+#define OPUS_PKT_MAX_FRAME_MS           (120)           // 单包最大时长（libopus上限）
+#define OPUS_PKT_DTX_KEEPALIVE_MS       (400)           // 静音期间舒适噪声/保活包间隔（与Opus DTX一致）
+#define OPUS_PKT_RED_BLOCK_BYTES        (512)           // 进入冗余历史的单帧上限，更长的帧不做冗余
+
+/**
+ * @brief 包编码元素配置（管道末端元素，输出写入slab，不需要输出环形缓冲区）
+ */
+typedef struct {
+    opus_packet_slab_t *slab;   // 输出包slab（由调用者创建）
+    opus_preroll_t *preroll;    // 输出预录环（由调用者创建），非NULL时取代 slab
+    int  sample_rate;           // 输入采样率
+    int  channels;              // 输入通道数
+    int  frame_us;              // 帧长（微秒），取 2500/5000/10000/20000/40000/60000
+    int  bitrate;               // 目标比特率（bps）
+    int  complexity;            // 编码复杂度 0~10
+    bool fec;                   // 带内FEC
+    int  packet_loss_pct;       // 预期丢包率（%）
+    uint8_t red_depth;          // 每包附带前几帧的编码数据（0 ~ OPUS_RED_MAX_DEPTH，0为不封装），见 opus_red.h
+    uint16_t red_max_bytes;     // 每包冗余部分字节上限（0为只受包容量一半限制）
+    bool adaptive;              // 按编码耗时与接收端反馈自动调整参数（见 opus_rate_ctrl.h）
+    opus_rate_ctrl_cfg_t rate_ctrl; // 自适应配置（adaptive 为true时有效，arena 字段忽略）
+    bool dtx;                   // 静音时不编码不发送，仅按 dtx_keepalive_ms 发送舒适噪声/保活包
+    bool dtx_denoised;          // 输入已经降噪：DTX的语音检测用 VOICE_ACTIVITY_DENOISED_CONFIG()
+    int  dtx_keepalive_ms;      // 静音期间发包间隔（毫秒）
+    audio_arena_t *arena;       // 元素私有内存（libopus状态、帧缓冲、VAD）所在内存区，NULL 时从堆分配
+    int  task_stack;            // 任务堆栈大小
+    int  task_core;             // 任务绑定核心
+    int  task_prio;             // 任务优先级
+    bool stack_in_ext;          // 堆栈是否放在外部RAM
+} opus_pkt_encoder_cfg_t;
+
+#define DEFAULT_OPUS_PKT_ENCODER_CONFIG() {             \
+    .slab         = NULL,                               \
+    .preroll      = NULL,                               \
+    .sample_rate  = 16000,                              \
+    .channels     = 1,                                  \
+    .frame_us     = 20000,                              \
+    .bitrate      = 24000,                              \
+    .complexity   = 5,                                  \
+    .fec          = false,                              \
+    .packet_loss_pct = 0,                               \
+    .red_depth    = 0,                                  \
+    .red_max_bytes = 0,                                 \
+    .adaptive     = false,                              \
+    .rate_ctrl    = DEFAULT_OPUS_RATE_CTRL_CONFIG(),    \
+    .dtx          = false,                              \
+    .dtx_denoised = false,                              \
+    .dtx_keepalive_ms = OPUS_PKT_DTX_KEEPALIVE_MS,      \
+    .arena        = NULL,                               \
+    .task_stack   = OPUS_PKT_ENCODER_TASK_STACK,        \
+    .task_core    = OPUS_PKT_TASK_CORE,                 \
+    .task_prio    = OPUS_PKT_TASK_PRIO,                 \
+    .stack_in_ext = false,                              \
+}
+
+/**
+ * @brief 包编码元素统计
+ */
+typedef struct {
+    uint32_t frames;            // 输入帧数
+    uint32_t packets;           // 已提交的包数
+    uint32_t bytes;             // 已提交的包字节总数
+    uint32_t red_bytes;         // 其中冗余封装（包头与冗余块）的字节数
+    uint32_t dropped;           // slab已满丢弃的帧数
+    uint32_t read_dropped;      // 兼容读取接口因缓冲区不足丢弃的包数（由录制层填写，编码器本身为0）
+    uint32_t dtx_frames;        // 静音期间跳过编码、不发送的帧数
+    uint32_t keepalive;         // 静音期间发送的舒适噪声/保活包数
+    bool speech;                // 最近一帧是否为语音（未启用DTX时恒为true）
+    voice_activity_stats_t vad; // 语音活动检测统计（未启用DTX时为0）
+    opus_rate_params_t params;  // 当前生效的编码参数
+    uint32_t param_changes;     // 参数变更次数（手动与自适应）
+    opus_rate_ctrl_stats_t rate; // 自适应统计（未启用时为0）
+} opus_pkt_encoder_stats_t;
+
+/**
+ * @brief 包解码元素配置（管道首元素，输入取自slab，不需要输入环形缓冲区）
+ */
+typedef struct {
+    opus_packet_slab_t *slab;   // 输入包slab（由调用者创建）
+    int  sample_rate;           // 输出采样率
+    int  channels;              // 输出通道数
+    int  frame_us;              // 发送端每包时长（微秒），抖动缓冲按此步进
+    int  streams;               // 预分配的路数（1 ~ OPUS_MIXER_MAX_STREAMS），每路独立抖动缓冲与解码器
+    int  jitter_min_ms;         // 抖动缓冲最小目标深度
+    int  jitter_max_ms;         // 抖动缓冲最大目标深度
+    bool red;                   // 包为冗余封装（与发送端 red_depth > 0 对应），丢包先用后续包携带的副本补上
+    bool fec;                   // 发送端启用了带内FEC（与发送端 fec 对应），缺包时用下一包的FEC数据恢复
+    bool drift_comp;            // 时钟漂移补偿：解码输出经 drift_asrc 微调比值，使第0路的抖动缓冲水位长期不变
+    audio_lifecycle_t *lifecycle; // 所属管道的生命周期，用于记录启动到首帧解码的耗时（可为NULL）
+    audio_arena_t *arena;       // 元素私有内存（各路libopus状态与抖动缓冲、PCM缓冲）所在内存区，NULL 时从堆分配
+    int  out_rb_size;           // 输出环形缓冲区大小
+    int  task_stack;            // 任务堆栈大小
+    int  task_core;             // 任务绑定核心
+    int  task_prio;             // 任务优先级
+    bool stack_in_ext;          // 堆栈是否放在外部RAM
+} opus_pkt_decoder_cfg_t;
+
+#define DEFAULT_OPUS_PKT_DECODER_CONFIG() {             \
+    .slab         = NULL,                               \
+    .sample_rate  = 16000,                              \
+    .channels     = 1,                                  \
+    .frame_us     = 20000,                              \
+    .streams      = 1,                                  \
+    .jitter_min_ms = 40,                                \
+    .jitter_max_ms = 400,                               \
+    .red          = false,                              \
+    .fec          = false,                              \
+    .drift_comp   = false,                              \
+    .lifecycle    = NULL,                               \
+    .arena        = NULL,                               \
+    .out_rb_size  = OPUS_PKT_DECODER_RINGBUFFER,        \
+    .task_stack   = OPUS_PKT_DECODER_TASK_STACK,        \
+    .task_core    = OPUS_PKT_TASK_CORE,                 \
+    .task_prio    = OPUS_PKT_TASK_PRIO,                 \
+    .stack_in_ext = false,                              \
+}
+
+/**
+ * @brief 创建包编码元素
+ *
+ * 每凑满一帧PCM即从slab获取空闲包槽，libopus直接编码进包槽后提交，
+ * 全程不经过环形缓冲区；slab已满时丢弃该帧并计数。
+ * 启用 dtx 时每帧先做语音活动检测：语音帧正常编码；静音段只编码首帧及此后每
+ * dtx_keepalive_ms 一帧（libopus DTX 输出舒适噪声参数），其余帧不编码、不占包槽。
+ * 未发送的帧同样推进序号与时间戳，接收端按丢包做隐藏，Opus解码器在DTX包之后自动生成舒适噪声。
+ * red_depth 大于0时每包按 opus_red.h 的格式附带前几帧的编码数据，接收端须设置 red 并把
+ * 抖动缓冲最小深度设到 (red_depth + 1) 帧以上，副本才能赶在播放点之前到达。
+ *
+ * @param config 元素配置
+ * @return 元素句柄，失败返回NULL
+ */
+audio_element_handle_t opus_pkt_encoder_init(opus_pkt_encoder_cfg_t *config);
+
+/**
+ * @brief 获取因slab已满而丢弃的帧数
+ */
+uint32_t opus_pkt_encoder_get_dropped(audio_element_handle_t self);
+
+/**
+ * @brief 获取编码统计（含VAD状态与DTX节省的帧数）
+ *
+ * @param self  编码元素句柄
+ * @param stats 输出统计
+ * @return ESP_OK 成功
+ */
+esp_err_t opus_pkt_encoder_get_stats(audio_element_handle_t self, opus_pkt_encoder_stats_t *stats);
+
+/**
+ * @brief 冲刷编码元素：丢弃未凑满的半帧，复位编码器、VAD与DTX状态
+ *
+ * 只可在元素暂停期间调用（管道已 audio_pipeline_pause），编码器实例保留，不重新分配。
+ */
+esp_err_t opus_pkt_encoder_flush(audio_element_handle_t self);
+
+/**
+ * @brief 编码端算法延迟（微秒）：攒满一帧的时长 + 编码器前瞻
+ */
+uint32_t opus_pkt_encoder_get_delay_us(audio_element_handle_t self);
+
+/**
+ * @brief 调整运行中编码器的参数（可在任意任务调用）
+ *
+ * 编码任务在下一个帧边界通过 opus_encoder_ctl 原地生效，不重建编码器、不打断音频；
+ * 帧长变化时已累积的样点并入新帧，序号与时间戳照常连续。
+ * 启用自适应时以此为新的起点，之后仍按耗时与反馈继续调整（受 rate_ctrl 上下限约束）。
+ *
+ * @param self   编码元素句柄
+ * @param params 新参数，frame_us 须为 libopus 支持的帧长且不超过60ms
+ * @return ESP_OK 成功，参数非法返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t opus_pkt_encoder_set_params(audio_element_handle_t self, const opus_rate_params_t *params);
+
+/**
+ * @brief 获取当前生效的编码参数
+ */
+esp_err_t opus_pkt_encoder_get_params(audio_element_handle_t self, opus_rate_params_t *params);
+
+/**
+ * @brief 接收端反馈的丢包率与可用带宽，驱动自适应（可在任意任务调用，未启用自适应时忽略）
+ *
+ * @param self          编码元素句柄
+ * @param loss_pct      丢包率（%）
+ * @param bandwidth_bps 可用带宽（含包头开销），0 表示未知
+ * @return ESP_OK 成功，未启用自适应返回 ESP_ERR_NOT_SUPPORTED
+ */
+esp_err_t opus_pkt_encoder_report_link(audio_element_handle_t self, uint8_t loss_pct, uint32_t bandwidth_bps);
+
+/**
+ * @brief 以同步方式打开编码器（元素不注册到管道、不创建任务，由调用者的任务直接喂数据）
+ *
+ * 用于单任务处理图（audio_graph）：元素只作为编码器状态、统计与参数接口的容器，
+ * 其余接口（统计、冲刷、参数调整、链路反馈）照常可用。
+ *
+ * @param self 由 opus_pkt_encoder_init() 创建、未运行的编码元素
+ * @return ESP_OK 成功
+ */
+esp_err_t opus_pkt_encoder_sync_open(audio_element_handle_t self);
+
+/**
+ * @brief 同步编码：按帧切分 pcm，凑满一帧即编码并写入slab，不足一帧的部分留到下次
+ *
+ * @param self    已 opus_pkt_encoder_sync_open() 的编码元素
+ * @param pcm     16位交织样点
+ * @param samples 每通道样点数
+ * @return ESP_OK 成功，未打开返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t opus_pkt_encoder_sync_feed(audio_element_handle_t self, const int16_t *pcm, size_t samples);
+
+/**
+ * @brief 关闭同步编码（状态内存保留，可再次 sync_open）
+ */
+void opus_pkt_encoder_sync_close(audio_element_handle_t self);
+
+/**
+ * @brief 创建包解码元素
+ *
+ * 将slab中到达的包移入按序号重排的自适应抖动缓冲，按播放节奏逐帧取出解码：
+ * 包齐全时正常解码，缺包时优先用下一包携带的FEC恢复，否则做PLC，不会停住管道。
+ * 输出环形缓冲区只保持 OPUS_PKT_DECODER_OUT_FRAMES 帧，延迟由抖动缓冲目标深度决定。
+ * 该元素会接管slab的通知回调，用于在新包到达时唤醒。
+ *
+ * streams 大于1时按 opus_packet_t.stream 分路，每路独立抖动缓冲、FEC/PLC与解码器状态，
+ * 逐帧按路增益饱和混音后输出一路PCM（见 opus_mixer.h）。第0路在创建时以0dB打开，
+ * 其余路通过 opus_pkt_decoder_get_mixer() 打开/关闭。
+ *
+ * drift_comp 打开时，混音输出先经异步重采样再写入输出环形缓冲区：以第0路抖动缓冲水位
+ * （已到达未播放的帧 + 最新包到达后经过的时间）为控制量，比值在 ±max_ppm 内连续微调，
+ * 抵消发送端与本地I2S时钟的偏差，长时间通话不再因水位漂移而整帧丢弃/插入。
+ * 设定点在开始播放时取目标深度加1.5帧，之后只随抖动缓冲自身的整帧调整平移，两者不相互抵消。
+ * 多路时其余路与第0路共用比值，各路发送端时钟不同时只有第0路被补偿。
+ *
+ * @param config 元素配置
+ * @return 元素句柄，失败返回NULL
+ */
+audio_element_handle_t opus_pkt_decoder_init(opus_pkt_decoder_cfg_t *config);
+
+/**
+ * @brief 按配置计算解码元素在 place 中所需的内存（按内存区对齐取整），用于预留内存区
+ *
+ * @return 字节数，配置非法返回0
+ */
+size_t opus_pkt_decoder_mem_size(const opus_pkt_decoder_cfg_t *config, audio_arena_place_t place);
+
+/**
+ * @brief 冲刷解码元素：丢弃slab中积压的包，复位各路抖动缓冲与解码器状态
+ *
+ * 只可在元素暂停期间调用（管道已 audio_pipeline_pause），恢复后重新预缓冲。
+ */
+esp_err_t opus_pkt_decoder_flush(audio_element_handle_t self);
+
+/**
+ * @brief 获取解码元素第0路的抖动缓冲统计
+ *
+ * @param self  解码元素句柄
+ * @param stats 输出统计
+ * @return ESP_OK 成功
+ */
+esp_err_t opus_pkt_decoder_get_stats(audio_element_handle_t self, jitter_buffer_stats_t *stats);
+
+/**
+ * @brief 获取时钟漂移补偿统计（比值、估计的时钟偏差、水位误差）
+ *
+ * @return ESP_OK 成功，未启用 drift_comp 返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t opus_pkt_decoder_get_drift_stats(audio_element_handle_t self, drift_asrc_stats_t *stats);
+
+/**
+ * @brief 获取解码元素的混音器，用于打开/关闭其他路、调整增益与查询各路统计
+ *
+ * 元素销毁后失效。
+ */
+opus_mixer_t *opus_pkt_decoder_get_mixer(audio_element_handle_t self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,261 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 10:00:00
+ * @LastEditTime: 2026-10-16 10:00:00
+ * @LastEditors: 星年
+ * @Description: Opus包slab实现，生产者/消费者各自推进一个原子下标并缓存对方下标，两侧字段分处不同缓存行，无锁无等待
+ * @FilePath: \audio_manager\main\opus_packet_slab.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "opus_packet_slab.h"
+
+#define OPUS_PACKET_SLAB_CACHE_LINE 64    // 按64字节隔开生产者与消费者字段（主机与S3的PSRAM缓存行均不超过64字节）
+
+/**
+ * 生产者与消费者各自只写自己那一组字段，并各缓存一份对方下标的快照：
+ * 只有快照显示已满/为空时才重读对方下标，平时收发不触碰对方写的缓存行。
+ */
+struct opus_packet_slab {
+    audio_arena_t *arena;               // 所属内存区（NULL为堆）
+    opus_packet_t *slots;               // 包描述数组
+    uint8_t *mem;                       // 包数据区，slot_count * slot_size
+    uint32_t mask;                      // slot_count - 1
+    opus_packet_slab_notify_t notify;   // 通知回调
+    void *notify_ctx;                   // 通知回调上下文
+    opus_packet_slab_watermark_t wm_cb; // 水位回调
+    void *wm_ctx;                       // 水位回调上下文
+    uint32_t wm_high;                   // 高水位（包），0 为不通知
+    uint32_t wm_low;                    // 低水位（包）
+    _Atomic bool wm_above;              // 已通知高水位、尚未通知低水位（两侧只在越过水位时交换）
+    uint8_t pad0[OPUS_PACKET_SLAB_CACHE_LINE];
+
+    // 生产者
+    _Atomic uint32_t head;              // 生产者下标（下一个提交位置）
+    uint32_t tail_cache;                // 生产者看到的消费者下标
+    uint32_t full;                      // 因已满未取到包槽的次数
+    uint8_t pad1[OPUS_PACKET_SLAB_CACHE_LINE];
+
+    // 消费者
+    _Atomic uint32_t tail;              // 消费者下标（下一个读取位置）
+    uint32_t head_cache;                // 消费者看到的生产者下标
+    uint8_t pad2[OPUS_PACKET_SLAB_CACHE_LINE];
+};
+
+opus_packet_slab_t *opus_packet_slab_create(audio_arena_t *arena, uint32_t slot_count, uint32_t slot_size)
+{
+    if (slot_count == 0 || slot_size == 0 || slot_size > UINT16_MAX) {
+        return NULL;
+    }
+    uint32_t count = 1;
+    while (count < slot_count) {
+        count <<= 1;
+    }
+    slot_size = (slot_size + 3) & ~3u;  // 每个包槽4字节对齐
+
+    // 包描述与读写下标每包都要访问，放片内；包数据区按槽整块读写，放PSRAM
+    opus_packet_slab_t *slab = audio_arena_calloc(arena, 1, sizeof(opus_packet_slab_t), AUDIO_ARENA_INTERNAL);
+    if (!slab) {
+        return NULL;
+    }
+    slab->arena = arena;
+    slab->slots = audio_arena_calloc(arena, count, sizeof(opus_packet_t), AUDIO_ARENA_INTERNAL);
+    slab->mem = audio_arena_calloc(arena, count, slot_size, AUDIO_ARENA_PSRAM);
+    if (!slab->slots || !slab->mem) {
+        opus_packet_slab_destroy(slab);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        slab->slots[i].data = slab->mem + (size_t)i * slot_size;
+        slab->slots[i].cap = (uint16_t)slot_size;
+    }
+    slab->mask = count - 1;
+    atomic_init(&slab->head, 0);
+    atomic_init(&slab->tail, 0);
+    atomic_init(&slab->wm_above, false);
+    return slab;
+}
+
+void opus_packet_slab_destroy(opus_packet_slab_t *slab)
+{
+    if (!slab) {
+        return;
+    }
+    audio_arena_free(slab->arena, slab->slots);
+    audio_arena_free(slab->arena, slab->mem);
+    audio_arena_free(slab->arena, slab);
+}
+
+void opus_packet_slab_set_notify(opus_packet_slab_t *slab, opus_packet_slab_notify_t cb, void *ctx)
+{
+    slab->notify = cb;
+    slab->notify_ctx = ctx;
+}
+
+void opus_packet_slab_set_watermarks(opus_packet_slab_t *slab, uint32_t high, uint32_t low,
+                                     opus_packet_slab_watermark_t cb, void *ctx)
+{
+    slab->wm_high = high;
+    slab->wm_low = low < high ? low : 0;
+    slab->wm_ctx = ctx;
+    slab->wm_cb = high ? cb : NULL;
+    atomic_store(&slab->wm_above, false);
+}
+
+void opus_packet_slab_reset(opus_packet_slab_t *slab)
+{
+    atomic_store(&slab->head, 0);
+    atomic_store(&slab->tail, 0);
+    slab->tail_cache = 0;
+    slab->head_cache = 0;
+    slab->full = 0;
+    atomic_store(&slab->wm_above, false);
+}
+
+/**
+ * @brief 生产者侧可写的包槽数，快照不足 want 时才重读消费者下标
+ */
+static uint32_t _opus_packet_slab_free(opus_packet_slab_t *slab, uint32_t head, uint32_t want)
+{
+    uint32_t space = slab->mask + 1 - (head - slab->tail_cache);
+    if (space < want) {
+        slab->tail_cache = atomic_load_explicit(&slab->tail, memory_order_acquire);
+        space = slab->mask + 1 - (head - slab->tail_cache);
+    }
+    return space;
+}
+
+/**
+ * @brief 消费者侧可读的包数，快照不足 want 时才重读生产者下标
+ */
+static uint32_t _opus_packet_slab_ready(opus_packet_slab_t *slab, uint32_t tail, uint32_t want)
+{
+    uint32_t ready = slab->head_cache - tail;
+    if (ready < want) {
+        slab->head_cache = atomic_load_explicit(&slab->head, memory_order_acquire);
+        ready = slab->head_cache - tail;
+    }
+    return ready;
+}
+
+opus_packet_t *opus_packet_slab_acquire_write(opus_packet_slab_t *slab)
+{
+    uint32_t head = atomic_load_explicit(&slab->head, memory_order_relaxed);
+    if (_opus_packet_slab_free(slab, head, 1) == 0) {
+        slab->full++;
+        return NULL;    // 已满
+    }
+    opus_packet_t *pkt = &slab->slots[head & slab->mask];
+    pkt->len = 0;
+    pkt->stream = 0;
+    return pkt;
+}
+
+uint32_t opus_packet_slab_acquire_write_batch(opus_packet_slab_t *slab, opus_packet_t **pkts, uint32_t max)
+{
+    uint32_t head = atomic_load_explicit(&slab->head, memory_order_relaxed);
+    uint32_t n = _opus_packet_slab_free(slab, head, max);
+    if (n > max) {
+        n = max;
+    }
+    if (n == 0 && max > 0) {
+        slab->full++;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        opus_packet_t *pkt = &slab->slots[(head + i) & slab->mask];
+        pkt->len = 0;
+        pkt->stream = 0;
+        pkts[i] = pkt;
+    }
+    return n;
+}
+
+void opus_packet_slab_commit_batch(opus_packet_slab_t *slab, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    uint32_t head = atomic_load_explicit(&slab->head, memory_order_relaxed) + count;
+    atomic_store_explicit(&slab->head, head, memory_order_release);
+    if (slab->notify) {
+        slab->notify(slab->notify_ctx);
+    }
+    // 按提交前后的占用判断是否越过高水位（两侧并发推进，通知只作提示，不保证恰好一次）
+    opus_packet_slab_watermark_t cb = slab->wm_cb;
+    if (cb) {
+        uint32_t used = head - atomic_load_explicit(&slab->tail, memory_order_acquire);
+        if (used >= slab->wm_high && used - count < slab->wm_high && !atomic_exchange(&slab->wm_above, true)) {
+            cb(slab->wm_ctx, true);
+        }
+    }
+}
+
+void opus_packet_slab_commit(opus_packet_slab_t *slab, opus_packet_t *pkt)
+{
+    (void)pkt;
+    opus_packet_slab_commit_batch(slab, 1);
+}
+
+const opus_packet_t *opus_packet_slab_acquire_read(opus_packet_slab_t *slab)
+{
+    uint32_t tail = atomic_load_explicit(&slab->tail, memory_order_relaxed);
+    if (_opus_packet_slab_ready(slab, tail, 1) == 0) {
+        return NULL;    // 为空
+    }
+    return &slab->slots[tail & slab->mask];
+}
+
+uint32_t opus_packet_slab_acquire_read_batch(opus_packet_slab_t *slab, const opus_packet_t **pkts, uint32_t max)
+{
+    uint32_t tail = atomic_load_explicit(&slab->tail, memory_order_relaxed);
+    uint32_t n = _opus_packet_slab_ready(slab, tail, max);
+    if (n > max) {
+        n = max;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        pkts[i] = &slab->slots[(tail + i) & slab->mask];
+    }
+    return n;
+}
+
+void opus_packet_slab_release_batch(opus_packet_slab_t *slab, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    uint32_t tail = atomic_load_explicit(&slab->tail, memory_order_relaxed) + count;
+    atomic_store_explicit(&slab->tail, tail, memory_order_release);
+    opus_packet_slab_watermark_t cb = slab->wm_cb;
+    if (cb) {
+        uint32_t used = atomic_load_explicit(&slab->head, memory_order_acquire) - tail;
+        if (used <= slab->wm_low && used + count > slab->wm_low && atomic_exchange(&slab->wm_above, false)) {
+            cb(slab->wm_ctx, false);
+        }
+    }
+}
+
+void opus_packet_slab_release(opus_packet_slab_t *slab, const opus_packet_t *pkt)
+{
+    (void)pkt;
+    opus_packet_slab_release_batch(slab, 1);
+}
+
+uint32_t opus_packet_slab_count(const opus_packet_slab_t *slab)
+{
+    uint32_t tail = atomic_load_explicit(&((opus_packet_slab_t *)slab)->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&((opus_packet_slab_t *)slab)->head, memory_order_acquire);
+    return head - tail;
+}
+
+uint32_t opus_packet_slab_capacity(const opus_packet_slab_t *slab)
+{
+    return slab->mask + 1;
+}
+
+uint32_t opus_packet_slab_full_count(const opus_packet_slab_t *slab)
+{
+    return slab->full;
+}
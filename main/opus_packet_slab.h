@@ -0,0 +1,158 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 10:00:00
+ * @LastEditTime: 2026-10-16 10:00:00
+ * @LastEditors: 星年
+ * @Description: Opus包slab：预分配的定长包槽环形队列，单生产者/单消费者无等待，获取/释放语义（含批量），零拷贝，可选水位通知
+ * @FilePath: \audio_manager\main\opus_packet_slab.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 一个完整的Opus包，数据位于slab内部
+ */
+typedef struct {
+    uint8_t *data;          // 包数据（指向slab内部，不可释放）
+    uint16_t len;           // 包长度（字节）
+    uint16_t cap;           // 槽容量（字节）
+    uint16_t seq;           // 包序号
+    uint8_t stream;         // 所属流（多路播放时区分说话人，单路为0）
+    uint32_t timestamp;     // 时间戳（以编码采样率的采样点计）
+    uint32_t arrival_ms;    // 本地到达时间（毫秒，仅接收端填写，供抖动缓冲统计）
+} opus_packet_t;
+
+typedef struct opus_packet_slab opus_packet_slab_t;
+
+/**
+ * @brief 通知回调，生产者每提交一个新包后调用（用于唤醒等待中的消费者）
+ */
+typedef void (*opus_packet_slab_notify_t)(void *ctx);
+
+/**
+ * @brief 水位回调：high 为 true 表示提交后占用达到高水位（在生产者任务调用），
+ *        false 表示释放后占用回落到低水位（在消费者任务调用）
+ */
+typedef void (*opus_packet_slab_watermark_t)(void *ctx, bool high);
+
+/**
+ * @brief 创建slab，所有包槽一次性分配，之后收发过程中不再分配内存
+ *
+ * @param arena      内存区（包描述在片内SRAM，包数据在PSRAM），NULL 时从堆分配
+ * @param slot_count 包槽数量（会向上取整到2的幂）
+ * @param slot_size  每个包槽容量（字节）
+ * @return slab句柄，失败返回NULL
+ */
+opus_packet_slab_t *opus_packet_slab_create(audio_arena_t *arena, uint32_t slot_count, uint32_t slot_size);
+
+/**
+ * @brief 销毁slab
+ */
+void opus_packet_slab_destroy(opus_packet_slab_t *slab);
+
+/**
+ * @brief 设置通知回调（可为NULL）
+ */
+void opus_packet_slab_set_notify(opus_packet_slab_t *slab, opus_packet_slab_notify_t cb, void *ctx);
+
+/**
+ * @brief 设置水位通知（须在生产者与消费者开始收发之前设置）
+ *
+ * 占用从低于 high 升到 high 及以上时通知一次，从高于 low 降到 low 及以下时通知一次，
+ * 两者之间不重复通知；两侧并发推进，通知只作提示（如让网络任务暂缓收包或加快发送），不保证恰好一次。
+ *
+ * @param high 高水位（包），0 为关闭通知
+ * @param low  低水位（包），须小于 high
+ * @param cb   回调，须非常短且不阻塞
+ * @param ctx  回调上下文
+ */
+void opus_packet_slab_set_watermarks(opus_packet_slab_t *slab, uint32_t high, uint32_t low,
+                                     opus_packet_slab_watermark_t cb, void *ctx);
+
+/**
+ * @brief 清空slab（仅可在生产者与消费者都停止时调用）
+ */
+void opus_packet_slab_reset(opus_packet_slab_t *slab);
+
+/**
+ * @brief 生产者获取一个空闲包槽，不阻塞
+ *
+ * @return 可写包槽，slab已满返回NULL
+ */
+opus_packet_t *opus_packet_slab_acquire_write(opus_packet_slab_t *slab);
+
+/**
+ * @brief 生产者提交此前获取的包槽（填好len/seq/timestamp后调用）
+ */
+void opus_packet_slab_commit(opus_packet_slab_t *slab, opus_packet_t *pkt);
+
+/**
+ * @brief 生产者一次获取最多 max 个连续的空闲包槽，不阻塞
+ *
+ * 下标只读一次，之后用 opus_packet_slab_commit_batch() 一次提交前若干个（按获取顺序），
+ * 未提交的包槽下次获取时仍会返回。
+ *
+ * @param pkts 输出包槽数组
+ * @param max  最多获取的个数
+ * @return 实际获取的个数，slab已满返回0
+ */
+uint32_t opus_packet_slab_acquire_write_batch(opus_packet_slab_t *slab, opus_packet_t **pkts, uint32_t max);
+
+/**
+ * @brief 生产者按获取顺序一次提交 count 个包槽，只推进一次下标、只通知一次
+ */
+void opus_packet_slab_commit_batch(opus_packet_slab_t *slab, uint32_t count);
+
+/**
+ * @brief 消费者获取最早的已提交包，不阻塞
+ *
+ * @return 只读包，slab为空返回NULL
+ */
+const opus_packet_t *opus_packet_slab_acquire_read(opus_packet_slab_t *slab);
+
+/**
+ * @brief 消费者释放此前获取的包，包槽回到空闲状态
+ */
+void opus_packet_slab_release(opus_packet_slab_t *slab, const opus_packet_t *pkt);
+
+/**
+ * @brief 消费者一次获取最多 max 个最早的已提交包，不阻塞
+ *
+ * @param pkts 输出只读包数组（按提交顺序）
+ * @param max  最多获取的个数
+ * @return 实际获取的个数，slab为空返回0
+ */
+uint32_t opus_packet_slab_acquire_read_batch(opus_packet_slab_t *slab, const opus_packet_t **pkts, uint32_t max);
+
+/**
+ * @brief 消费者按获取顺序一次释放 count 个包，只推进一次下标
+ */
+void opus_packet_slab_release_batch(opus_packet_slab_t *slab, uint32_t count);
+
+/**
+ * @brief 当前已提交未释放的包数量
+ */
+uint32_t opus_packet_slab_count(const opus_packet_slab_t *slab);
+
+/**
+ * @brief 包槽总数
+ */
+uint32_t opus_packet_slab_capacity(const opus_packet_slab_t *slab);
+
+/**
+ * @brief 生产者因slab已满而未取到包槽的累计次数（reset 清零）
+ */
+uint32_t opus_packet_slab_full_count(const opus_packet_slab_t *slab);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,325 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: Opus预录环实现，生产者独占覆盖与定位起点，读取者只推进读下标，触发在生产者的帧边界上交接，无锁
+ * @FilePath: \audio_manager\main\opus_preroll.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "opus_preroll.h"
+
+#define OPUS_PREROLL_CACHE_LINE 64          // 按64字节隔开生产者与读取者字段（同 opus_packet_slab.c）
+#define OPUS_PREROLL_WRAP       0xFFFF      // 回绕标记：本记录到环尾的空间不用，下一条记录从环首开始
+#define OPUS_PREROLL_ALIGN(n)   (((n) + 7u) & ~7u)
+
+enum {
+    OPUS_PREROLL_IDLE = 0,                  // 未触发：只保留历史，满时覆盖最旧的包
+    OPUS_PREROLL_REQUESTED,                 // 已请求触发，等生产者在帧边界上定位起点
+    OPUS_PREROLL_ARMED,                     // 已触发：读取者从读下标起取包，生产者不再覆盖未读的包
+};
+
+/**
+ * @brief 环内一条记录（包数据紧随其后）；记录连续存放，包数据不跨环尾，读取者可直接引用
+ */
+typedef struct {
+    uint16_t len;                           // 包长度，OPUS_PREROLL_WRAP 为回绕标记
+    uint16_t seq;                           // 包序号
+    uint32_t timestamp;                     // 包时间戳
+} opus_preroll_rec_t;
+
+/**
+ * 下标为单调递增的字节位置（取模环容量），最旧记录的位置 tail 只由生产者推进：
+ * 未触发时生产者可一直覆盖到 head；触发由生产者在帧边界上定位读下标后才生效，
+ * 此后只覆盖读下标之前（已读过）的记录，读取者持有的包不会被改写。
+ */
+struct opus_preroll {
+    audio_arena_t *arena;                   // 所属内存区（NULL为堆）
+    uint8_t *ring;                          // 记录环（PSRAM）
+    uint32_t mask;                          // 环容量 - 1
+    uint32_t max_record;                    // 最大记录长度（记录头 + 对齐后的最大包长）
+    uint16_t max_packet;                    // 单包最大长度
+    opus_packet_slab_notify_t notify;       // 通知回调
+    void *notify_ctx;                       // 通知回调上下文
+    _Atomic uint32_t state;                 // 触发状态
+    _Atomic uint32_t req_ts;                // 请求的起点时间戳
+    _Atomic uint32_t now_ts;                // 生产者最近发布的时间戳
+    opus_preroll_stats_t stats;             // 统计（生产者写）
+    uint8_t pad0[OPUS_PREROLL_CACHE_LINE];
+
+    // 生产者
+    _Atomic uint32_t head;                  // 写下标（下一条记录的位置）
+    _Atomic uint32_t tail;                  // 最旧记录的位置
+    uint32_t wpos;                          // 正在写入的记录位置（跳过回绕后）
+    opus_packet_t wr;                       // 写入中的包描述
+    uint8_t pad1[OPUS_PREROLL_CACHE_LINE];
+
+    // 读取者
+    _Atomic uint32_t read;                  // 读下标（下一条待读记录的位置）
+    uint32_t rd_pos;                        // 已取出的记录位置
+    opus_packet_t rd;                       // 已取出的包描述
+    uint8_t pad2[OPUS_PREROLL_CACHE_LINE];
+};
+
+static inline opus_preroll_rec_t *opus_preroll_rec(const opus_preroll_t *pr, uint32_t pos)
+{
+    return (opus_preroll_rec_t *)(pr->ring + (pos & pr->mask));
+}
+
+/**
+ * @brief pos 处记录占用的字节数（回绕标记占到环尾）
+ */
+static inline uint32_t opus_preroll_rec_size(const opus_preroll_t *pr, uint32_t pos)
+{
+    const opus_preroll_rec_t *rec = opus_preroll_rec(pr, pos);
+    if (rec->len == OPUS_PREROLL_WRAP) {
+        return pr->mask + 1 - (pos & pr->mask);
+    }
+    return OPUS_PREROLL_HEADER_BYTES + OPUS_PREROLL_ALIGN(rec->len);
+}
+
+opus_preroll_t *opus_preroll_create(audio_arena_t *arena, uint32_t bytes, uint32_t max_packet)
+{
+    if (max_packet == 0 || max_packet >= OPUS_PREROLL_WRAP) {
+        return NULL;
+    }
+    uint32_t max_record = OPUS_PREROLL_HEADER_BYTES + OPUS_PREROLL_ALIGN(max_packet);
+    // 至少容得下一次回绕加一条最大记录
+    if (bytes < 2 * max_record) {
+        bytes = 2 * max_record;
+    }
+    uint32_t cap = 1;
+    while (cap < bytes) {
+        cap <<= 1;
+    }
+
+    // 描述与下标每包都要访问，放片内；记录环整段顺序读写，放PSRAM
+    opus_preroll_t *pr = audio_arena_calloc(arena, 1, sizeof(opus_preroll_t), AUDIO_ARENA_INTERNAL);
+    if (!pr) {
+        return NULL;
+    }
+    pr->arena = arena;
+    pr->ring = audio_arena_calloc(arena, 1, cap, AUDIO_ARENA_PSRAM);
+    if (!pr->ring) {
+        opus_preroll_destroy(pr);
+        return NULL;
+    }
+    pr->mask = cap - 1;
+    pr->max_record = max_record;
+    pr->max_packet = (uint16_t)max_packet;
+    opus_preroll_reset(pr);
+    return pr;
+}
+
+void opus_preroll_destroy(opus_preroll_t *pr)
+{
+    if (!pr) {
+        return;
+    }
+    audio_arena_free(pr->arena, pr->ring);
+    audio_arena_free(pr->arena, pr);
+}
+
+void opus_preroll_reset(opus_preroll_t *pr)
+{
+    if (!pr) {
+        return;
+    }
+    atomic_store(&pr->state, OPUS_PREROLL_IDLE);
+    atomic_store(&pr->head, 0);
+    atomic_store(&pr->tail, 0);
+    atomic_store(&pr->read, 0);
+    memset(&pr->stats, 0, sizeof(pr->stats));
+    pr->stats.capacity = pr->mask + 1;
+}
+
+void opus_preroll_set_notify(opus_preroll_t *pr, opus_packet_slab_notify_t notify, void *ctx)
+{
+    if (!pr) {
+        return;
+    }
+    pr->notify_ctx = ctx;
+    pr->notify = notify;
+}
+
+void opus_preroll_poll(opus_preroll_t *pr, uint32_t now_ts)
+{
+    atomic_store_explicit(&pr->now_ts, now_ts, memory_order_relaxed);
+    if (atomic_load_explicit(&pr->state, memory_order_acquire) != OPUS_PREROLL_REQUESTED) {
+        return;
+    }
+    // 从最旧的记录向后找首个不早于起点的包；此时只有生产者在改写环，遍历不会读到半条记录
+    uint32_t from = atomic_load_explicit(&pr->req_ts, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&pr->head, memory_order_relaxed);
+    uint32_t pos = atomic_load_explicit(&pr->tail, memory_order_relaxed);
+    while (pos != head) {
+        const opus_preroll_rec_t *rec = opus_preroll_rec(pr, pos);
+        if (rec->len != OPUS_PREROLL_WRAP && (int32_t)(rec->timestamp - from) >= 0) {
+            break;
+        }
+        pos += opus_preroll_rec_size(pr, pos);
+    }
+    uint32_t n = 0;
+    uint32_t first_ts = now_ts;
+    for (uint32_t p = pos; p != head; p += opus_preroll_rec_size(pr, p)) {
+        const opus_preroll_rec_t *rec = opus_preroll_rec(pr, p);
+        if (rec->len != OPUS_PREROLL_WRAP && n++ == 0) {
+            first_ts = rec->timestamp;
+        }
+    }
+    atomic_store_explicit(&pr->read, pos, memory_order_relaxed);
+    uint32_t expect = OPUS_PREROLL_REQUESTED;
+    // 读下标随状态一起发布；其间读取者若已解除触发则放弃本次交接
+    if (atomic_compare_exchange_strong_explicit(&pr->state, &expect, OPUS_PREROLL_ARMED,
+                                                memory_order_release, memory_order_relaxed)) {
+        pr->stats.triggers++;
+        pr->stats.history_packets = n;
+        pr->stats.history_samples = now_ts - first_ts;
+        if (n && pr->notify) {
+            pr->notify(pr->notify_ctx);
+        }
+    }
+}
+
+opus_packet_t *opus_preroll_acquire_write(opus_preroll_t *pr)
+{
+    uint32_t cap = pr->mask + 1;
+    uint32_t pos = atomic_load_explicit(&pr->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&pr->tail, memory_order_relaxed);
+    // 到环尾放不下一条最大记录时回绕，保证包数据连续
+    uint32_t room = cap - (pos & pr->mask);
+    uint32_t skip = room < pr->max_record ? room : 0;
+    uint32_t need = skip + pr->max_record;
+    // 已触发时只能覆盖读取者已归还的记录
+    bool armed = atomic_load_explicit(&pr->state, memory_order_acquire) == OPUS_PREROLL_ARMED;
+    uint32_t limit = armed ? atomic_load_explicit(&pr->read, memory_order_acquire) : pos;
+    while (pos + need - tail > cap) {
+        if (tail == limit) {
+            atomic_store_explicit(&pr->tail, tail, memory_order_relaxed);
+            pr->stats.dropped++;
+            return NULL;
+        }
+        if (opus_preroll_rec(pr, tail)->len != OPUS_PREROLL_WRAP) {
+            pr->stats.evicted++;
+        }
+        tail += opus_preroll_rec_size(pr, tail);
+    }
+    atomic_store_explicit(&pr->tail, tail, memory_order_relaxed);
+    if (skip) {
+        opus_preroll_rec(pr, pos)->len = OPUS_PREROLL_WRAP;
+    }
+    pr->wpos = pos + skip;
+    pr->wr.data = (uint8_t *)opus_preroll_rec(pr, pr->wpos) + OPUS_PREROLL_HEADER_BYTES;
+    pr->wr.cap = pr->max_packet;
+    pr->wr.len = 0;
+    return &pr->wr;
+}
+
+void opus_preroll_commit(opus_preroll_t *pr, opus_packet_t *pkt)
+{
+    if (pkt != &pr->wr || pkt->len > pr->max_packet) {
+        return;
+    }
+    opus_preroll_rec_t *rec = opus_preroll_rec(pr, pr->wpos);
+    rec->len = pkt->len;
+    rec->seq = pkt->seq;
+    rec->timestamp = pkt->timestamp;
+    pr->stats.packets++;
+    atomic_store_explicit(&pr->head, pr->wpos + OPUS_PREROLL_HEADER_BYTES + OPUS_PREROLL_ALIGN(pkt->len),
+                          memory_order_release);
+    if (pr->notify && atomic_load_explicit(&pr->state, memory_order_relaxed) == OPUS_PREROLL_ARMED) {
+        pr->notify(pr->notify_ctx);
+    }
+}
+
+void opus_preroll_trigger(opus_preroll_t *pr, uint32_t from_ts)
+{
+    atomic_store_explicit(&pr->req_ts, from_ts, memory_order_relaxed);
+    atomic_store_explicit(&pr->state, OPUS_PREROLL_REQUESTED, memory_order_release);
+}
+
+void opus_preroll_disarm(opus_preroll_t *pr)
+{
+    atomic_store_explicit(&pr->state, OPUS_PREROLL_IDLE, memory_order_release);
+}
+
+bool opus_preroll_is_armed(const opus_preroll_t *pr)
+{
+    return pr && atomic_load_explicit(&pr->state, memory_order_acquire) == OPUS_PREROLL_ARMED;
+}
+
+uint32_t opus_preroll_timestamp(const opus_preroll_t *pr)
+{
+    return atomic_load_explicit(&pr->now_ts, memory_order_relaxed);
+}
+
+const opus_packet_t *opus_preroll_acquire_read(opus_preroll_t *pr)
+{
+    if (atomic_load_explicit(&pr->state, memory_order_acquire) != OPUS_PREROLL_ARMED) {
+        return NULL;
+    }
+    uint32_t pos = atomic_load_explicit(&pr->read, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&pr->head, memory_order_acquire);
+    while (pos != head) {
+        const opus_preroll_rec_t *rec = opus_preroll_rec(pr, pos);
+        if (rec->len == OPUS_PREROLL_WRAP) {
+            pos += opus_preroll_rec_size(pr, pos);
+            atomic_store_explicit(&pr->read, pos, memory_order_release);
+            continue;
+        }
+        pr->rd_pos = pos;
+        pr->rd.data = (uint8_t *)rec + OPUS_PREROLL_HEADER_BYTES;
+        pr->rd.len = rec->len;
+        pr->rd.cap = rec->len;
+        pr->rd.seq = rec->seq;
+        pr->rd.timestamp = rec->timestamp;
+        return &pr->rd;
+    }
+    return NULL;
+}
+
+void opus_preroll_release(opus_preroll_t *pr, const opus_packet_t *pkt)
+{
+    if (pkt != &pr->rd) {
+        return;
+    }
+    atomic_store_explicit(&pr->read, pr->rd_pos + OPUS_PREROLL_HEADER_BYTES + OPUS_PREROLL_ALIGN(pkt->len),
+                          memory_order_release);
+}
+
+uint32_t opus_preroll_count(const opus_preroll_t *pr)
+{
+    if (!opus_preroll_is_armed(pr)) {
+        return 0;
+    }
+    uint32_t head = atomic_load_explicit(&pr->head, memory_order_acquire);
+    uint32_t n = 0;
+    for (uint32_t p = atomic_load_explicit(&pr->read, memory_order_relaxed); p != head;
+         p += opus_preroll_rec_size(pr, p)) {
+        n += opus_preroll_rec(pr, p)->len != OPUS_PREROLL_WRAP;
+    }
+    return n;
+}
+
+void opus_preroll_get_stats(const opus_preroll_t *pr, opus_preroll_stats_t *stats)
+{
+    if (!pr || !stats) {
+        return;
+    }
+    *stats = pr->stats;
+    stats->used = atomic_load_explicit(&pr->head, memory_order_relaxed) -
+                  atomic_load_explicit(&pr->tail, memory_order_relaxed);
+}
+
+uint32_t opus_preroll_bytes_for(uint32_t history_ms, uint32_t bitrate, uint32_t frame_us, uint32_t max_packet)
+{
+    if (frame_us == 0) {
+        return 0;
+    }
+    uint32_t frames = (uint32_t)(((uint64_t)history_ms * 1000 + frame_us - 1) / frame_us);
+    uint32_t per = OPUS_PREROLL_HEADER_BYTES + OPUS_PREROLL_ALIGN((uint32_t)((uint64_t)bitrate * frame_us / 8000000));
+    return frames * per + 2 * (OPUS_PREROLL_HEADER_BYTES + OPUS_PREROLL_ALIGN(max_packet));
+}
@@ -0,0 +1,133 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: Opus预录环：编码器常开写入的变长包环（PSRAM），未触发时覆盖最旧的包只保留最近历史，
+ *               触发后从指定时间戳起把历史与实时包接成一条不断的流交给读取者，零拷贝
+ * @FilePath: \audio_manager\main\opus_preroll.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+#include "opus_packet_slab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPUS_PREROLL_HEADER_BYTES   8       // 每包记录头（长度、序号、时间戳），记录按8字节对齐
+
+typedef struct opus_preroll opus_preroll_t;
+
+/**
+ * @brief 预录环统计（生产者更新，读取者读到的是近似快照）
+ */
+typedef struct {
+    uint32_t capacity;          // 环容量（字节）
+    uint32_t used;              // 当前占用（字节，含记录头）
+    uint32_t packets;           // 写入的包数
+    uint32_t evicted;           // 因环满被覆盖的历史包数
+    uint32_t dropped;           // 已触发但读取者跟不上、环满丢弃的新包数
+    uint32_t triggers;          // 生效的触发次数
+    uint32_t history_packets;   // 最近一次触发时交出的历史包数（触发前已编码的部分）
+    uint32_t history_samples;   // 最近一次触发时交出的历史时长（采样点，首包时间戳到触发时刻）
+} opus_preroll_stats_t;
+
+/**
+ * @brief 创建预录环，环一次性分配，之后写入与读取过程中不再分配内存
+ *
+ * @param arena      内存区（描述在片内SRAM，环在PSRAM），NULL 时从堆分配
+ * @param bytes      环容量（字节，向上取整到2的幂），可保存的时长约为 bytes / (每包字节 + 记录头)
+ * @param max_packet 单包最大长度（字节），编码器按此申请写入空间
+ * @return 预录环句柄，失败返回NULL
+ */
+opus_preroll_t *opus_preroll_create(audio_arena_t *arena, uint32_t bytes, uint32_t max_packet);
+
+/**
+ * @brief 销毁预录环
+ */
+void opus_preroll_destroy(opus_preroll_t *pr);
+
+/**
+ * @brief 清空历史并解除触发（须在生产者与读取者都停止时调用）
+ */
+void opus_preroll_reset(opus_preroll_t *pr);
+
+/**
+ * @brief 设置通知回调，已触发期间每写入一个包后调用（用于唤醒读取者）
+ */
+void opus_preroll_set_notify(opus_preroll_t *pr, opus_packet_slab_notify_t notify, void *ctx);
+
+/**
+ * @brief 生产者每帧调用一次（含DTX跳过、不出包的帧）：发布当前时间戳，并在帧边界上执行待处理的触发
+ * @param now_ts 下一个包的时间戳（采样点）
+ */
+void opus_preroll_poll(opus_preroll_t *pr, uint32_t now_ts);
+
+/**
+ * @brief 生产者获取一个连续的写入空间（cap 为单包最大长度），必要时覆盖最旧的历史包
+ * @return 包描述，已触发且读取者未取走的包占满环时返回NULL（新包丢弃）
+ */
+opus_packet_t *opus_preroll_acquire_write(opus_preroll_t *pr);
+
+/**
+ * @brief 生产者提交此前获取的包（填好len/seq/timestamp后调用）
+ */
+void opus_preroll_commit(opus_preroll_t *pr, opus_packet_t *pkt);
+
+/**
+ * @brief 请求从 from_ts 起读取：下一个帧边界上由生产者定位到首个时间戳不早于 from_ts 的包，
+ *        早于最旧历史时从最旧的包开始；之后实时写入的包接在历史后面，中间不断
+ * @param from_ts 起点时间戳（采样点，与包时间戳同一时基，见 opus_preroll_timestamp()）
+ */
+void opus_preroll_trigger(opus_preroll_t *pr, uint32_t from_ts);
+
+/**
+ * @brief 解除触发，回到只保留历史的状态（此前取得的包随即失效）
+ */
+void opus_preroll_disarm(opus_preroll_t *pr);
+
+/**
+ * @brief 触发是否已生效（生产者已定位起点）
+ */
+bool opus_preroll_is_armed(const opus_preroll_t *pr);
+
+/**
+ * @brief 生产者最近发布的时间戳（下一个包的时间戳），用于换算“此前 N 毫秒”
+ */
+uint32_t opus_preroll_timestamp(const opus_preroll_t *pr);
+
+/**
+ * @brief 读取者取出下一个包（零拷贝，数据位于环内）
+ * @return 包描述，未触发、触发尚未生效或暂无新包返回NULL
+ */
+const opus_packet_t *opus_preroll_acquire_read(opus_preroll_t *pr);
+
+/**
+ * @brief 读取者归还此前取出的包，其空间此后可被覆盖
+ */
+void opus_preroll_release(opus_preroll_t *pr, const opus_packet_t *pkt);
+
+/**
+ * @brief 已触发后尚未读取的包数（读取者调用）
+ */
+uint32_t opus_preroll_count(const opus_preroll_t *pr);
+
+/**
+ * @brief 获取统计
+ */
+void opus_preroll_get_stats(const opus_preroll_t *pr, opus_preroll_stats_t *stats);
+
+/**
+ * @brief 保存 history_ms 时长所需的环容量（字节，未取整），按比特率与帧长估算，另留一个最大包的余量
+ */
+uint32_t opus_preroll_bytes_for(uint32_t history_ms, uint32_t bitrate, uint32_t frame_us, uint32_t max_packet);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,247 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 12:00:00
+ * @LastEditTime: 2026-10-17 12:00:00
+ * @LastEditors: 星年
+ * @Description: Opus编码参数自适应实现：复杂度按编码耗时的指数平均与连续超时升降（上调失败后加倍等待），
+ *               比特率按反馈带宽立即下调、持续无丢包时缓慢上调，FEC按平滑丢包率带迟滞开关
+ * @FilePath: \audio_manager\main\opus_rate_ctrl.c
+ * 遇事不决，可问春风
+ */
+#include <stdatomic.h>
+#include "opus_rate_ctrl.h"
+
+#define RC_AVG_SHIFT        3       // 编码耗时指数平均系数 1/8
+#define RC_COOLDOWN_FRAMES  8       // 调整复杂度后等平均值跟上的帧数
+#define RC_OVERRUN_STREAK   2       // 连续超出预算的帧数达到此值立即降复杂度
+#define RC_BACKOFF_MAX      8       // 上调复杂度失败后等待时长的最大倍数
+#define RC_FEC_ON_PCT       2       // 平滑丢包率达到此值打开FEC
+#define RC_FEC_OFF_PCT      1       // 平滑丢包率低于此值关闭FEC
+#define RC_LOSS_MAX_PCT     25      // 预期丢包率上限（再高FEC冗余只会挤占语音码率）
+#define RC_LOSS_CUT_PCT     10      // 带宽未知时，丢包率超过此值下调比特率
+#define RC_LOSS_GROW_PCT    2       // 丢包率低于此值才允许上调比特率
+#define RC_BITRATE_STEP     100     // 比特率取整粒度，避免反馈噪声引起频繁设置
+#define RC_LOW_BITRATE      12000   // 低于此码率时加长帧
+#define RC_HIGH_BITRATE     16000   // 高于此码率时恢复原帧长
+
+struct opus_rate_ctrl {
+    opus_rate_ctrl_cfg_t cfg;
+    opus_rate_params_t params;      // 当前参数
+    opus_rate_params_t out;         // 上一次 update() 输出的参数
+    int base_frame_us;              // 初始帧长（码率恢复后回到此帧长）
+    uint64_t now_us;                // 按帧累计的时间
+    uint32_t avg_q4;                // 编码耗时指数平均（微秒，Q4）
+    uint32_t streak;                // 连续超出预算的帧数
+    uint32_t cooldown;              // 剩余冷却帧数
+    uint32_t cpu_hold_us;           // 编码耗时持续低于下水位的时长
+    uint32_t backoff;               // 上调复杂度的等待倍数
+    uint64_t last_up_us;            // 上一次上调复杂度的时间
+    uint64_t last_grow_us;          // 上一次上调（或下调）比特率的时间
+    uint32_t loss_q4;               // 平滑丢包率（%，Q4）
+    uint32_t report_seen;           // 已处理的反馈序号
+    atomic_uint report_seq;         // 反馈序号（高24位）与丢包率（低8位）
+    atomic_uint report_bw;          // 反馈带宽
+    opus_rate_ctrl_stats_t stats;
+};
+
+static int rc_clamp(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static bool rc_params_equal(const opus_rate_params_t *a, const opus_rate_params_t *b)
+{
+    return a->bitrate == b->bitrate && a->complexity == b->complexity && a->frame_us == b->frame_us &&
+           a->fec == b->fec && a->loss_pct == b->loss_pct;
+}
+
+static uint32_t rc_budget_us(const opus_rate_ctrl_t *rc)
+{
+    return (uint32_t)((uint64_t)rc->params.frame_us * rc->cfg.cpu_budget_pct / 100);
+}
+
+opus_rate_ctrl_t *opus_rate_ctrl_create(const opus_rate_ctrl_cfg_t *cfg, const opus_rate_params_t *initial)
+{
+    if (!cfg || !initial || cfg->min_bitrate <= 0 || cfg->min_bitrate > cfg->max_bitrate ||
+        cfg->min_complexity < 0 || cfg->max_complexity > 10 || cfg->min_complexity > cfg->max_complexity ||
+        cfg->cpu_budget_pct == 0 || cfg->cpu_budget_pct > 100 || initial->frame_us <= 0) {
+        return NULL;
+    }
+    opus_rate_ctrl_t *rc = audio_arena_calloc(cfg->arena, 1, sizeof(opus_rate_ctrl_t), AUDIO_ARENA_INTERNAL);
+    if (!rc) {
+        return NULL;
+    }
+    rc->cfg = *cfg;
+    rc->base_frame_us = initial->frame_us;
+    atomic_init(&rc->report_seq, 0);
+    atomic_init(&rc->report_bw, 0);
+    opus_rate_ctrl_reset(rc, initial);
+    return rc;
+}
+
+void opus_rate_ctrl_destroy(opus_rate_ctrl_t *rc)
+{
+    if (rc) {
+        audio_arena_free(rc->cfg.arena, rc);
+    }
+}
+
+void opus_rate_ctrl_reset(opus_rate_ctrl_t *rc, const opus_rate_params_t *params)
+{
+    rc->params = *params;
+    rc->params.bitrate = rc_clamp(params->bitrate, rc->cfg.min_bitrate, rc->cfg.max_bitrate);
+    rc->params.complexity = rc_clamp(params->complexity, rc->cfg.min_complexity, rc->cfg.max_complexity);
+    rc->params.loss_pct = rc_clamp(params->loss_pct, 0, RC_LOSS_MAX_PCT);
+    rc->out = rc->params;
+    rc->streak = 0;
+    rc->cooldown = RC_COOLDOWN_FRAMES;
+    rc->cpu_hold_us = 0;
+    rc->backoff = 1;
+    rc->last_up_us = 0;
+    rc->last_grow_us = rc->now_us;
+    rc->stats.budget_us = rc_budget_us(rc);
+}
+
+void opus_rate_ctrl_encode_time(opus_rate_ctrl_t *rc, uint32_t encode_us)
+{
+    opus_rate_ctrl_stats_t *st = &rc->stats;
+    st->frames++;
+    if (encode_us > st->peak_encode_us) {
+        st->peak_encode_us = encode_us;
+    }
+    uint32_t x = encode_us << 4;
+    if (st->frames == 1) {
+        rc->avg_q4 = x;
+    } else {
+        rc->avg_q4 = (uint32_t)((int32_t)rc->avg_q4 + (((int32_t)x - (int32_t)rc->avg_q4) >> RC_AVG_SHIFT));
+    }
+    st->avg_encode_us = rc->avg_q4 >> 4;
+
+    uint32_t budget = rc_budget_us(rc);
+    if (encode_us > budget) {
+        st->overruns++;
+        rc->streak++;
+    } else {
+        rc->streak = 0;
+    }
+    if (rc->cooldown) {
+        rc->cooldown--;
+        return;
+    }
+
+    int c = rc->params.complexity;
+    uint32_t avg = st->avg_encode_us;
+    if ((avg > budget - budget / 8 || rc->streak >= RC_OVERRUN_STREAK) && c > rc->cfg.min_complexity) {
+        // 超出预算立即降一级；刚上调不久就失败说明上一级本就放不下，下次上调前等待加倍
+        if (rc->last_up_us && rc->now_us - rc->last_up_us < 2000ull * rc->cfg.hold_ms * rc->backoff) {
+            rc->backoff = rc->backoff * 2 > RC_BACKOFF_MAX ? RC_BACKOFF_MAX : rc->backoff * 2;
+        }
+        rc->params.complexity = c - 1;
+        rc->last_up_us = 0;
+    } else if (avg < budget / 2 && c < rc->cfg.max_complexity) {
+        // 持续有一半以上余量才升一级
+        rc->cpu_hold_us += (uint32_t)rc->params.frame_us;
+        if (rc->cpu_hold_us < 1000u * rc->cfg.hold_ms * rc->backoff) {
+            return;
+        }
+        rc->params.complexity = c + 1;
+        rc->last_up_us = rc->now_us;
+    } else {
+        rc->cpu_hold_us = 0;
+        return;
+    }
+    rc->cpu_hold_us = 0;
+    rc->streak = 0;
+    rc->cooldown = RC_COOLDOWN_FRAMES;
+    st->complexity_changes++;
+}
+
+void opus_rate_ctrl_report(opus_rate_ctrl_t *rc, uint8_t loss_pct, uint32_t bandwidth_bps)
+{
+    atomic_store_explicit(&rc->report_bw, bandwidth_bps, memory_order_relaxed);
+    uint32_t seq = (atomic_load_explicit(&rc->report_seq, memory_order_relaxed) & ~0xffu) + 0x100u;
+    atomic_store_explicit(&rc->report_seq, seq | (loss_pct > 100 ? 100 : loss_pct), memory_order_release);
+}
+
+/**
+ * @brief 处理一次接收端反馈：平滑丢包率、开关FEC、按带宽或丢包率调整比特率与帧长
+ */
+static void rc_handle_report(opus_rate_ctrl_t *rc, uint32_t loss, uint32_t bw)
+{
+    opus_rate_ctrl_stats_t *st = &rc->stats;
+    opus_rate_params_t *p = &rc->params;
+    st->reports++;
+    st->bandwidth_bps = bw;
+
+    // 1. 丢包率平滑（3/4 旧 + 1/4 新），FEC带迟滞开关
+    rc->loss_q4 = st->reports == 1 ? loss << 4 : (rc->loss_q4 * 3 + (loss << 4)) / 4;
+    uint32_t loss_pct = (rc->loss_q4 + 8) >> 4;
+    st->loss_pct = (uint8_t)loss_pct;
+    bool fec = p->fec ? rc->loss_q4 >= (RC_FEC_OFF_PCT << 4) : rc->loss_q4 >= (RC_FEC_ON_PCT << 4);
+    if (fec != p->fec) {
+        p->fec = fec;
+        st->fec_changes++;
+    }
+    p->loss_pct = rc_clamp((int)loss_pct, 0, RC_LOSS_MAX_PCT);
+
+    // 2. 比特率：超出可用带宽立即下调；持续 hold_ms 无明显丢包才上调 1/4（不超过可用带宽）
+    int rate = p->bitrate;
+    bool hold_done = rc->now_us - rc->last_grow_us >= 1000ull * rc->cfg.hold_ms;
+    if (bw) {
+        int pps = 1000000 / p->frame_us;
+        int avail = (int)((uint64_t)bw * 9 / 10) - rc->cfg.overhead_bytes * 8 * pps;
+        if (rate > avail) {
+            rate = avail;
+        } else if (loss_pct < RC_LOSS_GROW_PCT && hold_done) {
+            int grow = rate + rate / 4;
+            rate = grow < avail ? grow : avail;
+        }
+    } else if (loss_pct > RC_LOSS_CUT_PCT) {
+        rate -= rate / 8;
+    } else if (loss_pct < RC_LOSS_GROW_PCT && hold_done) {
+        rate += rate / 16;
+    }
+    rate = rc_clamp(rate / RC_BITRATE_STEP * RC_BITRATE_STEP, rc->cfg.min_bitrate, rc->cfg.max_bitrate);
+    if (rate != p->bitrate) {
+        if (rate > p->bitrate || bw == 0) {
+            rc->last_grow_us = rc->now_us;
+        }
+        p->bitrate = rate;
+        st->bitrate_changes++;
+    }
+
+    // 3. 帧长：低码率时包头开销占比高，加长一倍（迟滞恢复）
+    if (rc->cfg.adapt_frame) {
+        int frame = p->frame_us;
+        int longer = rc->base_frame_us * 2 > 60000 ? 60000 : rc->base_frame_us * 2;
+        if (p->bitrate <= RC_LOW_BITRATE) {
+            frame = longer;
+        } else if (p->bitrate >= RC_HIGH_BITRATE) {
+            frame = rc->base_frame_us;
+        }
+        if (frame != p->frame_us) {
+            p->frame_us = frame;
+            st->frame_changes++;
+        }
+    }
+}
+
+bool opus_rate_ctrl_update(opus_rate_ctrl_t *rc, opus_rate_params_t *params)
+{
+    rc->now_us += (uint32_t)rc->params.frame_us;
+    uint32_t seq = atomic_load_explicit(&rc->report_seq, memory_order_acquire);
+    if ((seq & ~0xffu) != rc->report_seen) {
+        rc->report_seen = seq & ~0xffu;
+        rc_handle_report(rc, seq & 0xff, atomic_load_explicit(&rc->report_bw, memory_order_relaxed));
+    }
+    rc->stats.budget_us = rc_budget_us(rc);
+    *params = rc->params;
+    bool changed = !rc_params_equal(&rc->out, &rc->params);
+    rc->out = rc->params;
+    return changed;
+}
+
+void opus_rate_ctrl_get_stats(const opus_rate_ctrl_t *rc, opus_rate_ctrl_stats_t *stats)
+{
+    *stats = rc->stats;
+}
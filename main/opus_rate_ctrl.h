@@ -0,0 +1,130 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 12:00:00
+ * @LastEditTime: 2026-10-17 12:00:00
+ * @LastEditors: 星年
+ * @Description: Opus编码参数自适应：按实测编码耗时守住CPU预算调整复杂度，按接收端反馈的丢包率/带宽调整比特率、FEC与帧长
+ * @FilePath: \audio_manager\main\opus_rate_ctrl.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 编码参数（与 opus_encoder_ctl 一一对应）
+ */
+typedef struct {
+    int bitrate;                // 目标比特率（bps）
+    int complexity;             // 编码复杂度 0~10
+    int frame_us;               // 帧长（微秒），取 10000/20000/40000/60000
+    bool fec;                   // 带内FEC（下一包携带本帧的低码率冗余）
+    int loss_pct;               // 预期丢包率（%），决定FEC冗余的分量
+} opus_rate_params_t;
+
+/**
+ * @brief 自适应配置
+ */
+typedef struct {
+    int min_bitrate;            // 比特率下限
+    int max_bitrate;            // 比特率上限
+    int min_complexity;         // 复杂度下限
+    int max_complexity;         // 复杂度上限
+    uint8_t cpu_budget_pct;     // 编码耗时预算（占帧长的百分比），编码任务与采集共核时须留出余量
+    uint8_t overhead_bytes;     // 每包传输开销（IP/UDP/RTP头），按带宽折算可用码率时扣除
+    uint16_t hold_ms;           // 提高复杂度/比特率前须持续满足条件的时长
+    bool adapt_frame;           // 低码率时加长帧以摊薄包头开销（接收端须按包实际时长计时）
+    audio_arena_t *arena;       // 内存区，NULL 时从堆分配
+} opus_rate_ctrl_cfg_t;
+
+#define DEFAULT_OPUS_RATE_CTRL_CONFIG() {   \
+    .min_bitrate    = 6000,                 \
+    .max_bitrate    = 32000,                \
+    .min_complexity = 0,                    \
+    .max_complexity = 10,                   \
+    .cpu_budget_pct = 40,                   \
+    .overhead_bytes = 40,                   \
+    .hold_ms        = 2000,                 \
+    .adapt_frame    = false,                \
+    .arena          = NULL,                 \
+}
+
+/**
+ * @brief 自适应统计
+ */
+typedef struct {
+    uint32_t frames;            // 计入的编码帧数
+    uint32_t avg_encode_us;     // 平均编码耗时（指数平均）
+    uint32_t peak_encode_us;    // 最长编码耗时
+    uint32_t budget_us;         // 当前帧长下的编码耗时预算
+    uint32_t overruns;          // 编码耗时超出预算的帧数
+    uint32_t reports;           // 收到的接收端反馈次数
+    uint8_t loss_pct;           // 平滑后的丢包率
+    uint32_t bandwidth_bps;     // 最近一次反馈的可用带宽（0 表示未知）
+    uint32_t complexity_changes; // 复杂度调整次数
+    uint32_t bitrate_changes;   // 比特率调整次数
+    uint32_t frame_changes;     // 帧长调整次数
+    uint32_t fec_changes;       // FEC开关次数
+} opus_rate_ctrl_stats_t;
+
+typedef struct opus_rate_ctrl opus_rate_ctrl_t;
+
+/**
+ * @brief 创建自适应控制器
+ *
+ * @param cfg     配置
+ * @param initial 初始参数（按配置的上下限截断）
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+opus_rate_ctrl_t *opus_rate_ctrl_create(const opus_rate_ctrl_cfg_t *cfg, const opus_rate_params_t *initial);
+
+/**
+ * @brief 销毁控制器
+ */
+void opus_rate_ctrl_destroy(opus_rate_ctrl_t *rc);
+
+/**
+ * @brief 以 params 为新的起点（手动设置参数后调用），清空耗时平均与统计之外的状态
+ *
+ * 只可在编码任务中调用。
+ */
+void opus_rate_ctrl_reset(opus_rate_ctrl_t *rc, const opus_rate_params_t *params);
+
+/**
+ * @brief 记录一帧的实测编码耗时（只可在编码任务中调用，DTX跳过的帧不计入）
+ */
+void opus_rate_ctrl_encode_time(opus_rate_ctrl_t *rc, uint32_t encode_us);
+
+/**
+ * @brief 接收端反馈（RTCP RR/REMB 等），可在任意任务调用，最新一次覆盖未处理的上一次
+ *
+ * @param rc            句柄
+ * @param loss_pct      反馈周期内的丢包率（%）
+ * @param bandwidth_bps 估计的可用带宽（含包头开销），0 表示未知、只按丢包率调整
+ */
+void opus_rate_ctrl_report(opus_rate_ctrl_t *rc, uint8_t loss_pct, uint32_t bandwidth_bps);
+
+/**
+ * @brief 计算下一帧的参数（每帧在编码任务中调用一次）
+ *
+ * @param rc     句柄
+ * @param params 输出参数
+ * @return 参数相对上一次有变化返回true
+ */
+bool opus_rate_ctrl_update(opus_rate_ctrl_t *rc, opus_rate_params_t *params);
+
+/**
+ * @brief 获取统计
+ */
+void opus_rate_ctrl_get_stats(const opus_rate_ctrl_t *rc, opus_rate_ctrl_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
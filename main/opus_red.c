@@ -0,0 +1,171 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: Opus冗余封装实现，发送端按序号保存最近几帧的主负载，解析端只返回包内指针不拷贝
+ * @FilePath: \audio_manager\main\opus_red.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "opus_red.h"
+
+#define OPUS_RED_LEN_MASK   0x3FFF      // 块头中长度所占的低14位
+
+typedef struct {
+    bool valid;
+    uint16_t seq;
+    uint16_t len;
+    uint8_t *data;
+} opus_red_entry_t;
+
+struct opus_red {
+    audio_arena_t *arena;                       // 所属内存区（NULL为堆）
+    uint8_t depth;                              // 每包携带的历史帧数
+    uint16_t max_block;                         // 单帧主负载最大长度
+    uint16_t max_bytes;                         // 每包冗余部分字节上限（0为不限）
+    uint8_t next;                               // 下一个写入的历史槽
+    opus_red_entry_t hist[OPUS_RED_MAX_DEPTH];  // 最近几帧（环形）
+    uint8_t *mem;                               // 历史帧数据，depth * max_block
+};
+
+opus_red_t *opus_red_create(audio_arena_t *arena, uint8_t depth, uint16_t max_block, uint16_t max_bytes)
+{
+    if (depth == 0 || depth > OPUS_RED_MAX_DEPTH || max_block == 0 || max_block > OPUS_RED_LEN_MASK) {
+        return NULL;
+    }
+    // 每帧只拷贝一次主负载、读取几段历史，整体放PSRAM
+    opus_red_t *red = audio_arena_calloc(arena, 1, sizeof(opus_red_t), AUDIO_ARENA_PSRAM);
+    if (!red) {
+        return NULL;
+    }
+    red->arena = arena;
+    red->mem = audio_arena_calloc(arena, depth, max_block, AUDIO_ARENA_PSRAM);
+    if (!red->mem) {
+        opus_red_destroy(red);
+        return NULL;
+    }
+    red->depth = depth;
+    red->max_block = max_block;
+    red->max_bytes = max_bytes;
+    for (uint8_t i = 0; i < depth; i++) {
+        red->hist[i].data = red->mem + (size_t)i * max_block;
+    }
+    return red;
+}
+
+size_t opus_red_mem_size(uint8_t depth, uint16_t max_block)
+{
+    return AUDIO_ARENA_SIZE(sizeof(opus_red_t)) + AUDIO_ARENA_SIZE((size_t)depth * max_block);
+}
+
+void opus_red_destroy(opus_red_t *red)
+{
+    if (!red) {
+        return;
+    }
+    audio_arena_free(red->arena, red->mem);
+    audio_arena_free(red->arena, red);
+}
+
+void opus_red_reset(opus_red_t *red)
+{
+    if (!red) {
+        return;
+    }
+    for (uint8_t i = 0; i < red->depth; i++) {
+        red->hist[i].valid = false;
+    }
+    red->next = 0;
+}
+
+/**
+ * @brief 查找序号为 seq 的历史帧
+ */
+static const opus_red_entry_t *opus_red_find(const opus_red_t *red, uint16_t seq)
+{
+    for (uint8_t i = 0; i < red->depth; i++) {
+        if (red->hist[i].valid && red->hist[i].seq == seq) {
+            return &red->hist[i];
+        }
+    }
+    return NULL;
+}
+
+size_t opus_red_begin(opus_red_t *red, uint16_t seq, uint8_t *out, size_t cap)
+{
+    if (cap < 1) {
+        return 0;
+    }
+    // 从最近一帧起选取，遇到缺帧（DTX跳过、满包丢弃）即停止，保证距离连续可算
+    const opus_red_entry_t *pick[OPUS_RED_MAX_DEPTH];
+    size_t budget = cap / 2;
+    if (red->max_bytes && red->max_bytes < budget) {
+        budget = red->max_bytes;
+    }
+    size_t used = 1;
+    int n = 0;
+    for (uint8_t d = 1; d <= red->depth; d++) {
+        const opus_red_entry_t *e = opus_red_find(red, (uint16_t)(seq - d));
+        if (!e || used + OPUS_RED_BLOCK_HEADER + e->len > budget) {
+            break;
+        }
+        used += OPUS_RED_BLOCK_HEADER + e->len;
+        pick[n++] = e;
+    }
+    // 块头与数据都按距离从远到近排列，接收端按序号顺序放回
+    uint8_t *p = out;
+    *p++ = (uint8_t)n;
+    for (int i = n - 1; i >= 0; i--) {
+        uint16_t h = (uint16_t)((i + 1) << 14 | pick[i]->len);
+        *p++ = (uint8_t)(h >> 8);
+        *p++ = (uint8_t)h;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        memcpy(p, pick[i]->data, pick[i]->len);
+        p += pick[i]->len;
+    }
+    return (size_t)(p - out);
+}
+
+void opus_red_push(opus_red_t *red, uint16_t seq, const uint8_t *primary, uint16_t len)
+{
+    opus_red_entry_t *e = &red->hist[red->next];
+    red->next = (uint8_t)((red->next + 1) % red->depth);
+    if (len > red->max_block) {
+        e->valid = false;   // 过长的帧不做冗余，之后的包在此处断开
+        return;
+    }
+    memcpy(e->data, primary, len);
+    e->len = len;
+    e->seq = seq;
+    e->valid = true;
+}
+
+int opus_red_parse(const uint8_t *pkt, size_t len, opus_red_block_t *blocks, int max)
+{
+    if (!pkt || len < 1) {
+        return -1;
+    }
+    int n = pkt[0];
+    if (n > OPUS_RED_MAX_DEPTH || n + 1 > max || len < 1 + (size_t)n * OPUS_RED_BLOCK_HEADER) {
+        return -1;
+    }
+    size_t off = 1 + (size_t)n * OPUS_RED_BLOCK_HEADER;
+    for (int i = 0; i < n; i++) {
+        uint16_t h = (uint16_t)(pkt[1 + i * OPUS_RED_BLOCK_HEADER] << 8 | pkt[2 + i * OPUS_RED_BLOCK_HEADER]);
+        uint16_t blen = h & OPUS_RED_LEN_MASK;
+        if (off + blen > len || (h >> 14) == 0) {
+            return -1;
+        }
+        blocks[i].data = pkt + off;
+        blocks[i].len = blen;
+        blocks[i].distance = (uint8_t)(h >> 14);
+        off += blen;
+    }
+    blocks[n].data = pkt + off;
+    blocks[n].len = (uint16_t)(len - off);
+    blocks[n].distance = 0;
+    return n + 1;
+}
@@ -0,0 +1,97 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-17 18:00:00
+ * @LastEditTime: 2026-10-17 18:00:00
+ * @LastEditors: 星年
+ * @Description: Opus冗余封装（RED，参照RFC 2198的紧凑格式）：每包附带前 N 帧的编码数据，
+ *               接收端丢包后可从后续包中取回原帧，弥补带内FEC只覆盖前一帧的不足
+ * @FilePath: \audio_manager\main\opus_red.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPUS_RED_MAX_DEPTH      3       // 每包最多携带的历史帧数（块头中距离占2位）
+#define OPUS_RED_BLOCK_HEADER   2       // 每个冗余块的块头：距离(2位) + 长度(14位)，大端
+
+/*
+ * 包格式：[冗余块数 n(1字节)] [块头 × n] [冗余块数据 × n，按距离从远到近] [主负载]
+ * 主负载即本帧的Opus包，长度为包长减去前面各部分；n 为0时只多1字节。
+ * 收发两端须约定同时启用（相当于RTP中协商RED负载类型）。
+ */
+
+/**
+ * @brief 解析出的一个块：distance 为0是主负载，1~3 为前 distance 帧的冗余数据
+ */
+typedef struct {
+    const uint8_t *data;    // 块数据（指向包内部）
+    uint16_t len;           // 块长度
+    uint8_t distance;       // 与本包序号之差
+} opus_red_block_t;
+
+typedef struct opus_red opus_red_t;
+
+/**
+ * @brief 创建发送端冗余状态：保存最近 depth 帧的主负载，一次性分配
+ *
+ * @param arena     内存区（历史帧在PSRAM），NULL 时从堆分配
+ * @param depth     每包携带的历史帧数（1 ~ OPUS_RED_MAX_DEPTH）
+ * @param max_block 单帧主负载最大长度（字节），更长的帧不进入历史
+ * @param max_bytes 每包冗余部分（含块头）的字节上限，0 为只受包容量限制
+ * @return 句柄，失败返回NULL
+ */
+opus_red_t *opus_red_create(audio_arena_t *arena, uint8_t depth, uint16_t max_block, uint16_t max_bytes);
+
+/**
+ * @brief 创建所需的内存（全部在PSRAM，按内存区对齐取整），用于预留内存区
+ */
+size_t opus_red_mem_size(uint8_t depth, uint16_t max_block);
+
+/**
+ * @brief 销毁
+ */
+void opus_red_destroy(opus_red_t *red);
+
+/**
+ * @brief 清空历史（编码器冲刷、序号不再连续时调用）
+ */
+void opus_red_reset(opus_red_t *red);
+
+/**
+ * @brief 为序号 seq 的包写入包头与冗余块，返回主负载的偏移
+ *
+ * 从最近一帧起逐个加入序号连续的历史帧，直到达到深度、字节上限或包容量的一半
+ * （另一半留给主负载）。调用者随后把本帧直接编码到 out + 偏移 处。
+ *
+ * @param out 包缓冲区
+ * @param cap 包缓冲区容量
+ * @return 主负载偏移（字节），cap 不足1字节时返回0
+ */
+size_t opus_red_begin(opus_red_t *red, uint16_t seq, uint8_t *out, size_t cap);
+
+/**
+ * @brief 记下序号 seq 的主负载，供之后的包携带
+ */
+void opus_red_push(opus_red_t *red, uint16_t seq, const uint8_t *primary, uint16_t len);
+
+/**
+ * @brief 解析一个冗余封装的包
+ *
+ * @param pkt    包数据
+ * @param len    包长度
+ * @param blocks 输出块数组，按距离从远到近，最后一个为主负载
+ * @param max    blocks 容量（OPUS_RED_MAX_DEPTH + 1 即可容纳任意包）
+ * @return 块数（含主负载），格式错误或 max 不足返回-1
+ */
+int opus_red_parse(const uint8_t *pkt, size_t len, opus_red_block_t *blocks, int max);
+
+#ifdef __cplusplus
+}
+#endif
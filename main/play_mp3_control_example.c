@@ -7,22 +7,86 @@
 
 // ESP-IDF日志库，用于输出调试和运行日志
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 
 // 音频框架相关头文件
 #include "opus_decode_play.h"   // 新增头文件引用
 #include "opus_encode_recorder.h" // 新增头文件引用
+#include "audio_latency.h"        // 延迟档位
+#include "audio_probe.h"          // 管道探针
+#include "audio_duplex.h"         // 全双工引擎
+#include "audio_aec.h"            // 回声消除
+#include "audio_arena.h"          // 内存区
+#include "dsp_bench.h"            // DSP内核微基准
 // 日志TAG
 static const char *TAG = "AUDIO_TASK";
 
+// 启停压测轮数：大于0时启动后先反复停止/启动录制与播放，校验启停耗时与堆内存不增长
+#define AUDIO_LIFECYCLE_SOAK_CYCLES 0
+
+// DSP内核微基准：为1时启动各管道前先按CPU周期跑一遍内核基准（含精度比较），与内嵌基线比较
+#define AUDIO_DSP_BENCH 0
+
+/**
+ * @brief 启停压测：每轮停止再启动录制与播放，结束后打印启停耗时与前后空闲堆
+ */
+static void lifecycle_soak(int cycles)
+{
+    audio_lifecycle_stats_t rec, play;
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    for (int i = 0; i < cycles; i++) {
+        opus_encode_recorder_stop();
+        opus_decode_play_stop();
+        vTaskDelay(pdMS_TO_TICKS(10));
+        opus_decode_play_start();
+        opus_encode_recorder_start();
+        vTaskDelay(pdMS_TO_TICKS(30));
+    }
+    size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    opus_encode_recorder_get_lifecycle(&rec);
+    opus_decode_play_get_lifecycle(&play);
+    ESP_LOGI(TAG, "soak %d cycles, free heap %u -> %u", cycles, (unsigned)heap_before, (unsigned)heap_after);
+    ESP_LOGI(TAG, "rec  build %luus start max %luus stop max %luus first data max %luus",
+             (unsigned long)rec.build_us, (unsigned long)rec.start_max_us,
+             (unsigned long)rec.stop_max_us, (unsigned long)rec.first_data_max_us);
+    ESP_LOGI(TAG, "play build %luus start max %luus stop max %luus",
+             (unsigned long)play.build_us, (unsigned long)play.start_max_us, (unsigned long)play.stop_max_us);
+}
+
 /**
  * @brief 主应用入口
  *        初始化音频管道、外设、事件监听，处理按键事件，实现MP3播放控制
  */
 void app_main(void)
 {
+    if (AUDIO_DSP_BENCH) {
+        dsp_bench_run_target(true, DSP_BENCH_THRESHOLD_PCT);
+    }
+
+    // 选择延迟档位，需在启动各管道前设置
+    audio_latency_set_profile(AUDIO_LATENCY_BALANCED);
+
+    // 全双工引擎独占I2S0收发，需先于播放与采集启动；失败时各管道退回各自独立的I2S
+    if (audio_duplex_start() != ESP_OK) {
+        ESP_LOGW(TAG, "full-duplex engine unavailable, using separate I2S pipelines");
+    } else if (audio_aec_start(NULL) != ESP_OK) {
+        // 回声消除依赖全双工引擎提供对齐的播放参考
+        ESP_LOGW(TAG, "echo cancellation unavailable");
+    }
+
     // 启动opus解码播放任务
     opus_decode_play_start();
 
     // 启动opus编码录制任务
     opus_encode_recorder_start();
+
+    if (AUDIO_LIFECYCLE_SOAK_CYCLES > 0) {
+        lifecycle_soak(AUDIO_LIFECYCLE_SOAK_CYCLES);
+    }
+
+    // 打印各管道内存区的预算与各元素占用，即整条音频链路的固定内存占用
+    audio_arena_log_all();
+
+    // 每5秒打印一次各元素耗时与缓冲区水位
+    audio_probe_start_log(5000);
 }
@@ -0,0 +1,100 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 09:00:00
+ * @LastEditTime: 2026-10-16 09:00:00
+ * @LastEditors: 星年
+ * @Description: 多相FIR定点重采样器实现，ESP32-S3使用PIE向量点积，其余平台使用可移植C实现
+ * @FilePath: \audio_manager\main\polyphase_resampler.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+#include "polyphase_resampler.h"
+#include "polyphase_resampler_coef.h"
+
+#define RSP_HIST        (POLYPHASE_RSP_TAPS - 1)                    // 历史样点数
+#define RSP_CAP         (RSP_HIST + POLYPHASE_RSP_BLOCK)            // buf 有效数据容量
+#define RSP_STEP_INT    (POLYPHASE_RSP_DOWN / POLYPHASE_RSP_UP)     // 每个输出前进的整数输入样点
+#define RSP_STEP_FRAC   (POLYPHASE_RSP_DOWN % POLYPHASE_RSP_UP)     // 每个输出前进的相位增量
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(POLYPHASE_RSP_FORCE_C)
+/**
+ * @brief PIE向量点积（见 polyphase_resampler_aes3.S）
+ *
+ * x 可不对齐，h 必须16字节对齐，n8 为8样点组数；返回未移位的32位累加和。
+ */
+extern int32_t polyphase_rsp_dot_aes3(const int16_t *x, const int16_t *h, int n8);
+#define RSP_DOT(x, h) polyphase_rsp_dot_aes3((x), (h), POLYPHASE_RSP_TAPS / 8)
+#else
+/**
+ * @brief 可移植C点积，与PIE版本逐位一致
+ */
+static inline int32_t rsp_dot_c(const int16_t *x, const int16_t *h)
+{
+    int32_t acc = 0;
+    for (int i = 0; i < POLYPHASE_RSP_TAPS; i++) {
+        acc += (int32_t)x[i] * h[i];
+    }
+    return acc;
+}
+#define RSP_DOT(x, h) rsp_dot_c((x), (h))
+#endif
+
+static inline int16_t rsp_sat16(int32_t v)
+{
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+void polyphase_rsp_reset(polyphase_rsp_t *rsp)
+{
+    memset(rsp, 0, sizeof(*rsp));
+    rsp->fill = RSP_HIST;   // 历史以0填充，首个输出对应第一个输入样点
+    rsp->end = RSP_HIST;
+}
+
+size_t polyphase_rsp_max_output(size_t in_samples)
+{
+    return (in_samples * POLYPHASE_RSP_UP) / POLYPHASE_RSP_DOWN + 2;
+}
+
+size_t polyphase_rsp_process(polyphase_rsp_t *rsp, const int16_t *in, size_t in_samples, int16_t *out)
+{
+    size_t produced = 0;
+
+    while (in_samples > 0) {
+        // 1. 将一批新输入追加到历史之后
+        size_t n = RSP_CAP - rsp->fill;
+        if (n > in_samples) n = in_samples;
+        memcpy(&rsp->buf[rsp->fill], in, n * sizeof(int16_t));
+        rsp->fill += n;
+        in += n;
+        in_samples -= n;
+
+        // 2. 窗口末端落在有效数据内的输出全部算完
+        uint32_t end = rsp->end;
+        uint32_t phase = rsp->phase;
+        while (end < rsp->fill) {
+            int32_t acc = RSP_DOT(&rsp->buf[end - RSP_HIST], s_polyphase_coef[phase]);
+            out[produced++] = rsp_sat16((acc + (1 << 14)) >> 15);
+            end += RSP_STEP_INT;
+            phase += RSP_STEP_FRAC;
+            if (phase >= POLYPHASE_RSP_UP) {
+                phase -= POLYPHASE_RSP_UP;
+                end++;
+            }
+        }
+
+        // 3. 丢弃不再需要的样点，仅保留下一个窗口所需的历史
+        uint32_t drop = end - RSP_HIST;
+        if (drop > rsp->fill) drop = rsp->fill;
+        memmove(rsp->buf, &rsp->buf[drop], (rsp->fill - drop) * sizeof(int16_t));
+        rsp->fill -= drop;
+        rsp->end = end - drop;
+        rsp->phase = phase;
+    }
+    return produced;
+}
@@ -0,0 +1,67 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 09:00:00
+ * @LastEditTime: 2026-10-16 09:00:00
+ * @LastEditors: 星年
+ * @Description: 多相FIR定点重采样器（44100Hz -> 16000Hz，160/441），纯C实现，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\polyphase_resampler.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POLYPHASE_RSP_UP        160     // 上采样因子
+#define POLYPHASE_RSP_DOWN      441     // 下采样因子
+#define POLYPHASE_RSP_TAPS      48      // 每个相位的抽头数（8的倍数，便于SIMD）
+#define POLYPHASE_RSP_BLOCK     256     // 内部每批处理的输入样点数
+#define POLYPHASE_RSP_PAD       8       // SIMD越界读取的尾部填充（样点）
+
+/**
+ * @brief 重采样器状态
+ *
+ * buf 前 TAPS-1 个样点为滤波器历史，之后为本批新输入；
+ * end/phase 记录下一个输出样点对应的窗口末端与相位，跨调用保持，
+ * 因此块边界处不会丢失小数相位，也不会产生咔嗒声。
+ */
+typedef struct {
+    int16_t buf[POLYPHASE_RSP_TAPS - 1 + POLYPHASE_RSP_BLOCK + POLYPHASE_RSP_PAD] __attribute__((aligned(16)));
+    uint32_t fill;      // buf 中有效样点数
+    uint32_t end;       // 下一个输出的窗口末端下标（窗口为 buf[end-TAPS+1 .. end]）
+    uint32_t phase;     // 下一个输出的相位，0 .. UP-1
+} polyphase_rsp_t;
+
+/**
+ * @brief 复位重采样器（清空历史，相位归零）
+ *
+ * @param rsp 重采样器状态
+ */
+void polyphase_rsp_reset(polyphase_rsp_t *rsp);
+
+/**
+ * @brief 计算输入 in_samples 个样点时最多可能产生的输出样点数
+ *
+ * @param in_samples 输入样点数
+ * @return 输出缓冲区需要的最小容量（样点）
+ */
+size_t polyphase_rsp_max_output(size_t in_samples);
+
+/**
+ * @brief 重采样一段16位单声道PCM
+ *
+ * @param rsp        重采样器状态
+ * @param in         输入样点（44100Hz）
+ * @param in_samples 输入样点数，可为任意长度
+ * @param out        输出缓冲区（16000Hz），容量不小于 polyphase_rsp_max_output(in_samples)
+ * @return 实际输出的样点数
+ */
+size_t polyphase_rsp_process(polyphase_rsp_t *rsp, const int16_t *in, size_t in_samples, int16_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,970 @@
+/*
+ * 由 tools/gen_polyphase_coef.py 生成, 请勿手工修改
+ * UP=160 DOWN=441 TAPS=48 FC=7200Hz Kaiser beta=6.0
+ */
+#pragma once
+
+#include <stdint.h>
+
+static const int16_t s_polyphase_coef[160][48] __attribute__((aligned(16))) = {
+    { // phase 0
+           -13,    -12,     14,     49,     42,    -35,   -125,   -107,     66,    262,    236,   -105,
+          -495,   -472,    146,    894,    920,   -182,  -1688,  -1984,    203,   4522,   8866,  10703,
+          8888,   4552,    224,  -1978,  -1696,   -192,    917,    897,    151,   -469,   -497,   -108,
+           234,    263,     68,   -107,   -125,    -36,     41,     49,     15,    -12,    -13,     -3,
+    },
+    { // phase 1
+           -13,    -12,     14,     49,     42,    -35,   -124,   -108,     65,    262,    237,   -102,
+          -494,   -474,    141,    891,    924,   -173,  -1681,  -1989,    181,   4492,   8845,  10704,
+          8909,   4581,    246,  -1973,  -1703,   -201,    913,    900,    156,   -467,   -499,   -111,
+           233,    264,     69,   -106,   -125,    -37,     41,     49,     15,    -12,    -13,     -3,
+    },
+    { // phase 2
+           -13,    -12,     14,     48,     42,    -34,   -124,   -109,     63,    261,    238,   -100,
+          -492,   -476,    136,    887,    927,   -163,  -1673,  -1994,    159,   4462,   8823,  10703,
+          8931,   4611,    268,  -1968,  -1710,   -211,    910,    904,    162,   -465,   -500,   -113,
+           232,    265,     70,   -106,   -126,    -37,     41,     49,     15,    -11,    -13,     -3,
+    },
+    { // phase 3
+           -12,    -12,     14,     48,     42,    -33,   -124,   -109,     62,    260,    239,    -97,
+          -491,   -478,    131,    884,    931,   -154,  -1666,  -1999,    138,   4432,   8801,  10703,
+          8952,   4641,    290,  -1962,  -1718,   -220,    906,    907,    167,   -463,   -502,   -116,
+           231,    265,     72,   -105,   -126,    -38,     40,     49,     15,    -11,    -13,     -3,
+    },
+    { // phase 4
+           -12,    -12,     13,     48,     43,    -33,   -123,   -110,     61,    259,    240,    -94,
+          -489,   -480,    126,    880,    934,   -144,  -1658,  -2004,    116,   4402,   8779,  10701,
+          8973,   4671,    312,  -1956,  -1725,   -230,    903,    910,    172,   -461,   -503,   -119,
+           229,    266,     73,   -104,   -126,    -38,     40,     49,     16,    -11,    -13,     -3,
+    },
+    { // phase 5
+           -12,    -12,     13,     48,     43,    -32,   -123,   -111,     59,    258,    242,    -91,
+          -487,   -482,    121,    877,    937,   -135,  -1650,  -2009,     95,   4372,   8757,  10699,
+          8994,   4701,    335,  -1950,  -1732,   -240,    899,    913,    177,   -458,   -505,   -122,
+           228,    267,     75,   -104,   -127,    -39,     40,     50,     16,    -11,    -13,     -3,
+    },
+    { // phase 6
+           -12,    -12,     13,     48,     43,    -31,   -122,   -111,     58,    258,    243,    -89,
+          -486,   -484,    116,    874,    940,   -125,  -1643,  -2013,     74,   4342,   8735,  10696,
+          9015,   4731,    357,  -1945,  -1739,   -249,    895,    916,    182,   -456,   -506,   -124,
+           227,    268,     76,   -103,   -127,    -40,     40,     50,     16,    -11,    -13,     -4,
+    },
+    { // phase 7
+           -12,    -12,     13,     48,     43,    -31,   -122,   -112,     57,    257,    244,    -86,
+          -484,   -486,    111,    870,    943,   -116,  -1635,  -2018,     52,   4312,   8713,  10701,
+          9036,   4761,    379,  -1939,  -1746,   -259,    891,    919,    187,   -454,   -508,   -127,
+           225,    268,     77,   -102,   -127,    -40,     39,     50,     16,    -11,    -13,     -4,
+    },
+    { // phase 8
+           -12,    -12,     13,     48,     44,    -30,   -122,   -112,     55,    256,    245,    -83,
+          -482,   -488,    106,    867,    946,   -106,  -1627,  -2022,     31,   4283,   8691,  10695,
+          9056,   4791,    402,  -1932,  -1753,   -269,    887,    922,    192,   -451,   -509,   -130,
+           224,    269,     79,   -102,   -128,    -41,     39,     50,     16,    -11,    -13,     -4,
+    },
+    { // phase 9
+           -12,    -12,     12,     47,     44,    -30,   -121,   -113,     54,    255,    246,    -81,
+          -480,   -490,    101,    863,    950,    -97,  -1619,  -2027,     10,   4253,   8668,  10697,
+          9077,   4821,    424,  -1926,  -1760,   -278,    883,    925,    197,   -449,   -511,   -133,
+           223,    270,     80,   -101,   -128,    -42,     39,     50,     17,    -11,    -13,     -4,
+    },
+    { // phase 10
+           -12,    -12,     12,     47,     44,    -29,   -121,   -113,     52,    254,    247,    -78,
+          -479,   -492,     96,    860,    953,    -88,  -1611,  -2031,    -10,   4223,   8646,  10695,
+          9097,   4850,    447,  -1920,  -1767,   -288,    879,    928,    203,   -447,   -512,   -135,
+           221,    270,     82,   -100,   -128,    -42,     38,     50,     17,    -11,    -13,     -4,
+    },
+    { // phase 11
+           -12,    -13,     12,     47,     44,    -28,   -121,   -114,     51,    253,    248,    -75,
+          -477,   -493,     91,    856,    955,    -78,  -1603,  -2035,    -31,   4193,   8623,  10692,
+          9118,   4880,    470,  -1913,  -1774,   -298,    875,    931,    208,   -444,   -513,   -138,
+           220,    271,     83,    -99,   -128,    -43,     38,     50,     17,    -11,    -13,     -4,
+    },
+    { // phase 12
+           -12,    -13,     12,     47,     45,    -28,   -120,   -115,     50,    253,    249,    -72,
+          -475,   -495,     86,    852,    958,    -69,  -1595,  -2039,    -52,   4163,   8600,  10691,
+          9138,   4910,    493,  -1907,  -1781,   -308,    871,    934,    213,   -442,   -515,   -141,
+           219,    272,     85,    -99,   -129,    -43,     38,     50,     17,    -11,    -13,     -4,
+    },
+    { // phase 13
+           -12,    -13,     11,     47,     45,    -27,   -120,   -115,     48,    252,    250,    -70,
+          -473,   -497,     81,    849,    961,    -60,  -1587,  -2043,    -73,   4134,   8578,  10687,
+          9158,   4940,    516,  -1900,  -1787,   -317,    867,    937,    218,   -439,   -516,   -144,
+           217,    272,     86,    -98,   -129,    -44,     37,     51,     18,    -11,    -13,     -4,
+    },
+    { // phase 14
+           -12,    -13,     11,     47,     45,    -27,   -119,   -116,     47,    251,    251,    -67,
+          -472,   -499,     76,    845,    964,    -50,  -1579,  -2047,    -93,   4104,   8555,  10684,
+          9178,   4970,    539,  -1894,  -1794,   -327,    863,    940,    223,   -437,   -517,   -146,
+           216,    273,     87,    -97,   -129,    -45,     37,     51,     18,    -10,    -13,     -4,
+    },
+    { // phase 15
+           -12,    -13,     11,     46,     45,    -26,   -119,   -116,     46,    250,    253,    -64,
+          -470,   -501,     71,    841,    967,    -41,  -1571,  -2051,   -113,   4074,   8532,  10684,
+          9198,   5000,    562,  -1887,  -1801,   -337,    859,    942,    228,   -434,   -519,   -149,
+           214,    273,     89,    -97,   -130,    -45,     37,     51,     18,    -10,    -13,     -4,
+    },
+    { // phase 16
+           -12,    -13,     11,     46,     45,    -25,   -119,   -117,     44,    249,    254,    -62,
+          -468,   -502,     66,    838,    969,    -32,  -1563,  -2054,   -134,   4044,   8509,  10682,
+          9218,   5030,    585,  -1880,  -1807,   -347,    855,    945,    233,   -432,   -520,   -152,
+           213,    274,     90,    -96,   -130,    -46,     37,     51,     18,    -10,    -13,     -4,
+    },
+    { // phase 17
+           -12,    -13,     11,     46,     46,    -25,   -118,   -117,     43,    248,    255,    -59,
+          -466,   -504,     61,    834,    972,    -23,  -1555,  -2058,   -154,   4014,   8485,  10680,
+          9237,   5059,    608,  -1873,  -1814,   -357,    850,    948,    239,   -429,   -521,   -155,
+           211,    275,     92,    -95,   -130,    -47,     36,     51,     19,    -10,    -13,     -4,
+    },
+    { // phase 18
+           -12,    -13,     10,     46,     46,    -24,   -118,   -118,     41,    247,    256,    -56,
+          -464,   -506,     56,    830,    975,    -14,  -1547,  -2062,   -174,   3985,   8462,  10678,
+          9257,   5089,    632,  -1866,  -1820,   -367,    846,    950,    244,   -426,   -523,   -158,
+           210,    275,     93,    -94,   -130,    -47,     36,     51,     19,    -10,    -13,     -4,
+    },
+    { // phase 19
+           -12,    -13,     10,     46,     46,    -23,   -117,   -118,     40,    246,    256,    -54,
+          -462,   -507,     51,    826,    977,     -5,  -1538,  -2065,   -194,   3955,   8439,  10676,
+          9276,   5119,    655,  -1858,  -1827,   -376,    842,    953,    249,   -424,   -524,   -160,
+           208,    276,     94,    -94,   -131,    -48,     36,     51,     19,    -10,    -14,     -4,
+    },
+    { // phase 20
+           -12,    -13,     10,     46,     46,    -23,   -117,   -119,     39,    245,    257,    -51,
+          -460,   -509,     46,    823,    980,      5,  -1530,  -2068,   -214,   3925,   8415,  10673,
+          9296,   5149,    678,  -1851,  -1833,   -386,    837,    956,    254,   -421,   -525,   -163,
+           207,    276,     96,    -93,   -131,    -49,     35,     51,     19,    -10,    -14,     -4,
+    },
+    { // phase 21
+           -12,    -13,     10,     45,     47,    -22,   -116,   -119,     37,    244,    258,    -48,
+          -458,   -511,     41,    819,    982,     14,  -1522,  -2071,   -234,   3896,   8392,  10668,
+          9315,   5179,    702,  -1843,  -1840,   -396,    833,    958,    259,   -419,   -526,   -166,
+           205,    277,     97,    -92,   -131,    -49,     35,     51,     20,    -10,    -14,     -4,
+    },
+    { // phase 22
+           -11,    -13,      9,     45,     47,    -22,   -116,   -120,     36,    243,    259,    -46,
+          -456,   -512,     36,    815,    985,     23,  -1513,  -2074,   -254,   3866,   8368,  10663,
+          9334,   5208,    726,  -1836,  -1846,   -406,    828,    961,    265,   -416,   -527,   -169,
+           204,    278,     99,    -91,   -131,    -50,     35,     52,     20,    -10,    -14,     -4,
+    },
+    { // phase 23
+           -11,    -13,      9,     45,     47,    -21,   -116,   -120,     35,    242,    260,    -43,
+          -454,   -514,     31,    811,    987,     32,  -1505,  -2077,   -273,   3836,   8344,  10662,
+          9353,   5238,    750,  -1828,  -1852,   -416,    824,    963,    270,   -413,   -529,   -171,
+           202,    278,    100,    -90,   -132,    -51,     34,     52,     20,    -10,    -14,     -4,
+    },
+    { // phase 24
+           -11,    -13,      9,     45,     47,    -20,   -115,   -121,     33,    241,    261,    -40,
+          -453,   -515,     27,    807,    989,     41,  -1496,  -2080,   -293,   3807,   8321,  10656,
+          9372,   5268,    773,  -1820,  -1858,   -426,    819,    966,    275,   -410,   -530,   -174,
+           201,    279,    101,    -90,   -132,    -51,     34,     52,     20,     -9,    -14,     -5,
+    },
+    { // phase 25
+           -11,    -13,      9,     45,     47,    -20,   -115,   -121,     32,    240,    262,    -38,
+          -451,   -517,     22,    803,    992,     50,  -1488,  -2083,   -312,   3777,   8297,  10656,
+          9390,   5298,    797,  -1812,  -1864,   -436,    814,    968,    280,   -408,   -531,   -177,
+           199,    279,    103,    -89,   -132,    -52,     34,     52,     20,     -9,    -14,     -5,
+    },
+    { // phase 26
+           -11,    -13,      9,     45,     48,    -19,   -114,   -122,     31,    239,    263,    -35,
+          -449,   -518,     17,    799,    994,     59,  -1479,  -2086,   -332,   3747,   8273,  10648,
+          9409,   5327,    821,  -1804,  -1870,   -446,    810,    971,    285,   -405,   -532,   -180,
+           198,    280,    104,    -88,   -132,    -52,     33,     52,     21,     -9,    -14,     -5,
+    },
+    { // phase 27
+           -11,    -13,      8,     44,     48,    -19,   -114,   -122,     29,    238,    264,    -32,
+          -447,   -520,     12,    795,    996,     68,  -1471,  -2088,   -351,   3718,   8249,  10648,
+          9428,   5357,    845,  -1796,  -1876,   -456,    805,    973,    290,   -402,   -533,   -183,
+           196,    280,    106,    -87,   -133,    -53,     33,     52,     21,     -9,    -14,     -5,
+    },
+    { // phase 28
+           -11,    -14,      8,     44,     48,    -18,   -113,   -122,     28,    237,    265,    -30,
+          -445,   -521,      7,    791,    998,     76,  -1462,  -2091,   -370,   3688,   8224,  10644,
+          9446,   5387,    869,  -1788,  -1882,   -466,    800,    976,    296,   -399,   -534,   -185,
+           195,    281,    107,    -86,   -133,    -54,     32,     52,     21,     -9,    -14,     -5,
+    },
+    { // phase 29
+           -11,    -14,      8,     44,     48,    -17,   -113,   -123,     27,    236,    265,    -27,
+          -442,   -522,      2,    787,   1000,     85,  -1453,  -2093,   -389,   3659,   8200,  10640,
+          9464,   5416,    894,  -1780,  -1888,   -476,    795,    978,    301,   -396,   -535,   -188,
+           193,    281,    108,    -86,   -133,    -54,     32,     52,     21,     -9,    -14,     -5,
+    },
+    { // phase 30
+           -11,    -14,      8,     44,     48,    -17,   -112,   -123,     25,    235,    266,    -25,
+          -440,   -524,     -2,    783,   1002,     94,  -1445,  -2095,   -408,   3629,   8176,  10634,
+          9483,   5446,    918,  -1771,  -1894,   -486,    790,    980,    306,   -393,   -536,   -191,
+           191,    282,    110,    -85,   -133,    -55,     32,     52,     22,     -9,    -14,     -5,
+    },
+    { // phase 31
+           -11,    -14,      8,     44,     48,    -16,   -112,   -124,     24,    234,    267,    -22,
+          -438,   -525,     -7,    779,   1004,    103,  -1436,  -2098,   -427,   3600,   8151,  10631,
+          9501,   5476,    942,  -1763,  -1899,   -495,    785,    982,    311,   -391,   -537,   -194,
+           190,    282,    111,    -84,   -133,    -56,     31,     52,     22,     -9,    -14,     -5,
+    },
+    { // phase 32
+           -11,    -14,      7,     43,     49,    -16,   -111,   -124,     23,    233,    268,    -19,
+          -436,   -526,    -12,    775,   1006,    112,  -1427,  -2100,   -446,   3570,   8127,  10624,
+          9519,   5505,    967,  -1754,  -1905,   -505,    780,    985,    316,   -388,   -538,   -196,
+           188,    282,    113,    -83,   -134,    -56,     31,     52,     22,     -9,    -14,     -5,
+    },
+    { // phase 33
+           -11,    -14,      7,     43,     49,    -15,   -111,   -125,     21,    232,    269,    -17,
+          -434,   -528,    -17,    771,   1008,    121,  -1419,  -2102,   -464,   3541,   8102,  10620,
+          9536,   5535,    991,  -1745,  -1911,   -515,    775,    987,    322,   -385,   -539,   -199,
+           186,    283,    114,    -82,   -134,    -57,     31,     53,     22,     -8,    -14,     -5,
+    },
+    { // phase 34
+           -11,    -14,      7,     43,     49,    -14,   -110,   -125,     20,    231,    269,    -14,
+          -432,   -529,    -21,    767,   1010,    129,  -1410,  -2104,   -483,   3511,   8077,  10614,
+          9554,   5564,   1016,  -1736,  -1916,   -525,    770,    989,    327,   -382,   -540,   -202,
+           185,    283,    115,    -81,   -134,    -58,     30,     53,     23,     -8,    -14,     -5,
+    },
+    { // phase 35
+           -11,    -14,      7,     43,     49,    -14,   -110,   -125,     19,    230,    270,    -12,
+          -430,   -530,    -26,    763,   1012,    138,  -1401,  -2105,   -501,   3482,   8053,  10605,
+          9572,   5594,   1041,  -1728,  -1922,   -535,    765,    991,    332,   -379,   -541,   -205,
+           183,    284,    117,    -80,   -134,    -58,     30,     53,     23,     -8,    -14,     -5,
+    },
+    { // phase 36
+           -11,    -14,      6,     43,     49,    -13,   -110,   -126,     17,    229,    271,     -9,
+          -428,   -531,    -31,    758,   1014,    147,  -1392,  -2107,   -520,   3453,   8028,  10603,
+          9589,   5624,   1066,  -1718,  -1927,   -545,    760,    993,    337,   -376,   -542,   -208,
+           181,    284,    118,    -80,   -134,    -59,     30,     53,     23,     -8,    -14,     -5,
+    },
+    { // phase 37
+           -11,    -14,      6,     42,     49,    -13,   -109,   -126,     16,    228,    272,     -6,
+          -426,   -533,    -36,    754,   1015,    155,  -1383,  -2109,   -538,   3423,   8003,  10600,
+          9606,   5653,   1090,  -1709,  -1932,   -555,    755,    995,    342,   -373,   -543,   -210,
+           180,    284,    120,    -79,   -134,    -59,     29,     53,     23,     -8,    -14,     -5,
+    },
+    { // phase 38
+           -11,    -14,      6,     42,     50,    -12,   -109,   -126,     15,    227,    272,     -4,
+          -424,   -534,    -40,    750,   1017,    164,  -1374,  -2110,   -556,   3394,   7978,  10590,
+          9624,   5683,   1115,  -1700,  -1938,   -565,    749,    997,    348,   -369,   -544,   -213,
+           178,    285,    121,    -78,   -135,    -60,     29,     53,     24,     -8,    -14,     -5,
+    },
+    { // phase 39
+           -10,    -14,      6,     42,     50,    -12,   -108,   -127,     13,    226,    273,     -1,
+          -421,   -535,    -45,    746,   1018,    172,  -1365,  -2112,   -574,   3365,   7953,  10586,
+          9641,   5712,   1140,  -1691,  -1943,   -576,    744,    999,    353,   -366,   -544,   -216,
+           176,    285,    123,    -77,   -135,    -61,     28,     53,     24,     -8,    -14,     -5,
+    },
+    { // phase 40
+           -10,    -14,      6,     42,     50,    -11,   -108,   -127,     12,    225,    274,      1,
+          -419,   -536,    -50,    741,   1020,    181,  -1356,  -2113,   -592,   3335,   7928,  10579,
+          9658,   5741,   1165,  -1681,  -1948,   -586,    739,   1001,    358,   -363,   -545,   -219,
+           174,    286,    124,    -76,   -135,    -61,     28,     53,     24,     -8,    -14,     -5,
+    },
+    { // phase 41
+           -10,    -14,      5,     42,     50,    -10,   -107,   -128,     11,    224,    274,      4,
+          -417,   -537,    -54,    737,   1022,    190,  -1347,  -2114,   -610,   3306,   7902,  10571,
+          9674,   5771,   1191,  -1671,  -1953,   -596,    733,   1003,    363,   -360,   -546,   -221,
+           173,    286,    125,    -75,   -135,    -62,     28,     53,     24,     -7,    -14,     -6,
+    },
+    { // phase 42
+           -10,    -14,      5,     41,     50,    -10,   -107,   -128,     10,    223,    275,      6,
+          -415,   -538,    -59,    733,   1023,    198,  -1338,  -2115,   -628,   3277,   7877,  10568,
+          9691,   5800,   1216,  -1662,  -1958,   -606,    728,   1005,    368,   -357,   -547,   -224,
+           171,    286,    127,    -74,   -135,    -63,     27,     53,     25,     -7,    -14,     -6,
+    },
+    { // phase 43
+           -10,    -14,      5,     41,     50,     -9,   -106,   -128,      8,    222,    276,      9,
+          -413,   -539,    -64,    728,   1024,    206,  -1329,  -2117,   -646,   3248,   7852,  10564,
+          9708,   5830,   1241,  -1652,  -1963,   -616,    722,   1006,    373,   -354,   -548,   -227,
+           169,    286,    128,    -73,   -135,    -63,     27,     53,     25,     -7,    -14,     -6,
+    },
+    { // phase 44
+           -10,    -14,      5,     41,     50,     -9,   -106,   -129,      7,    221,    276,     11,
+          -410,   -540,    -68,    724,   1026,    215,  -1320,  -2117,   -663,   3219,   7826,  10555,
+          9724,   5859,   1266,  -1642,  -1968,   -626,    717,   1008,    379,   -350,   -548,   -230,
+           167,    287,    129,    -72,   -135,    -64,     26,     53,     25,     -7,    -14,     -6,
+    },
+    { // phase 45
+           -10,    -14,      5,     41,     51,     -8,   -105,   -129,      6,    219,    277,     14,
+          -408,   -541,    -73,    720,   1027,    223,  -1311,  -2118,   -681,   3189,   7800,  10549,
+          9741,   5888,   1292,  -1632,  -1973,   -636,    711,   1010,    384,   -347,   -549,   -232,
+           165,    287,    131,    -71,   -136,    -65,     26,     53,     25,     -7,    -14,     -6,
+    },
+    { // phase 46
+           -10,    -14,      4,     41,     51,     -7,   -105,   -129,      4,    218,    277,     16,
+          -406,   -542,    -77,    715,   1028,    232,  -1301,  -2119,   -698,   3160,   7775,  10545,
+          9757,   5917,   1317,  -1622,  -1977,   -646,    705,   1011,    389,   -344,   -550,   -235,
+           164,    287,    132,    -71,   -136,    -65,     26,     53,     25,     -7,    -14,     -6,
+    },
+    { // phase 47
+           -10,    -14,      4,     40,     51,     -7,   -104,   -130,      3,    217,    278,     19,
+          -404,   -543,    -82,    711,   1030,    240,  -1292,  -2120,   -715,   3131,   7749,  10535,
+          9773,   5947,   1343,  -1611,  -1982,   -656,    700,   1013,    394,   -341,   -550,   -238,
+           162,    288,    134,    -70,   -136,    -66,     25,     53,     26,     -7,    -14,     -6,
+    },
+    { // phase 48
+           -10,    -14,      4,     40,     51,     -6,   -103,   -130,      2,    216,    279,     21,
+          -401,   -544,    -87,    706,   1031,    248,  -1283,  -2120,   -732,   3102,   7723,  10526,
+          9789,   5976,   1369,  -1601,  -1987,   -666,    694,   1015,    399,   -337,   -551,   -241,
+           160,    288,    135,    -69,   -136,    -66,     25,     53,     26,     -6,    -14,     -6,
+    },
+    { // phase 49
+           -10,    -14,      4,     40,     51,     -6,   -103,   -130,      1,    215,    279,     24,
+          -399,   -545,    -91,    702,   1032,    256,  -1274,  -2121,   -749,   3073,   7697,  10523,
+          9805,   6005,   1394,  -1591,  -1991,   -676,    688,   1016,    404,   -334,   -552,   -243,
+           158,    288,    136,    -68,   -136,    -67,     24,     53,     26,     -6,    -14,     -6,
+    },
+    { // phase 50
+           -10,    -14,      4,     40,     51,     -5,   -102,   -130,     -1,    214,    280,     26,
+          -397,   -546,    -96,    698,   1033,    265,  -1264,  -2121,   -766,   3044,   7672,  10512,
+          9820,   6034,   1420,  -1580,  -1996,   -686,    682,   1018,    410,   -331,   -552,   -246,
+           156,    288,    138,    -67,   -136,    -68,     24,     53,     26,     -6,    -14,     -6,
+    },
+    { // phase 51
+           -10,    -14,      3,     40,     51,     -5,   -102,   -131,     -2,    213,    280,     29,
+          -394,   -546,   -100,    693,   1034,    273,  -1255,  -2122,   -783,   3016,   7645,  10504,
+          9836,   6063,   1446,  -1569,  -2000,   -696,    676,   1019,    415,   -327,   -553,   -249,
+           154,    289,    139,    -66,   -136,    -68,     24,     54,     27,     -6,    -15,     -6,
+    },
+    { // phase 52
+           -10,    -14,      3,     39,     51,     -4,   -101,   -131,     -3,    211,    281,     31,
+          -392,   -547,   -105,    689,   1035,    281,  -1246,  -2122,   -800,   2987,   7619,  10497,
+          9851,   6092,   1472,  -1559,  -2004,   -706,    671,   1021,    420,   -324,   -553,   -251,
+           152,    289,    141,    -65,   -136,    -69,     23,     54,     27,     -6,    -15,     -6,
+    },
+    { // phase 53
+           -10,    -14,      3,     39,     52,     -4,   -101,   -131,     -4,    210,    281,     34,
+          -390,   -548,   -109,    684,   1036,    289,  -1236,  -2122,   -817,   2958,   7593,  10490,
+          9867,   6121,   1498,  -1548,  -2009,   -716,    665,   1022,    425,   -320,   -554,   -254,
+           150,    289,    142,    -64,   -136,    -70,     23,     54,     27,     -6,    -15,     -6,
+    },
+    { // phase 54
+           -10,    -14,      3,     39,     52,     -3,   -100,   -132,     -6,    209,    282,     36,
+          -387,   -549,   -114,    680,   1037,    297,  -1227,  -2122,   -833,   2929,   7567,  10482,
+          9882,   6150,   1524,  -1537,  -2013,   -726,    659,   1024,    430,   -317,   -554,   -257,
+           148,    289,    143,    -63,   -136,    -70,     22,     54,     27,     -6,    -15,     -6,
+    },
+    { // phase 55
+            -9,    -15,      3,     39,     52,     -2,   -100,   -132,     -7,    208,    282,     39,
+          -385,   -550,   -118,    675,   1038,    305,  -1218,  -2122,   -850,   2900,   7541,  10473,
+          9897,   6179,   1550,  -1526,  -2017,   -736,    653,   1025,    435,   -313,   -555,   -260,
+           147,    289,    145,    -62,   -136,    -71,     22,     54,     28,     -6,    -15,     -6,
+    },
+    { // phase 56
+            -9,    -15,      2,     39,     52,     -2,    -99,   -132,     -8,    207,    283,     41,
+          -383,   -550,   -123,    670,   1039,    313,  -1208,  -2122,   -866,   2872,   7514,  10463,
+          9912,   6208,   1576,  -1514,  -2021,   -746,    646,   1026,    440,   -310,   -555,   -262,
+           145,    290,    146,    -61,   -136,    -71,     21,     54,     28,     -5,    -15,     -6,
+    },
+    { // phase 57
+            -9,    -15,      2,     38,     52,     -1,    -99,   -132,     -9,    206,    283,     44,
+          -380,   -551,   -127,    666,   1039,    321,  -1199,  -2122,   -882,   2843,   7488,  10457,
+          9927,   6237,   1602,  -1503,  -2025,   -756,    640,   1027,    445,   -306,   -556,   -265,
+           143,    290,    147,    -60,   -137,    -72,     21,     54,     28,     -5,    -15,     -6,
+    },
+    { // phase 58
+            -9,    -15,      2,     38,     52,     -1,    -98,   -132,    -11,    204,    284,     46,
+          -378,   -552,   -131,    661,   1040,    329,  -1189,  -2121,   -898,   2814,   7461,  10450,
+          9941,   6266,   1629,  -1492,  -2029,   -766,    634,   1029,    451,   -303,   -556,   -268,
+           141,    290,    149,    -59,   -137,    -73,     20,     54,     28,     -5,    -15,     -7,
+    },
+    { // phase 59
+            -9,    -15,      2,     38,     52,      0,    -98,   -133,    -12,    203,    284,     48,
+          -376,   -552,   -136,    657,   1041,    337,  -1180,  -2121,   -914,   2786,   7435,  10439,
+          9956,   6295,   1655,  -1480,  -2033,   -776,    628,   1030,    456,   -299,   -557,   -270,
+           139,    290,    150,    -58,   -137,    -73,     20,     54,     29,     -5,    -15,     -7,
+    },
+    { // phase 60
+            -9,    -15,      2,     38,     52,      0,    -97,   -133,    -13,    202,    284,     51,
+          -373,   -553,   -140,    652,   1041,    345,  -1170,  -2120,   -930,   2757,   7408,  10428,
+          9970,   6324,   1682,  -1468,  -2036,   -786,    622,   1031,    461,   -296,   -557,   -273,
+           137,    290,    152,    -57,   -137,    -74,     20,     54,     29,     -5,    -15,     -7,
+    },
+    { // phase 61
+            -9,    -15,      2,     38,     52,      1,    -96,   -133,    -14,    201,    285,     53,
+          -371,   -553,   -144,    647,   1042,    353,  -1161,  -2120,   -946,   2729,   7381,  10421,
+          9985,   6352,   1708,  -1457,  -2040,   -796,    615,   1032,    466,   -292,   -557,   -276,
+           135,    290,    153,    -56,   -137,    -75,     19,     54,     29,     -5,    -15,     -7,
+    },
+    { // phase 62
+            -9,    -15,      1,     37,     52,      1,    -96,   -133,    -15,    200,    285,     55,
+          -368,   -554,   -149,    643,   1042,    361,  -1151,  -2119,   -962,   2700,   7355,  10414,
+          9999,   6381,   1735,  -1445,  -2044,   -806,    609,   1033,    471,   -289,   -558,   -278,
+           133,    290,    154,    -55,   -137,    -75,     19,     54,     29,     -5,    -15,     -7,
+    },
+    { // phase 63
+            -9,    -15,      1,     37,     53,      2,    -95,   -134,    -17,    198,    286,     58,
+          -366,   -554,   -153,    638,   1043,    368,  -1141,  -2118,   -977,   2672,   7328,  10400,
+         10013,   6410,   1761,  -1433,  -2047,   -816,    603,   1034,    476,   -285,   -558,   -281,
+           131,    290,    156,    -54,   -137,    -76,     18,     54,     30,     -4,    -15,     -7,
+    },
+    { // phase 64
+            -9,    -15,      1,     37,     53,      2,    -95,   -134,    -18,    197,    286,     60,
+          -363,   -555,   -157,    633,   1043,    376,  -1132,  -2118,   -993,   2643,   7301,  10394,
+         10027,   6438,   1788,  -1421,  -2050,   -826,    596,   1035,    481,   -281,   -558,   -284,
+           129,    290,    157,    -53,   -137,    -76,     18,     54,     30,     -4,    -15,     -7,
+    },
+    { // phase 65
+            -9,    -15,      1,     37,     53,      3,    -94,   -134,    -19,    196,    286,     63,
+          -361,   -555,   -162,    628,   1044,    384,  -1122,  -2117,  -1008,   2615,   7274,  10382,
+         10040,   6467,   1815,  -1408,  -2054,   -836,    590,   1036,    486,   -278,   -558,   -286,
+           127,    290,    158,    -52,   -137,    -77,     17,     54,     30,     -4,    -15,     -7,
+    },
+    { // phase 66
+            -9,    -15,      1,     36,     53,      3,    -94,   -134,    -20,    195,    287,     65,
+          -359,   -556,   -166,    624,   1044,    391,  -1113,  -2116,  -1024,   2587,   7247,  10377,
+         10054,   6495,   1842,  -1396,  -2057,   -846,    583,   1037,    491,   -274,   -559,   -289,
+           124,    290,    160,    -51,   -137,    -78,     17,     54,     30,     -4,    -15,     -7,
+    },
+    { // phase 67
+            -9,    -15,      0,     36,     53,      4,    -93,   -134,    -21,    193,    287,     67,
+          -356,   -556,   -170,    619,   1044,    399,  -1103,  -2115,  -1039,   2558,   7220,  10368,
+         10067,   6524,   1868,  -1384,  -2060,   -856,    577,   1038,    496,   -270,   -559,   -292,
+           122,    290,    161,    -50,   -137,    -78,     16,     54,     30,     -4,    -15,     -7,
+    },
+    { // phase 68
+            -9,    -15,      0,     36,     53,      5,    -93,   -134,    -23,    192,    287,     70,
+          -354,   -557,   -174,    614,   1045,    407,  -1093,  -2113,  -1054,   2530,   7193,  10355,
+         10081,   6552,   1895,  -1371,  -2063,   -866,    570,   1038,    501,   -266,   -559,   -294,
+           120,    290,    162,    -49,   -137,    -79,     16,     54,     31,     -4,    -15,     -7,
+    },
+    { // phase 69
+            -9,    -15,      0,     36,     53,      5,    -92,   -135,    -24,    191,    287,     72,
+          -351,   -557,   -179,    609,   1045,    414,  -1083,  -2112,  -1069,   2502,   7165,  10346,
+         10094,   6581,   1922,  -1359,  -2066,   -876,    563,   1039,    506,   -263,   -559,   -297,
+           118,    290,    164,    -47,   -137,    -79,     15,     54,     31,     -3,    -15,     -7,
+    },
+    { // phase 70
+            -9,    -15,      0,     36,     53,      6,    -91,   -135,    -25,    190,    288,     74,
+          -349,   -557,   -183,    605,   1045,    422,  -1074,  -2111,  -1084,   2474,   7138,  10333,
+         10107,   6609,   1949,  -1346,  -2069,   -886,    557,   1040,    511,   -259,   -559,   -300,
+           116,    290,    165,    -46,   -137,    -80,     15,     54,     31,     -3,    -15,     -7,
+    },
+    { // phase 71
+            -8,    -15,      0,     35,     53,      6,    -91,   -135,    -26,    188,    288,     76,
+          -346,   -558,   -187,    600,   1045,    429,  -1064,  -2109,  -1098,   2446,   7111,  10323,
+         10120,   6637,   1977,  -1333,  -2072,   -896,    550,   1040,    516,   -255,   -559,   -302,
+           114,    290,    166,    -45,   -137,    -81,     15,     54,     31,     -3,    -15,     -7,
+    },
+    { // phase 72
+            -8,    -15,      0,     35,     53,      7,    -90,   -135,    -27,    187,    288,     79,
+          -344,   -558,   -191,    595,   1045,    437,  -1054,  -2108,  -1113,   2418,   7083,  10310,
+         10133,   6666,   2004,  -1320,  -2075,   -906,    543,   1041,    521,   -251,   -560,   -305,
+           112,    290,    168,    -44,   -137,    -81,     14,     54,     32,     -3,    -15,     -7,
+    },
+    { // phase 73
+            -8,    -15,     -1,     35,     53,      7,    -90,   -135,    -28,    186,    288,     81,
+          -341,   -558,   -195,    590,   1045,    444,  -1045,  -2106,  -1128,   2390,   7056,  10302,
+         10146,   6694,   2031,  -1307,  -2078,   -916,    536,   1042,    526,   -247,   -560,   -308,
+           110,    290,    169,    -43,   -136,    -82,     14,     54,     32,     -3,    -15,     -8,
+    },
+    { // phase 74
+            -8,    -15,     -1,     35,     53,      8,    -89,   -135,    -30,    185,    289,     83,
+          -339,   -559,   -199,    585,   1045,    451,  -1035,  -2105,  -1142,   2362,   7028,  10295,
+         10158,   6722,   2058,  -1294,  -2081,   -926,    529,   1042,    531,   -243,   -560,   -310,
+           108,    290,    170,    -42,   -136,    -83,     13,     54,     32,     -3,    -15,     -8,
+    },
+    { // phase 75
+            -8,    -15,     -1,     34,     53,      8,    -88,   -136,    -31,    183,    289,     86,
+          -336,   -559,   -203,    580,   1045,    459,  -1025,  -2103,  -1156,   2334,   7001,  10280,
+         10170,   6750,   2086,  -1281,  -2083,   -936,    523,   1043,    536,   -239,   -560,   -313,
+           105,    290,    172,    -41,   -136,    -83,     13,     54,     32,     -2,    -15,     -8,
+    },
+    { // phase 76
+            -8,    -15,     -1,     34,     53,      9,    -88,   -136,    -32,    182,    289,     88,
+          -333,   -559,   -208,    576,   1045,    466,  -1015,  -2101,  -1171,   2306,   6973,  10270,
+         10183,   6778,   2113,  -1267,  -2086,   -946,    516,   1043,    541,   -236,   -560,   -315,
+           103,    290,    173,    -40,   -136,    -84,     12,     54,     33,     -2,    -15,     -8,
+    },
+    { // phase 77
+            -8,    -15,     -1,     34,     53,      9,    -87,   -136,    -33,    181,    289,     90,
+          -331,   -559,   -212,    571,   1045,    473,  -1005,  -2099,  -1185,   2278,   6945,  10259,
+         10195,   6806,   2140,  -1254,  -2088,   -956,    509,   1044,    546,   -232,   -560,   -318,
+           101,    290,    174,    -39,   -136,    -84,     12,     54,     33,     -2,    -15,     -8,
+    },
+    { // phase 78
+            -8,    -15,     -1,     34,     53,     10,    -87,   -136,    -34,    179,    289,     92,
+          -328,   -559,   -216,    566,   1045,    480,   -995,  -2097,  -1199,   2251,   6918,  10246,
+         10207,   6834,   2168,  -1240,  -2090,   -966,    502,   1044,    551,   -228,   -560,   -321,
+            99,    290,    176,    -38,   -136,    -85,     11,     54,     33,     -2,    -15,     -8,
+    },
+    { // phase 79
+            -8,    -15,     -2,     33,     54,     10,    -86,   -136,    -35,    178,    290,     95,
+          -326,   -559,   -220,    561,   1045,    487,   -986,  -2095,  -1213,   2223,   6890,  10235,
+         10219,   6862,   2195,  -1226,  -2093,   -976,    494,   1044,    556,   -224,   -559,   -323,
+            97,    290,    177,    -36,   -136,    -86,     11,     54,     33,     -2,    -15,     -8,
+    },
+    { // phase 80
+            -8,    -15,     -2,     33,     54,     11,    -86,   -136,    -36,    177,    290,     97,
+          -323,   -559,   -224,    556,   1044,    494,   -976,  -2093,  -1226,   2195,   6862,  10219,
+         10235,   6890,   2223,  -1213,  -2095,   -986,    487,   1045,    561,   -220,   -559,   -326,
+            95,    290,    178,    -35,   -136,    -86,     10,     54,     33,     -2,    -15,     -8,
+    },
+    { // phase 81
+            -8,    -15,     -2,     33,     54,     11,    -85,   -136,    -38,    176,    290,     99,
+          -321,   -560,   -228,    551,   1044,    502,   -966,  -2090,  -1240,   2168,   6834,  10207,
+         10246,   6918,   2251,  -1199,  -2097,   -995,    480,   1045,    566,   -216,   -559,   -328,
+            92,    289,    179,    -34,   -136,    -87,     10,     53,     34,     -1,    -15,     -8,
+    },
+    { // phase 82
+            -8,    -15,     -2,     33,     54,     12,    -84,   -136,    -39,    174,    290,    101,
+          -318,   -560,   -232,    546,   1044,    509,   -956,  -2088,  -1254,   2140,   6806,  10195,
+         10259,   6945,   2278,  -1185,  -2099,  -1005,    473,   1045,    571,   -212,   -559,   -331,
+            90,    289,    181,    -33,   -136,    -87,      9,     53,     34,     -1,    -15,     -8,
+    },
+    { // phase 83
+            -8,    -15,     -2,     33,     54,     12,    -84,   -136,    -40,    173,    290,    103,
+          -315,   -560,   -236,    541,   1043,    516,   -946,  -2086,  -1267,   2113,   6778,  10183,
+         10270,   6973,   2306,  -1171,  -2101,  -1015,    466,   1045,    576,   -208,   -559,   -333,
+            88,    289,    182,    -32,   -136,    -88,      9,     53,     34,     -1,    -15,     -8,
+    },
+    { // phase 84
+            -8,    -15,     -2,     32,     54,     13,    -83,   -136,    -41,    172,    290,    105,
+          -313,   -560,   -239,    536,   1043,    523,   -936,  -2083,  -1281,   2086,   6750,  10170,
+         10280,   7001,   2334,  -1156,  -2103,  -1025,    459,   1045,    580,   -203,   -559,   -336,
+            86,    289,    183,    -31,   -136,    -88,      8,     53,     34,     -1,    -15,     -8,
+    },
+    { // phase 85
+            -8,    -15,     -3,     32,     54,     13,    -83,   -136,    -42,    170,    290,    108,
+          -310,   -560,   -243,    531,   1042,    529,   -926,  -2081,  -1294,   2058,   6722,  10158,
+         10295,   7028,   2362,  -1142,  -2105,  -1035,    451,   1045,    585,   -199,   -559,   -339,
+            83,    289,    185,    -30,   -135,    -89,      8,     53,     35,     -1,    -15,     -8,
+    },
+    { // phase 86
+            -8,    -15,     -3,     32,     54,     14,    -82,   -136,    -43,    169,    290,    110,
+          -308,   -560,   -247,    526,   1042,    536,   -916,  -2078,  -1307,   2031,   6694,  10146,
+         10302,   7056,   2390,  -1128,  -2106,  -1045,    444,   1045,    590,   -195,   -558,   -341,
+            81,    288,    186,    -28,   -135,    -90,      7,     53,     35,     -1,    -15,     -8,
+    },
+    { // phase 87
+            -7,    -15,     -3,     32,     54,     14,    -81,   -137,    -44,    168,    290,    112,
+          -305,   -560,   -251,    521,   1041,    543,   -906,  -2075,  -1320,   2004,   6666,  10133,
+         10310,   7083,   2418,  -1113,  -2108,  -1054,    437,   1045,    595,   -191,   -558,   -344,
+            79,    288,    187,    -27,   -135,    -90,      7,     53,     35,      0,    -15,     -8,
+    },
+    { // phase 88
+            -7,    -15,     -3,     31,     54,     15,    -81,   -137,    -45,    166,    290,    114,
+          -302,   -559,   -255,    516,   1040,    550,   -896,  -2072,  -1333,   1977,   6637,  10120,
+         10323,   7111,   2446,  -1098,  -2109,  -1064,    429,   1045,    600,   -187,   -558,   -346,
+            76,    288,    188,    -26,   -135,    -91,      6,     53,     35,      0,    -15,     -8,
+    },
+    { // phase 89
+            -7,    -15,     -3,     31,     54,     15,    -80,   -137,    -46,    165,    290,    116,
+          -300,   -559,   -259,    511,   1040,    557,   -886,  -2069,  -1346,   1949,   6609,  10107,
+         10333,   7138,   2474,  -1084,  -2111,  -1074,    422,   1045,    605,   -183,   -557,   -349,
+            74,    288,    190,    -25,   -135,    -91,      6,     53,     36,      0,    -15,     -9,
+    },
+    { // phase 90
+            -7,    -15,     -3,     31,     54,     15,    -79,   -137,    -47,    164,    290,    118,
+          -297,   -559,   -263,    506,   1039,    563,   -876,  -2066,  -1359,   1922,   6581,  10094,
+         10346,   7165,   2502,  -1069,  -2112,  -1083,    414,   1045,    609,   -179,   -557,   -351,
+            72,    287,    191,    -24,   -135,    -92,      5,     53,     36,      0,    -15,     -9,
+    },
+    { // phase 91
+            -7,    -15,     -4,     31,     54,     16,    -79,   -137,    -49,    162,    290,    120,
+          -294,   -559,   -266,    501,   1038,    570,   -866,  -2063,  -1371,   1895,   6552,  10081,
+         10355,   7193,   2530,  -1054,  -2113,  -1093,    407,   1045,    614,   -174,   -557,   -354,
+            70,    287,    192,    -23,   -134,    -93,      5,     53,     36,      0,    -15,     -9,
+    },
+    { // phase 92
+            -7,    -15,     -4,     30,     54,     16,    -78,   -137,    -50,    161,    290,    122,
+          -292,   -559,   -270,    496,   1038,    577,   -856,  -2060,  -1384,   1868,   6524,  10067,
+         10368,   7220,   2558,  -1039,  -2115,  -1103,    399,   1044,    619,   -170,   -556,   -356,
+            67,    287,    193,    -21,   -134,    -93,      4,     53,     36,      0,    -15,     -9,
+    },
+    { // phase 93
+            -7,    -15,     -4,     30,     54,     17,    -78,   -137,    -51,    160,    290,    124,
+          -289,   -559,   -274,    491,   1037,    583,   -846,  -2057,  -1396,   1842,   6495,  10054,
+         10377,   7247,   2587,  -1024,  -2116,  -1113,    391,   1044,    624,   -166,   -556,   -359,
+            65,    287,    195,    -20,   -134,    -94,      3,     53,     36,      1,    -15,     -9,
+    },
+    { // phase 94
+            -7,    -15,     -4,     30,     54,     17,    -77,   -137,    -52,    158,    290,    127,
+          -286,   -558,   -278,    486,   1036,    590,   -836,  -2054,  -1408,   1815,   6467,  10040,
+         10382,   7274,   2615,  -1008,  -2117,  -1122,    384,   1044,    628,   -162,   -555,   -361,
+            63,    286,    196,    -19,   -134,    -94,      3,     53,     37,      1,    -15,     -9,
+    },
+    { // phase 95
+            -7,    -15,     -4,     30,     54,     18,    -76,   -137,    -53,    157,    290,    129,
+          -284,   -558,   -281,    481,   1035,    596,   -826,  -2050,  -1421,   1788,   6438,  10027,
+         10394,   7301,   2643,   -993,  -2118,  -1132,    376,   1043,    633,   -157,   -555,   -363,
+            60,    286,    197,    -18,   -134,    -95,      2,     53,     37,      1,    -15,     -9,
+    },
+    { // phase 96
+            -7,    -15,     -4,     30,     54,     18,    -76,   -137,    -54,    156,    290,    131,
+          -281,   -558,   -285,    476,   1034,    603,   -816,  -2047,  -1433,   1761,   6410,  10013,
+         10400,   7328,   2672,   -977,  -2118,  -1141,    368,   1043,    638,   -153,   -554,   -366,
+            58,    286,    198,    -17,   -134,    -95,      2,     53,     37,      1,    -15,     -9,
+    },
+    { // phase 97
+            -7,    -15,     -5,     29,     54,     19,    -75,   -137,    -55,    154,    290,    133,
+          -278,   -558,   -289,    471,   1033,    609,   -806,  -2044,  -1445,   1735,   6381,   9999,
+         10414,   7355,   2700,   -962,  -2119,  -1151,    361,   1042,    643,   -149,   -554,   -368,
+            55,    285,    200,    -15,   -133,    -96,      1,     52,     37,      1,    -15,     -9,
+    },
+    { // phase 98
+            -7,    -15,     -5,     29,     54,     19,    -75,   -137,    -56,    153,    290,    135,
+          -276,   -557,   -292,    466,   1032,    615,   -796,  -2040,  -1457,   1708,   6352,   9985,
+         10421,   7381,   2729,   -946,  -2120,  -1161,    353,   1042,    647,   -144,   -553,   -371,
+            53,    285,    201,    -14,   -133,    -96,      1,     52,     38,      2,    -15,     -9,
+    },
+    { // phase 99
+            -7,    -15,     -5,     29,     54,     20,    -74,   -137,    -57,    152,    290,    137,
+          -273,   -557,   -296,    461,   1031,    622,   -786,  -2036,  -1468,   1682,   6324,   9970,
+         10428,   7408,   2757,   -930,  -2120,  -1170,    345,   1041,    652,   -140,   -553,   -373,
+            51,    284,    202,    -13,   -133,    -97,      0,     52,     38,      2,    -15,     -9,
+    },
+    { // phase 100
+            -7,    -15,     -5,     29,     54,     20,    -73,   -137,    -58,    150,    290,    139,
+          -270,   -557,   -299,    456,   1030,    628,   -776,  -2033,  -1480,   1655,   6295,   9956,
+         10439,   7435,   2786,   -914,  -2121,  -1180,    337,   1041,    657,   -136,   -552,   -376,
+            48,    284,    203,    -12,   -133,    -98,      0,     52,     38,      2,    -15,     -9,
+    },
+    { // phase 101
+            -7,    -15,     -5,     28,     54,     20,    -73,   -137,    -59,    149,    290,    141,
+          -268,   -556,   -303,    451,   1029,    634,   -766,  -2029,  -1492,   1629,   6266,   9941,
+         10450,   7461,   2814,   -898,  -2121,  -1189,    329,   1040,    661,   -131,   -552,   -378,
+            46,    284,    204,    -11,   -132,    -98,     -1,     52,     38,      2,    -15,     -9,
+    },
+    { // phase 102
+            -6,    -15,     -5,     28,     54,     21,    -72,   -137,    -60,    147,    290,    143,
+          -265,   -556,   -306,    445,   1027,    640,   -756,  -2025,  -1503,   1602,   6237,   9927,
+         10457,   7488,   2843,   -882,  -2122,  -1199,    321,   1039,    666,   -127,   -551,   -380,
+            44,    283,    206,     -9,   -132,    -99,     -1,     52,     38,      2,    -15,     -9,
+    },
+    { // phase 103
+            -6,    -15,     -5,     28,     54,     21,    -71,   -136,    -61,    146,    290,    145,
+          -262,   -555,   -310,    440,   1026,    646,   -746,  -2021,  -1514,   1576,   6208,   9912,
+         10463,   7514,   2872,   -866,  -2122,  -1208,    313,   1039,    670,   -123,   -550,   -383,
+            41,    283,    207,     -8,   -132,    -99,     -2,     52,     39,      2,    -15,     -9,
+    },
+    { // phase 104
+            -6,    -15,     -6,     28,     54,     22,    -71,   -136,    -62,    145,    289,    147,
+          -260,   -555,   -313,    435,   1025,    653,   -736,  -2017,  -1526,   1550,   6179,   9897,
+         10473,   7541,   2900,   -850,  -2122,  -1218,    305,   1038,    675,   -118,   -550,   -385,
+            39,    282,    208,     -7,   -132,   -100,     -2,     52,     39,      3,    -15,     -9,
+    },
+    { // phase 105
+            -6,    -15,     -6,     27,     54,     22,    -70,   -136,    -63,    143,    289,    148,
+          -257,   -554,   -317,    430,   1024,    659,   -726,  -2013,  -1537,   1524,   6150,   9882,
+         10482,   7567,   2929,   -833,  -2122,  -1227,    297,   1037,    680,   -114,   -549,   -387,
+            36,    282,    209,     -6,   -132,   -100,     -3,     52,     39,      3,    -14,    -10,
+    },
+    { // phase 106
+            -6,    -15,     -6,     27,     54,     23,    -70,   -136,    -64,    142,    289,    150,
+          -254,   -554,   -320,    425,   1022,    665,   -716,  -2009,  -1548,   1498,   6121,   9867,
+         10490,   7593,   2958,   -817,  -2122,  -1236,    289,   1036,    684,   -109,   -548,   -390,
+            34,    281,    210,     -4,   -131,   -101,     -4,     52,     39,      3,    -14,    -10,
+    },
+    { // phase 107
+            -6,    -15,     -6,     27,     54,     23,    -69,   -136,    -65,    141,    289,    152,
+          -251,   -553,   -324,    420,   1021,    671,   -706,  -2004,  -1559,   1472,   6092,   9851,
+         10497,   7619,   2987,   -800,  -2122,  -1246,    281,   1035,    689,   -105,   -547,   -392,
+            31,    281,    211,     -3,   -131,   -101,     -4,     51,     39,      3,    -14,    -10,
+    },
+    { // phase 108
+            -6,    -15,     -6,     27,     54,     24,    -68,   -136,    -66,    139,    289,    154,
+          -249,   -553,   -327,    415,   1019,    676,   -696,  -2000,  -1569,   1446,   6063,   9836,
+         10504,   7645,   3016,   -783,  -2122,  -1255,    273,   1034,    693,   -100,   -546,   -394,
+            29,    280,    213,     -2,   -131,   -102,     -5,     51,     40,      3,    -14,    -10,
+    },
+    { // phase 109
+            -6,    -14,     -6,     26,     53,     24,    -68,   -136,    -67,    138,    288,    156,
+          -246,   -552,   -331,    410,   1018,    682,   -686,  -1996,  -1580,   1420,   6034,   9820,
+         10512,   7672,   3044,   -766,  -2121,  -1264,    265,   1033,    698,    -96,   -546,   -397,
+            26,    280,    214,     -1,   -130,   -102,     -5,     51,     40,      4,    -14,    -10,
+    },
+    { // phase 110
+            -6,    -14,     -6,     26,     53,     24,    -67,   -136,    -68,    136,    288,    158,
+          -243,   -552,   -334,    404,   1016,    688,   -676,  -1991,  -1591,   1394,   6005,   9805,
+         10523,   7697,   3073,   -749,  -2121,  -1274,    256,   1032,    702,    -91,   -545,   -399,
+            24,    279,    215,      1,   -130,   -103,     -6,     51,     40,      4,    -14,    -10,
+    },
+    { // phase 111
+            -6,    -14,     -6,     26,     53,     25,    -66,   -136,    -69,    135,    288,    160,
+          -241,   -551,   -337,    399,   1015,    694,   -666,  -1987,  -1601,   1369,   5976,   9789,
+         10526,   7723,   3102,   -732,  -2120,  -1283,    248,   1031,    706,    -87,   -544,   -401,
+            21,    279,    216,      2,   -130,   -103,     -6,     51,     40,      4,    -14,    -10,
+    },
+    { // phase 112
+            -6,    -14,     -7,     26,     53,     25,    -66,   -136,    -70,    134,    288,    162,
+          -238,   -550,   -341,    394,   1013,    700,   -656,  -1982,  -1611,   1343,   5947,   9773,
+         10535,   7749,   3131,   -715,  -2120,  -1292,    240,   1030,    711,    -82,   -543,   -404,
+            19,    278,    217,      3,   -130,   -104,     -7,     51,     40,      4,    -14,    -10,
+    },
+    { // phase 113
+            -6,    -14,     -7,     25,     53,     26,    -65,   -136,    -71,    132,    287,    164,
+          -235,   -550,   -344,    389,   1011,    705,   -646,  -1977,  -1622,   1317,   5917,   9757,
+         10545,   7775,   3160,   -698,  -2119,  -1301,    232,   1028,    715,    -77,   -542,   -406,
+            16,    277,    218,      4,   -129,   -105,     -7,     51,     41,      4,    -14,    -10,
+    },
+    { // phase 114
+            -6,    -14,     -7,     25,     53,     26,    -65,   -136,    -71,    131,    287,    165,
+          -232,   -549,   -347,    384,   1010,    711,   -636,  -1973,  -1632,   1292,   5888,   9741,
+         10549,   7800,   3189,   -681,  -2118,  -1311,    223,   1027,    720,    -73,   -541,   -408,
+            14,    277,    219,      6,   -129,   -105,     -8,     51,     41,      5,    -14,    -10,
+    },
+    { // phase 115
+            -6,    -14,     -7,     25,     53,     26,    -64,   -135,    -72,    129,    287,    167,
+          -230,   -548,   -350,    379,   1008,    717,   -626,  -1968,  -1642,   1266,   5859,   9724,
+         10555,   7826,   3219,   -663,  -2117,  -1320,    215,   1026,    724,    -68,   -540,   -410,
+            11,    276,    221,      7,   -129,   -106,     -9,     50,     41,      5,    -14,    -10,
+    },
+    { // phase 116
+            -6,    -14,     -7,     25,     53,     27,    -63,   -135,    -73,    128,    286,    169,
+          -227,   -548,   -354,    373,   1006,    722,   -616,  -1963,  -1652,   1241,   5830,   9708,
+         10564,   7852,   3248,   -646,  -2117,  -1329,    206,   1024,    728,    -64,   -539,   -413,
+             9,    276,    222,      8,   -128,   -106,     -9,     50,     41,      5,    -14,    -10,
+    },
+    { // phase 117
+            -6,    -14,     -7,     25,     53,     27,    -63,   -135,    -74,    127,    286,    171,
+          -224,   -547,   -357,    368,   1005,    728,   -606,  -1958,  -1662,   1216,   5800,   9691,
+         10568,   7877,   3277,   -628,  -2115,  -1338,    198,   1023,    733,    -59,   -538,   -415,
+             6,    275,    223,     10,   -128,   -107,    -10,     50,     41,      5,    -14,    -10,
+    },
+    { // phase 118
+            -6,    -14,     -7,     24,     53,     28,    -62,   -135,    -75,    125,    286,    173,
+          -221,   -546,   -360,    363,   1003,    733,   -596,  -1953,  -1671,   1191,   5771,   9674,
+         10571,   7902,   3306,   -610,  -2114,  -1347,    190,   1022,    737,    -54,   -537,   -417,
+             4,    274,    224,     11,   -128,   -107,    -10,     50,     42,      5,    -14,    -10,
+    },
+    { // phase 119
+            -5,    -14,     -8,     24,     53,     28,    -61,   -135,    -76,    124,    286,    174,
+          -219,   -545,   -363,    358,   1001,    739,   -586,  -1948,  -1681,   1165,   5741,   9658,
+         10579,   7928,   3335,   -592,  -2113,  -1356,    181,   1020,    741,    -50,   -536,   -419,
+             1,    274,    225,     12,   -127,   -108,    -11,     50,     42,      6,    -14,    -10,
+    },
+    { // phase 120
+            -5,    -14,     -8,     24,     53,     28,    -61,   -135,    -77,    123,    285,    176,
+          -216,   -544,   -366,    353,    999,    744,   -576,  -1943,  -1691,   1140,   5712,   9641,
+         10586,   7953,   3365,   -574,  -2112,  -1365,    172,   1018,    746,    -45,   -535,   -421,
+            -1,    273,    226,     13,   -127,   -108,    -12,     50,     42,      6,    -14,    -10,
+    },
+    { // phase 121
+            -5,    -14,     -8,     24,     53,     29,    -60,   -135,    -78,    121,    285,    178,
+          -213,   -544,   -369,    348,    997,    749,   -565,  -1938,  -1700,   1115,   5683,   9624,
+         10590,   7978,   3394,   -556,  -2110,  -1374,    164,   1017,    750,    -40,   -534,   -424,
+            -4,    272,    227,     15,   -126,   -109,    -12,     50,     42,      6,    -14,    -11,
+    },
+    { // phase 122
+            -5,    -14,     -8,     23,     53,     29,    -59,   -134,    -79,    120,    284,    180,
+          -210,   -543,   -373,    342,    995,    755,   -555,  -1932,  -1709,   1090,   5653,   9606,
+         10600,   8003,   3423,   -538,  -2109,  -1383,    155,   1015,    754,    -36,   -533,   -426,
+            -6,    272,    228,     16,   -126,   -109,    -13,     49,     42,      6,    -14,    -11,
+    },
+    { // phase 123
+            -5,    -14,     -8,     23,     53,     30,    -59,   -134,    -80,    118,    284,    181,
+          -208,   -542,   -376,    337,    993,    760,   -545,  -1927,  -1718,   1066,   5624,   9589,
+         10603,   8028,   3453,   -520,  -2107,  -1392,    147,   1014,    758,    -31,   -531,   -428,
+            -9,    271,    229,     17,   -126,   -110,    -13,     49,     43,      6,    -14,    -11,
+    },
+    { // phase 124
+            -5,    -14,     -8,     23,     53,     30,    -58,   -134,    -80,    117,    284,    183,
+          -205,   -541,   -379,    332,    991,    765,   -535,  -1922,  -1728,   1041,   5594,   9572,
+         10605,   8053,   3482,   -501,  -2105,  -1401,    138,   1012,    763,    -26,   -530,   -430,
+           -12,    270,    230,     19,   -125,   -110,    -14,     49,     43,      7,    -14,    -11,
+    },
+    { // phase 125
+            -5,    -14,     -8,     23,     53,     30,    -58,   -134,    -81,    115,    283,    185,
+          -202,   -540,   -382,    327,    989,    770,   -525,  -1916,  -1736,   1016,   5564,   9554,
+         10614,   8077,   3511,   -483,  -2104,  -1410,    129,   1010,    767,    -21,   -529,   -432,
+           -14,    269,    231,     20,   -125,   -110,    -14,     49,     43,      7,    -14,    -11,
+    },
+    { // phase 126
+            -5,    -14,     -8,     22,     53,     31,    -57,   -134,    -82,    114,    283,    186,
+          -199,   -539,   -385,    322,    987,    775,   -515,  -1911,  -1745,    991,   5535,   9536,
+         10620,   8102,   3541,   -464,  -2102,  -1419,    121,   1008,    771,    -17,   -528,   -434,
+           -17,    269,    232,     21,   -125,   -111,    -15,     49,     43,      7,    -14,    -11,
+    },
+    { // phase 127
+            -5,    -14,     -9,     22,     52,     31,    -56,   -134,    -83,    113,    282,    188,
+          -196,   -538,   -388,    316,    985,    780,   -505,  -1905,  -1754,    967,   5505,   9519,
+         10624,   8127,   3570,   -446,  -2100,  -1427,    112,   1006,    775,    -12,   -526,   -436,
+           -19,    268,    233,     23,   -124,   -111,    -16,     49,     43,      7,    -14,    -11,
+    },
+    { // phase 128
+            -5,    -14,     -9,     22,     52,     31,    -56,   -133,    -84,    111,    282,    190,
+          -194,   -537,   -391,    311,    982,    785,   -495,  -1899,  -1763,    942,   5476,   9501,
+         10631,   8151,   3600,   -427,  -2098,  -1436,    103,   1004,    779,     -7,   -525,   -438,
+           -22,    267,    234,     24,   -124,   -112,    -16,     48,     44,      8,    -14,    -11,
+    },
+    { // phase 129
+            -5,    -14,     -9,     22,     52,     32,    -55,   -133,    -85,    110,    282,    191,
+          -191,   -536,   -393,    306,    980,    790,   -486,  -1894,  -1771,    918,   5446,   9483,
+         10634,   8176,   3629,   -408,  -2095,  -1445,     94,   1002,    783,     -2,   -524,   -440,
+           -25,    266,    235,     25,   -123,   -112,    -17,     48,     44,      8,    -14,    -11,
+    },
+    { // phase 130
+            -5,    -14,     -9,     21,     52,     32,    -54,   -133,    -86,    108,    281,    193,
+          -188,   -535,   -396,    301,    978,    795,   -476,  -1888,  -1780,    894,   5416,   9464,
+         10640,   8200,   3659,   -389,  -2093,  -1453,     85,   1000,    787,      2,   -522,   -442,
+           -27,    265,    236,     27,   -123,   -113,    -17,     48,     44,      8,    -14,    -11,
+    },
+    { // phase 131
+            -5,    -14,     -9,     21,     52,     32,    -54,   -133,    -86,    107,    281,    195,
+          -185,   -534,   -399,    296,    976,    800,   -466,  -1882,  -1788,    869,   5387,   9446,
+         10644,   8224,   3688,   -370,  -2091,  -1462,     76,    998,    791,      7,   -521,   -445,
+           -30,    265,    237,     28,   -122,   -113,    -18,     48,     44,      8,    -14,    -11,
+    },
+    { // phase 132
+            -5,    -14,     -9,     21,     52,     33,    -53,   -133,    -87,    106,    280,    196,
+          -183,   -533,   -402,    290,    973,    805,   -456,  -1876,  -1796,    845,   5357,   9428,
+         10648,   8249,   3718,   -351,  -2088,  -1471,     68,    996,    795,     12,   -520,   -447,
+           -32,    264,    238,     29,   -122,   -114,    -19,     48,     44,      8,    -13,    -11,
+    },
+    { // phase 133
+            -5,    -14,     -9,     21,     52,     33,    -52,   -132,    -88,    104,    280,    198,
+          -180,   -532,   -405,    285,    971,    810,   -446,  -1870,  -1804,    821,   5327,   9409,
+         10648,   8273,   3747,   -332,  -2086,  -1479,     59,    994,    799,     17,   -518,   -449,
+           -35,    263,    239,     31,   -122,   -114,    -19,     48,     45,      9,    -13,    -11,
+    },
+    { // phase 134
+            -5,    -14,     -9,     20,     52,     34,    -52,   -132,    -89,    103,    279,    199,
+          -177,   -531,   -408,    280,    968,    814,   -436,  -1864,  -1812,    797,   5298,   9390,
+         10656,   8297,   3777,   -312,  -2083,  -1488,     50,    992,    803,     22,   -517,   -451,
+           -38,    262,    240,     32,   -121,   -115,    -20,     47,     45,      9,    -13,    -11,
+    },
+    { // phase 135
+            -5,    -14,     -9,     20,     52,     34,    -51,   -132,    -90,    101,    279,    201,
+          -174,   -530,   -410,    275,    966,    819,   -426,  -1858,  -1820,    773,   5268,   9372,
+         10656,   8321,   3807,   -293,  -2080,  -1496,     41,    989,    807,     27,   -515,   -453,
+           -40,    261,    241,     33,   -121,   -115,    -20,     47,     45,      9,    -13,    -11,
+    },
+    { // phase 136
+            -4,    -14,    -10,     20,     52,     34,    -51,   -132,    -90,    100,    278,    202,
+          -171,   -529,   -413,    270,    963,    824,   -416,  -1852,  -1828,    750,   5238,   9353,
+         10662,   8344,   3836,   -273,  -2077,  -1505,     32,    987,    811,     31,   -514,   -454,
+           -43,    260,    242,     35,   -120,   -116,    -21,     47,     45,      9,    -13,    -11,
+    },
+    { // phase 137
+            -4,    -14,    -10,     20,     52,     35,    -50,   -131,    -91,     99,    278,    204,
+          -169,   -527,   -416,    265,    961,    828,   -406,  -1846,  -1836,    726,   5208,   9334,
+         10663,   8368,   3866,   -254,  -2074,  -1513,     23,    985,    815,     36,   -512,   -456,
+           -46,    259,    243,     36,   -120,   -116,    -22,     47,     45,      9,    -13,    -11,
+    },
+    { // phase 138
+            -4,    -14,    -10,     20,     51,     35,    -49,   -131,    -92,     97,    277,    205,
+          -166,   -526,   -419,    259,    958,    833,   -396,  -1840,  -1843,    702,   5179,   9315,
+         10668,   8392,   3896,   -234,  -2071,  -1522,     14,    982,    819,     41,   -511,   -458,
+           -48,    258,    244,     37,   -119,   -116,    -22,     47,     45,     10,    -13,    -12,
+    },
+    { // phase 139
+            -4,    -14,    -10,     19,     51,     35,    -49,   -131,    -93,     96,    276,    207,
+          -163,   -525,   -421,    254,    956,    837,   -386,  -1833,  -1851,    678,   5149,   9296,
+         10673,   8415,   3925,   -214,  -2068,  -1530,      5,    980,    823,     46,   -509,   -460,
+           -51,    257,    245,     39,   -119,   -117,    -23,     46,     46,     10,    -13,    -12,
+    },
+    { // phase 140
+            -4,    -14,    -10,     19,     51,     36,    -48,   -131,    -94,     94,    276,    208,
+          -160,   -524,   -424,    249,    953,    842,   -376,  -1827,  -1858,    655,   5119,   9276,
+         10676,   8439,   3955,   -194,  -2065,  -1538,     -5,    977,    826,     51,   -507,   -462,
+           -54,    256,    246,     40,   -118,   -117,    -23,     46,     46,     10,    -13,    -12,
+    },
+    { // phase 141
+            -4,    -13,    -10,     19,     51,     36,    -47,   -130,    -94,     93,    275,    210,
+          -158,   -523,   -426,    244,    950,    846,   -367,  -1820,  -1866,    632,   5089,   9257,
+         10678,   8462,   3985,   -174,  -2062,  -1547,    -14,    975,    830,     56,   -506,   -464,
+           -56,    256,    247,     41,   -118,   -118,    -24,     46,     46,     10,    -13,    -12,
+    },
+    { // phase 142
+            -4,    -13,    -10,     19,     51,     36,    -47,   -130,    -95,     92,    275,    211,
+          -155,   -521,   -429,    239,    948,    850,   -357,  -1814,  -1873,    608,   5059,   9237,
+         10680,   8485,   4014,   -154,  -2058,  -1555,    -23,    972,    834,     61,   -504,   -466,
+           -59,    255,    248,     43,   -117,   -118,    -25,     46,     46,     11,    -13,    -12,
+    },
+    { // phase 143
+            -4,    -13,    -10,     18,     51,     37,    -46,   -130,    -96,     90,    274,    213,
+          -152,   -520,   -432,    233,    945,    855,   -347,  -1807,  -1880,    585,   5030,   9218,
+         10682,   8509,   4044,   -134,  -2054,  -1563,    -32,    969,    838,     66,   -502,   -468,
+           -62,    254,    249,     44,   -117,   -119,    -25,     45,     46,     11,    -13,    -12,
+    },
+    { // phase 144
+            -4,    -13,    -10,     18,     51,     37,    -45,   -130,    -97,     89,    273,    214,
+          -149,   -519,   -434,    228,    942,    859,   -337,  -1801,  -1887,    562,   5000,   9198,
+         10684,   8532,   4074,   -113,  -2051,  -1571,    -41,    967,    841,     71,   -501,   -470,
+           -64,    253,    250,     46,   -116,   -119,    -26,     45,     46,     11,    -13,    -12,
+    },
+    { // phase 145
+            -4,    -13,    -10,     18,     51,     37,    -45,   -129,    -97,     87,    273,    216,
+          -146,   -517,   -437,    223,    940,    863,   -327,  -1794,  -1894,    539,   4970,   9178,
+         10684,   8555,   4104,    -93,  -2047,  -1579,    -50,    964,    845,     76,   -499,   -472,
+           -67,    251,    251,     47,   -116,   -119,    -27,     45,     47,     11,    -13,    -12,
+    },
+    { // phase 146
+            -4,    -13,    -11,     18,     51,     37,    -44,   -129,    -98,     86,    272,    217,
+          -144,   -516,   -439,    218,    937,    867,   -317,  -1787,  -1900,    516,   4940,   9158,
+         10687,   8578,   4134,    -73,  -2043,  -1587,    -60,    961,    849,     81,   -497,   -473,
+           -70,    250,    252,     48,   -115,   -120,    -27,     45,     47,     11,    -13,    -12,
+    },
+    { // phase 147
+            -4,    -13,    -11,     17,     50,     38,    -43,   -129,    -99,     85,    272,    219,
+          -141,   -515,   -442,    213,    934,    871,   -308,  -1781,  -1907,    493,   4910,   9138,
+         10691,   8600,   4163,    -52,  -2039,  -1595,    -69,    958,    852,     86,   -495,   -475,
+           -72,    249,    253,     50,   -115,   -120,    -28,     45,     47,     12,    -13,    -12,
+    },
+    { // phase 148
+            -4,    -13,    -11,     17,     50,     38,    -43,   -128,    -99,     83,    271,    220,
+          -138,   -513,   -444,    208,    931,    875,   -298,  -1774,  -1913,    470,   4880,   9118,
+         10692,   8623,   4193,    -31,  -2035,  -1603,    -78,    955,    856,     91,   -493,   -477,
+           -75,    248,    253,     51,   -114,   -121,    -28,     44,     47,     12,    -13,    -12,
+    },
+    { // phase 149
+            -4,    -13,    -11,     17,     50,     38,    -42,   -128,   -100,     82,    270,    221,
+          -135,   -512,   -447,    203,    928,    879,   -288,  -1767,  -1920,    447,   4850,   9097,
+         10695,   8646,   4223,    -10,  -2031,  -1611,    -88,    953,    860,     96,   -492,   -479,
+           -78,    247,    254,     52,   -113,   -121,    -29,     44,     47,     12,    -12,    -12,
+    },
+    { // phase 150
+            -4,    -13,    -11,     17,     50,     39,    -42,   -128,   -101,     80,    270,    223,
+          -133,   -511,   -449,    197,    925,    883,   -278,  -1760,  -1926,    424,   4821,   9077,
+         10697,   8668,   4253,     10,  -2027,  -1619,    -97,    950,    863,    101,   -490,   -480,
+           -81,    246,    255,     54,   -113,   -121,    -30,     44,     47,     12,    -12,    -12,
+    },
+    { // phase 151
+            -4,    -13,    -11,     16,     50,     39,    -41,   -128,   -102,     79,    269,    224,
+          -130,   -509,   -451,    192,    922,    887,   -269,  -1753,  -1932,    402,   4791,   9056,
+         10695,   8691,   4283,     31,  -2022,  -1627,   -106,    946,    867,    106,   -488,   -482,
+           -83,    245,    256,     55,   -112,   -122,    -30,     44,     48,     13,    -12,    -12,
+    },
+    { // phase 152
+            -4,    -13,    -11,     16,     50,     39,    -40,   -127,   -102,     77,    268,    225,
+          -127,   -508,   -454,    187,    919,    891,   -259,  -1746,  -1939,    379,   4761,   9036,
+         10701,   8713,   4312,     52,  -2018,  -1635,   -116,    943,    870,    111,   -486,   -484,
+           -86,    244,    257,     57,   -112,   -122,    -31,     43,     48,     13,    -12,    -12,
+    },
+    { // phase 153
+            -4,    -13,    -11,     16,     50,     40,    -40,   -127,   -103,     76,    268,    227,
+          -124,   -506,   -456,    182,    916,    895,   -249,  -1739,  -1945,    357,   4731,   9015,
+         10696,   8735,   4342,     74,  -2013,  -1643,   -125,    940,    874,    116,   -484,   -486,
+           -89,    243,    258,     58,   -111,   -122,    -31,     43,     48,     13,    -12,    -12,
+    },
+    { // phase 154
+            -3,    -13,    -11,     16,     50,     40,    -39,   -127,   -104,     75,    267,    228,
+          -122,   -505,   -458,    177,    913,    899,   -240,  -1732,  -1950,    335,   4701,   8994,
+         10699,   8757,   4372,     95,  -2009,  -1650,   -135,    937,    877,    121,   -482,   -487,
+           -91,    242,    258,     59,   -111,   -123,    -32,     43,     48,     13,    -12,    -12,
+    },
+    { // phase 155
+            -3,    -13,    -11,     16,     49,     40,    -38,   -126,   -104,     73,    266,    229,
+          -119,   -503,   -461,    172,    910,    903,   -230,  -1725,  -1956,    312,   4671,   8973,
+         10701,   8779,   4402,    116,  -2004,  -1658,   -144,    934,    880,    126,   -480,   -489,
+           -94,    240,    259,     61,   -110,   -123,    -33,     43,     48,     13,    -12,    -12,
+    },
+    { // phase 156
+            -3,    -13,    -11,     15,     49,     40,    -38,   -126,   -105,     72,    265,    231,
+          -116,   -502,   -463,    167,    907,    906,   -220,  -1718,  -1962,    290,   4641,   8952,
+         10703,   8801,   4432,    138,  -1999,  -1666,   -154,    931,    884,    131,   -478,   -491,
+           -97,    239,    260,     62,   -109,   -124,    -33,     42,     48,     14,    -12,    -12,
+    },
+    { // phase 157
+            -3,    -13,    -11,     15,     49,     41,    -37,   -126,   -106,     70,    265,    232,
+          -113,   -500,   -465,    162,    904,    910,   -211,  -1710,  -1968,    268,   4611,   8931,
+         10703,   8823,   4462,    159,  -1994,  -1673,   -163,    927,    887,    136,   -476,   -492,
+          -100,    238,    261,     63,   -109,   -124,    -34,     42,     48,     14,    -12,    -13,
+    },
+    { // phase 158
+            -3,    -13,    -12,     15,     49,     41,    -37,   -125,   -106,     69,    264,    233,
+          -111,   -499,   -467,    156,    900,    913,   -201,  -1703,  -1973,    246,   4581,   8909,
+         10704,   8845,   4492,    181,  -1989,  -1681,   -173,    924,    891,    141,   -474,   -494,
+          -102,    237,    262,     65,   -108,   -124,    -35,     42,     49,     14,    -12,    -13,
+    },
+    { // phase 159
+            -3,    -13,    -12,     15,     49,     41,    -36,   -125,   -107,     68,    263,    234,
+          -108,   -497,   -469,    151,    897,    917,   -192,  -1696,  -1978,    224,   4552,   8888,
+         10703,   8866,   4522,    203,  -1984,  -1688,   -182,    920,    894,    146,   -472,   -495,
+          -105,    236,    262,     66,   -107,   -125,    -35,     42,     49,     14,    -12,    -13,
+    },
+};
@@ -0,0 +1,165 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 09:00:00
+ * @LastEditTime: 2026-10-16 09:00:00
+ * @LastEditors: 星年
+ * @Description: 多相FIR重采样ADF元素实现，封装 polyphase_resampler 核心
+ * @FilePath: \audio_manager\main\rsp_polyphase.c
+ * 遇事不决，可问春风
+ */
+#include <string.h>
+#include "esp_log.h"
+#include "audio_element.h"
+#include "audio_mem.h"
+#include "audio_error.h"
+#include "polyphase_resampler.h"
+#include "capture_convert.h"
+#include "audio_probe.h"
+#include "rsp_polyphase.h"
+
+static const char *TAG = "RSP_POLYPHASE";
+
+#define RSP_POLYPHASE_OUT_SAMPLES   (RSP_POLYPHASE_BUF_SIZE / 2 * POLYPHASE_RSP_UP / POLYPHASE_RSP_DOWN + 2)
+#define RSP_POLYPHASE_RAW_WORDS     (RSP_POLYPHASE_BUF_SIZE / sizeof(int32_t))
+
+typedef struct {
+    polyphase_rsp_t core;                           // 重采样核心状态（含历史与相位）
+    int16_t out[RSP_POLYPHASE_OUT_SAMPLES];         // 输出缓冲区
+    audio_probe_t *probe;                           // 性能探针（按管道注册名）
+    int in_bits;                                    // 输入位宽
+    bool bypass;                                    // 输入已是16kHz，只做格式转换
+    audio_arena_t *arena;                           // 所属内存区（NULL为堆）
+    capture_conv_t conv;                            // 24-in-32 转换状态
+    uint32_t raw_carry;                             // raw 中上次剩余的不足一个字的字节数
+    int32_t raw[RSP_POLYPHASE_RAW_WORDS + CAPTURE_CONV_PAD_BYTES / sizeof(int32_t)] __attribute__((aligned(16)));
+    int16_t pcm[RSP_POLYPHASE_RAW_WORDS] __attribute__((aligned(16)));
+} rsp_polyphase_t;
+
+static esp_err_t _rsp_polyphase_open(audio_element_handle_t self)
+{
+    rsp_polyphase_t *rsp = (rsp_polyphase_t *)audio_element_getdata(self);
+    polyphase_rsp_reset(&rsp->core);
+    capture_conv_reset(&rsp->conv);
+    rsp->raw_carry = 0;
+    rsp->probe = audio_probe_get(audio_element_get_tag(self));
+
+    // 告知下游元素输出格式
+    audio_element_info_t info = {0};
+    audio_element_getinfo(self, &info);
+    info.sample_rates = 16000;
+    info.channels = 1;
+    info.bits = 16;
+    audio_element_setinfo(self, &info);
+    audio_element_report_info(self);
+    return ESP_OK;
+}
+
+static esp_err_t _rsp_polyphase_close(audio_element_handle_t self)
+{
+    return ESP_OK;
+}
+
+/**
+ * @brief 32位输入：DMA字直接读入对齐的 raw，转换与重采样都在这一次处理中完成
+ */
+static audio_element_err_t _rsp_polyphase_process_raw(audio_element_handle_t self, rsp_polyphase_t *rsp)
+{
+    char *dst = (char *)rsp->raw + rsp->raw_carry;
+    int r_size = audio_element_input(self, dst, RSP_POLYPHASE_BUF_SIZE - rsp->raw_carry);
+    if (r_size <= 0) {
+        return r_size;
+    }
+    uint32_t bytes = rsp->raw_carry + r_size;
+    size_t words = bytes / sizeof(int32_t);
+    uint32_t stamp = audio_probe_begin(rsp->probe, self);
+    capture_conv_s16(&rsp->conv, rsp->raw, rsp->pcm, words);
+    const int16_t *pcm = rsp->pcm;
+    size_t n = words;
+    if (!rsp->bypass) {
+        pcm = rsp->out;
+        n = polyphase_rsp_process(&rsp->core, rsp->pcm, words, rsp->out);
+    }
+    audio_probe_end(rsp->probe, stamp);
+    // 环形缓冲区读取可能截断在字中间，剩余字节留到下次
+    rsp->raw_carry = bytes - words * sizeof(int32_t);
+    if (rsp->raw_carry) {
+        memmove(rsp->raw, (char *)rsp->raw + words * sizeof(int32_t), rsp->raw_carry);
+    }
+    if (n == 0) {
+        return r_size;
+    }
+    return audio_element_output(self, (char *)pcm, n * sizeof(int16_t));
+}
+
+static audio_element_err_t _rsp_polyphase_process(audio_element_handle_t self, char *in_buffer, int in_len)
+{
+    rsp_polyphase_t *rsp = (rsp_polyphase_t *)audio_element_getdata(self);
+    if (rsp->in_bits == 32) {
+        return _rsp_polyphase_process_raw(self, rsp);
+    }
+    int r_size = audio_element_input(self, in_buffer, in_len);
+    if (r_size <= 0 || rsp->bypass) {
+        // 直通时16位输入原样转发（上游已是16kHz 16位，通常不会这样接）
+        return r_size <= 0 ? r_size : audio_element_output(self, in_buffer, r_size);
+    }
+    uint32_t stamp = audio_probe_begin(rsp->probe, self);
+    size_t n = polyphase_rsp_process(&rsp->core, (const int16_t *)in_buffer, r_size / sizeof(int16_t), rsp->out);
+    audio_probe_end(rsp->probe, stamp);
+    if (n == 0) {
+        return r_size;
+    }
+    return audio_element_output(self, (char *)rsp->out, n * sizeof(int16_t));
+}
+
+static esp_err_t _rsp_polyphase_destroy(audio_element_handle_t self)
+{
+    rsp_polyphase_t *rsp = (rsp_polyphase_t *)audio_element_getdata(self);
+    audio_arena_free(rsp->arena, rsp);
+    return ESP_OK;
+}
+
+audio_element_handle_t rsp_polyphase_init(rsp_polyphase_cfg_t *config)
+{
+    if (config == NULL) {
+        ESP_LOGE(TAG, "config is NULL");
+        return NULL;
+    }
+    if (config->in_bits != 16 && config->in_bits != 32) {
+        ESP_LOGE(TAG, "unsupported input width %d", config->in_bits);
+        return NULL;
+    }
+    if (config->in_rate != 44100 && config->in_rate != 16000) {
+        ESP_LOGE(TAG, "unsupported input rate %d", config->in_rate);
+        return NULL;
+    }
+    // 历史、转换与输出缓冲每块都要访问，整体放片内SRAM
+    rsp_polyphase_t *rsp = (rsp_polyphase_t *)audio_arena_calloc(config->arena, 1, sizeof(rsp_polyphase_t), AUDIO_ARENA_INTERNAL);
+    AUDIO_MEM_CHECK(TAG, rsp, return NULL);
+    rsp->arena = config->arena;
+    rsp->in_bits = config->in_bits;
+    rsp->bypass = config->in_rate == 16000;
+    if (capture_conv_init(&rsp->conv, &config->conv) != 0) {
+        ESP_LOGE(TAG, "invalid capture gain %u", (unsigned)config->conv.gain_q12);
+        audio_arena_free(rsp->arena, rsp);
+        return NULL;
+    }
+
+    audio_element_cfg_t cfg = DEFAULT_AUDIO_ELEMENT_CONFIG();
+    cfg.open = _rsp_polyphase_open;
+    cfg.close = _rsp_polyphase_close;
+    cfg.process = _rsp_polyphase_process;
+    cfg.destroy = _rsp_polyphase_destroy;
+    cfg.buffer_len = RSP_POLYPHASE_BUF_SIZE;
+    cfg.out_rb_size = config->out_rb_size;
+    cfg.task_stack = config->task_stack;
+    cfg.task_core = config->task_core;
+    cfg.task_prio = config->task_prio;
+    cfg.stack_in_ext = config->stack_in_ext;
+    cfg.tag = "rsp_polyphase";
+
+    audio_element_handle_t el = audio_element_init(&cfg);
+    AUDIO_MEM_CHECK(TAG, el, {audio_arena_free(rsp->arena, rsp); return NULL;});
+    audio_element_setdata(el, rsp);
+    ESP_LOGD(TAG, "rsp_polyphase_init");
+    return el;
+}
@@ -0,0 +1,69 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 09:00:00
+ * @LastEditTime: 2026-10-16 09:00:00
+ * @LastEditors: 星年
+ * @Description: 多相FIR重采样ADF元素，可直接替换 rsp_filter_init（44.1kHz -> 16kHz，16位单声道）
+ * @FilePath: \audio_manager\main\rsp_polyphase.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdbool.h>
+#include "audio_element.h"
+#include "capture_convert.h"
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RSP_POLYPHASE_BUF_SIZE      (1024)          // 每次处理的输入字节数
+#define RSP_POLYPHASE_RINGBUFFER    (4 * 1024)      // 输出环形缓冲区大小
+#define RSP_POLYPHASE_TASK_STACK    (3 * 1024)      // 任务堆栈大小
+#define RSP_POLYPHASE_TASK_CORE     (0)             // 任务绑定核心
+#define RSP_POLYPHASE_TASK_PRIO     (5)             // 任务优先级
+
+/**
+ * @brief 多相重采样元素配置
+ */
+typedef struct {
+    int  in_bits;           // 输入位宽：16 为16位PCM；32 为24-in-32 I2S DMA字，先经 conv 转换
+    int  in_rate;           // 输入采样率：44100 重采样；与输出相同（16000）时只做格式转换
+    capture_conv_cfg_t conv; // in_bits 为32时的去直流与增益
+    audio_arena_t *arena;   // 重采样状态与工作缓冲所在内存区（片内SRAM），NULL 时从堆分配
+    int  out_rb_size;       // 输出环形缓冲区大小
+    int  task_stack;        // 任务堆栈大小
+    int  task_core;         // 任务绑定核心
+    int  task_prio;         // 任务优先级
+    bool stack_in_ext;      // 堆栈是否放在外部RAM
+} rsp_polyphase_cfg_t;
+
+#define DEFAULT_RSP_POLYPHASE_CONFIG() {            \
+    .in_bits      = 16,                             \
+    .in_rate      = 44100,                          \
+    .conv         = DEFAULT_CAPTURE_CONV_CONFIG(),  \
+    .arena        = NULL,                           \
+    .out_rb_size  = RSP_POLYPHASE_RINGBUFFER,       \
+    .task_stack   = RSP_POLYPHASE_TASK_STACK,       \
+    .task_core    = RSP_POLYPHASE_TASK_CORE,        \
+    .task_prio    = RSP_POLYPHASE_TASK_PRIO,        \
+    .stack_in_ext = false,                          \
+}
+
+/**
+ * @brief 创建多相重采样元素
+ *
+ * 输入为44100Hz单声道：16位PCM，或 in_bits 为32时直接取I2S读取元素的24-in-32 DMA字
+ * （读取元素不做位宽扩展），在同一元素内一次遍历完成取位/去直流/增益/饱和后重采样。
+ * 输出为16000Hz 16位单声道PCM。格式协商选定16kHz直采时 in_rate 设为16000，只做格式转换，不跑滤波器。
+ * 滤波器历史与相位在整个流中连续保持，open时复位。
+ *
+ * @param config 元素配置
+ * @return 元素句柄，失败返回NULL
+ */
+audio_element_handle_t rsp_polyphase_init(rsp_polyphase_cfg_t *config);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,165 @@
+/*
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 18:00:00
+ * @LastEditTime: 2026-10-16 18:00:00
+ * @LastEditors: 星年
+ * @Description: 轻量语音活动检测实现：一阶高通去除低频嗡声后统计带内能量与差分能量，
+ *               带内电平超出自适应噪声底且频谱不呈宽带嘶声时判为语音
+ * @FilePath: \audio_manager\main\voice_activity.c
+ * 遇事不决，可问春风
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "voice_activity.h"
+
+#define VA_HP_COEF_Q15      30147   // 一阶高通极点，16kHz下截止约 270Hz
+#define VA_DB_FLOOR_Q8      (-100 * 256)
+#define VA_PEAK_FALL_DB_S   10      // 语音峰值回落速度（dB/秒），只在配置了 refresh_db 时跟踪
+
+struct voice_activity {
+    voice_activity_cfg_t cfg;
+    int32_t hp_x1;                  // 高通滤波器状态：上一输入
+    int32_t hp_y1;                  // 高通滤波器状态：上一输出
+    int32_t hp_d1;                  // 上一高通输出（计算差分）
+    int32_t noise_q8;               // 噪声底（dBFS，Q8）
+    int32_t peak_q8;                // 语音峰值（dBFS，Q8）
+    uint32_t hang_left;             // 剩余拖尾样点数
+    uint32_t hang_samples;          // 拖尾总样点数
+    bool primed;                    // 噪声底是否已初始化
+    bool speech;                    // 最近一帧判定
+    voice_activity_stats_t stats;
+};
+
+/**
+ * @brief 均方功率的dBFS（Q8），以log2的分段线性近似计算，误差小于0.1dB
+ */
+static int32_t va_power_db_q8(uint64_t energy, size_t n)
+{
+    uint64_t p = n ? energy / n : 0;
+    if (p == 0) {
+        return VA_DB_FLOOR_Q8;
+    }
+    int b = 63 - __builtin_clzll(p);
+    uint32_t frac = (uint32_t)(b >= 8 ? (p >> (b - 8)) & 0xff : (p << (8 - b)) & 0xff);
+    int32_t log2_q8 = (b << 8) + (int32_t)frac;
+    // 满量程正弦功率约 2^30；10*log10(2) ≈ 771/256
+    int32_t db = ((log2_q8 - (30 << 8)) * 771) >> 8;
+    return db < VA_DB_FLOOR_Q8 ? VA_DB_FLOOR_Q8 : db;
+}
+
+voice_activity_t *voice_activity_create(const voice_activity_cfg_t *cfg)
+{
+    if (!cfg || cfg->sample_rate == 0 || cfg->max_tilt_pct == 0 || cfg->noise_fall_shift > 15) {
+        return NULL;
+    }
+    voice_activity_t *va = audio_arena_calloc(cfg->arena, 1, sizeof(voice_activity_t), AUDIO_ARENA_INTERNAL);
+    if (!va) {
+        return NULL;
+    }
+    va->cfg = *cfg;
+    va->hang_samples = (uint32_t)((uint64_t)cfg->hangover_ms * cfg->sample_rate / 1000);
+    voice_activity_reset(va);
+    return va;
+}
+
+void voice_activity_destroy(voice_activity_t *va)
+{
+    if (va) {
+        audio_arena_free(va->cfg.arena, va);
+    }
+}
+
+void voice_activity_reset(voice_activity_t *va)
+{
+    va->hp_x1 = 0;
+    va->hp_y1 = 0;
+    va->hp_d1 = 0;
+    va->noise_q8 = VA_DB_FLOOR_Q8;
+    va->peak_q8 = VA_DB_FLOOR_Q8;
+    va->hang_left = 0;
+    va->primed = false;
+    va->speech = false;
+    memset(&va->stats, 0, sizeof(va->stats));
+    va->stats.noise_db_q8 = (int16_t)VA_DB_FLOOR_Q8;
+    va->stats.level_db_q8 = (int16_t)VA_DB_FLOOR_Q8;
+}
+
+bool voice_activity_process(voice_activity_t *va, const int16_t *pcm, size_t n)
+{
+    if (n == 0) {
+        return va->speech;
+    }
+    // 1. 高通后的带内能量与一阶差分能量（差分能量/带内能量 反映频谱倾斜：
+    //    浊音集中在低频，比值远小于1；白噪声约为2）
+    uint64_t eb = 0, ed = 0;
+    int32_t x1 = va->hp_x1, y1 = va->hp_y1, d1 = va->hp_d1;
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = pcm[i];
+        int32_t y = x - x1 + (int32_t)(((int64_t)y1 * VA_HP_COEF_Q15) >> 15);
+        int32_t d = y - d1;
+        x1 = x;
+        y1 = y;
+        d1 = y;
+        eb += (int64_t)y * y;
+        ed += (int64_t)d * d;
+    }
+    va->hp_x1 = x1;
+    va->hp_y1 = y1;
+    va->hp_d1 = d1;
+
+    // 2. 噪声底：低于噪声底时按 noise_fall_shift 跟随（0为立即），高于时按 noise_rise_db_s 缓慢爬升
+    int32_t level = va_power_db_q8(eb, n);
+    if (!va->primed) {
+        va->noise_q8 = level;
+        va->primed = true;
+    } else if (level < va->noise_q8) {
+        va->noise_q8 += (level - va->noise_q8) / (1 << va->cfg.noise_fall_shift);
+    } else {
+        int32_t rise = (int32_t)((uint64_t)va->cfg.noise_rise_db_s * 256 * n / va->cfg.sample_rate);
+        va->noise_q8 += rise ? rise : 1;
+        if (va->noise_q8 > level) {
+            va->noise_q8 = level;
+        }
+    }
+
+    // 3. 判定：电平超出噪声底门限、高于绝对下限且不是宽带嘶声
+    bool active = level > va->noise_q8 + va->cfg.threshold_db * 256 &&
+                  level > va->cfg.min_level_db * 256 &&
+                  ed * 100 <= eb * va->cfg.max_tilt_pct;
+    // 4. 拖尾：配置了 refresh_db 时只有接近语音峰值的活动帧重新开始拖尾，其余活动帧只算本帧
+    bool refresh = active;
+    if (va->cfg.refresh_db) {
+        int32_t fall = (int32_t)((uint64_t)VA_PEAK_FALL_DB_S * 256 * n / va->cfg.sample_rate);
+        va->peak_q8 = va->peak_q8 - fall > level ? va->peak_q8 - fall : level;
+        refresh = active && level >= va->peak_q8 - va->cfg.refresh_db * 256;
+    }
+    bool was = va->speech;
+    if (refresh) {
+        va->hang_left = va->hang_samples;
+        va->speech = true;
+    } else {
+        va->hang_left = va->hang_left > n ? va->hang_left - (uint32_t)n : 0;
+        va->speech = active || va->hang_left > 0;
+    }
+
+    va->stats.frames++;
+    if (va->speech) {
+        va->stats.speech_frames++;
+        if (!was) {
+            va->stats.onsets++;
+        }
+    }
+    va->stats.level_db_q8 = (int16_t)level;
+    va->stats.noise_db_q8 = (int16_t)va->noise_q8;
+    return va->speech;
+}
+
+bool voice_activity_is_speech(const voice_activity_t *va)
+{
+    return va->speech;
+}
+
+void voice_activity_get_stats(const voice_activity_t *va, voice_activity_stats_t *stats)
+{
+    *stats = va->stats;
+}
@@ -0,0 +1,116 @@
+/***
+ * @Author: jixingnian@gmail.com
+ * @Date: 2026-10-16 18:00:00
+ * @LastEditTime: 2026-10-16 18:00:00
+ * @LastEditors: 星年
+ * @Description: 轻量语音活动检测（能量 + 频谱倾斜，自适应噪声底，拖尾保持），定点实现，可在Linux主机上编译
+ * @FilePath: \audio_manager\main\voice_activity.h
+ * @遇事不决，可问春风
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 语音活动检测配置
+ */
+typedef struct {
+    uint32_t sample_rate;       // 采样率（换算拖尾与噪声底爬升速度）
+    uint8_t threshold_db;       // 高于噪声底多少dB判为语音
+    int8_t min_level_db;        // 低于此电平（dBFS）一律判为静音
+    uint8_t max_tilt_pct;       // 差分能量/带内能量 的上限（%），超过视为嘶声类宽带噪声
+    uint16_t hangover_ms;       // 语音结束后继续保持语音状态的时长（覆盖词尾清辅音与词间停顿）
+    uint16_t noise_rise_db_s;   // 噪声底上升速度（dB/秒）
+    uint8_t noise_fall_shift;   // 噪声底下降速度：0 立即跟随最低电平，n 每帧向更低的电平靠近 1/2^n
+    uint8_t refresh_db;         // 只有电平距语音峰值 refresh_db 以内的活动帧才重新开始拖尾，0 每个活动帧都重新开始
+    audio_arena_t *arena;       // 内存区，NULL 时从堆分配
+} voice_activity_cfg_t;
+
+#define DEFAULT_VOICE_ACTIVITY_CONFIG() {   \
+    .sample_rate     = 16000,               \
+    .threshold_db    = 9,                   \
+    .min_level_db    = -60,                 \
+    .max_tilt_pct    = 150,                 \
+    .hangover_ms     = 300,                 \
+    .noise_rise_db_s = 3,                   \
+    .noise_fall_shift = 0,                  \
+    .refresh_db      = 0,                   \
+    .arena           = NULL,                \
+}
+
+/**
+ * @brief 降噪输出上的检测：残余噪声逐帧起伏大，噪声底不跟随瞬时最低值；
+ *        语音结束时降噪增益释放放过的尾音远低于刚结束的语音峰值，只算本帧活动，不重新开始拖尾
+ */
+#define VOICE_ACTIVITY_DENOISED_CONFIG() {  \
+    .sample_rate     = 16000,               \
+    .threshold_db    = 9,                   \
+    .min_level_db    = -60,                 \
+    .max_tilt_pct    = 150,                 \
+    .hangover_ms     = 300,                 \
+    .noise_rise_db_s = 3,                   \
+    .noise_fall_shift = 3,                  \
+    .refresh_db      = 20,                  \
+    .arena           = NULL,                \
+}
+
+/**
+ * @brief 语音活动检测统计
+ */
+typedef struct {
+    uint32_t frames;            // 已处理帧数
+    uint32_t speech_frames;     // 判为语音的帧数（含拖尾）
+    uint32_t onsets;            // 静音 -> 语音 切换次数
+    int16_t level_db_q8;        // 最近一帧带内电平（dBFS，Q8）
+    int16_t noise_db_q8;        // 当前噪声底（dBFS，Q8）
+} voice_activity_stats_t;
+
+typedef struct voice_activity voice_activity_t;
+
+/**
+ * @brief 创建检测器
+ *
+ * @return 句柄，参数非法或内存不足返回NULL
+ */
+voice_activity_t *voice_activity_create(const voice_activity_cfg_t *cfg);
+
+/**
+ * @brief 销毁检测器
+ */
+void voice_activity_destroy(voice_activity_t *va);
+
+/**
+ * @brief 清空滤波器状态、噪声底与统计
+ */
+void voice_activity_reset(voice_activity_t *va);
+
+/**
+ * @brief 处理一帧（10~60ms为宜），返回该帧是否为语音
+ *
+ * @param va  句柄
+ * @param pcm 16位单声道样点
+ * @param n   样点数
+ * @return true 语音（含拖尾），false 静音
+ */
+bool voice_activity_process(voice_activity_t *va, const int16_t *pcm, size_t n);
+
+/**
+ * @brief 最近一帧的判定结果
+ */
+bool voice_activity_is_speech(const voice_activity_t *va);
+
+/**
+ * @brief 获取统计
+ */
+void voice_activity_get_stats(const voice_activity_t *va, voice_activity_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
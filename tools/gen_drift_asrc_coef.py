@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成时钟漂移补偿ASRC的分数延迟插值系数表(Q15)
+
+相位 p (0..PHASES) 对应分数位置 mu = p / PHASES, 系数 c_p[j] 作用于窗口内第 j 个样点
+(窗口末端为最新样点), 其相对输出时刻的偏移为 t = j - TAPS/2 + 1 - mu。
+原型为截止频率 FC 的sinc乘以端点为0的Kaiser窗, 因此第 PHASES 行恰为第0行右移一个样点,
+运行时在相邻两行之间线性插值即可覆盖 [0, 1) 内任意分数位置而无跳变。
+系数按时间正序存放, 逐相位修正使系数和恰好为 32768 (各相位直流增益一致)。
+
+用法: python3 tools/gen_drift_asrc_coef.py > main/drift_asrc_coef.h
+"""
+import math
+
+PHASES, TAPS = 128, 16
+FC = 0.45           # 截止频率(相对采样率)
+BETA = 7.0
+
+
+def bessel_i0(x):
+    s, t, k = 1.0, 1.0, 1
+    while True:
+        t *= (x / 2 / k) ** 2
+        s += t
+        k += 1
+        if t < 1e-12 * s:
+            return s
+
+
+def kernel(t):
+    x = t / (TAPS / 2)
+    if abs(x) >= 1:
+        return 0.0
+    w = (bessel_i0(BETA * math.sqrt(1 - x * x)) - 1) / (bessel_i0(BETA) - 1)
+    s = 2 * FC if t == 0 else math.sin(2 * math.pi * FC * t) / (math.pi * t)
+    return s * w
+
+
+def main():
+    print("/*")
+    print(" * 由 tools/gen_drift_asrc_coef.py 生成, 请勿手工修改")
+    print(" * PHASES=%d TAPS=%d FC=%.2f*fs Kaiser beta=%.1f" % (PHASES, TAPS, FC, BETA))
+    print(" */")
+    print("#pragma once")
+    print("")
+    print("#include <stdint.h>")
+    print("")
+    print("static const int16_t s_drift_asrc_coef[%d][%d] __attribute__((aligned(16))) = {" % (PHASES + 1, TAPS))
+    for p in range(PHASES + 1):
+        mu = p / PHASES
+        c = [kernel(j - TAPS / 2 + 1 - mu) for j in range(TAPS)]
+        g = sum(c)
+        q = [int(round(v / g * 32768)) for v in c]
+        q[max(range(TAPS), key=lambda j: abs(c[j]))] += 32768 - sum(q)
+        print("    { // phase %d" % p)
+        for i in range(0, TAPS, 8):
+            print("        " + ", ".join("%6d" % v for v in q[i:i + 8]) + ",")
+        print("    },")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成定点实FFT的旋转因子、实FFT拆分因子与位反转表(Q30)
+
+按最大复数点数 N=MAX_N 生成一套表, 较小的 N' = N >> s 按步长取用:
+旋转因子 e^{-j2πk/N'} 即第 k<<s 项, 拆分因子 e^{-jπk/N'} 即第 k<<s 项, 位反转下标右移 s 位。
+取整与原各模块初始化时的 lrint(cos/sin * 2^30) 一致, 输出逐位相同。
+
+用法: python3 tools/gen_fixed_fft_tables.py > main/fixed_fft_tables.h
+"""
+import math
+
+LOG2_MAX_N = 7
+MAX_N = 1 << LOG2_MAX_N
+Q = 30
+
+
+def q30(v):
+    return int(round(v * (1 << Q)))
+
+
+def emit(name, vals, comment):
+    print("/* %s */" % comment)
+    print("static const fixed_fft_cpx_t %s[%d] = {" % (name, len(vals)))
+    for i in range(0, len(vals), 4):
+        print("    " + " ".join("{%11d, %11d}," % v for v in vals[i:i + 4]))
+    print("};")
+    print("")
+
+
+def main():
+    print("/*")
+    print(" * 由 tools/gen_fixed_fft_tables.py 生成, 请勿手工修改")
+    print(" * MAX_N=%d (实FFT长度%d) Q%d" % (MAX_N, 2 * MAX_N, Q))
+    print(" */")
+    print("#pragma once")
+    print("")
+    print("#include <stdint.h>")
+    print("#include \"fixed_fft.h\"")
+    print("")
+    tw = []
+    for k in range(MAX_N // 2):
+        ph = -2.0 * math.pi * k / MAX_N
+        tw.append((q30(math.cos(ph)), q30(math.sin(ph))))
+    emit("s_fixed_fft_tw", tw, "复数FFT旋转因子 e^{-j2πk/N}")
+    sp = []
+    for k in range(MAX_N + 1):
+        ph = -math.pi * k / MAX_N
+        sp.append((q30(math.cos(ph)), q30(math.sin(ph))))
+    emit("s_fixed_fft_sp", sp, "实FFT拆分因子 e^{-jπk/N}")
+    rev = []
+    for n in range(MAX_N):
+        r = 0
+        for b in range(LOG2_MAX_N):
+            r |= ((n >> b) & 1) << (LOG2_MAX_N - 1 - b)
+        rev.append(r)
+    print("/* 位反转下标 */")
+    print("static const uint8_t s_fixed_fft_rev[%d] = {" % MAX_N)
+    for i in range(0, MAX_N, 16):
+        print("    " + " ".join("%3d," % v for v in rev[i:i + 16]))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
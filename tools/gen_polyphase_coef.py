@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成 44100 -> 16000 (160/441) 多相FIR重采样器的Q15系数表
+
+原型滤波器: Kaiser窗sinc, 总长 UP * TAPS, 截止频率 FC (以上采样率计)
+每个相位的系数按时间倒序存放, 便于与输入窗口做顺序点积,
+并逐相位修正使系数和恰好为 32768 (各相位直流增益一致, 避免相位相关的纹波)。
+
+用法: python3 tools/gen_polyphase_coef.py > main/polyphase_resampler_coef.h
+"""
+import math
+
+UP, DOWN, TAPS = 160, 441, 48
+FS_IN = 44100.0
+FC = 7200.0
+BETA = 6.0
+
+
+def bessel_i0(x):
+    s, t, k = 1.0, 1.0, 1
+    while True:
+        t *= (x / 2 / k) ** 2
+        s += t
+        k += 1
+        if t < 1e-12 * s:
+            return s
+
+
+def main():
+    n_total = UP * TAPS
+    wc = 2 * FC / (FS_IN * UP)
+    proto = []
+    for n in range(n_total):
+        m = n - (n_total - 1) / 2
+        s = wc if m == 0 else math.sin(math.pi * wc * m) / (math.pi * m)
+        w = bessel_i0(BETA * math.sqrt(1 - (2 * n / (n_total - 1) - 1) ** 2)) / bessel_i0(BETA)
+        proto.append(UP * s * w)
+
+    print("/*")
+    print(" * 由 tools/gen_polyphase_coef.py 生成, 请勿手工修改")
+    print(" * UP=%d DOWN=%d TAPS=%d FC=%.0fHz Kaiser beta=%.1f" % (UP, DOWN, TAPS, FC, BETA))
+    print(" */")
+    print("#pragma once")
+    print("")
+    print("#include <stdint.h>")
+    print("")
+    print("static const int16_t s_polyphase_coef[%d][%d] __attribute__((aligned(16))) = {" % (UP, TAPS))
+    for p in range(UP):
+        c = [proto[(TAPS - 1 - j) * UP + p] for j in range(TAPS)]
+        q = [int(round(v * 32768)) for v in c]
+        q[max(range(TAPS), key=lambda j: abs(c[j]))] += 32768 - sum(q)
+        print("    { // phase %d" % p)
+        for i in range(0, TAPS, 12):
+            print("        " + ", ".join("%6d" % v for v in q[i:i + 12]) + ",")
+        print("    },")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()